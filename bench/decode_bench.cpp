@@ -0,0 +1,301 @@
+// ── 모듈 디코더 벤치마크 (합성 신호, SNR / CFO / CW 간섭 스윕) ───────────────
+// 모듈별 합성기 (bench/synth_*.hpp) 가 만든 버스트열에 SynthCommon::Channel 로 열화를 얹고,
+// 워커 프런트엔드 근사 (채널 LPF → |x| / AM 포락선 / FM 판별 + 정합필터) 를 거쳐
+// 각 모듈의 디코드 코어에 청크 단위로 투입.
+// 보고: 디코드 수율 (고유 패킷 ID 기준, 청크 overlap 중복 제외), 처리 속도 (Msamples/s),
+//       pkts/s (CPU 초당 디코드), CPU%RT (그 모듈 샘플레이트 실시간 스트림 대비 단일 코어 비율).
+// 측정 구간 = 프런트엔드 + 디코드 (합성/열화 제외).
+//
+//   decode_bench [mod|all] [packets=200] [snr_list=모듈 기본] [cfo_hz=0] [cw_dbc=off] [cw_hz=0.2·fs]
+//   mod = adsb acars ais dmr btle wifi_b wifi_g   (wifi_* 는 FFTW 있을 때 빌드)
+#include "synth_common.hpp"
+#include "synth_modes.hpp"
+#include "synth_acars.hpp"
+#include "synth_ais.hpp"
+#include "synth_dmr.hpp"
+#include "synth_btle.hpp"
+#include "adsb_decode.hpp"
+#include "acars_decode.hpp"
+#include "ais_decode.hpp"
+#include "dmr_decode.hpp"
+#include "btle_decode.hpp"
+#ifdef BEWE_BENCH_WIFI
+#include "synth_wifi.hpp"
+#include "wifi_dsss.hpp"
+#endif
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <set>
+#include <string>
+#include <vector>
+
+using SynthCommon::cf;
+
+static double cpu_now(){
+    timespec ts; clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// 디코드 결과: 고유 ID (합성 순번) + 오탐 (범위 밖 ID / CRC 실패 레코드)
+struct Hits {
+    std::set<int> ids;
+    long bad = 0;
+    void add(int id, int n){ if(id >= 0 && id < n) ids.insert(id); else bad++; }
+};
+
+struct Mode {
+    const char* name;
+    double      fs;
+    const char* snrs;                                           // 기본 SNR 목록 (dB)
+    // 깨끗한 신호 (버스트 + 0 간격) 합성
+    void (*build)(std::vector<cf>& sig, int n, std::mt19937& rng, double fs);
+    // 열화된 신호 → 프런트엔드 + 디코드
+    void (*run)(const std::vector<cf>& sig, int n, double fs, Hits& h);
+};
+
+static void gap(std::vector<cf>& sig, double sec, double fs){ sig.resize(sig.size() + (size_t)(sec*fs)); }
+static double urand(std::mt19937& rng, double lo, double hi){
+    return lo + (hi-lo)*std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+}
+
+// ── ADS-B: DF17 PPM, 2.4 MSPS, |x| → AdsbDecoder (20 ms 청크) ──
+static void adsb_build(std::vector<cf>& sig, int n, std::mt19937& rng, double fs){
+    for(int i=0;i<n;i++){
+        gap(sig, urand(rng, 150e-6, 450e-6), fs);
+        uint8_t msg[14];
+        SynthModeS::df17_ident(msg, 0x700000u + (uint32_t)i, "BEWE123");
+        SynthModeS::frame_iq(sig, msg, fs, urand(rng, 0.0, 1.0)/fs);
+    }
+    gap(sig, 200e-6, fs);
+}
+static void adsb_run(const std::vector<cf>& sig, int n, double fs, Hits& h){
+    AdsbDecoder dec;
+    dec.on_record = [&](const AdsbRecord& m){ h.add(m.df == 17 ? (int)(m.icao - 0x700000u) : -1, n); };
+    dec.reset(fs, 0);
+    size_t chunk = (size_t)(fs*0.02);
+    std::vector<float> mag(chunk);
+    for(size_t o=0;o<sig.size();o+=chunk){
+        size_t k = std::min(chunk, sig.size()-o);
+        for(size_t i=0;i<k;i++) mag[i] = std::abs(sig[o+i]);
+        dec.process(mag.data(), k);
+    }
+}
+
+// ── ACARS: MSK/AM, 48 kHz, 채널 LPF → 포락선 → DC 제거 → 3 kHz LPF → AcarsDecoder ──
+static void acars_build(std::vector<cf>& sig, int n, std::mt19937& rng, double fs){
+    char text[64];
+    for(int i=0;i<n;i++){
+        gap(sig, urand(rng, 0.05, 0.15), fs);
+        snprintf(text, sizeof(text), "%04dKE%04d BEWE SYNTH POS N37.5 E126.9", i, 1000 + i%9000);
+        SynthAcars::burst(sig, SynthAcars::block(".HL8001", "H1", (char)('0' + i%10), text), fs);
+    }
+    gap(sig, 0.1, fs);
+}
+static void acars_run(const std::vector<cf>& sig, int n, double fs, Hits& h){
+    struct Lp { float a=0, s=0; void set(double hz, double fs){ a=(float)(1.0-std::exp(-2.0*M_PI*hz/fs)); }
+                float p(float x){ s+=a*(x-s); return s; } };
+    SynthCommon::ChanIir lpf; lpf.set(6000, fs);
+    Lp dc, alf;
+    dc.set(30, fs); alf.set(3000, fs);
+    AcarsDecoder dec;
+    dec.on_record = [&](const AcarsMsg& m){
+        if(!m.crc_ok){ h.bad++; return; }
+        h.add(m.text[0] >= '0' && m.text[0] <= '9' ? atoi(m.text) : -1, n);
+    };
+    dec.reset((float)fs, 0);
+    for(const cf& z : sig){
+        float env = std::abs(lpf.p(z));
+        float d = dc.p(env);
+        dec.feed(alf.p(env - d));
+    }
+}
+
+// ── AIS: GMSK/HDLC, 48 kHz, FM 판별 → AisBitSync → AisDecoder ──
+static void ais_build(std::vector<cf>& sig, int n, std::mt19937& rng, double fs){
+    const double slot = 60.0/2250.0;
+    uint8_t bits[168];
+    for(int i=0;i<n;i++){
+        gap(sig, slot*(1 + rng()%3) - 256/9600.0, fs);     // 슬롯 정렬 근사 (버스트 ≈ 256 bit)
+        SynthAis::msg1(bits, 440000000u + (uint32_t)i, 35.1 + i*1e-4, 129.0 + i*1e-4, 12.3f, 45.6f);
+        SynthAis::burst(sig, SynthAis::frame_bits(bits, 168), fs);
+    }
+    gap(sig, slot, fs);
+}
+static void ais_run(const std::vector<cf>& sig, int n, double fs, Hits& h){
+    SynthCommon::ChanIir lpf; lpf.set(12500, fs);              // 25 kHz 채널
+    SynthCommon::Discrim disc;
+    AisBitSync bs; bs.init((uint32_t)fs);
+    AisDecoder dec;
+    dec.on_record = [&](const AisRecord& r){ h.add(r.msg_type == 1 ? (int)(r.mmsi - 440000000u) : -1, n); };
+    dec.reset_all();
+    for(const cf& z : sig){
+        int b = bs.step(disc.p(lpf.p(z)));
+        if(b >= 0) dec.feed_bit((uint8_t)b);
+    }
+}
+
+// ── DMR: CSBK 데이터 버스트 4FSK, 48 kHz, FM 판별 → RRC → DmrDecoder ──
+// 기지국 outbound 근사: 반송파 연속 (CACH 12 + 버스트 132 = 슬롯 144 심볼), 패킷 사이 유휴 슬롯은
+// 랜덤 디비트 (sync 없음). 버스트 사이가 무반송파면 판별기 잡음이 RRC 를 타고 가장자리 심볼을 깸.
+// 유휴 간격은 144 심볼 배수 — DmrDecoder 의 omega 트래킹이 TDMA 격자 거리로 클럭을 잡음.
+static void dmr_build(std::vector<cf>& sig, int n, std::mt19937& rng, double fs){
+    uint8_t p96[96];
+    std::vector<float> sym;
+    auto idle = [&](int k){ for(int i=0;i<k;i++) sym.push_back((float)dmr::dibit_to_sym(rng()&1, rng()&1)); };
+    idle(144);
+    for(int i=0;i<n;i++){
+        idle(12);                                                // CACH
+        SynthDmr::csbk(p96, 0x04, 9000, 2000000u + (uint32_t)i);
+        auto b = SynthDmr::data_burst(p96, 1, 3);
+        sym.insert(sym.end(), b.begin(), b.end());
+        idle(144*(1 + 2*(rng()%2)));                             // 다음 패킷까지 1 또는 3 슬롯
+    }
+    gap(sig, 0.05, fs);
+    SynthDmr::burst(sig, sym, fs);
+    gap(sig, 0.05, fs);
+}
+static void dmr_run(const std::vector<cf>& sig, int n, double fs, Hits& h){
+    SynthCommon::ChanIir lpf; lpf.set(6250, fs);               // 12.5 kHz 채널
+    SynthCommon::Discrim disc;
+    std::vector<float> rrc = SynthCommon::rrc_taps(fs/4800.0, 0.2);
+    std::vector<float> hist(2*rrc.size(), 0.f); size_t pos = 0, T = rrc.size();
+    DmrDecoder dec; dec.configure(fs);
+    dec.on_record = [&](const DmrRecord& m){ h.add(m.crc_ok ? (int)(m.src_id - 2000000u) : -1, n); };
+    for(const cf& z : sig){
+        float d = disc.p(lpf.p(z));
+        hist[pos] = hist[pos+T] = d;
+        if(++pos >= T) pos = 0;
+        float y = 0;
+        for(size_t t=0;t<T;t++) y += hist[pos+t]*rrc[t];
+        dec.feed(y);
+    }
+}
+
+// ── BLE: ADV_NONCONN_IND GFSK, 4 MSPS, FM 판별 + |z|² → BtleDecoder (1 ms 청크) ──
+static void btle_build(std::vector<cf>& sig, int n, std::mt19937& rng, double fs){
+    char name[24];
+    for(int i=0;i<n;i++){
+        gap(sig, urand(rng, 0.3e-3, 1.5e-3), fs);
+        uint8_t mac[6] = { 0xC0, 0xBE, 0x3E, 0x00, (uint8_t)(i>>8), (uint8_t)i };
+        snprintf(name, sizeof(name), "BEWE-%04d", i);
+        SynthBtle::burst(sig, SynthBtle::air_bits(SynthBtle::adv_nonconn(mac, name), 37), fs);
+    }
+    gap(sig, 1e-3, fs);
+}
+static void btle_run(const std::vector<cf>& sig, int n, double fs, Hits& h){
+    SynthCommon::ChanFir lpf; lpf.init(1.1e6, fs, 33);          // 1M PHY 점유 ±0.75 MHz
+    SynthCommon::Discrim disc;
+    BtleDecoder dec;
+    dec.on_record = [&](const BtleRecord& m){
+        bool ours = m.mac[0] == 0xC0 && m.mac[1] == 0xBE && m.mac[2] == 0x3E;
+        h.add(ours ? (m.mac[4]<<8 | m.mac[5]) : -1, n);
+    };
+    dec.reset(fs, 0, 37);
+    size_t chunk = (size_t)(fs*1e-3);
+    std::vector<float> d(chunk), amp(chunk);
+    for(size_t o=0;o<sig.size();o+=chunk){
+        size_t k = std::min(chunk, sig.size()-o);
+        for(size_t i=0;i<k;i++){ cf y = lpf.p(sig[o+i]); d[i] = disc.p(y); amp[i] = std::norm(y); }
+        dec.process(d.data(), amp.data(), k);
+    }
+}
+
+#ifdef BEWE_BENCH_WIFI
+// ── WiFi: 비콘 (b: DSSS 22 MSPS / g: OFDM 20 MSPS), 워커와 같은 fs/8 스캔 버퍼 + 4096 overlap ──
+static void wifi_build(std::vector<cf>& sig, int n, std::mt19937& rng, double fs, bool dsss){
+    char ssid[24];
+    for(int i=0;i<n;i++){
+        gap(sig, urand(rng, 0.5e-3, 2e-3), fs);
+        uint8_t bssid[6] = { 0x02, 0xBE, 0x3E, 0x00, (uint8_t)(i>>8), (uint8_t)i };
+        snprintf(ssid, sizeof(ssid), "BEWE-%04d", i);
+        auto m = SynthWifi::beacon(bssid, ssid, 6);
+        if(dsss) SynthWifi::dsss_burst(sig, m); else SynthWifi::ofdm_burst(sig, m);
+    }
+    gap(sig, 1e-3, fs);
+}
+static void wifi_b_build(std::vector<cf>& s, int n, std::mt19937& r, double fs){ wifi_build(s, n, r, fs, true); }
+static void wifi_g_build(std::vector<cf>& s, int n, std::mt19937& r, double fs){ wifi_build(s, n, r, fs, false); }
+static void wifi_run(const std::vector<cf>& sig, int n, double fs, Hits& h, bool dsss){
+    auto emit = [&](const WifiRecord& r){
+        unsigned b[6];
+        if(sscanf(r.bssid, "%x:%x:%x:%x:%x:%x", &b[0],&b[1],&b[2],&b[3],&b[4],&b[5]) == 6
+           && b[0] == 0x02 && b[1] == 0xBE && b[2] == 0x3E) h.add((int)(b[4]<<8 | b[5]), n);
+        else h.bad++;
+    };
+    const size_t W = (size_t)(fs/8), KEEP = 4096;
+    for(size_t o=0; o<sig.size(); o+=W){
+        size_t s0 = o >= KEEP ? o-KEEP : 0, e = std::min(sig.size(), o+W);
+        if(dsss) wifi_dsss::decode_buffer_dsss(sig.data()+s0, e-s0, fs, emit);
+        else     wifi_ofdm::decode_buffer(sig.data()+s0, e-s0, fs, emit);
+    }
+}
+static void wifi_b_run(const std::vector<cf>& s, int n, double fs, Hits& h){ wifi_run(s, n, fs, h, true); }
+static void wifi_g_run(const std::vector<cf>& s, int n, double fs, Hits& h){ wifi_run(s, n, fs, h, false); }
+#endif
+
+static const Mode MODES[] = {
+    { "adsb",   2.4e6,  "6,8,10,12,15,20",  adsb_build,   adsb_run   },
+    { "acars",  48e3,   "0,3,6,9,12,20",    acars_build,  acars_run  },
+    { "ais",    48e3,   "3,6,9,12,15,20",   ais_build,    ais_run    },
+    { "dmr",    48e3,   "6,9,12,15,18,25",  dmr_build,    dmr_run    },
+    { "btle",   4e6,    "3,6,9,12,15,20",   btle_build,   btle_run   },
+#ifdef BEWE_BENCH_WIFI
+    { "wifi_b", 22e6,   "-6,-3,0,3,6,10",   wifi_b_build, wifi_b_run },
+    { "wifi_g", 20e6,   "0,3,6,9,12,15",    wifi_g_build, wifi_g_run },
+#endif
+};
+
+int main(int argc, char** argv){
+    std::string sel  = argc > 1 ? argv[1] : "all";
+    int    packets   = argc > 2 ? atoi(argv[2]) : 200;
+    std::string snr_arg = argc > 3 ? argv[3] : "";
+    double cfo_hz    = argc > 4 ? atof(argv[4]) : 0.0;
+    bool   cw_on     = argc > 5 && strcmp(argv[5], "off") != 0;
+    float  cw_dbc    = cw_on ? (float)atof(argv[5]) : -200.f;
+    double cw_hz_arg = argc > 6 ? atof(argv[6]) : -1.0;
+
+    bool any = false;
+    for(const Mode& md : MODES){
+        if(sel != "all" && sel != md.name) continue;
+        any = true;
+        double cw_hz = cw_hz_arg >= 0 ? cw_hz_arg : md.fs*0.2;
+        std::mt19937 rng(99);
+        std::vector<cf> clean;
+        md.build(clean, packets, rng, md.fs);
+        double sig_sec = clean.size()/md.fs;
+
+        printf("\n%s: fs=%.3f MHz, %d packets (%.2f s), CFO %.0f Hz", md.name, md.fs/1e6, packets, sig_sec, cfo_hz);
+        if(cw_on) printf(", CW %.1f dBc @ %+.0f Hz", cw_dbc, cw_hz);
+        printf("\n%6s %9s %8s %10s %10s %9s\n", "SNR", "decoded", "yield", "Msamp/s", "pkts/s", "CPU%RT");
+
+        std::string snrs = snr_arg.empty() ? md.snrs : snr_arg;
+        size_t p = 0;
+        while(p < snrs.size()){
+            size_t q = snrs.find(',', p); if(q == std::string::npos) q = snrs.size();
+            float snr = (float)atof(snrs.substr(p, q-p).c_str());
+            p = q + 1;
+
+            std::vector<cf> sig = clean;
+            SynthCommon::Channel ch(md.fs, 1234u);
+            ch.set_snr(snr); ch.set_cfo(cfo_hz); ch.set_cw(cw_dbc, cw_hz);
+            ch.apply(sig);
+
+            Hits h;
+            double c0 = cpu_now();
+            md.run(sig, packets, md.fs, h);
+            double cpu = cpu_now() - c0;
+            if(cpu <= 0) cpu = 1e-9;
+
+            long good = (long)h.ids.size();
+            printf("%6.1f %9ld %7.1f%% %10.2f %10.0f %8.2f%%", snr, good, 100.0*good/packets,
+                   sig.size()/cpu/1e6, good/cpu, 100.0*cpu/sig_sec);
+            if(h.bad) printf("  (false %ld)", h.bad);
+            printf("\n");
+        }
+    }
+    if(!any){ fprintf(stderr, "decode_bench: unknown module '%s'\n", sel.c_str()); return 1; }
+    return 0;
+}
@@ -0,0 +1,245 @@
+// ── 지도/지구본 렌더 벤치마크 (헤드리스, EGL surfaceless + FBO; llvmpipe 에서도 동작) ──
+// 표적 수별 프레임 시간. ImGui 프레임 빌드(CPU) 와 GL 그리기+glFinish 를 따로 잼.
+//   2D 지도 (modview_map::draw_map, src/korea_osm_data.hpp 있을 때):
+//     클러스터 off/on × 정지 카메라(캐시 재사용) / 매 프레임 팬(해안선·육지 재투영)
+//   지구본 (GlobeRenderer, GLEW + stb 있을 때):
+//     기존 ImGui 마커 (9 원/위성, 매 프레임 project_world) vs 인스턴스 마커 1 draw
+//
+//   map_render_bench [frames=60] [width=1600] [height=900]
+//   (LIBGL_ALWAYS_SOFTWARE=1 / EGL_PLATFORM=surfaceless 로 소프트웨어 래스터 강제 가능)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#ifdef BEWE_BENCH_GLOBE
+#include "globe.hpp"
+#else
+#define GL_GLEXT_PROTOTYPES 1
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+#include "imgui.h"
+#include "imgui_impl_opengl3.h"
+#ifdef BEWE_BENCH_MAP
+#include "modview_map.hpp"
+#endif
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+void bewe_log_push(int, const char* fmt, ...){
+    if(!getenv("BENCH_VERBOSE")) return;
+    va_list ap; va_start(ap, fmt); vfprintf(stderr, fmt, ap); va_end(ap);
+}
+
+static double wall_now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool egl_context(int w, int h, GLuint& fbo){
+    EGLDisplay d = EGL_NO_DISPLAY;
+    auto get_platform = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(get_platform) d = get_platform(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if(d == EGL_NO_DISPLAY) d = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint maj = 0, min = 0;
+    if(d == EGL_NO_DISPLAY || !eglInitialize(d, &maj, &min)){ fprintf(stderr, "EGL init failed\n"); return false; }
+    const EGLint cfg_attr[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_NONE };
+    EGLConfig cfg; EGLint ncfg = 0;
+    if(!eglChooseConfig(d, cfg_attr, &cfg, 1, &ncfg) || ncfg < 1){ fprintf(stderr, "EGL: no config\n"); return false; }
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint ctx_attr[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+                                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+    EGLContext ctx = eglCreateContext(d, cfg, EGL_NO_CONTEXT, ctx_attr);
+    if(ctx == EGL_NO_CONTEXT){ fprintf(stderr, "EGL: no GL 3.3 core context\n"); return false; }
+    if(!eglMakeCurrent(d, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)){ fprintf(stderr, "EGL: surfaceless make-current failed\n"); return false; }
+#ifdef BEWE_BENCH_GLOBE
+    glewExperimental = GL_TRUE;
+    glewInit();   // GLX 빌드 GLEW 는 디스플레이 없음 에러를 내지만 GL 함수는 이미 로드됨
+    if(!glGenVertexArrays){ fprintf(stderr, "GLEW: GL entry points not loaded\n"); return false; }
+#endif
+    GLuint rb[2];
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glGenRenderbuffers(2, rb);
+    glBindRenderbuffer(GL_RENDERBUFFER, rb[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rb[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, rb[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rb[1]);
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){ fprintf(stderr, "FBO incomplete\n"); return false; }
+    printf("map_render_bench: %s / %s, EGL %d.%d, %dx%d FBO\n",
+           (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION), maj, min, w, h);
+    return true;
+}
+
+struct Timing { double build_ms = 0, draw_ms = 0; long vtx = 0; };
+
+// one ImGui frame: body() 안에서 창/지도 빌드, Render → RenderDrawData → glFinish
+template<class Pre, class Body>
+static Timing run_frames(int frames, int w, int h, Pre pre, Body body){
+    ImGuiIO& io = ImGui::GetIO();
+    Timing t;
+    for(int f = -3; f < frames; f++){       // 3 프레임 워밍업 (캐시/버퍼 채움)
+        glViewport(0, 0, w, h);
+        glClearColor(0.03f, 0.05f, 0.10f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        double t0 = wall_now();
+        pre(f);
+        ImGui_ImplOpenGL3_NewFrame();
+        io.DisplaySize = ImVec2((float)w, (float)h);
+        io.DeltaTime = 1.f / 60.f;
+        ImGui::NewFrame();
+        body(f);
+        ImGui::Render();
+        double t1 = wall_now();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        glFinish();
+        double t2 = wall_now();
+        if(f < 0) continue;
+        t.build_ms += (t1 - t0) * 1e3;
+        t.draw_ms  += (t2 - t1) * 1e3;
+        t.vtx      += ImGui::GetDrawData()->TotalVtxCount;
+    }
+    t.build_ms /= frames; t.draw_ms /= frames; t.vtx /= frames;
+    return t;
+}
+
+static void report(const char* scene, int n, const char* mode, const Timing& t){
+    printf("%-8s %8d  %-22s %9.2f %9.2f %9.2f %10ld\n", scene, n, mode,
+           t.build_ms, t.draw_ms, t.build_ms + t.draw_ms, t.vtx);
+}
+
+#ifdef BEWE_BENCH_MAP
+static void bench_map(int frames, int w, int h){
+    using namespace modview_map;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    const int counts[] = { 100, 1000, 10000, 100000 };
+    for(int n : counts){
+        // 한국 연안 선박/항공기 유사 분포 + 10% 항적 20점
+        std::vector<MapPoint> pts(n);
+        std::vector<std::vector<float>> trails(n);
+        std::vector<std::string> labels(n);
+        for(int i = 0; i < n; i++){
+            MapPoint& p = pts[i];
+            p.lat = 33.0 + 6.0 * U(rng);
+            p.lon = 124.0 + 7.5 * U(rng);
+            p.heading = (float)(360.0 * U(rng));
+            p.color = (i % 3) ? IM_COL32(80, 200, 255, 255) : IM_COL32(255, 200, 80, 255);
+            p.id = (uint64_t)(i + 1);
+            labels[i] = "TGT" + std::to_string(i);
+            p.label = labels[i].c_str();
+            if(i % 10 == 0){
+                for(int k = 0; k < 20; k++){
+                    trails[i].push_back((float)(p.lat - 0.002 * (20 - k)));
+                    trails[i].push_back((float)(p.lon - 0.003 * (20 - k)));
+                }
+                p.trail = trails[i].data(); p.trail_n = 20;
+            }
+        }
+        pts[0].selected = true;
+        for(int cl = 0; cl < 2; cl++){
+            for(int pan = 0; pan < 2; pan++){
+                MapView v;
+                v.cluster = cl != 0;
+                // 남해안 중심 3°×(종횡비) 창 — 팬이 bbox 클램프에 막히지 않는 줌
+                v.initialized = true;
+                v.lat0 = 33.5; v.lat1 = 36.5;
+                double lonspan = (double)w / h * 3.0 / std::cos(35.0 * M_PI / 180.0);
+                v.lon0 = 127.5 - lonspan * 0.5; v.lon1 = 127.5 + lonspan * 0.5;
+                auto pre = [&](int f){
+                    if(pan && f >= 0){ double d = 0.01 * ((f & 2) ? 1 : -1); v.lon0 += d; v.lon1 += d; }
+                };
+                auto body = [&](int){
+                    ImGui::SetNextWindowPos(ImVec2(0, 0));
+                    ImGui::SetNextWindowSize(ImVec2((float)w, (float)h));
+                    ImGui::Begin("##map", nullptr, ImGuiWindowFlags_NoDecoration);
+                    draw_map("##m", v, pts);
+                    ImGui::End();
+                };
+                Timing t = run_frames(frames, w, h, pre, body);
+                char mode[40];
+                snprintf(mode, sizeof mode, "cluster %s, %s", cl ? "on " : "off", pan ? "pan" : "static");
+                report("map", n, mode, t);
+            }
+        }
+    }
+}
+#endif
+
+#ifdef BEWE_BENCH_GLOBE
+static void bench_globe(int frames, int w, int h){
+    GlobeRenderer globe;
+    if(!globe.init()){ fprintf(stderr, "globe init failed\n"); return; }
+    globe.set_viewport(w, h);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> U(0.f, 1.f);
+    const int counts[] = { 1000, 10000, 30000 };
+    for(int n : counts){
+        // 구면 균일 + LEO 고도 (r 1.05–1.3)
+        std::vector<GlobeRenderer::Marker> mk(n);
+        for(auto& m : mk){
+            float z = 2.f * U(rng) - 1.f, ph = 6.2831853f * U(rng), r = 1.05f + 0.25f * U(rng);
+            float s = std::sqrt(1.f - z * z);
+            m = { r * s * std::cos(ph), r * z, r * s * std::sin(ph), IM_COL32(80, 160, 255, 255), 4.5f };
+        }
+        for(int mode = 0; mode < 2; mode++){
+            if(mode == 1) globe.set_markers(mk.data(), n);
+            auto pre = [&](int){
+                glEnable(GL_DEPTH_TEST);
+                globe.render();
+                glDisable(GL_DEPTH_TEST);
+            };
+            auto body = [&](int){
+                if(mode == 1){ globe.draw_markers(); return; }
+                // 기존 경로: 위성마다 project_world + 8 겹 원 + 코어
+                ImDrawList* fdl = ImGui::GetForegroundDrawList();
+                for(const auto& m : mk){
+                    float sx, sy;
+                    if(!globe.project_world(m.x, m.y, m.z, sx, sy)) continue;
+                    for(int k = 7; k >= 0; k--){
+                        float t = k / 7.f, r = 0.75f + (4.5f - 0.75f) * t;
+                        unsigned a = (unsigned)(240.f * (1.f - t) * (1.f - t) + 15.f);
+                        fdl->AddCircleFilled(ImVec2(sx, sy), r, (m.rgba & 0x00FFFFFFu) | (a << 24), 16);
+                    }
+                    fdl->AddCircleFilled(ImVec2(sx, sy), 0.75f, IM_COL32(255, 255, 255, 230), 8);
+                }
+            };
+            Timing t = run_frames(frames, w, h, pre, body);
+            report("globe", n, mode ? "instanced markers" : "imgui markers (old)", t);
+        }
+        globe.set_markers(nullptr, 0);
+    }
+    globe.destroy();
+}
+#endif
+
+int main(int argc, char** argv){
+    int frames = argc > 1 ? atoi(argv[1]) : 60;
+    int w      = argc > 2 ? atoi(argv[2]) : 1600;
+    int h      = argc > 3 ? atoi(argv[3]) : 900;
+    GLuint fbo = 0;
+    if(!egl_context(w, h, fbo)) return 1;
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGui::GetIO().IniFilename = nullptr;
+    if(!ImGui_ImplOpenGL3_Init("#version 330")){ fprintf(stderr, "ImGui GL3 backend init failed\n"); return 1; }
+
+    printf("%-8s %8s  %-22s %9s %9s %9s %10s\n", "scene", "targets", "mode",
+           "build ms", "draw ms", "frame ms", "vertices");
+#ifdef BEWE_BENCH_MAP
+    bench_map(frames, w, h);
+#endif
+#ifdef BEWE_BENCH_GLOBE
+    bench_globe(frames, w, h);
+#endif
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui::DestroyContext();
+    return 0;
+}
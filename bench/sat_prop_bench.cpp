@@ -0,0 +1,175 @@
+// ── SGP4 일괄 전파 벤치마크 ──────────────────────────────────────────────
+// TLE 카탈로그 스냅샷(또는 합성 카탈로그)을 한 시각에 전부 전파.
+// 보고: objects/s — tle_propagate (기존 UI 경로, 객체마다 elsetrec 복사) vs
+//       SatProp::Batch (SoA + SIMD 레인, 1 스레드 / 전 스레드),
+//       batch 와 scalar 결과 최대 차이, PassService 24 h 패스 예측 소요 시간.
+//
+//   sat_prop_bench [tle_file | synth] [n_synth=12000] [pass_objs=500]
+//   (celestrak GROUP=active 스냅샷: assets/tle/leo_tle.txt)
+#include "sat_prop.hpp"
+#include "sat_tle.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+void bewe_log_push(int, const char* fmt, ...){
+    if(!getenv("BENCH_VERBOSE")) return;
+    va_list ap; va_start(ap, fmt); vfprintf(stderr, fmt, ap); va_end(ap);
+}
+
+static double wall_now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void put(char* line, int col, const char* s){ memcpy(line + col, s, strlen(s)); }
+
+// TLE 지수 필드 " 12345-4" = 0.12345e-4
+static void exp_field(char* out, double v){
+    if(v == 0){ strcpy(out, " 00000-0"); return; }
+    int e = (int)std::floor(std::log10(std::fabs(v))) + 1;
+    int mant = (int)std::lround(std::fabs(v) / std::pow(10.0, e) * 1e5);
+    if(mant >= 100000){ mant /= 10; e++; }
+    snprintf(out, 9, "%c%05d%c%d", v < 0 ? '-' : ' ', mant, e < 0 ? '-' : '+', std::abs(e));
+}
+
+// LEO 70% / 고경사 LEO 10% / MEO(GNSS) 10% / GEO 10% — 실제 카탈로그와 비슷한 구성.
+static std::string synth_catalogue(int n, int yy, double doy){
+    std::string path = "/tmp/sat_prop_bench_tle.txt";
+    FILE* fp = fopen(path.c_str(), "w");
+    if(!fp) return "";
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    for(int i = 0; i < n; i++){
+        double r = U(rng), mm, ecc, inc, bstar;
+        if(r < 0.7)      { mm = 14.0 + 2.0 * U(rng); ecc = 0.02 * U(rng);  inc = 98 * U(rng) + 0.5; bstar = 1e-5 + 5e-4 * U(rng); }
+        else if(r < 0.8) { mm = 11.0 + 3.0 * U(rng); ecc = 0.1 * U(rng);   inc = 60 + 40 * U(rng);  bstar = 1e-5 * U(rng); }
+        else if(r < 0.9) { mm = 2.0 + 0.01 * U(rng); ecc = 0.01 * U(rng);  inc = 55 + 10 * U(rng);  bstar = 0; }
+        else             { mm = 1.0027;              ecc = 0.001 * U(rng); inc = 0.1 * U(rng);      bstar = 0; }
+        char l1[72], l2[72], f[32];
+        memset(l1, ' ', 69); l1[69] = 0;
+        memset(l2, ' ', 69); l2[69] = 0;
+        int cat = 10000 + i;
+        put(l1, 0, "1");
+        snprintf(f, sizeof f, "%05dU", cat);              put(l1, 2, f);
+        snprintf(f, sizeof f, "%02d%012.8f", yy, doy);    put(l1, 18, f);
+        put(l1, 33, " .00000100");
+        put(l1, 44, " 00000-0");
+        exp_field(f, bstar);                              put(l1, 53, f);
+        put(l1, 62, "0  9990");
+        put(l2, 0, "2");
+        snprintf(f, sizeof f, "%05d", cat);               put(l2, 2, f);
+        snprintf(f, sizeof f, "%8.4f", inc);              put(l2, 8, f);
+        snprintf(f, sizeof f, "%8.4f", 360 * U(rng));     put(l2, 17, f);
+        snprintf(f, sizeof f, "%07d", (int)(ecc * 1e7));  put(l2, 26, f);
+        snprintf(f, sizeof f, "%8.4f", 360 * U(rng));     put(l2, 34, f);
+        snprintf(f, sizeof f, "%8.4f", 360 * U(rng));     put(l2, 43, f);
+        snprintf(f, sizeof f, "%11.8f", mm);              put(l2, 52, f);
+        put(l2, 63, "000010");
+        fprintf(fp, "SYN-%d\n%s\n%s\n", cat, l1, l2);
+    }
+    fclose(fp);
+    return path;
+}
+
+int main(int argc, char** argv){
+    std::string src = argc > 1 ? argv[1] : "synth";
+    int n_synth   = argc > 2 ? atoi(argv[2]) : 12000;
+    int pass_objs = argc > 3 ? atoi(argv[3]) : 500;
+
+    std::vector<TleElem> cat;
+    bool synth = (src == "synth");
+    std::string path = src;
+    if(synth){   // epoch = 어제 (PassService 는 현재 시각부터 예측)
+        time_t y = time(nullptr) - 86400;
+        struct tm g; gmtime_r(&y, &g);
+        path = synth_catalogue(n_synth, g.tm_year % 100,
+                               g.tm_yday + 1 + (g.tm_hour * 3600 + g.tm_min * 60 + g.tm_sec) / 86400.0);
+    }
+    if(!tle_load(path, cat) || cat.empty()){
+        fprintf(stderr, "sat_prop_bench: no TLEs from %s\n", path.c_str());
+        return 1;
+    }
+    // 기준 시각: 카탈로그 평균 epoch + 2 일 (스냅샷 직후 며칠이 실사용 구간)
+    double ep = 0;
+    for(auto& e : cat) ep += e.satrec.jdsatepoch + e.satrec.jdsatepochF;
+    ep /= cat.size();
+    time_t T = (time_t)((ep + 2.0 - 2440587.5) * 86400.0);
+
+    SatProp::Batch b;
+    double t0 = wall_now();
+    b.build(cat);
+    double t_build = wall_now() - t0;
+    size_t n = cat.size();
+    int hw = (int)std::thread::hardware_concurrency();
+    printf("sat_prop_bench: %zu objects (%zu near-earth, %zu deep-space) from %s, build %.1f ms\n",
+           n, n - b.deep_count(), b.deep_count(), synth ? "synthetic catalogue" : path.c_str(),
+           t_build * 1e3);
+    printf("%-26s %7s %13s %11s\n", "path", "threads", "objects/s", "ns/object");
+
+    std::vector<double> la(n), lo(n), al(n), rla(n), rlo(n), ral(n);
+    std::vector<uint8_t> ok(n);
+    auto report = [&](const char* name, int thr, int reps, double dt){
+        double ops = (double)n * reps / dt;
+        printf("%-26s %7d %13.0f %11.1f\n", name, thr, ops, 1e9 / ops);
+    };
+
+    // 1) 기존 경로: 객체마다 tle_propagate
+    int reps = std::max(1, (int)(200000 / n));
+    t0 = wall_now();
+    for(int r = 0; r < reps; r++)
+        for(size_t i = 0; i < n; i++) tle_propagate(cat[i], T + r, rla[i], rlo[i], ral[i]);
+    report("tle_propagate (scalar)", 1, reps, wall_now() - t0);
+    for(size_t i = 0; i < n; i++) tle_propagate(cat[i], T, rla[i], rlo[i], ral[i]);
+
+    // 2) Batch
+    int thr_list[2] = { 1, std::max(1, std::min(hw, 8)) };
+    for(int k = 0; k < 2; k++){
+        int thr = thr_list[k];
+        reps = std::max(3, (int)(2000000 / n));
+        b.geodetic((double)T, la.data(), lo.data(), al.data(), ok.data(), thr);   // warm
+        t0 = wall_now();
+        for(int r = 0; r < reps; r++)
+            b.geodetic((double)(T + r), la.data(), lo.data(), al.data(), ok.data(), thr);
+        report("SatProp::Batch::geodetic", thr, reps, wall_now() - t0);
+        if(k == 0 && thr_list[1] == 1) break;
+    }
+
+    // 3) 정확도: batch vs tle_propagate 같은 시각
+    b.geodetic((double)T, la.data(), lo.data(), al.data(), ok.data());
+    double dlat = 0, dlon = 0, dalt = 0;
+    size_t errs = 0;
+    for(size_t i = 0; i < n; i++){
+        if(!ok[i]){ errs++; continue; }
+        double dl = std::fabs(lo[i] - rlo[i]); if(dl > 180) dl = 360 - dl;
+        dlat = std::max(dlat, std::fabs(la[i] - rla[i]));
+        dlon = std::max(dlon, dl);
+        dalt = std::max(dalt, std::fabs(al[i] - ral[i]));
+    }
+    printf("max |batch - scalar|: lat %.2e deg, lon %.2e deg, alt %.2e km  (%zu SGP4 errors)\n",
+           dlat, dlon, dalt, errs);
+
+    // 4) 패스 예측: 서울 근방 지상국, 24 h
+    pass_objs = (int)std::min<size_t>((size_t)pass_objs, n);
+    if(pass_objs > 0){
+        SatProp::PassService ps;
+        ps.set_station(37.5665, 126.978, 0.05);
+        t0 = wall_now();
+        for(int i = 0; i < pass_objs; i++) ps.request(cat[i]);
+        while(ps.busy()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        double dt = wall_now() - t0;
+        size_t total = 0;
+        std::vector<SatProp::Pass> v;
+        for(int i = 0; i < pass_objs; i++)
+            if(ps.passes(cat[i].catalog_num, time(nullptr), v)) total += v.size();
+        printf("PassService: %d objects x 24 h -> %zu passes in %.2f s (%.1f ms/object)\n",
+               pass_objs, total, dt, dt * 1e3 / pass_objs);
+    }
+    return 0;
+}
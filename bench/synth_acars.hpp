@@ -0,0 +1,75 @@
+#pragma once
+// ── ACARS 합성기 (벤치마크용, ARINC 618) ─────────────────────────────────────
+// 블록 (SOH mode reg ack label blk STX text ETX) → 7-bit 홀수 패리티 → BCS (CRC-16
+// reflected 0x8408, SOH 다음부터 ETX 까지) → pre-key + "+*" + SYN SYN 앞붙임
+// → 2400 bps MSK 오디오 (1200/2400 Hz, 비트 = 직전 비트와 같으면 2400 Hz) → DSB-AM.
+// 출력 = 단위 전력 복소 baseband (반송파 = 채널 중심).
+#include "synth_common.hpp"
+#include <cstring>
+#include <string>
+
+namespace SynthAcars {
+
+using SynthCommon::cf;
+
+inline uint8_t odd_parity(uint8_t c){
+    c &= 0x7F;
+    return (uint8_t)(__builtin_popcount(c)&1 ? c : (c|0x80));
+}
+
+inline uint16_t bcs(const uint8_t* p, int n){
+    uint16_t c = 0;
+    for(int i=0;i<n;i++){ c ^= p[i]; for(int k=0;k<8;k++) c = (c&1) ? (c>>1)^0x8408 : (c>>1); }
+    return c;
+}
+
+// 다운링크 블록: reg 7자 ("." 패딩), label 2자, blk '0'..'9', text ≤ 220자
+inline std::vector<uint8_t> block(const char* reg, const char* label, char blk, const std::string& text){
+    std::vector<uint8_t> body;
+    body.push_back(odd_parity('2'));                          // mode (Category A)
+    char r[8]; memset(r, '.', 7); r[7] = 0;
+    size_t rl = strlen(reg); if(rl > 7) rl = 7;
+    memcpy(r + 7 - rl, reg, rl);
+    for(int i=0;i<7;i++) body.push_back(odd_parity((uint8_t)r[i]));
+    body.push_back(odd_parity(0x15));                         // ack = NAK
+    body.push_back(odd_parity((uint8_t)label[0]));
+    body.push_back(odd_parity((uint8_t)label[1]));
+    body.push_back(odd_parity((uint8_t)blk));
+    body.push_back(odd_parity(0x02));                         // STX
+    for(char c : text) body.push_back(odd_parity((uint8_t)c));
+    body.push_back(odd_parity(0x03));                         // ETX
+    uint16_t c = bcs(body.data(), (int)body.size());
+
+    std::vector<uint8_t> out;
+    for(int i=0;i<16;i++) out.push_back(0xFF);                // pre-key (128 bit 1)
+    out.push_back(odd_parity('+')); out.push_back(odd_parity('*'));
+    out.push_back(odd_parity(0x16)); out.push_back(odd_parity(0x16));
+    out.push_back(odd_parity(0x01));                          // SOH
+    out.insert(out.end(), body.begin(), body.end());
+    out.push_back((uint8_t)(c & 0xFF)); out.push_back((uint8_t)(c >> 8));
+    out.push_back(0xFF);                                      // DEL (후미)
+    return out;
+}
+
+// 바이트열 → MSK 오디오 (LSB-first) → AM (변조도 m) → out append. fs 는 오디오/채널 레이트.
+inline void burst(std::vector<cf>& out, const std::vector<uint8_t>& bytes, double fs, float m=0.5f){
+    const double spb = fs/2400.0;
+    const float  A = 1.f/std::sqrt(1.f + m*m*0.5f);           // 버스트 평균 전력 1
+    double ph = 0, t = 0;
+    int prev = 1;
+    size_t nb = bytes.size()*8;
+    for(size_t k=0;k<nb;k++){
+        int bit = (bytes[k>>3] >> (k&7)) & 1;
+        double f = (bit == prev) ? 2400.0 : 1200.0;
+        prev = bit;
+        double w = 2.0*M_PI*f/fs;
+        double end = (k+1)*spb;
+        for(; t < end; t += 1.0){
+            float a = (float)std::sin(ph);
+            out.emplace_back(A*(1.f + m*a), 0.f);
+            ph = std::remainder(ph + w, 2.0*M_PI);
+        }
+    }
+}
+
+} // namespace SynthAcars
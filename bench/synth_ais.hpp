@@ -0,0 +1,81 @@
+#pragma once
+// ── AIS 합성기 (벤치마크용, ITU-R M.1371) ────────────────────────────────────
+// 메시지 1 (Class A 위치보고, 168 bit) → HDLC (옥텟 LSB-first + FCS CRC-16 + 비트스터핑
+// + 플래그 0x7E) → 트레이닝 24 bit 교번 앞붙임 → NRZI → GMSK (BT 0.4, h 0.5, 9600 bps).
+// 출력 = 단위 진폭 복소 baseband (채널 중심), 열화는 SynthCommon::Channel.
+#include "synth_common.hpp"
+#include <cstring>
+
+namespace SynthAis {
+
+using SynthCommon::cf;
+
+inline void putbits(uint8_t* bits, int start, int len, uint32_t v){   // MSB-first
+    for(int i=0;i<len;i++) bits[start+i] = (uint8_t)((v>>(len-1-i))&1);
+}
+
+// 메시지 1: mmsi, 위치 (도), SOG (kn), COG (도). bits[168]
+inline void msg1(uint8_t bits[168], uint32_t mmsi, double lat, double lon, float sog, float cog){
+    memset(bits, 0, 168);
+    putbits(bits, 0, 6, 1);
+    putbits(bits, 8, 30, mmsi);
+    putbits(bits, 38, 4, 0);                                  // under way
+    putbits(bits, 42, 8, 128);                                // ROT n/a
+    putbits(bits, 50, 10, (uint32_t)(sog*10.f));
+    putbits(bits, 61, 28, (uint32_t)(int32_t)std::lround(lon*600000.0) & 0x0FFFFFFF);
+    putbits(bits, 89, 27, (uint32_t)(int32_t)std::lround(lat*600000.0) & 0x07FFFFFF);
+    putbits(bits, 116, 12, (uint32_t)(cog*10.f));
+    putbits(bits, 128, 9, 511);                               // heading n/a
+    putbits(bits, 137, 6, 60);
+}
+
+// HDLC FCS (reflected 0x8408, init 0xFFFF, 반전) — 디코더 잔차 0x0F47 검사와 짝
+inline uint16_t fcs16(const uint8_t* data, int len){
+    uint16_t crc = 0xFFFF;
+    for(int i=0;i<len;i++){
+        crc ^= data[i];
+        for(int b=0;b<8;b++) crc = (crc&1) ? (crc>>1)^0x8408 : (crc>>1);
+    }
+    return (uint16_t)~crc;
+}
+
+// 메시지 비트 (MSB-first, nbits%8==0) → on-air 데이터 비트 (NRZI 전)
+inline std::vector<uint8_t> frame_bits(const uint8_t* msg, int nbits){
+    int nb = nbits/8;
+    std::vector<uint8_t> oct(nb+2);
+    for(int j=0;j<nb;j++){ uint8_t v=0; for(int i=0;i<8;i++) v=(uint8_t)((v<<1)|msg[j*8+i]); oct[j]=v; }
+    uint16_t f = fcs16(oct.data(), nb);
+    oct[nb] = (uint8_t)(f & 0xFF); oct[nb+1] = (uint8_t)(f >> 8);
+
+    std::vector<uint8_t> out;
+    for(int i=0;i<24;i++) out.push_back((uint8_t)(i&1));      // 트레이닝 0101..
+    auto flag = [&]{ for(int i=0;i<8;i++) out.push_back((uint8_t)(i!=0 && i!=7)); };
+    flag();
+    int ones = 0;
+    for(uint8_t o : oct) for(int b=0;b<8;b++){                // 옥텟 LSB-first + 비트스터핑
+        uint8_t v = (o>>b)&1;
+        out.push_back(v);
+        if(v){ if(++ones==5){ out.push_back(0); ones=0; } }
+        else ones = 0;
+    }
+    flag();
+    for(int i=0;i<8;i++) out.push_back(0);                    // ramp-down 여유
+    return out;
+}
+
+// 데이터 비트 → NRZI (0 = 레벨 전환) → GMSK. out 에 append.
+inline void burst(std::vector<cf>& out, const std::vector<uint8_t>& bits, double fs){
+    const double sps = fs/9600.0;
+    std::vector<float> lv; lv.reserve(bits.size());
+    float level = 1.f;
+    for(uint8_t b : bits){ if(!b) level = -level; lv.push_back(level); }
+    static thread_local std::vector<float> h; static thread_local double h_sps = 0;
+    if(h_sps != sps){ h = SynthCommon::gauss_taps(0.4, sps); h_sps = sps; }
+    std::vector<float> w = SynthCommon::shape(lv, sps, h);
+    const float dev = (float)(2.0*M_PI*2400.0/fs);            // h=0.5 → ±Rb/4
+    for(auto& v : w) v *= dev;
+    double ph = 0;
+    SynthCommon::fm_mod(w, out, ph);
+}
+
+} // namespace SynthAis
@@ -0,0 +1,78 @@
+#pragma once
+// ── BLE 광고 합성기 (벤치마크용, Bluetooth Core Vol 6 Part B) ─────────────────
+// ADV_NONCONN_IND (AdvA + AD: Flags, Complete Local Name) → CRC-24 (init 0x555555)
+// → 채널 인덱스 화이트닝 → 프리앰블 + 광고 AA 0x8E89BED6 (전부 LSB-first)
+// → GFSK 1 Mbit/s (BT 0.5, h 0.5 → ±250 kHz).
+#include "synth_common.hpp"
+#include <cstring>
+
+namespace SynthBtle {
+
+using SynthCommon::cf;
+
+static constexpr uint32_t ADV_AA = 0x8E89BED6u;
+
+// CRC-24: LFSR (reversed poly 0xDA6000) 에 init 을 비트역전해 로드, 데이터 LSB-first
+inline uint32_t crc24(const uint8_t* d, int n, uint32_t init){
+    uint32_t crc = 0;
+    for(int b=0;b<24;b++) if(init & (1u<<b)) crc |= 1u<<(23-b);
+    for(int i=0;i<n;i++)
+        for(int b=0;b<8;b++){
+            uint32_t in = (d[i]>>b)&1, out = crc&1;
+            crc >>= 1;
+            if(in^out) crc ^= 0xDA6000;
+        }
+    return crc & 0xFFFFFF;
+}
+
+// PDU (헤더 2 + 페이로드). mac[0] = 최상위 바이트 (표기순).
+inline std::vector<uint8_t> adv_nonconn(const uint8_t mac[6], const char* name){
+    std::vector<uint8_t> pl;
+    for(int i=5;i>=0;i--) pl.push_back(mac[i]);               // AdvA on-air LSB 바이트 먼저
+    pl.push_back(2); pl.push_back(0x01); pl.push_back(0x06);  // Flags: LE General | BR/EDR 미지원
+    size_t nl = strlen(name); if(nl > 20) nl = 20;
+    pl.push_back((uint8_t)(nl+1)); pl.push_back(0x09);
+    pl.insert(pl.end(), name, name+nl);
+    std::vector<uint8_t> pdu;
+    pdu.push_back((uint8_t)(0x02 | (1<<6)));                  // ADV_NONCONN_IND, TxAdd=random
+    pdu.push_back((uint8_t)pl.size());
+    pdu.insert(pdu.end(), pl.begin(), pl.end());
+    return pdu;
+}
+
+// PDU → 에어 비트 (프리앰블 + AA + 화이트닝된 PDU·CRC)
+inline std::vector<uint8_t> air_bits(const std::vector<uint8_t>& pdu, int chan){
+    std::vector<uint8_t> bits;
+    uint8_t pre = (ADV_AA & 1) ? 0x55 : 0xAA;
+    for(int b=0;b<8;b++) bits.push_back((pre>>b)&1);
+    for(int B=0;B<4;B++) for(int b=0;b<8;b++) bits.push_back((uint8_t)((ADV_AA>>(8*B+b))&1));
+    std::vector<uint8_t> body = pdu;
+    uint32_t c = crc24(pdu.data(), (int)pdu.size(), 0x555555);
+    body.push_back((uint8_t)c); body.push_back((uint8_t)(c>>8)); body.push_back((uint8_t)(c>>16));
+    uint8_t r[7]; r[0] = 1;                                   // 화이트닝 LFSR x^7+x^4+1
+    for(int i=0;i<6;i++) r[1+i] = (uint8_t)((chan>>(5-i))&1);
+    for(uint8_t v : body) for(int b=0;b<8;b++){
+        uint8_t w = r[6];
+        for(int i=6;i>0;i--) r[i] = r[i-1];
+        r[0] = w; r[4] ^= w;
+        bits.push_back((uint8_t)(((v>>b)&1) ^ w));
+    }
+    return bits;
+}
+
+inline void burst(std::vector<cf>& out, const std::vector<uint8_t>& bits, double fs){
+    const double sps = fs/1e6;
+    std::vector<float> lv; lv.reserve(bits.size()+2);
+    lv.push_back(bits.empty() ? -1.f : (bits[0] ? -1.f : 1.f));   // 램프 1 bit
+    for(uint8_t b : bits) lv.push_back(b ? 1.f : -1.f);
+    lv.push_back(lv.back());
+    static thread_local std::vector<float> h; static thread_local double h_sps = 0;
+    if(h_sps != sps){ h = SynthCommon::gauss_taps(0.5, sps); h_sps = sps; }
+    std::vector<float> w = SynthCommon::shape(lv, sps, h);
+    const float dev = (float)(2.0*M_PI*250e3/fs);
+    for(auto& v : w) v *= dev;
+    double ph = 0;
+    SynthCommon::fm_mod(w, out, ph);
+}
+
+} // namespace SynthBtle
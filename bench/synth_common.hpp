@@ -0,0 +1,171 @@
+#pragma once
+// ── 합성기 공용: 채널 열화 + 변조 원시함수 (벤치마크용) ─────────────────────
+// 모든 합성기는 버스트 구간 전력 1 (|x|=1) 인 복소 baseband 를 만들고, 버스트 사이는 0.
+// Channel 이 그 위에 CFO 회전 · CW 간섭 · AWGN 을 얹는다.
+//   SNR  = 버스트 전력 / 샘플레이트 대역 전체 잡음 전력 (채널 필터 전, 1/(2σ²))
+//   CW   = 버스트 전력 대비 dBc, 중심에서 cw_hz 떨어진 연속파 (인접 채널 누설/스퍼 모사)
+// 상태(위상)는 호출 간 연속 → 청크 단위로 apply 해도 결과 동일.
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace SynthCommon {
+
+using cf = std::complex<float>;
+
+class Channel {
+public:
+    Channel(double fs, uint32_t seed) : fs_(fs), rng_(seed) {}
+
+    void set_snr(float snr_db){ sigma_ = (float)std::sqrt(0.5 / std::pow(10.0, snr_db/10.0)); }
+    void set_cfo(double hz){ cfo_w_ = 2.0*M_PI*hz/fs_; }
+    void set_cw(float dbc, double hz){
+        cw_a_ = dbc > -150.f ? (float)std::pow(10.0, dbc/20.0) : 0.f;
+        cw_w_ = 2.0*M_PI*hz/fs_;
+    }
+
+    void apply(cf* x, size_t n){
+        for(size_t i=0;i<n;i++){
+            cf v = x[i];
+            if(cfo_w_ != 0.0){
+                v *= cf((float)std::cos(cfo_ph_), (float)std::sin(cfo_ph_));
+                cfo_ph_ = std::remainder(cfo_ph_ + cfo_w_, 2.0*M_PI);
+            }
+            if(cw_a_ > 0.f){
+                v += cw_a_ * cf((float)std::cos(cw_ph_), (float)std::sin(cw_ph_));
+                cw_ph_ = std::remainder(cw_ph_ + cw_w_, 2.0*M_PI);
+            }
+            x[i] = v + cf(nd_(rng_)*sigma_, nd_(rng_)*sigma_);
+        }
+    }
+    void apply(std::vector<cf>& x){ apply(x.data(), x.size()); }
+
+private:
+    double fs_;
+    std::mt19937 rng_;
+    std::normal_distribution<float> nd_{0.f, 1.f};
+    float  sigma_ = 0.f;
+    double cfo_w_ = 0, cfo_ph_ = 0;
+    float  cw_a_ = 0.f;
+    double cw_w_ = 0, cw_ph_ = 0;
+};
+
+// 순시주파수 열 (rad/sample) → 위상 연속 단위 진폭 복소. ph 는 버스트 간 이어짐.
+inline void fm_mod(const std::vector<float>& w, std::vector<cf>& out, double& ph){
+    for(float d : w){
+        ph = std::remainder(ph + d, 2.0*M_PI);
+        out.emplace_back((float)std::cos(ph), (float)std::sin(ph));
+    }
+}
+
+// 비트/심볼 레벨 → sps 배 업샘플 (NRZ 직사각) 후 탭 컨볼루션. 출력 길이 = 심볼수*sps.
+// (sps 는 비정수 허용: 심볼 k 는 [k*sps, (k+1)*sps) 샘플 구간)
+inline std::vector<float> shape(const std::vector<float>& sym, double sps, const std::vector<float>& h){
+    size_t n = (size_t)std::ceil(sym.size()*sps);
+    std::vector<float> nrz(n, 0.f);
+    for(size_t i=0;i<n;i++){ size_t k=(size_t)(i/sps); if(k<sym.size()) nrz[i]=sym[k]; }
+    if(h.size() <= 1) return nrz;
+    std::vector<float> y(n, 0.f);
+    int half = (int)h.size()/2;
+    for(size_t i=0;i<n;i++){
+        float a = 0;
+        for(size_t t=0;t<h.size();t++){
+            long j = (long)i + half - (long)t;
+            if(j>=0 && j<(long)n) a += h[t]*nrz[j];
+        }
+        y[i] = a;
+    }
+    return y;
+}
+
+// 심볼 임펄스 (k*sps 위치, 크기 sym·sps) 에 탭 컨볼루션 — RRC 성형용 (DC 이득 1 탭 → 레벨 보존)
+inline std::vector<float> shape_imp(const std::vector<float>& sym, double sps, const std::vector<float>& h){
+    size_t n = (size_t)std::ceil(sym.size()*sps);
+    std::vector<float> imp(n, 0.f);
+    for(size_t k=0;k<sym.size();k++){ size_t i=(size_t)std::lround(k*sps); if(i<n) imp[i]=sym[k]*(float)sps; }
+    std::vector<float> y(n, 0.f);
+    int half = (int)h.size()/2;
+    for(size_t i=0;i<n;i++){
+        if(imp[i]==0.f) continue;
+        for(size_t t=0;t<h.size();t++){
+            long j = (long)i - half + (long)t;
+            if(j>=0 && j<(long)n) y[j] += h[t]*imp[i];
+        }
+    }
+    return y;
+}
+
+// GMSK/GFSK 가우시안 주파수 펄스 (NRZ 에 컨볼루션, DC 이득 1). bt = BT 곱, sps = samples/bit.
+inline std::vector<float> gauss_taps(double bt, double sps, int span_bits=3){
+    int half = (int)std::ceil(span_bits*sps/2.0);
+    std::vector<float> h(2*half+1);
+    double sig = std::sqrt(std::log(2.0)) / (2.0*M_PI*bt) * sps;   // 샘플 단위 σ
+    double sum = 0;
+    for(int i=-half;i<=half;i++){ double v=std::exp(-0.5*(i/sig)*(i/sig)); h[i+half]=(float)v; sum+=v; }
+    for(auto& v : h) v = (float)(v/sum);
+    return h;
+}
+
+// RRC (DC 이득 1) — 송신 성형 / 수신 정합 공용
+inline std::vector<float> rrc_taps(double sps, double alpha, int span=4){
+    int half = std::max(1, (int)std::lround(span*sps));
+    std::vector<float> h(2*half+1);
+    double sum = 0;
+    for(int n=0;n<2*half+1;n++){
+        double t=(n-half)/sps, v;
+        if(std::fabs(t)<1e-9) v=1.0-alpha+4.0*alpha/M_PI;
+        else if(std::fabs(std::fabs(t)-1.0/(4.0*alpha))<1e-9)
+            v=alpha/std::sqrt(2.0)*((1+2/M_PI)*std::sin(M_PI/(4*alpha))+(1-2/M_PI)*std::cos(M_PI/(4*alpha)));
+        else v=(std::sin(M_PI*t*(1-alpha))+4*alpha*t*std::cos(M_PI*t*(1+alpha)))
+              /(M_PI*t*(1-(4*alpha*t)*(4*alpha*t)));
+        h[n]=(float)v; sum+=v;
+    }
+    for(auto& v : h) v = (float)(v/sum);
+    return h;
+}
+
+// ── 수신 프런트엔드 (decode_bench: 워커의 DDC 채널필터 근사, 채널 레이트에서 적용) ──
+// 4단 1차 IIR (워커 IIR1 ×4 cascade, ACARS/AIS/DMR)
+struct ChanIir {
+    float a = 0, b = 1; cf s[4] = {};
+    void set(double cut_hz, double fs){ a = (float)std::exp(-2.0*M_PI*cut_hz/fs); b = 1.f - a; }
+    inline cf p(cf x){ for(auto& v : s){ v = a*v + b*x; x = v; } return x; }
+};
+// Blackman 윈도 sinc FIR (BTLE 채널뱅크 근사). 스트리밍, 출력 지연 = (taps-1)/2.
+struct ChanFir {
+    std::vector<float> h; std::vector<cf> z; size_t pos = 0;
+    void init(double cut_hz, double fs, int taps){
+        h.assign(taps, 0.f); z.assign(2*taps, cf(0,0)); pos = 0;
+        double fc = cut_hz/fs, c = 0.5*(taps-1), sum = 0;
+        for(int n=0;n<taps;n++){
+            double x = n - c, sinc = std::fabs(x) < 1e-9 ? 2*fc : std::sin(2*M_PI*fc*x)/(M_PI*x);
+            double w = 0.42 - 0.5*std::cos(2*M_PI*n/(taps-1)) + 0.08*std::cos(4*M_PI*n/(taps-1));
+            h[n] = (float)(sinc*w); sum += h[n];
+        }
+        for(auto& v : h) v = (float)(v/sum);
+    }
+    inline cf p(cf x){
+        size_t T = h.size();
+        z[pos] = z[pos+T] = x;
+        if(++pos >= T) pos = 0;
+        cf a(0,0);
+        for(size_t t=0;t<T;t++) a += h[t]*z[pos+t];
+        return a;
+    }
+};
+
+// FM 판별 (워커들과 같은 식: arg(z·conj(prev)))
+struct Discrim {
+    float pi = 0, pq = 0;
+    inline float p(cf z){
+        float oi=z.real(), oq=z.imag();
+        float d = std::atan2(oq*pi - oi*pq, oi*pi + oq*pq + 1e-20f);
+        pi=oi; pq=oq;
+        return d;
+    }
+};
+
+} // namespace SynthCommon
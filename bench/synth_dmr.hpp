@@ -0,0 +1,74 @@
+#pragma once
+// ── DMR 합성기 (벤치마크용, ETSI TS 102 361-1) ───────────────────────────────
+// CSBK (96 bit, CRC-16 CCITT ⊕ 마스크) → BPTC(196,96) 인코드 (행 H(15,11) · 열 H(13,9)
+// · ×181 인터리브) + Slot Type Golay(20,8) + BS_DATA sync → 132 디비트 버스트
+// → 4FSK (±648/±1944 Hz, RRC α=0.2 송신 성형, 4800 sym/s).
+// 인코더 원시함수는 디코더와 같은 dmr_fec.hpp / dmr_sync.hpp (패리티식/패턴 공유).
+#include "synth_common.hpp"
+#include "dmr_sync.hpp"
+#include "dmr_fec.hpp"
+
+namespace SynthDmr {
+
+using SynthCommon::cf;
+
+// CSBK p96: LB=1 PF=0 CSBKO FID=0 dst(24) src(24) 0(16) CRC(16)
+inline void csbk(uint8_t p96[96], int csbko, uint32_t dst, uint32_t src){
+    memset(p96, 0, 96);
+    p96[0] = 1;
+    dmr::uint_to_bits((uint32_t)csbko & 0x3F, p96+2, 6);
+    dmr::uint_to_bits(dst & 0xFFFFFF, p96+16, 24);
+    dmr::uint_to_bits(src & 0xFFFFFF, p96+40, 24);
+    uint16_t c = (uint16_t)(dmr::crc16_ccitt(p96, 80) ^ 0x5A5A);   // ~crc ⊕ CSBK 마스크 0xA5A5
+    dmr::uint_to_bits(c, p96+80, 16);
+}
+
+// BPTC(196,96) 인코드 → on-air 196 bit (bptc196_96 의 역)
+inline void bptc_encode(const uint8_t p96[96], uint8_t onair[196]){
+    uint8_t M[13][15] = {};
+    int o = 0;
+    for(int c=3;c<=10;c++) M[0][c] = p96[o++];
+    for(int r=1;r<=8;r++) for(int c=0;c<=10;c++) M[r][c] = p96[o++];
+    for(int r=0;r<9;r++) dmr::h15_11_par(M[r], M[r]+11);
+    for(int c=0;c<15;c++){
+        uint8_t col[9], par[4];
+        for(int r=0;r<9;r++) col[r] = M[r][c];
+        dmr::h13_9_par(col, par);
+        for(int r=0;r<4;r++) M[9+r][c] = par[r];
+    }
+    uint8_t m[196]; m[0] = 0;
+    for(int r=0;r<13;r++) for(int c=0;c<15;c++) m[1+r*15+c] = M[r][c];
+    for(int i=0;i<196;i++) onair[(i*181)%196] = m[i];
+}
+
+// 데이터 버스트 132 심볼 (±1/±3): INFO 98 | SlotType 10 | SYNC 48 | SlotType 10 | INFO 98
+inline std::vector<float> data_burst(const uint8_t p96[96], int color_code, int data_type,
+                                     dmr::SyncType sync = dmr::SyncType::BS_DATA){
+    uint8_t info[196]; bptc_encode(p96, info);
+    uint32_t st = dmr::golay20_8_encode((uint8_t)(((color_code&0xF)<<4) | (data_type&0xF)));
+    uint64_t sw = 0;
+    for(int p=0;p<dmr::N_SYNC;p++) if(dmr::SYNC_PATTERNS[p].type == sync) sw = dmr::SYNC_PATTERNS[p].bits48;
+    uint8_t bits[264];
+    memcpy(bits, info, 98);
+    for(int i=0;i<10;i++) bits[98+i]  = (uint8_t)((st>>(19-i))&1);
+    for(int i=0;i<48;i++) bits[108+i] = (uint8_t)((sw>>(47-i))&1);
+    for(int i=0;i<10;i++) bits[156+i] = (uint8_t)((st>>(9-i))&1);
+    memcpy(bits+166, info+98, 98);
+    std::vector<float> sym(132);
+    for(int k=0;k<132;k++) sym[k] = (float)dmr::dibit_to_sym(bits[2*k], bits[2*k+1]);
+    return sym;
+}
+
+// 심볼 → RRC 성형 → FM (1 심볼 단위 = 648 Hz). out append.
+inline void burst(std::vector<cf>& out, const std::vector<float>& sym, double fs){
+    const double sps = fs/4800.0;
+    static thread_local std::vector<float> h; static thread_local double h_sps = 0;
+    if(h_sps != sps){ h = SynthCommon::rrc_taps(sps, 0.2); h_sps = sps; }
+    std::vector<float> w = SynthCommon::shape_imp(sym, sps, h);
+    const float dev = (float)(2.0*M_PI*648.0/fs);
+    for(auto& v : w) v *= dev;
+    double ph = 0;
+    SynthCommon::fm_mod(w, out, ph);
+}
+
+} // namespace SynthDmr
@@ -0,0 +1,112 @@
+#pragma once
+// ── Mode S 1090ES 합성기 (벤치마크용) ───────────────────────────────────────
+// DF17 식별(TC 4) 프레임 → PPM 펄스열 → 복소 baseband (랜덤 위상/부분 샘플 지연,
+// AWGN) → magnitude. 샘플 값은 샘플 구간과 펄스의 겹침 비율 (워커의 boxcar 데시메이션과 동일).
+// SNR = 펄스 전력 / 잡음 전력 (A² / 2σ²).
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace SynthModeS {
+
+inline uint32_t crc24(const uint8_t* msg, int nbytes){
+    uint32_t rem=0;
+    for(int i=0;i<nbytes;i++){
+        rem ^= (uint32_t)msg[i]<<16;
+        for(int b=0;b<8;b++)
+            rem = (rem & 0x800000) ? ((rem<<1)^0xFFF409)&0xFFFFFF : (rem<<1)&0xFFFFFF;
+    }
+    return rem;
+}
+
+inline void putbits(uint8_t* msg, int start, int len, uint32_t v){
+    for(int i=0;i<len;i++){
+        int bit=start+i;
+        if((v>>(len-1-i))&1) msg[bit>>3] |= (uint8_t)(0x80>>(bit&7));
+    }
+}
+
+// DF17 TC4 식별 프레임 (112 bit). callsign: A-Z, 0-9, 공백 최대 8자.
+inline void df17_ident(uint8_t msg[14], uint32_t icao, const char* callsign){
+    memset(msg, 0, 14);
+    putbits(msg, 0, 5, 17); putbits(msg, 5, 3, 5); putbits(msg, 8, 24, icao);
+    putbits(msg, 32, 5, 4); putbits(msg, 37, 3, 0);
+    char cs[8]; memset(cs, ' ', 8);                      // 공백 패딩
+    for(int k=0;k<8 && callsign[k];k++) cs[k] = callsign[k];
+    for(int k=0;k<8;k++){
+        uint32_t v = (cs[k]>='A'&&cs[k]<='Z') ? (uint32_t)(cs[k]-'A'+1) : (uint32_t)cs[k];
+        putbits(msg, 40+6*k, 6, v & 63);
+    }
+    putbits(msg, 88, 24, crc24(msg, 11));
+}
+
+// PPM 포락선: 부분 샘플 지연 t0 (s) 로 시작하는 프레임의 샘플별 펄스 점유율 (0..1).
+// 샘플 값 = 샘플 구간과 0.5 µs half-chip 펄스의 겹침 비율 (워커의 boxcar 데시메이션과 동일).
+inline std::vector<float> ppm_envelope(const uint8_t msg[14], double fs, double t0){
+    bool on[16+224] = {};                                 // 프리앰블 16 + 데이터 224 half-chip
+    on[0]=on[2]=on[7]=on[9]=true;
+    for(int b=0;b<112;b++){
+        bool one = (msg[b>>3]>>(7-(b&7)))&1;
+        on[16+2*b+(one?0:1)] = true;
+    }
+    double dur = 120e-6 + 4.0/fs;
+    size_t n   = (size_t)std::ceil(dur*fs);
+    std::vector<float> env(n);
+    for(size_t k=0;k<n;k++){
+        double a = k/fs - t0, b = (k+1)/fs - t0;          // 샘플 구간 (프레임 시간축)
+        double cover = 0.0;
+        int h0 = std::max(0, (int)std::floor(a/0.5e-6));
+        int h1 = std::min(16+224-1, (int)std::floor(b/0.5e-6));
+        for(int h=h0; h<=h1; h++){
+            if(!on[h]) continue;
+            double lo = std::max(a, h*0.5e-6), hi = std::min(b, (h+1)*0.5e-6);
+            if(hi > lo) cover += hi - lo;
+        }
+        env[k] = (float)(cover * fs);
+    }
+    return env;
+}
+
+// 복소 baseband 프레임 (잡음 없음, 위상 0, 펄스 진폭 1) — decode_bench 가 SynthCommon::Channel 로 열화
+inline void frame_iq(std::vector<std::complex<float>>& out, const uint8_t msg[14], double fs, double t0){
+    for(float a : ppm_envelope(msg, fs, t0)) out.emplace_back(a, 0.f);
+}
+
+class Generator {
+public:
+    Generator(double fs, uint32_t seed) : fs_(fs), rng_(seed) {}
+
+    // 잡음만 n 샘플 (σ 는 set_snr 로)
+    void noise(std::vector<float>& out, size_t n){
+        for(size_t i=0;i<n;i++){
+            float re = nd_(rng_)*sigma_, im = nd_(rng_)*sigma_;
+            out.push_back(std::sqrt(re*re + im*im));
+        }
+    }
+    // 펄스 진폭 1 기준 SNR(dB) → 잡음 σ
+    void set_snr(float snr_db){ sigma_ = (float)std::sqrt(0.5 / std::pow(10.0, snr_db/10.0)); }
+
+    // 프레임 1개 (프리앰블 8 µs + 112 bit) + 앞뒤 여유. 시작은 부분 샘플 지연.
+    void frame(std::vector<float>& out, const uint8_t msg[14]){
+        double t0   = ud_(rng_) / fs_;                    // 부분 샘플 지연 (s)
+        float  ph   = (float)(ud_(rng_) * 2.0 * M_PI);
+        float  cr = std::cos(ph), ci = std::sin(ph);
+        for(float amp : ppm_envelope(msg, fs_, t0)){
+            float re = amp*cr + nd_(rng_)*sigma_, im = amp*ci + nd_(rng_)*sigma_;
+            out.push_back(std::sqrt(re*re + im*im));
+        }
+    }
+
+private:
+    double fs_;
+    float  sigma_ = 0.f;
+    std::mt19937 rng_;
+    std::normal_distribution<float> nd_{0.f, 1.f};
+    std::uniform_real_distribution<double> ud_{0.0, 1.0};
+};
+
+} // namespace SynthModeS
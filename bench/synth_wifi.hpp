@@ -0,0 +1,154 @@
+#pragma once
+// ── 802.11 비콘 합성기 (벤치마크용) ──────────────────────────────────────────
+// 비콘 MPDU (SSID/Rates/DS IE + FCS CRC-32) 를 두 PHY 로:
+//   b: DSSS 1 Mbps — long PLCP (SYNC 128 + SFD 0xF3A0 + SIGNAL/SERVICE/LENGTH/CRC16)
+//      → self-sync 스크램블 (z^-4 ⊕ z^-7) → DBPSK → Barker 11 → 22 MSPS (2 sps/chip)
+//   g: OFDM 6 Mbps — L-STF/L-LTF/L-SIG + DATA (스크램블 x^7+x^4+1, K=7 r=1/2 길쌈,
+//      48 인터리브, BPSK, pilot 극성열) → 64-pt IDFT + CP16 → 20 MSPS
+// 출력은 버스트 평균 전력 1. (IDFT 는 직접 합 — 합성 비용은 측정 대상 아님, FFTW 비의존)
+#include "synth_common.hpp"
+#include <cstring>
+#include <string>
+
+namespace SynthWifi {
+
+using SynthCommon::cf;
+
+inline uint32_t crc32(const uint8_t* d, size_t n){
+    uint32_t c = 0xFFFFFFFFu;
+    for(size_t i=0;i<n;i++){ c ^= d[i]; for(int k=0;k<8;k++) c = (c&1) ? 0xEDB88320u^(c>>1) : (c>>1); }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// 비콘 MPDU (FCS 포함). bssid[0] = 표기순 첫 바이트.
+inline std::vector<uint8_t> beacon(const uint8_t bssid[6], const char* ssid, int wch){
+    std::vector<uint8_t> m = { 0x80, 0x00, 0x00, 0x00 };      // FC=beacon, duration
+    for(int i=0;i<6;i++) m.push_back(0xFF);                   // DA broadcast
+    for(int r=0;r<2;r++) for(int i=0;i<6;i++) m.push_back(bssid[i]);   // SA, BSSID
+    m.push_back(0x10); m.push_back(0x00);                     // seq ctrl
+    for(int i=0;i<8;i++) m.push_back((uint8_t)(i*17));        // timestamp
+    m.push_back(0x64); m.push_back(0x00);                     // beacon interval 100 TU
+    m.push_back(0x01); m.push_back(0x04);                     // capability: ESS, short slot
+    size_t n = strlen(ssid); if(n > 32) n = 32;
+    m.push_back(0); m.push_back((uint8_t)n); m.insert(m.end(), ssid, ssid+n);
+    const uint8_t rates[] = { 0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24 };
+    m.push_back(1); m.push_back(8); m.insert(m.end(), rates, rates+8);
+    m.push_back(3); m.push_back(1); m.push_back((uint8_t)wch);
+    uint32_t f = crc32(m.data(), m.size());
+    for(int i=0;i<4;i++) m.push_back((uint8_t)(f >> (8*i)));
+    return m;
+}
+
+// ── 802.11b DSSS 1 Mbps ──────────────────────────────────────────────────────
+inline void dsss_burst(std::vector<cf>& out, const std::vector<uint8_t>& mpdu){
+    static const int BARKER[11] = {1,-1,1,1,-1,1,1,1,-1,-1,-1};
+    std::vector<uint8_t> bits;
+    auto put = [&](uint32_t v, int n){ for(int i=0;i<n;i++) bits.push_back((uint8_t)((v>>i)&1)); };
+    for(int i=0;i<128;i++) bits.push_back(1);                 // SYNC
+    put(0xF3A0, 16);                                          // SFD (LSB-first)
+    size_t hdr0 = bits.size();
+    put(0x0A, 8); put(0x00, 8); put((uint32_t)(mpdu.size()*8), 16);   // SIGNAL, SERVICE, LENGTH(µs)
+    uint16_t crc = 0xFFFF;                                    // PLCP CRC-16 (CCITT, 보수)
+    for(size_t i=hdr0;i<bits.size();i++){
+        uint16_t fb = (uint16_t)(((crc>>15)&1) ^ bits[i]);
+        crc = (uint16_t)(crc<<1); if(fb) crc ^= 0x1021;
+    }
+    crc = (uint16_t)~crc;
+    for(int i=15;i>=0;i--) bits.push_back((uint8_t)((crc>>i)&1));
+    for(uint8_t o : mpdu) put(o, 8);
+
+    std::vector<uint8_t> s(bits.size());                      // self-sync 스크램블, seed 0x1B
+    uint8_t sr = 0x1B;
+    for(size_t n=0;n<bits.size();n++){
+        uint8_t v = (uint8_t)(bits[n] ^ ((sr>>3)&1) ^ ((sr>>6)&1));
+        s[n] = v; sr = (uint8_t)(((sr<<1)|v) & 0x7F);
+    }
+    float ph = 1.f;
+    for(int k=0;k<11;k++){ out.emplace_back((float)BARKER[k], 0.f); out.emplace_back((float)BARKER[k], 0.f); }  // 기준 심볼
+    for(uint8_t v : s){
+        if(v) ph = -ph;                                       // DBPSK: 1 = π 전환
+        for(int k=0;k<11;k++){ cf c(ph*BARKER[k], 0.f); out.push_back(c); out.push_back(c); }
+    }
+}
+
+// ── 802.11g OFDM 6 Mbps ──────────────────────────────────────────────────────
+namespace ofdm {
+static const int LTF[53] = {
+ 1,1,-1,-1,1,1,-1,1,-1,1,1,1,1,1,1,-1,-1,1,1,-1,1,-1,1,1,1,1,
+ 0,
+ 1,-1,-1,1,1,-1,1,-1,1,-1,-1,-1,-1,-1,1,1,-1,-1,1,-1,1,-1,1,1,1,1 };
+static const int8_t PILOT_POL[127] = {
+ 1,1,1,1,-1,-1,-1,1,-1,-1,-1,-1,1,1,-1,1,-1,-1,1,1,-1,1,1,-1,1,1,1,1,1,1,-1,1,
+ 1,1,-1,1,1,-1,-1,1,1,1,-1,1,-1,-1,-1,1,-1,1,-1,-1,1,-1,-1,1,1,1,1,1,-1,-1,1,1,
+ -1,-1,1,-1,1,-1,1,1,-1,-1,-1,1,1,-1,-1,-1,-1,1,-1,-1,1,-1,1,1,1,1,-1,1,-1,1,-1,1,
+ -1,-1,-1,-1,-1,1,-1,1,1,-1,1,-1,1,1,1,-1,-1,1,-1,-1,-1,1,1,1,-1,-1,-1,-1,-1,-1,-1 };
+static const int DSC48[48] = {-26,-25,-24,-23,-22,-20,-19,-18,-17,-16,-15,-14,-13,-12,-11,-10,-9,-8,
+    -6,-5,-4,-3,-2,-1,1,2,3,4,5,6,8,9,10,11,12,13,14,15,16,17,18,19,20,22,23,24,25,26};
+
+// 주파수영역 X[sc=-32..31 → bin] 64개 → 시간 64 (직접 IDFT)
+inline void idft64(const cf* X, cf* x){
+    for(int n=0;n<64;n++){
+        cf a(0,0);
+        for(int k=0;k<64;k++){ if(X[k]==cf(0,0)) continue; double t=2.0*M_PI*k*n/64.0; a += X[k]*cf((float)std::cos(t),(float)std::sin(t)); }
+        x[n] = a / 8.0f;
+    }
+}
+inline int bin(int sc){ return (sc+64)%64; }
+
+// 48 coded bit → CP + 64 샘플. sym = pilot 극성 인덱스 (SIGNAL = 0).
+inline void symbol(std::vector<cf>& out, const uint8_t* coded, int sym){
+    static const int PSC[4] = {-21,-7,7,21}, PVAL[4] = {1,1,1,-1};
+    cf X[64] = {}, x[64];
+    for(int k=0;k<48;k++) X[bin(DSC48[3*(k%16)+k/16])] = cf(coded[k] ? 1.f : -1.f, 0.f);
+    for(int p=0;p<4;p++) X[bin(PSC[p])] = cf((float)(PVAL[p]*PILOT_POL[sym%127]), 0.f);
+    idft64(X, x);
+    for(int n=48;n<64;n++) out.push_back(x[n]);
+    for(int n=0;n<64;n++) out.push_back(x[n]);
+}
+
+inline void conv(const uint8_t* in, int n, std::vector<uint8_t>& out){
+    int reg = 0;
+    auto par = [&](int g){ return __builtin_popcount(reg & g) & 1; };
+    for(int i=0;i<n;i++){ reg = ((reg<<1)|in[i]) & 0x7F; out.push_back((uint8_t)par(0133)); out.push_back((uint8_t)par(0171)); }
+}
+} // namespace ofdm
+
+inline void ofdm_burst(std::vector<cf>& out, const std::vector<uint8_t>& mpdu){
+    using namespace ofdm;
+    size_t o0 = out.size();
+    // L-STF: ±4,±8..±24 에 √(13/6)(±1±j) → 16 주기, 160 샘플
+    { static const int S[53] = {0,0,1,0,0,0,-1,0,0,0,1,0,0,0,-1,0,0,0,-1,0,0,0,1,0,0,0,0,0,0,0,-1,0,0,0,-1,0,0,0,1,0,0,0,1,0,0,0,1,0,0,0,1,0,0};
+      cf X[64] = {}, x[64];
+      for(int sc=-26;sc<=26;sc++) X[bin(sc)] = (float)(std::sqrt(13.0/6.0)*S[sc+26]) * cf(1.f,1.f);
+      idft64(X, x);
+      for(int n=0;n<160;n++) out.push_back(x[n%64]); }
+    // L-LTF: GI2 32 + 2×64
+    { cf X[64] = {}, x[64];
+      for(int sc=-26;sc<=26;sc++) X[bin(sc)] = cf((float)LTF[sc+26], 0.f);
+      idft64(X, x);
+      for(int n=32;n<64;n++) out.push_back(x[n]);
+      for(int r=0;r<2;r++) for(int n=0;n<64;n++) out.push_back(x[n]); }
+    // L-SIG: RATE 1101 (6 Mbps), LENGTH, 짝수 패리티, tail 6
+    const int len = (int)mpdu.size();
+    uint8_t sig[24] = {1,1,0,1,0};
+    for(int i=0;i<12;i++) sig[5+i] = (uint8_t)((len>>i)&1);
+    int p = 0; for(int i=0;i<17;i++) p ^= sig[i];
+    sig[17] = (uint8_t)p;
+    std::vector<uint8_t> c; conv(sig, 24, c);
+    symbol(out, c.data(), 0);
+    // DATA: SERVICE 16 + PSDU + tail 6 + pad → 스크램블 (seed 0x5D) → tail 0 → 길쌈
+    int nsym = (16 + 8*len + 6 + 23)/24, nb = nsym*24;
+    std::vector<uint8_t> d(nb, 0);
+    for(int B=0;B<len;B++) for(int b=0;b<8;b++) d[16+B*8+b] = (uint8_t)((mpdu[B]>>b)&1);
+    int st = 0x5D;
+    for(int i=0;i<nb;i++){ int fb = ((st>>6)^(st>>3))&1; d[i] ^= (uint8_t)fb; st = ((st<<1)|fb)&0x7F; }
+    for(int i=0;i<6;i++) d[16+8*len+i] = 0;
+    c.clear(); conv(d.data(), nb, c);
+    for(int s=0;s<nsym;s++) symbol(out, c.data()+48*s, s+1);
+    // 버스트 평균 전력 1
+    double pw = 0; for(size_t i=o0;i<out.size();i++) pw += std::norm(out[i]);
+    float g = (float)(1.0/std::sqrt(pw/(double)(out.size()-o0)));
+    for(size_t i=o0;i<out.size();i++) out[i] *= g;
+}
+
+} // namespace SynthWifi
@@ -1,4 +1,6 @@
 #include "central_server.hpp"
+#include "../src/metrics.hpp"
+#include "../src/trace.hpp"
 #include <cstdio>
 #include <cstring>
 #include <csignal>
@@ -24,8 +26,10 @@ int main(int argc, char** argv){
     setbuf(stdout, nullptr);  // stdout 라인 버퍼링 해제 → 즉시 출력
     setbuf(stderr, nullptr);
     int port = CENTRAL_PORT; // 기본 7700 (단일 포트) 나중에 보안검토 다시 할때 수정하기 ...
+    int metrics_port = 9770; // Prometheus /metrics (127.0.0.1 전용, 0 = 끔)
     for(int i=1; i<argc; i++){
         if(!strcmp(argv[i],"--port") && i+1<argc) port = atoi(argv[++i]);
+        else if(!strcmp(argv[i],"--metrics-port") && i+1<argc) metrics_port = atoi(argv[++i]);
     }
 
     printf("=== BEWE Central Server ===\n");
@@ -37,15 +41,19 @@ int main(int argc, char** argv){
     signal(SIGTERM, sig_handler);
     signal(SIGPIPE, SIG_IGN);
 
+    Trace::init_from_env();
     if(!central_srv.start(port)){
         fprintf(stderr,"[Central] start failed\n");
         return 1;
     }
+    Trace::http_install();
+    Metrics::http_start(metrics_port);
     // sig handler는 flag만 set. 메인 루프가 polling으로 stop() 호출 — 재진입/락 데드락 방지.
     while(!g_should_stop.load()){
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
     printf("[Central] received shutdown signal, stopping...\n");
+    Metrics::http_stop();
     central_srv.stop();
     printf("[Central] shutdown complete\n");
     return 0;
@@ -2,24 +2,37 @@
 // Layout: ~/BE_WE/DataBase/missions/<station>/<year>/<code>/{iq,audio,hist}/
 // HOST PUSH (IQ/audio):
 //   PUSH_META(transfer_id, mode, total, info)  ->  archive_dir/filename + .info
-//   PUSH_DATA(offset, chunk) xN
+//   PUSH_DATA(offset, chunk) xN                ->  pwrite at offset
 //   PUSH_DATA(is_last=1)     -> Central close + PUSH_ACK(status=0)
+// Resumable (mode=2, HOST MissionPush):
+//   PUSH_META + file_id      -> .<filename>.part(.state) 재사용 or 새로, PUSH_STATE(RESUME, have)
+//   PUSH_DATA(offset=have, crc32c) xN -> 검증 + pwrite + 상태파일, PUSH_STATE(PROGRESS)
+//   PUSH_DATA(COMMIT, file crc32c)    -> 전체 CRC 비교 → rename → PUSH_ACK
+//   .part 디스크 readback (재개 시 / COMMIT 시) 은 detached worker — room thread 는 안 막힘.
 // HIST: PUSH 없이 LWF_LIVE_START/ROW/STOP 스트림 tap.
 #include "central_server.hpp"
 #include "../src/net_protocol.hpp"
 #include "../src/sigmf.hpp"
 #include "../src/long_waterfall.hpp"   // build_hist_filename_finalize
+#include "../src/lwf_codec.hpp"        // v4 block / index footer
+#include "../src/crc32c.hpp"
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
 #include <algorithm>
 #include <vector>
 #include <string>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <thread>
 
 namespace {
+// HIST live 블록 gap 0-fill 상한 (행). 5 row/s 기준 ~58 h — 이보다 크면 row index 오류로 보고 버림.
+constexpr uint32_t HIST_GAP_FILL_MAX = 1u << 20;
+
 // 파일명/경로 컴포넌트 sanitization.
 // 슬래시 '/' 와 ".." 컴포넌트 차단 (디렉토리 escape 방지).
 // 빈 문자열·null 입력 → false.
@@ -74,6 +87,103 @@ const char* subdir_name(uint8_t s){
         default:        return nullptr;
     }
 }
+
+bool pwrite_all(int fd, const void* buf, size_t n, uint64_t off){
+    const uint8_t* p = static_cast<const uint8_t*>(buf);
+    while(n > 0){
+        ssize_t w = pwrite(fd, p, n, (off_t)off);
+        if(w < 0){ if(errno == EINTR) continue; return false; }
+        if(w == 0) return false;
+        p += w; n -= (size_t)w; off += (uint64_t)w;
+    }
+    return true;
+}
+
+// fd 의 [0, len) 을 다시 읽어 CRC32C (디스크에 실제 있는 내용 기준)
+bool crc_file(int fd, uint64_t len, uint32_t& crc){
+    static thread_local std::vector<uint8_t> buf(1u << 20);
+    crc = 0;
+    uint64_t off = 0;
+    while(off < len){
+        size_t n = (size_t)std::min<uint64_t>(buf.size(), len - off);
+        ssize_t r = pread(fd, buf.data(), n, (off_t)off);
+        if(r < 0){ if(errno == EINTR) continue; return false; }
+        if(r == 0) return false;
+        crc = Crc32c::extend(crc, buf.data(), (size_t)r);
+        off += (uint64_t)r;
+    }
+    return true;
+}
+
+void xfer_close(MissionFileTransfer& xf){
+    if(xf.fd >= 0)       { close(xf.fd);       xf.fd = -1; }
+    if(xf.state_fd >= 0) { close(xf.state_fd); xf.state_fd = -1; }
+}
+
+// resumable partial 상태 (.<name>.part.state, 고정 크기 — 청크마다 offset 0 에 덮어씀)
+struct __attribute__((packed)) PartState {
+    char     magic[8];      // "BEWEPRT1"
+    uint64_t file_id;
+    uint64_t total;
+    uint64_t have;
+    uint32_t have_crc;
+    uint32_t _pad;
+};
+
+void part_state_save(const MissionFileTransfer& xf){
+    PartState ps{};
+    memcpy(ps.magic, "BEWEPRT1", 8);
+    ps.file_id  = xf.file_id;
+    ps.total    = xf.expected_bytes;
+    ps.have     = xf.have;
+    ps.have_crc = xf.have_crc;
+    pwrite_all(xf.state_fd, &ps, sizeof(ps), 0);
+}
+
+// .<name>.part + .state 열고 재개 지점 결정 (숨김 파일 → LIST 에 안 보임).
+// 상태파일의 file_id/total 이 다르면 (HOST 파일이 바뀜) partial 폐기 후 0 부터.
+// 상태는 데이터 pwrite 뒤에 기록하지만 둘 다 fsync 없이 page cache 라 전원 차단 후엔 순서 보장이
+// 없음 → [0, have) CRC 를 디스크에서 다시 계산해야 함. have > 0 이면 xf.verify 를 달아 반환,
+// 호출자가 worker 에서 검증 (GB 단위 readback 을 room thread 에서 하지 않음).
+bool open_part(MissionFileTransfer& xf, const std::string& dir, const char* fname,
+               uint64_t file_id){
+    xf.resumable = true;
+    xf.file_id   = file_id;
+    xf.part_path = dir + "/." + fname + ".part";
+    xf.fd = open(xf.part_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(xf.fd < 0) return false;
+    xf.state_fd = open((xf.part_path + ".state").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(xf.state_fd < 0){ xfer_close(xf); return false; }
+
+    PartState ps{};
+    struct stat st{};
+    bool match = pread(xf.state_fd, &ps, sizeof(ps), 0) == (ssize_t)sizeof(ps)
+              && memcmp(ps.magic, "BEWEPRT1", 8) == 0
+              && ps.file_id == file_id && ps.total == xf.expected_bytes
+              && ps.have <= ps.total
+              && fstat(xf.fd, &st) == 0 && (uint64_t)st.st_size >= ps.have;
+    xf.have     = match ? ps.have     : 0;
+    xf.have_crc = match ? ps.have_crc : 0;
+    if(xf.have > 0){ xf.verify = std::make_shared<PartVerify>(); return true; }
+    if(!match && ftruncate(xf.fd, 0) != 0){ xfer_close(xf); return false; }
+    part_state_save(xf);
+    return true;
+}
+
+// worker 검증 결과 반영 (room thread). false = 아직 검증 중.
+bool part_verify_apply(MissionFileTransfer& xf){
+    if(!xf.verify) return true;
+    int r = xf.verify->result.load(std::memory_order_acquire);
+    if(r == 0) return false;
+    xf.verify.reset();
+    if(r == 2){
+        xf.have = 0; xf.have_crc = 0;
+        if(ftruncate(xf.fd, 0) != 0)
+            printf("[Central][Archive] part '%s' truncate FAIL errno=%d\n", xf.part_path.c_str(), errno);
+        part_state_save(xf);
+    }
+    return true;
+}
 } // anonymous namespace
 
 std::string CentralServer::archive_root() const {
@@ -128,6 +238,11 @@ void CentralServer::handle_mission_file_push_meta(std::shared_ptr<HostRoom> room
         send_push_ack(room, k, m->transfer_id, 3, 0, "invalid key");
         return;
     }
+    if(m->mode == MFP_MODE_RESUME &&
+       plen < sizeof(PktMissionFilePushMeta) + sizeof(PktMissionFilePushResume)){
+        send_push_ack(room, m->key, m->transfer_id, 2, 0, "resume trailer missing");
+        return;
+    }
 
     std::string dir = archive_dir(station, m->key.year, code, m->key.subdir);
     if(dir.empty()){
@@ -140,44 +255,82 @@ void CentralServer::handle_mission_file_push_meta(std::shared_ptr<HostRoom> room
 
     // 기존 transfer 있으면 닫음 (id 충돌 → 이전 transfer 폐기)
     auto it = room->mission_xfers.find(m->transfer_id);
-    if(it != room->mission_xfers.end() && it->second.fp){
-        fclose(it->second.fp);
+    if(it != room->mission_xfers.end()){
+        xfer_close(it->second);
         room->mission_xfers.erase(it);
     }
 
-    // mode==1(append) 일 때 + 기존 파일 있으면 append, 없으면 new
-    // mode==0(replace) 일 때 truncate
-    const char* fmode = (m->mode == 1) ? "ab" : "wb";
-    FILE* fp = fopen(fullpath.c_str(), fmode);
-    if(!fp){
-        printf("[Central][Archive] PUSH_META fopen FAIL '%s' errno=%d (%s)\n",
-               fullpath.c_str(), errno, strerror(errno));
-        send_push_ack(room, m->key, m->transfer_id, 1, 0, strerror(errno));
-        return;
-    }
-
     MissionFileTransfer xf;
     xf.key = m->key;
-    xf.fp = fp;
     xf.expected_bytes = m->total_bytes;
     xf.written_bytes = 0;
     xf.high_water = 0;
     xf.archive_path = fullpath;
     xf.info_data.assign(m->info_data, strnlen(m->info_data, sizeof(m->info_data)));
+
+    if(m->mode == MFP_MODE_RESUME){
+        const auto* rs = reinterpret_cast<const PktMissionFilePushResume*>(
+                             payload + sizeof(PktMissionFilePushMeta));
+        if(!open_part(xf, dir, fname, rs->file_id)){
+            printf("[Central][Archive] PUSH_META part open FAIL '%s' errno=%d (%s)\n",
+                   xf.part_path.c_str(), errno, strerror(errno));
+            send_push_ack(room, m->key, m->transfer_id, 1, 0, strerror(errno));
+            return;
+        }
+    } else {
+        // mode==1(append): 기존 파일 유지, 청크 offset 에 pwrite
+        // mode==0(replace): truncate
+        int fl = O_WRONLY | O_CREAT | O_CLOEXEC | (m->mode == MFP_MODE_APPEND ? 0 : O_TRUNC);
+        xf.fd = open(fullpath.c_str(), fl, 0644);
+        if(xf.fd < 0){
+            printf("[Central][Archive] PUSH_META open FAIL '%s' errno=%d (%s)\n",
+                   fullpath.c_str(), errno, strerror(errno));
+            send_push_ack(room, m->key, m->transfer_id, 1, 0, strerror(errno));
+            return;
+        }
+    }
     auto ins = room->mission_xfers.emplace(m->transfer_id, std::move(xf));
+    auto& x = ins.first->second;
 
     // info sidecar 즉시 작성 (있으면)
-    if(!ins.first->second.info_data.empty()){
+    if(!x.info_data.empty()){
         FILE* fi = fopen(SigMF::sidecar_path(fullpath).c_str(), "w");
         if(fi){
-            const auto& s = ins.first->second.info_data;
-            fwrite(s.data(), 1, s.size(), fi);
+            fwrite(x.info_data.data(), 1, x.info_data.size(), fi);
             fclose(fi);
         }
     }
 
-    printf("[Central][Archive] PUSH_META xfer=%u mode=%u total=%lu → %s\n",
-           m->transfer_id, m->mode, (unsigned long)m->total_bytes, fullpath.c_str());
+    if(x.resumable && x.verify){
+        // [0, have) readback 은 worker 에서 — 끝나면 RESUME 응답 (HOST 는 RESUME 전엔 데이터 안 보냄).
+        int vfd = dup(x.fd);
+        MissionFileTransfer st;                 // RESUME 패킷용 사본 (key/have/crc 만)
+        st.key = x.key; st.have = x.have; st.have_crc = x.have_crc;
+        std::string part = x.part_path;
+        uint8_t tid = m->transfer_id;
+        printf("[Central][Archive] PUSH_META xfer=%u resume total=%lu state have=%lu → %s (verifying)\n",
+               tid, (unsigned long)m->total_bytes, (unsigned long)x.have, fullpath.c_str());
+        std::thread([this, room, v = x.verify, vfd, st, part, tid]() mutable {
+            uint32_t disk_crc = 0;
+            bool ok = vfd >= 0 && crc_file(vfd, st.have, disk_crc) && disk_crc == st.have_crc;
+            if(vfd >= 0) close(vfd);
+            if(!ok){
+                printf("[Central][Archive] part '%s' have=%lu crc mismatch (state=%08x disk=%08x) — restart\n",
+                       part.c_str(), (unsigned long)st.have, st.have_crc, disk_crc);
+                st.have = 0; st.have_crc = 0;
+            }
+            v->result.store(ok ? 1 : 2, std::memory_order_release);
+            send_push_state(room, st, tid, MFP_ST_RESUME);
+        }).detach();
+    } else if(x.resumable){
+        printf("[Central][Archive] PUSH_META xfer=%u resume total=%lu have=%lu → %s\n",
+               m->transfer_id, (unsigned long)m->total_bytes, (unsigned long)x.have,
+               fullpath.c_str());
+        send_push_state(room, x, m->transfer_id, MFP_ST_RESUME);
+    } else {
+        printf("[Central][Archive] PUSH_META xfer=%u mode=%u total=%lu → %s\n",
+               m->transfer_id, m->mode, (unsigned long)m->total_bytes, fullpath.c_str());
+    }
 }
 
 // ── HOST → Central: PUSH_DATA ────────────────────────────────────────────
@@ -194,42 +347,38 @@ void CentralServer::handle_mission_file_push_data(std::shared_ptr<HostRoom> room
     }
 
     auto it = room->mission_xfers.find(d->transfer_id);
-    if(it == room->mission_xfers.end() || !it->second.fp){
+    if(it == room->mission_xfers.end() || it->second.fd < 0){
         printf("[Central][Archive] PUSH_DATA unknown xfer=%u (no META)\n", d->transfer_id);
         return;
     }
     auto& xf = it->second;
 
-    // offset 위치로 seek 후 write. append 모드라도 fseek 가능.
-    if(fseeko(xf.fp, (off_t)d->offset, SEEK_SET) != 0){
-        printf("[Central][Archive] PUSH_DATA seek FAIL xfer=%u offset=%lu errno=%d\n",
-               d->transfer_id, (unsigned long)d->offset, errno);
-        send_push_ack(room, xf.key, d->transfer_id, 1, xf.written_bytes, "seek failed");
-        fclose(xf.fp); xf.fp = nullptr;
-        room->mission_xfers.erase(it);
+    if(xf.resumable){
+        handle_push_data_resume(room, it->first, xf, d, raw);
+        if(xf.fd < 0) room->mission_xfers.erase(it);
         return;
     }
+
+    // offset 위치에 pwrite (stdio 버퍼/seek 없이 바로 page cache)
     if(d->chunk_bytes > 0){
-        size_t w = fwrite(raw, 1, d->chunk_bytes, xf.fp);
-        if(w != d->chunk_bytes){
-            printf("[Central][Archive] PUSH_DATA write short xfer=%u want=%u got=%zu\n",
-                   d->transfer_id, d->chunk_bytes, w);
-            send_push_ack(room, xf.key, d->transfer_id, 1, xf.written_bytes, "short write");
-            fclose(xf.fp); xf.fp = nullptr;
+        if(!pwrite_all(xf.fd, raw, d->chunk_bytes, d->offset)){
+            printf("[Central][Archive] PUSH_DATA write FAIL xfer=%u offset=%lu errno=%d\n",
+                   d->transfer_id, (unsigned long)d->offset, errno);
+            send_push_ack(room, xf.key, d->transfer_id, 1, xf.written_bytes, "write failed");
+            xfer_close(xf);
             room->mission_xfers.erase(it);
             return;
         }
-        xf.written_bytes += w;
+        xf.written_bytes += d->chunk_bytes;
         uint64_t hw = d->offset + d->chunk_bytes;
         if(hw > xf.high_water) xf.high_water = hw;
     }
 
     if(d->is_last){
-        fflush(xf.fp);
-        fclose(xf.fp); xf.fp = nullptr;
         // 디스크 commit 후 ack
         struct stat st{}; uint64_t disk_bytes = 0;
-        if(stat(xf.archive_path.c_str(), &st) == 0) disk_bytes = (uint64_t)st.st_size;
+        if(fstat(xf.fd, &st) == 0) disk_bytes = (uint64_t)st.st_size;
+        xfer_close(xf);
         printf("[Central][Archive] PUSH_DATA last xfer=%u written=%lu disk=%lu → ACK\n",
                d->transfer_id, (unsigned long)xf.written_bytes, (unsigned long)disk_bytes);
         send_push_ack(room, xf.key, d->transfer_id, 0, disk_bytes, "");
@@ -237,6 +386,97 @@ void CentralServer::handle_mission_file_push_data(std::shared_ptr<HostRoom> room
     }
 }
 
+// resumable 청크: offset == have 인 것만 수용 (go-back-N). CRC 불일치/어긋남 → REWIND 1회.
+// 청크 수용마다 상태파일 갱신 + PROGRESS. COMMIT → running CRC 비교 후 worker 가 readback·rename·ACK.
+// 전송 종료(성공/실패/worker 인계)면 xf.fd < 0 으로 닫아서 반환 → 호출자가 map 에서 제거.
+void CentralServer::handle_push_data_resume(std::shared_ptr<HostRoom> room, uint8_t tid,
+                                            MissionFileTransfer& xf,
+                                            const PktMissionFilePushData* d,
+                                            const uint8_t* raw){
+    // 재개 검증 중 (RESUME 응답 전) 도착한 청크는 버림 — HOST 는 RESUME 의 have 부터 다시 보냄.
+    if(!part_verify_apply(xf)) return;
+    if(d->flags & MFP_DATA_COMMIT){
+        bool ok = xf.have == xf.expected_bytes && xf.have_crc == d->crc32c;
+        if(!ok){
+            printf("[Central][Archive] PUSH_COMMIT xfer=%u MISMATCH have=%lu/%lu crc=%08x host=%08x — drop part\n",
+                   tid, (unsigned long)xf.have, (unsigned long)xf.expected_bytes,
+                   xf.have_crc, d->crc32c);
+            xfer_close(xf);
+            unlink(xf.part_path.c_str());
+            unlink((xf.part_path + ".state").c_str());
+            send_push_ack(room, xf.key, tid, 4, xf.have, "hash mismatch");
+            return;
+        }
+        // fdatasync + 디스크 readback (ACK 후 HOST 는 원본을 지울 수 있음) 은 수 GB 면 수십 초 →
+        // fd 를 worker 에 넘기고 room thread 는 바로 반환. ACK 는 worker 가 보냄.
+        if(xf.state_fd >= 0){ close(xf.state_fd); xf.state_fd = -1; }
+        int fd = xf.fd;
+        xf.fd = -1;
+        std::thread([this, room, fd, key = xf.key, tid, have = xf.have, crc = d->crc32c,
+                     part = xf.part_path, dst = xf.archive_path](){
+            bool io_ok = ftruncate(fd, (off_t)have) == 0 && fdatasync(fd) == 0;
+            uint32_t disk_crc = 0;
+            bool crc_ok = io_ok && crc_file(fd, have, disk_crc) && disk_crc == crc;
+            close(fd);
+            if(io_ok && !crc_ok){
+                printf("[Central][Archive] PUSH_COMMIT xfer=%u readback crc=%08x host=%08x — drop part\n",
+                       tid, disk_crc, crc);
+                unlink(part.c_str());
+                unlink((part + ".state").c_str());
+                send_push_ack(room, key, tid, 4, 0, "hash mismatch");
+                return;
+            }
+            if(!io_ok || rename(part.c_str(), dst.c_str()) != 0){
+                printf("[Central][Archive] PUSH_COMMIT xfer=%u finalize FAIL errno=%d (%s)\n",
+                       tid, errno, strerror(errno));
+                send_push_ack(room, key, tid, 1, have, strerror(errno));
+                return;
+            }
+            unlink((part + ".state").c_str());
+            printf("[Central][Archive] PUSH_COMMIT xfer=%u %lu bytes crc=%08x → %s\n",
+                   tid, (unsigned long)have, crc, dst.c_str());
+            send_push_ack(room, key, tid, 0, have, "");
+        }).detach();
+        return;
+    }
+
+    // HOST 가 offset 0 부터 다시 보냄 (prefix CRC 불일치) → partial 리셋
+    if(d->offset == 0 && xf.have > 0){
+        xf.have = 0; xf.have_crc = 0;
+        xf.rewind_sent = false;
+    }
+    const char* why = nullptr;
+    if(d->offset != xf.have)                                   why = "offset";
+    else if(!(d->flags & MFP_DATA_CRC))                        why = "no crc";
+    else if(d->offset + d->chunk_bytes > xf.expected_bytes)    why = "past end";
+    else if(Crc32c::extend(0, raw, d->chunk_bytes) != d->crc32c) why = "crc";
+    if(why){
+        if(!xf.rewind_sent){
+            printf("[Central][Archive] PUSH_DATA xfer=%u reject (%s) offset=%lu have=%lu → REWIND\n",
+                   tid, why, (unsigned long)d->offset, (unsigned long)xf.have);
+            send_push_state(room, xf, tid, MFP_ST_REWIND);
+            xf.rewind_sent = true;
+        }
+        return;
+    }
+    xf.rewind_sent = false;
+
+    if(d->chunk_bytes > 0 && !pwrite_all(xf.fd, raw, d->chunk_bytes, d->offset)){
+        printf("[Central][Archive] PUSH_DATA write FAIL xfer=%u offset=%lu errno=%d\n",
+               tid, (unsigned long)d->offset, errno);
+        // partial 은 남겨 둠 → 디스크 정리 후 재개 가능
+        send_push_ack(room, xf.key, tid, 1, xf.have, "write failed");
+        xfer_close(xf);
+        return;
+    }
+    xf.have     += d->chunk_bytes;
+    xf.have_crc  = Crc32c::extend(xf.have_crc, raw, d->chunk_bytes);
+    xf.written_bytes += d->chunk_bytes;
+    xf.high_water = xf.have;
+    part_state_save(xf);
+    send_push_state(room, xf, tid, MFP_ST_PROGRESS);
+}
+
 void CentralServer::send_push_ack(std::shared_ptr<HostRoom> room,
                                    const MissionFileKey& key, uint8_t transfer_id,
                                    uint8_t status, uint64_t total_bytes,
@@ -253,6 +493,21 @@ void CentralServer::send_push_ack(std::shared_ptr<HostRoom> room,
                       bewe.data(), (uint32_t)bewe.size());
 }
 
+void CentralServer::send_push_state(std::shared_ptr<HostRoom> room,
+                                     const MissionFileTransfer& xf, uint8_t transfer_id,
+                                     uint8_t reason){
+    PktMissionFilePushState st{};
+    st.key = xf.key;
+    st.transfer_id = transfer_id;
+    st.reason = reason;
+    st.have_crc = xf.have_crc;
+    st.have_bytes = xf.have;
+    auto bewe = CentralServer::make_bewe_packet(BEWE_TYPE_MISSION_FILE_PUSH_STATE,
+                                                  &st, sizeof(st));
+    enqueue_host_send(room, 0xFFFF, CentralMuxType::DATA,
+                      bewe.data(), (uint32_t)bewe.size());
+}
+
 // ── LIST_REQ ─────────────────────────────────────────────────────────────
 // 스캔 후 PktMissionFileList 페이지(들) 전송. count > MAX 면 다중 page.
 // requester != nullptr → JOIN, == nullptr → HOST.
@@ -665,6 +920,7 @@ void CentralServer::archive_hist_on_live_start(std::shared_ptr<HostRoom> room,
     strncpy(st.code, room->active_mission_code, sizeof(st.code)-1);
     st.fft_size = ls.fft_size;
     st.rows_written = 0;
+    st.file_pos = sizeof(h);
     room->hist_streams.emplace(fname, std::move(st));
 
     printf("[Central][Archive] HIST stream OPEN %s (fft=%u, %.3fMHz)\n",
@@ -678,7 +934,7 @@ void CentralServer::archive_hist_on_live_row(std::shared_ptr<HostRoom> room,
     auto it = room->hist_streams.find(fname);
     if(it == room->hist_streams.end() || !it->second.fp) return;
     auto& st = it->second;
-    if(row_bytes == 0) return;
+    if(row_bytes == 0 || st.blocks) return;   // v4 stream 에 raw row 혼입 금지
     fwrite(row, 1, row_bytes, st.fp);
     st.rows_written++;
     // 매 row fflush — row_rate 5Hz 라 부담 없음. UI LIST_REQ 가 stat() 으로 size
@@ -686,11 +942,73 @@ void CentralServer::archive_hist_on_live_row(std::shared_ptr<HostRoom> room,
     fflush(st.fp);
 }
 
+// v4 host: 디스크 블록 그대로 append. 첫 블록에서 header version 을 0x0004 로 전환.
+void CentralServer::archive_hist_on_live_block(std::shared_ptr<HostRoom> room,
+                                                const PktLwfLiveBlockHdr& hdr,
+                                                const uint8_t* blk, uint32_t blk_bytes){
+    char fname[65]={}; memcpy(fname, hdr.filename, 64); fname[64]=0;
+    auto it = room->hist_streams.find(fname);
+    if(it == room->hist_streams.end() || !it->second.fp) return;
+    auto& st = it->second;
+    LwfCodec::BlockHdr bh;
+    if(!LwfCodec::parse_block_hdr(blk, blk_bytes, bh)) return;
+    if(!st.blocks){
+        if(st.rows_written != 0) return;      // 이미 raw row 로 시작된 stream
+        uint16_t ver = LwfCodec::FILE_VERSION_BLOCK;
+        fflush(st.fp);
+        if(pwrite(fileno(st.fp), &ver, sizeof(ver), 4) != (ssize_t)sizeof(ver)) return;
+        st.blocks = true;
+    }
+    if(bh.first_row < st.rows_written){
+        printf("[Central][Archive] HIST block dup %s (have %u rows, got row %u) — drop\n",
+               fname, st.rows_written, bh.first_row);
+        return;
+    }
+    // 누락 구간 (STOP/START 사이 재접속, 미션 중간 시작 등) → 0 행 블록으로 채움.
+    // row index 가 host 파일과 일치해야 UI 시간축이 맞음.
+    if(bh.first_row > st.rows_written){
+        uint32_t gap = bh.first_row - st.rows_written;
+        if(gap > HIST_GAP_FILL_MAX){
+            printf("[Central][Archive] HIST block gap %s (expect row %u, got %u) too large — drop\n",
+                   fname, st.rows_written, bh.first_row);
+            return;
+        }
+        printf("[Central][Archive] HIST block gap %s (rows %u..%u) — zero fill\n",
+               fname, st.rows_written, bh.first_row);
+        std::vector<uint8_t> part, scratch;
+        while(st.rows_written < bh.first_row){
+            uint32_t n = std::min<uint32_t>(bh.first_row - st.rows_written, LwfCodec::BLOCK_ROWS);
+            const std::vector<uint8_t>* zb = &part;
+            if(n == LwfCodec::BLOCK_ROWS){
+                if(st.zero_blk.empty() &&
+                   !LwfCodec::encode_zero_block(n, st.fft_size, 0, st.zero_blk, scratch)) return;
+                memcpy(st.zero_blk.data() + offsetof(LwfCodec::BlockHdr, first_row),
+                       &st.rows_written, sizeof(uint32_t));
+                zb = &st.zero_blk;
+            } else if(!LwfCodec::encode_zero_block(n, st.fft_size, st.rows_written, part, scratch)){
+                return;
+            }
+            if(fwrite(zb->data(), 1, zb->size(), st.fp) != zb->size()) return;
+            st.block_offs.push_back(st.file_pos);
+            st.file_pos += zb->size();
+            st.rows_written += n;
+        }
+    }
+    uint32_t len = (uint32_t)(sizeof(bh) + bh.comp_bytes);
+    if(fwrite(blk, 1, len, st.fp) != len) return;
+    st.block_offs.push_back(st.file_pos);
+    st.file_pos += len;
+    st.rows_written += bh.n_rows;
+    fflush(st.fp);
+}
+
 void CentralServer::archive_hist_on_live_stop(std::shared_ptr<HostRoom> room,
                                                const PktLwfLiveStop& stop){
     char fname[65]={}; memcpy(fname, stop.filename, 64); fname[64]=0;
     auto it = room->hist_streams.find(fname);
     if(it == room->hist_streams.end()) return;
+    if(it->second.fp && it->second.blocks && it->second.rows_written > 0)
+        LwfCodec::write_footer(it->second.fp, it->second.block_offs, it->second.rows_written);
     if(it->second.fp){
         fflush(it->second.fp);
         fclose(it->second.fp);
@@ -151,6 +151,7 @@ static constexpr uint8_t BEWE_TYPE_LWF_LIVE_START  = 0x3C;
 static constexpr uint8_t BEWE_TYPE_LWF_LIVE_ROW    = 0x3D;
 static constexpr uint8_t BEWE_TYPE_LWF_LIVE_STOP   = 0x3E;
 static constexpr uint8_t BEWE_TYPE_LWF_LIVE_REQ    = 0x3F;
+static constexpr uint8_t BEWE_TYPE_LWF_LIVE_BLOCK  = 0x59;  // v4 압축 블록 (LIVE_ROW 대체)
 
 // ── Signal Library / Emitter DB (relay 내부 dispatch에 사용) ─────────────
 static constexpr uint8_t BEWE_TYPE_RPT_ADD            = 0x23;  // REPORT_ADD (intercept 후 emitter ingest)
@@ -180,6 +181,9 @@ static constexpr uint8_t BEWE_TYPE_MISSION_FILE_DELETE    = 0x54;
 static constexpr uint8_t BEWE_TYPE_MISSION_FILE_RENAME    = 0x55;
 static constexpr uint8_t BEWE_TYPE_MISSION_FILE_PUSH_ACK  = 0x56;
 static constexpr uint8_t BEWE_TYPE_MISSION_FILE_SET_NOTE  = 0x57;
+static constexpr uint8_t BEWE_TYPE_MISSION_FILE_PUSH_STATE = 0x5A;  // resumable PUSH 진행 ACK
+static constexpr uint8_t BEWE_TYPE_STATS                   = 0x5B;  // HOST 파이프라인 메트릭 요약
+static constexpr uint8_t BEWE_TYPE_CENTRAL_CAPS            = 0x5C;  // Central 기능 bitmask (HOST_OPEN 직후)
 
 static constexpr uint8_t BEWE_TYPE_CHAT     = 0x07;
 
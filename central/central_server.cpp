@@ -37,6 +37,7 @@ static void flush_host_send_queue(std::shared_ptr<HostRoom>& room){
         std::lock_guard<std::mutex> lk(room->host_send_mtx);
         batch.swap(room->host_send_queue);
     }
+    BEWE_TRACE_SCOPE_ARG("central", "host_send", batch.size());
     for(auto& pkt : batch){
         if(room->fd < 0 || !room->alive.load()) break;
         size_t sent = 0;
@@ -192,6 +193,38 @@ bool CentralServer::start(int port){
     running_.store(true);
     accept_thr_   = std::thread(&CentralServer::accept_loop,  this);
     watchdog_thr_ = std::thread(&CentralServer::watchdog_loop, this);
+
+    JoinEntry::drop_counter(false); JoinEntry::drop_counter(true);   // 0 부터 노출 (rate() 용)
+    // /metrics: room/JOIN 수 + station 별 큐 적체 (scrape 시점, 스냅샷 후 lock 하나씩)
+    metrics_col_ = Metrics::collector_add([this](Metrics::Writer& w){
+        std::vector<std::shared_ptr<HostRoom>> rooms;
+        { std::lock_guard<std::mutex> lk(rooms_mtx_); rooms = rooms_; }
+        w.family("bewe_central_rooms", "gauge", "HOST rooms");
+        w.sample("bewe_central_rooms", "", (double)rooms.size());
+        w.family("bewe_central_joins", "gauge", "JOIN connections per station");
+        w.family("bewe_central_join_queue_bytes", "gauge", "JoinEntry queued bytes summed per station");
+        w.family("bewe_central_join_ctrl_queue", "gauge", "JoinEntry ctrl queue depth summed per station (packets)");
+        w.family("bewe_central_host_send_queue", "gauge", "Central to HOST send queue depth (packets)");
+        for(auto& r : rooms){
+            std::vector<std::shared_ptr<JoinEntry>> joins;
+            { std::lock_guard<std::mutex> jlk(r->joins_mtx); joins = r->joins; }
+            size_t qf = 0, qa = 0, qfile = 0, qc = 0;
+            for(auto& je : joins){
+                std::lock_guard<std::mutex> qlk(je->send_mtx);
+                qf += je->send_queue_bytes; qa += je->audio_queue_bytes;
+                qfile += je->file_queue_bytes; qc += je->ctrl_queue.size();
+            }
+            size_t hq;
+            { std::lock_guard<std::mutex> hlk(r->host_send_mtx); hq = r->host_send_queue.size(); }
+            std::string st = Metrics::label("station", r->station_id);
+            w.sample("bewe_central_joins", st, (double)joins.size());
+            w.sample("bewe_central_join_queue_bytes", st + ",queue=\"fft\"",   (double)qf);
+            w.sample("bewe_central_join_queue_bytes", st + ",queue=\"audio\"", (double)qa);
+            w.sample("bewe_central_join_queue_bytes", st + ",queue=\"file\"",  (double)qfile);
+            w.sample("bewe_central_join_ctrl_queue", st, (double)qc);
+            w.sample("bewe_central_host_send_queue", st, (double)hq);
+        }
+    });
     return true;
 }
 
@@ -201,6 +234,7 @@ void CentralServer::run(){
 }
 
 void CentralServer::stop(){
+    if(metrics_col_){ Metrics::collector_del(metrics_col_); metrics_col_ = 0; }
     running_.store(false);
     if(listen_fd_ >= 0){ shutdown(listen_fd_, SHUT_RDWR); close(listen_fd_); listen_fd_=-1; }
     if(accept_thr_.joinable())   accept_thr_.join();
@@ -276,6 +310,13 @@ void CentralServer::handshake(int fd){
         strncpy(room->host_name, op->station_name, 31);
         room->host_tier = op->host_tier;
 
+        // 기능 협상 — room 이 rooms_ 에 보이기 전에 큐잉해서 HOST 가 받는 첫 패킷이 되게.
+        {
+            PktCentralCaps caps{};
+            caps.caps = CENTRAL_CAP_PUSH_RESUME;
+            auto pkt = make_bewe_packet(BEWE_TYPE_CENTRAL_CAPS, &caps, sizeof(caps));
+            enqueue_host_send(room, 0xFFFF, CentralMuxType::DATA, pkt.data(), (uint32_t)pkt.size());
+        }
         {
             std::lock_guard<std::mutex> lk(rooms_mtx_);
             rooms_.erase(std::remove_if(rooms_.begin(), rooms_.end(),
@@ -404,6 +445,10 @@ void CentralServer::host_mux_loop(std::shared_ptr<HostRoom> room){
 
     printf("[Central] host_mux_loop started room='%s' fd=%d\n",
            room->station_id.c_str(), room->fd);
+    {
+        char tn[16]; snprintf(tn, sizeof(tn), "hmux%d", room->fd);
+        pthread_setname_np(pthread_self(), tn);
+    }
 
     // HOST 접속 시 DB 목록 초기 전송 (Signal Library는 클라가 Refresh 시점에 요청)
     broadcast_db_list(room);
@@ -411,6 +456,8 @@ void CentralServer::host_mux_loop(std::shared_ptr<HostRoom> room){
     // flush 전용 스레드: recv 블로킹과 분리하여 JOIN→HOST 패킷 지연 제거
     std::thread flush_thr([room](){
         std::shared_ptr<HostRoom> r = room;
+        char tn[16]; snprintf(tn, sizeof(tn), "htx%d", r->fd);
+        pthread_setname_np(pthread_self(), tn);
         while(r->alive.load()){
             flush_host_send_queue(r);
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -428,6 +475,7 @@ void CentralServer::host_mux_loop(std::shared_ptr<HostRoom> room){
             break;
         }
         recv_bytes += CENTRAL_MUX_HDR_SIZE;
+        BEWE_TRACE_SCOPE_ARG("central", "host_recv", mux.len);   // payload 수신 + 처리/분배
 
         // 3초마다 통계 (구간 값)
         auto now_s = std::chrono::steady_clock::now();
@@ -557,7 +605,8 @@ void CentralServer::host_mux_loop(std::shared_ptr<HostRoom> room){
             uint8_t bt = buf[4];
             if(bt == BEWE_TYPE_FFT)        { fft_count++;   win_fft++;   win_fft_bytes   += mux.len; }
             else if(bt == BEWE_TYPE_AUDIO) { audio_count++; win_audio++; win_audio_bytes += mux.len; }
-            else if(bt == BEWE_TYPE_LWF_LIVE_ROW)         win_hist_bytes  += mux.len;
+            else if(bt == BEWE_TYPE_LWF_LIVE_ROW ||
+                    bt == BEWE_TYPE_LWF_LIVE_BLOCK)       win_hist_bytes  += mux.len;
             else                           other_count++;
         }
 
@@ -609,6 +658,10 @@ void CentralServer::join_loop(std::shared_ptr<JoinEntry> je, std::shared_ptr<Hos
     std::vector<uint8_t> buf(PIPE_BUF_SZ);
     uint64_t pkt_count = 0;
     const char* disc_reason = "unknown";
+    {
+        char tn[16]; snprintf(tn, sizeof(tn), "jrx%u", je->conn_id);
+        pthread_setname_np(pthread_self(), tn);
+    }
 
     while(je->alive.load() && room->alive.load()){
         // BEWE 패킷 헤더 수신 (9바이트: magic[4]+type[1]+len[4])
@@ -621,6 +674,7 @@ void CentralServer::join_loop(std::shared_ptr<JoinEntry> je, std::shared_ptr<Hos
             break;
         }
         uint32_t bewe_len = *reinterpret_cast<uint32_t*>(buf.data() + 5);
+        BEWE_TRACE_SCOPE_ARG("central", "join_recv", bewe_len);   // payload 수신 + intercept/enqueue
         if(bewe_len > 4*1024*1024){
             printf("[Central] join_loop oversized bewe_len=%u conn_id=%u\n", bewe_len, je->conn_id);
             disc_reason = "oversized";
@@ -679,6 +733,7 @@ void CentralServer::dispatch_to_joins(std::shared_ptr<HostRoom> room,
                                      uint16_t conn_id,
                                      const uint8_t* bewe_pkt, size_t bewe_len){
     if(bewe_len < BEWE_HDR_SIZE) return;
+    BEWE_TRACE_SCOPE_ARG("central", "dispatch", bewe_len);
     uint8_t bewe_type = bewe_pkt[4]; // BEWE 패킷 타입
 
     // ── AUTH_ACK: HOST → JOIN 통과. 릴레이는 op_index 캐시 + 캐시 전송
@@ -831,6 +886,14 @@ void CentralServer::dispatch_to_joins(std::shared_ptr<HostRoom> room,
         archive_hist_on_live_row(room, *h, row, row_bytes);
         return;
     }
+    if(bewe_type == BEWE_TYPE_LWF_LIVE_BLOCK &&
+       bewe_len >= BEWE_HDR_SIZE + sizeof(PktLwfLiveBlockHdr)){
+        const auto* h = reinterpret_cast<const PktLwfLiveBlockHdr*>(bewe_pkt + BEWE_HDR_SIZE);
+        uint32_t blk_bytes = (uint32_t)(bewe_len - BEWE_HDR_SIZE - sizeof(PktLwfLiveBlockHdr));
+        const uint8_t* blk = bewe_pkt + BEWE_HDR_SIZE + sizeof(PktLwfLiveBlockHdr);
+        archive_hist_on_live_block(room, *h, blk, blk_bytes);
+        return;
+    }
     if(bewe_type == BEWE_TYPE_LWF_LIVE_STOP &&
        bewe_len >= BEWE_HDR_SIZE + sizeof(PktLwfLiveStop)){
         const auto* s = reinterpret_cast<const PktLwfLiveStop*>(bewe_pkt + BEWE_HDR_SIZE);
@@ -1052,7 +1115,8 @@ void CentralServer::dispatch_to_joins(std::shared_ptr<HostRoom> room,
                     bewe_type == 0x3D ||                 // LWF_LIVE_ROW (행 누락 = stream 깨짐)
                     bewe_type == 0x3E ||                 // LWF_LIVE_STOP
                     bewe_type == 0x3F ||                 // LWF_LIVE_REQ (JOIN→host opt-in)
-                    bewe_type == 0x40);                  // LWF_DELETE_REQ (JOIN→host)
+                    bewe_type == 0x40 ||                 // LWF_DELETE_REQ (JOIN→host)
+                    bewe_type == BEWE_TYPE_STATS);       // 메트릭 요약 (작고 5s 주기 — 적체 시에도 전달)
     // joins 스냅샷 후 lock 해제 — enqueue_file이 BLOCK 될 수 있어 joins_mtx 잡고 있으면 안 됨
     static thread_local std::vector<std::shared_ptr<JoinEntry>> targets;
     targets.clear();
@@ -1767,6 +1831,7 @@ inline bool ais_parse(const uint8_t* rec, uint32_t rl, AisRB& rb){
     memset(&rb.w, 0, sizeof(rb.w));
     size_t plen = rl - sizeof(MpData);
     memcpy(&rb.w, rec + sizeof(MpData), std::min(plen, sizeof(AisWireMsg)));
+    if(plen < offsetof(AisWireMsg, slot) + sizeof(rb.w.slot)) rb.w.slot = -1;   // 슬롯 이전 버전
     return true;
 }
 inline void ais_emit(std::string& out, const AisRB& rb){
@@ -4,6 +4,8 @@
 #include <set>
 #include <map>
 #include "../src/net_protocol.hpp"  // PktBandEntry/PktBandPlan/PktBandRemove
+#include "../src/metrics.hpp"       // /metrics (JoinEntry 드롭 카운터)
+#include "../src/trace.hpp"         // /trace (접속별 send/recv span)
 #include "emitter_db.hpp"
 #include <thread>
 #include <mutex>
@@ -18,17 +20,32 @@
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <pthread.h>
 
 // ── Mission File Archive (Phase 1) ─────────────────────────────────────────
 // In-flight HOST → Central file transfer state (per transfer_id).
+// resume 시 .part [0, have) 디스크 재검증 결과 (worker thread → room thread, result 는 release/acquire)
+struct PartVerify {
+    std::atomic<int> result{0};          // 0 = 검증 중, 1 = 상태와 일치, 2 = 불일치 → 0 부터
+};
+
 struct MissionFileTransfer {
     MissionFileKey key{};
-    FILE*       fp = nullptr;
+    int         fd = -1;             // pwrite at chunk offset
     uint64_t    expected_bytes = 0;  // 0 = streaming (size unknown)
     uint64_t    written_bytes  = 0;  // monotonically increasing
     uint64_t    high_water     = 0;  // max(offset + chunk) seen
     std::string archive_path;        // absolute path on Central disk
     std::string info_data;           // captured at PUSH_META, written as .info sidecar at close
+    // MFP_MODE_RESUME: data goes to hidden .<name>.part, progress to .<name>.part.state
+    bool        resumable   = false;
+    int         state_fd    = -1;
+    std::string part_path;
+    uint64_t    file_id     = 0;
+    uint64_t    have        = 0;     // verified contiguous prefix
+    uint32_t    have_crc    = 0;     // CRC32C of [0, have)
+    bool        rewind_sent = false; // suppress REWIND spam for the rest of the window
+    std::shared_ptr<PartVerify> verify;  // non-null = have/have_crc 는 상태파일 값, 검증 대기
 };
 
 // In-flight Central → JOIN download (server-side, just temporary streaming state).
@@ -45,6 +62,11 @@ struct MissionHistStream {
     uint32_t    fft_size = 0;       // row size in bytes (each row = fft_size float? NO — row is uint8 per col)
                                     // 실제는 행 크기 = fft_size (8-bit packed dB). open_new_file에서 row_bytes = fft_size.
     uint32_t    rows_written = 0;
+    // v4 host (LWF_LIVE_BLOCK): 블록 그대로 append, STOP 시 index footer 기록.
+    bool                  blocks = false;
+    uint64_t              file_pos = 0;
+    std::vector<uint64_t> block_offs;
+    std::vector<uint8_t>  zero_blk;   // gap fill 용 BLOCK_ROWS 0 행 블록 (first_row 만 패치해 재사용)
 };
 
 struct JoinEntry {
@@ -109,8 +131,17 @@ struct JoinEntry {
     std::atomic<bool>       send_stop{false};
     std::mutex              fd_write_mtx;  // fd write 직렬화
 
+    // 큐 한도 초과로 버린 패킷 (전 JOIN 누적, /metrics)
+    static Metrics::Counter& drop_counter(bool audio){
+        static auto& m_fft   = Metrics::counter("bewe_central_join_drops_total", "JoinEntry queue overflow drops (packets)", "queue=\"fft\"");
+        static auto& m_audio = Metrics::counter("bewe_central_join_drops_total", "JoinEntry queue overflow drops (packets)", "queue=\"audio\"");
+        return audio ? m_audio : m_fft;
+    }
+    static void count_drop(bool audio){ drop_counter(audio).inc(); }
+
     void send_raw(const std::vector<uint8_t>& pkt){
         if(fd < 0 || !alive.load()) return;
+        BEWE_TRACE_SCOPE_ARG("central", "join_send", pkt.size());
         std::lock_guard<std::mutex> wlk(fd_write_mtx);
         const uint8_t* p = pkt.data();
         size_t rem = pkt.size();
@@ -133,6 +164,8 @@ struct JoinEntry {
     void start_send_worker(){
         // 단일 스레드: ctrl → FFT → 오디오 우선순위 순서로 배치 전송
         send_thr = std::thread([this](){
+            char tn[16]; snprintf(tn, sizeof(tn), "jtx%u", conn_id);
+            pthread_setname_np(pthread_self(), tn);
             while(true){
                 std::vector<std::vector<uint8_t>> batch;
                 batch.reserve(32);
@@ -215,6 +248,7 @@ struct JoinEntry {
         while(send_queue_bytes + len > SEND_QUEUE_MAX_BYTES && !send_queue.empty()){
             send_queue_bytes -= send_queue.front().size();
             send_queue.pop_front();
+            count_drop(false);
         }
         send_queue.emplace_back(data, data + len);
         send_queue_bytes += len;
@@ -227,6 +261,7 @@ struct JoinEntry {
         while(audio_queue_bytes + len > AUDIO_QUEUE_MAX_BYTES && !audio_queue.empty()){
             audio_queue_bytes -= audio_queue.front().size();
             audio_queue.pop_front();
+            count_drop(true);
         }
         audio_queue.emplace_back(data, data + len);
         audio_queue_bytes += len;
@@ -351,6 +386,7 @@ private:
 
     std::thread accept_thr_;
     std::thread watchdog_thr_;
+    int         metrics_col_ = 0;   // /metrics collector (start~stop)
 
     int  make_listen_sock(int port);
     void accept_loop();
@@ -458,6 +494,12 @@ private:
     void send_push_ack(std::shared_ptr<HostRoom> room,
                        const MissionFileKey& key, uint8_t transfer_id,
                        uint8_t status, uint64_t total_bytes, const char* err);
+    void handle_push_data_resume(std::shared_ptr<HostRoom> room, uint8_t tid,
+                                 MissionFileTransfer& xf, const PktMissionFilePushData* d,
+                                 const uint8_t* raw);
+    // resumable PUSH 재개 지점 / 진행 ACK (HOST에게)
+    void send_push_state(std::shared_ptr<HostRoom> room,
+                         const MissionFileTransfer& xf, uint8_t transfer_id, uint8_t reason);
 
     // any → Central: LIST/DL/DELETE/RENAME (intercept_join_cmd에서 호출 OR host_mux_loop)
     // requester == nullptr 이면 HOST가 요청한 것 (응답은 host_send_queue로).
@@ -483,6 +525,9 @@ private:
     void archive_hist_on_live_row  (std::shared_ptr<HostRoom> room,
                                     const PktLwfLiveRowHdr& hdr,
                                     const uint8_t* row, uint32_t row_bytes);
+    void archive_hist_on_live_block(std::shared_ptr<HostRoom> room,
+                                    const PktLwfLiveBlockHdr& hdr,
+                                    const uint8_t* blk, uint32_t blk_bytes);
     void archive_hist_on_live_stop (std::shared_ptr<HostRoom> room,
                                     const PktLwfLiveStop& stop);
     // MISSION_SYNC.active 변동 시 HostRoom shadow 갱신 (cached_mission_sync 업데이트 직후 호출)
@@ -0,0 +1,377 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// 비동기 파일 writer (header-only).
+//
+//   Writer : 호출자 데이터를 정렬된 슬롯(posix_memalign 4K)에 복사 → Engine 에 제출
+//            → 즉시 반환. 슬롯 수 = in-flight 상한 (다 차면 대기 + stalls 카운트).
+//            offset/길이/주소가 4K 정렬이면 O_DIRECT fd 로, 아니면 일반 fd 로 쓴다
+//            (tmpfs 등 O_DIRECT 불가 FS 는 자동으로 일반 fd 만 사용).
+//   Engine : 프로세스 공용. BEWE_HAVE_LIBURING 이면 io_uring 1개 + reaper 스레드,
+//            아니면(또는 ring 초기화 실패 시) pwrite 스레드 풀.
+//   Stats  : writer 별 + 전체 합계 — queue depth(현재/최대), 쓰기 지연(평균/최대 µs),
+//            stalls(슬롯 대기), errors.
+//
+// 디스크가 잠깐 멈춰도 캡처 스레드는 슬롯이 남아 있는 한 막히지 않는다.
+// 같은 파일 구간을 다시 읽기 전에는 sync(off, len) 으로 그 구간 in-flight 완료를 기다릴 것
+// (sync() = 지금까지 제출분 전체).
+// ─────────────────────────────────────────────────────────────────────────────
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef BEWE_HAVE_LIBURING
+  #include <liburing.h>
+#endif
+
+namespace AsyncIO {
+
+constexpr size_t ALIGN      = 4096;
+constexpr int    POOL_THR   = 2;       // fallback pwrite 스레드 수
+constexpr unsigned URING_QD = 256;
+
+struct Stats {
+    std::atomic<uint32_t> depth{0}, depth_max{0};
+    std::atomic<uint64_t> writes{0}, bytes{0}, direct_writes{0};
+    std::atomic<uint64_t> stalls{0}, errors{0};
+    std::atomic<uint64_t> lat_sum_us{0}, lat_max_us{0};
+
+    double lat_avg_us() const {
+        uint64_t w = writes.load();
+        return w ? (double)lat_sum_us.load() / (double)w : 0.0;
+    }
+};
+inline Stats& totals(){ static Stats s; return s; }
+
+// 로그/status 한 줄: "q 0/6  lat 180/2400us  stall 0  err 0  direct 12/40"
+inline int format(char* out, size_t n, const Stats& s){
+    return snprintf(out, n, "q %u/%u  lat %.0f/%lluus  stall %llu  err %llu  direct %llu/%llu",
+                    s.depth.load(), s.depth_max.load(), s.lat_avg_us(),
+                    (unsigned long long)s.lat_max_us.load(),
+                    (unsigned long long)s.stalls.load(), (unsigned long long)s.errors.load(),
+                    (unsigned long long)s.direct_writes.load(), (unsigned long long)s.writes.load());
+}
+
+inline void stat_max(std::atomic<uint64_t>& a, uint64_t v){
+    uint64_t c = a.load(std::memory_order_relaxed);
+    while(v > c && !a.compare_exchange_weak(c, v)) {}
+}
+inline void stat_max(std::atomic<uint32_t>& a, uint32_t v){
+    uint32_t c = a.load(std::memory_order_relaxed);
+    while(v > c && !a.compare_exchange_weak(c, v)) {}
+}
+
+class Writer;
+
+struct Req {
+    Writer*  w = nullptr;
+    int      slot = -1;
+    int      fd = -1;
+    uint8_t* buf = nullptr;
+    size_t   len = 0;
+    off_t    off = 0;
+    uint64_t seq = 0;
+    bool     busy = false;     // 제출 ~ 완료 (Writer::mtx_ 보호)
+    std::chrono::steady_clock::time_point t0;
+    uint64_t tr0 = 0;   // Trace 시각 (tracer off 면 0)
+};
+
+// ── Engine (공용 제출/완료) ─────────────────────────────────────────────────
+class Engine {
+public:
+    static Engine& get(){ static Engine e; return e; }
+    bool uring() const { return uring_; }
+    inline void submit(Req* r);
+
+private:
+    Engine(){
+#ifdef BEWE_HAVE_LIBURING
+        if(!getenv("BEWE_NO_URING") && io_uring_queue_init(URING_QD, &ring_, 0) == 0){
+            uring_ = true;
+            reaper_ = std::thread([this](){ pthread_setname_np(pthread_self(), "aio_reap"); reap(); });
+            return;
+        }
+#endif
+        for(int i = 0; i < POOL_THR; i++)
+            pool_.emplace_back([this](){ pthread_setname_np(pthread_self(), "aio_pool"); work(); });
+    }
+    ~Engine(){
+#ifdef BEWE_HAVE_LIBURING
+        if(uring_){
+            {
+                std::lock_guard<std::mutex> lk(mtx_);
+                io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+                if(sqe){ io_uring_prep_nop(sqe); io_uring_sqe_set_data(sqe, nullptr); io_uring_submit(&ring_); }
+            }
+            if(reaper_.joinable()) reaper_.join();
+            io_uring_queue_exit(&ring_);
+            return;
+        }
+#endif
+        { std::lock_guard<std::mutex> lk(mtx_); stop_ = true; }
+        cv_.notify_all();
+        for(auto& t : pool_) if(t.joinable()) t.join();
+    }
+
+    inline void complete(Req* r, ssize_t res);
+    void work(){
+        std::unique_lock<std::mutex> lk(mtx_);
+        for(;;){
+            cv_.wait(lk, [&]{ return stop_ || !q_.empty(); });
+            if(q_.empty()) return;
+            Req* r = q_.front(); q_.pop_front();
+            lk.unlock();
+            complete(r, pwrite(r->fd, r->buf, r->len, r->off));
+            lk.lock();
+        }
+    }
+#ifdef BEWE_HAVE_LIBURING
+    void reap(){
+        int fails = 0;
+        for(;;){
+            io_uring_cqe* cqe = nullptr;
+            int e = io_uring_wait_cqe(&ring_, &cqe);
+            if(e == -EINTR) continue;
+            if(e < 0){
+                // 지속 오류 → busy loop 대신 back-off (완료를 못 받으면 writer 는 슬롯 대기)
+                if(fails++ == 0) fprintf(stderr, "[AIO] io_uring_wait_cqe: %s\n", strerror(-e));
+                std::this_thread::sleep_for(std::chrono::milliseconds(std::min(fails, 100)));
+                continue;
+            }
+            fails = 0;
+            Req* r = (Req*)io_uring_cqe_get_data(cqe);
+            int res = cqe->res;
+            io_uring_cqe_seen(&ring_, cqe);
+            if(!r) return;                      // 종료 NOP
+            complete(r, res);
+        }
+    }
+    io_uring ring_{};
+    std::thread reaper_;
+#endif
+
+    bool uring_ = false;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<Req*> q_;
+    std::vector<std::thread> pool_;
+    bool stop_ = false;
+};
+
+// ── Writer ──────────────────────────────────────────────────────────────────
+class Writer {
+public:
+    Writer() = default;
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    ~Writer(){ close(); }
+
+    // fd: 일반(버퍼드) 쓰기 fd. own=true 면 close() 에서 닫음.
+    // path 가 있으면 O_DIRECT fd 를 따로 열어 정렬된 요청에 사용.
+    bool attach(int fd, const char* path, bool own, size_t slot_bytes = 1 << 20, int slots = 8){
+        close();
+        if(fd < 0) return false;
+        fd_ = fd; own_ = own;
+        slot_bytes_ = std::max(ALIGN, (slot_bytes + ALIGN - 1) / ALIGN * ALIGN);
+        for(int i = 0; i < slots; i++){
+            void* p = nullptr;
+            if(posix_memalign(&p, ALIGN, slot_bytes_) != 0) break;
+            slots_.push_back((uint8_t*)p);
+            free_.push_back(i);
+        }
+        if(slots_.empty()){ close(); return false; }
+        reqs_.assign(slots_.size(), Req{});
+        dfd_ = -1;
+        if(path && !getenv("BEWE_NO_DIRECT")) dfd_ = ::open(path, O_WRONLY | O_DIRECT);
+        app_off_ = 0; cur_ = -1; cur_len_ = 0;
+        Engine::get();                       // 엔진 기동 (첫 제출 지연 제거)
+        return true;
+    }
+    bool   is_open() const  { return fd_ >= 0; }
+    bool   direct() const   { return dfd_ >= 0; }
+    const Stats& stats() const { return st_; }
+
+    // pwrite 대체: [off, off+n) — 복사 후 비동기 제출 (slot 크기 단위로 나눔).
+    void write(const void* p, size_t n, off_t off){
+        const uint8_t* s = (const uint8_t*)p;
+        while(n > 0 && fd_ >= 0){
+            size_t take = std::min(n, slot_bytes_);
+            int k = acquire();
+            memcpy(slots_[k], s, take);
+            submit(k, take, off);
+            s += take; n -= take; off += (off_t)take;
+        }
+    }
+
+    // 순차 파일: start 부터 이어 쓰기. 슬롯이 가득 찰 때만 제출 → 정렬 시 O_DIRECT.
+    void seek(off_t start){ flush(); app_off_ = start; }
+    void append(const void* p, size_t n){
+        const uint8_t* s = (const uint8_t*)p;
+        while(n > 0 && fd_ >= 0){
+            if(cur_ < 0){ cur_ = acquire(); cur_len_ = 0; }
+            size_t take = std::min(n, slot_bytes_ - cur_len_);
+            memcpy(slots_[cur_] + cur_len_, s, take);
+            cur_len_ += take; s += take; n -= take;
+            if(cur_len_ == slot_bytes_){
+                submit(cur_, cur_len_, app_off_);
+                app_off_ += (off_t)cur_len_;
+                cur_ = -1; cur_len_ = 0;
+            }
+        }
+    }
+    off_t append_pos() const { return app_off_ + (off_t)cur_len_; }
+
+    // 부분 슬롯 제출 (close 직전 / 외부 reader 가 봐야 할 때).
+    void flush(){
+        if(cur_ < 0) return;
+        if(cur_len_ > 0){ submit(cur_, cur_len_, app_off_); app_off_ += (off_t)cur_len_; }
+        else release(cur_);
+        cur_ = -1; cur_len_ = 0;
+    }
+
+    // 지금까지 제출된 요청이 모두 끝날 때까지 대기 (이후 제출분은 기다리지 않음).
+    void sync() const {
+        std::unique_lock<std::mutex> lk(mtx_);
+        uint64_t snap = seq_;
+        cv_.wait(lk, [&]{ return inflight_.empty() || *inflight_.begin() > snap; });
+    }
+    // [off, off+len) 과 겹치는 제출분만 대기 — 읽기가 무관한 쓰기 뒤에 줄 서지 않음.
+    void sync(off_t off, size_t len) const {
+        std::unique_lock<std::mutex> lk(mtx_);
+        uint64_t snap = seq_;
+        cv_.wait(lk, [&]{
+            for(const Req& r : reqs_)
+                if(r.busy && r.seq <= snap && r.off < off + (off_t)len && off < r.off + (off_t)r.len)
+                    return false;
+            return true;
+        });
+    }
+
+    void close(){
+        if(fd_ < 0 && slots_.empty()) return;
+        flush();
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            cv_.wait(lk, [&]{ return inflight_.empty(); });
+        }
+        if(dfd_ >= 0){ ::close(dfd_); dfd_ = -1; }
+        if(own_ && fd_ >= 0) ::close(fd_);
+        fd_ = -1; own_ = false;
+        for(uint8_t* p : slots_) free(p);
+        slots_.clear(); free_.clear(); reqs_.clear();
+    }
+
+private:
+    friend class Engine;
+
+    int acquire(){
+        std::unique_lock<std::mutex> lk(mtx_);
+        if(free_.empty()){
+            st_.stalls++; totals().stalls++;
+            BEWE_TRACE_SCOPE("disk", "slot_wait");
+            cv_.wait(lk, [&]{ return !free_.empty(); });
+        }
+        int k = free_.back(); free_.pop_back();
+        return k;
+    }
+    void release(int k){
+        { std::lock_guard<std::mutex> lk(mtx_); free_.push_back(k); }
+        cv_.notify_all();
+    }
+    void submit(int k, size_t len, off_t off){
+        Req* r = &reqs_[k];                  // 슬롯당 1개 — 완료 전엔 슬롯이 free_ 에 없음
+        r->w = this; r->slot = k; r->buf = slots_[k]; r->len = len; r->off = off;
+        bool aligned = ((uint64_t)off % ALIGN == 0) && (len % ALIGN == 0);
+        r->fd = (dfd_ >= 0 && aligned) ? dfd_ : fd_;
+        if(r->fd == dfd_){ st_.direct_writes++; totals().direct_writes++; }
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            r->seq = ++seq_;
+            r->busy = true;
+            inflight_.insert(r->seq);
+        }
+        uint32_t d = ++st_.depth;  stat_max(st_.depth_max, d);
+        uint32_t g = ++totals().depth; stat_max(totals().depth_max, g);
+        r->t0 = std::chrono::steady_clock::now();
+        r->tr0 = Trace::on() ? Trace::now() : 0;
+        Engine::get().submit(r);
+    }
+    // Engine 완료 콜백 (reaper / pool 스레드)
+    void done(Req* r, ssize_t res){
+        // 짧은 쓰기 / O_DIRECT 거부 → 나머지를 일반 fd 로 동기 재시도
+        size_t ok = res > 0 ? (size_t)res : 0;
+        while(ok < r->len){
+            ssize_t w = pwrite(fd_, r->buf + ok, r->len - ok, r->off + (off_t)ok);
+            if(w <= 0){
+                st_.errors++; totals().errors++;
+                fprintf(stderr, "[AIO] write failed off=%lld len=%zu: %s\n",
+                        (long long)r->off, r->len, strerror(errno));
+                break;
+            }
+            ok += (size_t)w;
+        }
+        uint64_t seq = r->seq; int slot = r->slot;
+        uint64_t us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - r->t0).count();
+        for(Stats* s : { &st_, &totals() }){
+            s->writes++; s->bytes += r->len; s->lat_sum_us += us;
+            stat_max(s->lat_max_us, us);
+            s->depth--;
+        }
+        BEWE_TRACE_SPAN("disk", "write", r->tr0, r->len);   // 제출 → 완료 (완료 스레드에 기록)
+        // lock 안에서 notify — close() 가 깨어나 writer 를 해제하기 전에 끝나도록
+        std::lock_guard<std::mutex> lk(mtx_);
+        r->busy = false;
+        inflight_.erase(seq);
+        free_.push_back(slot);
+        cv_.notify_all();
+    }
+
+    int    fd_ = -1, dfd_ = -1;
+    bool   own_ = false;
+    size_t slot_bytes_ = 0;
+    std::vector<uint8_t*> slots_;
+    std::vector<int>      free_;
+    std::vector<Req>      reqs_;     // slots_ 와 1:1 (요청마다 new 안 함)
+    int    cur_ = -1;
+    size_t cur_len_ = 0;
+    off_t  app_off_ = 0;
+    uint64_t seq_ = 0;
+    std::set<uint64_t> inflight_;
+    mutable std::mutex mtx_;
+    mutable std::condition_variable cv_;
+    Stats  st_;
+};
+
+inline void Engine::complete(Req* r, ssize_t res){ r->w->done(r, res); }
+
+inline void Engine::submit(Req* r){
+#ifdef BEWE_HAVE_LIBURING
+    if(uring_){
+        std::lock_guard<std::mutex> lk(mtx_);
+        io_uring_sqe* sqe;
+        while(!(sqe = io_uring_get_sqe(&ring_))) io_uring_submit(&ring_);
+        io_uring_prep_write(sqe, r->fd, r->buf, (unsigned)r->len, (uint64_t)r->off);
+        io_uring_sqe_set_data(sqe, r);
+        io_uring_submit(&ring_);
+        return;
+    }
+#endif
+    { std::lock_guard<std::mutex> lk(mtx_); q_.push_back(r); }
+    cv_.notify_one();
+}
+
+} // namespace AsyncIO
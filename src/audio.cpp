@@ -39,7 +39,7 @@ void FFTViewer::mix_worker(){
                     float smp=0; int8_t pan=0;
                     bool jgate=channels[c].sq_gate.load(std::memory_order_relaxed);
                     if(!net_cli->audio[c].pop(smp, pan)){
-                        if(rec_on && channels[c].audio_rec_fp)
+                        if(rec_on && channels[c].audio_rec_io.load(std::memory_order_relaxed)==Channel::REC_IO_OPEN)
                             channels[c].maybe_rec_audio(0.f, jgate);
                         continue;
                     }
@@ -2,6 +2,9 @@
 #include <thread>
 #include "net_server.hpp"
 #include "long_waterfall.hpp"
+#include "metrics.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <volk/volk.h>
 #include <cstring>
 #include <algorithm>
@@ -87,7 +90,8 @@ bool FFTViewer::initialize_bladerf(float cf_mhz, float sr_msps){
     s=bladerf_enable_module(dev_blade,BLADERF_CHANNEL_RX(0),true);
     if(s){ bewe_log("enable: %s\n",bladerf_strerror(s)); bladerf_close(dev_blade); return false; }
 
-    s=bladerf_sync_config(dev_blade,BLADERF_RX_X1,BLADERF_FORMAT_SC16_Q11,512,16384,128,5000);
+    // _META 포맷: sync_rx 가 timestamp/overrun status 를 돌려줌 → 샘플 손실 계측 (/metrics)
+    s=bladerf_sync_config(dev_blade,BLADERF_RX_X1,BLADERF_FORMAT_SC16_Q11_META,512,16384,128,5000);
     if(s){ bewe_log("sync: %s\n",bladerf_strerror(s)); bladerf_close(dev_blade); return false; }
 
     bewe_log("BladeRF: %.2f MHz  %.2f MSPS  BW %.2f MHz\n",cf_mhz,actual/1e6f,actual_bw/1e6f);
@@ -124,6 +128,7 @@ bool FFTViewer::initialize_bladerf(float cf_mhz, float sr_msps){
 }
 
 void FFTViewer::capture_and_process(){
+    PipeStats::name_thread("cap_bladerf");
     // RX 버퍼: fft_size와 무관하게 최소 8192 샘플 고정 > USB 오버헤드 최소화
     static constexpr int RX_MIN = 8192;
     int rx_chunk = std::max(fft_input_size, RX_MIN);
@@ -133,6 +138,12 @@ void FFTViewer::capture_and_process(){
     int rx_avail = 0; // iq_buf에 유효한 샘플 수
 
     std::vector<float> pacc(fft_size,0.0f); int fcnt=0;
+    // RX 계측: overrun = META status, 손실 샘플 = timestamp 불연속 (다음 기대 ts 대비)
+    static auto& m_rx      = Metrics::counter("bewe_sdr_rx_samples_total", "SDR samples received", "sdr=\"bladerf\"");
+    static auto& m_ovr     = Metrics::counter("bewe_sdr_rx_overruns_total", "SDR RX overruns reported by the driver", "sdr=\"bladerf\"");
+    static auto& m_lost    = Metrics::counter("bewe_sdr_rx_lost_samples_total", "Samples lost to overrun / timestamp gaps", "sdr=\"bladerf\"");
+    static auto& m_rx_wait = Metrics::histogram("bewe_sdr_rx_wait_seconds", "Time blocked in SDR read call", "sdr=\"bladerf\"", 1e-6);
+    uint64_t rx_next_ts = 0;   // 0 = 기준 없음 (시작/재설정 직후)
     // 초기 안정화: 처음 N번 FFT 결과 버림
     static constexpr int WARMUP_FFTS = 30;
     int warmup_cnt = 0;
@@ -141,7 +152,7 @@ void FFTViewer::capture_and_process(){
         // ── Pause (타임머신 모드) ─────────────────────────────────────────
         if(capture_pause.load(std::memory_order_relaxed)){
             std::this_thread::sleep_for(std::chrono::milliseconds(20));
-            rx_avail=0; rx_pos=0;
+            rx_avail=0; rx_pos=0; rx_next_ts=0;   // 일시정지 중 버려지는 샘플은 손실 아님
             continue;
         }
 
@@ -195,19 +206,13 @@ void FFTViewer::capture_and_process(){
             bool tm_was_on = tm_iq_on.load(std::memory_order_relaxed);
             if(tm_was_on) tm_iq_on.store(false);
             tm_iq_close(); // fd 닫기 + 상태 초기화 (이미 closed면 no-op)
-            // 기존 SR 롤링 파일 삭제 (SR 불일치 방지)
-            {
-                std::string tm_dir = BEWEPaths::time_temp_dir();
-                char old_path[256];
-                snprintf(old_path, sizeof(old_path), "%s/iq_rolling_%uMSPS.wav",
-                         tm_dir.c_str(), header.sample_rate/1000000);
-                if(access(old_path, F_OK)==0){ remove(old_path); }
-            }
+            // 기존 SR 롤링 파일 삭제 (SR 불일치 방지, raw/압축 둘 다)
+            tm_iq_remove_rolling(header.sample_rate);
 
             // 122.88M 이상 > SC8_Q7 (8bit) + OVERSAMPLE, 그 외 > SC16_Q11 (16bit)
             bool was_sc8 = sc8_mode;
             sc8_mode = (new_sr >= 122880000);
-            bladerf_format fmt = sc8_mode ? BLADERF_FORMAT_SC8_Q7 : BLADERF_FORMAT_SC16_Q11;
+            bladerf_format fmt = sc8_mode ? BLADERF_FORMAT_SC8_Q7_META : BLADERF_FORMAT_SC16_Q11_META;
 
             bladerf_enable_module(dev_blade,BLADERF_CHANNEL_RX(0),false);
 
@@ -248,11 +253,11 @@ void FFTViewer::capture_and_process(){
 
             rx_chunk = std::max(fft_input_size, RX_MIN);
             delete[] iq_buf; iq_buf = new int16_t[rx_chunk*2];
-            rx_pos=0; rx_avail=0;
+            rx_pos=0; rx_avail=0; rx_next_ts=0;
             pacc.assign(fft_size,0.0f); fcnt=0; warmup_cnt=0;
             texture_needs_recreate=true;
             // SR 변경 > 신호 크기 스케일이 달라질 수 있어 오토스케일 재트리거
-            autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
+            autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
             // TM IQ: SC8 모드(122.88M)에서는 롤링 IQ 비활성화
             if(tm_was_on && !sc8_mode){
                 tm_iq_open();
@@ -277,7 +282,7 @@ void FFTViewer::capture_and_process(){
                 live_cf_hz.store((uint64_t)(pending_cf*1e6), std::memory_order_release);
                 LongWaterfall::request_rotate();   // CF changed → new file
                 bewe_log("Freq > %.2f MHz\n",pending_cf);
-                autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
+                autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
                 warmup_cnt=0;
                 update_dem_by_freq(pending_cf);
             }
@@ -286,8 +291,15 @@ void FFTViewer::capture_and_process(){
 
         // ── RX: 고정 청크(min 8192)로 읽기 > fft_size 무관 일정 throughput ──
         if(rx_avail == 0){
-            int status=bladerf_sync_rx(dev_blade,iq_buf,rx_chunk,nullptr,3000);
+            BEWE_TRACE_SCOPE_ARG("cap", "rx", rx_chunk);
+            bladerf_metadata meta{};
+            meta.flags = BLADERF_META_FLAG_RX_NOW;
+            auto t_rx0 = std::chrono::steady_clock::now();
+            int status=bladerf_sync_rx(dev_blade,iq_buf,rx_chunk,&meta,3000);
+            m_rx_wait.observe((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now()-t_rx0).count());
             if(status){
+                rx_next_ts = 0;
                 if(status==BLADERF_ERR_TIMEOUT){
                     // 타임아웃 중 장치 분리 확인
                     if(!dev_blade || !bladerf_is_fpga_configured(dev_blade)){
@@ -305,10 +317,23 @@ void FFTViewer::capture_and_process(){
                 sdr_stream_error.store(true);
                 break;
             }
+            // overrun 시 actual_count < rx_chunk (버퍼 앞부분만 유효)
+            int got = (int)std::min<unsigned>(meta.actual_count, (unsigned)rx_chunk);
+            if(meta.status & BLADERF_META_STATUS_OVERRUN){
+                m_ovr.inc();
+                BEWE_TRACE_INSTANT("cap", "overrun", got);
+            }
+            if(rx_next_ts && meta.timestamp > rx_next_ts){
+                m_lost.inc(meta.timestamp - rx_next_ts);
+                BEWE_TRACE_INSTANT("cap", "lost", meta.timestamp - rx_next_ts);
+            }
+            rx_next_ts = meta.timestamp + (uint64_t)got;
+            m_rx.inc((uint64_t)got);
+            if(got <= 0) continue;
             // SC8_Q7: int8 샘플을 int16으로 확장 (뒤에서부터 > in-place 안전)
             if(sc8_mode){
                 int8_t* i8 = (int8_t*)iq_buf;
-                for(int k = rx_chunk*2 - 1; k >= 0; k--)
+                for(int k = got*2 - 1; k >= 0; k--)
                     iq_buf[k] = (int16_t)i8[k];
             }
             // IQ Ring write: 전체 청크를 한 번에 ring에 추가
@@ -319,18 +344,10 @@ void FFTViewer::capture_and_process(){
             }
             bool need_tm=!sc8_mode&&tm_iq_on.load(std::memory_order_relaxed)&&(warmup_cnt>=WARMUP_FFTS);
             if(need_ring||need_tm){
-                size_t wp=ring_wp.load(std::memory_order_relaxed);
-                size_t n=(size_t)rx_chunk, cap=IQ_RING_CAPACITY;
-                if(wp+n<=cap) memcpy(&ring[wp*2],iq_buf,n*2*sizeof(int16_t));
-                else{
-                    size_t p1=cap-wp, p2=n-p1;
-                    memcpy(&ring[wp*2],iq_buf,p1*2*sizeof(int16_t));
-                    memcpy(&ring[0],iq_buf+p1*2,p2*2*sizeof(int16_t));
-                }
-                ring_wp.store((wp+n)&IQ_RING_MASK,std::memory_order_release);
-                if(need_tm) tm_iq_write(iq_buf,(int)n);
+                iq_ring_write(iq_buf,(size_t)got);
+                if(need_tm) tm_iq_write(iq_buf,got);
             }
-            rx_pos=0; rx_avail=rx_chunk;
+            rx_pos=0; rx_avail=got;
         }
 
         // ── FFT: 버퍼에서 fft_input_size씩 처리 ─────────────────────────
@@ -350,20 +367,7 @@ void FFTViewer::capture_and_process(){
                 fft_in[i][0]=iq[i*2]/hw.iq_scale;
                 fft_in[i][1]=iq[i*2+1]/hw.iq_scale;
             }
-            // Nuttall window via VOLK SIMD (complex × real element-wise)
-            volk_32fc_32f_multiply_32fc((lv_32fc_t*)fft_in, (lv_32fc_t*)fft_in,
-                                        win_buf, fft_input_size);
-            // pad region은 init/resize 시 한 번만 0 초기화 (out-of-place FFT > fft_in 불변)
-            fftwf_execute(fft_plan);
-            {
-                // VOLK magnitude squared: |X[k]|² for all bins
-                volk_32fc_magnitude_squared_32f(mag_sq_buf, (lv_32fc_t*)fft_out, fft_size);
-                const float scale=NUTTALL_WINDOW_CORRECTION/((float)fft_input_size*(float)fft_input_size);
-                for(int i=0;i<fft_size;i++){
-                    pacc[i] += mag_sq_buf[i]*scale + 1e-10f;
-                }
-            }
-            pacc[0]=(pacc[1]+pacc[fft_size-1])*0.5f; fcnt++;
+            fft_accumulate(pacc.data()); fcnt++;
             if(fcnt>=time_average){
                 if(warmup_cnt < WARMUP_FFTS){
                     warmup_cnt++;
@@ -371,67 +375,7 @@ void FFTViewer::capture_and_process(){
                     rx_pos+=fft_input_size; rx_avail-=fft_input_size;
                     continue;
                 }
-                int fi=total_ffts%MAX_FFTS_MEMORY;
-                float* rowp=fft_data.data()+fi*fft_size;
-                {std::lock_guard<std::mutex> lk(data_mtx);
-                 // current_spectrum은 UI 스레드 전용(픽셀별 peak) > 캡처가 절대 쓰지 않음
-                 // (과거 bin별 avg를 여기에 덮어써 UI 파워스펙트럼에 1프레임 깨짐 유발했음)
-                 for(int i=0;i<fft_size;i++){
-                     rowp[i]=10.0f*log10f(pacc[i]/fcnt);
-                 }
-                 // 비-캡처 스레드 요청 처리 (set_frequency/init) — 여기서만 autoscale 상태 변경 (레이스 X)
-                 if(autoscale_req.exchange(false)){
-                     autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
-                 }
-                 if(autoscale_active){
-                     if(!autoscale_init){
-                         size_t cap=(size_t)fft_size*100;
-                         if(autoscale_accum.size()!=cap) autoscale_accum.assign(cap,0.0f);
-                         autoscale_wp=0; autoscale_buf_full=false;
-                         autoscale_last=std::chrono::steady_clock::now();
-                         autoscale_init=true;
-                     }
-                     size_t cap=autoscale_accum.size();
-                     for(int i=1;i<fft_size;i++){
-                         autoscale_accum[autoscale_wp]=rowp[i];  // current_spectrum 대신 rowp 직접 사용
-                         if(++autoscale_wp>=cap){ autoscale_wp=0; autoscale_buf_full=true; }
-                     }
-                     float el=std::chrono::duration<float>(std::chrono::steady_clock::now()-autoscale_last).count();
-                     if(el>=1.0f&&(autoscale_buf_full||autoscale_wp>0)){
-                         size_t n=autoscale_buf_full?cap:autoscale_wp;
-                         std::vector<float> tmp(autoscale_accum.begin(),
-                                                autoscale_accum.begin()+(ptrdiff_t)n);
-                         // 노이즈 플로어: 15% 분위수 → pmin = noise - 5dB
-                         // 피크: 99% 분위수 → pmax = peak + 20dB
-                         size_t idx_lo=(size_t)(n*0.15f);
-                         std::nth_element(tmp.begin(),tmp.begin()+(ptrdiff_t)idx_lo,tmp.end());
-                         float noise=tmp[idx_lo];
-                         float peak=*std::max_element(tmp.begin(),tmp.end());
-                         display_power_min=noise-5.0f;
-                         display_power_max=peak+20.0f;
-                         if(display_power_max-display_power_min<20.f)
-                             display_power_max=display_power_min+20.f;
-                         header.power_min=display_power_min;
-                         header.power_max=display_power_max;
-                         bewe_log_push(0,"[autoscale] noise=%.1f peak=%.1f → pmin=%.1f pmax=%.1f\n",
-                             noise, peak, display_power_min, display_power_max);
-                         autoscale_active=false; autoscale_init=false;
-                         autoscale_wp=0; autoscale_buf_full=false;
-                         cached_sp_idx=-1;
-                     }
-                 }
-                 total_ffts++; current_fft_idx=total_ffts-1;
-                 header.num_ffts=std::min(total_ffts,MAX_FFTS_MEMORY);
-                 row_write_pos[current_fft_idx%MAX_FFTS_MEMORY]=tm_iq_write_sample;
-                 row_wall_ms[current_fft_idx%MAX_FFTS_MEMORY]=(int64_t)(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-                 if(tm_iq_on.load(std::memory_order_relaxed))
-                     tm_mark_rows(current_fft_idx%MAX_FFTS_MEMORY);
-                 else
-                     iq_row_avail[current_fft_idx%MAX_FFTS_MEMORY]=false;
-                 tm_add_time_tag(current_fft_idx);
-                 net_bcast_seq.fetch_add(1, std::memory_order_release);
-                 net_bcast_cv.notify_one();
-                }
+                fft_commit_row(pacc.data(), fcnt);
                 std::fill(pacc.begin(),pacc.end(),0.0f); fcnt=0;
             }
         } // end !spectrum_pause
@@ -0,0 +1,102 @@
+#include "fft_viewer.hpp"
+#include "net_server.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <volk/volk.h>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+
+// ── 캡처 백엔드 공통 hot path ─────────────────────────────────────────────
+// BladeRF / RTL-SDR / Pluto / Replay 가 동일 경로를 타도록 여기 한 곳에 둠.
+// (replay 벤치 결과가 실장비 경로의 회귀 지표가 되려면 코드가 같아야 함)
+
+// IQ Ring write: n 샘플 (int16 IQ 인터리브) → ring, wp 전진 (캡처 스레드 전용)
+void FFTViewer::iq_ring_write(const int16_t* iq, size_t n){
+    BEWE_TRACE_SCOPE_ARG("cap", "ring_write", n);
+    size_t wp=ring_wp.load(std::memory_order_relaxed);
+    const size_t cap=IQ_RING_CAPACITY;
+    if(wp+n<=cap) memcpy(&ring[wp*2],iq,n*2*sizeof(int16_t));
+    else{
+        size_t p1=cap-wp, p2=n-p1;
+        memcpy(&ring[wp*2],iq,p1*2*sizeof(int16_t));
+        memcpy(&ring[0],iq+p1*2,p2*2*sizeof(int16_t));
+    }
+    ring_wp.store((wp+n)&IQ_RING_MASK,std::memory_order_release);
+    static auto& m_ring = Metrics::counter("bewe_ring_written_samples_total", "Samples written to the IQ ring");
+    m_ring.inc(n);
+}
+
+// fft_in[0..fft_input_size) 가 채워진 상태에서 호출 → 창 + FFT + |X|² 를 pacc 에 누적.
+// 호출자가 fcnt++ 담당.
+void FFTViewer::fft_accumulate(float* pacc){
+    BEWE_TRACE_SCOPE_ARG("cap", "fft", fft_size);
+    // Nuttall window via VOLK SIMD (complex × real element-wise)
+    volk_32fc_32f_multiply_32fc((lv_32fc_t*)fft_in, (lv_32fc_t*)fft_in,
+                                win_buf, fft_input_size);
+    // pad region은 init/resize 시 한 번만 0 초기화 (out-of-place FFT > fft_in 불변)
+    fftwf_execute(fft_plan);
+    // VOLK magnitude squared: |X[k]|² for all bins
+    volk_32fc_magnitude_squared_32f(mag_sq_buf, (lv_32fc_t*)fft_out, fft_size);
+    const float scale=NUTTALL_WINDOW_CORRECTION/((float)fft_input_size*(float)fft_input_size);
+    for(int i=0;i<fft_size;i++){
+        pacc[i] += mag_sq_buf[i]*scale + 1e-10f;
+    }
+    pacc[0]=(pacc[1]+pacc[fft_size-1])*0.5f;
+}
+
+// time_average 만큼 누적된 pacc → dB 행 1개 commit (autoscale, fft_data, TM 태그, 브로드캐스트 알림).
+// pacc 는 dB 로 덮어씀 — 호출자가 이후 0 으로 리셋.
+void FFTViewer::fft_commit_row(float* pacc, int fcnt){
+    BEWE_TRACE_SCOPE_ARG("cap", "row_commit", fcnt);
+    int fi=total_ffts%MAX_FFTS_MEMORY;
+    // dB 변환은 pacc 제자리 (lock 밖). autoscale 은 이 float 행을 보고,
+    // fft_data 에는 행 자신의 min/max 로 양자화해 저장 (fft_store_row).
+    for(int i=0;i<fft_size;i++) pacc[i]=10.0f*log10f(pacc[i]/fcnt);
+    const float* rowp=pacc;
+    std::lock_guard<std::mutex> lk(data_mtx);
+    // current_spectrum은 UI 스레드 전용(픽셀별 peak) > 캡처가 절대 쓰지 않음
+    // (과거 bin별 avg를 여기에 덮어써 UI 파워스펙트럼에 1프레임 깨짐 유발했음)
+    // 비-캡처 스레드 요청 처리 (set_frequency/init) — 여기서만 autoscale 상태 변경 (레이스 X)
+    if(autoscale_req.exchange(false)){
+        autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
+    }
+    if(autoscale_active){
+        if(!autoscale_init){
+            autoscale_hist.clear();
+            autoscale_last=std::chrono::steady_clock::now();
+            autoscale_init=true;
+        }
+        autoscale_hist.add(rowp+1,fft_size-1);   // DC bin 제외
+        float el=std::chrono::duration<float>(std::chrono::steady_clock::now()-autoscale_last).count();
+        if(el>=1.0f&&autoscale_hist.count()>0){
+            // 노이즈 플로어: 15% 분위수 → pmin = noise - 5dB, 피크: max → pmax = peak + 20dB
+            float noise=autoscale_hist.quantile(0.15f);
+            float peak=autoscale_hist.max();
+            display_power_min=noise-5.0f;
+            display_power_max=peak+20.0f;
+            if(display_power_max-display_power_min<20.f)
+                display_power_max=display_power_min+20.f;
+            header.power_min=display_power_min;
+            header.power_max=display_power_max;
+            bewe_log_push(0,"[autoscale] noise=%.1f peak=%.1f → pmin=%.1f pmax=%.1f\n",
+                noise, peak, display_power_min, display_power_max);
+            autoscale_active=false; autoscale_init=false;
+            cached_sp_idx=-1;
+        }
+    }
+    fft_store_row(fi,rowp);
+    total_ffts++; current_fft_idx=total_ffts-1;
+    header.num_ffts=std::min(total_ffts,MAX_FFTS_MEMORY);
+    row_write_pos[current_fft_idx%MAX_FFTS_MEMORY]=tm_iq_write_sample;
+    row_wall_ms[current_fft_idx%MAX_FFTS_MEMORY]=(int64_t)(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    if(tm_iq_on.load(std::memory_order_relaxed))
+        tm_mark_rows(current_fft_idx%MAX_FFTS_MEMORY);
+    else
+        iq_row_avail[current_fft_idx%MAX_FFTS_MEMORY]=false;
+    tm_add_time_tag(current_fft_idx);
+    net_bcast_seq.fetch_add(1, std::memory_order_release);
+    net_bcast_cv.notify_one();
+    static auto& m_rows = Metrics::counter("bewe_fft_rows_total", "Waterfall rows committed");
+    m_rows.inc();
+}
@@ -8,6 +8,7 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <netinet/tcp.h>
+#include <sys/sendfile.h>
 #include <fcntl.h>
 #include <poll.h>
 #include <chrono>
@@ -205,7 +206,7 @@ void CentralClient::enqueue_central(const void* hdr, size_t hdr_len,
             bool dropped = false;
             for(auto it = central_send_queue_.begin(); it != central_send_queue_.end(); ++it){
                 if(!it->no_drop){
-                    central_queue_bytes_ -= it->data.size();
+                    central_queue_bytes_ -= it->data.size() + it->file_len;
                     central_send_queue_.erase(it);
                     dropped = true;
                     break;
@@ -227,9 +228,24 @@ void CentralClient::enqueue_central(const void* hdr, size_t hdr_len,
     central_queue_cv_.notify_one();
 }
 
+// 파일 구간을 소켓으로 직접 (page cache → socket, user-space 복사 없음)
+static bool central_sendfile_all(int sock, int fd, uint64_t off, size_t len){
+    off_t o = (off_t)off;
+    while(len > 0){
+        ssize_t r = sendfile(sock, fd, &o, len);
+        if(r < 0){
+            if(errno == EINTR) continue;
+            return false;
+        }
+        if(r == 0){ errno = EIO; return false; }  // 파일이 도중에 잘림 → 프레임 깨짐, 연결 리셋
+        len -= (size_t)r;
+    }
+    return true;
+}
+
 // central_fd 단독 write 스레드: 배치 처리로 큐를 빠르게 드레인
 void CentralClient::central_sender_loop(int central_fd){
-    std::deque<std::vector<uint8_t>> batch;
+    std::deque<QueueEntry> batch;
     while(central_sender_running_.load()){
         batch.clear();
         {
@@ -240,13 +256,17 @@ void CentralClient::central_sender_loop(int central_fd){
             // 한 번에 최대 64개 꺼내기
             int n = 0;
             while(!central_send_queue_.empty() && n++ < 64){
-                central_queue_bytes_ -= central_send_queue_.front().data.size();
-                batch.push_back(std::move(central_send_queue_.front().data));
+                auto& f = central_send_queue_.front();
+                central_queue_bytes_ -= f.data.size() + f.file_len;
+                batch.push_back(std::move(f));
                 central_send_queue_.pop_front();
             }
         }
-        for(auto& pkt : batch){
-            if(!central_send_all(central_fd, pkt.data(), pkt.size())){
+        for(auto& e : batch){
+            bool ok = central_send_all(central_fd, e.data.data(), e.data.size());
+            if(ok && e.file && e.file_len)
+                ok = central_sendfile_all(central_fd, e.file->fd, e.file_off, e.file_len);
+            if(!ok){
                 int e = errno;
                 bewe_log_push(1,"[CentralClient] relay_sender: send failed errno=%d(%s), closing central_fd\n",
                        e, strerror(e));
@@ -266,6 +286,8 @@ void CentralClient::start_mux_adapter(int central_fd,
     stop_mux_adapter();
     mux_central_fd_ = central_fd;
     on_central_disconnect_ = std::move(on_disconnect);
+    central_caps_.store(0);
+    central_caps_known_.store(false);
 
     // central_fd 송신 타임아웃 해제 (relay_sender가 단독으로 블로킹 write)
     // tcp_connect에서 설정된 3초 SNDTIMEO를 제거해 장기 스트림에 맞게 설정
@@ -408,6 +430,10 @@ void CentralClient::mux_loop(int central_fd,
 
         auto mux_type = static_cast<CentralMuxType>(mux.type);
         uint16_t cid  = mux.conn_id;
+        // CENTRAL_CAPS 는 Central 이 보내는 첫 패킷 — 그 전에 다른 게 오면 구버전 Central (caps 0)
+        if(!central_caps_known_.load(std::memory_order_relaxed) &&
+           !(mux_type == CentralMuxType::DATA && cid == 0xFFFF))
+            central_caps_known_.store(true, std::memory_order_release);
 
         if(mux_type == CentralMuxType::CONN_OPEN){
             // 새 JOIN → socketpair 생성
@@ -492,6 +518,17 @@ void CentralClient::mux_loop(int central_fd,
             // 릴레이→HOST 방향 broadcast (conn_id=0xFFFF) 처리
             if(cid == 0xFFFF && mux.len >= 9){
                 uint8_t btype = buf[4];
+                if(btype == 0x5C){  // CENTRAL_CAPS: 기능 협상
+                    if(mux.len >= 9 + sizeof(PktCentralCaps)){
+                        const auto* c = reinterpret_cast<const PktCentralCaps*>(buf.data() + 9);
+                        central_caps_.store(c->caps, std::memory_order_relaxed);
+                        bewe_log_push(1,"[CentralClient] Central caps 0x%08x\n", c->caps);
+                    }
+                    central_caps_known_.store(true, std::memory_order_release);
+                    continue;
+                }
+                if(!central_caps_known_.load(std::memory_order_relaxed))
+                    central_caps_known_.store(true, std::memory_order_release);
                 if(btype == 0x0A){  // CH_SYNC: audio_mask 갱신
                     if(on_central_ch_sync_)
                         on_central_ch_sync_(buf.data(), mux.len);
@@ -555,6 +592,11 @@ void CentralClient::mux_loop(int central_fd,
                         on_central_mf_push_ack_(buf.data(), mux.len);
                     continue;
                 }
+                if(btype == 0x5A){  // MISSION_FILE_PUSH_STATE: Central → HOST
+                    if(on_central_mf_push_state_)
+                        on_central_mf_push_state_(buf.data(), mux.len);
+                    continue;
+                }
             }
 
             // 중앙서버→HOST CHAT: relay 루프 방지를 위해 socketpair 전달 않음
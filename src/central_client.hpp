@@ -11,6 +11,7 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unistd.h>
 
 // ── CentralClient ────────────────────────────────────────────────────────────
 // HOST 모드:
@@ -66,6 +67,12 @@ public:
                            std::function<void()> on_disconnect = nullptr);
     void stop_mux_adapter();
     bool is_central_connected() const { return mux_running_.load(); }
+    // 현재 연결된 Central 의 CENTRAL_CAP_* (net_protocol.hpp). false = 아직 첫 패킷 전 (미확정).
+    bool central_caps(uint32_t& caps) const {
+        if(!central_caps_known_.load(std::memory_order_acquire)) return false;
+        caps = central_caps_.load(std::memory_order_relaxed);
+        return true;
+    }
     size_t queue_bytes() const { return central_queue_bytes_; }
 
     // HOST 주기 STATS 출력용 (3초 평균 전송 바이트/s)
@@ -100,12 +107,44 @@ public:
                  || bt == BEWE_TYPE_MISSION_FILE_PUSH_DATA
                  || bt == BEWE_TYPE_MISSION_FILE_DL_DATA)
                 stat_tx_file_bytes.fetch_add(tot, std::memory_order_relaxed);
-            else if(bt == BEWE_TYPE_LWF_LIVE_ROW)
+            else if(bt == BEWE_TYPE_LWF_LIVE_ROW || bt == BEWE_TYPE_LWF_LIVE_BLOCK)
                 stat_tx_hist_bytes.fetch_add(tot, std::memory_order_relaxed);
         }
         enqueue_central(&mh, CENTRAL_MUX_HDR_SIZE, bewe_pkt, bewe_len, no_drop);
     }
 
+    // sendfile 원본 fd. 큐에 남은 엔트리가 다 나갈 때까지 살아 있어야 해서 shared 소유.
+    struct SendFile {
+        int fd = -1;
+        ~SendFile(){ if(fd >= 0) ::close(fd); }
+    };
+    // 파일 구간을 payload 꼬리로 붙이는 broadcast (no_drop). bewe_hdr 의 len 필드는
+    // 구간 길이까지 포함해야 함. sender 스레드가 헤더 send 후 sendfile → 청크가
+    // user-space 버퍼를 거치지 않음 (MissionPush 청크 전송).
+    void enqueue_relay_broadcast_file(const uint8_t* bewe_hdr, size_t hdr_len,
+                                      std::shared_ptr<SendFile> src,
+                                      uint64_t off, uint32_t len){
+        if(!central_sender_running_.load()) return;
+        CentralMuxHdr mh{}; mh.conn_id = 0xFFFF;
+        mh.type = static_cast<uint8_t>(CentralMuxType::DATA);
+        mh.len  = (uint32_t)(hdr_len + len);
+        uint64_t tot = (uint64_t)hdr_len + len + CENTRAL_MUX_HDR_SIZE;
+        stat_tx_total_bytes.fetch_add(tot, std::memory_order_relaxed);
+        stat_tx_file_bytes.fetch_add(tot, std::memory_order_relaxed);
+        QueueEntry e;
+        e.data.reserve(CENTRAL_MUX_HDR_SIZE + hdr_len);
+        e.data.insert(e.data.end(), (const uint8_t*)&mh, (const uint8_t*)&mh + CENTRAL_MUX_HDR_SIZE);
+        e.data.insert(e.data.end(), bewe_hdr, bewe_hdr + hdr_len);
+        e.no_drop  = true;
+        e.file     = std::move(src);
+        e.file_off = off;
+        e.file_len = len;
+        std::lock_guard<std::mutex> lk(central_queue_mtx_);
+        central_queue_bytes_ += e.data.size() + len;
+        central_send_queue_.push_back(std::move(e));
+        central_queue_cv_.notify_one();
+    }
+
     // 중앙서버→HOST 방향 전역 채팅 수신 콜백 설정
     void set_on_central_chat(std::function<void(const char* from, const char* msg)> cb){
         on_central_chat_ = std::move(cb);
@@ -142,6 +181,9 @@ private:
     std::thread       mux_thr_;
     std::atomic<bool> mux_running_{false};
     int               mux_central_fd_ = -1;
+    // 기능 협상 (CENTRAL_CAPS) — 연결마다 초기화, mux_loop 가 첫 패킷에서 확정
+    std::atomic<uint32_t> central_caps_{0};
+    std::atomic<bool>     central_caps_known_{false};
 
     // central_fd 전용 송신 큐 + 스레드
     // 펌프/HB 모두 여기 enqueue → central_sender_thr_ 가 직렬로 write
@@ -150,7 +192,13 @@ private:
     std::atomic<bool>        central_sender_running_{false};
     std::mutex               central_queue_mtx_;
     std::condition_variable  central_queue_cv_;
-    struct QueueEntry { std::vector<uint8_t> data; bool no_drop; };
+    struct QueueEntry {
+        std::vector<uint8_t>      data;
+        bool                      no_drop = false;
+        std::shared_ptr<SendFile> file;          // 있으면 data 뒤에 [file_off, +file_len) sendfile
+        uint64_t                  file_off = 0;
+        uint32_t                  file_len = 0;
+    };
     std::deque<QueueEntry> central_send_queue_;
     size_t                   central_queue_bytes_ = 0;
     static constexpr size_t  CENTRAL_QUEUE_MAX_BYTES = 4 * 1024 * 1024; // 4MB (~1초)
@@ -185,6 +233,7 @@ private:
     std::function<void(const uint8_t*, size_t)> on_central_module_pipe_;  // MODULE_PIPE (0x58) Central→HOST
     // Mission File archive (Central → HOST): PUSH_ACK / LIST / DL_DATA
     std::function<void(const uint8_t*, size_t)> on_central_mf_push_ack_;
+    std::function<void(const uint8_t*, size_t)> on_central_mf_push_state_;
     std::function<void(const uint8_t*, size_t)> on_central_mf_list_;
     std::function<void(const uint8_t*, size_t)> on_central_mf_dl_data_;
 
@@ -229,6 +278,9 @@ public:
     void set_on_central_mf_push_ack(std::function<void(const uint8_t*, size_t)> cb){
         on_central_mf_push_ack_ = std::move(cb);
     }
+    void set_on_central_mf_push_state(std::function<void(const uint8_t*, size_t)> cb){
+        on_central_mf_push_state_ = std::move(cb);
+    }
     void set_on_central_mf_list(std::function<void(const uint8_t*, size_t)> cb){
         on_central_mf_list_ = std::move(cb);
     }
@@ -1,14 +1,20 @@
 #pragma once
 #include "config.hpp"
+#include "async_writer.hpp"
+#include "quantile_sketch.hpp"
+#include "doppler_track.hpp"
 #include <fftw3.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <fcntl.h>
 
 // ── Oscillator ────────────────────────────────────────────────────────────
 struct Oscillator {
@@ -18,6 +24,11 @@ struct Oscillator {
         double w=-2.0*M_PI*freq_hz/sr;
         dre=(float)cos(w); dim=(float)sin(w); re=1; im=0; cnt=0;
     }
+    // 위상 유지한 채 주파수만 변경 (도플러 추적: 주기적 재설정에도 출력 위상 연속)
+    void retune(double freq_hz,double sr){
+        double w=-2.0*M_PI*freq_hz/sr;
+        dre=(float)cos(w); dim=(float)sin(w);
+    }
     inline void mix(float si,float sq,float& mi,float& mq){
         mi=si*re-sq*im; mq=si*im+sq*re;
         float nr=re*dre-im*dim, ni=re*dim+im*dre; re=nr; im=ni;
@@ -34,28 +45,95 @@ struct IIR1 {
 
 // ── Raw IQ writer (interleaved int16 I,Q — SigMF .sigmf-data) ──────────────
 // 헤더 없음. 중심주파수/시각/SR 등 메타는 별도 .sigmf-meta 파일이 담는다.
+// BUF_FRAMES 가 차면 AsyncIO 슬롯 1개(256 KB, 4K 정렬)로 비동기 제출 → O_DIRECT 가능,
+// 호출 스레드는 fflush/디스크 대기 없음. 디스크 반영 주기는 기존 fflush 와 같은 65536 샘플.
 struct WAVWriter {
-    FILE*    fp=nullptr;
+    AsyncIO::Writer aw;
     uint32_t sample_rate=0;
     uint64_t num_samples=0;
     std::vector<int16_t> buf;
     static constexpr size_t BUF_FRAMES=65536;
+    static constexpr int    SLOTS=8;
 
     bool open(const std::string& fn, uint32_t sr){
-        fp=fopen(fn.c_str(),"wb"); if(!fp) return false;
+        int fd=::open(fn.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644); if(fd<0) return false;
+        if(!aw.attach(fd,fn.c_str(),true,BUF_FRAMES*2*sizeof(int16_t),SLOTS)) return false;
         sample_rate=sr; num_samples=0; buf.reserve(BUF_FRAMES*2); return true;
     }
+    bool is_open() const { return aw.is_open(); }
     void push(int16_t i,int16_t q){
         buf.push_back(i); buf.push_back(q); ++num_samples;
         if(buf.size()>=BUF_FRAMES*2) flush();
     }
+    // 녹음 스레드: int16 interleaved 블록 (frames 쌍)
+    void write_block(const int16_t* iq, size_t frames){
+        buf.insert(buf.end(), iq, iq+frames*2); num_samples+=frames;
+        if(buf.size()>=BUF_FRAMES*2) flush();
+    }
     void flush(){
-        if(!fp||buf.empty()) return;
-        fwrite(buf.data(),2,buf.size(),fp);
+        if(!aw.is_open()||buf.empty()) return;
+        aw.append(buf.data(),buf.size()*sizeof(int16_t));
         buf.clear();
-        fflush(fp);
     }
-    void close(){ flush(); if(!fp) return; fclose(fp); fp=nullptr; }
+    void close(){ if(!aw.is_open()) return; flush(); aw.close(); }
+};
+
+// ── 녹음 블록 ring (DSP 스레드 → 녹음 스레드, SPSC float) ──────────────────
+// DSP 루프는 샘플을 배열에 넣기만 하고 BLOCK 단위로 wp 를 공개 → stdio/lock 없음.
+// int16 변환·파일 쓰기·헤더 마감은 FFTViewer::rec_io_worker 가 담당.
+// 가득 차면(녹음 스레드 지연) 버리고 drops 카운트.
+struct RecRing {
+    static constexpr size_t BLOCK = 1024;        // wp 공개 단위 (float)
+    std::vector<float>  buf;
+    size_t              mask = 0;
+    size_t              wp_local = 0;            // producer 전용
+    size_t              rp_cached = 0;           // producer 전용 (rp 스냅샷)
+    std::atomic<size_t> wp{0}, rp{0};
+    std::atomic<uint64_t> drops{0};
+
+    // n_floats 이상 2^k 로 할당 (녹음 시작 전, producer 정지 상태에서)
+    void alloc(size_t n_floats){
+        size_t sz = BLOCK * 4;
+        while(sz < n_floats) sz <<= 1;
+        if(buf.size() != sz) buf.assign(sz, 0.f);
+        mask = sz - 1;
+        wp_local = rp_cached = 0;
+        wp.store(0); rp.store(0); drops.store(0);
+    }
+    inline bool room(size_t n){
+        if(wp_local + n - rp_cached <= buf.size()) return true;
+        rp_cached = rp.load(std::memory_order_acquire);
+        if(wp_local + n - rp_cached <= buf.size()) return true;
+        drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    inline void publish_block(){
+        if((wp_local & (BLOCK - 1)) < 2) wp.store(wp_local, std::memory_order_release);
+    }
+    inline bool put(float v){
+        if(!room(1)) return false;
+        buf[wp_local & mask] = v; wp_local++;
+        publish_block();
+        return true;
+    }
+    inline bool put2(float a, float b){          // IQ 쌍 — 쌍 단위로만 버림
+        if(!room(2)) return false;
+        buf[wp_local & mask] = a; buf[(wp_local + 1) & mask] = b; wp_local += 2;
+        publish_block();
+        return true;
+    }
+    // producer 정지 후 (stop 경로) 남은 부분 블록 공개
+    void publish(){ wp.store(wp_local, std::memory_order_release); }
+
+    // consumer: 연속 구간 포인터 (wrap 전까지), consume(n) 으로 반환
+    size_t peek(const float*& p) const {
+        size_t r = rp.load(std::memory_order_relaxed);
+        size_t w = wp.load(std::memory_order_acquire);
+        size_t n = std::min(w - r, buf.size() - (r & mask));
+        p = buf.data() + (r & mask);
+        return n;
+    }
+    void consume(size_t n){ rp.store(rp.load(std::memory_order_relaxed) + n, std::memory_order_release); }
 };
 
 // ── Per-channel state ─────────────────────────────────────────────────────
@@ -117,7 +195,11 @@ struct Channel {
 
     // ── Audio recording (demod 스레드 내에서만 접근) ──────────────────────
     std::atomic<bool> audio_rec_on{false};
-    FILE*             audio_rec_fp      = nullptr;
+    // 녹음 파일 I/O 상태 (start: UI→OPEN, stop: CLOSE 요청 → 녹음 스레드가 마감 후 IDLE)
+    enum RecIo : int { REC_IO_IDLE=0, REC_IO_OPEN=1, REC_IO_CLOSE=2 };
+    std::atomic<int>  audio_rec_io{REC_IO_IDLE};
+    RecRing           audio_rec_ring;
+    AsyncIO::Writer   audio_rec_aw;       // 녹음 스레드 전용 (open 은 start 에서)
     uint64_t          audio_rec_frames  = 0;
     uint32_t          audio_rec_sr      = 0;
     std::string       audio_rec_path;
@@ -127,21 +209,22 @@ struct Channel {
     int      sqr_state       = SQR_IDLE;
     uint32_t sqr_tail_remain = 0;
 
-    // mono int16 WAV 헤더 기록 (open / close 시 호출)
-    void audio_rec_write_wav_hdr(FILE* fp, uint32_t sr, uint64_t frames){
-        auto w32=[&](uint32_t v){ fwrite(&v,4,1,fp); };
-        auto w16=[&](uint16_t v){ fwrite(&v,2,1,fp); };
-        uint32_t db=(uint32_t)(frames*2);
-        fwrite("RIFF",1,4,fp); w32(36+db); fwrite("WAVE",1,4,fp);
-        fwrite("fmt ",1,4,fp); w32(16); w16(1); w16(1); // PCM, mono
-        w32(sr); w32(sr*2); w16(2); w16(16);
-        fwrite("data",1,4,fp); w32(db);
+    // mono int16 WAV 헤더 44 B 를 h 에 작성 (녹음 스레드 마감용)
+    static void wav_hdr_mono(uint8_t* h, uint32_t sr, uint64_t frames){
+        uint32_t db=(uint32_t)(frames*2), v;
+        memcpy(h,"RIFF",4); v=36+db; memcpy(h+4,&v,4); memcpy(h+8,"WAVE",4);
+        memcpy(h+12,"fmt ",4); v=16; memcpy(h+16,&v,4);
+        uint16_t fmt=1, nch=1, ba=2, bits=16;
+        memcpy(h+20,&fmt,2); memcpy(h+22,&nch,2);
+        memcpy(h+24,&sr,4); v=sr*2; memcpy(h+28,&v,4);
+        memcpy(h+32,&ba,2); memcpy(h+34,&bits,2);
+        memcpy(h+36,"data",4); memcpy(h+40,&db,4);
     }
 
     // demod worker에서 호출: 스컬치 기반 녹음 상태머신
     inline void maybe_rec_audio(float out, bool gate_open){
         if(!audio_rec_on.load(std::memory_order_relaxed)) return;
-        if(!audio_rec_fp) return;
+        if(audio_rec_io.load(std::memory_order_relaxed)!=REC_IO_OPEN) return;
         if(dem_paused.load(std::memory_order_relaxed)) return; // Holding 중 쓰기 정지
 
         uint32_t tail_samples = audio_rec_sr; // 1초
@@ -169,15 +252,17 @@ struct Channel {
             break;
         }
 
-        int16_t s16=(int16_t)(out<-1.f?-32767:out>1.f?32767:(int)(out*32767.f));
-        fwrite(&s16,2,1,audio_rec_fp);
-        audio_rec_frames++;
+        // int16 변환(포화)은 녹음 스레드에서 블록 단위로
+        if(audio_rec_ring.put(out)) audio_rec_frames++;
     }
 
     // ── Per-channel IQ recording (demod 스레드 내에서만 접근) ────────────
     std::atomic<bool> iq_rec_on{false};
     std::atomic<bool> iq_rec_force_all{false}; // true면 squelch와 무관하게 전 구간 녹음 (예약 녹음용)
-    FILE*             iq_rec_fp      = nullptr;
+    std::shared_ptr<const DopplerTrack> iq_dop; // 예약 위성 녹음: iq_only_worker 가 시작 시 복사 (arm→start 순서)
+    std::atomic<int>  iq_rec_io{REC_IO_IDLE};
+    RecRing           iq_rec_ring;
+    WAVWriter         iq_rec_wav;         // 녹음 스레드 전용 (open 은 start 에서)
     uint64_t          iq_rec_frames  = 0;
     uint32_t          iq_rec_sr      = 0;
     std::string       iq_rec_path;
@@ -195,7 +280,7 @@ struct Channel {
     // 메타(cf/시각/SR)는 .sigmf-meta 파일이 담는다 (start_iq_rec에서 생성).
     inline void maybe_rec_iq(float fi, float fq, bool gate_open){
         if(!iq_rec_on.load(std::memory_order_relaxed)) return;
-        if(!iq_rec_fp) return;
+        if(iq_rec_io.load(std::memory_order_relaxed)!=REC_IO_OPEN) return;
         if(dem_paused.load(std::memory_order_relaxed)) return; // Holding 중 쓰기 정지
         // 예약 녹음(force_all): squelch 무시하고 전 구간 실신호 녹음
         bool force = iq_rec_force_all.load(std::memory_order_relaxed);
@@ -229,14 +314,9 @@ struct Channel {
                 break;
             }
         }
-        auto c16=[](float v)->int16_t{ return (int16_t)(v<-1.f?-32767:v>1.f?32767:(int)(v*32767.f)); };
-        int16_t si = write_silence ? 0 : c16(fi);
-        int16_t sq = write_silence ? 0 : c16(fq);
-        fwrite(&si,2,1,iq_rec_fp);
-        fwrite(&sq,2,1,iq_rec_fp);
-        iq_rec_frames++;
-        // 매 65536 샘플마다 flush (녹음 중 실시간 분석 가능 — raw라 헤더 갱신 불필요)
-        if((iq_rec_frames & 0xFFFF) == 0) fflush(iq_rec_fp);
+        // interleave 만 — int16 변환/파일 쓰기는 녹음 스레드
+        if(write_silence){ fi = 0.f; fq = 0.f; }
+        if(iq_rec_ring.put2(fi,fq)) iq_rec_frames++;
     }
 
     // Squelch (UI 스레드에서 FFT 기반으로 중앙 관리)
@@ -248,8 +328,8 @@ struct Channel {
     float sq_cached_peak = -120.0f;
     float sq_scan_s = 0, sq_scan_e = 0;  // 캐시가 유효한 대역 (s/e 변하면 무효)
     // 캘리브레이션 (UI 스레드 전용)
-    int   sq_calib_cnt = 0;
-    float sq_calib_buf[60] = {};  // ~1초 (GUI 60fps) / ~1.2초 (CLI 50Hz)
+    static constexpr int SQ_CALIB_FRAMES = 60;  // ~1초 (GUI 60fps) / ~1.2초 (CLI 50Hz)
+    QuantileSketch sq_calib;        // 채널 peak 분포 (20th percentile → noise floor)
     int   sq_gate_hold = 0;      // gate hold 카운터 (프레임 단위)
     float sq_last_close_t = -10.f; // 게이트 마지막 닫힌 시점 (ImGui::GetTime)
     bool  sq_gate_prev = false;  // 이전 프레임 게이트 상태
@@ -289,6 +369,7 @@ struct Channel {
         iq_sqr_state=SQR_IDLE;
         iq_sqr_tail_remain=0;
         iq_rec_force_all.store(false);
+        iq_dop.reset();
         // squelch
         sq_threshold.store(-50.0f);
         sq_sig.store(-120.0f);
@@ -296,8 +377,7 @@ struct Channel {
         sq_gate.store(false);
         sq_calibrated.store(false);
         sq_cached_peak=-120.0f; sq_scan_s=0; sq_scan_e=0;
-        sq_calib_cnt=0;
-        memset(sq_calib_buf, 0, sizeof(sq_calib_buf));
+        sq_calib.clear();
         sq_gate_hold=0;
         sq_active_time=0; sq_total_time=0;
         // drag state
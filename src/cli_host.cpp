@@ -49,103 +49,7 @@ void bewe_log(const char* fmt, ...){
 // ── bladerf_usb_reset 선언 (hw_detect.cpp) ───────────────────────────────
 bool bladerf_usb_reset();
 
-// ── 채널 스컬치 (ui.cpp에서 추출 - GUI 의존성 없음) ──────────────────────
-void FFTViewer::update_channel_squelch(){
-    if(total_ffts < 1 || fft_size < 1) return;
-    // 호출 간격 기반 실 delta 시간 (시간 카운터용)
-    static auto sq_last_tick = std::chrono::steady_clock::now();
-    auto sq_now = std::chrono::steady_clock::now();
-    float real_dt = std::chrono::duration<float>(sq_now - sq_last_tick).count();
-    if(real_dt > 0.5f) real_dt = 0.02f; // 첫 호출/정지 이후 복귀 보정
-    sq_last_tick = sq_now;
-
-    std::lock_guard<std::mutex> lk(data_mtx);
-    float cf_mhz = (float)(header.center_frequency / 1e6);
-    float nyq_mhz = header.sample_rate / 2e6f;
-    if(nyq_mhz < 0.001f) return;
-    int hf = fft_size / 2;
-    int fi = (total_ffts > 0 ? total_ffts - 1 : 0) % MAX_FFTS_MEMORY;
-    const float* rowp = fft_data.data() + fi * fft_size;
-    // 같은 FFT 행이면 채널별 peak 재스캔 생략 (행 갱신은 ~1.5-37Hz, 호출은 ~50Hz)
-    bool same_row = (total_ffts == sq_last_total_ffts);
-    sq_last_total_ffts = total_ffts;
-    auto freq_to_bin = [&](float rel_mhz) -> int {
-        int bin = (rel_mhz >= 0)
-            ? (int)((rel_mhz / nyq_mhz) * hf)
-            : fft_size + (int)((rel_mhz / nyq_mhz) * hf);
-        return std::max(0, std::min(fft_size - 1, bin));
-    };
-    for(int c = 0; c < MAX_CHANNELS; c++){
-        Channel& ch = channels[c];
-        if(!ch.filter_active) continue;
-        float s_mhz = std::min(ch.s, ch.e) - cf_mhz;
-        float e_mhz = std::max(ch.s, ch.e) - cf_mhz;
-        int bin_s = freq_to_bin(s_mhz);
-        int bin_e = freq_to_bin(e_mhz);
-        // 행·대역 둘 다 그대로면 캐시 재사용 (계산결과 동일 → 게이트/시간 동작 불변)
-        float peak_db;
-        if(same_row && ch.sq_calibrated.load(std::memory_order_relaxed)
-           && ch.sq_scan_s == ch.s && ch.sq_scan_e == ch.e){
-            peak_db = ch.sq_cached_peak;
-        } else {
-            peak_db = -120.0f;
-            if(bin_s <= bin_e){
-                for(int b = bin_s; b <= bin_e; b++)
-                    if(rowp[b] > peak_db) peak_db = rowp[b];
-            } else {
-                for(int b = bin_s; b < fft_size; b++)
-                    if(rowp[b] > peak_db) peak_db = rowp[b];
-                for(int b = 0; b <= bin_e; b++)
-                    if(rowp[b] > peak_db) peak_db = rowp[b];
-            }
-            ch.sq_cached_peak = peak_db;
-            ch.sq_scan_s = ch.s; ch.sq_scan_e = ch.e;
-        }
-        float prev = ch.sq_sig.load(std::memory_order_relaxed);
-        float sig = 0.3f * peak_db + 0.7f * prev;
-        ch.sq_sig.store(sig, std::memory_order_relaxed);
-        if(!ch.sq_calibrated.load(std::memory_order_relaxed)){
-            if(ch.sq_calib_cnt < 60)
-                ch.sq_calib_buf[ch.sq_calib_cnt++] = peak_db;
-            if(ch.sq_calib_cnt >= 60){
-                float tmp[60];
-                memcpy(tmp, ch.sq_calib_buf, sizeof(tmp));
-                std::nth_element(tmp, tmp + 12, tmp + 60); // 20th percentile
-                ch.sq_threshold.store(tmp[12] + 10.0f, std::memory_order_relaxed);
-                ch.sq_calibrated.store(true, std::memory_order_relaxed);
-                ch.sq_calib_cnt = 0;
-            }
-        }
-        float thr = ch.sq_threshold.load(std::memory_order_relaxed);
-        bool gate = ch.sq_gate.load(std::memory_order_relaxed);
-        const float HYS = 3.0f;
-        const int HOLD_FRAMES = 18;
-        if(ch.sq_calibrated.load(std::memory_order_relaxed)){
-            if(!gate && sig >= thr){
-                gate = true;
-                ch.sq_gate_hold = HOLD_FRAMES;
-            }
-            if(gate){
-                if(sig >= thr - HYS)
-                    ch.sq_gate_hold = HOLD_FRAMES;
-                else if(--ch.sq_gate_hold <= 0)
-                    gate = false;
-            }
-        }
-        ch.sq_gate.store(gate, std::memory_order_relaxed);
-
-        // 스컬치 누적 시간 — 실벽시계 delta 사용 (Holding 중에는 정지)
-        if(ch.filter_active && !ch.dem_paused.load()){
-            if(!sdr_stream_error.load()){
-                ch.sq_total_time += real_dt;
-                if(gate) ch.sq_active_time += real_dt;
-            }
-        } else if(!ch.filter_active){
-            ch.sq_active_time = 0;
-            ch.sq_total_time = 0;
-        }
-    }
-}
+// 채널 스컬치 (update_channel_squelch) → squelch.cpp (GUI 공용)
 
 // ── Signal handler ───────────────────────────────────────────────────────
 static std::atomic<bool> g_shutdown{false};
@@ -516,7 +420,7 @@ void run_cli_host(){
     };
     srv->cb.on_set_autoscale = [&](){
         v.autoscale_active=true; v.autoscale_init=false;
-        v.autoscale_accum.clear();
+        v.autoscale_hist.clear();
     };
     srv->cb.on_toggle_tm_iq = [&](){
         bool cur=v.tm_iq_on.load();
@@ -640,19 +544,13 @@ void run_cli_host(){
         std::thread([&v,srv,fl,fh,time_start_ms,time_end_ms,samp_start,samp_end,oidx,fname,sid,&central_cli,req_id_val](){
           try {
             uint32_t req_id = req_id_val;
-            for(int w=0;w<200&&v.rec_busy_flag.load();w++)
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            v.region.fft_top=0; v.region.fft_bot=0; // 사용 안 함 (samp/time 기반)
-            v.region.freq_lo=fl; v.region.freq_hi=fh;
-            v.region.time_start_ms=time_start_ms;
-            v.region.time_end_ms=time_end_ms;
-            v.region.samp_start=samp_start;
-            v.region.samp_end=samp_end;
-            v.region.active=true;
-            v.rec_busy_flag.store(true);
-            v.rec_state = FFTViewer::REC_BUSY;
-            v.rec_anim_timer = 0.0f;
-            v.region.active = false;
+            FFTViewer::RegionSel rq{};
+            rq.fft_top=0; rq.fft_bot=0; // 사용 안 함 (samp/time 기반)
+            rq.freq_lo=fl; rq.freq_hi=fh;
+            rq.time_start_ms=time_start_ms;
+            rq.time_end_ms=time_end_ms;
+            rq.samp_start=samp_start;
+            rq.samp_end=samp_end;
             if(srv){
                 PktIqProgress prog{};
                 prog.req_id = req_id;
@@ -663,10 +561,8 @@ void run_cli_host(){
             bewe_log_push(0,"[CLI] region_save: tm_on=%d tm_write=%lld t_ms=%lld~%lld\n",
                 (int)v.tm_iq_on.load(), (long long)v.tm_iq_write_sample,
                 (long long)time_start_ms, (long long)time_end_ms);
-            std::string path = v.do_region_save_work();
-            v.rec_state = FFTViewer::REC_SUCCESS;
-            v.rec_success_timer = 3.0f;
-            v.rec_busy_flag.store(false);
+            // 동시에 들어온 요청과 묶어 롤링 파일 1 pass 로 추출 (rec_state/busy 는 큐 워커가 관리)
+            std::string path = v.region_save_enqueue(rq).get();
             bewe_log_push(0,"[CLI] region_save done: path='%s'\n", path.c_str());
             if(path.empty()){
                 if(srv) srv->send_region_response((int)oidx, false);
@@ -1037,6 +933,7 @@ void run_cli_host(){
         v.net_srv = srv;
         srv->set_host_info(login_get_id(), (uint8_t)login_get_tier());
         bewe_log_push(0,"[BEWE CLI] Server started on port %d\n", host_port);
+        v.metrics_install();   // /metrics (localhost)
 
         // Central MUX adapter
         if(central_host[0] != '\0'){
@@ -1142,16 +1039,14 @@ void run_cli_host(){
                     auto* ss = reinterpret_cast<const PktSchedSync*>(pkt + 9);
                     int n = std::min<int>(ss->count, MAX_SCHED_ENTRIES);
                     std::lock_guard<std::mutex> lk(v.sched_mtx);
-                    // 현재 활성(ARM/REC) 엔트리가 있으면 그 식별자를 기억
-                    int64_t active_st   = -1;
-                    float   active_freq = 0.f;
-                    if(v.sched_active_idx >= 0 && v.sched_active_idx < (int)v.sched_entries.size()){
-                        active_st   = (int64_t)v.sched_entries[v.sched_active_idx].start_time;
-                        active_freq = v.sched_entries[v.sched_active_idx].freq_mhz;
-                    }
+                    // 같은 (start, freq) 로컬 엔트리는 uid / 도플러 트랙 유지,
+                    // 활성(ARM/REC) 엔트리는 로컬 상태/타임스탬프/채널까지 유지.
+                    auto same = [](const FFTViewer::SchedEntry& a, int64_t st, float f){
+                        return (int64_t)a.start_time == st && fabsf(a.freq_mhz - f) < 1e-4f;
+                    };
                     std::vector<FFTViewer::SchedEntry> next;
                     next.reserve(n);
-                    int new_active = -1;
+                    std::vector<bool> kept(v.sched_entries.size(), false);
                     for(int i=0; i<n; i++){
                         const auto& se = ss->entries[i];
                         if(!se.valid) continue;
@@ -1163,19 +1058,32 @@ void run_cli_host(){
                         ne.op_index     = se.op_index;
                         strncpy(ne.operator_name, se.operator_name, sizeof(ne.operator_name)-1);
                         strncpy(ne.target,        se.target,        sizeof(ne.target)-1);
-                        // 활성 엔트리는 로컬 상태/타임스탬프/채널 유지
-                        if(active_st == se.start_time && fabsf(active_freq - se.freq_mhz) < 1e-4f){
-                            ne.status      = v.sched_entries[v.sched_active_idx].status;
-                            ne.temp_ch_idx = v.sched_entries[v.sched_active_idx].temp_ch_idx;
-                            ne.rec_started = v.sched_entries[v.sched_active_idx].rec_started;
-                            new_active     = (int)next.size();
-                        } else {
-                            ne.status = (FFTViewer::SchedEntry::Status)se.status;
+                        ne.status = (FFTViewer::SchedEntry::Status)se.status;
+                        for(size_t k=0; k<v.sched_entries.size(); k++){
+                            const auto& old = v.sched_entries[k];
+                            if(kept[k] || !same(old, se.start_time, se.freq_mhz)) continue;
+                            kept[k] = true;
+                            ne.uid = old.uid;
+                            ne.dop = old.dop;
+                            if(old.status == FFTViewer::SchedEntry::ARMED ||
+                               old.status == FFTViewer::SchedEntry::RECORDING){
+                                ne.status      = old.status;
+                                ne.temp_ch_idx = old.temp_ch_idx;
+                                ne.rec_started = old.rec_started;
+                            }
+                            break;
                         }
                         next.push_back(ne);
                     }
+                    // Central 목록에 없는 활성 엔트리도 끝까지 녹음
+                    for(size_t k=0; k<v.sched_entries.size(); k++){
+                        const auto& old = v.sched_entries[k];
+                        if(!kept[k] && (old.status == FFTViewer::SchedEntry::ARMED ||
+                                        old.status == FFTViewer::SchedEntry::RECORDING))
+                            next.push_back(old);
+                    }
                     v.sched_entries = std::move(next);
-                    v.sched_active_idx = new_active;
+                    v.sched_heap_sig = 0;           // 다음 tick 에서 힙 재구성
                     bewe_log_push(0, "[Central] restored %d scheduled entries\n", (int)v.sched_entries.size());
                 });
 
@@ -1343,9 +1251,9 @@ void run_cli_host(){
                 lcb.on_start = [&v](const PktLwfLiveStart& s){
                     if(v.net_srv) v.net_srv->broadcast_lwf_live_start(s);
                 };
-                lcb.on_row   = [&v](const PktLwfLiveRowHdr& hdr,
-                                    const uint8_t* row, uint32_t row_bytes){
-                    if(v.net_srv) v.net_srv->broadcast_lwf_live_row(hdr, row, row_bytes);
+                lcb.on_block = [&v](const PktLwfLiveBlockHdr& hdr,
+                                    const uint8_t* blk, uint32_t blk_bytes){
+                    if(v.net_srv) v.net_srv->broadcast_lwf_live_block(hdr, blk, blk_bytes);
                 };
                 lcb.on_stop  = [&v](const PktLwfLiveStop& s){
                     if(v.net_srv) v.net_srv->broadcast_lwf_live_stop(s);
@@ -1692,6 +1600,16 @@ void run_cli_host(){
             }
         }
 
+        // ── STATS (5s): 파이프라인 메트릭 요약 broadcast (상세는 /metrics) ──
+        if(v.net_srv){
+            static auto stats_last = clk::now();
+            if(std::chrono::duration<float>(clk::now()-stats_last).count() >= 5.0f){
+                stats_last = clk::now();
+                PktStats st; v.stats_fill(st);
+                v.net_srv->broadcast_stats(st);
+            }
+        }
+
         // ── SDR 런타임 교체 ──────────────────────────────────────────────
         if(v.pending_sdr_switch.load()){
             v.pending_sdr_switch.store(false);
@@ -1867,7 +1785,7 @@ void run_cli_host(){
             pending_autoscale_at = clk::time_point{};
             v.autoscale_active = true;
             v.autoscale_init   = false;
-            v.autoscale_accum.clear();
+            v.autoscale_hist.clear();
             bewe_log_push(0, "[autoscale] post-reconnect trigger (2s settling done)\n");
         }
 
@@ -1994,6 +1912,12 @@ void run_cli_host(){
                        v.tm_iq_on.load()?"ON":"OFF");
                 bewe_log_push(0,"  CPU=%.0f%%  RAM=%.0f%%  IO=%.0f%%  GHz=%.2f\n",
                        v.sysmon_cpu, v.sysmon_ram, v.sysmon_io, v.sysmon_ghz);
+                {
+                    char aio[128];
+                    AsyncIO::format(aio, sizeof(aio), AsyncIO::totals());
+                    bewe_log_push(0,"  DISK(%s): %s\n",
+                           AsyncIO::Engine::get().uring()?"io_uring":"pool", aio);
+                }
                 if(v.net_srv){
                     auto ns = v.net_srv->collect_stats();
                     auto fb = [](uint64_t b) -> std::string {
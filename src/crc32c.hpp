@@ -0,0 +1,79 @@
+#pragma once
+// CRC32C (Castagnoli, reflected poly 0x82F63B78) — mission push 청크/파일 무결성.
+//
+//   uint32_t c = Crc32c::extend(0, p, n);      // 한 블록
+//   c = Crc32c::extend(c, p2, n2);             // 이어 붙이면 p‖p2 전체의 CRC
+//
+// x86-64 는 SSE4.2 crc32 명령을 런타임 감지해서 사용 (빌드 플래그 무관 —
+// Central 은 -march 없이 빌드됨). 그 외는 slicing-by-8 테이블.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Crc32c {
+
+namespace detail {
+
+struct Tables {
+    uint32_t t[8][256];
+    Tables(){
+        for(uint32_t i = 0; i < 256; i++){
+            uint32_t c = i;
+            for(int k = 0; k < 8; k++) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1u)));
+            t[0][i] = c;
+        }
+        for(int k = 1; k < 8; k++)
+            for(uint32_t i = 0; i < 256; i++)
+                t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xFF];
+    }
+};
+
+inline const Tables& tables(){ static const Tables T; return T; }
+
+// c: 반전된 상태 (~crc)
+inline uint32_t sw(uint32_t c, const uint8_t* p, size_t n){
+    const auto& T = tables().t;
+    while(n >= 8){
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4); memcpy(&hi, p + 4, 4);   // little-endian 가정
+        lo ^= c;
+        c = T[7][lo & 0xFF] ^ T[6][(lo >> 8) & 0xFF] ^ T[5][(lo >> 16) & 0xFF] ^ T[4][lo >> 24]
+          ^ T[3][hi & 0xFF] ^ T[2][(hi >> 8) & 0xFF] ^ T[1][(hi >> 16) & 0xFF] ^ T[0][hi >> 24];
+        p += 8; n -= 8;
+    }
+    while(n--) c = T[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    return c;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+inline uint32_t hw(uint32_t c, const uint8_t* p, size_t n){
+    while(n && ((uintptr_t)p & 7)){ c = __builtin_ia32_crc32qi(c, *p++); n--; }
+    uint64_t c64 = c;
+    while(n >= 8){
+        uint64_t v; memcpy(&v, p, 8);
+        c64 = __builtin_ia32_crc32di(c64, v);
+        p += 8; n -= 8;
+    }
+    c = (uint32_t)c64;
+    while(n--) c = __builtin_ia32_crc32qi(c, *p++);
+    return c;
+}
+
+inline bool have_hw(){
+    static const bool h = __builtin_cpu_supports("sse4.2");
+    return h;
+}
+#endif
+
+} // namespace detail
+
+inline uint32_t extend(uint32_t crc, const void* data, size_t n){
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+#if defined(__x86_64__)
+    if(detail::have_hw()) return ~detail::hw(~crc, p, n);
+#endif
+    return ~detail::sw(~crc, p, n);
+}
+
+} // namespace Crc32c
@@ -1,6 +1,9 @@
 #include "fft_viewer.hpp"
 #include "module_api.hpp"
 #include "net_server.hpp"
+#include "pipe_stats.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -9,6 +12,7 @@
 void FFTViewer::dem_worker(int ch_idx){
     Channel& ch=channels[ch_idx];
     Channel::DemodMode mode=ch.mode;
+    PipeStats::ReaderScope rs_(ch.dem_rp, "dem", ch_idx);   // lag 계측 + 스레드 이름
     // 네트워크 오디오 배치 버퍼 (256샘플 단위로 서버에 전송)
     static constexpr int NET_AUDIO_BATCH = 256;
     std::vector<float> net_audio_buf;
@@ -82,6 +86,9 @@ void FFTViewer::dem_worker(int ch_idx){
         // Lag limiter: reset if too far behind
         if(lag>MAX_LAG){
             size_t keep=(size_t)(msr*0.02);
+            static auto& m_skip=Metrics::counter("bewe_demod_skipped_samples_total","Ring samples skipped by demod lag limiter");
+            m_skip.inc(lag-keep);
+            BEWE_TRACE_INSTANT("dem", "skip", lag-keep);
             rp=(wp-keep)&IQ_RING_MASK;
             ch.dem_rp.store(rp,std::memory_order_release);
             for(int k=0;k<4;k++){ lpi[k].s=lpq[k].s=0; }
@@ -111,6 +118,7 @@ void FFTViewer::dem_worker(int ch_idx){
         }
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("dem", "batch", avail);
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
             float si=ring[pos*2]*inv_scale, sq=ring[pos*2+1]*inv_scale;
@@ -0,0 +1,24 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ── Doppler track ─────────────────────────────────────────────────────────
+// 예약 위성 녹음용: unix 시각 t0 부터 step 초 간격 도플러 편이(Hz) — 선형 보간,
+// 범위 밖은 양 끝값 유지.
+struct DopplerTrack {
+    double t0=0, step=1;
+    std::vector<float> hz;
+    float at(double t) const {
+        if(hz.empty()) return 0.f;
+        double x=(t-t0)/step;
+        if(x<=0) return hz.front();
+        size_t k=(size_t)x;
+        if(k+1>=hz.size()) return hz.back();
+        float f=(float)(x-(double)k);
+        return hz[k]+(hz[k+1]-hz[k])*f;
+    }
+    float max_abs() const {
+        float m=0; for(float v:hz) m=std::max(m,fabsf(v)); return m;
+    }
+};
@@ -1,5 +1,6 @@
 #include "fft_viewer.hpp"
 #include "sigmf.hpp"
+#include "quantile_sketch.hpp"
 #include <cstdio>
 #include <cmath>
 #include <cstring>
@@ -7,7 +8,74 @@
 #include <vector>
 #include <sys/stat.h>
 
-// ── EID envelope 추출 (비동기 스레드) ────────────────────────────────────────
+// ── 자동 스케일 통계 (샘플 블록 추출) ────────────────────────────────────────
+// 전체 샘플을 훑지 않고 균등 간격 STAT_BLOCKS × STAT_BLOCK_LEN 구간만 읽는다
+// (mmap 페이지도 그 구간만 올라옴). envelope 분위수는 QuantileSketch 로.
+namespace {
+constexpr int64_t STAT_BLOCKS    = 256;
+constexpr int64_t STAT_BLOCK_LEN = 16384;
+
+struct EidStats {
+    float amp_lo = 0.f, amp_hi = 1.f, noise = 0.f;
+    float freq_lo = 0.f, freq_hi = 0.f;
+};
+
+EidStats eid_scan_stats(const EidStore::Samples& iq, bool is_iq, uint32_t sr){
+    EidStats st;
+    int64_t n = iq.size();
+    if(n < 1) return st;
+    QuantileSketch sk(0.f, 2.f, 1e-4f);
+    float env_max = 0.f;
+    float f_lo = 0.f, f_hi = 0.f; bool f_init = false;
+    const float TWO_PI = 6.283185307f;
+    const float HZ_SCL = (float)sr / TWO_PI;
+    int64_t blocks = std::min(STAT_BLOCKS, (n + STAT_BLOCK_LEN - 1) / STAT_BLOCK_LEN);
+    std::vector<float> bi(STAT_BLOCK_LEN), bq(STAT_BLOCK_LEN);
+    for(int64_t b = 0; b < blocks; b++){
+        int64_t s0 = (blocks > 1) ? b * (n - STAT_BLOCK_LEN) / (blocks - 1) : 0;
+        if(s0 < 0) s0 = 0;
+        int64_t len = std::min(STAT_BLOCK_LEN, n - s0);
+        iq.read(s0, len, bi.data(), bq.data());
+        float prev_ph = atan2f(bq[0], bi[0]);
+        for(int64_t k = 0; k < len; k++){
+            float e = sqrtf(bi[k]*bi[k] + bq[k]*bq[k]);
+            sk.add(e);
+            if(e > env_max) env_max = e;
+            if(!is_iq || k == 0) continue;
+            float ph = atan2f(bq[k], bi[k]);
+            float dp = ph - prev_ph;
+            if(dp >  3.14159265f) dp -= TWO_PI;
+            if(dp < -3.14159265f) dp += TWO_PI;
+            prev_ph = ph;
+            if((k & 63) != 0) continue;          // inst_freq Y범위는 성긴 샘플로 충분
+            float f = dp * HZ_SCL;
+            if(!f_init){ f_lo = f_hi = f; f_init = true; }
+            if(f < f_lo) f_lo = f;
+            if(f > f_hi) f_hi = f;
+        }
+    }
+    // 1st percentile ~ 실제 최대값 (클리핑 방지)
+    float amp_lo = sk.quantile(0.01);
+    float amp_hi = env_max;
+    if(amp_hi - amp_lo < 0.001f) amp_hi = amp_lo + 0.001f;
+    float margin_lo = (amp_hi - amp_lo) * 0.05f;
+    float margin_hi = amp_hi * 0.20f;
+    amp_lo -= margin_lo;
+    amp_hi += margin_hi;
+    if(amp_lo < 0.f) amp_lo = 0.f;
+    st.amp_lo = amp_lo;
+    st.amp_hi = amp_hi;
+    // 노이즈 레벨: 5th percentile
+    st.noise = sk.quantile(0.05);
+    float fm = (f_hi - f_lo) * 0.05f;
+    st.freq_lo = f_lo - fm;
+    st.freq_hi = f_hi + fm;
+    return st;
+}
+} // namespace
+
+// ── EID 로드 (비동기 스레드) ─────────────────────────────────────────────────
+// 샘플은 mmap 으로 매핑만 하고 읽지 않는다 — envelope/phase/freq 는 표시 시 계산.
 void FFTViewer::eid_start(const std::string& wav_path){
     if(eid_thread.joinable()) eid_thread.join();
     eid_computing.store(true);
@@ -18,126 +86,50 @@ void FFTViewer::eid_start(const std::string& wav_path){
         // ── IQ/audio 소스 열기 (SigMF .sigmf-data 또는 legacy .wav + bewe) ──
         SigMF::Source src;
         if(!SigMF::open_source(wav_path, src)){ eid_computing.store(false); return; }
-        FILE* f = src.f;   // open_source가 데이터 시작 위치로 seek 완료
+        FILE* f = src.f;
         uint32_t meta_sr    = src.sample_rate;
-        uint32_t wav_sr     = src.sample_rate;   // alias (derived 계산 fallback)
         uint64_t meta_cf_hz = src.center_freq_hz;
         int64_t  meta_time  = src.start_unix;
         long     data_size  = src.data_size;
 
+        // mono: 오디오로 취급 (I=sample, Q=0, env=|sample|, phase/freq는 0)
+        // stereo: IQ로 취급
         const int nch = src.nch;  // 1=mono(audio), 2=stereo(IQ)
-        int64_t n_samples = data_size / (int64_t)(nch * (int)sizeof(int16_t));
-        if(n_samples < 1){ fclose(f); eid_computing.store(false); return; }
-
-        // ── WAV 로드 + envelope/I/Q/phase/freq 추출 ─────────────────────────
-        // mono: 오디오로 취급 (I=sample, Q=0, env=|sample|, phase/freq는 의미 없음)
-        // stereo: IQ로 취급 (기존 로직)
-        const int64_t BLOCK = 65536;
-        std::vector<float> env(n_samples), ch_i(n_samples), ch_q(n_samples);
-        std::vector<float> phase(n_samples), inst_freq(n_samples);
-        std::vector<int16_t> raw(BLOCK * nch);
-        int64_t done = 0;
-        const float SCL = 1.0f / 32768.0f;
-        float prev_phase = 0.f;
-        const float TWO_PI = 6.283185307f;
-        // inst_freq를 Hz 단위로 변환하는 스케일 (sr / 2π * dp) — 저장 시 바로 적용
-        uint32_t sr_val = meta_sr > 0 ? meta_sr : wav_sr;
-        const float HZ_SCL = (float)sr_val / TWO_PI;
-
-        while(done < n_samples){
-            int64_t todo = std::min(BLOCK, n_samples - done);
-            int64_t got = (int64_t)fread(raw.data(), sizeof(int16_t), (size_t)(todo * nch), f) / nch;
-            if(got <= 0) break;
-            for(int64_t i = 0; i < got; i++){
-                int64_t idx = done + i;
-                if(nch == 2){
-                    float fi = raw[i * 2    ] * SCL;
-                    float fq = raw[i * 2 + 1] * SCL;
-                    env[idx]  = sqrtf(fi * fi + fq * fq);
-                    ch_i[idx] = fi;
-                    ch_q[idx] = fq;
-                    float ph  = atan2f(fq, fi);
-                    phase[idx] = ph;
-                    float dp = ph - prev_phase;
-                    if(dp >  3.14159265f) dp -= TWO_PI;
-                    if(dp < -3.14159265f) dp += TWO_PI;
-                    inst_freq[idx] = (idx == 0) ? 0.f : dp * HZ_SCL;
-                    prev_phase = ph;
-                } else {
-                    float s = raw[i] * SCL;
-                    env[idx]       = fabsf(s);
-                    ch_i[idx]      = s;
-                    ch_q[idx]      = 0.f;
-                    phase[idx]     = 0.f;
-                    inst_freq[idx] = 0.f;
-                }
-            }
-            done += got;
-        }
-        fclose(f);
-        if(done < 1){ eid_computing.store(false); return; }
-        env.resize(done); ch_i.resize(done); ch_q.resize(done);
-        phase.resize(done); inst_freq.resize(done);
-
-        // ── 자동 스케일: 1st~99th percentile ────────────────────────────────
-        std::vector<float> sorted_env(env);
-        std::nth_element(sorted_env.begin(),
-                         sorted_env.begin() + (size_t)(sorted_env.size() * 0.01f),
-                         sorted_env.end());
-        float amp_lo = sorted_env[(size_t)(sorted_env.size() * 0.01f)];
-        float amp_hi = *std::max_element(env.begin(), env.end());  // 실제 최대값 (클리핑 방지)
-        if(amp_hi - amp_lo < 0.001f) amp_hi = amp_lo + 0.001f;
-        float margin_lo = (amp_hi - amp_lo) * 0.05f;
-        float margin_hi = amp_hi * 0.20f;
-        amp_lo -= margin_lo;
-        amp_hi += margin_hi;
-        if(amp_lo < 0.f) amp_lo = 0.f;
-
-        // 노이즈 레벨: 5th percentile
-        std::nth_element(sorted_env.begin(),
-                         sorted_env.begin() + (size_t)(sorted_env.size() * 0.05f),
-                         sorted_env.end());
-        float noise_lvl = sorted_env[(size_t)(sorted_env.size() * 0.05f)];
-
-        // inst_freq Y범위 초기화
-        float freq_lo = inst_freq[0], freq_hi = freq_lo;
-        { int64_t step = std::max((int64_t)1, done/4000);
-          for(int64_t i = 0; i < done; i += step){
-              if(inst_freq[i] < freq_lo) freq_lo = inst_freq[i];
-              if(inst_freq[i] > freq_hi) freq_hi = inst_freq[i];
-          }
-          float fm = (freq_hi - freq_lo) * 0.05f;
-          freq_lo -= fm; freq_hi += fm;
-        }
+        int64_t done = data_size / (int64_t)(nch * (int)sizeof(int16_t));
+        if(done < 1){ fclose(f); eid_computing.store(false); return; }
+
+        EidStore::BufPtr buf = EidStore::map_file(fileno(f), src.data_offset, done, nch);
+        fclose(f);   // mapping 은 fd 와 무관하게 유지
+        if(!buf || done < 1){ eid_computing.store(false); return; }
+        EidStore::Samples iq = EidStore::Samples::whole(std::move(buf), done);
+
+        EidStats st = eid_scan_stats(iq, nch == 2, meta_sr);
 
         // ── 데이터 전달 ─────────────────────────────────────────────────────
         {
             std::lock_guard<std::mutex> lk(eid_data_mtx);
-            eid_envelope      = std::move(env);
-            eid_ch_i          = std::move(ch_i);
-            eid_ch_q          = std::move(ch_q);
-            eid_phase         = std::move(phase);
-            eid_inst_freq     = std::move(inst_freq);
+            eid_iq            = std::move(iq);
             eid_total_samples = done;
-            eid_sample_rate   = meta_sr > 0 ? meta_sr : wav_sr;
+            eid_sample_rate   = meta_sr;
             eid_is_iq         = (nch == 2);   // stereo = IQ → Audio 탭에서 AM/FM 복조 가능
+            eid_derived.invalidate();
         }
         eid_view_t0        = 0.0;
         eid_view_t1        = (double)done;
-        eid_amp_min        = amp_lo;
-        eid_amp_max        = amp_hi;
-        eid_y_min[0]       = amp_lo;
-        eid_y_max[0]       = amp_hi;
-        eid_y_min[3]       = freq_lo;
-        eid_y_max[3]       = freq_hi;
-        eid_noise_level    = noise_lvl;
+        eid_amp_min        = st.amp_lo;
+        eid_amp_max        = st.amp_hi;
+        eid_y_min[0]       = st.amp_lo;
+        eid_y_max[0]       = st.amp_hi;
+        eid_y_min[3]       = st.freq_lo;
+        eid_y_max[3]       = st.freq_hi;
+        eid_noise_level    = st.noise;
         eid_center_freq_hz = meta_cf_hz;
         eid_start_time_meta = meta_time;
         eid_view_mode      = 0; // reset to Signal on new load
         eid_phase_detrend_hz = 0.0f;
         eid_data_ready.store(true);
         eid_computing.store(false);
-        bewe_log("EID: loaded %lld samples, sr=%u, cf=%llu\n",
+        bewe_log("EID: mapped %lld samples, sr=%u, cf=%llu\n",
                  (long long)done, eid_sample_rate, (unsigned long long)meta_cf_hz);
     });
 }
@@ -150,7 +142,9 @@ void FFTViewer::eid_auto_analyze_tag(EidTag& tag){
     if(i1 - i0 < 4 || eid_envelope.empty()) return;
 
     // threshold: 구간 내 median * 비율
-    std::vector<float> seg(eid_envelope.begin()+i0, eid_envelope.begin()+i1);
+    std::vector<float> seg((size_t)(i1 - i0));
+    for(int64_t i = i0; i < i1; i++) seg[i - i0] = eid_envelope[i];
+    std::vector<float> env_seg(seg);
     std::nth_element(seg.begin(), seg.begin()+seg.size()/2, seg.end());
     float median = seg[seg.size()/2];
     float thr = median * 1.5f;
@@ -160,8 +154,9 @@ void FFTViewer::eid_auto_analyze_tag(EidTag& tag){
     std::vector<int64_t> edges;
     bool above = false;
     for(int64_t i = i0; i < i1; i++){
-        if(!above && eid_envelope[i] >= thr){ above = true; edges.push_back(i); }
-        else if(above && eid_envelope[i] < thr * 0.7f) above = false;
+        float e = env_seg[i - i0];
+        if(!above && e >= thr){ above = true; edges.push_back(i); }
+        else if(above && e < thr * 0.7f) above = false;
     }
 
     tag.auto_pulse_count = (int)edges.size();
@@ -179,60 +174,35 @@ void FFTViewer::eid_auto_analyze_tag(EidTag& tag){
     tag.auto_prf_hz = (float)sr / median_interval;
 }
 
-// ── ch_i/ch_q 로부터 envelope/phase/inst_freq 재계산 ─────────────────────────
+// ── 샘플 변경 후: 파생 채널 캐시 무효화 + auto-scale 재계산 ─────────────────
 void FFTViewer::eid_recompute_derived(){
     eid_edit_gen++;   // IQ 수정됨 → Audio 탭 복조 캐시 무효화
-    std::lock_guard<std::mutex> lk(eid_data_mtx);
-    int64_t n = eid_total_samples;
-    if(n <= 0 || (int64_t)eid_ch_i.size() < n) return;
-    eid_envelope.resize(n);
-    eid_phase.resize(n);
-    eid_inst_freq.resize(n);
-    float prev_ph = 0.f;
-    const float TWO_PI = 6.283185307f;
-    float scale = (float)eid_sample_rate / TWO_PI;  // Hz 변환 — 저장 시 바로 적용
-    for(int64_t i = 0; i < n; i++){
-        float fi = eid_ch_i[i], fq = eid_ch_q[i];
-        eid_envelope[i] = sqrtf(fi*fi + fq*fq);
-        float ph = atan2f(fq, fi);
-        eid_phase[i] = ph;
-        float dp = ph - prev_ph;
-        if(dp >  3.14159265f) dp -= TWO_PI;
-        if(dp < -3.14159265f) dp += TWO_PI;
-        eid_inst_freq[i] = (i == 0) ? 0.f : dp * scale;
-        prev_ph = ph;
+    EidStore::Samples iq;
+    {
+        std::lock_guard<std::mutex> lk(eid_data_mtx);
+        eid_derived.invalidate();
+        if(eid_total_samples <= 0 || eid_iq.size() < eid_total_samples) return;
+        iq = eid_iq;
     }
-
-    // auto-scale 재계산
-    std::vector<float> sorted_env(eid_envelope);
-    std::nth_element(sorted_env.begin(), sorted_env.begin()+(size_t)(sorted_env.size()*0.01f), sorted_env.end());
-    float lo = sorted_env[(size_t)(sorted_env.size()*0.01f)];
-    float hi = *std::max_element(eid_envelope.begin(), eid_envelope.end());
-    if(hi-lo<0.001f) hi=lo+0.001f;
-    float margin_lo = (hi-lo)*0.05f;
-    float margin_hi = hi*0.20f;
-    eid_amp_min = std::max(0.f, lo-margin_lo);
-    eid_amp_max = hi+margin_hi;
+    EidStats st = eid_scan_stats(iq, eid_is_iq, eid_sample_rate);
+    eid_amp_min = st.amp_lo;
+    eid_amp_max = st.amp_hi;
     eid_y_min[0] = eid_amp_min;
     eid_y_max[0] = eid_amp_max;
-    std::nth_element(sorted_env.begin(), sorted_env.begin()+(size_t)(sorted_env.size()*0.05f), sorted_env.end());
-    eid_noise_level = sorted_env[(size_t)(sorted_env.size()*0.05f)];
+    eid_noise_level = st.noise;
 }
 
 // ── FFT 기반 BPF (brick-wall, 블록 처리) ─────────────────────────────────────
 // uv_lo/uv_hi: 스펙트로그램 주파수축 UV [0,1] (0=-sr/2, 0.5=DC, 1=+sr/2)
 void FFTViewer::eid_apply_bpf(float uv_lo, float uv_hi){
-    // 원본 백업 (첫 적용 시에만)
-    if(!eid_bpf_active){
-        eid_orig_ch_i = eid_ch_i;
-        eid_orig_ch_q = eid_ch_q;
-    }
+    // 원본 백업 (첫 적용 시에만) — piece table 복사라 샘플 복사 없음
+    if(!eid_bpf_active) eid_orig_iq = eid_iq;
 
-    // 항상 원본에서 시작 (중첩 BPF 방지)
-    std::vector<float> work_i = eid_orig_ch_i;
-    std::vector<float> work_q = eid_orig_ch_q;
-    int64_t n = (int64_t)work_i.size();
+    // 항상 원본에서 시작 (중첩 BPF 방지). 결과만 새 float 버퍼로 materialize.
+    int64_t n = eid_orig_iq.size();
     if(n < 1) return;
+    std::vector<float> work_i((size_t)n), work_q((size_t)n);
+    eid_orig_iq.read(0, n, work_i.data(), work_q.data());
 
     int fft_n = 65536;
     while(fft_n > n) fft_n >>= 1;
@@ -290,8 +260,7 @@ void FFTViewer::eid_apply_bpf(float uv_lo, float uv_hi){
 
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        eid_ch_i = std::move(work_i);
-        eid_ch_q = std::move(work_q);
+        eid_iq = EidStore::Samples::whole(EidStore::from_floats(std::move(work_i), std::move(work_q)), n);
     }
     eid_bpf_active = true;
 
@@ -303,8 +272,7 @@ void FFTViewer::eid_undo_bpf(){
     if(!eid_bpf_active) return;
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        eid_ch_i = eid_orig_ch_i;
-        eid_ch_q = eid_orig_ch_q;
+        eid_iq = eid_orig_iq;
     }
     eid_bpf_active = false;
     eid_bpf_center_uv = 0.5f;   // BPF 해제 → 재중심 없음(DC)
@@ -392,18 +360,20 @@ std::string FFTViewer::eid_save_filtered_to(const std::string& out_path){
     uint32_t n_frames = 0;
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        n_frames = (uint32_t)std::min(eid_ch_i.size(), eid_ch_q.size());
+        n_frames = (uint32_t)eid_iq.size();
         // .sigmf-data: raw(헤더 없음) / .wav: 기존 RIFF(stereo) 헤더
         if(!sig)
             eid_write_wav_header(f, eid_sample_rate, n_frames,
                                  eid_center_freq_hz, eid_start_time_meta);
         constexpr size_t CHUNK = 4096;
         std::vector<int16_t> buf(CHUNK * 2);
+        std::vector<float> ci(CHUNK), cq(CHUNK);
         for(size_t i = 0; i < n_frames; i += CHUNK){
             size_t n = std::min(CHUNK, (size_t)n_frames - i);
+            eid_iq.read((int64_t)i, (int64_t)n, ci.data(), cq.data());
             for(size_t j = 0; j < n; j++){
-                float fi = std::max(-1.0f, std::min(1.0f, eid_ch_i[i+j]));
-                float fq = std::max(-1.0f, std::min(1.0f, eid_ch_q[i+j]));
+                float fi = std::max(-1.0f, std::min(1.0f, ci[j]));
+                float fq = std::max(-1.0f, std::min(1.0f, cq[j]));
                 buf[j*2  ] = (int16_t)(fi * 32767.0f);
                 buf[j*2+1] = (int16_t)(fq * 32767.0f);
             }
@@ -462,15 +432,8 @@ void FFTViewer::eid_remove_samples(double s0, double s1){
 
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        auto erase = [&](std::vector<float>& vec){
-            if(i0 < (int64_t)vec.size() && i1 <= (int64_t)vec.size())
-                vec.erase(vec.begin()+i0, vec.begin()+i1);
-        };
-        erase(eid_envelope);
-        erase(eid_ch_i);
-        erase(eid_ch_q);
-        erase(eid_phase);
-        erase(eid_inst_freq);
+        eid_iq.erase(i0, i1);          // piece 만 자름 — 샘플 복사 없음
+        eid_derived.invalidate();
         eid_total_samples -= count;
     }
 
@@ -508,21 +471,14 @@ void FFTViewer::eid_select_samples(double s0, double s1){
 
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        auto crop = [&](std::vector<float>& vec){
-            if((int64_t)vec.size() < i1) return;
-            vec = std::vector<float>(vec.begin()+i0, vec.begin()+i1);
-        };
-        crop(eid_envelope);
-        crop(eid_ch_i);
-        crop(eid_ch_q);
-        crop(eid_phase);
-        crop(eid_inst_freq);
+        eid_iq.crop(i0, i1);
+        eid_derived.invalidate();
         eid_total_samples = i1 - i0;
     }
 
     // BPF 백업 무효화 (길이 불일치 방지)
     eid_bpf_active = false;
-    eid_orig_ch_i.clear(); eid_orig_ch_q.clear();
+    eid_orig_iq.clear();
 
     // 태그 조정: 범위 밖 삭제, 범위 안은 좌표 이동
     double new_len = (double)(i1 - i0);
@@ -551,11 +507,8 @@ void FFTViewer::eid_cleanup(){
     eid_edit_gen++;   // 동일 파일 재로드 시 SA/EID 캐시 stale 방지
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        eid_envelope.clear();  eid_envelope.shrink_to_fit();
-        eid_ch_i.clear();      eid_ch_i.shrink_to_fit();
-        eid_ch_q.clear();      eid_ch_q.shrink_to_fit();
-        eid_phase.clear();     eid_phase.shrink_to_fit();
-        eid_inst_freq.clear(); eid_inst_freq.shrink_to_fit();
+        eid_iq.clear();            // 마지막 참조가 사라지면 mmap 해제
+        eid_derived.invalidate();
     }
     eid_data_ready.store(false);
     eid_computing.store(false);
@@ -566,8 +519,7 @@ void FFTViewer::eid_cleanup(){
     eid_view_mode        = 0;
     eid_phase_detrend_hz = 0.0f;
     eid_bpf_active       = false;
-    eid_orig_ch_i.clear(); eid_orig_ch_i.shrink_to_fit();
-    eid_orig_ch_q.clear(); eid_orig_ch_q.shrink_to_fit();
+    eid_orig_iq.clear();
     eid_tags.clear();
     eid_view_stack.clear();
     sa_view_history.clear();
@@ -579,13 +531,8 @@ void FFTViewer::eid_cleanup(){
 // ── Undo/Redo 시스템 ──────────────────────────────────────────────────────
 FFTViewer::EidUndoEntry FFTViewer::eid_snapshot() const {
     EidUndoEntry e;
-    e.envelope   = eid_envelope;
-    e.ch_i       = eid_ch_i;
-    e.ch_q       = eid_ch_q;
-    e.phase      = eid_phase;
-    e.inst_freq  = eid_inst_freq;
-    e.orig_ch_i  = eid_orig_ch_i;
-    e.orig_ch_q  = eid_orig_ch_q;
+    e.iq         = eid_iq;
+    e.orig_iq    = eid_orig_iq;
     e.tags       = eid_tags;
     e.view_stack = eid_view_stack;
     e.sa_history = sa_view_history;
@@ -612,19 +559,15 @@ FFTViewer::EidUndoEntry FFTViewer::eid_snapshot() const {
 void FFTViewer::eid_restore(const EidUndoEntry& e){
     eid_edit_gen++;   // IQ 복원(undo/redo) → 복조 캐시 무효화
     bool data_changed = (e.total_samples != eid_total_samples ||
-                         e.ch_i.size() != eid_ch_i.size() ||
+                         e.iq.size() != eid_iq.size() ||
                          e.bpf_active != eid_bpf_active);
     {
         std::lock_guard<std::mutex> lk(eid_data_mtx);
-        eid_envelope  = e.envelope;
-        eid_ch_i      = e.ch_i;
-        eid_ch_q      = e.ch_q;
-        eid_phase     = e.phase;
-        eid_inst_freq = e.inst_freq;
+        eid_iq        = e.iq;
+        eid_derived.invalidate();
         eid_total_samples = e.total_samples;
     }
-    eid_orig_ch_i = e.orig_ch_i;
-    eid_orig_ch_q = e.orig_ch_q;
+    eid_orig_iq   = e.orig_iq;
     eid_tags      = e.tags;
     eid_view_stack = e.view_stack;
     sa_view_history = e.sa_history;
@@ -677,7 +620,7 @@ void FFTViewer::eid_do_redo(){
 // ── IQ(eid_ch_i/q) → AM/FM 복조 → 임시 mono WAV(≈AUDIO_SR) ──────────────────
 // dem_worker 와 동일한 복조 수학. 녹음 IQ 는 이미 채널 baseband 이므로 mixing 없음.
 std::string FFTViewer::eid_iq_demod_tempwav(int am_fm){
-    size_t N = std::min(eid_ch_i.size(), eid_ch_q.size());
+    size_t N = eid_iq.size();
     uint32_t sr_in = eid_sample_rate;
     if(N < 2 || sr_in == 0) return "";
     uint32_t decim = std::max(1u, (uint32_t)llround((double)sr_in / (double)AUDIO_SR));
@@ -698,7 +641,8 @@ std::string FFTViewer::eid_iq_demod_tempwav(int am_fm){
 
     std::vector<int16_t> out; out.reserve(N/decim + 16);
     for(size_t n=0; n<N; n++){
-        float fi, fq; osc.mix(eid_ch_i[n], eid_ch_q[n], fi, fq);
+        float ri, rq; eid_iq.get((int64_t)n, ri, rq);
+        float fi, fq; osc.mix(ri, rq, fi, fq);
         float samp;
         if(am_fm==0){   // AM: envelope + DC제거 + AGC
             float env = sqrtf(fi*fi+fq*fq);
@@ -0,0 +1,296 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// EID sample store — mmap 기반 원본 + piece table 편집 + lazy 파생 채널.
+//
+//   Buf      : 불변 샘플 버퍼. 녹음 파일 mmap(int16, mono/IQ) 또는 float I/Q
+//              (BPF 결과처럼 새로 만들어진 데이터).
+//   Samples  : Buf 조각(piece) 목록. remove/select 는 piece 만 자르고 샘플은
+//              복사하지 않는다. 복사 비용 = piece 수 → undo 스냅샷이 O(1) 메모리.
+//   Derived  : envelope / phase / inst_freq 를 CHUNK 단위로 필요할 때 계산
+//              (VOLK magnitude/atan2) 하는 LRU. 보이는/분석 범위만 계산된다.
+//   Channel  : 기존 std::vector<float> 처럼 ch[s] / size() / empty() 로 읽는 view.
+//
+// 스레드: Samples::read() 는 const + hint 미사용 → worker 스레드에서 복사본으로 사용 가능
+//         (복사는 hint 를 읽지 않음 — UI 가 get() 중이어도 eid_data_mtx 아래 복사 OK).
+//         Samples::get() / Derived::at() / Channel 은 UI 스레드 전용 (hint/LRU 가 mutable).
+//         Derived::invalidate() 는 어느 스레드든 가능 — generation 만 올리고 slot 은
+//         다음 at() 때 UI 스레드가 비운다.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <volk/volk.h>
+
+namespace EidStore {
+
+constexpr float   SCL   = 1.0f / 32768.0f;
+constexpr int64_t CHUNK = 65536;          // 파생 채널 계산 단위 (샘플)
+constexpr size_t  DERIVED_CACHE_CHUNKS = 64;   // 64 × 64K × 3ch × 4B ≈ 48 MB
+
+enum Ch { CH_I = 0, CH_Q, CH_ENV, CH_PHASE, CH_FREQ };
+
+struct Buf {
+    // mmap int16 (nch=1 mono: I=s,Q=0 / nch=2 IQ interleaved)
+    const int16_t* s16 = nullptr;
+    int            nch = 2;
+    void*          map = nullptr;
+    size_t         map_size = 0;
+    // float I/Q (s16 == nullptr 일 때)
+    std::vector<float> fi, fq;
+
+    Buf() = default;
+    Buf(const Buf&) = delete;
+    Buf& operator=(const Buf&) = delete;
+    ~Buf(){ if(map) munmap(map, map_size); }
+
+    inline void get(int64_t k, float& i, float& q) const {
+        if(s16){
+            if(nch == 2){ i = s16[k*2] * SCL; q = s16[k*2+1] * SCL; }
+            else        { i = s16[k] * SCL;   q = 0.f; }
+        } else {
+            i = fi[k]; q = fq[k];
+        }
+    }
+};
+using BufPtr = std::shared_ptr<const Buf>;
+
+// fd 의 [data_off, data_off + n*nch*2) 를 mmap. fd 는 호출자가 닫아도 됨.
+inline BufPtr map_file(int fd, long data_off, int64_t& n_samples, int nch){
+    off_t end = lseek(fd, 0, SEEK_END);
+    if(end <= data_off || n_samples <= 0) return nullptr;
+    void* m = mmap(nullptr, (size_t)end, PROT_READ, MAP_SHARED, fd, 0);
+    if(m == MAP_FAILED) return nullptr;
+    int64_t avail = ((int64_t)end - data_off) / (nch * (int64_t)sizeof(int16_t));
+    if(n_samples > avail) n_samples = avail;
+    auto b = std::make_shared<Buf>();
+    b->map = m; b->map_size = (size_t)end;
+    b->s16 = (const int16_t*)((const uint8_t*)m + data_off);
+    b->nch = nch;
+    posix_madvise(m, (size_t)end, POSIX_MADV_RANDOM);
+    return b;
+}
+
+inline BufPtr from_floats(std::vector<float>&& fi, std::vector<float>&& fq){
+    auto b = std::make_shared<Buf>();
+    b->fi = std::move(fi); b->fq = std::move(fq);
+    return b;
+}
+
+// ── Piece table ─────────────────────────────────────────────────────────
+class Samples {
+public:
+    static Samples whole(BufPtr b, int64_t n){
+        Samples s;
+        if(b && n > 0){ s.p_.push_back({std::move(b), 0, n, 0}); s.n_ = n; }
+        return s;
+    }
+
+    Samples() = default;
+    Samples(const Samples& o) : p_(o.p_), n_(o.n_) {}
+    Samples& operator=(const Samples& o){
+        if(this != &o){ p_ = o.p_; n_ = o.n_; hint_ = 0; }
+        return *this;
+    }
+    Samples(Samples&&) = default;
+    Samples& operator=(Samples&&) = default;
+
+    int64_t size()  const { return n_; }
+    bool    empty() const { return n_ == 0; }
+    void    clear()       { p_.clear(); n_ = 0; hint_ = 0; }
+
+    // 단일 샘플 (순차 접근은 hint 로 O(1)). UI 스레드 전용.
+    inline void get(int64_t s, float& i, float& q) const {
+        if(p_.empty()){ i = q = 0.f; return; }
+        const Piece* p = &p_[hint_ < p_.size() ? hint_ : 0];
+        if(s < p->start || s >= p->start + p->len){ hint_ = find(s); p = &p_[hint_]; }
+        p->buf->get(p->off + (s - p->start), i, q);
+    }
+    float i(int64_t s) const { float a, b; get(s, a, b); return a; }
+    float q(int64_t s) const { float a, b; get(s, a, b); return b; }
+
+    // [s0, s0+n) → i[], q[] (q 는 nullptr 가능). 스레드 안전 (const, hint 미사용).
+    void read(int64_t s0, int64_t n, float* oi, float* oq) const {
+        if(n <= 0) return;
+        size_t pi = find(s0);
+        int64_t k = 0;
+        while(k < n && pi < p_.size()){
+            const Piece& p = p_[pi];
+            int64_t base = p.off + (s0 + k - p.start);
+            int64_t take = std::min(n - k, p.start + p.len - (s0 + k));
+            for(int64_t j = 0; j < take; j++){
+                float a, b; p.buf->get(base + j, a, b);
+                oi[k + j] = a;
+                if(oq) oq[k + j] = b;
+            }
+            k += take; pi++;
+        }
+    }
+    // interleaved (I,Q,I,Q…) 버전 — FFT/VOLK 입력용.
+    void read_iq(int64_t s0, int64_t n, float* iq) const {
+        if(n <= 0) return;
+        size_t pi = find(s0);
+        int64_t k = 0;
+        while(k < n && pi < p_.size()){
+            const Piece& p = p_[pi];
+            int64_t base = p.off + (s0 + k - p.start);
+            int64_t take = std::min(n - k, p.start + p.len - (s0 + k));
+            for(int64_t j = 0; j < take; j++)
+                p.buf->get(base + j, iq[(k + j)*2], iq[(k + j)*2 + 1]);
+            k += take; pi++;
+        }
+    }
+
+    // [i0, i1) 삭제 — 샘플 복사 없음.
+    void erase(int64_t i0, int64_t i1){
+        if(i0 < 0) i0 = 0;
+        if(i1 > n_) i1 = n_;
+        if(i1 <= i0) return;
+        std::vector<Piece> out;
+        out.reserve(p_.size() + 1);
+        for(const Piece& p : p_){
+            int64_t a = p.start, b = p.start + p.len;
+            if(b <= i0 || a >= i1){ out.push_back(p); continue; }
+            if(a < i0) out.push_back({p.buf, p.off, i0 - a, 0});
+            if(b > i1) out.push_back({p.buf, p.off + (i1 - a), b - i1, 0});
+        }
+        p_.swap(out);
+        relink();
+    }
+    // [i0, i1) 만 남김.
+    void crop(int64_t i0, int64_t i1){
+        if(i1 < n_) erase(i1, n_);
+        if(i0 > 0)  erase(0, i0);
+    }
+
+private:
+    struct Piece { BufPtr buf; int64_t off, len, start; };
+
+    size_t find(int64_t s) const {
+        size_t lo = 0, hi = p_.size();
+        while(hi - lo > 1){
+            size_t mid = (lo + hi) / 2;
+            if(p_[mid].start <= s) lo = mid; else hi = mid;
+        }
+        return lo;
+    }
+    void relink(){
+        n_ = 0;
+        for(Piece& p : p_){ p.start = n_; n_ += p.len; }
+        hint_ = 0;
+    }
+
+    std::vector<Piece> p_;
+    int64_t            n_ = 0;
+    mutable size_t     hint_ = 0;
+};
+
+// ── Lazy derived channels ───────────────────────────────────────────────
+class Derived {
+public:
+    // is_iq=false(mono audio) 이면 phase/inst_freq 는 0 (기존 로더와 동일).
+    Derived(const Samples* s, const uint32_t* sample_rate, const bool* is_iq)
+        : src_(s), sr_(sample_rate), iq_flag_(is_iq) {}
+    // 샘플이 바뀔 때마다 (load/BPF/remove/select/undo) 호출. 스레드 무관.
+    void invalidate(){ gen_.fetch_add(1, std::memory_order_release); }
+
+    inline float at(int ch, int64_t s){
+        uint32_t g = gen_.load(std::memory_order_acquire);
+        if(g != seen_){
+            for(auto& sl : slots_) sl.chunk = -1;
+            last_ = nullptr;
+            seen_ = g;
+        }
+        int64_t c = s / CHUNK;
+        const Slot* sl = (last_ && last_->chunk == c) ? last_ : load(c);
+        if(!sl) return 0.f;
+        size_t k = (size_t)(s - c * CHUNK);
+        switch(ch){
+            case CH_ENV:   return sl->env[k];
+            case CH_PHASE: return sl->ph[k];
+            default:       return sl->fr[k];
+        }
+    }
+
+private:
+    struct Slot { int64_t chunk = -1; uint64_t used = 0;
+                  std::vector<float> env, ph, fr; };
+
+    const Slot* load(int64_t c){
+        if(!src_ || c < 0 || c * CHUNK >= src_->size()) return nullptr;
+        for(auto& sl : slots_) if(sl.chunk == c){ sl.used = ++tick_; last_ = &sl; return last_; }
+        if(slots_.empty()) slots_.resize(DERIVED_CACHE_CHUNKS);
+        Slot* dst = &slots_[0];
+        for(auto& sl : slots_){
+            if(sl.chunk < 0){ dst = &sl; break; }
+            if(sl.used < dst->used) dst = &sl;
+        }
+        compute(c, *dst);
+        dst->chunk = c;
+        dst->used  = ++tick_;
+        last_ = dst;
+        return dst;
+    }
+
+    // chunk c: 앞 샘플 1개를 함께 읽어 inst_freq 경계를 이어 붙인다.
+    void compute(int64_t c, Slot& sl){
+        int64_t s0  = c * CHUNK;
+        int64_t n   = std::min(CHUNK, src_->size() - s0);
+        int64_t pre = s0 > 0 ? 1 : 0;
+        iq_.resize((size_t)(n + pre) * 2);
+        src_->read_iq(s0 - pre, n + pre, iq_.data());
+        sl.env.resize((size_t)n); sl.ph.resize((size_t)n); sl.fr.resize((size_t)n);
+        ph_tmp_.resize((size_t)(n + pre));
+        const lv_32fc_t* in = (const lv_32fc_t*)iq_.data();
+        volk_32fc_s32f_atan2_32f(ph_tmp_.data(), in, 1.0f, (unsigned)(n + pre));
+        volk_32fc_magnitude_32f(sl.env.data(), in + pre, (unsigned)n);
+        if(iq_flag_ && !*iq_flag_){
+            std::fill(sl.ph.begin(), sl.ph.end(), 0.f);
+            std::fill(sl.fr.begin(), sl.fr.end(), 0.f);
+            return;
+        }
+        memcpy(sl.ph.data(), ph_tmp_.data() + pre, (size_t)n * sizeof(float));
+        // inst_freq = wrap(Δphase) × sr/2π (Hz) — 파일 첫 샘플은 0
+        const float TWO_PI = 6.283185307f;
+        const float hz = (float)(sr_ ? *sr_ : 0) / TWO_PI;
+        float prev = ph_tmp_[0];
+        for(int64_t k = 0; k < n; k++){
+            float ph = sl.ph[k];
+            float dp = ph - prev;
+            if(dp >  3.14159265f) dp -= TWO_PI;
+            if(dp < -3.14159265f) dp += TWO_PI;
+            sl.fr[k] = (s0 + k == 0) ? 0.f : dp * hz;
+            prev = ph;
+        }
+    }
+
+    const Samples*     src_ = nullptr;
+    const uint32_t*    sr_  = nullptr;
+    const bool*        iq_flag_ = nullptr;
+    std::vector<Slot>  slots_;
+    Slot*              last_ = nullptr;
+    uint64_t           tick_ = 0;
+    std::atomic<uint32_t> gen_{0};
+    uint32_t           seen_ = 0;     // UI 스레드가 마지막으로 반영한 gen_
+    std::vector<float> iq_, ph_tmp_;
+};
+
+// ── vector 호환 view ─────────────────────────────────────────────────────
+struct Channel {
+    const Samples* s;
+    Derived*       d;
+    int            ch;
+    float operator[](int64_t k) const {
+        if(ch == CH_I) return s->i(k);
+        if(ch == CH_Q) return s->q(k);
+        return d->at(ch, k);
+    }
+    size_t size()  const { return (size_t)s->size(); }
+    bool   empty() const { return s->empty(); }
+};
+
+} // namespace EidStore
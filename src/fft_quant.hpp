@@ -0,0 +1,69 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// FFT 행 양자화 (header-only).
+//
+// fft_data 는 행마다 uint8[fft_size] + Scale{lo, step} (dB = lo + q·step).
+// 범위는 그 행 자신의 [min, max] (row_scale) — 화면 autoscale 창과 무관하게 clip 없음.
+// Scale 은 행 옆에 저장. FFT_FLAG_QUANT_U8 wire 의 pmin/pmax 는 캡처 범위
+// (header.power_min/max, JOIN 이 표시 범위로 씀) 고정 → broadcast 는 requantize (256 LUT).
+// float 대비 RSS 1/4 (32768 bin × 2500 행: 327 MB → 82 MB).
+// 범위 밖 값은 clamp (NaN → lo).
+// ─────────────────────────────────────────────────────────────────────────────
+#include <cstdint>
+
+namespace FftQuant {
+
+struct Scale {
+    float lo   = 0.f;
+    float step = 0.f;
+};
+
+inline Scale make_scale(float lo, float hi){
+    float range = hi - lo;
+    if(!(range > 0.f)) range = 1.f;
+    return Scale{lo, range / 255.f};
+}
+inline float hi(Scale s){ return s.lo + 255.f * s.step; }
+
+// 행 자신의 [min, max] 범위 (±inf/NaN 무시, 최소 폭 MIN_RANGE dB).
+constexpr float MIN_RANGE = 1.0f;
+inline Scale row_scale(const float* db, int n){
+    float lo = 1e30f, hi_ = -1e30f;
+    for(int i = 0; i < n; i++){
+        float v = db[i];
+        if(!(v > -1e30f && v < 1e30f)) continue;   // -inf (log10 0) / NaN
+        lo  = v < lo  ? v : lo;
+        hi_ = v > hi_ ? v : hi_;
+    }
+    if(lo > hi_) lo = hi_ = 0.f;                    // 유효 값 없음
+    if(hi_ - lo < MIN_RANGE) hi_ = lo + MIN_RANGE;
+    return make_scale(lo, hi_);
+}
+
+// n 개 (자동 벡터화되는 단순 루프)
+inline void quantize_row(const float* db, uint8_t* out, int n, Scale s){
+    const float k = s.step > 0.f ? 1.0f / s.step : 0.f;
+    for(int i = 0; i < n; i++){
+        float t = (db[i] - s.lo) * k + 0.5f;
+        t = t > 0.f ? t : 0.f;          // NaN → 0
+        t = t < 255.f ? t : 255.f;
+        out[i] = (uint8_t)t;
+    }
+}
+
+// 저장 Scale → 다른 Scale 로 uint8 재매핑 (코드 256 개 LUT, in == out 가능)
+inline void requantize(const uint8_t* in, uint8_t* out, int n, Scale from, Scale to){
+    uint8_t lut[256]; float db[256];
+    for(int q = 0; q < 256; q++) db[q] = from.lo + (float)q * from.step;
+    quantize_row(db, lut, 256, to);
+    for(int i = 0; i < n; i++) out[i] = lut[in[i]];
+}
+
+// 읽기 전용 행 view — rowp[b] 로 dB 값 (기존 const float* 와 같은 사용법).
+struct Row {
+    const uint8_t* q = nullptr;
+    Scale s;
+    float operator[](int i) const { return s.lo + (float)q[i] * s.step; }
+};
+
+} // namespace FftQuant
@@ -2,6 +2,7 @@
 #include "audio_playback.hpp"
 #include "net_protocol.hpp"
 #include "kst_time.hpp"
+#include "sat_pass_plan.hpp"
 #include <algorithm>
 #include <mutex>
 
@@ -64,132 +65,284 @@ void bewe_log_push(int col, const char* fmt, ...){
     else fputs(buf, stdout);
 }
 
-// ── Jet colormap LUT (COLORMAP_LUT_SIZE entry, 한 번만 계산) ────────────
-static uint32_t g_jet_lut[COLORMAP_LUT_SIZE];
-static bool g_jet_init=false;
-static const uint32_t* jet_lut(){
-    if(!g_jet_init){
-        g_jet_init=true;
-        auto c=[](float v)->uint8_t{v=v<0?0:v>1?1:v;return(uint8_t)(v*255);};
-        for(int i=0;i<COLORMAP_LUT_SIZE;i++){
-            float t=i/(float)(COLORMAP_LUT_SIZE-1);
-            float r=1.5f-fabsf(4*t-3);
-            float g=1.5f-fabsf(4*t-2);
-            float b=1.5f-fabsf(4*t-1);
-            g_jet_lut[i]=IM_COL32(c(r),c(g),c(b),255);
-        }
+// ── Waterfall (GPU 컬러맵) ────────────────────────────────────────────────
+// data 텍스처: 행 = fft_data 1행 (ring, MAX_FFTS_MEMORY), 텍셀 RGBA8 = 연속 4 bin 의
+// uint8 (FftQuant) + 행별 Scale 텍스처. CPU 는 행 memcpy + glTexSubImage2D 만 한다.
+// 표시: render_waterfall() 가 셰이더로 화면 픽셀 크기 FBO 에 그림 —
+//   · 픽셀 폭에 걸친 bin 들의 max (peak map, 최대 WF_MAX_TAPS fetch)
+//   · 노치 구간은 같은 행의 해시 위치 2곳 중 작은 값 (노이즈 플로어 대체)
+//   · dB 범위 + Jet 컬러맵
+// GLSL 330 core 만 사용 → Mesa llvmpipe 에서도 동작.
+
+static constexpr int WF_BINS_PER_TEXEL = 4;
+static constexpr int WF_MAX_NOTCH      = 16;
+
+#ifndef BEWE_HEADLESS
+static const char* WF_VS = R"(
+#version 330 core
+out vec2 vUV;
+void main(){
+    // 전화면 삼각형 (VBO 없음)
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    vUV = p;
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* WF_FS = R"(
+#version 330 core
+uniform sampler2D uData;     // RGBA8, texel = 4 bin
+uniform int   uN;            // fft_size
+uniform int   uRows;         // ring 행 수
+uniform int   uTop;          // 화면 맨 윗행의 ring index
+uniform int   uH;            // 출력 높이 (px = 행)
+uniform float uW;            // 출력 폭 (px)
+uniform float uD0, uD1;      // 화면 좌/우 끝 display-bin 좌표 (0..N, DC = N/2)
+uniform sampler2D uScale;    // RG32F (lo, step) × 행: dB = lo + q*255*step
+uniform float uWmin, uWinv;  // 표시 범위
+uniform int   uNotchN;
+uniform vec2  uNotch[16];    // display-bin [lo, hi]
+uniform int   uMaxTaps;
+in vec2 vUV;
+out vec4 frag;
+
+float fetch_q(int b, int row){
+    vec4 c = texelFetch(uData, ivec2(b >> 2, row), 0);
+    int k = b & 3;
+    return k == 0 ? c.r : k == 1 ? c.g : k == 2 ? c.b : c.a;
+}
+bool in_notch(float d){
+    for(int i = 0; i < uNotchN; i++)
+        if(d >= uNotch[i].x && d <= uNotch[i].y) return true;
+    return false;
+}
+uint hash(uint x){
+    x ^= x >> 16; x *= 0x7feb352du; x ^= x >> 15; x *= 0x846ca68bu; x ^= x >> 16;
+    return x;
+}
+// display-bin d → 0..1 양자화 값 (노치면 같은 행 임의 2 bin 중 작은 값)
+float val(int d, int row){
+    d = clamp(d, 0, uN - 1);
+    if(uNotchN > 0 && in_notch(float(d) + 0.5)){
+        uint h = hash(uint(d) * 2654435761u ^ uint(row));
+        float a = fetch_q(int(h % uint(uN)), row);
+        float b = fetch_q(int(hash(h) % uint(uN)), row);
+        return min(a, b);
+    }
+    int b = d + (uN >> 1);
+    if(b >= uN) b -= uN;
+    return fetch_q(b, row);
+}
+void main(){
+    int y   = int(gl_FragCoord.y);              // 0 = 아래
+    int row = uTop - (uH - 1 - y);
+    row = ((row % uRows) + uRows) % uRows;
+    float span = (uD1 - uD0) / uW;              // 픽셀당 bin
+    float x0 = uD0 + floor(gl_FragCoord.x) * span;
+    float q;
+    if(span <= 1.0){
+        // 확대: 인접 bin 선형 보간 (기존 GL_LINEAR 와 동일)
+        float d = x0 + 0.5 * span - 0.5;
+        int   i = int(floor(d));
+        q = mix(val(i, row), val(i + 1, row), d - floor(d));
+    } else {
+        // 축소: 픽셀 폭 구간 peak
+        int b0 = int(floor(x0)), b1 = int(ceil(x0 + span));
+        int n = max(b1 - b0, 1);
+        int stride = max(1, (n + uMaxTaps - 1) / uMaxTaps);
+        q = 0.0;
+        for(int b = b0; b < b1; b += stride) q = max(q, val(b, row));
     }
-    return g_jet_lut;
+    vec2  sc = texelFetch(uScale, ivec2(0, row), 0).rg;
+    float db = sc.x + q * 255.0 * sc.y;
+    float t  = clamp((db - uWmin) * uWinv, 0.0, 1.0);
+    vec3 c = clamp(vec3(1.5) - abs(vec3(4.0 * t) - vec3(3.0, 2.0, 1.0)), 0.0, 1.0);
+    frag = vec4(c, 1.0);
 }
+)";
 
-// 텍스처 폭: GPU 한계(보통 16384) 이내로 제한
-static constexpr int WF_TEX_MAX = 16384;
+static GLuint wf_compile(){
+    auto sh = [](GLenum type, const char* src) -> GLuint {
+        GLuint s = glCreateShader(type);
+        glShaderSource(s, 1, &src, nullptr);
+        glCompileShader(s);
+        GLint ok; glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
+        if(!ok){
+            char log[512]; glGetShaderInfoLog(s, sizeof(log), nullptr, log);
+            bewe_log_push(1,"[Waterfall] shader compile error: %s\n", log);
+        }
+        return s;
+    };
+    GLuint vs = sh(GL_VERTEX_SHADER, WF_VS), fs = sh(GL_FRAGMENT_SHADER, WF_FS);
+    GLuint prog = glCreateProgram();
+    glAttachShader(prog, vs); glAttachShader(prog, fs);
+    glLinkProgram(prog);
+    GLint ok; glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if(!ok){
+        char log[512]; glGetProgramInfoLog(prog, sizeof(log), nullptr, log);
+        bewe_log_push(1,"[Waterfall] shader link error: %s\n", log);
+        glDeleteProgram(prog); prog = 0;
+    }
+    glDeleteShader(vs); glDeleteShader(fs);
+    return prog;
+}
+#endif
 
 // ── Waterfall texture ─────────────────────────────────────────────────────
 void FFTViewer::create_waterfall_texture(){
+    int tex_w = std::max(1, (fft_size + WF_BINS_PER_TEXEL - 1) / WF_BINS_PER_TEXEL);
+    wf_row_q.assign((size_t)tex_w * WF_BINS_PER_TEXEL, 0);
 #ifdef BEWE_HEADLESS
-    int tex_w = std::min(fft_size, WF_TEX_MAX);
-    if(tex_w < 1) tex_w = 1;
-    wf_row_buf.assign(tex_w, 0);
     return;
 #else
-    if(waterfall_texture) glDeleteTextures(1,&waterfall_texture);
-    int tex_w = std::min(fft_size, WF_TEX_MAX);
-    if(tex_w < 1) tex_w = 1;
-    glGenTextures(1,&waterfall_texture);
-    glBindTexture(GL_TEXTURE_2D,waterfall_texture);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+    if(wf_data_tex) glDeleteTextures(1,&wf_data_tex);
+    glGenTextures(1,&wf_data_tex);
+    glBindTexture(GL_TEXTURE_2D,wf_data_tex);
+    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_REPEAT);
-    glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA,tex_w,MAX_FFTS_MEMORY,0,GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+    glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA8,tex_w,MAX_FFTS_MEMORY,0,GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+    if(!wf_scale_tex){
+        glGenTextures(1,&wf_scale_tex);
+        glBindTexture(GL_TEXTURE_2D,wf_scale_tex);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D,0,GL_RG32F,1,MAX_FFTS_MEMORY,0,GL_RG,GL_FLOAT,nullptr);
+    }
     glBindTexture(GL_TEXTURE_2D,0);
+    if(!wf_prog){
+        wf_prog = wf_compile();
+        glGenVertexArrays(1,&wf_vao);
+        auto U=[&](const char* n){ return glGetUniformLocation(wf_prog,n); };
+        wf_u={U("uData"),U("uN"),U("uRows"),U("uTop"),U("uH"),U("uW"),U("uD0"),U("uD1"),
+              U("uScale"),U("uWmin"),U("uWinv"),U("uNotchN"),U("uNotch"),U("uMaxTaps")};
+    }
+    wf_fbo_w = wf_fbo_h = 0;            // 다음 render 에서 출력 FBO 재생성
 #endif
 }
 
+// 행 fi 업로드 — 저장된 uint8 행 그대로 (재양자화 없음).
 void FFTViewer::update_wf_row(int fi){
 #ifdef BEWE_HEADLESS
     (void)fi;
     return;
 #else
-    std::lock_guard<std::mutex> lk(data_mtx);
-    int tex_w = std::min(fft_size, WF_TEX_MAX);
-    if(tex_w < 1) tex_w = 1;
-    if((int)wf_row_buf.size()!=tex_w) wf_row_buf.resize(tex_w);
+    if(!wf_data_tex) return;
     int mi=fi%MAX_FFTS_MEMORY;
-    const float* row=fft_data.data()+mi*fft_size;
-    float wmin=display_power_min, wmax=display_power_max;
-    float wrng_inv=1.0f/std::max(1.0f,wmax-wmin);
-    const uint32_t* lut=jet_lut();
-
-    int fft_half=fft_size/2;
-    int tex_half=tex_w/2;
+    FftQuant::Scale sc;
+    {
+        std::lock_guard<std::mutex> lk(data_mtx);
+        if(wf_row_q.size() < (size_t)fft_size) return;   // fft_size 변경 직후 (재생성 대기)
+        memcpy(wf_row_q.data(), fft_data.data()+(size_t)mi*fft_size, (size_t)fft_size);
+        sc=fft_row_scale[mi];
+    }
+    int tex_w=(int)(wf_row_q.size()/WF_BINS_PER_TEXEL);
+    glBindTexture(GL_TEXTURE_2D,wf_data_tex);
+    glTexSubImage2D(GL_TEXTURE_2D,0,0,mi,tex_w,1,GL_RGBA,GL_UNSIGNED_BYTE,wf_row_q.data());
+    glBindTexture(GL_TEXTURE_2D,wf_scale_tex);
+    glTexSubImage2D(GL_TEXTURE_2D,0,0,mi,1,1,GL_RG,GL_FLOAT,&sc);
+    glBindTexture(GL_TEXTURE_2D,0);
+    wf_dirty=true;
+#endif
+}
 
-    float ratio = (float)fft_half / (float)tex_half;
+// 화면 (w × h px) 워터폴을 waterfall_texture (FBO) 에 그림.
+// top_row: 맨 윗행 FFT index, d0/d1: 좌/우 끝 display-bin 좌표 (0..fft_size).
+// 입력이 직전 호출과 같으면 재렌더 생략.
+void FFTViewer::render_waterfall(int w, int h, int top_row, float d0, float d1){
+#ifdef BEWE_HEADLESS
+    (void)w; (void)h; (void)top_row; (void)d0; (void)d1;
+#else
+    if(!wf_prog || !wf_data_tex || w < 1 || h < 1) return;
+    if(w != wf_fbo_w || h != wf_fbo_h){
+        if(!wf_fbo) glGenFramebuffers(1,&wf_fbo);
+        if(waterfall_texture) glDeleteTextures(1,&waterfall_texture);
+        glGenTextures(1,&waterfall_texture);
+        glBindTexture(GL_TEXTURE_2D,waterfall_texture);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA8,w,h,0,GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+        glBindTexture(GL_TEXTURE_2D,0);
+        GLint prev_fb; glGetIntegerv(GL_FRAMEBUFFER_BINDING,&prev_fb);
+        glBindFramebuffer(GL_FRAMEBUFFER,wf_fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,GL_TEXTURE_2D,waterfall_texture,0);
+        glBindFramebuffer(GL_FRAMEBUFFER,(GLuint)prev_fb);
+        wf_fbo_w=w; wf_fbo_h=h; wf_dirty=true;
+    }
 
-    // ── 노치필터: 전체 FFT의 하위 절반(중앙값 이하) bin을 노이즈 플로어 풀로 사용
-    // 강한 신호 배제 + DC 가로지르는 노치도 MHz 기반 매칭으로 안전
-    static thread_local std::vector<NotchFilter> nlocal;
+    // 노치 → display-bin 좌표
+    float nv[WF_MAX_NOTCH*2]; int nn=0;
     {
+        float nyq=(float)header.sample_rate/2e6f, cf=(float)(header.center_frequency/1e6);
+        float k=(nyq>0.f)?(float)fft_size/(2.f*nyq):0.f;
         std::lock_guard<std::mutex> nlk(notches_mtx);
-        nlocal = notches;
-    }
-    static thread_local std::vector<float> noise_floor_pool;
-    noise_floor_pool.clear(); // 노치 제거 시 stale pool 잔존 방지
-    if(!nlocal.empty()){
-        static thread_local std::vector<float> tmp;
-        tmp.assign(row, row+fft_size);
-        size_t half = tmp.size()/2;
-        std::nth_element(tmp.begin(), tmp.begin()+half, tmp.end());
-        noise_floor_pool.assign(tmp.begin(), tmp.begin()+half);
+        for(auto& n : notches){
+            if(nn>=WF_MAX_NOTCH) break;
+            nv[nn*2]  =(n.freq_lo_mhz-cf)*k+fft_size*0.5f;
+            nv[nn*2+1]=(n.freq_hi_mhz-cf)*k+fft_size*0.5f;
+            nn++;
+        }
     }
-    float nyq_mhz_wf = (float)(header.sample_rate)/2.0f / 1e6f;
-    float cf_mhz_wf = (float)(header.center_frequency/1e6);
-    int hf_wf = fft_size/2;
-    auto bin_to_mhz_wf = [&](int b) -> float {
-        float fd = (b < hf_wf) ? (float)b/hf_wf*nyq_mhz_wf : (float)(b-fft_size)/hf_wf*nyq_mhz_wf;
-        return cf_mhz_wf + fd;
-    };
-    auto bin_in_notch = [&](int b) -> bool {
-        if(nlocal.empty()) return false;
-        float mhz = bin_to_mhz_wf(b);
-        for(auto& n : nlocal) if(mhz >= n.freq_lo_mhz && mhz <= n.freq_hi_mhz) return true;
-        return false;
-    };
-    auto sample_at_wf = [&](int b) -> float {
-        if(noise_floor_pool.empty()) return -80.0f;
-        uint32_t h = (uint32_t)(b * 2654435761u) ^ (uint32_t)fi;
-        return noise_floor_pool[h % noise_floor_pool.size()];
+    float wmin=display_power_min, wmax=display_power_max;
+    uint64_t key=0xcbf29ce484222325ull;
+    auto mix=[&](const void* p, size_t n){
+        const uint8_t* b=(const uint8_t*)p;
+        for(size_t i=0;i<n;i++){ key^=b[i]; key*=0x100000001b3ull; }
     };
+    mix(&top_row,sizeof(top_row)); mix(&d0,sizeof(d0)); mix(&d1,sizeof(d1));
+    mix(&wmin,sizeof(wmin)); mix(&wmax,sizeof(wmax)); mix(nv,sizeof(float)*2*nn); mix(&nn,sizeof(nn));
+    if(!wf_dirty && key==wf_key) return;
+    wf_dirty=false; wf_key=key;
 
-    auto map_peak=[&](float bin_start_f, float bin_end_f)->uint32_t{
-        int bs=std::max(0, (int)bin_start_f);
-        int be=std::min(fft_size-1, (int)bin_end_f);
-        float mx=-200.0f;
-        for(int b=bs;b<=be;b++){
-            float v = bin_in_notch(b) ? sample_at_wf(b) : row[b];
-            if(v > mx) mx = v;
-        }
-        float t=(mx-wmin)*wrng_inv;
-        int idx=(int)(t*(COLORMAP_LUT_SIZE-1));
-        idx=idx<0?0:idx>=(COLORMAP_LUT_SIZE)?COLORMAP_LUT_SIZE-1:idx;
-        return lut[idx];
-    };
+    // GL 상태 보존 (ImGui 프레임 구성 중 호출)
+    GLint prev_fb, prev_prog, prev_vao, prev_tex, prev_tex1, prev_act, vp[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING,&prev_fb);
+    glGetIntegerv(GL_CURRENT_PROGRAM,&prev_prog);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING,&prev_vao);
+    glGetIntegerv(GL_ACTIVE_TEXTURE,&prev_act);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D,&prev_tex);
+    glGetIntegerv(GL_VIEWPORT,vp);
+    GLboolean sc=glIsEnabled(GL_SCISSOR_TEST), bl=glIsEnabled(GL_BLEND), dt=glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_SCISSOR_TEST); glDisable(GL_BLEND); glDisable(GL_DEPTH_TEST);
 
-    for(int i=0;i<tex_half;i++){
-        float b0 = fft_half + i * ratio;
-        float b1 = fft_half + (i+1) * ratio - 1;
-        wf_row_buf[i]=map_peak(b0, b1);
-    }
-    for(int i=0;i<tex_half;i++){
-        float b0 = i * ratio;
-        float b1 = (i+1) * ratio - 1;
-        wf_row_buf[tex_half+i]=map_peak(b0, b1);
-    }
+    glBindFramebuffer(GL_FRAMEBUFFER,wf_fbo);
+    glViewport(0,0,w,h);
+    glUseProgram(wf_prog);
+    glActiveTexture(GL_TEXTURE1);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D,&prev_tex1);
+    glBindTexture(GL_TEXTURE_2D,wf_scale_tex);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D,wf_data_tex);
+    glUniform1i(wf_u.data,0);
+    glUniform1i(wf_u.n,fft_size);
+    glUniform1i(wf_u.rows,MAX_FFTS_MEMORY);
+    glUniform1i(wf_u.top,top_row%MAX_FFTS_MEMORY);
+    glUniform1i(wf_u.h,h);
+    glUniform1f(wf_u.w,(float)w);
+    glUniform1f(wf_u.d0,d0);
+    glUniform1f(wf_u.d1,d1);
+    glUniform1i(wf_u.scale,1);
+    glUniform1f(wf_u.wmin,wmin);
+    glUniform1f(wf_u.winv,1.0f/std::max(1.0f,wmax-wmin));
+    glUniform1i(wf_u.notch_n,nn);
+    if(nn>0) glUniform2fv(wf_u.notch,nn,nv);
+    glUniform1i(wf_u.max_taps,64);
+    glBindVertexArray(wf_vao);
+    glDrawArrays(GL_TRIANGLES,0,3);
 
-    glBindTexture(GL_TEXTURE_2D,waterfall_texture);
-    glTexSubImage2D(GL_TEXTURE_2D,0,0,mi,tex_w,1,GL_RGBA,GL_UNSIGNED_BYTE,wf_row_buf.data());
-    glBindTexture(GL_TEXTURE_2D,0);
+    glBindVertexArray((GLuint)prev_vao);
+    glBindTexture(GL_TEXTURE_2D,(GLuint)prev_tex);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D,(GLuint)prev_tex1);
+    glActiveTexture((GLenum)prev_act);
+    glUseProgram((GLuint)prev_prog);
+    glBindFramebuffer(GL_FRAMEBUFFER,(GLuint)prev_fb);
+    glViewport(vp[0],vp[1],vp[2],vp[3]);
+    if(sc) glEnable(GL_SCISSOR_TEST);
+    if(bl) glEnable(GL_BLEND);
+    if(dt) glEnable(GL_DEPTH_TEST);
 #endif
 }
 
@@ -230,6 +383,7 @@ int FFTViewer::channel_at_x(float mx, float gx, float gw) const {
 // 정상 경로에서는 cleanup이 모든 스레드를 이미 join했지만,
 // 누락/예외/재진입 시에도 안전하도록 RAII로 보장.
 FFTViewer::~FFTViewer(){
+    metrics_remove();   // collector 가 this 를 잡고 있음 → 멤버 해제 전에
     // 실행 중일 수 있는 루프들에 종료 신호 전달
     is_running = false;
     mix_stop.store(true);
@@ -239,13 +393,22 @@ FFTViewer::~FFTViewer(){
     sa_computing.store(false);
     eid_computing.store(false);
 
+    rec_io_stop.store(true);
+    rec_io_cv.notify_all();
+    tm_pin_stop.store(true);
+    tm_pin_cv.notify_all();
+    if(sched_plan) sched_plan->cancel.store(true);   // replan 워커가 this 보다 오래 살지 않게
+
     auto join_if = [](std::thread& t){ if(t.joinable()) t.join(); };
     join_if(mix_thr);
     join_if(net_bcast_thr);
     join_if(rec_thr);
+    join_if(rec_io_thr);
+    join_if(tm_pin_thr);
     join_if(sa_thread);
     join_if(sa_play_thread);
     join_if(eid_thread);
+    join_if(sched_plan_thr);
     for(int i = 0; i < MAX_CHANNELS; ++i){
         join_if(channels[i].dem_thr);
         join_if(channels[i].iq_only_thr);
@@ -7,6 +7,11 @@
 #include "channel.hpp"
 #include "audio_playback.hpp"
 #include "mission.hpp"
+#include "eid_store.hpp"
+#include "tm_codec.hpp"
+#include "tm_tiers.hpp"
+#include "fft_quant.hpp"
+#include "quantile_sketch.hpp"
 
 #ifndef BEWE_HEADLESS
   #include <GL/glew.h>
@@ -14,6 +19,7 @@
   #include <imgui.h>
 #else
   typedef unsigned int GLuint;
+  typedef int          GLint;
 #endif
 #include <libbladeRF.h>
 #include <rtl-sdr.h>
@@ -34,6 +40,7 @@
 #include <algorithm>
 #include <deque>
 #include <condition_variable>
+#include <future>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -41,6 +48,7 @@
 
 // ── Global log helper (ui.cpp에서 정의, 모든 .cpp에서 사용 가능) ─────────
 extern std::string g_sdr_force; // "" = 자동, "bladerf"|"rtlsdr"|"pluto"
+extern int g_metrics_port;        // HOST /metrics 포트 (localhost, 0 = 끔) — host_metrics.cpp
 extern std::vector<std::string> scan_available_sdrs();
 extern void bewe_log(const char* fmt, ...);
 // LOG 오버레이용 글로벌 로그 (col: 0=HOST 1=SERVER 2=JOIN)
@@ -62,6 +70,8 @@ void write_default_info_file(const std::string& wav_path,
                              int utc_offset_hours = INT_MIN,
                              uint32_t sample_rate = 0);  // SigMF meta용 (IQ .sigmf-data); .wav는 무시
 
+namespace SatPlan { class Queue; }   // sat_pass_plan.hpp (sched_record.cpp 에서만 완전 타입)
+
 // ── FFTViewer ─────────────────────────────────────────────────────────────
 class FFTViewer {
 public:
@@ -72,9 +82,29 @@ public:
 
     // ── FFT / waterfall data ──────────────────────────────────────────────
     FFTHeader            header;
-    std::vector<float>   fft_data;
-    GLuint               waterfall_texture=0;
-    std::vector<uint32_t> wf_row_buf;
+    // MAX_FFTS_MEMORY 행 ring, 행마다 uint8[fft_size] + fft_row_scale (FftQuant).
+    // 읽기: fft_row(mi)[b] → dB, 쓰기: fft_store_row(mi, db) — 모두 data_mtx 안에서.
+    std::vector<uint8_t> fft_data;
+    FftQuant::Scale      fft_row_scale[MAX_FFTS_MEMORY]={};
+    FftQuant::Row fft_row(int mi) const {
+        return FftQuant::Row{fft_data.data()+(size_t)mi*fft_size, fft_row_scale[mi]};
+    }
+    // 행 자신의 min/max 로 양자화 저장 (autoscale 표시 창으로 자르지 않음)
+    void fft_store_row(int mi, const float* db){
+        FftQuant::Scale s=FftQuant::row_scale(db, fft_size);
+        FftQuant::quantize_row(db, fft_data.data()+(size_t)mi*fft_size, fft_size, s);
+        fft_row_scale[mi]=s;
+    }
+    GLuint               waterfall_texture=0;   // 화면 크기 FBO 출력 (render_waterfall)
+    GLuint               wf_data_tex=0;         // 양자화 dB ring (RGBA8 = 4 bin/texel)
+    GLuint               wf_fbo=0, wf_prog=0, wf_vao=0;
+    struct WfUniforms { GLint data, n, rows, top, h, w, d0, d1, scale, wmin, winv, notch_n, notch, max_taps; };
+    WfUniforms           wf_u{};                // wf_prog 링크 직후 1회 조회
+    int                  wf_fbo_w=0, wf_fbo_h=0;
+    bool                 wf_dirty=true;         // 새 행 업로드 / FBO 재생성
+    uint64_t             wf_key=0;              // 직전 render 입력 해시
+    GLuint               wf_scale_tex=0;        // 행별 FftQuant::Scale (RG32F, 1 × MAX_FFTS_MEMORY)
+    std::vector<uint8_t> wf_row_q;              // 업로드용 행 (4 bin 패딩)
 
     int   fft_size=DEFAULT_FFT_SIZE*FFT_PAD_FACTOR, time_average=TIME_AVERAGE;
     int   fft_input_size=DEFAULT_FFT_SIZE;  // 실제 입력 샘플 수 (윈도우 길이)
@@ -289,12 +319,26 @@ public:
     std::vector<int16_t> tm_iq_batch_buf;
     int tm_iq_batch_cnt=0;
     int64_t  tm_iq_write_sample=0;         // 현재 파일 내 쓰기 샘플 위치
-    int64_t  tm_iq_total_samples=0;        // 파일 전체 샘플 수 (미리 할당)
+    std::atomic<int64_t> tm_iq_total_samples{0};   // 파일 전체 샘플 수 (미리 할당) — 압축 링은 capture 가 갱신, UI/spill/net 이 읽음
     // 초 단위 타임스탬프 배열 [0..TM_IQ_SECS-1]: 각 초 청크의 시작 시각
     time_t   tm_iq_chunk_time[TM_IQ_SECS]={};
     int      tm_iq_chunk_write=0;          // 현재 쓰고 있는 청크 인덱스
     int64_t  tm_iq_chunk_sample_start=0;   // 현재 청크 샘플 시작
     bool     tm_iq_file_ready=false;
+    // 압축 롤링 모드 (BEWE_TM_COMPRESS=lossless|bfp8|bfp6|bfp4, 기본 raw WAV).
+    // 압축 시 같은 바이트 용량의 가변 블록 링 → tm_iq_total_samples 는 현재 압축비 기준 추정치.
+    TmCodec::Mode  tm_iq_codec=TmCodec::MODE_RAW;
+    TmCodec::Ring  tm_iq_ring;
+    // 계층 보존: RAM hot ring → (SPILL 단위) → SSD 롤링 → trigger pin → SigMF
+    TmTier::HotRing tm_hot;
+    AsyncIO::Writer tm_aw;                 // raw 롤링 파일 비동기 쓰기 (io_uring / pool)
+    int64_t  tm_iq_spilled=0;              // SSD 에 내려간 끝 (hot ring 꺼지면 == write_sample)
+    uint32_t tm_pin_sources=0;             // BEWE_TM_PIN (TmTier::Trig 비트)
+    std::mutex              tm_pin_mtx;
+    std::condition_variable tm_pin_cv;
+    std::vector<TmTier::Pin> tm_pins;
+    std::thread             tm_pin_thr;
+    std::atomic<bool>       tm_pin_stop{false};
 
     // 영역 녹음 진행 상태
     enum RecState { REC_IDLE, REC_BUSY, REC_SUCCESS } rec_state=REC_IDLE;
@@ -309,6 +353,19 @@ public:
     void tm_iq_close();
     void tm_iq_write(const int16_t* samples, int n_pairs);
     void tm_iq_flush_batch();
+    // 롤링 버퍼 읽기 (raw/압축 공통). [pos,pos+n) 샘플 좌표, 없는 구간은 0 → false.
+    bool tm_iq_read(int64_t pos, int n, int16_t* dst) const;
+    // snap_write 기준 아직 롤링 버퍼에 남아 있는 가장 오래된 샘플.
+    int64_t tm_iq_valid_start(int64_t snap_write) const;
+    void tm_iq_remove_rolling(uint32_t sr);   // 해당 SR 롤링 파일 삭제 (.wav/.bwtm)
+    void tm_ssd_write(const int16_t* buf, int n, int64_t pos);
+    bool tm_ssd_read(int64_t pos, int n, int16_t* dst) const;
+    void tm_iq_spill(bool all);
+    // trigger → 보존 pin (소스가 BEWE_TM_PIN 에 켜져 있을 때만)
+    void tm_pin_channel(uint32_t trig, int ch, bool open, const char* label);
+    void tm_pin_range(uint32_t trig, float freq_lo, float freq_hi,
+                      int64_t s0, int64_t s1, const char* label, int ch=-1);
+    void tm_pin_worker();
     void tm_mark_rows(int fft_idx);
     void tm_update_display();
     bool tm_rec_start();
@@ -338,6 +395,15 @@ public:
 
     void region_save();
     std::string do_region_save_work();
+    // 여러 영역을 롤링 파일 1 pass 로 추출. 반환 = 영역별 출력 경로 ("" = 실패)
+    // archive=true: trigger pin 보존용 (file_xfers / SA / region 상태 건드리지 않음)
+    std::vector<std::string> do_region_save_batch(const std::vector<RegionSel>& regs, bool archive=false);
+    // JOIN 영역 요청 큐: 짧은 시간 안에 모인 요청을 한 배치로 처리
+    std::future<std::string> region_save_enqueue(const RegionSel& r);
+    void region_q_drain();
+    std::mutex region_q_mtx;
+    std::vector<std::pair<RegionSel, std::promise<std::string>>> region_q;
+    bool region_q_worker = false;
 
     // ── SA (Signal Analyzer) 패널 ─────────────────────────────────────────
     bool              sa_panel_open  = false;
@@ -354,14 +420,23 @@ public:
     bool              sa_drag_active = false;
     float right_panel_x   = 0.0f;
 
-    // SA 픽셀 버퍼 (스레드 → 메인 스레드 전달)
+    // SA 픽셀 버퍼 (스레드 → 메인 스레드 전달, tile 단위 점진 업로드)
     std::vector<uint32_t> sa_pixel_buf;
+    std::vector<int>      sa_tile_queue;          // 완료됐지만 아직 GL 에 안 올린 tile
+    bool                  sa_tex_realloc = false; // 새 크기 → 텍스처 재할당 필요
     std::mutex            sa_pixel_mtx;
     std::atomic<bool>     sa_pixel_ready{false};
+    std::atomic<bool>     sa_cancel{false};
+    std::atomic<int64_t>  sa_tiles_done{0};
+    std::atomic<int64_t>  sa_tiles_total{0};
 
     void sa_start(const std::string& wav_path);  // 비동기 FFT 계산 시작
     void sa_cleanup();                            // 임시파일 삭제 + 텍스처 해제
     void sa_upload_texture();                     // 메인스레드에서 GL 업로드
+    // sa_thread 공용 스트리밍 렌더 (sketch pass + tile pass). 반환: FFT 행 수 / -1
+    int64_t sa_render(int fft_req, int win_type, int64_t n_samples,
+                      const std::function<void(int64_t,int,float*)>& fill,
+                      float sample_scale);
 
     // SA 메타데이터 (WAV BEWE 청크에서 읽음)
     uint64_t sa_center_freq_hz = 0;   // 중심주파수 (Hz)
@@ -405,17 +480,37 @@ public:
         // filter the list. Empty year/code = added outside any mission.
         int     mission_year      = 0;
         char    mission_code[8]   = {};
+        // 로컬 전용 (SCHED_SYNC 에 안 실림)
+        uint32_t uid              = 0;   // 0 = 새로 추가됨 → sched_tick 이 부여 + 힙 재구성
+        std::shared_ptr<const DopplerTrack> dop;   // 위성 패스 계획 항목만
+        double   plan_cf_hz       = 0;   // SatPlan 그룹 CF (겹치는 계획 항목 전부 포함, 0 = 없음)
     };
     static constexpr float SCHED_PRE_ARM_SEC = 5.0f;
     std::vector<SchedEntry> sched_entries;
     std::mutex              sched_mtx;
-    int   sched_active_idx  = -1;
+    // ARMED/RECORDING 엔트리 (uid, 채널 슬롯). 같은 SDR 튜닝 안에 들어가면 여러 개 동시.
+    // 인덱스 대신 uid — UI/Central 에서 리스트가 바뀌어도 활성 엔트리를 잃지 않음.
+    std::vector<std::pair<uint32_t,int>> sched_active;
+    std::vector<std::pair<time_t,uint32_t>> sched_heap;   // WAITING start_time min-heap
+    uint64_t sched_heap_sig = 0;     // 힙 구성 당시 (uid, start_time, status) 서명 — 제자리 수정도 감지
+    uint32_t sched_uid_next = 1;
     float sched_saved_cf    = 0;
     bool  sched_panel_open  = false;
     void sched_tick();
-    void sched_arm_entry(int idx);
+    void sched_arm_entry(int idx, double cf_hz);
     void sched_begin_rec(int idx);
     void sched_stop_entry(int idx);
+    int  sched_find(uint32_t uid) const;
+    void sched_index_locked();
+    bool sched_fits_locked(const SchedEntry& e, double& cf_hz) const;
+    void sched_release_locked(uint32_t uid);
+    // 위성 패스 자동 예약 (~/BE_WE/sat_downlinks.txt 가 있을 때만)
+    static constexpr int   SCHED_PLAN_LEAD_SEC    = 120;        // 시작 이만큼 전에 SchedEntry 로
+    static constexpr int   SCHED_PLAN_REFRESH_SEC = 6 * 3600;   // 재계획 주기 (24 h 창)
+    static constexpr int   SCHED_PLAN_MAX_SLOTS   = 4;          // 동시 녹음 채널 상한
+    std::shared_ptr<SatPlan::Queue> sched_plan;
+    std::thread                     sched_plan_thr;   // replan 워커 (소멸자에서 cancel + join)
+    void sched_plan_poll_locked(time_t now);
     // Overlap 검사 — [start, start+dur)이 기존 WAITING/RECORDING entry와 겹치는지 (sched_mtx 잡은 채로 호출)
     bool sched_has_overlap(time_t start, float dur) const;
     // 전체 sched 리스트를 JOIN 클라이언트에 브로드캐스트 (SCHED_SYNC)
@@ -456,20 +551,21 @@ public:
     // 뷰 모드: 0=Signal(envelope), 1=I/Q, 2=Phase, 3=Frequency
     int eid_view_mode = 0;
 
-    // envelope 데이터
-    std::vector<float> eid_envelope;       // sqrt(I²+Q²), 전체 샘플
+    // 샘플 저장소: 녹음 파일 mmap + piece table (eid_store.hpp)
+    EidStore::Samples  eid_iq;
     std::mutex         eid_data_mtx;
     std::atomic<bool>  eid_data_ready{false};
     int64_t            eid_total_samples = 0;
     uint32_t           eid_sample_rate   = 0;
+    // 파생 채널은 보이는/분석 구간만 chunk 단위로 계산 (UI 스레드 전용)
+    EidStore::Derived  eid_derived{&eid_iq, &eid_sample_rate, &eid_is_iq};
 
-    // I/Q 분리 데이터
-    std::vector<float> eid_ch_i;       // I(t) normalized
-    std::vector<float> eid_ch_q;       // Q(t) normalized
-
-    // 순시 위상/주파수
-    std::vector<float> eid_phase;      // atan2(Q,I)
-    std::vector<float> eid_inst_freq;  // d(phase)/dt
+    // vector 호환 view — ch[s], size(), empty()
+    EidStore::Channel  eid_ch_i     {&eid_iq, &eid_derived, EidStore::CH_I};     // I(t) normalized
+    EidStore::Channel  eid_ch_q     {&eid_iq, &eid_derived, EidStore::CH_Q};     // Q(t) normalized
+    EidStore::Channel  eid_envelope {&eid_iq, &eid_derived, EidStore::CH_ENV};   // sqrt(I²+Q²)
+    EidStore::Channel  eid_phase    {&eid_iq, &eid_derived, EidStore::CH_PHASE}; // atan2(Q,I)
+    EidStore::Channel  eid_inst_freq{&eid_iq, &eid_derived, EidStore::CH_FREQ};  // d(phase)/dt (Hz)
 
     float eid_phase_detrend_hz = 0.0f;  // sweep line 주파수 오프셋 (Hz)
 
@@ -553,15 +649,14 @@ public:
     struct SaViewEntry { float x0,x1,y0,y1; bool had_bpf; };
     std::vector<SaViewEntry> sa_view_history;
 
-    // BPF 상태 (원본 IQ 백업 + 필터 상태)
-    std::vector<float> eid_orig_ch_i;   // 필터 전 원본 I
-    std::vector<float> eid_orig_ch_q;   // 필터 전 원본 Q
+    // BPF 상태 (원본 IQ 백업 + 필터 상태) — piece table 이라 백업은 버퍼 공유
+    EidStore::Samples eid_orig_iq;      // 필터 전 원본 I/Q
     bool eid_bpf_active = false;
 
     // ── Undo/Redo 시스템 ──────────────────────────────────────────────
+    // 샘플은 piece table 스냅샷만 저장 (불변 버퍼 공유) — 파생 채널은 저장하지 않음.
     struct EidUndoEntry {
-        std::vector<float> envelope, ch_i, ch_q, phase, inst_freq;
-        std::vector<float> orig_ch_i, orig_ch_q;
+        EidStore::Samples iq, orig_iq;
         std::vector<EidTag> tags;
         std::vector<std::pair<double,double>> view_stack;
         std::vector<SaViewEntry> sa_history;
@@ -627,16 +722,13 @@ public:
     std::vector<float> current_spectrum;
     int   cached_sp_idx=-1; float cached_pan=-999, cached_zoom=-999;
     int   cached_px=-1;     float cached_pmin=-999, cached_pmax=-999;
-    // autoscale: 고정 크기 순환 버퍼 (push_back per FFT 제거)
-    // 최대 fft_size*100 샘플 고정 → nth_element 시 재할당 없음
-    std::vector<float> autoscale_accum;
-    size_t             autoscale_wp=0;   // 순환 버퍼 write pointer
-    bool               autoscale_buf_full=false;
+    // autoscale: 행 dB 분포 스트리밍 히스토그램 (행당 O(fft_size) 누적, 분위 조회 O(1))
+    QuantileSketch     autoscale_hist;
     std::chrono::steady_clock::time_point autoscale_last;
     std::chrono::steady_clock::time_point autoscale_check_last{};  // 10s 천장초과 감시 타이머
     bool  autoscale_init=false, autoscale_active=true;
     // 비-캡처 스레드(set_frequency/init)가 autoscale 재트리거를 요청 → 캡처 스레드가 처리.
-    // autoscale_accum/active/init 를 캡처 스레드 밖에서 직접 건드리면 레이스 → 이 플래그로 위임.
+    // autoscale_hist/active/init 를 캡처 스레드 밖에서 직접 건드리면 레이스 → 이 플래그로 위임.
     std::atomic<bool> autoscale_req{false};
     std::atomic<bool> spectrum_pause{false};
 
@@ -869,6 +961,12 @@ public:
     std::atomic<uint64_t> rec_frames{0};
     std::chrono::steady_clock::time_point rec_t0;
 
+    // ── 채널 녹음 I/O 스레드 (RecRing drain → int16 변환 → AsyncIO) ───────
+    std::thread             rec_io_thr;
+    std::atomic<bool>       rec_io_stop{false};
+    std::mutex              rec_io_mtx;
+    std::condition_variable rec_io_cv;
+
     // ── Audio mix ─────────────────────────────────────────────────────────
     std::atomic<bool> mix_stop{false};
     std::thread       mix_thr;
@@ -908,12 +1006,24 @@ public:
     void capture_and_process();
     void capture_and_process_rtl();
     void capture_and_process_pluto();
+    bool initialize_replay(float cf_mhz);   // g_replay 소스 (replay.hpp) — cf_mhz 는 합성 소스용
+    void capture_and_process_replay();
+    // capture_common.cpp — 전 백엔드 공통 hot path (ring write / FFT 누적 / 행 commit)
+    void iq_ring_write(const int16_t* iq, size_t n);
+    void fft_accumulate(float* pacc);
+    void fft_commit_row(float* pacc, int fcnt);
+    // host_metrics.cpp — /metrics collector (ring lag / 스레드 CPU / 레코드) + STATS 요약
+    int  metrics_col = 0;
+    void metrics_install();         // collector 등록 + HTTP 시작 (HOST/replay 진입 시 1회)
+    void metrics_remove();          // 소멸자에서 호출
+    void stats_fill(PktStats& st);  // 5s 주기 (rate 는 직전 호출 대비)
     void set_frequency(float cf_mhz);
     void set_gain(float db);
     float gain_db = 0.0f;
 
     // ── 채널 스컬치 (UI 스레드, FFT 기반) ──────────────────────────────────
     int  sq_last_total_ffts = -1;   // new-row guard: 같은 FFT 행 재스캔 방지
+    std::chrono::steady_clock::time_point sq_last_tick = std::chrono::steady_clock::now();
     void update_channel_squelch();
 
     // ── demod.cpp ─────────────────────────────────────────────────────────
@@ -933,6 +1043,9 @@ public:
     void start_iq_rec(int ch_idx);
     void stop_iq_rec(int ch_idx);
     void iq_only_worker(int ch_idx);  // demod 우회 IQ-only 녹음 worker
+    void rec_io_worker();             // 채널 audio/IQ 녹음 파일 쓰기·마감 전담
+    void rec_io_open(std::atomic<int>& io);    // 스레드 기동 + OPEN
+    void rec_io_close(std::atomic<int>& io);   // CLOSE 요청 → 마감 완료까지 대기
 
     void start_join_audio_rec(int ch_idx); // JOIN 모드 로컬 오디오 녹음
     void stop_join_audio_rec(int ch_idx);
@@ -943,6 +1056,7 @@ public:
     // ── fft_viewer.cpp (waterfall + display helpers) ──────────────────────
     void create_waterfall_texture();
     void update_wf_row(int fi);
+    void render_waterfall(int w, int h, int top_row, float d0, float d1);
     void get_disp(float& ds, float& de) const;
     float x_to_abs(float x, float gx, float gw) const;
     float abs_to_x(float abs_mhz, float gx, float gw) const;
@@ -0,0 +1,125 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Level-of-detail polylines for the vector map layers (globe coastlines, 2D map OSM).
+//
+// Input is the generated map format: interleaved lat,lon floats, NAN,NAN between
+// polylines. build() runs Douglas–Peucker once per tolerance and keeps every level
+// in one flat array with per-line offsets + bbox, so a renderer can upload it once
+// (VBO) or cull lines against the view without touching the points.
+//
+// Tolerances are degrees of latitude; longitude is scaled by cos(lat) of the line's
+// first point so a tolerance means the same screen distance in both axes. At eps > 0
+// lines whose bbox is smaller than eps (islets, short fragments) are dropped.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace GeoLod {
+
+struct Line {
+    int   start = 0, count = 0;             // in points (pts index / 2)
+    float lat0 = 0, lat1 = 0, lon0 = 0, lon1 = 0;
+};
+
+struct Level {
+    float             eps_deg = 0;
+    std::vector<float> pts;                 // lat,lon interleaved
+    std::vector<Line>  lines;
+};
+
+// Douglas–Peucker keep-mask for n points (iterative, endpoints always kept).
+inline void dp_mask(const float* ll, int n, float eps, std::vector<unsigned char>& keep) {
+    keep.assign(n, 0);
+    if (n <= 0) return;
+    keep[0] = keep[n - 1] = 1;
+    if (n < 3 || eps <= 0.f) { keep.assign(n, 1); return; }
+    float kx = std::cos(ll[0] * (float)M_PI / 180.f);
+    float eps2 = eps * eps;
+    std::vector<std::pair<int,int>> st;
+    st.push_back({0, n - 1});
+    while (!st.empty()) {
+        auto [a, b] = st.back(); st.pop_back();
+        if (b - a < 2) continue;
+        float ay = ll[2*a], ax = ll[2*a+1] * kx;
+        float by = ll[2*b], bx = ll[2*b+1] * kx;
+        float dx = bx - ax, dy = by - ay, L2 = dx*dx + dy*dy;
+        int   imax = -1; float dmax = -1.f;
+        for (int i = a + 1; i < b; i++) {
+            float py = ll[2*i] - ay, px = ll[2*i+1] * kx - ax;
+            float d2;
+            if (L2 > 0.f) { float c = px*dy - py*dx; d2 = c * c / L2; }   // closed ring: a == b
+            else            d2 = px*px + py*py;
+            if (d2 > dmax) { dmax = d2; imax = i; }
+        }
+        if (dmax > eps2) {
+            keep[imax] = 1;
+            st.push_back({a, imax});
+            st.push_back({imax, b});
+        }
+    }
+}
+
+// eps[] ascending. split_dlon > 0 → also break a line where |Δlon| exceeds it
+// (antimeridian crossing on the globe).
+inline std::vector<Level> build(const float* data, int count, const float* eps, int n_eps,
+                                float split_dlon = 0.f) {
+    // split into polylines once
+    std::vector<std::pair<int,int>> runs;   // [first, last) in points
+    {
+        int n = count / 2, s = -1;
+        for (int i = 0; i < n; i++) {
+            float la = data[2*i], lo = data[2*i+1];
+            if (std::isnan(la) || std::isnan(lo)) {
+                if (s >= 0 && i - s > 1) runs.push_back({s, i});
+                s = -1; continue;
+            }
+            if (s >= 0 && split_dlon > 0.f) {
+                float d = lo - data[2*i-1];
+                if (d >  180.f) d -= 360.f;
+                if (d < -180.f) d += 360.f;
+                if (std::fabs(d) > split_dlon) {
+                    if (i - s > 1) runs.push_back({s, i});
+                    s = i; continue;
+                }
+            }
+            if (s < 0) s = i;
+        }
+        if (s >= 0 && n - s > 1) runs.push_back({s, n});
+    }
+
+    std::vector<Level> out(n_eps);
+    std::vector<unsigned char> keep;
+    for (int k = 0; k < n_eps; k++) {
+        Level& L = out[k];
+        L.eps_deg = eps[k];
+        for (auto& r : runs) {
+            const float* ll = data + 2 * r.first;
+            int n = r.second - r.first;
+            Line ln;
+            ln.lat0 = ln.lat1 = ll[0]; ln.lon0 = ln.lon1 = ll[1];
+            for (int i = 1; i < n; i++) {
+                ln.lat0 = std::fmin(ln.lat0, ll[2*i]);   ln.lat1 = std::fmax(ln.lat1, ll[2*i]);
+                ln.lon0 = std::fmin(ln.lon0, ll[2*i+1]); ln.lon1 = std::fmax(ln.lon1, ll[2*i+1]);
+            }
+            if (eps[k] > 0.f && ln.lat1 - ln.lat0 < eps[k] && ln.lon1 - ln.lon0 < eps[k]) continue;
+            dp_mask(ll, n, eps[k], keep);
+            ln.start = (int)(L.pts.size() / 2);
+            for (int i = 0; i < n; i++)
+                if (keep[i]) { L.pts.push_back(ll[2*i]); L.pts.push_back(ll[2*i+1]); }
+            ln.count = (int)(L.pts.size() / 2) - ln.start;
+            L.lines.push_back(ln);
+        }
+    }
+    return out;
+}
+
+// Coarsest level whose tolerance stays under px_tol screen pixels.
+inline int pick(const std::vector<Level>& L, double deg_per_px, double px_tol = 0.5) {
+    int best = 0;
+    for (int k = 0; k < (int)L.size(); k++)
+        if (L[k].eps_deg <= deg_per_px * px_tol) best = k;
+    return best;
+}
+
+} // namespace GeoLod
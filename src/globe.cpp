@@ -1,10 +1,12 @@
 #include "globe.hpp"
 #include "world_map_data.hpp"
+#include "geo_lod.hpp"
 #include "bewe_paths.hpp"
 extern void bewe_log_push(int col, const char* fmt, ...);
 #include <GL/glew.h>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
@@ -94,6 +96,63 @@ void main(){
 }
 )GLSL";
 
+// ── Point markers (instanced) ─────────────────────────────────────────────
+// One quad per instance, expanded in screen pixels around the projected centre.
+// Globe occlusion is the analytic ray/sphere test of project_world() (camera at
+// uCam), so markers need no depth test. The fragment shader composites the
+// 8-ring glow + white core the ImGui path used to draw as 9 circles per marker.
+static const char* MARKER_VERT = R"GLSL(
+#version 330 core
+layout(location=0) in vec3  iPos;
+layout(location=1) in vec4  iCol;
+layout(location=2) in float iSize;
+uniform mat4 uMVP;
+uniform vec3 uCam;
+uniform vec2 uVP;
+out vec2  vOff;
+out vec4  vCol;
+out float vR;
+const vec2 CORNER[4] = vec2[4](vec2(-1.0,-1.0), vec2(1.0,-1.0), vec2(-1.0,1.0), vec2(1.0,1.0));
+void main(){
+    vec3  D    = iPos - uCam;
+    float OD   = dot(uCam, D), DD = dot(D, D);
+    float disc = OD*OD - DD*(dot(uCam, uCam) - 1.0);
+    bool  hid  = false;
+    if (disc > 0.0) { float t = (-OD - sqrt(disc)) / DD; hid = t > 0.0 && t < 1.0; }
+    vec4 c = uMVP * vec4(iPos, 1.0);
+    if (hid || c.w <= 0.0) { gl_Position = vec4(2.0, 2.0, 2.0, 1.0); return; }   // clipped
+    vec2 o = CORNER[gl_VertexID];
+    float r = iSize + 1.0;                        // +1 px for the AA edge
+    vOff = o * r; vCol = iCol; vR = iSize;
+    c.xy += o * r * 2.0 / uVP * c.w;
+    gl_Position = c;
+}
+)GLSL";
+
+static const char* MARKER_FRAG = R"GLSL(
+#version 330 core
+in  vec2  vOff;
+in  vec4  vCol;
+in  float vR;
+out vec4  FragColor;
+void main(){
+    float d   = length(vOff);
+    float rin = vR / 6.0;
+    float tr  = 1.0;                              // transmittance through the 8 rings
+    for (int k = 0; k < 8; k++) {
+        float t = float(k) / 7.0;
+        float a = (240.0 * (1.0 - t) * (1.0 - t) + 15.0) / 255.0;
+        tr *= 1.0 - a * clamp(mix(rin, vR, t) - d + 0.5, 0.0, 1.0);
+    }
+    float core = 0.9 * clamp(rin - d + 0.5, 0.0, 1.0);
+    float a    = 1.0 - tr;
+    vec3  col  = mix(vCol.rgb, vec3(1.0), core);
+    a = 1.0 - (1.0 - a) * (1.0 - core);
+    if (a <= 0.004) discard;
+    FragColor = vec4(col, a * vCol.a);
+}
+)GLSL";
+
 // ── Sky background ────────────────────────────────────────────────────────
 // Reuses vao_sphere_. The unit sphere is scaled up (×100) and pushed to the
 // far plane (gl_Position.z = w) so it always sits behind the globe regardless
@@ -174,7 +233,8 @@ bool GlobeRenderer::init() {
     prog_lines_  = compile_shader(LINES_VERT, LINES_FRAG);
     prog_land_   = compile_shader(LAND_VERT,  LAND_FRAG);
     prog_sky_    = compile_shader(SKY_VERT,   SKY_FRAG);
-    if (!prog_sphere_ || !prog_lines_ || !prog_land_ || !prog_sky_) return false;
+    prog_marker_ = compile_shader(MARKER_VERT, MARKER_FRAG);
+    if (!prog_sphere_ || !prog_lines_ || !prog_land_ || !prog_sky_ || !prog_marker_) return false;
     loc_sky_proj_      = glGetUniformLocation(prog_sky_,    "uProj");
     loc_sky_viewrot_   = glGetUniformLocation(prog_sky_,    "uViewRot");
     loc_sphere_mvp_    = glGetUniformLocation(prog_sphere_, "uMVP");
@@ -182,9 +242,13 @@ bool GlobeRenderer::init() {
     loc_sphere_hastex_ = glGetUniformLocation(prog_sphere_, "uHasTex");
     loc_land_mvp_      = glGetUniformLocation(prog_land_,   "uMVP");
     loc_lines_mvp_     = glGetUniformLocation(prog_lines_,  "uMVP");
+    loc_marker_mvp_    = glGetUniformLocation(prog_marker_, "uMVP");
+    loc_marker_cam_    = glGetUniformLocation(prog_marker_, "uCam");
+    loc_marker_vp_     = glGetUniformLocation(prog_marker_, "uVP");
     build_sphere(64, 128);
     build_land();
     build_map_lines();
+    build_markers();
     load_earth_texture();
     // Default orientation: screen center = 38N 127E, north pole straight up
     // col2=pick-fwd(38N,-127lon), col1=Gram-Schmidt(north,fwd), col0=cross(col1,col2)
@@ -207,12 +271,16 @@ void GlobeRenderer::destroy() {
     if (vbo_lines_)  { glDeleteBuffers(1, &vbo_lines_); vbo_lines_=0; }
     if (vao_land_)   { glDeleteVertexArrays(1, &vao_land_); vao_land_=0; }
     if (vbo_land_)   { glDeleteBuffers(1, &vbo_land_); vbo_land_=0; }
+    if (vao_marker_) { glDeleteVertexArrays(1, &vao_marker_); vao_marker_=0; }
+    if (vbo_marker_) { glDeleteBuffers(1, &vbo_marker_); vbo_marker_=0; }
     if (tex_earth_)  { glDeleteTextures(1, &tex_earth_); tex_earth_=0; }
     if (prog_sphere_){ glDeleteProgram(prog_sphere_); prog_sphere_=0; }
     if (prog_lines_) { glDeleteProgram(prog_lines_); prog_lines_=0; }
     if (prog_land_)  { glDeleteProgram(prog_land_); prog_land_=0; }
     if (prog_sky_)   { glDeleteProgram(prog_sky_); prog_sky_=0; }
-    seg_starts_.clear(); seg_counts_.clear();
+    if (prog_marker_){ glDeleteProgram(prog_marker_); prog_marker_=0; }
+    lod_eps_.clear(); lod_starts_.clear(); lod_counts_.clear();
+    marker_n_ = marker_cap_ = 0;
 }
 
 void GlobeRenderer::set_viewport(int w, int h) {
@@ -277,22 +345,75 @@ void GlobeRenderer::render() {
     }
 
     // 3. Draw map lines only when no texture (texture already shows coastlines)
-    if (!tex_earth_) {
+    //    LOD: surface distance (zoom_ - 1) → degrees per pixel at screen centre,
+    //    coarsest level that stays under half a pixel.
+    if (!tex_earth_ && !lod_eps_.empty()) {
+        float px_per_unit = (0.5f * vp_h_) / (tanf(22.5f * (float)M_PI / 180.f) * (zoom_ - 1.f));
+        float deg_per_px  = (180.f / (float)M_PI) / px_per_unit;
+        lod_cur_ = 0;
+        for (int k = 0; k < (int)lod_eps_.size(); k++)
+            if (lod_eps_[k] <= deg_per_px * 0.5f) lod_cur_ = k;
+
         glUseProgram(prog_lines_);
         glUniformMatrix4fv(loc_lines_mvp_, 1, GL_FALSE, mvp);
 
         glBindVertexArray(vao_lines_);
-        if (!seg_starts_.empty())
+        if (!lod_starts_[lod_cur_].empty())
             glMultiDrawArrays(GL_LINE_STRIP,
-                              seg_starts_.data(),
-                              seg_counts_.data(),
-                              (GLsizei)seg_starts_.size());
+                              lod_starts_[lod_cur_].data(),
+                              lod_counts_[lod_cur_].data(),
+                              (GLsizei)lod_starts_[lod_cur_].size());
         glBindVertexArray(0);
     }
 
     glUseProgram(0);
 }
 
+// ── Markers ───────────────────────────────────────────────────────────────
+
+void GlobeRenderer::set_markers(const Marker* m, int n) {
+    if (!vbo_marker_) return;
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_marker_);
+    if (n > marker_cap_) {
+        marker_cap_ = std::max(n, marker_cap_ * 2);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)marker_cap_ * sizeof(Marker),
+                     nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (n > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)n * sizeof(Marker), m);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    marker_n_ = n;
+}
+
+void GlobeRenderer::draw_markers() {
+    if (!prog_marker_ || marker_n_ <= 0) return;
+    float mvp[16];
+    get_mvp(mvp);
+    float cam[3] = { 2*(qx_*qz_ + qw_*qy_) * zoom_,
+                     2*(qy_*qz_ - qw_*qx_) * zoom_,
+                     (1 - 2*(qx_*qx_ + qy_*qy_)) * zoom_ };
+    GLboolean depth_was = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend_was = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glUseProgram(prog_marker_);
+    glUniformMatrix4fv(loc_marker_mvp_, 1, GL_FALSE, mvp);
+    glUniform3fv(loc_marker_cam_, 1, cam);
+    glUniform2f(loc_marker_vp_, (float)vp_w_, (float)vp_h_);
+    glBindVertexArray(vao_marker_);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, marker_n_);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    if (!blend_was) glDisable(GL_BLEND);
+    if (depth_was)  glEnable(GL_DEPTH_TEST);
+}
+
+uint32_t GlobeRenderer::view_version() const {
+    if (mvp_dirty_) { float m[16]; get_mvp(m); }
+    return view_ver_;
+}
+
 // ── Mouse interaction ─────────────────────────────────────────────────────
 
 bool GlobeRenderer::screen_to_arcball(float mx, float my,
@@ -649,6 +770,7 @@ void GlobeRenderer::get_mvp(float* mvp) const {
         // mvp = proj * view
         mat4_mul(mvp_cache_, proj, view);
         mvp_dirty_ = false;
+        view_ver_++;
     }
     memcpy(mvp, mvp_cache_, 64);
 }
@@ -759,56 +881,26 @@ void GlobeRenderer::build_sphere(int stacks, int slices) {
 }
 
 void GlobeRenderer::build_map_lines() {
+    // Natural Earth 110m is ~0.1–1° between points — levels only matter zoomed out.
+    // 180° 안티메리디안 교차 (인접 두 점 경도 차 > 170°) → 세그먼트 분할
+    static const float EPS[] = { 0.f, 0.1f, 0.3f, 0.8f };
+    std::vector<GeoLod::Level> lv = GeoLod::build(WORLD_MAP_DATA, WORLD_MAP_DATA_COUNT,
+                                                  EPS, 4, 170.f);
     std::vector<float> verts;
-
-    GLint current_start = 0;
-    int   current_count = 0;
-    bool  in_segment    = false;
-    float prev_lon      = 0.f;
-
-    for (int i = 0; i + 1 < WORLD_MAP_DATA_COUNT; i += 2) {
-        float lat = WORLD_MAP_DATA[i];
-        float lon = WORLD_MAP_DATA[i+1];
-
-        if (std::isnan(lat) || std::isnan(lon)) {
-            // End of segment
-            if (in_segment && current_count > 0) {
-                seg_starts_.push_back(current_start);
-                seg_counts_.push_back((GLsizei)current_count);
-            }
-            current_start = (GLint)(verts.size() / 3);
-            current_count = 0;
-            in_segment = false;
-            prev_lon = 0.f;
-        } else {
-            // 180° 안티메리디안 교차 감지: 인접 두 점 경도 차 > 180° → 세그먼트 분할
-            if (in_segment) {
-                float dlon = lon - prev_lon;
-                if (dlon >  180.f) dlon -= 360.f;
-                if (dlon < -180.f) dlon += 360.f;
-                if (fabsf(dlon) > 170.f) {
-                    // 현재 세그먼트 저장 후 새 세그먼트 시작
-                    if (current_count > 0) {
-                        seg_starts_.push_back(current_start);
-                        seg_counts_.push_back((GLsizei)current_count);
-                    }
-                    current_start = (GLint)(verts.size() / 3);
-                    current_count = 0;
-                }
-            }
+    lod_eps_.clear(); lod_starts_.assign(lv.size(), {}); lod_counts_.assign(lv.size(), {});
+    for (size_t k = 0; k < lv.size(); k++) {
+        GLint base = (GLint)(verts.size() / 3);
+        lod_eps_.push_back(lv[k].eps_deg);
+        for (const GeoLod::Line& ln : lv[k].lines) {
+            lod_starts_[k].push_back(base + ln.start);
+            lod_counts_[k].push_back((GLsizei)ln.count);
+        }
+        for (size_t i = 0; i + 1 < lv[k].pts.size(); i += 2) {
             float x, y, z;
-            latlon_to_xyz(lat, lon, x, y, z);
+            latlon_to_xyz(lv[k].pts[i], lv[k].pts[i+1], x, y, z);
             verts.push_back(x); verts.push_back(y); verts.push_back(z);
-            current_count++;
-            in_segment = true;
-            prev_lon = lon;
         }
     }
-    // Flush final segment
-    if (in_segment && current_count > 0) {
-        seg_starts_.push_back(current_start);
-        seg_counts_.push_back((GLsizei)current_count);
-    }
 
     glGenVertexArrays(1, &vao_lines_);
     glGenBuffers(1, &vbo_lines_);
@@ -824,8 +916,27 @@ void GlobeRenderer::build_map_lines() {
                           3*sizeof(float), (void*)0);
     glBindVertexArray(0);
 
-    bewe_log_push(1,"[Globe] map lines: %zu segments, %zu vertices\n",
-           seg_starts_.size(), verts.size()/3);
+    for (size_t k = 0; k < lv.size(); k++)
+        bewe_log_push(1,"[Globe] map lines LOD%zu (eps %.2f deg): %zu segments, %zu vertices\n",
+               k, lod_eps_[k], lod_starts_[k].size(), lv[k].pts.size()/2);
+}
+
+void GlobeRenderer::build_markers() {
+    glGenVertexArrays(1, &vao_marker_);
+    glGenBuffers(1, &vbo_marker_);
+    glBindVertexArray(vao_marker_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_marker_);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Marker), (void*)offsetof(Marker, x));
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Marker), (void*)offsetof(Marker, rgba));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(Marker), (void*)offsetof(Marker, size));
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void GlobeRenderer::build_land() {
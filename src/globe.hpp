@@ -1,5 +1,6 @@
 #pragma once
 #include <GL/glew.h>
+#include <cstdint>
 #include <vector>
 
 // ── GlobeRenderer ─────────────────────────────────────────────────────────
@@ -24,6 +25,9 @@
 //   // project to screen:
 //   float sx, sy;
 //   if (globe.project(lat, lon, sx, sy)) { ... }
+//   // point markers (one instanced draw; upload only when they change):
+//   globe.set_markers(m.data(), (int)m.size());
+//   globe.draw_markers();        // after render(), before ImGui
 
 class GlobeRenderer {
 public:
@@ -49,12 +53,24 @@ public:
 
     float get_zoom() const { return zoom_; }
 
+    // Bumped on every camera / viewport change — callers key screen-space caches on it.
+    uint32_t view_version() const;
+
+    // Glow marker (world space like project_world). rgba = IM_COL32 layout (A<<24|B<<16|G<<8|R),
+    // size = outer radius in px. Occluded by the globe in the shader, no depth test.
+    struct Marker { float x, y, z; uint32_t rgba; float size; };
+    void set_markers(const Marker* m, int n);
+    void draw_markers();
+    int  marker_count() const { return marker_n_; }
+    int  line_level()   const { return lod_cur_; }   // coastline LOD used by the last render()
+
 private:
     // OpenGL objects
     GLuint prog_sphere_ = 0;
     GLuint prog_lines_  = 0;
     GLuint prog_land_   = 0;
     GLuint prog_sky_    = 0;
+    GLuint prog_marker_ = 0;
     GLuint vao_sphere_  = 0;
     GLuint vbo_sphere_  = 0;
     GLuint ebo_sphere_  = 0;
@@ -62,13 +78,18 @@ private:
     GLuint vbo_lines_   = 0;
     GLuint vao_land_    = 0;
     GLuint vbo_land_    = 0;
+    GLuint vao_marker_  = 0;
+    GLuint vbo_marker_  = 0;   // per-instance Marker
     GLuint tex_earth_   = 0;   // Blue Marble texture
     GLint  idx_count_   = 0;
     GLint  land_vtx_count_ = 0;
+    int    marker_n_ = 0, marker_cap_ = 0;
 
-    // Map line segment boundaries for glMultiDrawArrays
-    std::vector<GLint>   seg_starts_;
-    std::vector<GLsizei> seg_counts_;
+    // Map line LOD levels (one VBO, level k = lod_starts_[k]/lod_counts_[k] for glMultiDrawArrays)
+    std::vector<float>                lod_eps_;
+    std::vector<std::vector<GLint>>   lod_starts_;
+    std::vector<std::vector<GLsizei>> lod_counts_;
+    int                               lod_cur_ = 0;
 
     // Camera state
     float qw_ = 1.f, qx_ = 0.f, qy_ = 0.f, qz_ = 0.f;
@@ -80,6 +101,7 @@ private:
     // MVP cache — qw_..qz_/zoom_/vp 변경 시 mvp_dirty_ 세팅 필수
     mutable float mvp_cache_[16];
     mutable bool  mvp_dirty_ = true;
+    mutable uint32_t view_ver_ = 0;
 
     // Uniform locations (fetched once in init())
     GLint loc_sky_proj_      = -1;
@@ -89,6 +111,9 @@ private:
     GLint loc_sphere_hastex_ = -1;
     GLint loc_land_mvp_      = -1;
     GLint loc_lines_mvp_     = -1;
+    GLint loc_marker_mvp_    = -1;
+    GLint loc_marker_cam_    = -1;
+    GLint loc_marker_vp_     = -1;
 
     // Drag
     float drag_ax_ = 0.f, drag_ay_ = 0.f, drag_az_ = 0.f;
@@ -113,6 +138,7 @@ private:
     void   build_sphere(int stacks, int slices);
     void   build_map_lines();
     void   build_land();
+    void   build_markers();
     bool   load_earth_texture();
     GLuint compile_shader(const char* vsrc, const char* fsrc);
 };
@@ -0,0 +1,95 @@
+#include "fft_viewer.hpp"
+#include "metrics.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
+#include <map>
+
+// ── HOST 메트릭: scrape 시점 collector + JOIN 용 STATS 요약 ─────────────────
+// hot path 카운터는 각 지점에 직접 (bladerf_io / capture_common / demod / net_server).
+// 여기는 주기적으로만 읽어도 되는 값 — ring lag, 스레드 CPU, 모듈 레코드.
+
+int g_metrics_port = 9771;
+
+void FFTViewer::metrics_install(){
+    if(metrics_col) return;
+    metrics_col = Metrics::collector_add([this](Metrics::Writer& w){
+        size_t wp = ring_wp.load(std::memory_order_acquire);
+        w.family("bewe_ring_capacity_samples", "gauge", "IQ ring capacity (samples)");
+        w.sample("bewe_ring_capacity_samples", "", (double)IQ_RING_CAPACITY);
+        w.family("bewe_ring_lag_samples", "gauge", "IQ ring reader lag behind ring_wp (samples)");
+        for(auto& [name, lag] : PipeStats::lags(wp))
+            w.sample("bewe_ring_lag_samples", Metrics::label("reader", name), (double)lag);
+        w.family("bewe_sdr_sample_rate_hz", "gauge", "Current capture sample rate");
+        w.sample("bewe_sdr_sample_rate_hz", "", (double)header.sample_rate);
+
+        w.family("bewe_thread_cpu_seconds_total", "counter", "Per-thread CPU time (utime+stime)");
+        for(auto& t : PipeStats::thread_cpu())
+            w.sample("bewe_thread_cpu_seconds_total",
+                     Metrics::label("thread", t.name) + ",tid=\"" + std::to_string(t.tid) + "\"", t.cpu_s);
+        w.family("bewe_process_cpu_seconds_total", "counter", "Process CPU time (utime+stime)");
+        w.sample("bewe_process_cpu_seconds_total", "", PipeStats::process_cpu_s());
+
+        w.family("bewe_module_records_total", "counter", "Decoded module records (bewe_mod_emit)");
+        for(auto& [id, n] : PipeStats::records())
+            w.sample("bewe_module_records_total", Metrics::label("mod", id), (double)n);
+    });
+    Trace::http_install();   // /trace 경로 (BEWE_TRACE=1 이면 이미 on)
+    Metrics::http_start(g_metrics_port);
+}
+
+void FFTViewer::metrics_remove(){
+    if(!metrics_col) return;
+    Metrics::collector_del(metrics_col);
+    metrics_col = 0;
+    Metrics::http_stop();
+}
+
+void FFTViewer::stats_fill(PktStats& st){
+    memset(&st, 0, sizeof(st));
+    st.rx_overruns   = (uint64_t)Metrics::sum("bewe_sdr_rx_overruns_total");
+    st.rx_lost       = (uint64_t)Metrics::sum("bewe_sdr_rx_lost_samples_total");
+    st.net_drops     = (uint64_t)Metrics::sum("bewe_net_drops_total");
+    st.dem_skipped   = (uint64_t)Metrics::sum("bewe_demod_skipped_samples_total");
+    st.ring_lag_max  = (uint32_t)PipeStats::max_lag(ring_wp.load(std::memory_order_acquire));
+    st.ring_capacity = IQ_RING_CAPACITY;
+    if(net_srv){
+        NetServer::NetStats ns = net_srv->collect_stats();
+        st.q_fft   = (uint32_t)ns.q_fft;
+        st.q_audio = (uint32_t)ns.q_audio;
+    }
+
+    // rate: 직전 호출 대비 (메인 루프 단일 스레드에서만 호출)
+    using clk = std::chrono::steady_clock;
+    static clk::time_point      t_prev;
+    static bool                 have_prev = false;
+    static uint64_t             rec_prev  = 0;
+    static double               cpu_prev  = 0;
+    static std::map<int,double> thr_prev;
+
+    clk::time_point now = clk::now();
+    uint64_t rec = 0;
+    for(auto& r : PipeStats::records()) rec += r.second;
+    double cpu = PipeStats::process_cpu_s();
+    auto threads = PipeStats::thread_cpu();
+
+    double dt = have_prev ? std::chrono::duration<double>(now - t_prev).count() : 0.0;
+    if(dt > 0.5){
+        st.records_x10  = (uint32_t)((rec - rec_prev) * 10.0 / dt);
+        st.proc_cpu_x10 = (uint16_t)std::min(65535.0, (cpu - cpu_prev) * 1000.0 / dt);
+        double best = -1;
+        for(auto& t : threads){
+            auto it = thr_prev.find(t.tid);
+            if(it == thr_prev.end()) continue;
+            double d = t.cpu_s - it->second;
+            if(d > best){
+                best = d;
+                strncpy(st.top_thread, t.name.c_str(), sizeof(st.top_thread)-1);
+            }
+        }
+        if(best > 0) st.top_cpu_x10 = (uint16_t)std::min(65535.0, best * 1000.0 / dt);
+    }
+    t_prev = now; have_prev = true;
+    rec_prev = rec; cpu_prev = cpu;
+    thr_prev.clear();
+    for(auto& t : threads) thr_prev[t.tid] = t.cpu_s;
+}
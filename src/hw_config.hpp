@@ -3,7 +3,7 @@
 #include <cstdlib>  // abs(int)
 
 // ── 하드웨어 타입 ──────────────────────────────────────────────────────────
-enum class HWType { NONE, BLADERF, RTLSDR, PLUTO };
+enum class HWType { NONE, BLADERF, RTLSDR, PLUTO, REPLAY };  // REPLAY: 파일/합성 소스 (replay_io.cpp)
 
 // ── 런타임 HW 파라미터 (초기화 시 채워짐) ────────────────────────────────
 struct HWConfig {
@@ -134,4 +134,22 @@ inline HWConfig make_rtlsdr_config(uint32_t actual_sr){
     c.gain_max        = 49.6f;
     c.gain_default    = (float)RTLSDR_RX_GAIN_TENTHS / 10.0f;
     return c;
-}
\ No newline at end of file
+}
+
+// Replay (SigMF ci16 / 합성) — 링 int16 스케일은 실장비와 동일 (±2048)
+inline HWConfig make_replay_config(uint32_t sr){
+    HWConfig c;
+    c.type            = HWType::REPLAY;
+    c.sample_rate     = sr;
+    c.sample_rate_mhz = sr / 1e6f;
+    c.freq_min_hz     = 0.0;
+    c.freq_max_hz     = 6000e6;
+    c.iq_scale        = 2048.0f;
+    c.iq_offset       = 0.0f;
+    c.eff_bw_ratio    = 1.0f;
+    c.name            = "Replay";
+    c.gain_min        = 0.0f;
+    c.gain_max        = 0.0f;
+    c.gain_default    = 0.0f;
+    return c;
+}
@@ -4,12 +4,15 @@
 #include "mission_push.hpp"
 #include "kst_time.hpp"
 #include "sigmf.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <ctime>
 #include <algorithm>
 #include <chrono>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <cmath>
+#include <volk/volk.h>
 
 // 모든 시간은 KST(UTC+9) 기준.
 static void fmt_time_hms(char* out, size_t sz, const struct tm& tm_loc){
@@ -243,6 +246,7 @@ static const char* dem_mode_name(Channel::DemodMode m){
 
 // ── IQ 녹음 워커 ─────────────────────────────────────────────────────────
 void FFTViewer::rec_worker(){
+    PipeStats::ReaderScope rs_(rec_rp, "rec", 0);
     uint32_t msr=header.sample_rate;
     float off=(rec_cf_mhz-(float)(header.center_frequency/1e6f))*1e6f;
     uint32_t safe_sr=std::max(1u,rec_sr);
@@ -263,6 +267,7 @@ void FFTViewer::rec_worker(){
         size_t rp=rec_rp.load(std::memory_order_relaxed);
         if(rp==wp){ std::this_thread::sleep_for(std::chrono::microseconds(100)); continue; }
         size_t avail=std::min((wp-rp)&IQ_RING_MASK,(size_t)65536);
+        BEWE_TRACE_SCOPE_ARG("rec", "batch", avail);
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
             float si=ring[pos*2]*inv_scale, sq=ring[pos*2+1]*inv_scale;
@@ -277,7 +282,9 @@ void FFTViewer::rec_worker(){
         rec_rp.store((rp+avail)&IQ_RING_MASK,std::memory_order_release);
     }
     wav.close();
-    bewe_log("REC IQ done: %llu frames → %s\n",(unsigned long long)rec_frames.load(),rec_filename.c_str());
+    char aio[128];
+    AsyncIO::format(aio, sizeof(aio), wav.aw.stats());
+    bewe_log("REC IQ done: %llu frames → %s  [%s]\n",(unsigned long long)rec_frames.load(),rec_filename.c_str(),aio);
 
     // .info Duration 갱신
     if(actual_sr > 0)
@@ -394,15 +401,18 @@ void FFTViewer::start_audio_rec(int ch_idx){
         snprintf(fn, sizeof(fn), "%s/%s", rec_dir.c_str(), base.c_str());
     }
 
-    FILE* fp=fopen(fn,"wb");
-    if(!fp){ bewe_log("Audio REC: cannot open %s\n",fn); return; }
-    setvbuf(fp, nullptr, _IOFBF, 1<<16);  // 64KB stdio 버퍼 → 샘플당 write() syscall 제거
+    int fd=::open(fn,O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if(fd<0 || !ch.audio_rec_aw.attach(fd,fn,true,1<<16,4)){
+        if(fd>=0) ::close(fd);
+        bewe_log("Audio REC: cannot open %s\n",fn); return;
+    }
+    ch.audio_rec_aw.seek(44);          // 헤더는 마감 시 녹음 스레드가 기록
+    ch.audio_rec_ring.alloc((size_t)asr);   // 1 초분
     ch.audio_rec_frames=0;
-    ch.audio_rec_write_wav_hdr(fp,asr,0);
-    ch.audio_rec_fp=fp;
     ch.audio_rec_path=fn;
     ch.sqr_state = Channel::SQR_IDLE;
     ch.sqr_tail_remain = 0;
+    rec_io_open(ch.audio_rec_io);
     ch.audio_rec_on.store(true,std::memory_order_release);
 
     // RecEntry 추가
@@ -437,13 +447,11 @@ void FFTViewer::stop_audio_rec(int ch_idx){
     ch.audio_rec_on.store(false,std::memory_order_release);
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
-    FILE* fp=ch.audio_rec_fp;
-    ch.audio_rec_fp=nullptr;
-    if(fp){
-        fseek(fp,0,SEEK_SET);
-        ch.audio_rec_write_wav_hdr(fp,ch.audio_rec_sr,ch.audio_rec_frames);
-        fclose(fp);
-    }
+    // producer 정지 후 남은 부분 블록 공개 → 녹음 스레드가 비우고 헤더 마감
+    ch.audio_rec_ring.publish();
+    rec_io_close(ch.audio_rec_io);
+    if(uint64_t d=ch.audio_rec_ring.drops.load())
+        bewe_log("Audio REC ch%d: %llu samples dropped (recorder lag)\n",ch_idx,(unsigned long long)d);
 
     // 실제 녹음 출력이 없으면 파일 삭제 + RecEntry 제거
     if(ch.audio_rec_frames==0){
@@ -501,7 +509,12 @@ void FFTViewer::iq_only_worker(int ch_idx){
     uint32_t actual_sr = msr / decim;
     ch.iq_rec_sr = actual_sr;
 
-    Oscillator osc; osc.set_freq((double)off_hz, (double)msr);
+    // 예약 위성 녹음: 도플러 추적 (채널 중심 + 편이(t) 를 0 Hz 로). 배치마다 갱신, 위상 연속.
+    std::shared_ptr<const DopplerTrack> dop = ch.iq_dop;
+    float dop_hz = dop ? dop->at(std::chrono::duration<double>(
+                             std::chrono::system_clock::now().time_since_epoch()).count()) : 0.f;
+
+    Oscillator osc; osc.set_freq((double)(off_hz + dop_hz), (double)msr);
     uint64_t prev_cf = init_cf;
 
     // BW LPF cascade (4-stage IIR1) — pre-decim 단계에서 anti-alias
@@ -514,15 +527,21 @@ void FFTViewer::iq_only_worker(int ch_idx){
     const float inv_scale=1.0f/hw.iq_scale;  // ÷ → ×
     const size_t MAX_LAG = (size_t)(msr * 0.08);
     const size_t BATCH   = std::max((size_t)4096, (size_t)decim * 256);
+    PipeStats::ReaderScope rs_(ch.iq_only_rp, "iqonly", ch_idx);
 
     while(!ch.iq_only_stop_req.load(std::memory_order_relaxed) && !sdr_stream_error.load()){
         // CF 변경 감지
         uint64_t cur_cf = live_cf_hz.load(std::memory_order_acquire);
         if(cur_cf != prev_cf){
             off_hz = (ch_cf_mhz - (float)(cur_cf / 1e6f)) * 1e6f;
-            osc.set_freq((double)off_hz, (double)msr);
+            osc.set_freq((double)(off_hz + dop_hz), (double)msr);
             prev_cf = cur_cf;
         }
+        if(dop){
+            float d = dop->at(std::chrono::duration<double>(
+                          std::chrono::system_clock::now().time_since_epoch()).count());
+            if(fabsf(d - dop_hz) > 1.0f){ dop_hz = d; osc.retune((double)(off_hz + dop_hz), (double)msr); }
+        }
         size_t wp = ring_wp.load(std::memory_order_acquire);
         size_t rp = ch.iq_only_rp.load(std::memory_order_relaxed);
         size_t lag = (wp - rp) & IQ_RING_MASK;
@@ -537,6 +556,7 @@ void FFTViewer::iq_only_worker(int ch_idx){
         if(lag == 0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
 
         size_t avail = std::min(lag, BATCH);
+        BEWE_TRACE_SCOPE_ARG("rec", "iqonly_batch", avail);
         for(size_t s=0; s<avail; s++){
             size_t pos = (rp + s) & IQ_RING_MASK;
             float si = ring[pos*2]   * inv_scale;
@@ -558,6 +578,87 @@ void FFTViewer::iq_only_worker(int ch_idx){
     ch.iq_only_run.store(false, std::memory_order_release);
 }
 
+// ── 채널 녹음 I/O 스레드 ──────────────────────────────────────────────────
+// demod / iq_only / mix 스레드는 RecRing 에 float 만 넣는다. 여기서 20 ms 마다
+// 전 채널 ring 을 비워 int16 변환(VOLK) 후 AsyncIO 로 쓰고, CLOSE 요청 시
+// 남은 블록 + WAV 헤더 마감까지 끝낸 뒤 IDLE 로 돌려 stop_* 를 깨운다.
+namespace {
+constexpr size_t REC_IO_CHUNK = 16384;   // float 단위 변환 블록
+
+// ring → int16 → sink(p, n_float). 남은 것 전부.
+template<class Sink>
+void rec_drain(RecRing& r, std::vector<int16_t>& s16, Sink&& sink){
+    const float* p;
+    size_t n;
+    while((n = r.peek(p)) > 0){
+        n = std::min(n, REC_IO_CHUNK);
+        volk_32f_s32f_convert_16i(s16.data(), p, 32767.0f, (unsigned)n);
+        sink(s16.data(), n);
+        r.consume(n);
+    }
+}
+} // namespace
+
+void FFTViewer::rec_io_worker(){
+    std::vector<int16_t> s16(REC_IO_CHUNK);
+    std::unique_lock<std::mutex> lk(rec_io_mtx);
+    while(!rec_io_stop.load()){
+        rec_io_cv.wait_for(lk, std::chrono::milliseconds(20));
+        lk.unlock();
+        bool closed = false;
+        for(int c = 0; c < MAX_CHANNELS; c++){
+            Channel& ch = channels[c];
+            int as = ch.audio_rec_io.load(std::memory_order_acquire);
+            if(as != Channel::REC_IO_IDLE){
+                rec_drain(ch.audio_rec_ring, s16, [&](const int16_t* p, size_t n){
+                    ch.audio_rec_aw.append(p, n * sizeof(int16_t));
+                });
+                if(as == Channel::REC_IO_CLOSE){
+                    uint8_t hdr[44];
+                    Channel::wav_hdr_mono(hdr, ch.audio_rec_sr, ch.audio_rec_frames);
+                    ch.audio_rec_aw.flush();
+                    ch.audio_rec_aw.write(hdr, sizeof(hdr), 0);
+                    ch.audio_rec_aw.close();
+                    ch.audio_rec_io.store(Channel::REC_IO_IDLE, std::memory_order_release);
+                    closed = true;
+                }
+            }
+            int is = ch.iq_rec_io.load(std::memory_order_acquire);
+            if(is != Channel::REC_IO_IDLE){
+                rec_drain(ch.iq_rec_ring, s16, [&](const int16_t* p, size_t n){
+                    ch.iq_rec_wav.write_block(p, n / 2);
+                });
+                if(is == Channel::REC_IO_CLOSE){
+                    ch.iq_rec_wav.close();
+                    ch.iq_rec_io.store(Channel::REC_IO_IDLE, std::memory_order_release);
+                    closed = true;
+                }
+            }
+        }
+        lk.lock();
+        if(closed) rec_io_cv.notify_all();
+    }
+}
+
+void FFTViewer::rec_io_open(std::atomic<int>& io){
+    {
+        std::lock_guard<std::mutex> lk(rec_io_mtx);
+        if(!rec_io_thr.joinable()){
+            rec_io_stop.store(false);
+            rec_io_thr = std::thread(&FFTViewer::rec_io_worker, this);
+        }
+    }
+    io.store(Channel::REC_IO_OPEN, std::memory_order_release);
+}
+
+void FFTViewer::rec_io_close(std::atomic<int>& io){
+    std::unique_lock<std::mutex> lk(rec_io_mtx);
+    if(io.load() == Channel::REC_IO_IDLE) return;
+    io.store(Channel::REC_IO_CLOSE, std::memory_order_release);
+    rec_io_cv.notify_all();
+    rec_io_cv.wait(lk, [&]{ return io.load() == Channel::REC_IO_IDLE || rec_io_stop.load(); });
+}
+
 // ── Per-channel IQ recording (squelch-gated, decimated baseband) ──────────
 void FFTViewer::start_iq_rec(int ch_idx){
     if(ch_idx<0||ch_idx>=MAX_CHANNELS) return;
@@ -625,18 +726,17 @@ void FFTViewer::start_iq_rec(int ch_idx){
         snprintf(fn, sizeof(fn), "%s/%s", rec_dir.c_str(), base.c_str());
     }
 
-    FILE* fp=fopen(fn,"wb");
-    if(!fp){ bewe_log("IQ REC: cannot open %s\n",fn); return; }
-    setvbuf(fp, nullptr, _IOFBF, 1<<16);  // 64KB stdio 버퍼 → 샘플당 write() syscall 제거
+    if(!ch.iq_rec_wav.open(fn,actual_inter)){ bewe_log("IQ REC: cannot open %s\n",fn); return; }
+    ch.iq_rec_ring.alloc((size_t)actual_inter);   // 0.5 초분 (I,Q float)
     ch.iq_rec_frames=0;
     ch.iq_rec_cf_hz=(uint64_t)(cf_mhz*1e6);
     ch.iq_rec_start_time=(int64_t)t;
     // raw IQ(.sigmf-data): 헤더 없이 데이터부터 기록. 메타는 아래 .sigmf-meta.
 
-    ch.iq_rec_fp=fp;
     ch.iq_rec_path=fn;
     ch.iq_sqr_state=Channel::SQR_IDLE;
     ch.iq_sqr_tail_remain=0;
+    rec_io_open(ch.iq_rec_io);
     ch.iq_rec_on.store(true,std::memory_order_release);
 
     // demod path 없으면 IQ-only worker 시작
@@ -683,9 +783,14 @@ void FFTViewer::stop_iq_rec(int ch_idx){
     }
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
-    FILE* fp=ch.iq_rec_fp;
-    ch.iq_rec_fp=nullptr;
-    if(fp) fclose(fp);   // raw .sigmf-data — 헤더 재작성 불필요
+    // raw .sigmf-data — 헤더 재작성 불필요. 녹음 스레드가 남은 블록을 쓰고
+    // in-flight 쓰기 완료까지 마친 뒤 돌아온다.
+    ch.iq_rec_ring.publish();
+    rec_io_close(ch.iq_rec_io);
+    if(uint64_t d=ch.iq_rec_ring.drops.load())
+        bewe_log("IQ REC ch%d: %llu samples dropped (recorder lag)\n",ch_idx,(unsigned long long)d);
+    char aio[128];
+    AsyncIO::format(aio, sizeof(aio), ch.iq_rec_wav.aw.stats());
 
     if(ch.iq_rec_frames==0){
         remove(ch.iq_rec_path.c_str());
@@ -698,8 +803,8 @@ void FFTViewer::stop_iq_rec(int ch_idx){
         return;
     }
 
-    bewe_log("IQ REC done: %llu frames > %s\n",
-             (unsigned long long)ch.iq_rec_frames, ch.iq_rec_path.c_str());
+    bewe_log("IQ REC done: %llu frames > %s  [%s]\n",
+             (unsigned long long)ch.iq_rec_frames, ch.iq_rec_path.c_str(), aio);
 
     if(ch.iq_rec_sr > 0)
         update_info_file_duration(ch.iq_rec_path,
@@ -746,15 +851,18 @@ void FFTViewer::start_join_audio_rec(int ch_idx){
         snprintf(fn, sizeof(fn), "%s/%s", rec_dir.c_str(), base.c_str());
     }
 
-    FILE* fp=fopen(fn,"wb");
-    if(!fp){ bewe_log("JOIN Audio REC: cannot open %s\n",fn); return; }
-    setvbuf(fp, nullptr, _IOFBF, 1<<16);  // 64KB stdio 버퍼 → 샘플당 write() syscall 제거
+    int fd=::open(fn,O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if(fd<0 || !ch.audio_rec_aw.attach(fd,fn,true,1<<16,4)){
+        if(fd>=0) ::close(fd);
+        bewe_log("JOIN Audio REC: cannot open %s\n",fn); return;
+    }
+    ch.audio_rec_aw.seek(44);          // 헤더는 마감 시 녹음 스레드가 기록
+    ch.audio_rec_ring.alloc((size_t)asr);   // 1 초분
     ch.audio_rec_frames=0;
-    ch.audio_rec_write_wav_hdr(fp,asr,0);
-    ch.audio_rec_fp=fp;
     ch.audio_rec_path=fn;
     ch.sqr_state = Channel::SQR_IDLE;
     ch.sqr_tail_remain = 0;
+    rec_io_open(ch.audio_rec_io);
     ch.audio_rec_on.store(true,std::memory_order_release);
 
     {
@@ -786,13 +894,11 @@ void FFTViewer::stop_join_audio_rec(int ch_idx){
     ch.audio_rec_on.store(false,std::memory_order_release);
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
-    FILE* fp=ch.audio_rec_fp;
-    ch.audio_rec_fp=nullptr;
-    if(fp){
-        fseek(fp,0,SEEK_SET);
-        ch.audio_rec_write_wav_hdr(fp,ch.audio_rec_sr,ch.audio_rec_frames);
-        fclose(fp);
-    }
+    // producer 정지 후 남은 부분 블록 공개 → 녹음 스레드가 비우고 헤더 마감
+    ch.audio_rec_ring.publish();
+    rec_io_close(ch.audio_rec_io);
+    if(uint64_t d=ch.audio_rec_ring.drops.load())
+        bewe_log("Audio REC ch%d: %llu samples dropped (recorder lag)\n",ch_idx,(unsigned long long)d);
 
     // 실제 녹음 출력이 없으면 파일 삭제 + RecEntry 제거
     if(ch.audio_rec_frames==0){
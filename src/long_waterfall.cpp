@@ -1,4 +1,6 @@
 #include "long_waterfall.hpp"
+#include "lwf_pyramid.hpp"
+#include "lwf_codec.hpp"
 #include "fft_viewer.hpp"
 #include "bewe_paths.hpp"
 #include "net_protocol.hpp"
@@ -49,6 +51,21 @@ std::mutex          g_path_mtx;
 std::string         g_cur_path;            // empty when no file open
 FILE*               g_fp = nullptr;
 FileHeader          g_hdr_cur{};
+// <file>.pyr — zoom-out 용 mip pyramid. row append 와 같은 시점에 증분 갱신.
+LwfPyramid::Builder g_pyr;
+
+// v4 block writer — BLOCK_ROWS 행을 모아 압축 블록 1개로 기록 (lwf_codec.hpp).
+// 미봉인 행은 viewer 가 pending_rows() 로 읽음 → g_blk_rows/g_blk_n/g_rows_written 쓰기는
+// g_pend_mtx 안 (worker 자신의 읽기는 lock 불필요).
+std::mutex            g_pend_mtx;
+uint64_t              g_pend_seq = 0;      // 미봉인 꼬리 변경마다 ++
+std::vector<uint8_t>  g_blk_rows;          // 미기록 행 (g_blk_n × fft)
+uint32_t              g_blk_n = 0;
+std::chrono::steady_clock::time_point g_blk_t0;   // 현재 블록 첫 행 시각 (SEAL_SEC 부분 봉인)
+uint64_t              g_rows_written = 0;  // 블록으로 기록 완료된 행 수
+std::vector<uint64_t> g_blk_offs;          // finalize footer 용 block offset
+uint64_t              g_file_pos = 0;
+std::vector<uint8_t>  g_blk_out, g_blk_scratch;
 
 // Max-hold accumulator across capture rows since last flush.
 std::vector<float>  g_acc_db;              // size = current fft_size
@@ -59,7 +76,52 @@ int                 g_last_total_ffts = 0;
 
 // ── Helpers ──────────────────────────────────────────────────────────────
 
+// 버퍼에 모인 행을 압축 블록으로 기록 + Central 로 동일 블록 전달.
+void write_block_locked(){
+    if(!g_fp || g_blk_n == 0) return;
+    uint32_t fft = g_hdr_cur.fft_size;
+    if(!LwfCodec::encode_block(g_blk_rows.data(), g_blk_n, fft, (uint32_t)g_rows_written,
+                               g_blk_out, g_blk_scratch)){
+        fprintf(stderr, "[LongWaterfall] block encode failed (%u rows dropped)\n", g_blk_n);
+        std::lock_guard<std::mutex> lk(g_pend_mtx);
+        g_blk_n = 0; g_pend_seq++;
+        return;
+    }
+    if(fwrite(g_blk_out.data(), 1, g_blk_out.size(), g_fp) != g_blk_out.size()){
+        fprintf(stderr, "[LongWaterfall] block write failed errno=%d\n", errno);
+    }
+    fflush(g_fp);
+    g_blk_offs.push_back(g_file_pos);
+    g_file_pos     += g_blk_out.size();
+    {
+        std::lock_guard<std::mutex> lk(g_pend_mtx);
+        g_rows_written += g_blk_n;
+        g_blk_n = 0; g_pend_seq++;
+    }
+
+    // Live broadcast — Central archive 가 같은 블록을 mirror 파일에 append.
+    PktLwfLiveBlockHdr bhdr{};
+    {
+        std::lock_guard<std::mutex> lk(g_live_state_mtx);
+        if(g_live_state_valid)
+            memcpy(bhdr.filename, g_live_state.filename, sizeof(bhdr.filename));
+    }
+    if(bhdr.filename[0]){
+        LiveCallbacks cb_copy;
+        { std::lock_guard<std::mutex> lk(g_live_cb_mtx); cb_copy = g_live_cb; }
+        if(cb_copy.on_block) cb_copy.on_block(bhdr, g_blk_out.data(), (uint32_t)g_blk_out.size());
+    }
+}
+
 void close_file_locked(){
+    // 남은 행 블록 + index footer (STOP 이전에 — Central 이 마지막 블록까지 받도록).
+    if(g_fp){
+        write_block_locked();
+        LwfCodec::write_footer(g_fp, g_blk_offs, g_rows_written);
+    }
+    g_blk_offs.clear();
+    { std::lock_guard<std::mutex> lk(g_pend_mtx); g_rows_written = 0; g_pend_seq++; }
+
     // Live broadcast STOP first (so JOIN closes its mirror file).
     PktLwfLiveStop stop_pkt{};
     bool had_state = false;
@@ -81,6 +143,7 @@ void close_file_locked(){
     }
 
     if(g_fp){ fflush(g_fp); fclose(g_fp); g_fp = nullptr; }
+    g_pyr.close();
 
     // Empty file (header-only, no rows flushed) — discard instead of finalize.
     // Common at midnight rollover: mission_end + mission_start + utc0_worker call
@@ -98,6 +161,7 @@ void close_file_locked(){
                    discard_path.c_str());
             unlink(discard_path.c_str());
             unlink((discard_path + ".info").c_str());
+            unlink(LwfPyramid::sidecar_path(discard_path).c_str());
         }
         g_acc_db.clear();
         g_acc_count = 0;
@@ -106,10 +170,13 @@ void close_file_locked(){
     }
 
     // Finalize: -LIVE → -<HHMM>Z based on close time.
+    // pyramid sidecar 는 LIVE 열람용 파생 데이터 — 로컬 파일은 finalize 후 push/unlink
+    // 되므로 여기서 버린다. 수신측 viewer 가 필요 시 재생성.
     std::string finalized_path;
     {
         std::lock_guard<std::mutex> lk(g_path_mtx);
         if(!g_cur_path.empty()){
+            unlink(LwfPyramid::sidecar_path(g_cur_path).c_str());
             auto slash = g_cur_path.find_last_of('/');
             std::string dir  = (slash == std::string::npos) ? "" : g_cur_path.substr(0, slash+1);
             std::string base = (slash == std::string::npos) ? g_cur_path : g_cur_path.substr(slash+1);
@@ -196,7 +263,7 @@ bool open_new_file(uint64_t cf_hz, uint64_t sr_hz, uint32_t fft_size,
     if(!(dmax > dmin)){ dmin = DEFAULT_DB_MIN; dmax = DEFAULT_DB_MAX; }
     FileHeader h{};
     memcpy(h.magic, "BWWF", 4);
-    h.version        = FILE_VERSION;     // 0x0003
+    h.version        = FILE_VERSION;     // 0x0004 (block-compressed)
     h.fft_size       = fft_size;
     h.sample_rate_hz = sr_hz;
     h.center_freq_hz = cf_hz;
@@ -217,6 +284,19 @@ bool open_new_file(uint64_t cf_hz, uint64_t sr_hz, uint32_t fft_size,
 
     g_fp = fp;
     g_hdr_cur = h;
+    {
+        std::lock_guard<std::mutex> lk(g_pend_mtx);
+        g_blk_rows.resize((size_t)LwfCodec::BLOCK_ROWS * fft_size);
+        g_blk_n = 0;
+        g_rows_written = 0;
+        g_pend_seq++;
+    }
+    g_blk_offs.clear();
+    g_file_pos = sizeof(h);
+    if(!g_pyr.open(LwfPyramid::sidecar_path(full), fft_size)){
+        // fft 가 너무 작거나 sidecar 생성 실패 — viewer 는 base row 샘플링으로 동작.
+        unlink(LwfPyramid::sidecar_path(full).c_str());
+    }
     g_acc_db.assign(fft_size, -200.0f);  // very-low init for max-hold
     g_acc_count = 0;
     g_file_dirty.store(false);  // 새 파일 = LIVE tap 안정 가정으로 시작
@@ -256,32 +336,29 @@ bool open_new_file(uint64_t cf_hz, uint64_t sr_hz, uint32_t fft_size,
     return true;
 }
 
-// Flush accumulated max-hold row to disk as 1 byte/bin. Resets accumulator.
+// Quantize accumulated max-hold row to 1 byte/bin and queue it for the current
+// block (sealed every BLOCK_ROWS rows, or as a partial block after SEAL_SEC —
+// see worker_loop). Resets accumulator.
 void flush_row_locked(){
     if(!g_fp || g_acc_count == 0 || g_acc_db.empty()) return;
-    std::vector<uint8_t> row(g_acc_db.size());
+    if(g_acc_db.size() != g_hdr_cur.fft_size) return;
+    uint8_t* row = g_blk_rows.data() + (size_t)g_blk_n * g_acc_db.size();
     float dmin = g_hdr_cur.db_min;
     float dmax = g_hdr_cur.db_max;
-    for(size_t i=0; i<g_acc_db.size(); i++){
-        row[i] = db_to_byte(g_acc_db[i], dmin, dmax);
-    }
-    fwrite(row.data(), 1, row.size(), g_fp);
-    fflush(g_fp);
-
-    // Live broadcast — JOIN's hist/live/<filename> appends this row.
-    PktLwfLiveRowHdr rhdr{};
     {
-        std::lock_guard<std::mutex> lk(g_live_state_mtx);
-        if(g_live_state_valid){
-            memcpy(rhdr.filename, g_live_state.filename, sizeof(rhdr.filename));
-            rhdr.row_index = g_live_row_idx++;
+        std::lock_guard<std::mutex> lk(g_pend_mtx);
+        for(size_t i=0; i<g_acc_db.size(); i++){
+            row[i] = db_to_byte(g_acc_db[i], dmin, dmax);
         }
+        g_blk_n++; g_pend_seq++;
     }
-    if(rhdr.filename[0]){
-        LiveCallbacks cb_copy;
-        { std::lock_guard<std::mutex> lk(g_live_cb_mtx); cb_copy = g_live_cb; }
-        if(cb_copy.on_row) cb_copy.on_row(rhdr, row.data(), (uint32_t)row.size());
+    g_pyr.append(row);
+    {
+        std::lock_guard<std::mutex> lk(g_live_state_mtx);
+        if(g_live_state_valid) g_live_row_idx++;
     }
+    if(g_blk_n == 1) g_blk_t0 = std::chrono::steady_clock::now();
+    if(g_blk_n >= LwfCodec::BLOCK_ROWS) write_block_locked();
 
     std::fill(g_acc_db.begin(), g_acc_db.end(), -200.0f);
     g_acc_count = 0;
@@ -318,7 +395,8 @@ bool ingest_new_rows(FFTViewer* v){
     int start_abs = now - new_rows;
     for(int abs_idx = start_abs; abs_idx < now; abs_idx++){
         int fi = abs_idx % MAX_FFTS_MEMORY;
-        const float* rowp = v->fft_data.data() + (size_t)fi * src_fft;
+        // uint8 행: 같은 행 안에서는 q 순서 = dB 순서 → max 는 byte 로, dB 변환은 1회
+        FftQuant::Row rowp = v->fft_row(fi);
         if(pad == 1){
             for(int i=0; i<dst_fft; i++){
                 float d = rowp[i];
@@ -326,10 +404,11 @@ bool ingest_new_rows(FFTViewer* v){
             }
         } else {
             for(int o=0; o<dst_fft; o++){
-                const float* gp = rowp + (size_t)o * pad;
-                float mx = gp[0];
+                const uint8_t* gp = rowp.q + (size_t)o * pad;
+                uint8_t mx = gp[0];
                 for(int k=1; k<pad; k++){ if(gp[k] > mx) mx = gp[k]; }
-                if(mx > g_acc_db[o]) g_acc_db[o] = mx;
+                float d = rowp.s.lo + (float)mx * rowp.s.step;
+                if(d > g_acc_db[o]) g_acc_db[o] = d;
             }
         }
         g_acc_count++;
@@ -425,6 +504,12 @@ void worker_loop(){
             }
             next_flush = now + std::chrono::milliseconds(period_ms);
         }
+        // 블록은 행 수로 봉인 (5 row/s 에서 6.4 s) — 압축 단위/index 크기를 row rate 와 무관하게.
+        // LIVE viewer 는 미봉인 꼬리를 pending_rows() 로 즉시 보고, Central archive 는 블록 단위.
+        // 저속 row rate 에서 크래시 손실만 SEAL_SEC 로 제한.
+        if(g_blk_n > 0 &&
+           now - g_blk_t0 >= std::chrono::duration<float>(LwfCodec::SEAL_SEC))
+            write_block_locked();
 
         std::this_thread::sleep_for(std::chrono::milliseconds(20));
     }
@@ -433,6 +518,35 @@ void worker_loop(){
     if(g_fp){ flush_row_locked(); close_file_locked(); }
 }
 
+// 크래시/강제종료로 footer 없이 남은 v4 파일: 체인 scan 으로 index 재구성 → 잘린 꼬리 블록 제거
+// → BWIX footer append (close_file_locked 와 같은 결과). 이후 목록/row 수는 O(1).
+void repair_footer(const std::string& path){
+    FILE* fp = fopen(path.c_str(), "r+b");
+    if(!fp) return;
+    FileHeader h{};
+    if(fread(&h, 1, sizeof(h), fp) != sizeof(h) || memcmp(h.magic, "BWWF", 4) != 0 ||
+       h.version != LwfCodec::FILE_VERSION_BLOCK || fseek(fp, 0, SEEK_END) != 0){
+        fclose(fp); return;
+    }
+    uint64_t size = (uint64_t)ftell(fp);
+    LwfCodec::IndexFooter f;
+    if(LwfCodec::read_footer(fp, size, f)){ fclose(fp); return; }
+    std::vector<uint64_t> offs;
+    uint64_t rows = 0;
+    uint64_t end = LwfCodec::scan_chain(fp, size, rows, &offs);
+    if(end < size && ftruncate(fileno(fp), (off_t)end) != 0){
+        fprintf(stderr, "[LongWaterfall] footer repair: truncate failed %s errno=%d\n", path.c_str(), errno);
+        fclose(fp); return;
+    }
+    bool ok = LwfCodec::write_footer(fp, offs, rows);
+    if(fclose(fp) != 0) ok = false;
+    if(ok)
+        printf("[LongWaterfall] footer repair: %s (%zu blocks, %llu rows, %llu B tail dropped)\n",
+               path.c_str(), offs.size(), (unsigned long long)rows, (unsigned long long)(size - end));
+    else
+        fprintf(stderr, "[LongWaterfall] footer repair failed: %s\n", path.c_str());
+}
+
 } // anon
 
 // ── Public API ───────────────────────────────────────────────────────────
@@ -477,6 +591,22 @@ void set_live_callbacks(const LiveCallbacks& cbs){
     g_live_cb = cbs;
 }
 
+bool pending_rows(const std::string& path, uint64_t& seq,
+                  uint64_t& first_row, uint32_t& n, std::vector<uint8_t>& rows){
+    {
+        std::lock_guard<std::mutex> lk(g_path_mtx);
+        if(path.empty() || path != g_cur_path) return false;
+    }
+    std::lock_guard<std::mutex> lk(g_pend_mtx);
+    if(seq == g_pend_seq) return true;
+    seq       = g_pend_seq;
+    first_row = g_rows_written;
+    n         = g_blk_n;
+    size_t fft = g_blk_rows.size() / LwfCodec::BLOCK_ROWS;   // open_new_file 이 lock 안에서 설정
+    rows.assign(g_blk_rows.begin(), g_blk_rows.begin() + (size_t)n * fft);
+    return true;
+}
+
 bool snapshot_live_start(::PktLwfLiveStart& out){
     std::lock_guard<std::mutex> lk(g_live_state_mtx);
     if(!g_live_state_valid) return false;
@@ -508,6 +638,7 @@ void finalize_stale_live_in_dir(const std::string& dir,
         uint64_t end_utc = (uint64_t)st.st_mtime;
         std::string fin = build_hist_filename_finalize(base, end_utc, 0);
         if(fin == base) continue;
+        repair_footer(full);   // end_utc 는 repair 전 mtime
         std::string new_full = dir + "/" + fin;
         // 충돌 회피: 같은 이름 이미 있으면 _2, _3 ... suffix
         std::string try_full = new_full;
@@ -519,6 +650,8 @@ void finalize_stale_live_in_dir(const std::string& dir,
             try_full = dir + "/" + try_fin;
         }
         if(rename(full.c_str(), try_full.c_str()) == 0){
+            rename(LwfPyramid::sidecar_path(full).c_str(),
+                   LwfPyramid::sidecar_path(try_full).c_str());
             printf("[LongWaterfall] stale-LIVE finalize: %s → %s\n",
                    base.c_str(), try_fin.c_str());
         } else {
@@ -605,7 +738,7 @@ void scan_dir_into_list(::PktLwfList& out){
 
     struct Entry {
         std::string name;
-        uint64_t size, start, cf, sr;
+        uint64_t size, start, cf, sr, rows;
         uint32_t fft;
         char     station_name[32];
         float    station_lat, station_lon;
@@ -625,11 +758,13 @@ void scan_dir_into_list(::PktLwfList& out){
         if(!fp) continue;
         FileHeader h{};
         if(fread(&h, 1, sizeof(h), fp) != sizeof(h) || memcmp(h.magic, "BWWF", 4) != 0
-           || h.version != FILE_VERSION){
+           || !LwfCodec::is_known_version(h.version)){
             fclose(fp); continue;
         }
+        uint64_t rows = LwfCodec::count_rows(fp, h.version, h.fft_size, (uint64_t)st.st_size);
         fclose(fp);
         Entry e{};
+        e.rows  = rows;
         e.name  = n;
         e.size  = (uint64_t)st.st_size;
         e.start = h.start_utc_unix;
@@ -658,7 +793,7 @@ void scan_dir_into_list(::PktLwfList& out){
         e.center_freq_hz = all[i].cf;
         e.sample_rate_hz = all[i].sr;
         e.fft_size       = all[i].fft;
-        e.num_rows       = (uint32_t)((all[i].size - sizeof(FileHeader)) / std::max<uint64_t>(1, all[i].fft));
+        e.num_rows       = (uint32_t)all[i].rows;
         memcpy(e.station_name, all[i].station_name, sizeof(e.station_name));
         e.station_lat    = all[i].station_lat;
         e.station_lon    = all[i].station_lon;
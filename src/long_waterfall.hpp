@@ -6,10 +6,13 @@
 // capture rows down to ~5 row/sec, quantizes float dB to uint8 (db_min..db_max
 // → 0..255), appends to .bewewf file under ~/BE_WE/recordings/long_waterfall/.
 //
-// File format (62B header rounded to 64, then raw rows):
-//   "BWWF"(4) ver(2) fft_size(4) sample_rate(8) center_freq(8)
-//   row_rate_hz(4 float) db_min(4 float) db_max(4 float) start_utc(8) reserved(16)
-// Each row = fft_size bytes.
+// File format (128B FileHeader, then rows):
+//   v3: raw rows, each row = fft_size bytes.
+//   v4: zlib blocks of up to BLOCK_ROWS rows (sealed when full, after SEAL_SEC, or on close) +
+//       finalize index footer (see lwf_codec.hpp).
+//       Writer emits v4; readers accept both.
+// Sidecar <file>.pyr = max/mean mip pyramid, appended alongside each row
+// (see lwf_pyramid.hpp). Viewer zoom-out reads it instead of raw rows.
 
 #include <cstdint>
 #include <cstdio>
@@ -17,6 +20,7 @@
 #include <ctime>
 #include <string>
 #include <functional>
+#include <vector>
 
 #include "net_protocol.hpp"
 #include "kst_time.hpp"
@@ -29,7 +33,7 @@ namespace LongWaterfall {
 #pragma pack(push, 1)
 struct FileHeader {
     char     magic[4];          // "BWWF"
-    uint16_t version;           // 0x0003
+    uint16_t version;           // 0x0003 raw rows / 0x0004 block-compressed
     uint32_t fft_size;
     uint64_t sample_rate_hz;
     uint64_t center_freq_hz;
@@ -49,7 +53,7 @@ struct FileHeader {
 #pragma pack(pop)
 static_assert(sizeof(FileHeader) == 128, "LongWaterfall::FileHeader v3 must be 128");
 
-constexpr uint16_t FILE_VERSION = 0x0003;
+constexpr uint16_t FILE_VERSION = 0x0004;   // writer version (LwfCodec::FILE_VERSION_BLOCK)
 
 constexpr float DEFAULT_ROW_RATE_HZ = 5.0f;
 constexpr float DEFAULT_DB_MIN = -120.0f;
@@ -89,12 +93,13 @@ void finalize_stale_live_all();
 
 // ── Live broadcast hooks ───────────────────────────────────────────────
 // Set by host wiring (cli_host / ui). Worker calls these inside open/flush/close
-// so NetServer can fan out LIVE_START / LIVE_ROW / LIVE_STOP to all JOINs.
+// so NetServer can fan out LIVE_START / LIVE_BLOCK / LIVE_STOP (Central archive tap).
 // Callbacks must be cheap (queue-only); worker thread invokes them directly.
 struct LiveCallbacks {
     std::function<void(const ::PktLwfLiveStart&)> on_start;
-    std::function<void(const ::PktLwfLiveRowHdr& hdr,
-                       const uint8_t* row, uint32_t row_bytes)> on_row;
+    // blk = LwfCodec::BlockHdr + zlib bytes — 디스크에 쓴 블록 그대로.
+    std::function<void(const ::PktLwfLiveBlockHdr& hdr,
+                       const uint8_t* blk, uint32_t blk_bytes)> on_block;
     std::function<void(const ::PktLwfLiveStop&)>  on_stop;
 };
 void set_live_callbacks(const LiveCallbacks& cbs);
@@ -103,6 +108,13 @@ void set_live_callbacks(const LiveCallbacks& cbs);
 // Returns false if no file is currently open.
 bool snapshot_live_start(::PktLwfLiveStart& out);
 
+// Rows of the recording `path` not yet sealed into a block (provisional tail for the
+// LIVE viewer). first_row = rows already on disk, rows = n × fft bytes.
+// seq changes whenever the tail does; if it equals the caller's seq nothing is copied.
+// false = `path` is not the file being recorded.
+bool pending_rows(const std::string& path, uint64_t& seq,
+                  uint64_t& first_row, uint32_t& n, std::vector<uint8_t>& rows);
+
 // Public format constants (so view code can quantize/dequantize identically).
 inline uint8_t db_to_byte(float db, float dmin, float dmax){
     if(db <= dmin) return 0;
@@ -2,7 +2,8 @@
 // Layout: viewer (left, large) + resizable splitter + file list (right, status-style).
 // Y=freq (top=high, bottom=low, linear FFT-shifted). X=time (left=old, right=new).
 // Wheel = X(time) cursor-anchored zoom; Ctrl+wheel = Y(freq) cursor-anchored zoom.
-// Arrow ←/→ = pan one full screen (EID parity).
+// Arrow ←/→ = pan one full screen (EID parity). M = max-hold ↔ mean 축소 토글.
+// Zoom-out 은 <file>.pyr mip pyramid (lwf_pyramid.hpp) 레벨을 읽어 파일 길이와 무관.
 // File click = select. Right-click = context menu (Info / Delete).
 //
 // Source files:
@@ -10,6 +11,8 @@
 //   - JOIN 다운로드: 같은 디렉토리에 host에서 받은 파일을 같은 이름으로 저장
 
 #include "long_waterfall.hpp"
+#include "lwf_pyramid.hpp"
+#include "lwf_codec.hpp"
 #include "fft_viewer.hpp"
 #include "bewe_paths.hpp"
 #include "net_protocol.hpp"
@@ -26,7 +29,10 @@
 #include <ctime>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <functional>
 #include <dirent.h>
@@ -58,9 +64,36 @@ struct OpenFile {
     int            fd = -1;
     const uint8_t* map = nullptr;
     size_t         map_size = 0;
+    // v4 (block-compressed): mmap 위 블록 index + 디코드 LRU. v3 는 미사용.
+    LwfCodec::Index      blk_idx;
+    LwfCodec::BlockCache blk_cache;
+    // LIVE v4: 아직 봉인 안 된 꼬리 행 (LongWaterfall::pending_rows 사본). row pend_row0 부터 pend_n 행.
+    uint64_t             pend_seq = 0;
+    uint64_t             pend_row0 = 0;
+    uint32_t             pend_n = 0;
+    std::vector<uint8_t> pend_rows;
+    // <path>.pyr mip pyramid — zoom-out 시 base row 대신 축소 타일을 읽음.
+    // 없거나 덜 채워졌으면 g_pyr_build 가 background 로 이어서 생성.
+    int              pyr_fd = -1;
+    const uint8_t*   pyr_map = nullptr;
+    size_t           pyr_map_size = 0;
+    LwfPyramid::View pyr;
 };
 OpenFile g_open;
 
+// Background pyramid catch-up (Central mirror / 다운로드 / 구버전 파일).
+// host 가 지금 기록 중인 LIVE 파일은 LongWaterfall worker 가 직접 sidecar 를 갱신.
+struct PyrBuild {
+    std::thread           thr;
+    std::atomic<bool>     stop{false};
+    std::atomic<bool>     done{false};
+    std::atomic<uint64_t> rows{0};
+    std::chrono::steady_clock::time_point last_remap{};
+};
+PyrBuild g_pyr_build;
+bool     g_pyr_mean = false;   // M키: 시간축 축소를 max-hold 대신 mean 으로 표시
+int      g_last_lod = 0;       // 마지막 rebuild 에 사용된 pyramid 레벨 (0=base)
+
 // ── Texture ──────────────────────────────────────────────────────────────
 GLuint   g_tex = 0;
 int      g_tex_w = 1024;
@@ -83,7 +116,11 @@ float    g_right_saved = 0.22f;
 bool     g_files_panel_open = true;   // S키 토글
 
 // File-list cache (HOST tab — local hist_host_dir, JOIN tab — local hist_join_dir)
-struct HistFileEntry { std::string path; std::string base; uint64_t start_utc; uint64_t size; };
+// header/rows 는 dirty rescan 때만 읽음 — v4 row 수는 footer 없으면 블록 chain walk 라 매 프레임 금지.
+struct HistFileEntry {
+    std::string path; std::string base; uint64_t start_utc; uint64_t size;
+    LongWaterfall::FileHeader hdr; uint64_t rows;
+};
 std::vector<HistFileEntry> g_host_files;
 std::vector<HistFileEntry> g_join_files;
 bool      g_host_list_dirty  = true;
@@ -117,6 +154,11 @@ std::string g_ctx_path;             // file targeted by current right-click cont
 std::unordered_map<std::string,int> g_selected;
 bool        g_info_modal_open = false;
 std::string g_info_path;            // file shown in Info modal
+// Info modal header cache (경로/크기 바뀌거나 모달 재오픈 때만 다시 읽음)
+std::string               g_info_read_path;
+LongWaterfall::FileHeader g_info_hdr{};
+uint64_t                  g_info_size = 0, g_info_rows = 0;
+bool                      g_info_ok = false;
 
 // JOIN download progress
 struct DlState {
@@ -172,8 +214,123 @@ std::mutex g_remote_list_mtx;
 
 uint64_t   g_last_known_rows = 0;
 
+// ── Pyramid sidecar ──────────────────────────────────────────────────────
+void pyr_unmap(){
+    if(g_open.pyr_map){ munmap((void*)g_open.pyr_map, g_open.pyr_map_size); }
+    if(g_open.pyr_fd >= 0){ ::close(g_open.pyr_fd); }
+    g_open.pyr_fd = -1;
+    g_open.pyr_map = nullptr;
+    g_open.pyr_map_size = 0;
+    g_open.pyr = LwfPyramid::View{};
+}
+
+// (re)map sidecar at its current size. 없거나 header 불일치면 pyr.levels=0 유지.
+void pyr_remap(){
+    pyr_unmap();
+    int fd = ::open(LwfPyramid::sidecar_path(g_open.path).c_str(), O_RDONLY);
+    if(fd < 0) return;
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(LwfPyramid::Header)){
+        ::close(fd); return;
+    }
+    void* m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if(m == MAP_FAILED){ ::close(fd); return; }
+    g_open.pyr_fd = fd;
+    g_open.pyr_map = (const uint8_t*)m;
+    g_open.pyr_map_size = (size_t)st.st_size;
+    if(!g_open.pyr.attach(g_open.pyr_map, g_open.pyr_map_size, g_open.hdr.fft_size)) pyr_unmap();
+}
+
+void pyr_build_stop(){
+    if(g_pyr_build.thr.joinable()){
+        g_pyr_build.stop.store(true);
+        g_pyr_build.thr.join();
+    }
+    g_pyr_build.stop.store(false);
+    g_pyr_build.done.store(false);
+    g_pyr_build.rows.store(0);
+}
+
+// base 파일을 순차로 읽어 sidecar 를 끝까지 채움. 기존 sidecar 는 이어서 작성.
+void pyr_build_start(const std::string& path, uint16_t version, uint32_t fft, uint32_t num_rows){
+    pyr_build_stop();
+    g_pyr_build.last_remap = std::chrono::steady_clock::now();
+    g_pyr_build.thr = std::thread([path, version, fft, num_rows](){
+        LwfPyramid::Builder b;
+        if(!b.open(LwfPyramid::sidecar_path(path), fft, true)){
+            g_pyr_build.done.store(true);
+            return;
+        }
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0){ g_pyr_build.done.store(true); return; }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        uint64_t r = b.rows();
+        if(version == LwfCodec::FILE_VERSION_BLOCK){
+            // v4: 블록 단위 순차 디코드 (재개 지점이 블록 중간일 수 있음).
+            struct stat st{};
+            void* m = MAP_FAILED;
+            if(fstat(fd, &st) == 0 && st.st_size > 0)
+                m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if(m != MAP_FAILED){
+                const uint8_t* mp = (const uint8_t*)m;
+                uint64_t msz = (uint64_t)st.st_size;
+                LwfCodec::Index idx;
+                idx.build(mp, msz);
+                std::vector<uint8_t> rows;
+                for(uint64_t bi = idx.block_of(r);
+                    bi < idx.offs.size() && r < num_rows &&
+                    !g_pyr_build.stop.load(std::memory_order_relaxed); bi++){
+                    uint32_t n = 0;
+                    if(!LwfCodec::decode_block(mp + idx.offs[bi], msz - idx.offs[bi], fft, rows, &n)) break;
+                    uint64_t row0 = idx.row0[bi];
+                    for(uint32_t i = 0; i < n && r < num_rows; i++){
+                        if(row0 + i < r) continue;
+                        b.append(rows.data() + (size_t)i * fft);
+                        r++;
+                    }
+                    g_pyr_build.rows.store(r, std::memory_order_relaxed);
+                }
+                munmap(m, (size_t)st.st_size);
+            }
+            ::close(fd);
+            b.close();
+            g_pyr_build.done.store(true);
+            return;
+        }
+        constexpr uint32_t kChunkRows = 64;
+        std::vector<uint8_t> buf((size_t)kChunkRows * fft);
+        while(r < num_rows && !g_pyr_build.stop.load(std::memory_order_relaxed)){
+            uint32_t n = (uint32_t)std::min<uint64_t>(kChunkRows, num_rows - r);
+            off_t off = (off_t)(sizeof(LongWaterfall::FileHeader) + r * (uint64_t)fft);
+            ssize_t got = pread(fd, buf.data(), (size_t)n * fft, off);
+            if(got != (ssize_t)((size_t)n * fft)) break;
+            for(uint32_t i = 0; i < n; i++) b.append(buf.data() + (size_t)i * fft);
+            r += n;
+            g_pyr_build.rows.store(r, std::memory_order_relaxed);
+        }
+        ::close(fd);
+        b.close();
+        g_pyr_build.done.store(true);
+    });
+}
+
+// 매 프레임 호출 — catch-up 진행분을 주기적으로 remap 해 zoom-out 이 점점 빨라지게.
+void pyr_poll(){
+    if(!g_pyr_build.thr.joinable()) return;
+    auto now = std::chrono::steady_clock::now();
+    bool done = g_pyr_build.done.load();
+    if(!done && now - g_pyr_build.last_remap < std::chrono::seconds(2)) return;
+    g_pyr_build.last_remap = now;
+    if(done) g_pyr_build.thr.join();
+    uint64_t before = g_open.pyr.rows;
+    pyr_remap();
+    if(g_open.pyr.rows != before) g_tex_dirty = true;
+}
+
 // ── Helpers ──────────────────────────────────────────────────────────────
 void close_open(){
+    pyr_build_stop();
+    pyr_unmap();
     if(g_open.map){ munmap((void*)g_open.map, g_open.map_size); }
     if(g_open.fd >= 0){ ::close(g_open.fd); }
     if(g_open.fp){ fclose(g_open.fp); g_open.fp = nullptr; }
@@ -188,13 +345,14 @@ bool open_file(const std::string& path){
     if(!fp) return false;
     LongWaterfall::FileHeader h{};
     if(fread(&h, 1, sizeof(h), fp) != sizeof(h) || memcmp(h.magic,"BWWF",4)!=0
-       || h.version != LongWaterfall::FILE_VERSION){
+       || !LwfCodec::is_known_version(h.version)){
         fclose(fp); return false;
     }
     fseek(fp, 0, SEEK_END);
     uint64_t sz = (uint64_t)ftell(fp);
     fseek(fp, 0, SEEK_SET);
     if(h.fft_size == 0 || sz < sizeof(h)){ fclose(fp); return false; }
+    const bool blocked = (h.version == LwfCodec::FILE_VERSION_BLOCK);
     g_open.path = path;
     g_open.hdr = h;
     g_open.total_size = sz;
@@ -213,6 +371,22 @@ bool open_file(const std::string& path){
             ::close(g_open.fd); g_open.fd = -1;
         }
     }
+    if(blocked){
+        // v4 는 mmap 필수 (블록 index/디코드가 map 위에서 동작).
+        if(!g_open.map){ close_open(); return false; }
+        g_open.blk_idx.build(g_open.map, g_open.map_size);
+        g_open.num_rows = (uint32_t)g_open.blk_idx.rows;
+    }
+    pyr_remap();
+    // host 가 기록 중인 LIVE 파일은 worker 가 sidecar 를 직접 갱신 — 여기선 읽기만.
+    // 그 외 파일은 최상위 레벨 한 칸 이상 부족하면 background 로 이어서 생성.
+    if(path != LongWaterfall::current_file_path()){
+        int levels = LwfPyramid::level_count(h.fft_size);
+        if(levels > 0 &&
+           g_open.pyr.rows + LwfPyramid::level_factor(levels) <= g_open.num_rows){
+            pyr_build_start(path, h.version, h.fft_size, g_open.num_rows);
+        }
+    }
     g_t0 = 0; g_t1 = std::max<uint32_t>(1, g_open.num_rows);
     g_f0 = 0; g_f1 = h.fft_size;
     g_tex_dirty = true;
@@ -246,10 +420,12 @@ static void hist_delete_one(const std::string& id, int section, NetClient* cli){
         case 0: // (legacy LIVE section removed in v4.6.0 — kept for backward enum compat)
             if(g_open.path == id) close_open();
             unlink(id.c_str());
+            unlink(LwfPyramid::sidecar_path(id).c_str());
             break;
         case 1: // HOST local file (full path)
             if(g_open.path == id) close_open();
             unlink(id.c_str());
+            unlink(LwfPyramid::sidecar_path(id).c_str());
             g_host_list_dirty = true;
             break;
         case 2: // HOST remote — id is host-side basename
@@ -259,21 +435,24 @@ static void hist_delete_one(const std::string& id, int section, NetClient* cli){
         case 3: // LOCAL / JOIN-downloaded (full path)
             if(g_open.path == id) close_open();
             unlink(id.c_str());
+            unlink(LwfPyramid::sidecar_path(id).c_str());
             g_join_list_dirty = true;
             break;
     }
     if(g_sel_path == id) g_sel_path.clear();
 }
 
-bool read_header_only(const std::string& path, LongWaterfall::FileHeader& h, uint64_t& size){
+bool read_header_only(const std::string& path, LongWaterfall::FileHeader& h, uint64_t& size,
+                      uint64_t& rows){
     FILE* fp = fopen(path.c_str(), "rb");
     if(!fp) return false;
     if(fread(&h, 1, sizeof(h), fp) != sizeof(h) || memcmp(h.magic,"BWWF",4)!=0
-       || h.version != LongWaterfall::FILE_VERSION){
+       || !LwfCodec::is_known_version(h.version)){
         fclose(fp); return false;
     }
     fseek(fp, 0, SEEK_END);
     size = (uint64_t)ftell(fp);
+    rows = LwfCodec::count_rows(fp, h.version, h.fft_size, size);
     fclose(fp);
     return true;
 }
@@ -283,17 +462,23 @@ void refresh_size_live(){
     struct stat st{};
     if(stat(g_open.path.c_str(), &st) != 0) return;
     uint64_t sz = (uint64_t)st.st_size;
-    if(sz == g_open.total_size) return;
-    g_open.total_size = sz;
-    uint32_t old_rows = g_open.num_rows;
-    g_open.num_rows = (uint32_t)((sz - sizeof(LongWaterfall::FileHeader)) / g_open.hdr.fft_size);
-    if(g_open.num_rows != old_rows){
-        if(g_t1 >= old_rows - 0.5){
-            double w = g_t1 - g_t0;
-            g_t1 = g_open.num_rows;
-            g_t0 = g_t1 - w;
-            if(g_t0 < 0) g_t0 = 0;
+    const bool blocked = g_open.hdr.version == LwfCodec::FILE_VERSION_BLOCK;
+    // v4: 봉인 전 꼬리는 파일에 없음 → writer 메모리 사본을 seq 로 폴링.
+    bool pend_changed = false;
+    if(blocked){
+        uint64_t seq = g_open.pend_seq, row0 = g_open.pend_row0; uint32_t n = g_open.pend_n;
+        if(LongWaterfall::pending_rows(g_open.path, seq, row0, n, g_open.pend_rows)){
+            if(seq != g_open.pend_seq){
+                g_open.pend_seq = seq; g_open.pend_row0 = row0; g_open.pend_n = n;
+                pend_changed = true;
+            }
+        } else if(g_open.pend_n){
+            g_open.pend_n = 0; pend_changed = true;   // rotate/stop — 남은 꼬리는 이미 봉인됨
         }
+    }
+    if(sz == g_open.total_size && !pend_changed) return;
+    if(sz != g_open.total_size){
+        g_open.total_size = sz;
         // mmap 확장: LIVE 파일은 계속 자라므로 새 크기로 remap.
         if(g_open.fd >= 0){
             if(g_open.map){ munmap((void*)g_open.map, g_open.map_size); g_open.map = nullptr; g_open.map_size = 0; }
@@ -304,6 +489,26 @@ void refresh_size_live(){
                 posix_madvise(m, sz, POSIX_MADV_RANDOM);
             }
         }
+        // 디코드된 블록은 불변 — cache 유지, index 만 이어서 scan.
+        if(blocked && g_open.map) g_open.blk_idx.extend(g_open.map, g_open.map_size);
+    }
+    uint32_t old_rows = g_open.num_rows;
+    if(blocked){
+        // 꼬리는 index 끝에 바로 이어질 때만 (봉인 직후 stat/폴링 순서 어긋남은 다음 프레임에 맞춰짐).
+        g_open.num_rows = (uint32_t)g_open.blk_idx.rows;
+        if(g_open.pend_n && g_open.pend_row0 == g_open.blk_idx.rows) g_open.num_rows += g_open.pend_n;
+        if(pend_changed) g_tex_dirty = true;
+    } else {
+        g_open.num_rows = (uint32_t)((sz - sizeof(LongWaterfall::FileHeader)) / g_open.hdr.fft_size);
+    }
+    if(g_open.num_rows != old_rows){
+        if(g_t1 >= old_rows - 0.5){
+            double w = g_t1 - g_t0;
+            g_t1 = g_open.num_rows;
+            g_t0 = g_t1 - w;
+            if(g_t0 < 0) g_t0 = 0;
+        }
+        pyr_remap();
         g_tex_dirty = true;
         g_last_known_rows = g_open.num_rows;
     }
@@ -319,7 +524,6 @@ void rebuild_texture(float view_db_min, float view_db_max){
     double f_span = std::max(1.0, g_f1 - g_f0);
     uint32_t fft_sz = g_open.hdr.fft_size;
     if(fft_sz == 0) return;
-    int fft_half = (int)fft_sz / 2;
 
     // byte → dB → 메인 워터폴 윈도 [view_db_min, view_db_max] 재정규화.
     const float fmin = g_open.hdr.db_min;
@@ -336,28 +540,57 @@ void rebuild_texture(float view_db_min, float view_db_max){
         color_lut[b] = jet_color((uint8_t)(tt * 255.0f));
     }
 
-    // 가시 linear freq 범위 → 저장 bin 범위 (FFT-shift 풀기).
-    // linear: 0=lowest, fft_half=DC, fft_sz-1=highest. storage: 0=DC.
-    // bin = (idx<fft_half) ? idx+fft_half : idx-fft_half.
-    int lin_lo = (int)std::floor(g_f0); if(lin_lo < 0) lin_lo = 0;
-    int lin_hi = (int)std::ceil (g_f1); if(lin_hi > (int)fft_sz) lin_hi = fft_sz;
-    if(lin_hi <= lin_lo) lin_hi = lin_lo + 1;
-    int br_lo[2], br_hi[2]; int n_br = 0;
-    if(lin_hi <= fft_half){
-        br_lo[0] = lin_lo + fft_half; br_hi[0] = lin_hi + fft_half; n_br = 1;
-    } else if(lin_lo >= fft_half){
-        br_lo[0] = lin_lo - fft_half; br_hi[0] = lin_hi - fft_half; n_br = 1;
-    } else {
-        br_lo[0] = lin_lo + fft_half; br_hi[0] = (int)fft_sz;
-        br_lo[1] = 0;                 br_hi[1] = lin_hi - fft_half; n_br = 2;
+    // Pyramid LOD: 한 타일(4^k row × 4^k bin)이 픽셀 하나보다 작을 때까지 올라감.
+    // 화면 해상도에 맞는 레벨만 읽으므로 zoom-out 비용이 파일 길이와 무관.
+    int lod = 0;
+    const LwfPyramid::View& pyr = g_open.pyr;
+    {
+        double rows_per_col = t_span / W;
+        double bins_per_px  = f_span / H;
+        while(lod < pyr.levels &&
+              (double)LwfPyramid::level_factor(lod + 1) <= rows_per_col &&
+              (double)LwfPyramid::level_factor(lod + 1) <= bins_per_px &&
+              pyr.records(lod + 1) > 0) lod++;
     }
+    g_last_lod = lod;
+    const uint64_t lod_f = LwfPyramid::level_factor(lod);
+    const uint64_t lod_rows = lod > 0 ? pyr.records(lod) * lod_f : 0;  // pyramid 커버 범위
+
+    // 가시 linear freq 범위 → 저장 bin 범위 (FFT-shift 풀기). scale = 레벨 bin 폭.
+    // linear: 0=lowest, half=DC, bins-1=highest. storage: 0=DC.
+    // bin = (idx<half) ? idx+half : idx-half.
+    struct BinMap { int bins, half, n_br, br_lo[2], br_hi[2]; double scale; };
+    auto make_map = [&](uint64_t f) -> BinMap {
+        BinMap m{};
+        m.bins  = (int)(fft_sz / f);
+        m.half  = m.bins / 2;
+        m.scale = (double)f;
+        int lin_lo = (int)std::floor(g_f0 / m.scale); if(lin_lo < 0) lin_lo = 0;
+        int lin_hi = (int)std::ceil (g_f1 / m.scale); if(lin_hi > m.bins) lin_hi = m.bins;
+        if(lin_hi <= lin_lo) lin_hi = lin_lo + 1;
+        if(lin_hi <= m.half){
+            m.br_lo[0] = lin_lo + m.half; m.br_hi[0] = lin_hi + m.half; m.n_br = 1;
+        } else if(lin_lo >= m.half){
+            m.br_lo[0] = lin_lo - m.half; m.br_hi[0] = lin_hi - m.half; m.n_br = 1;
+        } else {
+            m.br_lo[0] = lin_lo + m.half; m.br_hi[0] = m.bins;
+            m.br_lo[1] = 0;               m.br_hi[1] = lin_hi - m.half; m.n_br = 2;
+        }
+        return m;
+    };
+    const BinMap map_base = make_map(1);
+    const bool   blocked  = (g_open.hdr.version == LwfCodec::FILE_VERSION_BLOCK);
+    const BinMap map_lod  = make_map(lod_f);
+    const bool   use_mean = g_pyr_mean;
 
-    std::vector<uint8_t> rowbuf(fft_sz);
-    std::vector<uint8_t> col_max(fft_sz, 0);  // 호이스팅: 컬럼마다 가시 bin만 zero.
+    std::vector<uint8_t>  rowbuf(fft_sz);
+    std::vector<uint8_t>  col_max(fft_sz, 0);  // 호이스팅: 컬럼마다 가시 bin만 zero.
+    std::vector<uint32_t> col_sum(use_mean ? fft_sz : 0);
 
     int rows_total = (int)t_span;
     int rows_per_col_max = 64;
     int rows_step = std::max(1, rows_total / (W * rows_per_col_max));
+    const int blocks_per_col_max = 8;   // v4 base fallback: 컬럼당 inflate 상한
 
     for(int x=0; x<W; x++){
         double t_a = g_t0 + (x      / (double)W) * t_span;
@@ -371,44 +604,99 @@ void rebuild_texture(float view_db_min, float view_db_max){
             for(int y=0; y<H; y++) g_pixel_buf[(size_t)y*W + x] = IM_COL32(20,20,25,255);
             continue;
         }
-        // 가시 bin 영역만 0으로 reset (max-hold 시작값).
-        for(int k=0; k<n_br; k++)
-            std::memset(col_max.data() + br_lo[k], 0, (size_t)(br_hi[k] - br_lo[k]));
+        // pyramid 가 아직 덮지 못한 꼬리(LIVE 성장분 등)는 base row 로 fallback.
+        const bool from_lod = lod > 0 && (uint64_t)rb <= lod_rows;
+        const BinMap& bm = from_lod ? map_lod : map_base;
+
+        // 가시 bin 영역만 0으로 reset (max-hold / 합산 시작값).
+        for(int k=0; k<bm.n_br; k++){
+            std::memset(col_max.data() + bm.br_lo[k], 0, (size_t)(bm.br_hi[k] - bm.br_lo[k]));
+            if(use_mean)
+                std::memset(col_sum.data() + bm.br_lo[k], 0,
+                            sizeof(uint32_t) * (size_t)(bm.br_hi[k] - bm.br_lo[k]));
+        }
+        auto accumulate = [&](const uint8_t* rb_ptr){
+            // 가시 bin만 누적 (off-screen bin 무시).
+            for(int k=0; k<bm.n_br; k++){
+                int b0 = bm.br_lo[k], b1 = bm.br_hi[k];
+                if(use_mean){
+                    uint32_t* cs = col_sum.data();
+                    for(int b=b0; b<b1; b++) cs[b] += rb_ptr[b];
+                } else {
+                    uint8_t* cm = col_max.data();
+                    for(int b=b0; b<b1; b++)
+                        if(rb_ptr[b] > cm[b]) cm[b] = rb_ptr[b];
+                }
+            }
+        };
 
         int n_sampled = 0;
-        for(int r=ra; r<rb; r += rows_step){
-            uint64_t off = sizeof(LongWaterfall::FileHeader) + (uint64_t)r * fft_sz;
-            const uint8_t* rb_ptr;
-            if(g_open.map && off + fft_sz <= g_open.map_size){
-                // mmap fast path — syscall 없음, page cache 직접 액세스.
-                rb_ptr = g_open.map + off;
-            } else {
-                fseek(g_open.fp, (long)off, SEEK_SET);
-                if(fread(rowbuf.data(), 1, fft_sz, g_open.fp) != fft_sz) break;
-                rb_ptr = rowbuf.data();
+        if(from_lod){
+            uint64_t ia = (uint64_t)ra / lod_f;
+            uint64_t ib = ((uint64_t)rb + lod_f - 1) / lod_f;
+            if(ib > pyr.records(lod)) ib = pyr.records(lod);
+            uint64_t step = std::max<uint64_t>(1, (ib - ia) / (uint64_t)rows_per_col_max);
+            for(uint64_t i=ia; i<ib; i += step){
+                accumulate(use_mean ? pyr.mean_row(lod, i) : pyr.max_row(lod, i));
+                if(++n_sampled >= rows_per_col_max) break;
+            }
+        } else if(blocked){
+            // v4: inflate 가 비용의 대부분 → 블록 단위로 골라 디코드하고, 디코드한 블록 안의
+            // 구간 행은 전부 누적 (행마다 블록을 새로 푸는 대신). 컬럼당 디코드 상한 blocks_per_col_max.
+            const LwfCodec::Index& idx = g_open.blk_idx;
+            uint64_t b0 = idx.block_of((uint64_t)ra);
+            uint64_t b1 = std::min<uint64_t>(idx.block_of((uint64_t)rb - 1) + 1, idx.offs.size());
+            uint64_t bstep = std::max<uint64_t>(1, (b1 - b0) / (uint64_t)blocks_per_col_max);
+            for(uint64_t bi = b0; bi < b1; bi += bstep){
+                uint32_t n = 0;
+                const uint8_t* bp = g_open.blk_cache.block(g_open.map, g_open.map_size, idx, fft_sz, bi, &n);
+                if(!bp) break;
+                uint64_t r0 = idx.row0[bi];
+                uint64_t lo = std::max<uint64_t>((uint64_t)ra, r0);
+                uint64_t hi = std::min<uint64_t>((uint64_t)rb, r0 + n);
+                for(uint64_t r = lo; r < hi; r++){ accumulate(bp + (r - r0) * fft_sz); n_sampled++; }
             }
-            // 가시 bin만 max-hold (off-screen bin 무시).
-            uint8_t* cm_ptr = col_max.data();
-            for(int k=0; k<n_br; k++){
-                int b0 = br_lo[k], b1 = br_hi[k];
-                for(int b=b0; b<b1; b++)
-                    if(rb_ptr[b] > cm_ptr[b]) cm_ptr[b] = rb_ptr[b];
+            // LIVE 미봉인 꼬리 (num_rows 는 pend_row0 == idx.rows 일 때만 이만큼 늘어나 있음)
+            if(g_open.pend_n && g_open.pend_row0 == idx.rows && (uint64_t)rb > idx.rows){
+                uint64_t lo = std::max<uint64_t>((uint64_t)ra, idx.rows);
+                for(uint64_t r = lo; r < (uint64_t)rb; r++){
+                    accumulate(g_open.pend_rows.data() + (r - idx.rows) * fft_sz); n_sampled++;
+                }
             }
-            if(++n_sampled >= rows_per_col_max) break;
+        } else {
+            for(int r=ra; r<rb; r += rows_step){
+                uint64_t off = sizeof(LongWaterfall::FileHeader) + (uint64_t)r * fft_sz;
+                const uint8_t* rb_ptr;
+                if(g_open.map && off + fft_sz <= g_open.map_size){
+                    // mmap fast path — syscall 없음, page cache 직접 액세스.
+                    rb_ptr = g_open.map + off;
+                } else {
+                    fseek(g_open.fp, (long)off, SEEK_SET);
+                    if(fread(rowbuf.data(), 1, fft_sz, g_open.fp) != fft_sz) break;
+                    rb_ptr = rowbuf.data();
+                }
+                accumulate(rb_ptr);
+                if(++n_sampled >= rows_per_col_max) break;
+            }
+        }
+        if(use_mean && n_sampled > 0){
+            for(int k=0; k<bm.n_br; k++)
+                for(int b=bm.br_lo[k]; b<bm.br_hi[k]; b++)
+                    col_max[b] = (uint8_t)(col_sum[b] / (uint32_t)n_sampled);
         }
         // Y axis: max-hold across all bins mapped to each pixel row (avoids
         // missing strong signals when many bins fall into one pixel).
         for(int y=0; y<H; y++){
-            double f_top = g_f1 - (y       / (double)H) * f_span;
-            double f_bot = g_f1 - ((y+1.0) / (double)H) * f_span;
+            double f_top = (g_f1 - (y       / (double)H) * f_span) / bm.scale;
+            double f_bot = (g_f1 - ((y+1.0) / (double)H) * f_span) / bm.scale;
             int idx_lo = (int)std::floor(std::min(f_top, f_bot));
             int idx_hi = (int)std::ceil(std::max(f_top, f_bot));
             if(idx_lo < 0) idx_lo = 0;
-            if(idx_hi > (int)fft_sz) idx_hi = fft_sz;
+            if(idx_hi > bm.bins) idx_hi = bm.bins;
             if(idx_hi <= idx_lo) idx_hi = idx_lo + 1;
             uint8_t mx = 0;
             for(int idx = idx_lo; idx < idx_hi; idx++){
-                int bin = (idx < fft_half) ? (idx + fft_half) : (idx - fft_half);
+                int bin = (idx < bm.half) ? (idx + bm.half) : (idx - bm.half);
                 if(col_max[bin] > mx) mx = col_max[bin];
             }
             g_pixel_buf[(size_t)y*W + x] = color_lut[mx];
@@ -527,10 +815,17 @@ void register_dl_callbacks_once(NetClient* cli){
 
 // ── Info modal renderer ──────────────────────────────────────────────────
 void draw_info_modal(){
-    if(!g_info_modal_open) return;
-    LongWaterfall::FileHeader h{};
-    uint64_t sz = 0;
-    bool ok = read_header_only(g_info_path, h, sz);
+    if(!g_info_modal_open){ g_info_read_path.clear(); return; }
+    struct stat ist{};
+    uint64_t cur_sz = stat(g_info_path.c_str(), &ist) == 0 ? (uint64_t)ist.st_size : 0;
+    if(g_info_read_path != g_info_path || cur_sz != g_info_size){   // LIVE 파일은 크기 바뀔 때 재계산
+        g_info_read_path = g_info_path;
+        g_info_ok = read_header_only(g_info_path, g_info_hdr, g_info_size, g_info_rows);
+        g_info_size = cur_sz;   // 실패해도 같은 크기면 재시도 안 함
+    }
+    const LongWaterfall::FileHeader& h = g_info_hdr;
+    const uint64_t sz = g_info_size, n_rows = g_info_rows;
+    const bool ok = g_info_ok;
 
     ImGui::SetNextWindowSize(ImVec2(520.f, 0.f));
     ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x*0.5f - 260.f,
@@ -551,7 +846,7 @@ void draw_info_modal(){
 
         int off_h = header_utc_offset(h);
         uint32_t row_rate = (uint32_t)std::max(1.0f, h.row_rate_hz);
-        uint64_t dur_sec = (uint64_t)((sz - sizeof(h)) / std::max<uint32_t>(1,h.fft_size)) / row_rate;
+        uint64_t dur_sec = n_rows / row_rate;
         uint64_t stop_utc = h.start_utc_unix + dur_sec;
 
         const float L = 110.f;
@@ -667,6 +962,7 @@ void draw_modal(FFTViewer& v, NetClient* cli){
     } else {
         // host의 LIVE 파일이면 file size 폴링 (JOIN 측 hist/live/ mirror 는 v4.6.0 에서 제거).
         if(g_open.path == live_path) refresh_size_live();
+        pyr_poll();
         const auto& h = g_open.hdr;
         int off_h = header_utc_offset(h);
         uint32_t row_rate = (uint32_t)std::max(1.0f, h.row_rate_hz);
@@ -689,8 +985,11 @@ void draw_modal(FFTViewer& v, NetClient* cli){
         }
         ImGui::Text("Start : %s", fmt_local_time(h.start_utc_unix, off_h).c_str());
         ImGui::Text("Stop  : %s", fmt_local_time(stop_utc, off_h).c_str());
-        ImGui::Text("Color : %.1f / %.1f dB (shared with main)",
-            v.display_power_min, v.display_power_max);
+        ImGui::Text("Color : %.1f / %.1f dB (shared with main)   Reduce : %s (M)   LOD : %s",
+            v.display_power_min, v.display_power_max,
+            g_pyr_mean ? "mean" : "max-hold",
+            g_last_lod > 0 ? ("1/" + std::to_string(LwfPyramid::level_factor(g_last_lod))).c_str()
+                           : (g_pyr_build.thr.joinable() ? "full (building)" : "full"));
         ImGui::Unindent(10.0f);
         ImGui::Dummy(ImVec2(0, 2));
         ImGui::Separator();
@@ -752,6 +1051,10 @@ void draw_modal(FFTViewer& v, NetClient* cli){
                 g_f0 = 0; g_f1 = h.fft_size;
                 g_tex_dirty = true;
             }
+            if(focused && !io.WantTextInput && ImGui::IsKeyPressed(ImGuiKey_M, false)){
+                g_pyr_mean = !g_pyr_mean;
+                g_tex_dirty = true;
+            }
             if(focused && !io.WantTextInput){
                 double span = g_t1 - g_t0;
                 double total = (double)g_open.num_rows;
@@ -1040,10 +1343,11 @@ void draw_modal(FFTViewer& v, NetClient* cli){
                             if(!n || n[0]=='.') continue;
                             if(!is_hist_filename(n)) continue;
                             std::string full = dir + "/" + n;
-                            LongWaterfall::FileHeader hh{}; uint64_t fsz=0;
-                            if(!read_header_only(full, hh, fsz)) continue;
+                            LongWaterfall::FileHeader hh{}; uint64_t fsz=0, nr=0;
+                            if(!read_header_only(full, hh, fsz, nr)) continue;
                             HistFileEntry e; e.path=full; e.base=n;
                             e.start_utc=hh.start_utc_unix; e.size=fsz;
+                            e.hdr=hh; e.rows=nr;
                             g_host_files.push_back(std::move(e));
                         }
                         closedir(d);
@@ -1057,10 +1361,9 @@ void draw_modal(FFTViewer& v, NetClient* cli){
                 // Active LIVE file is shown only in the LIVE tab — skip here.
                 for(auto& e : g_host_files){
                     if(e.path == live_path) continue;
-                    LongWaterfall::FileHeader hh{}; uint64_t fsz=0;
-                    read_header_only(e.path, hh, fsz);
+                    const LongWaterfall::FileHeader& hh = e.hdr;
                     Row r; r.id = e.path; r.base = e.base; r.size = e.size;
-                    r.rows = hh.fft_size > 0 ? (uint32_t)((fsz - sizeof(hh)) / hh.fft_size) : 0;
+                    r.rows = (uint32_t)e.rows;
                     r.row_rate = hh.row_rate_hz;
                     r.is_live = false; r.is_remote = false;
                     r.cf_hz = hh.center_freq_hz;
@@ -1177,10 +1480,11 @@ void draw_modal(FFTViewer& v, NetClient* cli){
                         if(!n || n[0]=='.') continue;
                         if(!is_hist_filename(n)) continue;
                         std::string full = BEWEPaths::hist_join_dir() + "/" + n;
-                        LongWaterfall::FileHeader hh{}; uint64_t fsz=0;
-                        if(!read_header_only(full, hh, fsz)) continue;
+                        LongWaterfall::FileHeader hh{}; uint64_t fsz=0, nr=0;
+                        if(!read_header_only(full, hh, fsz, nr)) continue;
                         HistFileEntry e; e.path=full; e.base=n;
                         e.start_utc=hh.start_utc_unix; e.size=fsz;
+                        e.hdr=hh; e.rows=nr;
                         g_join_files.push_back(std::move(e));
                     }
                     closedir(d);
@@ -1213,9 +1517,8 @@ void draw_modal(FFTViewer& v, NetClient* cli){
             for(auto& e : g_join_files){
                 bool sel = (g_selected.count(e.path) > 0) || (g_sel_path == e.path);
                 ImGui::PushID(e.path.c_str());
-                LongWaterfall::FileHeader hh{}; uint64_t fsz=0;
-                read_header_only(e.path, hh, fsz);
-                uint32_t rows_ct = hh.fft_size > 0 ? (uint32_t)((fsz - sizeof(hh)) / hh.fft_size) : 0;
+                const LongWaterfall::FileHeader& hh = e.hdr;
+                uint32_t rows_ct = (uint32_t)e.rows;
                 // ARCHIVE 동일 패턴
                 float pw   = ImGui::GetContentRegionAvail().x;
                 float fn_w = pw * 0.66f;
@@ -0,0 +1,297 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Long-Waterfall v4 block-compressed row storage (host writer / Central archive /
+// viewer 공용, header-only — zlib 만 의존).
+//
+// v3 파일은 128B header 뒤에 raw row(fft_size bytes)가 그대로 이어진다.
+// v4 는 같은 128B header(version=0x0004) 뒤에 BLOCK_ROWS 행 단위 블록:
+//
+//   BlockHdr(16B) "BWBK" first_row n_rows flags comp_bytes
+//   zlib(rows)   — flags&BLK_DELTA 면 블록 첫 행 raw + 이후 행은 직전 행과의 차(mod 256)
+//
+// 노이즈 플로어가 대부분이라 블록마다 raw/delta 중 작은 쪽을 택한다.
+// 블록 행 수는 가변 (1..BLOCK_ROWS) — writer 는 BLOCK_ROWS 를 채워 봉인하되 저속 row rate 에선
+// SEAL_SEC 에 부분 블록, close 시 나머지. Central archive 는 누락 구간을 0 행 블록으로 채운다.
+// row → block 은 first_row 이분 탐색. 봉인 전 행은 파일에 없음 — LIVE viewer 는
+// LongWaterfall::pending_rows() 로 메모리 꼬리를 읽는다.
+// finalize 시 블록 offset 배열 + IndexFooter(24B)를 꼬리에 붙여 O(1) random seek.
+// LIVE/크래시 파일처럼 footer 가 없으면 블록 헤더 체인을 훑어 index 를 만든다.
+// 같은 블록 바이트가 LWF_LIVE_BLOCK 으로 Central 에 전달되어 archive 에 그대로 append.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <zlib.h>
+
+namespace LwfCodec {
+
+constexpr uint16_t FILE_VERSION_RAW   = 0x0003;   // raw rows
+constexpr uint16_t FILE_VERSION_BLOCK = 0x0004;   // block-compressed rows
+constexpr uint32_t HEADER_BYTES = 128;            // == sizeof(LongWaterfall::FileHeader)
+constexpr uint32_t BLOCK_ROWS   = 32;             // 5 row/s 기준 6.4 s (최대)
+constexpr float    SEAL_SEC     = 30.0f;          // 부분 블록 봉인 상한 (저속 row rate 의 크래시 손실 상한)
+constexpr uint16_t BLK_DELTA    = 0x0001;
+
+#pragma pack(push, 1)
+struct BlockHdr {
+    char     magic[4];      // "BWBK"
+    uint32_t first_row;
+    uint16_t n_rows;        // 1..BLOCK_ROWS (SEAL_SEC / close / gap fill 블록은 < BLOCK_ROWS)
+    uint16_t flags;         // BLK_*
+    uint32_t comp_bytes;    // 뒤따르는 zlib 바이트
+};
+struct IndexFooter {
+    char     magic[4];      // "BWIX"
+    uint32_t n_blocks;      // 바로 앞에 uint64 offset × n_blocks
+    uint64_t total_rows;
+    uint64_t index_off;     // offset 배열 시작 위치
+};
+#pragma pack(pop)
+static_assert(sizeof(BlockHdr) == 16, "LwfCodec::BlockHdr must be 16");
+static_assert(sizeof(IndexFooter) == 24, "LwfCodec::IndexFooter must be 24");
+
+inline bool is_known_version(uint16_t v){ return v == FILE_VERSION_RAW || v == FILE_VERSION_BLOCK; }
+
+// rows = n × fft bytes. out = BlockHdr + zlib stream. scratch 는 재사용 버퍼.
+inline bool encode_block(const uint8_t* rows, uint32_t n, uint32_t fft, uint32_t first_row,
+                         std::vector<uint8_t>& out, std::vector<uint8_t>& scratch){
+    if(n == 0 || fft == 0) return false;
+    size_t raw_bytes = (size_t)n * fft;
+    uLongf bound = compressBound((uLong)raw_bytes);
+
+    // 후보 1: raw rows
+    std::vector<uint8_t> plain(sizeof(BlockHdr) + bound);
+    uLongf plain_len = bound;
+    if(compress2(plain.data() + sizeof(BlockHdr), &plain_len, rows, (uLong)raw_bytes,
+                 Z_DEFAULT_COMPRESSION) != Z_OK) return false;
+
+    // 후보 2: 시간축 delta (행 간 상관이 큰 정적 신호 구간에서 유리)
+    scratch.resize(raw_bytes);
+    memcpy(scratch.data(), rows, fft);
+    for(uint32_t r = 1; r < n; r++){
+        const uint8_t* cur  = rows + (size_t)r * fft;
+        const uint8_t* prev = cur - fft;
+        uint8_t*       d    = scratch.data() + (size_t)r * fft;
+        for(uint32_t b = 0; b < fft; b++) d[b] = (uint8_t)(cur[b] - prev[b]);
+    }
+    out.resize(sizeof(BlockHdr) + bound);
+    uLongf delta_len = bound;
+    bool delta_ok = n > 1 &&
+        compress2(out.data() + sizeof(BlockHdr), &delta_len, scratch.data(), (uLong)raw_bytes,
+                  Z_DEFAULT_COMPRESSION) == Z_OK;
+
+    BlockHdr h{};
+    memcpy(h.magic, "BWBK", 4);
+    h.first_row = first_row;
+    h.n_rows    = (uint16_t)n;
+    if(delta_ok && delta_len < plain_len){
+        h.flags      = BLK_DELTA;
+        h.comp_bytes = (uint32_t)delta_len;
+        out.resize(sizeof(BlockHdr) + delta_len);
+    } else {
+        h.flags      = 0;
+        h.comp_bytes = (uint32_t)plain_len;
+        plain.resize(sizeof(BlockHdr) + plain_len);
+        out.swap(plain);
+    }
+    memcpy(out.data(), &h, sizeof(h));
+    return true;
+}
+
+// blk 에서 BlockHdr 검증. avail = blk 이후 남은 바이트.
+inline bool parse_block_hdr(const uint8_t* blk, uint64_t avail, BlockHdr& h){
+    if(avail < sizeof(BlockHdr)) return false;
+    memcpy(&h, blk, sizeof(h));
+    if(memcmp(h.magic, "BWBK", 4) != 0) return false;
+    if(h.n_rows == 0 || h.n_rows > BLOCK_ROWS) return false;
+    return (uint64_t)h.comp_bytes <= avail - sizeof(BlockHdr);
+}
+
+// n 개 0 행 블록 (Central archive 누락 구간 채움). 0 행은 delta/raw 모두 수백 B 로 압축됨.
+inline bool encode_zero_block(uint32_t n, uint32_t fft, uint32_t first_row,
+                              std::vector<uint8_t>& out, std::vector<uint8_t>& scratch){
+    std::vector<uint8_t> zeros((size_t)n * fft, 0);
+    return encode_block(zeros.data(), n, fft, first_row, out, scratch);
+}
+
+// 블록 하나 → n_rows × fft bytes.
+inline bool decode_block(const uint8_t* blk, uint64_t avail, uint32_t fft,
+                         std::vector<uint8_t>& rows_out, uint32_t* n_rows_out = nullptr){
+    BlockHdr h;
+    if(!parse_block_hdr(blk, avail, h)) return false;
+    uLongf raw_bytes = (uLongf)h.n_rows * fft;
+    rows_out.resize(raw_bytes);
+    uLongf got = raw_bytes;
+    if(uncompress(rows_out.data(), &got, blk + sizeof(BlockHdr), h.comp_bytes) != Z_OK ||
+       got != raw_bytes) return false;
+    if(h.flags & BLK_DELTA){
+        for(uint32_t r = 1; r < h.n_rows; r++){
+            uint8_t*       cur  = rows_out.data() + (size_t)r * fft;
+            const uint8_t* prev = cur - fft;
+            for(uint32_t b = 0; b < fft; b++) cur[b] = (uint8_t)(cur[b] + prev[b]);
+        }
+    }
+    if(n_rows_out) *n_rows_out = h.n_rows;
+    return true;
+}
+
+// ── Block index over an in-memory (mmap) v4 file ────────────────────────
+// footer 가 있으면 그대로, 없으면 블록 체인 scan. LIVE 파일은 extend() 로 이어서 scan.
+struct Index {
+    std::vector<uint64_t> offs;     // block i 의 파일 offset
+    std::vector<uint64_t> row0;     // block i 의 first_row (블록 행 수 가변)
+    uint64_t rows      = 0;
+    uint64_t scan_pos  = HEADER_BYTES;
+    bool     finalized = false;     // footer 에서 읽음 → 더 이상 scan 불필요
+
+    void build(const uint8_t* m, uint64_t size){
+        *this = Index{};
+        if(size >= HEADER_BYTES + sizeof(IndexFooter)){
+            IndexFooter f;
+            memcpy(&f, m + size - sizeof(f), sizeof(f));
+            if(memcmp(f.magic, "BWIX", 4) == 0 &&
+               f.index_off + (uint64_t)f.n_blocks * 8 + sizeof(f) == size){
+                offs.resize(f.n_blocks);
+                if(f.n_blocks) memcpy(offs.data(), m + f.index_off, (size_t)f.n_blocks * 8);
+                row0.resize(f.n_blocks);
+                bool ok = true;
+                for(uint32_t i = 0; i < f.n_blocks && ok; i++){
+                    BlockHdr h;
+                    ok = offs[i] < f.index_off && parse_block_hdr(m + offs[i], f.index_off - offs[i], h);
+                    if(ok) row0[i] = h.first_row;
+                }
+                if(ok){
+                    rows = f.total_rows;
+                    finalized = true;
+                    return;
+                }
+                offs.clear(); row0.clear();      // footer 손상 → 체인 scan
+            }
+        }
+        extend(m, size);
+    }
+    void extend(const uint8_t* m, uint64_t size){
+        if(finalized) return;
+        BlockHdr h;
+        while(parse_block_hdr(m + scan_pos, size - scan_pos, h)){
+            if(h.first_row != rows) break;              // 체인 깨짐 → 여기까지만 유효
+            offs.push_back(scan_pos);
+            row0.push_back(rows);
+            rows     += h.n_rows;
+            scan_pos += sizeof(BlockHdr) + h.comp_bytes;
+            if(scan_pos >= size) break;
+        }
+    }
+    // row 를 포함하는 블록 (row >= rows 면 offs.size())
+    uint64_t block_of(uint64_t row) const {
+        if(row >= rows) return offs.size();
+        auto it = std::upper_bound(row0.begin(), row0.end(), row);
+        return (uint64_t)(it - row0.begin()) - 1;
+    }
+};
+
+// Decoded-block LRU cache — viewer 의 random seek 용.
+class BlockCache {
+public:
+    BlockCache() = default;
+    explicit BlockCache(size_t cap) : cap_(cap) {}
+    void clear(){ slots_.clear(); tick_ = 0; last_ = 0; }
+
+    // 블록 b 디코드 결과 (n_rows × fft bytes). 실패 시 nullptr.
+    // 직전 블록은 탐색 없이 바로 반환 — 같은 블록 행을 연달아 읽는 경우가 대부분.
+    const uint8_t* block(const uint8_t* m, uint64_t size, const Index& idx,
+                         uint32_t fft, uint64_t b, uint32_t* n_rows = nullptr){
+        if(b >= idx.offs.size()) return nullptr;
+        Slot* hit = (last_ < slots_.size() && slots_[last_].block == b) ? &slots_[last_] : nullptr;
+        if(!hit){
+            for(auto& s : slots_) if(s.block == b){ hit = &s; break; }
+        }
+        if(!hit){
+            if(slots_.size() < cap_){ slots_.emplace_back(); hit = &slots_.back(); }
+            else {
+                hit = &slots_[0];
+                for(auto& s : slots_) if(s.used < hit->used) hit = &s;
+            }
+            uint64_t off = idx.offs[b];
+            hit->block = UINT64_MAX;
+            if(!decode_block(m + off, size - off, fft, hit->data, &hit->n_rows)) return nullptr;
+            hit->block = b;
+        }
+        hit->used = ++tick_;
+        last_ = (size_t)(hit - slots_.data());
+        if(n_rows) *n_rows = hit->n_rows;
+        return hit->data.data();
+    }
+
+    // row 의 포인터 (fft bytes). 실패 시 nullptr.
+    const uint8_t* row(const uint8_t* m, uint64_t size, const Index& idx,
+                       uint32_t fft, uint64_t r){
+        uint64_t b = idx.block_of(r);
+        uint32_t n = 0;
+        const uint8_t* d = block(m, size, idx, fft, b, &n);
+        if(!d) return nullptr;
+        uint64_t in_blk = r - idx.row0[b];
+        return in_blk < n ? d + in_blk * fft : nullptr;
+    }
+
+private:
+    struct Slot { uint64_t block = UINT64_MAX; uint64_t used = 0; uint32_t n_rows = 0;
+                  std::vector<uint8_t> data; };
+    std::vector<Slot> slots_;
+    size_t   cap_  = 32;
+    size_t   last_ = 0;
+    uint64_t tick_ = 0;
+};
+
+// 꼬리 IndexFooter 읽기 (offset 배열이 footer 바로 앞에 맞게 놓였는지까지 확인).
+inline bool read_footer(FILE* fp, uint64_t size, IndexFooter& f){
+    return size >= HEADER_BYTES + sizeof(f) &&
+           fseek(fp, (long)(size - sizeof(f)), SEEK_SET) == 0 &&
+           fread(&f, 1, sizeof(f), fp) == sizeof(f) && memcmp(f.magic, "BWIX", 4) == 0 &&
+           f.index_off + (uint64_t)f.n_blocks * 8 + sizeof(f) == size;
+}
+
+// footer 없는 파일의 블록 헤더 체인 scan (블록 본문은 읽지 않음).
+// 반환 = 마지막 유효 블록 끝 offset (그 뒤는 크래시로 잘린 블록/쓰레기).
+inline uint64_t scan_chain(FILE* fp, uint64_t size, uint64_t& rows,
+                           std::vector<uint64_t>* offs = nullptr){
+    uint64_t pos = HEADER_BYTES;
+    rows = 0;
+    BlockHdr h;
+    while(pos + sizeof(h) <= size){
+        if(fseek(fp, (long)pos, SEEK_SET) != 0 || fread(&h, 1, sizeof(h), fp) != sizeof(h)) break;
+        if(memcmp(h.magic, "BWBK", 4) != 0 || h.first_row != rows) break;
+        if(pos + sizeof(h) + h.comp_bytes > size) break;
+        if(offs) offs->push_back(pos);
+        rows += h.n_rows;
+        pos  += sizeof(h) + h.comp_bytes;
+    }
+    return pos;
+}
+
+// 파일 핸들로 row 수 계산 (목록/Info 용). footer 있으면 O(1), 없으면 체인 scan.
+inline uint64_t count_rows(FILE* fp, uint16_t version, uint32_t fft, uint64_t size){
+    if(fft == 0 || size < HEADER_BYTES) return 0;
+    if(version != FILE_VERSION_BLOCK) return (size - HEADER_BYTES) / fft;
+    IndexFooter f;
+    if(read_footer(fp, size, f)) return f.total_rows;
+    uint64_t rows = 0;
+    scan_chain(fp, size, rows);
+    return rows;
+}
+
+// finalize: offset 배열 + footer append.
+inline bool write_footer(FILE* fp, const std::vector<uint64_t>& offs, uint64_t total_rows){
+    if(fseek(fp, 0, SEEK_END) != 0) return false;
+    IndexFooter f{};
+    memcpy(f.magic, "BWIX", 4);
+    f.n_blocks   = (uint32_t)offs.size();
+    f.total_rows = total_rows;
+    f.index_off  = (uint64_t)ftell(fp);
+    if(!offs.empty() && fwrite(offs.data(), 8, offs.size(), fp) != offs.size()) return false;
+    return fwrite(&f, 1, sizeof(f), fp) == sizeof(f);
+}
+
+} // namespace LwfCodec
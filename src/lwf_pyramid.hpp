@@ -0,0 +1,248 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Long-Waterfall mip pyramid sidecar (<hist>.pyr).
+//
+// HIST 파일(.bewehist/.bewewf)은 uint8 row × fft_size 를 ~5 row/s 로 쌓는다.
+// 24h 파일을 zoom-out 으로 열면 viewer 가 컬럼당 최대 64 row 를 샘플링해야
+// 해서 GB 단위 page-in + aliasing. sidecar 에 레벨별 축소 타일을 미리 쌓아
+// viewer 가 화면 해상도에 맞는 레벨을 바로 읽게 한다.
+//
+//   level k (1..levels): 시간 4^k row × 주파수 4^k bin → 1 tile
+//   tile = max-hold byte + mean byte
+//
+// Layout: Header(32B) 다음에 레코드가 "생성 순서대로" append 된다.
+//   base row n 번째(1-based)가 들어올 때 n%4==0 이면 level1, n%16==0 이면
+//   level2 ... 순으로 1개씩 기록. record(k) = max[bins_k] + mean[bins_k].
+// 순서가 결정적이므로 (k,i) 레코드 오프셋을 O(levels) 로 계산 가능 — 별도 인덱스 없음.
+// 크래시로 잘린 sidecar 도 파일 크기만으로 커버 범위를 복원한다.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace LwfPyramid {
+
+#pragma pack(push, 1)
+struct Header {
+    char     magic[4];      // "BWPY"
+    uint16_t version;       // 0x0001
+    uint16_t levels;        // 1..MAX_LEVELS (0 = fft 너무 작음, 레코드 없음)
+    uint32_t fft_size;      // base row bytes
+    uint8_t  reserved[20];  // pad to 32
+};
+#pragma pack(pop)
+static_assert(sizeof(Header) == 32, "LwfPyramid::Header must be 32");
+
+constexpr uint16_t VERSION    = 0x0001;
+constexpr int      MAX_LEVELS = 8;
+constexpr uint32_t MIN_BINS   = 64;     // 이보다 좁은 레벨은 만들지 않음
+
+inline std::string sidecar_path(const std::string& hist_path){ return hist_path + ".pyr"; }
+
+inline uint64_t level_factor(int k){ return 1ull << (2 * k); }            // 4^k
+inline uint32_t level_bins(uint32_t fft, int k){ return fft >> (2 * k); }
+inline uint64_t record_bytes(uint32_t fft, int k){ return 2ull * level_bins(fft, k); }
+
+// fft_size 로부터 레벨 수 결정 (writer/reader 동일 규칙).
+inline int level_count(uint32_t fft){
+    int k = 0;
+    while(k < MAX_LEVELS){
+        uint64_t f = level_factor(k + 1);
+        if(fft % f != 0) break;
+        if(level_bins(fft, k + 1) < MIN_BINS) break;
+        k++;
+    }
+    return k;
+}
+
+// base row n 개가 append 된 직후의 sidecar 크기.
+inline uint64_t bytes_after(uint32_t fft, int levels, uint64_t n){
+    uint64_t b = sizeof(Header);
+    for(int k = 1; k <= levels; k++) b += (n / level_factor(k)) * record_bytes(fft, k);
+    return b;
+}
+
+// level k, index i 레코드의 파일 오프셋. 같은 base row 시점엔 낮은 레벨이 먼저 기록됨.
+inline uint64_t record_offset(uint32_t fft, int levels, int k, uint64_t i){
+    uint64_t n = (i + 1) * level_factor(k);     // 이 레코드가 만들어지는 base row 수
+    uint64_t off = sizeof(Header);
+    for(int j = 1; j <= levels; j++){
+        uint64_t cnt;
+        if(j < k)       cnt = n / level_factor(j);
+        else if(j == k) cnt = i;
+        else            cnt = (n - 1) / level_factor(j);
+        off += cnt * record_bytes(fft, j);
+    }
+    return off;
+}
+
+// sidecar 크기 → 완전히 반영된 base row 수 (bytes_after(n) <= size 인 최대 n).
+inline uint64_t rows_covered(uint32_t fft, int levels, uint64_t size){
+    if(levels <= 0 || size < sizeof(Header)) return 0;
+    uint64_t lo = 0, hi = 1;
+    while(bytes_after(fft, levels, hi) <= size) hi <<= 1;
+    while(hi - lo > 1){
+        uint64_t mid = lo + (hi - lo) / 2;
+        if(bytes_after(fft, levels, mid) <= size) lo = mid; else hi = mid;
+    }
+    return lo;
+}
+
+inline bool header_ok(const Header& h, uint32_t fft){
+    return memcmp(h.magic, "BWPY", 4) == 0 && h.version == VERSION &&
+           h.fft_size == fft && h.levels == (uint16_t)level_count(fft);
+}
+
+// ── Writer ───────────────────────────────────────────────────────────────
+// base row 를 append 할 때마다 호출. 각 레벨 accumulator 가 4 개 자식 row 를
+// 모으면 레코드를 기록하고 상위 레벨로 전달한다.
+class Builder {
+public:
+    ~Builder(){ close(); }
+
+    // resume=false → 새로 생성(truncate). resume=true → 기존 sidecar 를 이어서
+    // (최상위 레벨 경계까지 잘라내 accumulator 가 비어 있는 지점에서 재개).
+    // 성공 시 rows() = 이미 반영된 base row 수 — 호출자는 그 다음 row 부터 append.
+    bool open(const std::string& path, uint32_t fft, bool resume = false){
+        close();
+        fft_ = fft;
+        levels_ = level_count(fft);
+        rows_ = 0;
+        if(levels_ <= 0) return false;
+        if(resume){
+            fp_ = fopen(path.c_str(), "r+b");
+            if(fp_){
+                Header h{};
+                fseek(fp_, 0, SEEK_END);
+                uint64_t sz = (uint64_t)ftell(fp_);
+                fseek(fp_, 0, SEEK_SET);
+                if(fread(&h, 1, sizeof(h), fp_) == sizeof(h) && header_ok(h, fft)){
+                    uint64_t top = level_factor(levels_);
+                    uint64_t n = rows_covered(fft, levels_, sz);
+                    n -= n % top;
+                    uint64_t keep = bytes_after(fft, levels_, n);
+                    fflush(fp_);
+                    if(keep != sz && ftruncate(fileno(fp_), (off_t)keep) != 0){
+                        fclose(fp_); fp_ = nullptr;
+                    } else {
+                        fseek(fp_, 0, SEEK_END);
+                        rows_ = n;
+                    }
+                } else {
+                    fclose(fp_); fp_ = nullptr;
+                }
+            }
+        }
+        if(!fp_){
+            fp_ = fopen(path.c_str(), "wb");
+            if(!fp_) return false;
+            Header h{};
+            memcpy(h.magic, "BWPY", 4);
+            h.version  = VERSION;
+            h.levels   = (uint16_t)levels_;
+            h.fft_size = fft;
+            if(fwrite(&h, 1, sizeof(h), fp_) != sizeof(h)){ fclose(fp_); fp_ = nullptr; return false; }
+        }
+        for(int k = 1; k <= levels_; k++){
+            Acc& a = acc_[k];
+            uint32_t nb = level_bins(fft, k);
+            a.mx.assign(nb, 0);
+            a.sum.assign(nb, 0);
+            a.out.resize((size_t)nb * 2);
+            a.n = 0;
+        }
+        return true;
+    }
+
+    void close(){
+        if(fp_){ fflush(fp_); fclose(fp_); fp_ = nullptr; }
+    }
+
+    bool     is_open() const { return fp_ != nullptr; }
+    uint64_t rows() const    { return rows_; }
+
+    // row = fft_size bytes (저장 순서, FFT-shift 없음).
+    void append(const uint8_t* row){
+        if(!fp_) return;
+        rows_++;
+        if(feed(1, row, row)) fflush(fp_);
+    }
+
+private:
+    struct Acc {
+        std::vector<uint8_t>  mx;
+        std::vector<uint32_t> sum;
+        std::vector<uint8_t>  out;   // max[nb] + mean[nb]
+        int n = 0;
+    };
+
+    // in_mx / in_mean = 레벨 k-1 의 row (bins_{k-1}). 레코드를 기록했으면 true.
+    bool feed(int k, const uint8_t* in_mx, const uint8_t* in_mean){
+        Acc& a = acc_[k];
+        uint32_t nb = (uint32_t)a.mx.size();
+        uint8_t*  mx  = a.mx.data();
+        uint32_t* sum = a.sum.data();
+        for(uint32_t b = 0; b < nb; b++){
+            const uint8_t* pm = in_mx + (size_t)b * 4;
+            const uint8_t* pa = in_mean + (size_t)b * 4;
+            uint8_t m = mx[b];
+            if(pm[0] > m) m = pm[0];
+            if(pm[1] > m) m = pm[1];
+            if(pm[2] > m) m = pm[2];
+            if(pm[3] > m) m = pm[3];
+            mx[b] = m;
+            sum[b] += (uint32_t)pa[0] + pa[1] + pa[2] + pa[3];
+        }
+        if(++a.n < 4) return false;
+        uint8_t* out_mx   = a.out.data();
+        uint8_t* out_mean = a.out.data() + nb;
+        memcpy(out_mx, mx, nb);
+        for(uint32_t b = 0; b < nb; b++) out_mean[b] = (uint8_t)((sum[b] + 8) / 16);
+        fwrite(a.out.data(), 1, a.out.size(), fp_);
+        memset(mx, 0, nb);
+        memset(sum, 0, (size_t)nb * sizeof(uint32_t));
+        a.n = 0;
+        if(k < levels_) feed(k + 1, out_mx, out_mean);
+        return true;
+    }
+
+    FILE*    fp_     = nullptr;
+    uint32_t fft_    = 0;
+    int      levels_ = 0;
+    uint64_t rows_   = 0;
+    Acc      acc_[MAX_LEVELS + 1];
+};
+
+// ── Reader view over a mapped sidecar ────────────────────────────────────
+struct View {
+    const uint8_t* map    = nullptr;
+    uint64_t       size   = 0;
+    uint32_t       fft    = 0;
+    int            levels = 0;
+    uint64_t       rows   = 0;      // base row coverage
+
+    // map 은 호출자 소유. header 불일치면 false (levels=0).
+    bool attach(const uint8_t* m, uint64_t sz, uint32_t fft_size){
+        *this = View{};
+        if(!m || sz < sizeof(Header)) return false;
+        Header h;
+        memcpy(&h, m, sizeof(h));
+        if(!header_ok(h, fft_size)) return false;
+        map = m; size = sz; fft = fft_size; levels = h.levels;
+        rows = rows_covered(fft, levels, sz);
+        return true;
+    }
+    uint64_t records(int k) const { return levels > 0 ? rows / level_factor(k) : 0; }
+    // max row (bins_k bytes); mean row 는 바로 뒤 bins_k bytes.
+    const uint8_t* max_row(int k, uint64_t i) const {
+        return map + record_offset(fft, levels, k, i);
+    }
+    const uint8_t* mean_row(int k, uint64_t i) const {
+        return max_row(k, i) + level_bins(fft, k);
+    }
+};
+
+} // namespace LwfPyramid
@@ -1,6 +1,8 @@
 #include "fft_viewer.hpp"
 #include "bewe_paths.hpp"
 #include "session_args.hpp"
+#include "replay.hpp"
+#include "trace.hpp"
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
@@ -35,6 +37,8 @@ static bool starts_with(const char* s, const char* prefix){
 static void parse_args(int argc, char** argv){
     for(int i = 1; i < argc; i++){
         const char* a = argv[i];
+        int used = replay_parse_arg(argc, argv, i);
+        if(used >= 0){ i += used; continue; }
         if(std::strcmp(a, "--sdr") == 0 && i+1 < argc){
             std::string v = argv[i+1];
             if(v == "bladerf" || v == "rtlsdr" || v == "pluto"){
@@ -44,6 +48,9 @@ static void parse_args(int argc, char** argv){
                 fprintf(stderr, "[BEWE] unknown --sdr '%s' (use bladerf|rtlsdr|pluto)\n", v.c_str());
             }
             i++;
+        } else if(std::strcmp(a, "--metrics-port") == 0 && i+1 < argc){
+            g_metrics_port = std::atoi(argv[i+1]);
+            i++;
         } else if(starts_with(a, "--session-mode=")){
             std::string v = a + std::strlen("--session-mode=");
             if(v == "host" || v == "join"){
@@ -64,12 +71,19 @@ static void parse_args(int argc, char** argv){
             fprintf(stderr,
                 "BE_WE options:\n"
                 "  --sdr bladerf|rtlsdr|pluto   force a specific SDR backend\n"
+                "  --metrics-port N             HOST Prometheus /metrics on 127.0.0.1:N (default 9771, 0=off;\n"
+                "                               if busy, next free of N+1..N+9)\n"
                 "  --session-mode=host|join     internal: child-process boot mode\n"
                 "  --station-id=<id>            internal: Central room id (JOIN)\n"
                 "  --station-name=<utf8>        internal: station display name\n"
                 "  --station-lat=<deg>          internal: station latitude (HOST)\n"
                 "  --station-lon=<deg>          internal: station longitude (HOST)\n"
-                "  -h, --help                   this message\n");
+                "  --replay <f.sigmf-data|synth[:MSPS]>  offline pipeline bench (no SDR/login)\n"
+                "    --replay-rate 1|N|max  --replay-secs S  --replay-loop  --replay-fft N\n"
+                "    --replay-cf MHz  --replay-ch LO:HI:am|fm|none[:mod,..]  --replay-report out.json\n"
+                "  -h, --help                   this message\n"
+                "env: BEWE_TRACE=1 (hot path tracer on)  BEWE_TRACE_FILE=out.json (dump at exit)\n"
+                "     BEWE_TRACE_EVENTS=N (per-thread ring)  — /trace/start|stop|clear, /trace?ms=N on metrics port\n");
         }
     }
 }
@@ -77,20 +91,24 @@ static void parse_args(int argc, char** argv){
 #ifdef BEWE_HEADLESS
 int main(int argc, char** argv){
     parse_args(argc, argv);
-    BEWEPaths::ensure_dirs();
     install_signal_handlers();
+    Trace::init_from_env();   // BEWE_TRACE=1 / BEWE_TRACE_FILE=out.json
+    if(!g_replay.src.empty()) return run_replay_bench();
+    BEWEPaths::ensure_dirs();
     run_cli_host();
     return 0;
 }
 #else
 int main(int argc, char** argv){
     parse_args(argc, argv);
+    install_signal_handlers();
+    Trace::init_from_env();   // BEWE_TRACE=1 / BEWE_TRACE_FILE=out.json
+    if(!g_replay.src.empty()) return run_replay_bench();
     BEWEPaths::ensure_dirs();
     setenv("GTK_IM_MODULE","none",1);
     setenv("QT_IM_MODULE","none",1);
     setenv("XMODIFIERS","@im=none",1);
     setenv("GLFW_IM_MODULE","none",1);
-    install_signal_handlers();
     // TLE fetch is now lazy: only when the user picks ALL in the sat tracker.
     run_streaming_viewer();
     return 0;
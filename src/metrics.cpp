@@ -0,0 +1,290 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace Metrics {
+
+namespace {
+enum Kind { K_COUNTER, K_GAUGE, K_HIST };
+
+struct Entry {
+    std::string name, help, labels;
+    Kind        kind = K_COUNTER;
+    Counter     c;
+    Gauge       g;
+    Histogram   h;
+    double      unit = 1.0;     // histogram le/_sum 노출 배율
+};
+
+// 정적 파괴 순서와 무관하게 (전역 static 참조가 종료 직전까지 inc 가능) → 해제하지 않음
+struct Reg {
+    std::mutex        mtx;        // entries 등록/render
+    std::deque<Entry> entries;    // deque: push_back 해도 기존 참조 유지
+    std::mutex        col_mtx;    // collectors (entries lock 과 분리 — collector 가 다른 lock 잡음)
+    std::map<int, std::function<void(Writer&)>> cols;
+    int               next_id = 1;
+};
+Reg& reg(){
+    static Reg* r = new Reg;
+    return *r;
+}
+
+Entry& get(const char* name, const char* help, const char* labels, Kind k, double unit = 1.0){
+    Reg& r = reg();
+    std::lock_guard<std::mutex> lk(r.mtx);
+    for(auto& e : r.entries)
+        if(e.kind == k && e.name == name && e.labels == labels) return e;
+    r.entries.emplace_back();
+    Entry& e = r.entries.back();
+    e.name = name; e.help = help ? help : ""; e.labels = labels ? labels : ""; e.kind = k;
+    e.unit = unit;
+    return e;
+}
+
+const char* type_str(Kind k){
+    return k == K_COUNTER ? "counter" : k == K_GAUGE ? "gauge" : "histogram";
+}
+
+void put_sample(std::string& out, const std::string& name, const std::string& labels, const char* val){
+    out += name;
+    if(!labels.empty()){ out += '{'; out += labels; out += '}'; }
+    out += ' '; out += val; out += '\n';
+}
+
+void put_hist(std::string& out, const Entry& e){
+    char v[32];
+    uint64_t cum = 0;
+    const std::string bn = e.name + "_bucket";
+    const std::string pre = e.labels.empty() ? "" : e.labels + ",";
+    for(int i = 0; i < Histogram::NB; i++){
+        cum += e.h.b[i].load(std::memory_order_relaxed);
+        char le[32];
+        if(i == Histogram::NB - 1) snprintf(le, sizeof(le), "+Inf");
+        else snprintf(le, sizeof(le), "%.12g", (double)(1ull << i) * e.unit);
+        snprintf(v, sizeof(v), "%llu", (unsigned long long)cum);
+        put_sample(out, bn, pre + "le=\"" + le + "\"", v);
+    }
+    snprintf(v, sizeof(v), "%.12g", (double)e.h.sum.load(std::memory_order_relaxed) * e.unit);
+    put_sample(out, e.name + "_sum", e.labels, v);
+    // _count = +Inf 버킷과 같아야 함 (observe 중 scrape 시 count 먼저 읽히면 어긋남) → cum 사용
+    snprintf(v, sizeof(v), "%llu", (unsigned long long)cum);
+    put_sample(out, e.name + "_count", e.labels, v);
+}
+
+// ── HTTP ───────────────────────────────────────────────────────────────────
+std::atomic<bool> g_http_stop{false};
+std::thread       g_http_thr;
+int               g_http_port = 0;   // 실제 bind 된 포트 (0 = 미기동)
+constexpr int     HTTP_PORT_TRY = 10;
+std::mutex        g_route_mtx;
+std::vector<std::pair<std::string, Route>> g_routes;
+
+void http_serve(int c){
+    timeval tv{1, 0};
+    setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(c, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    char req[2048]; size_t n = 0;
+    while(n < sizeof(req) - 1){
+        ssize_t r = recv(c, req + n, sizeof(req) - 1 - n, 0);
+        if(r <= 0) break;
+        n += (size_t)r; req[n] = 0;
+        if(strstr(req, "\r\n\r\n") || strstr(req, "\n\n")) break;
+    }
+    req[n] = 0;
+    std::string path;
+    if(!strncmp(req, "GET ", 4)){
+        const char* p = req + 4;
+        const char* e = p + strcspn(p, " \r\n");
+        path.assign(p, e);
+    }
+    std::string body, ctype = "text/plain; version=0.0.4";
+    if(path == "/" || path == "/metrics"){
+        body = render();
+    } else if(!path.empty()){
+        Route fn;
+        {
+            std::lock_guard<std::mutex> lk(g_route_mtx);
+            for(auto& r : g_routes)
+                if(!path.compare(0, r.first.size(), r.first)){ fn = r.second; break; }
+        }
+        if(fn){ ctype = "text/plain"; body = fn(path, ctype); }
+    }
+    bool ok = !body.empty();
+    if(!ok){ body = "not found\n"; ctype = "text/plain"; }
+    char hdr[256];
+    int hl = snprintf(hdr, sizeof(hdr),
+        "HTTP/1.0 %s\r\nContent-Type: %s; charset=utf-8\r\n"
+        "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+        ok ? "200 OK" : "404 Not Found", ctype.c_str(), body.size());
+    std::string resp(hdr, hl);
+    resp += body;
+    size_t sent = 0;
+    while(sent < resp.size()){
+        ssize_t r = send(c, resp.data() + sent, resp.size() - sent, MSG_NOSIGNAL);
+        if(r <= 0) break;
+        sent += (size_t)r;
+    }
+}
+
+void http_loop(int fd){
+    pthread_setname_np(pthread_self(), "metrics");
+    while(!g_http_stop.load()){
+        pollfd p{fd, POLLIN, 0};
+        if(poll(&p, 1, 250) <= 0) continue;
+        int c = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if(c < 0) continue;
+        http_serve(c);
+        close(c);
+    }
+    close(fd);
+}
+} // namespace
+
+Counter& counter(const char* name, const char* help, const char* labels){
+    return get(name, help, labels, K_COUNTER).c;
+}
+Gauge& gauge(const char* name, const char* help, const char* labels){
+    return get(name, help, labels, K_GAUGE).g;
+}
+Histogram& histogram(const char* name, const char* help, const char* labels, double unit){
+    return get(name, help, labels, K_HIST, unit).h;
+}
+
+double sum(const char* name){
+    Reg& r = reg();
+    std::lock_guard<std::mutex> lk(r.mtx);
+    double s = 0;
+    for(auto& e : r.entries){
+        if(e.name != name) continue;
+        if(e.kind == K_COUNTER) s += (double)e.c.get();
+        else if(e.kind == K_GAUGE) s += (double)e.g.get();
+    }
+    return s;
+}
+
+void Writer::family(const char* name, const char* type, const char* help){
+    if(!seen.insert(name).second) return;
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+}
+
+void Writer::sample(const char* name, const std::string& labels, double v){
+    char b[32];
+    snprintf(b, sizeof(b), "%.12g", v);
+    put_sample(out, name, labels, b);
+}
+
+std::string label(const char* k, const std::string& v){
+    std::string s = k;
+    s += "=\"";
+    for(char ch : v){
+        if(ch == '\\' || ch == '"'){ s += '\\'; s += ch; }
+        else if(ch == '\n') s += "\\n";
+        else s += ch;
+    }
+    s += '"';
+    return s;
+}
+
+int collector_add(std::function<void(Writer&)> fn){
+    Reg& r = reg();
+    std::lock_guard<std::mutex> lk(r.col_mtx);
+    int id = r.next_id++;
+    r.cols[id] = std::move(fn);
+    return id;
+}
+
+void collector_del(int id){
+    Reg& r = reg();
+    std::lock_guard<std::mutex> lk(r.col_mtx);
+    r.cols.erase(id);
+}
+
+std::string render(){
+    Reg& r = reg();
+    Writer w;
+    {
+        std::lock_guard<std::mutex> lk(r.mtx);
+        // 같은 이름 (라벨만 다른) 샘플은 한 family 로 연속 출력해야 함 → 이름순 정렬
+        std::vector<const Entry*> es;
+        es.reserve(r.entries.size());
+        for(auto& e : r.entries) es.push_back(&e);
+        std::stable_sort(es.begin(), es.end(),
+                         [](const Entry* a, const Entry* b){ return a->name < b->name; });
+        char v[32];
+        for(const Entry* e : es){
+            w.family(e->name.c_str(), type_str(e->kind), e->help.c_str());
+            if(e->kind == K_COUNTER){
+                snprintf(v, sizeof(v), "%llu", (unsigned long long)e->c.get());
+                put_sample(w.out, e->name, e->labels, v);
+            } else if(e->kind == K_GAUGE){
+                snprintf(v, sizeof(v), "%lld", (long long)e->g.get());
+                put_sample(w.out, e->name, e->labels, v);
+            } else {
+                put_hist(w.out, *e);
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lk(r.col_mtx);
+    for(auto& kv : r.cols) kv.second(w);
+    return std::move(w.out);
+}
+
+bool http_start(int port){
+    if(port <= 0 || g_http_thr.joinable()) return false;
+    // 포트 사용 중 (다른 HOST/Central 인스턴스) → 다음 포트로 최대 HTTP_PORT_TRY 개 시도
+    for(int p = port; p < port + HTTP_PORT_TRY && p <= 65535; p++){
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port = htons((uint16_t)p);
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // localhost 전용 (인증 없음)
+        if(bind(fd, (sockaddr*)&a, sizeof(a)) < 0 || listen(fd, 4) < 0){
+            int err = errno;
+            fprintf(stderr, "[METRICS] bind 127.0.0.1:%d failed: %s\n", p, strerror(err));
+            close(fd);
+            if(err == EADDRINUSE) continue;
+            return false;
+        }
+        g_http_stop.store(false);
+        g_http_port = p;
+        g_http_thr = std::thread(http_loop, fd);
+        fprintf(stderr, "[METRICS] serving http://127.0.0.1:%d/metrics\n", p);
+        return true;
+    }
+    return false;
+}
+
+int http_port(){ return g_http_port; }
+
+void http_stop(){
+    g_http_stop.store(true);
+    if(g_http_thr.joinable()) g_http_thr.join();
+    g_http_port = 0;
+}
+
+void http_route(const char* prefix, Route fn){
+    std::lock_guard<std::mutex> lk(g_route_mtx);
+    for(auto& r : g_routes)
+        if(r.first == prefix){ r.second = std::move(fn); return; }
+    g_routes.emplace_back(prefix, std::move(fn));
+}
+
+} // namespace Metrics
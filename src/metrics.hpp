@@ -0,0 +1,81 @@
+#pragma once
+// ── 운용 메트릭 레지스트리 (Prometheus text, localhost HTTP) ─────────────────
+//   Counter / Gauge / Histogram : hot path 는 relaxed atomic 1~3회 (lock 없음).
+//     등록은 이름+라벨 당 1회 (mutex) → 호출부는 `static auto& m = Metrics::counter(...)` 로 캐시.
+//     반환 참조는 프로세스 수명 동안 유효 (deque 저장, 해제 없음).
+//   collector : scrape 시점에만 계산하는 값 (ring lag, 스레드 CPU, 큐 깊이 등).
+//     소유 객체 수명에 묶어 add/del — del 은 진행 중 scrape 가 끝날 때까지 대기.
+//   Histogram : 정수 단위 (us, bytes …) log2 버킷, bucket i = x ≤ 2^i (마지막은 +Inf).
+//     노출은 Prometheus 기본 단위 — unit 배율로 le/_sum 만 환산 (예: us 관측 → 1e-6 → _seconds).
+// HOST(BE_WE) 와 Central 공용 — 외부 의존성 없음.
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+
+namespace Metrics {
+
+struct Counter {
+    std::atomic<uint64_t> v{0};
+    void inc(uint64_t n = 1){ v.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return v.load(std::memory_order_relaxed); }
+};
+
+struct Gauge {
+    std::atomic<int64_t> v{0};
+    void set(int64_t x){ v.store(x, std::memory_order_relaxed); }
+    void add(int64_t d){ v.fetch_add(d, std::memory_order_relaxed); }
+    int64_t get() const { return v.load(std::memory_order_relaxed); }
+};
+
+struct Histogram {
+    static constexpr int NB = 24;
+    std::atomic<uint64_t> b[NB] = {};
+    std::atomic<uint64_t> sum{0}, count{0};
+    void observe(uint64_t x){
+        int i = x <= 1 ? 0 : 64 - __builtin_clzll(x - 1);
+        if(i >= NB) i = NB - 1;
+        b[i].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(x, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// labels: Prometheus 라벨 본문 그대로 (예: "kind=\"fft\""), 없으면 ""
+Counter&   counter  (const char* name, const char* help, const char* labels = "");
+Gauge&     gauge    (const char* name, const char* help, const char* labels = "");
+// unit: observe() 정수 1 당 노출 값 (us 로 재고 _seconds 로 내보내면 1e-6)
+Histogram& histogram(const char* name, const char* help, const char* labels = "", double unit = 1.0);
+
+// 같은 이름의 counter/gauge 전 라벨 합 (STATS 패킷 스냅샷용, 저빈도)
+double sum(const char* name);
+
+// scrape 시점 출력기. family() 는 이름당 HELP/TYPE 1회만 찍음.
+struct Writer {
+    std::string out;
+    std::set<std::string> seen;
+    void family(const char* name, const char* type, const char* help);
+    void sample(const char* name, const std::string& labels, double v);
+};
+
+// k="v" (값 escape: \ " 개행) — 스레드 이름 등 외부 문자열용
+std::string label(const char* k, const std::string& v);
+
+int  collector_add(std::function<void(Writer&)> fn);   // → id
+void collector_del(int id);
+
+std::string render();   // 전체 Prometheus text exposition
+
+// 127.0.0.1:port 에 GET /metrics 서빙 (port 0 = 비활성).
+// port 가 사용 중이면 port+1 … port+9 순으로 시도 — 실제 포트는 http_port() (미기동 0).
+bool http_start(int port);
+int  http_port();
+void http_stop();
+
+// 추가 경로 (예: "/trace") — path 가 prefix 로 시작하면 fn(path+query) 응답.
+// ctype 기본 "text/plain", fn 이 바꿀 수 있음. 빈 문자열 반환 = 404.
+using Route = std::function<std::string(const std::string& path, std::string& ctype)>;
+void http_route(const char* prefix, Route fn);
+
+} // namespace Metrics
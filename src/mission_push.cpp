@@ -6,7 +6,9 @@
 #include "net_protocol.hpp"
 #include "bewe_paths.hpp"
 #include "sigmf.hpp"
+#include "crc32c.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdio>
@@ -18,7 +20,9 @@
 #include <thread>
 #include <unordered_map>
 #include <vector>
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <dirent.h>
 
@@ -35,8 +39,12 @@ struct QueueItem {
 };
 
 struct AckEntry {
-    bool                 received = false;
+    bool                 received = false;   // PUSH_ACK (완료 or 실패)
     PktMissionFilePushAck ack{};
+    bool                 resumed  = false;   // PUSH_STATE RESUME 수신
+    uint64_t             have     = 0;       // Central 검증 prefix (최신 STATE)
+    uint32_t             have_crc = 0;
+    uint64_t             rewinds  = 0;       // REWIND 수신 횟수
 };
 
 FFTViewer*     g_v   = nullptr;
@@ -100,47 +108,152 @@ uint8_t alloc_transfer_id(){
     return 1;  // overflow fallback (collision 무시)
 }
 
-// Build BEWE packet (magic + type + len + payload) for MUX
-std::vector<uint8_t> make_bewe(uint8_t bewe_type, const void* payload, uint32_t plen){
+// Build BEWE packet (magic + type + len + payload) for MUX.
+// tail > 0: len 필드에 포함되지만 여기엔 없는 꼬리 (sendfile 로 뒤따르는 청크 바이트).
+std::vector<uint8_t> make_bewe(uint8_t bewe_type, const void* payload, uint32_t plen,
+                               uint32_t tail = 0){
     std::vector<uint8_t> out(9 + plen);
     out[0]='B'; out[1]='E'; out[2]='W'; out[3]='E';
     out[4] = bewe_type;
-    memcpy(out.data() + 5, &plen, 4);
+    uint32_t len = plen + tail;
+    memcpy(out.data() + 5, &len, 4);
     if(plen && payload) memcpy(out.data() + 9, payload, plen);
     return out;
 }
 
+// 원본 파일 read-only 매핑 (청크 CRC 계산용). sendfile 이 같은 page cache 를 쓰므로
+// CRC 로 한 번 읽힌 페이지가 그대로 소켓으로 나감.
+struct Mapping {
+    const uint8_t* p = nullptr;
+    size_t         n = 0;
+    ~Mapping(){ if(p) munmap((void*)p, n); }
+};
+
+// mux_loop 가 채운 ack 상태 대기 (tid). pred 가 true 거나 timeout/stop/Central 연결 끊김이면 반환.
+// 연결 끊김은 notify 가 없으므로 1 s 단위로 확인 (긴 COMMIT 대기가 끊긴 링크에 매달리지 않게).
+template<class Pred>
+void wait_ack(uint8_t tid, std::chrono::milliseconds ms, Pred pred){
+    auto deadline = std::chrono::steady_clock::now() + ms;
+    std::unique_lock<std::mutex> lk(ack_mtx);
+    auto done = [&]{
+        auto e = ack_map.find(tid);
+        return e == ack_map.end() || !running.load() || pred(e->second);
+    };
+    while(!done() && g_cli->is_central_connected()){
+        auto now = std::chrono::steady_clock::now();
+        if(now >= deadline) break;
+        ack_cv.wait_for(lk, std::min<std::chrono::steady_clock::duration>(deadline - now,
+                                                                          std::chrono::seconds(1)), done);
+    }
+}
+
+// Central 쪽 전체 파일 작업 (one-shot 수신 / .part readback / fdatasync) 대기 상한:
+// 파일 크기 비례 (200KB/s 가정 + 60 s, 최대 1 h) — 이전 one-shot 과 같은 기준
+std::chrono::seconds xfer_timeout(uint64_t total){
+    return std::chrono::seconds(std::min<uint64_t>(3600, 60 + total / (200ULL * 1024ULL)));
+}
+
+// COMMIT / 마지막 청크 뒤 PUSH_ACK 대기 → 성공이면 원본 + sidecar unlink. tid 는 여기서 해제.
+bool finish_ack(uint8_t tid, const QueueItem& it, std::chrono::seconds timeout){
+    wait_ack(tid, timeout, [](const AckEntry& a){ return a.received; });
+    bool ack_ok = false;
+    PktMissionFilePushAck ack{};
+    {
+        std::lock_guard<std::mutex> lk(ack_mtx);
+        auto f = ack_map.find(tid);
+        if(f != ack_map.end() && f->second.received){
+            ack = f->second.ack;
+            ack_ok = (ack.status == 0);
+        }
+        ack_map.erase(tid);
+    }
+    if(!running.load()){
+        fprintf(stderr, "[MissionPush] aborted tid=%u (worker stopped)\n", tid);
+        return false;
+    }
+    if(!ack_ok){
+        fprintf(stderr, "[MissionPush] tid=%u FAIL (ack received=%d status=%u msg='%s')\n",
+                tid, ack.transfer_id != 0, ack.status, ack.error_msg);
+        return false;
+    }
+    fprintf(stderr, "[MissionPush] tid=%u DONE (%lu bytes on Central) — unlink %s\n",
+            tid, (unsigned long)ack.total_bytes, it.path.c_str());
+    unlink(it.path.c_str());
+    unlink(SigMF::sidecar_path(it.path).c_str());
+    return true;
+}
+
+// 구버전 Central (resumable 미지원): META(REPLACE) + 청크 전부 + is_last → 완료 ACK 1회.
+// 재개 없음 — 실패하면 다음 시도는 처음부터.
+bool push_legacy(uint8_t tid, const QueueItem& it, PktMissionFilePushMeta meta,
+                 const std::shared_ptr<CentralClient::SendFile>& src, uint64_t total){
+    meta.mode = MFP_MODE_REPLACE;
+    auto meta_pkt = make_bewe(0x4E /*MISSION_FILE_PUSH_META*/, &meta, sizeof(meta));
+    g_cli->enqueue_relay_broadcast(meta_pkt.data(), meta_pkt.size(), /*no_drop=*/true);
+    fprintf(stderr, "[MissionPush] PUSH start tid=%u %s (%lu bytes, legacy) -> %s/%04d/%s/%s\n",
+            tid, it.path.c_str(), (unsigned long)total,
+            meta.key.station, it.year, it.code.c_str(), it.filename.c_str());
+
+    constexpr uint32_t CHUNK = 256 * 1024;
+    uint64_t off = 0;
+    do {
+        if(!running.load() || !g_cli->is_central_connected()){
+            std::lock_guard<std::mutex> lk(ack_mtx);
+            ack_map.erase(tid);
+            return false;
+        }
+        uint32_t n = (uint32_t)std::min<uint64_t>(CHUNK, total - off);
+        PktMissionFilePushData hd{};
+        hd.transfer_id = tid;
+        hd.is_last     = (off + n >= total) ? 1 : 0;
+        hd.offset      = off;
+        hd.chunk_bytes = n;
+        auto hdr = make_bewe(0x4F /*MISSION_FILE_PUSH_DATA*/, &hd, sizeof(hd), n);
+        if(n) g_cli->enqueue_relay_broadcast_file(hdr.data(), hdr.size(), src, off, n);
+        else  g_cli->enqueue_relay_broadcast(hdr.data(), hdr.size(), /*no_drop=*/true);
+        off += n;
+    } while(off < total);
+
+    return finish_ack(tid, it, xfer_timeout(total));
+}
+
 // 한 파일 push 시도. 성공 시 true(+ unlink), 실패 시 false(+ 파일 유지).
+// 실패해도 Central 에 검증된 prefix 가 남아 있어 다음 시도는 그 지점부터 이어 보냄.
 bool push_one(const QueueItem& it){
     if(!g_cli) return false;
-    FILE* fp = fopen(it.path.c_str(), "rb");
-    if(!fp){
-        fprintf(stderr, "[MissionPush] fopen FAIL %s errno=%d\n",
-                it.path.c_str(), errno);
-        return false;
-    }
-    fseeko(fp, 0, SEEK_END);
-    uint64_t total = (uint64_t)ftello(fp);
-    fseeko(fp, 0, SEEK_SET);
 
-    // station_name 결정
+    // station_name: 활성 미션 entry 의 mission_station_name
     std::string station;
-    if(g_v){
-        // FFTViewer의 mission_station_name (string-like getter 없음 → 직접 접근 필요)
-        // 대안: 활성 미션 entry에서 가져오기
-        // 안전책: 그냥 host_band station_name 캐시 (FFTViewer.station_name).
-        // 일단 viewer에서 추출하는 helper가 필요. 임시로 hostname or empty.
-        // 정확한 station: mission이 시작될 때 set된 mission_station_name.
-        // 여기선 viewer가 active mission entry에서 station_name을 알려주는 가정.
-        // Phase 1 메모리: station[64]는 mission_station_name과 동일.
-        station = g_v->mission_active_station_name();
-    }
+    if(g_v) station = g_v->mission_active_station_name();
     if(station.empty()){
         // 미션 IDLE 또는 station 미설정 → 조용히 skip + 큐 후미로 재시도.
-        fclose(fp);
         return false;
     }
 
+    auto src = std::make_shared<CentralClient::SendFile>();
+    src->fd = open(it.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(src->fd < 0){
+        fprintf(stderr, "[MissionPush] open FAIL %s errno=%d\n", it.path.c_str(), errno);
+        return false;
+    }
+    struct stat st{};
+    if(fstat(src->fd, &st) != 0) return false;
+    const uint64_t total = (uint64_t)st.st_size;
+    // 원본 fingerprint: 크기 + mtime (녹음 파일은 close 후 불변 — 바뀌면 Central partial 폐기)
+    const uint64_t file_id = (uint64_t)st.st_size * 0x9E3779B97F4A7C15ULL
+                           ^ ((uint64_t)st.st_mtim.tv_sec << 30) ^ (uint64_t)st.st_mtim.tv_nsec;
+
+    Mapping map;
+    if(total > 0){
+        void* p = mmap(nullptr, (size_t)total, PROT_READ, MAP_SHARED, src->fd, 0);
+        if(p == MAP_FAILED){
+            fprintf(stderr, "[MissionPush] mmap FAIL %s errno=%d\n", it.path.c_str(), errno);
+            return false;
+        }
+        map.p = (const uint8_t*)p; map.n = (size_t)total;
+        madvise(p, (size_t)total, MADV_SEQUENTIAL);
+    }
+
     uint8_t tid = alloc_transfer_id();
 
     // sidecar 읽기 (IQ: .sigmf-meta / audio: .info)
@@ -157,8 +270,12 @@ bool push_one(const QueueItem& it){
         }
     }
 
-    // META
-    PktMissionFilePushMeta meta{};
+    // META (resumable) + trailer
+    struct __attribute__((packed)) {
+        PktMissionFilePushMeta   meta;
+        PktMissionFilePushResume rs;
+    } mp{};
+    PktMissionFilePushMeta& meta = mp.meta;
     strncpy(meta.key.station, station.c_str(), sizeof(meta.key.station)-1);
     meta.key.year = (uint16_t)it.year;
     meta.key.subdir = it.subdir;
@@ -166,96 +283,125 @@ bool push_one(const QueueItem& it){
     strncpy(meta.key.filename, it.filename.c_str(), sizeof(meta.key.filename)-1);
     meta.total_bytes = total;
     meta.transfer_id = tid;
-    meta.mode = 0;  // replace
+    meta.mode = MFP_MODE_RESUME;
     if(!info_text.empty())
         strncpy(meta.info_data, info_text.c_str(), sizeof(meta.info_data)-1);
+    mp.rs.file_id = file_id;
 
     {
         std::lock_guard<std::mutex> lk(ack_mtx);
         ack_map[tid] = AckEntry{};
     }
+    auto drop_tid = [&]{
+        std::lock_guard<std::mutex> lk(ack_mtx);
+        ack_map.erase(tid);
+    };
 
-    auto meta_pkt = make_bewe(0x4E /*MISSION_FILE_PUSH_META*/, &meta, sizeof(meta));
-    g_cli->enqueue_relay_broadcast(meta_pkt.data(), meta_pkt.size(), /*no_drop=*/true);
+    // resumable 지원 여부는 Central 이 연결 직후 보내는 CENTRAL_CAPS 로 결정 (응답 timeout 으로 추정 안 함).
+    // 첫 패킷 전이면 잠깐 대기, 그래도 미확정이면 이번 시도만 실패 → 큐 재시도.
+    uint32_t caps = 0;
+    bool caps_known = g_cli->central_caps(caps);
+    for(int i = 0; !caps_known && i < 50 && running.load() && g_cli->is_central_connected(); i++){
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        caps_known = g_cli->central_caps(caps);
+    }
+    if(!caps_known){ drop_tid(); return false; }
+    if(!(caps & CENTRAL_CAP_PUSH_RESUME)) return push_legacy(tid, it, meta, src, total);
 
-    fprintf(stderr, "[MissionPush] PUSH start tid=%u %s (%lu bytes) -> %s/%04d/%s/%s\n",
-            tid, it.path.c_str(), (unsigned long)total,
-            station.c_str(), it.year, it.code.c_str(), it.filename.c_str());
+    auto meta_pkt = make_bewe(0x4E /*MISSION_FILE_PUSH_META*/, &mp, sizeof(mp));
+    g_cli->enqueue_relay_broadcast(meta_pkt.data(), meta_pkt.size(), /*no_drop=*/true);
 
-    // DATA chunks
-    constexpr uint32_t CHUNK = 256 * 1024;
-    std::vector<uint8_t> chunk(CHUNK);
-    uint64_t off = 0;
-    bool ok = true;
-    bool sent_any = false;
-    while(off < total || !sent_any){
-        if(!running.load()){ ok = false; break; }
-        uint32_t want = (uint32_t)std::min((uint64_t)CHUNK, total - off);
-        if(want > 0){
-            size_t got = fread(chunk.data(), 1, want, fp);
-            if(got != want){
-                fprintf(stderr, "[MissionPush] read short tid=%u want=%u got=%zu\n",
-                        tid, want, got);
-                ok = false; break;
-            }
-        }
-        // PUSH_DATA + raw chunk (BEWE payload = struct + raw)
-        PktMissionFilePushData hd{};
-        hd.transfer_id = tid;
-        hd.is_last = (off + want >= total) ? 1 : 0;
-        hd.offset = off;
-        hd.chunk_bytes = want;
-        std::vector<uint8_t> bewe_payload(sizeof(hd) + want);
-        memcpy(bewe_payload.data(), &hd, sizeof(hd));
-        if(want > 0) memcpy(bewe_payload.data() + sizeof(hd), chunk.data(), want);
-        auto pkt = make_bewe(0x4F /*MISSION_FILE_PUSH_DATA*/,
-                              bewe_payload.data(), (uint32_t)bewe_payload.size());
-        g_cli->enqueue_relay_broadcast(pkt.data(), pkt.size(), /*no_drop=*/true);
-        off += want;
-        sent_any = true;
-        if(want == 0) break;  // 빈 파일 1 chunk만
-    }
-    fclose(fp);
-    if(!ok){
+    // 재개 지점 (PUSH_STATE RESUME) — Central 이 기존 .part [0, have) 를 다시 읽어 검증한 뒤 응답
+    AckEntry e{};
+    wait_ack(tid, xfer_timeout(total), [](const AckEntry& a){ return a.resumed || a.received; });
+    {
         std::lock_guard<std::mutex> lk(ack_mtx);
-        ack_map.erase(tid);
+        auto f = ack_map.find(tid);
+        if(f != ack_map.end()) e = f->second;
+    }
+    if(!e.resumed){
+        fprintf(stderr, "[MissionPush] tid=%u no RESUME from Central (status=%u msg='%s')\n",
+                tid, e.ack.status, e.ack.error_msg);
+        drop_tid();
         return false;
     }
 
-    // ACK 대기 — 파일 크기 비례. 200KB/s 가정 (네트워크 매우 느린 경우까지 cover) +
-    // 60s base. 큰 hist 파일(수백 MB) 도 안정. 최소 60s, 최대 1시간 cap.
-    uint64_t timeout_sec = 60 + total / (200ULL * 1024ULL);
-    if(timeout_sec < 60)   timeout_sec = 60;
-    if(timeout_sec > 3600) timeout_sec = 3600;
-    bool ack_ok = false;
-    PktMissionFilePushAck ack{};
-    {
-        std::unique_lock<std::mutex> lk(ack_mtx);
-        ack_cv.wait_for(lk, std::chrono::seconds(timeout_sec), [&]{
-            auto it2 = ack_map.find(tid);
-            return it2 == ack_map.end() || it2->second.received || !running.load();
+    // Central prefix 를 로컬 파일과 대조 — 다르면 offset 0 부터 (Central 이 partial 리셋)
+    uint64_t acked = e.have <= total ? e.have : 0;
+    uint32_t fcrc  = acked ? Crc32c::extend(0, map.p, (size_t)acked) : 0;
+    if(acked != e.have || fcrc != e.have_crc){
+        fprintf(stderr, "[MissionPush] tid=%u Central prefix mismatch (have=%lu) — restart at 0\n",
+                tid, (unsigned long)acked);
+        acked = 0; fcrc = 0;
+    }
+    fprintf(stderr, "[MissionPush] PUSH start tid=%u %s (%lu bytes, resume at %lu) -> %s/%04d/%s/%s\n",
+            tid, it.path.c_str(), (unsigned long)total, (unsigned long)acked,
+            station.c_str(), it.year, it.code.c_str(), it.filename.c_str());
+
+    // DATA: sliding window (WINDOW 청크까지 ACK 없이), 청크 바이트는 sendfile
+    constexpr uint32_t CHUNK  = 256 * 1024;
+    constexpr uint32_t WINDOW = 8;
+    uint64_t sent = acked;
+    uint64_t rewind_seen = e.rewinds;
+    auto last_progress = std::chrono::steady_clock::now();
+    auto send_chunk = [&](uint64_t off, uint32_t n, uint8_t flags, uint32_t crc){
+        PktMissionFilePushData hd{};
+        hd.transfer_id = tid;
+        hd.flags       = flags;
+        hd.offset      = off;
+        hd.chunk_bytes = n;
+        hd.crc32c      = crc;
+        auto hdr = make_bewe(0x4F /*MISSION_FILE_PUSH_DATA*/, &hd, sizeof(hd), n);
+        if(n) g_cli->enqueue_relay_broadcast_file(hdr.data(), hdr.size(), src, off, n);
+        else  g_cli->enqueue_relay_broadcast(hdr.data(), hdr.size(), /*no_drop=*/true);
+    };
+    while(acked < total){
+        if(!running.load() || !g_cli->is_central_connected()){ drop_tid(); return false; }
+        while(sent < total && sent - acked < (uint64_t)WINDOW * CHUNK){
+            uint32_t n = (uint32_t)std::min<uint64_t>(CHUNK, total - sent);
+            send_chunk(sent, n, MFP_DATA_CRC, Crc32c::extend(0, map.p + sent, n));
+            sent += n;
+        }
+        wait_ack(tid, std::chrono::seconds(1), [&](const AckEntry& a){
+            return a.received || a.have > acked || a.rewinds != rewind_seen;
         });
-        auto it2 = ack_map.find(tid);
-        if(it2 != ack_map.end() && it2->second.received){
-            ack = it2->second.ack;
-            ack_ok = (ack.status == 0);
+        {
+            std::lock_guard<std::mutex> lk(ack_mtx);
+            auto f = ack_map.find(tid);
+            if(f == ack_map.end()) return false;
+            e = f->second;
+        }
+        if(e.received){
+            // 완료 전 ACK = Central 측 실패 (io error 등). partial 은 Central 에 남음.
+            fprintf(stderr, "[MissionPush] tid=%u FAIL at %lu (status=%u msg='%s')\n",
+                    tid, (unsigned long)acked, e.ack.status, e.ack.error_msg);
+            drop_tid();
+            return false;
+        }
+        if(e.have > acked && e.have <= sent){
+            fcrc  = Crc32c::extend(fcrc, map.p + acked, (size_t)(e.have - acked));
+            acked = e.have;
+            last_progress = std::chrono::steady_clock::now();
+        }
+        if(e.rewinds != rewind_seen){
+            rewind_seen = e.rewinds;
+            fprintf(stderr, "[MissionPush] tid=%u REWIND %lu -> %lu\n",
+                    tid, (unsigned long)sent, (unsigned long)acked);
+            sent = acked;
+        }
+        if(std::chrono::steady_clock::now() - last_progress > std::chrono::seconds(120)){
+            fprintf(stderr, "[MissionPush] tid=%u stalled at %lu/%lu — retry later\n",
+                    tid, (unsigned long)acked, (unsigned long)total);
+            drop_tid();
+            return false;
         }
-        ack_map.erase(tid);
-    }
-    if(!running.load()){
-        fprintf(stderr, "[MissionPush] aborted tid=%u (worker stopped)\n", tid);
-        return false;
-    }
-    if(!ack_ok){
-        fprintf(stderr, "[MissionPush] tid=%u FAIL (ack received=%d status=%u msg='%s')\n",
-                tid, ack.transfer_id != 0, ack.status, ack.error_msg);
-        return false;
     }
-    fprintf(stderr, "[MissionPush] tid=%u DONE (%lu bytes on Central) — unlink %s\n",
-            tid, (unsigned long)ack.total_bytes, it.path.c_str());
-    unlink(it.path.c_str());
-    unlink(SigMF::sidecar_path(it.path).c_str());
-    return true;
+
+    // COMMIT: 전체 파일 CRC32C → Central 이 fdatasync + readback + rename 후 ACK
+    send_chunk(total, 0, MFP_DATA_COMMIT, fcrc);
+    fprintf(stderr, "[MissionPush] tid=%u COMMIT %lu bytes crc32c=%08x\n",
+            tid, (unsigned long)total, fcrc);
+    return finish_ack(tid, it, xfer_timeout(total));
 }
 
 void worker_loop(){
@@ -324,6 +470,21 @@ void start(FFTViewer* v, CentralClient* cli){
                 }
             }
         });
+    // resumable PUSH 진행/재개 지점 (mux_loop 에서 호출)
+    cli->set_on_central_mf_push_state(
+        [](const uint8_t* bewe, size_t len){
+            if(len < 9 + sizeof(PktMissionFilePushState)) return;
+            const auto* s = reinterpret_cast<const PktMissionFilePushState*>(bewe + 9);
+            std::lock_guard<std::mutex> lk(ack_mtx);
+            auto it = ack_map.find(s->transfer_id);
+            if(it == ack_map.end()) return;
+            auto& e = it->second;
+            e.have     = s->have_bytes;
+            e.have_crc = s->have_crc;
+            if(s->reason == MFP_ST_RESUME) e.resumed = true;
+            if(s->reason == MFP_ST_REWIND) e.rewinds++;
+            ack_cv.notify_all();
+        });
     running.store(true);
     worker_thr = std::thread(worker_loop);
     fprintf(stderr, "[MissionPush] started\n");
@@ -10,6 +10,11 @@
 //   MissionPush::stop();                           // HOST 모드 종료 시
 //
 // 정책: ACK(status=0) 받으면 로컬 unlink (+.info도). 실패/timeout 시 다시 queue 후미로.
+//
+// 전송 (MFP_MODE_RESUME): Central 이 .part 에 검증된 prefix 를 유지 → 끊겨도 재시도는
+// 그 지점부터. 256 KB 청크마다 CRC32C, 최대 8 청크 in-flight (Central PUSH_STATE 가 ACK),
+// 끝에 전체 파일 CRC32C 로 COMMIT. 청크 바이트는 mmap(CRC) + sendfile(송신) — 복사 없음.
+// Central 이 CENTRAL_CAPS 에 CENTRAL_CAP_PUSH_RESUME 를 안 알리면 (구버전) one-shot REPLACE 전송.
 
 #include <cstdint>
 #include <string>
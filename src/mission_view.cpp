@@ -9,6 +9,7 @@
 #include "net_client.hpp"
 #include "bewe_paths.hpp"
 #include "sigmf.hpp"
+#include "lwf_pyramid.hpp"
 #include "login.hpp"
 #include "kst_time.hpp"
 
@@ -710,11 +711,12 @@ static const char* subdir_label(uint8_t s){
 }
 
 // .info sidecar 인지.
-// sidecar(.info / .sigmf-meta) 여부 — LOCAL 목록에서 숨김 (.sigmf-data 의 메타라 단독 표시 불필요).
+// sidecar(.info / .sigmf-meta / HIST .pyr) 여부 — LOCAL 목록에서 숨김 (단독 표시 불필요).
 static bool is_info_file(const std::string& name){
     size_t n = name.size();
     if(n >= 5  && name.compare(n - 5,  5,  ".info")       == 0) return true;
     if(n >= 11 && name.compare(n - 11, 11, ".sigmf-meta") == 0) return true;
+    if(n >= 4  && name.compare(n - 4,  4,  ".pyr")        == 0) return true;
     return false;
 }
 
@@ -740,6 +742,7 @@ static void process_delete_key(NetClient* cli){
         for(const std::string& full : g_sel_local_paths){
             unlink(full.c_str());
             unlink(SigMF::sidecar_path(full).c_str());
+            unlink(LwfPyramid::sidecar_path(full).c_str());
             n_local++;
         }
         g_sel_local_paths.clear();
@@ -1182,6 +1185,7 @@ static void local_context_menu(FFTViewer& v, NetClient* cli,
         if(ImGui::MenuItem("Delete")){
             unlink(full_path.c_str());
             unlink(SigMF::sidecar_path(full_path).c_str());
+            unlink(LwfPyramid::sidecar_path(full_path).c_str());
             // 로컬 파일 변경 → by[]/already_dl 캐시 무효화
             g_local_fs_gen.fetch_add(1, std::memory_order_relaxed);
             MissionView::show_toast("Local file deleted");
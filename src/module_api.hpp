@@ -68,6 +68,8 @@ void bewe_mod_rec_request(const char* id, const char* station, int ch, uint64_t
 void bewe_mod_rec_send(const char* id, uint64_t rec_id, uint32_t total, uint32_t off, const void* b, uint32_t n); // HOST→JOIN: WAV 청크 회신
 // HOST 워커 → 디코드 1건 방출: Central 전송(+로컬 뷰 반영). payload = 모듈 정의 레코드
 void bewe_mod_emit(FFTViewer& v, const char* id, const void* payload, size_t n);
+// 디코드 1건 → TM trigger pin (BEWE_TM_PIN=module 일 때 해당 채널 구간 SigMF 보존)
+void bewe_mod_tm_pin(FFTViewer& v, const char* id, int ch);
 
 // ── 채널별 디코드 레이트 통계 (코어 보관, 모듈이 on_data 에서 1건마다 bump) ──
 // key = (id, station_raw, ch). DEMOD 통합 테이블이 행마다 "N/min · 마지막수신" 표시용.
@@ -3,6 +3,7 @@
 #include "net_server.hpp"   // CH_EDIT 적용 시 broadcast_channel_sync
 #include "kst_time.hpp"     // 오늘 누적 디코드수 시드 (저장 JSONL = KST 일자)
 #include "login.hpp"        // CH_ADD owner = login_get_id()
+#include "pipe_stats.hpp"   // 디코드 레코드 카운터 (replay 벤치 리포트)
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
@@ -44,6 +45,18 @@ static const BeweModule* find_mod(const char* id){
     return nullptr;
 }
 
+// 모듈별 레코드 카운터 슬롯 (reg() 인덱스). 첫 emit 때 1회 등록, 이후 lock/map 없음.
+// 경쟁 등록은 무해 (record_slot 이 같은 주소 반환).
+static constexpr size_t REC_SLOT_MAX = 32;
+static std::atomic<std::atomic<uint64_t>*> g_rec_slot[REC_SLOT_MAX];
+static std::atomic<uint64_t>* rec_slot(const BeweModule* m){
+    size_t i = (size_t)(m - reg().data());
+    if(i >= REC_SLOT_MAX) return PipeStats::record_slot(m->id);
+    std::atomic<uint64_t>* s = g_rec_slot[i].load(std::memory_order_acquire);
+    if(!s){ s = PipeStats::record_slot(m->id); g_rec_slot[i].store(s, std::memory_order_release); }
+    return s;
+}
+
 // ── 송신 백엔드 ──
 static std::function<bool(const void*, uint32_t)> g_send_up;     // JOIN→Central
 static std::function<bool(const void*, uint32_t)> g_broadcast;   // HOST→relay(Central)
@@ -496,6 +509,7 @@ void bewe_mod_ch_stat(const char* id, const char* station, int ch, int64_t now_m
 void bewe_mod_emit(FFTViewer& v, const char* id, const void* payload, size_t n){
     const BeweModule* m = find_mod(id);
     if(!m) return;
+    rec_slot(m)->fetch_add(1, std::memory_order_relaxed);
     // MpData 봉투 (station 명시 — 어느 기지의 복조 데이터인지)
     std::vector<uint8_t> body(sizeof(MpData) + n);
     auto* d = reinterpret_cast<MpData*>(body.data());
@@ -507,6 +521,10 @@ void bewe_mod_emit(FFTViewer& v, const char* id, const void* payload, size_t n){
     if(m->on_data) m->on_data(v, g_my_station, (const uint8_t*)payload, n);
 }
 
+void bewe_mod_tm_pin(FFTViewer& v, const char* id, int ch){
+    v.tm_pin_channel(TmTier::TRIG_MODULE, ch, true, id);
+}
+
 // ── JOIN/뷰어 framework ─────────────────────────────────────────────────────
 bool bewe_mod_recv(const char* id){
     std::lock_guard<std::mutex> lk(g_fw_mtx);
@@ -5,6 +5,8 @@
 #include "acars_module.hpp"
 #include "acars_decode.hpp"
 #include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <algorithm>
 #include <chrono>
@@ -52,6 +54,7 @@ void worker(FFTViewer& v, int ch_idx){
     const size_t BATCH  =(size_t)cap_decim*actual_asr/50;
     std::atomic<size_t>& my_rp = worker_rp(ch_idx);
     my_rp.store(v.ring_wp.load());
+    PipeStats::ReaderScope rs_(my_rp, "acars", ch_idx);
 
     bool hold_prev=false;
     while(!worker_stop_req(ch_idx) && !v.sdr_stream_error.load() && ch.filter_active){
@@ -89,6 +92,7 @@ void worker(FFTViewer& v, int ch_idx){
         if(lag==0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("mod", "acars_batch", avail);
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
             float si=v.ring[pos*2]*inv_scale, sq=v.ring[pos*2+1]*inv_scale;
@@ -238,6 +238,7 @@ void host_emit(FFTViewer& v, AcarsMsg m){
     store_append(m);
     WireMsg w; msg_to_wire(m, w);
     bewe_mod_emit(v, "acars", &w, sizeof(w));
+    bewe_mod_tm_pin(v, "acars", m.ch);
 }
 
 // ── framework 데이터 수신 (라이브 + 히스토리 공용) ──────────────────────────
@@ -6,6 +6,8 @@
 #include "adsb_module.hpp"
 #include "adsb_decode.hpp"
 #include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <algorithm>
 #include <chrono>
@@ -53,6 +55,7 @@ void worker(FFTViewer& v, int ch_idx){
     const size_t BATCH  =(size_t)(msr/50);                 // ~20 ms 입력
     std::atomic<size_t>& my_rp = worker_rp(ch_idx);
     my_rp.store(v.ring_wp.load());
+    PipeStats::ReaderScope rs_(my_rp, "adsb", ch_idx);
 
     bool hold_prev=false;
     while(!worker_stop_req(ch_idx) && !v.sdr_stream_error.load() && ch.filter_active){
@@ -89,6 +92,7 @@ void worker(FFTViewer& v, int ch_idx){
         if(lag==0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("mod", "adsb_batch", avail);
         mag.clear();
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
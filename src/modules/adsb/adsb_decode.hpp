@@ -14,6 +14,19 @@
 //
 // 해독 흐름: magnitude 버퍼 → 프리앰블 상관 → half-chip 슬라이싱 → 비트팩 →
 //            CRC-24(필요시 1-bit 정정) → DF/ME 필드 추출(콜사인/고도/CPR위치/속도).
+//
+// 검출 구조:
+//   • magnitude prefix sum (double) 을 청크마다 증분 갱신 → 모든 0.5 µs 윈도우 평균이
+//     cs[j+b]-cs[j+a] 한 번 (µs 오프셋 → 샘플 [a,b) 표는 reset 시 1회 계산).
+//   • 1차 게이트: 청크 전체 정수 오프셋에 대해 분기 없는 루프 한 번 (-O3 자동
+//     벡터화) → 펄스/골/정적부 평균 에너지 비교 통과 마스크.
+//   • 통과 오프셋은 1 µs 이내 이웃끼리 한 후보 묶음. 묶음 구간을 1/4 샘플 위상
+//     간격으로 정밀 판정/채점 (분수 윈도우 = prefix sum 선형 보간) → 점수 상위
+//     위상부터 슬라이싱/CRC, 첫 통과 채택. 2.4 MHz 처럼 half-chip 이 1.2 샘플인
+//     레이트에서 정수 오프셋 윈도우의 비트 경계 어긋남 제거.
+//   • 버퍼는 [이전 꼬리 | 새 샘플] 선형 구간. 소비 후 꼬리(≤ 한 프레임)만 앞으로
+//     당기고 prefix sum 은 재기준화 — 전체 insert/erase 없음.
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <cmath>
@@ -35,32 +48,54 @@ public:
         sr  = sample_rate>1.0 ? sample_rate : 2400000.0;
         spb = sr/1e6;                 // samples per µs (= per bit)
         ch  = ch_idx;
-        buf.clear(); samp_base=0; cpr.clear(); roster.clear();
+        buf.clear(); cs.assign(1, 0.0); samp_base=0; cpr.clear(); roster.clear();
+        build_windows();
         build_syndrome();
     }
 
     // 워커가 magnitude 샘플 묶음을 투입. 내부에서 프리앰블 스캔 + 해독.
     void process(const float* mag, size_t n){
         dg_samp += (long)n;
-        for(size_t i=0;i<n;i++) if(mag[i]>dg_maxmag) dg_maxmag=mag[i];
-        buf.insert(buf.end(), mag, mag+n);
-        size_t need = (size_t)((PRE_US + 112.0)*spb) + 8;     // 8µs 프리앰블 + 최장 프레임
+        size_t old = buf.size();
+        buf.resize(old + n);
+        cs.resize(old + n + 1);
+        float mx = dg_maxmag;
+        double acc = cs[old];
+        for(size_t i=0;i<n;i++){
+            float m = mag[i];
+            buf[old+i] = m;
+            acc += m; cs[old+i+1] = acc;
+            if(m > mx) mx = m;
+        }
+        dg_maxmag = mx;
         if(buf.size() < need) return;
         size_t limit = buf.size() - need;
+
+        scan_preambles(limit);
+
+        // 후보 묶음: 통과 오프셋 j 부터 1 µs 이내 → 분수 위상 채점 → 상위 위상 순 해독
+        const size_t span = (size_t)std::ceil(spb);
         size_t j = 0;
         while(j <= limit){
-            if(preamble_ok(j)){
-                dg_pre++;
-                int adv = decode_at(j);
-                if(adv>0){ j += (size_t)adv; continue; }
-                else dg_fail++;
+            if(!pre_ok[j]){ j++; continue; }
+            dg_pre++;
+            size_t end = j;
+            for(size_t k=j+1; k<=std::min(limit, j+span); k++) if(pre_ok[k]) end = k;
+            struct Cand { double x; float score; } cand[64]; int nc = 0;
+            double x1 = std::min((double)end + 0.75, (double)limit);
+            for(double x=(double)j-0.75; x<=x1 && nc<64; x+=0.25){
+                if(x < 0) continue;
+                float sc = frac_score(x);
+                if(sc > 0.f) cand[nc++] = Cand{x, sc};
             }
-            j++;
-        }
-        if(j>0){
-            samp_base += (double)j;
-            buf.erase(buf.begin(), buf.begin()+j);
+            std::sort(cand, cand+nc, [](const Cand& a, const Cand& b){ return a.score > b.score; });
+            int adv = 0; double at = (double)j;
+            for(int c=0; c<nc && c<MAX_TRIES && adv<=0; c++){ at = cand[c].x; adv = decode_at(at); }
+            if(adv > 0){ j = (size_t)at + (size_t)adv; continue; }
+            dg_fail++;
+            j = end + 1;
         }
+        consume(j);
     }
 
 private:
@@ -68,7 +103,102 @@ private:
 
     double sr=2400000.0, spb=2.4, samp_base=0;
     int    ch=0;
-    std::vector<float> buf;
+    std::vector<float>  buf;      // [이전 꼬리 | 새 샘플]
+    std::vector<double> cs;       // cs[k] = Σ buf[0..k)   (size = buf.size()+1)
+    std::vector<uint8_t> pre_ok;  // 오프셋별 프리앰블 1차 통과
+
+    // ── µs 윈도우 [u0, u0+0.5) → 샘플 오프셋 [a, b) (오프셋 j 와 무관) ──────
+    // 분수 윈도우: [fa, fb) 샘플 (위상 x 에 더해 prefix sum 보간)
+    struct Win  { int a, b; double inv; };
+    struct FWin { double fa, fb, inv; };
+    Win    w_pulse[4], w_gap[6], w_quiet[5];
+    FWin   f_pulse[4], f_gap[6], f_quiet[5], f_bit[224];
+    size_t need = 0;              // 8µs 프리앰블 + 최장 프레임
+    float  gap_ratio = 2.f;       // 정밀 판정 pmin ≥ gap_ratio·골
+    static constexpr int MAX_TRIES = 4;   // 묶음당 슬라이싱 시도 위상 수
+
+    Win make_win(double u0) const {
+        int a=(int)llround(u0*spb), b=(int)llround((u0+0.5)*spb);
+        if(b<=a) b=a+1;
+        return Win{a, b, 1.0/(b-a)};
+    }
+    FWin make_fwin(double u0, double guard = 0.0) const {
+        double a = u0*spb + guard, b = (u0+0.5)*spb - guard;
+        if(b - a < 0.25){ double m = 0.5*(a+b); a = m - 0.125; b = m + 0.125; }
+        return FWin{a, b, 1.0/(b-a)};
+    }
+    void build_windows(){
+        const double p[] = {0.0,1.0,3.5,4.5};              // 펄스
+        const double g[] = {0.5,1.5,2.0,2.5,3.0,4.0};      // 펄스 사이/뒤 골
+        const double q[] = {5.5,6.0,6.5,7.0,7.5};          // 정적 구간
+        for(int i=0;i<4;i++){ w_pulse[i]=make_win(p[i]); f_pulse[i]=make_fwin(p[i]); }
+        // 골/정적부 정밀 윈도우는 양쪽 0.5 샘플 guard: ADC 적분/대역제한으로 펄스
+        // 가장자리가 ~1 샘플 번지므로, spb≈2.4 에서 1.2 샘플 골이 번짐에 묻히지 않게.
+        for(int i=0;i<6;i++){ w_gap[i]  =make_win(g[i]); f_gap[i]  =make_fwin(g[i], 0.5); }
+        for(int i=0;i<5;i++){ w_quiet[i]=make_win(q[i]); f_quiet[i]=make_fwin(q[i], 0.5); }
+        for(int b=0;b<112;b++){                            // 비트셀 앞/뒤 half-chip
+            f_bit[2*b]   = make_fwin(PRE_US + b);
+            f_bit[2*b+1] = make_fwin(PRE_US + b + 0.5);
+        }
+        // half-chip < 1.5 샘플이면 골 중앙 샘플에도 펄스 가장자리가 ~0.3 섞임 → 비율 완화
+        gap_ratio = spb >= 3.0 ? 2.f : 1.25f;
+        need = (size_t)((PRE_US + 112.0)*spb) + 8;
+    }
+
+    // ── magnitude 윈도우 평균 (prefix sum, O(1)) ────────────────────────────
+    // 분수 위치 x 까지의 적분: sample-hold 신호 → cs 선형 보간.
+    inline double csx(double x) const {
+        size_t i = (size_t)x;
+        if(i >= buf.size()) return cs[buf.size()];
+        return cs[i] + (x - (double)i) * buf[i];
+    }
+    inline float win(double x, const FWin& w) const {
+        return (float)((csx(x + w.fb) - csx(x + w.fa)) * w.inv);
+    }
+    // 위상 x 의 정밀 프리앰블 판정 (분수 윈도우). 통과 시 점수 pmin − 골 최대, 실패 -1.
+    //   pmax ≤ 4·pmin (펄스 진폭 비슷), pmin ≥ gap_ratio·골, 정적부 ≤ 0.5·pmin.
+    float frac_score(double x) const {
+        float pmin = 1e30f, pmax = 0.f, gmax = 0.f, qmax = 0.f;
+        for(int k=0;k<4;k++){ float p = win(x, f_pulse[k]); pmin = std::fmin(pmin, p); pmax = std::fmax(pmax, p); }
+        for(int k=0;k<6;k++) gmax = std::fmax(gmax, win(x, f_gap[k]));
+        for(int k=0;k<5;k++) qmax = std::fmax(qmax, win(x, f_quiet[k]));
+        bool good = (pmin > 1e-6f) && (pmax <= 4.0f*pmin) &&
+                    (pmin >= gap_ratio*gmax) && (qmax <= 0.5f*pmin);
+        return good ? pmin - gmax : -1.f;
+    }
+
+    // ── 프리앰블 1차 게이트 (정수 오프셋 0..limit 일괄, 분기 없는 루프 → 자동 벡터화) ──
+    //   정수 반올림 윈도우는 spb 가 정수가 아니면 1 샘플 폭 펄스 윈도우가 가장자리에
+    //   걸리는 위상이 생기므로 min/max 대신 평균 에너지로 느슨하게 후보만 고른다:
+    //   펄스 평균 ≥ 1.5·골 평균, 정적부 평균 ≤ 0.5·펄스 평균. 정밀 판정은 frac_score().
+    void scan_preambles(size_t limit){
+        size_t n = limit + 1;
+        pre_ok.resize(n);
+        const double* c = cs.data();
+        uint8_t* ok = pre_ok.data();
+        for(size_t j=0;j<n;j++){
+            double ps=0, gs=0, qs=0;
+            for(int k=0;k<4;k++) ps += (c[j+w_pulse[k].b]-c[j+w_pulse[k].a])*w_pulse[k].inv;
+            for(int k=0;k<6;k++) gs += (c[j+w_gap[k].b]  -c[j+w_gap[k].a])  *w_gap[k].inv;
+            for(int k=0;k<5;k++) qs += (c[j+w_quiet[k].b]-c[j+w_quiet[k].a])*w_quiet[k].inv;
+            float pm = (float)(ps*0.25), gm = (float)(gs*(1.0/6)), qm = (float)(qs*0.2);
+            bool good = (pm > 1e-6f) & (pm >= 1.5f*gm) & (qm <= 0.5f*pm);
+            ok[j] = good ? 1 : 0;
+        }
+    }
+
+    // j 샘플 소비: 꼬리만 앞으로 당기고 prefix sum 재기준화.
+    void consume(size_t j){
+        if(j == 0) return;
+        if(j > buf.size()) j = buf.size();
+        samp_base += (double)j;
+        size_t tail = buf.size() - j;
+        if(tail) memmove(buf.data(), buf.data()+j, tail*sizeof(float));
+        buf.resize(tail);
+        double base = cs[j];
+        for(size_t k=0;k<=tail;k++) cs[k] = cs[j+k] - base;
+        cs.resize(tail+1);
+    }
 
     // ── CPR(Compact Position Reporting) 짝(even/odd) 보관 + 마지막 위치 ──
     struct CprState {
@@ -82,48 +212,13 @@ private:
     // ── 단일비트 오류 정정용 잔차→비트위치 표 (메시지 길이별) ──
     std::unordered_map<uint32_t,int> synd112, synd56;
 
-    // ── magnitude 윈도우 평균 (µs 오프셋 [u0, u0+0.5) ) ─────────────────────
-    inline float win(size_t j, double u0) const {
-        long a=(long)(j + (size_t)llround(u0*spb));
-        long b=(long)(j + (size_t)llround((u0+0.5)*spb));
-        if(b<=a) b=a+1;
-        float s=0; int c=0;
-        long N=(long)buf.size();
-        for(long k=a;k<b;k++){ if(k>=0&&k<N){ s+=buf[k]; c++; } }
-        return c? s/c : 0.f;
-    }
-
-    // ── 프리앰블 상관: 펄스 4개가 골(gap)/정적부보다 충분히 높은가 (상대진폭) ──
-    bool preamble_ok(size_t j) const {
-        float p0=win(j,0.0), p1=win(j,1.0), p2=win(j,3.5), p3=win(j,4.5);
-        float pmin = std::fmin(std::fmin(p0,p1), std::fmin(p2,p3));
-        float pmax = std::fmax(std::fmax(p0,p1), std::fmax(p2,p3));
-        if(pmin <= 1e-6f) return false;
-        if(pmax > 4.0f*pmin) return false;                    // 4 펄스 진폭 비슷해야
-        // 펄스 사이/뒤 골은 펄스보다 낮아야 (펄스 ≥ 2× 골)
-        float gmax = 0.f;
-        const double g[] = {0.5,1.5,2.0,2.5,3.0,4.0};
-        for(double u : g) gmax = std::fmax(gmax, win(j,u));
-        if(pmin < 2.0f*gmax) return false;
-        // 5.5~8.0 µs 정적 구간은 펄스의 절반 미만
-        float qmax = 0.f;
-        const double q[] = {5.5,6.0,6.5,7.0,7.5};
-        for(double u : q) qmax = std::fmax(qmax, win(j,u));
-        if(qmax > 0.5f*pmin) return false;
-        return true;
-    }
-
-    // 프리앰블 j 에서 프레임 해독 시도. 성공 시 소비 샘플수(>0) 반환, 실패 0.
-    int decode_at(size_t j){
+    // 프리앰블 위상 j (분수 샘플) 에서 프레임 해독 시도. 성공 시 소비 샘플수(>0), 실패 0.
+    int decode_at(double j){
         // 먼저 112 bit 까지 슬라이스 → DF 로 실제 길이 판정
         uint8_t msg[14]={0};
-        float conf[112];
         for(int b=0;b<112;b++){
-            double t = PRE_US + b*1.0;          // 비트셀 시작 µs
-            float e0=win(j,t), e1=win(j,t+0.5);
-            int bit = (e0>e1)?1:0;
-            conf[b] = std::fabs(e0-e1)/(e0+e1+1e-9f);
-            if(bit) msg[b>>3] |= (uint8_t)(0x80>>(b&7));
+            float e0=win(j,f_bit[2*b]), e1=win(j,f_bit[2*b+1]);
+            if(e0>e1) msg[b>>3] |= (uint8_t)(0x80>>(b&7));
         }
         int df = msg[0]>>3;
         int nbits = (df & 0x10) ? 112 : 56;     // DF16~ = long
@@ -158,6 +158,7 @@ void host_emit(FFTViewer& v, AdsbRecord m){
     store_append(m);
     AdsbWireMsg w; adsb_msg_to_wire(m, w);
     bewe_mod_emit(v, "adsb", &w, sizeof(w));
+    bewe_mod_tm_pin(v, "adsb", m.ch);
 }
 
 static void on_data(FFTViewer& v, const char* station, const uint8_t* d, size_t n){
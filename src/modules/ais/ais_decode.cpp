@@ -1,11 +1,19 @@
 // ── AIS HOST 워커: IQ ring 독립 read-ptr 탭 → 채널 DDC → FM 판별기 → GMSK 비트동기
 //    → NRZI → HDLC 프레임 디코드. demod_worker/오디오 ring 과 완전 분리.
 //    결과는 host_emit() 으로 로그+일단위 저장+전 JOIN 브로드캐스트 (ACARS/WiFi 와 동형).
+//
+//  단일 모드: 채널필터 중심으로 DDC → ~48 kHz → 복조기 1개 (기존 동작).
+//  결합 모드: 필터가 AIS1(161.975)·AIS2(162.025) 둘 다 덮으면 (≈100 kHz 탭) 162.000 중심
+//            full-rate DDC 한 번 → ~100 kHz → 채널별 ±25 kHz 회전 + half-band ÷2 (~50 kHz)
+//            → 복조기 2개를 한 워커에서. full-rate 혼합/LPF 비용 절반, 두 채널이 같은
+//            샘플 시계(SlotClock)를 공유해 슬롯 타이밍이 서로 직접 비교 가능.
 #include "fft_viewer.hpp"
 #include "ais_module.hpp"
 #include "ais_decode.hpp"
 #include "ais_fp.hpp"
 #include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <algorithm>
 #include <chrono>
@@ -33,84 +41,206 @@ static bool fpcap_enabled(){
     return c==1;
 }
 
-// GMSK 정합 가우시안 LPF (9600 bps @ ~48 kHz, 5 sps). GNU AIS receiver.c 계수.
-static const float GMSK_FIR[36] = {
-   2.5959e-55f,2.9479e-49f,1.4741e-43f,3.2462e-38f,3.1480e-33f,
-   1.3443e-28f,2.5280e-24f,2.0934e-20f,7.6339e-17f,1.2259e-13f,
-   8.6690e-11f,2.6996e-08f,3.7020e-06f,2.2355e-04f,5.9448e-03f,
-   6.9616e-02f,3.5899e-01f,8.1522e-01f,8.1522e-01f,3.5899e-01f,
-   6.9616e-02f,5.9448e-03f,2.2355e-04f,3.7020e-06f,2.6996e-08f,
-   8.6690e-11f,1.2259e-13f,7.6339e-17f,2.0934e-20f,2.5280e-24f,
-   1.3443e-28f,3.1480e-33f,3.2462e-38f,1.4741e-43f,2.9479e-49f,
-   2.5959e-55f };
+// ── SOTDMA 슬롯 시계 (1분 = 2250 슬롯, 26.667 ms) ─────────────────────────
+// 샘플 인덱스 ↔ wall ms 앵커 (주기 재앵커) + 버스트 시작 위상 원형 EMA. 버스트는 슬롯
+// 경계에서 시작하므로 학습 위상 = 공통 오프셋 (NTP 오차 + 파이프라인 지연). 결합 모드에선
+// 두 채널 버스트가 같은 추정기에 들어가 관측이 두 배.
+struct SlotClock {
+    static constexpr double SLOT_MS = 60000.0/2250.0;
+    double  sr = 48000.0;
+    int64_t k0 = 0; double wall0 = 0;
+    double  ph_c = 1, ph_s = 0; long ph_n = 0;
+    void anchor(int64_t k, double wall_ms){ k0=k; wall0=wall_ms; }
+    double wall_of(int64_t k) const { return wall0 + (double)(k-k0)*1000.0/sr; }
+    int slot_of(int64_t k){
+        double t   = wall_of(k);
+        double ang = 2.0*M_PI*std::fmod(t, SLOT_MS)/SLOT_MS;
+        double a   = ph_n < 20 ? 1.0/(ph_n+1) : 0.05;
+        ph_c += a*(std::cos(ang)-ph_c); ph_s += a*(std::sin(ang)-ph_s); ph_n++;
+        double off = std::atan2(ph_s, ph_c)/(2.0*M_PI)*SLOT_MS;
+        long long n = llround((t - off)/SLOT_MS);          // 경계 ± 지터 → round
+        return (int)(((n % 2250) + 2250) % 2250);
+    }
+};
 
-void worker(FFTViewer& v, int ch_idx){
-    Channel& ch = v.channels[ch_idx];
-    uint32_t msr = v.header.sample_rate;
-    const float inv_scale=1.0f/v.hw.iq_scale;  // ÷ → ×
-    uint64_t init_cf = v.live_cf_hz.load(std::memory_order_acquire);
-    float off_hz = (((ch.s+ch.e)/2.0f) - (float)(init_cf/1e6f)) * 1e6f;
-    float bw_hz  = fabsf(ch.e-ch.s) * 1e6f;
+// ── half-band 데시메이터 (÷2, 복소). 짝수 오프셋 탭 0 → 출력 시점에만 (N+1)/2+1 MAC ──
+struct HalfBandDec {
+    static constexpr int N = 31, C = N/2;                   // 통과 ≲0.2·fs, 저지 ≳0.3·fs
+    float h[N]; float zi[N]={}, zq[N]={}; int pos=0; bool ph=false;
+    HalfBandDec(){
+        double sum=0;
+        for(int n=0;n<N;n++){
+            int k=n-C; double x=0.5*k*M_PI;
+            double sinc = k==0 ? 1.0 : std::sin(x)/x;
+            double w = 0.42 - 0.5*std::cos(2*M_PI*n/(N-1)) + 0.08*std::cos(4*M_PI*n/(N-1));
+            h[n]=(float)(0.5*sinc*w); sum+=h[n];
+        }
+        for(int n=0;n<N;n++) h[n]=(float)(h[n]/sum);
+    }
+    void reset(){ std::fill(zi,zi+N,0.f); std::fill(zq,zq+N,0.f); pos=0; ph=false; }
+    // 입력 1개 → 출력 시 true
+    inline bool push(float i, float q, float& oi, float& oq){
+        zi[pos]=i; zq[pos]=q; pos=(pos+1)%N;
+        ph=!ph; if(ph) return false;
+        float ai=0, aq=0;
+        for(int n=0;n<N;n++){
+            if(!((n-C)&1) && n!=C) continue;                // half-band 0 탭 (짝수 k≠0)
+            int idx=(pos+n)%N;                              // zi[pos] = 가장 오래된 샘플
+            ai+=h[N-1-n]*zi[idx]; aq+=h[N-1-n]*zq[idx];
+        }
+        oi=ai; oq=aq; return true;
+    }
+};
 
-    // ── DDC: ~48 kHz 정수배 데시메이트 (9600 bps → ~5 sps) ──
-    uint32_t decim  = std::max(1u, (uint32_t)llround((double)msr / 48000.0));
-    uint32_t out_sr = msr / decim;
+// ── 채널 1개 복조 체인: FM 판별 → AisBitSync (GMSK 정합 FIR → DPLL → NRZI) → HDLC + RF 지문 ──
+struct AisDemod {
+    FFTViewer* v = nullptr;
+    int      ch_idx = 0;
+    char     ais_ch = 0;          // 'A'/'B' (0 = 미상)
+    float    freq_mhz = 0.f;      // 결합 모드 서브채널 주파수 (0 = 필터 중심 사용)
+    uint32_t sr = 48000;
+    SlotClock* clk = nullptr;
+    bool     cap = false;
 
-    Oscillator osc; osc.set_freq((double)off_hz, (double)msr);
-    uint64_t prev_cf = init_cf;
-    // 데시메이션 전 anti-alias LPF: cutoff = min(채널BW/2, out_sr*0.45)
-    IIR1 lpi[4], lpq[4];
-    { float cut = std::min(bw_hz*0.5f, out_sr*0.45f);
-      float cn = cut/(float)msr; if(cn>0.45f)cn=0.45f; if(cn<0.005f)cn=0.005f;
-      for(int k=0;k<4;k++){ lpi[k].set(cn); lpq[k].set(cn); } }
-    double dec_i=0, dec_q=0; uint32_t dec_cnt=0;
-
-    // FM 판별기 상태 + GMSK 정합 FIR 딜레이라인
+    // FM 판별기 상태 + 비트 동기
     float prev_i=0, prev_q=0;
-    float fir[36]={}; int fir_pos=0;
-
-    // DPLL 비트동기 (GNU AIS 구조): pllinc 1비트 = out_sr/9600 샘플
-    const uint32_t PLLINC = (uint32_t)llround(65536.0*9600.0/(double)out_sr);
-    uint32_t pll=0; int prev_zc=0; uint8_t lastbit=0;
+    AisBitSync bs;
 
-    AisDecoder dec; dec.reset_all();
-    long frames=0;
-    BurstAcc acc; acc.reset();
-    const bool cap = fpcap_enabled();
+    AisDecoder dec;
+    BurstAcc   acc;
     // RF 지문 게이팅: 페이로드(ST_DATA) 구간만 누산 (프리앰블/플래그/탐색노이즈 제외 → CFO 잡음↓).
-    bool acc_gate=false; int acc_skip=0;
-    dec.on_gate = [&](bool on){ if(on){ acc.reset(); acc_gate=true; acc_skip=6; }   // FIR/DPLL 지연 6심볼 건너뜀
-                                else   { acc_gate=false; } };
-    dec.on_record = [&](const AisRecord& r){
+    bool    acc_gate=false; int acc_skip=0;
+    int64_t k=0, gate_k=0;        // 이 복조기 샘플 인덱스, 페이로드 시작 인덱스
+    long    frames=0, diag_bits=0;
+
+    void init(FFTViewer& vv, int ch, uint32_t rate, SlotClock* c){
+        v=&vv; ch_idx=ch; sr=rate; clk=c; cap=fpcap_enabled();
+        bs.init(sr);
+        dec.on_gate = [this](bool on){
+            if(on){ acc.reset(); acc_gate=true; acc_skip=6; gate_k=k; }   // FIR/DPLL 지연 6심볼 건너뜀
+            else  { acc_gate=false; } };
+        dec.on_record = [this](const AisRecord& r){ finalize(r); };
+        reset();
+    }
+    void reset(){
+        prev_i=prev_q=0; bs.reset();
+        dec.reset_all(); acc.reset(); acc_gate=false;
+    }
+    void finalize(const AisRecord& r){
         frames++;
-        AisRecord m=r; m.ch=ch_idx;
+        AisRecord m=r; m.ch=ch_idx; m.ais_ch=ais_ch; m.freq=freq_mhz;
+        // 슬롯: 페이로드 시작 − (ramp 8 + training 24 + 시작 플래그 8) 비트
+        if(clk) m.slot=(int16_t)clk->slot_of(gate_k - (int64_t)llround(40.0*sr/9600.0));
         // ── RF 지문 finalize (이 버스트 acc → 레코드) ──
         if(acc.n_d>2 && acc.sum_mag2>0){
-            double inv=1.0/acc.n_d, hz=(double)out_sr/(2.0*M_PI);
+            double inv=1.0/acc.n_d, hz=(double)sr/(2.0*M_PI);
             double mean_w=acc.sum_dw/acc.sum_mag2;                // magnitude-weighted CFO (fade/noise 가중↓)
             double mean=acc.sum_d*inv;                            // fdev 용 unweighted 평균
             double var =acc.sumsq_d*inv - mean*mean; if(var<0) var=0;
             m.cfo_hz      = (float)(mean_w*hz);
             m.fdev_std_hz = (float)(std::sqrt(var)*hz);
             m.rssi_db     = (float)(10.0*std::log10(acc.sum_mag2*inv + 1e-20));
-            m.dur_ms      = (float)(acc.n_d*1000.0/out_sr);
-            m.clk_ppm     = acc.n_bits ? (float)(acc.sum_pll/acc.n_bits*1e6/(double)PLLINC) : 0.f;
+            m.dur_ms      = (float)(acc.n_d*1000.0/sr);
+            m.clk_ppm     = acc.n_bits ? (float)(acc.sum_pll/acc.n_bits*1e6/(double)bs.PLLINC) : 0.f;
             m.fp_ver      = ais_fp::FP_VER;
             m.has_rf      = true;
             if(cap && !acc.series.empty()) host_fpcap(m.mmsi, acc.series.data(), (int)acc.series.size());
         }
-        host_emit(v, m);
+        host_emit(*v, m);
         acc.reset(); acc_gate=false;
-    };
+    }
+    // 채널 baseband 샘플 1개 (sr)
+    inline void feed(float oi, float oq){
+        k++;
+        // FM 판별: arg(z * conj(prev)) — 순시주파수 (GMSK mark/space). 부호모호성은 NRZI 가 흡수.
+        float d = atan2f(oq*prev_i - oi*prev_q, oi*prev_i + oq*prev_q + 1e-20f);
+        prev_i=oi; prev_q=oq;
+        // RF 지문 누산 (페이로드 게이트 열림 + skip 경과 후만; on_record 서 finalize)
+        if(acc_gate){
+            if(acc_skip>0) acc_skip--;
+            else {
+                double mag2=(double)oi*oi + (double)oq*oq;
+                acc.sum_d += d; acc.sumsq_d += (double)d*d;
+                acc.sum_dw += d*mag2; acc.sum_mag2 += mag2; acc.n_d++;
+                if(cap && acc.series.size()<512) acc.series.push_back(d);   // 옵션 raw 시리즈
+            }
+        }
 
-    bewe_log_push(0,"AIS[%d] start: %.4f MHz  BW=%.1f kHz  station=%u  decim=%u out=%u Hz (%.2f sps)\n",
-        ch_idx,(ch.s+ch.e)/2.0f, bw_hz/1000.f, msr, decim, out_sr, (double)out_sr/9600.0);
+        // GMSK 정합 FIR → DPLL (영교차 보정은 clk_ppm 용으로 페이로드 구간만 누산) → NRZI → 디코더
+        int b=bs.step(d);
+        if(bs.corr && acc_gate) acc.sum_pll += (double)bs.corr;
+        if(b>=0){
+            dec.feed_bit((uint8_t)b);
+            diag_bits++; if(acc_gate) acc.n_bits++;
+        }
+    }
+};
+
+constexpr double AIS1_MHZ = 161.975, AIS2_MHZ = 162.025;
+constexpr double JOINT_MARGIN_MHZ = 0.008;      // 서브채널 점유대역 ±8 kHz 가 필터 안에 있어야
+
+void worker(FFTViewer& v, int ch_idx){
+    Channel& ch = v.channels[ch_idx];
+    uint32_t msr = v.header.sample_rate;
+    const float inv_scale=1.0f/v.hw.iq_scale;  // ÷ → ×
+    uint64_t init_cf = v.live_cf_hz.load(std::memory_order_acquire);
+    float bw_hz  = fabsf(ch.e-ch.s) * 1e6f;
+    double flo = std::min(ch.s,ch.e), fhi = std::max(ch.s,ch.e);
+    const bool joint = flo <= AIS1_MHZ-JOINT_MARGIN_MHZ && fhi >= AIS2_MHZ+JOINT_MARGIN_MHZ;
+    // DDC 중심: 결합 = 두 채널 중간(162.000), 단일 = 필터 중심
+    const double ddc_mhz = joint ? 0.5*(AIS1_MHZ+AIS2_MHZ) : 0.5*(ch.s+ch.e);
+    float off_hz = (float)((ddc_mhz - init_cf/1e6) * 1e6);
+
+    // ── DDC: 단일 ~48 kHz (9600 bps → ~5 sps) / 결합 ~100 kHz (±25 kHz 두 채널 수용) ──
+    const double stage_sr = joint ? 100000.0 : 48000.0;
+    uint32_t decim  = std::max(1u, (uint32_t)llround((double)msr / stage_sr));
+    uint32_t out_sr = msr / decim;
+
+    Oscillator osc; osc.set_freq((double)off_hz, (double)msr);
+    uint64_t prev_cf = init_cf;
+    // 데시메이션 전 anti-alias LPF: 단일 cutoff = min(채널BW/2, out_sr*0.45),
+    // 결합 cutoff = 25 kHz + 서브채널 반폭 (두 채널 모두 통과)
+    IIR1 lpi[4], lpq[4];
+    { float cut = joint ? 40000.f : std::min(bw_hz*0.5f, out_sr*0.45f);
+      float cn = cut/(float)msr; if(cn>0.45f)cn=0.45f; if(cn<0.005f)cn=0.005f;
+      for(int k=0;k<4;k++){ lpi[k].set(cn); lpq[k].set(cn); } }
+    double dec_i=0, dec_q=0; uint32_t dec_cnt=0;
+
+    // 결합 모드 분기: 서브채널별 ±25 kHz 회전 (out_sr 에서) + half-band ÷2
+    const int nd = joint ? 2 : 1;
+    const uint32_t dem_sr = joint ? out_sr/2 : out_sr;
+    Oscillator sub_osc[2]; HalfBandDec hb[2];
+    SlotClock clk; clk.sr = dem_sr;
+    AisDemod dm[2];
+    for(int i=0;i<nd;i++) dm[i].init(v, ch_idx, dem_sr, &clk);
+    if(joint){
+        sub_osc[0].set_freq((AIS1_MHZ-ddc_mhz)*1e6, (double)out_sr);
+        sub_osc[1].set_freq((AIS2_MHZ-ddc_mhz)*1e6, (double)out_sr);
+        dm[0].ais_ch='A'; dm[0].freq_mhz=(float)AIS1_MHZ;
+        dm[1].ais_ch='B'; dm[1].freq_mhz=(float)AIS2_MHZ;
+    } else {
+        if(std::fabs(ddc_mhz-AIS1_MHZ)<0.005) dm[0].ais_ch='A';
+        else if(std::fabs(ddc_mhz-AIS2_MHZ)<0.005) dm[0].ais_ch='B';
+    }
+
+    if(joint)
+        bewe_log_push(0,"AIS[%d] start (joint A+B): DDC %.3f MHz  station=%u  decim=%u → %u Hz → 2×%u Hz (%.2f sps)\n",
+            ch_idx, ddc_mhz, msr, decim, out_sr, dem_sr, (double)dem_sr/9600.0);
+    else
+        bewe_log_push(0,"AIS[%d] start: %.4f MHz  BW=%.1f kHz  station=%u  decim=%u out=%u Hz (%.2f sps)\n",
+            ch_idx,(ch.s+ch.e)/2.0f, bw_hz/1000.f, msr, decim, out_sr, (double)out_sr/9600.0);
 
     const size_t MAX_LAG=(size_t)(msr*0.08);
     const size_t BATCH  =std::max<size_t>(4096, msr/50);
     std::atomic<size_t>& my_rp = worker_rp(ch_idx);
     my_rp.store(v.ring_wp.load());
-    int64_t last_diag=now_ms(); long diag_bits=0;
+    PipeStats::ReaderScope rs_(my_rp, "ais", ch_idx);
+    int64_t last_diag=now_ms();
+    clk.anchor(0, (double)last_diag);
+    auto reset_all=[&](){
+        for(int k=0;k<4;k++){ lpi[k].s=lpq[k].s=0; } dec_i=dec_q=0; dec_cnt=0;
+        for(int i=0;i<nd;i++){ dm[i].reset(); hb[i].reset(); }
+    };
 
     bool hold_prev=false;
     while(!worker_stop_req(ch_idx) && !v.sdr_stream_error.load() && ch.filter_active){
@@ -119,8 +249,8 @@ void worker(FFTViewer& v, int ch_idx){
         bool hold = ch.dem_paused.load(std::memory_order_relaxed);
         if(hold!=hold_prev){
             bewe_mod_host_ch_hold(ch_idx, hold);
-            if(hold){ for(int k=0;k<4;k++){ lpi[k].s=lpq[k].s=0; } dec_i=dec_q=0; dec_cnt=0; prev_i=prev_q=0;
-                      std::fill(fir,fir+36,0.f); fir_pos=0; pll=0; prev_zc=0; lastbit=0; dec.reset_all(); acc.reset(); acc_gate=false; }
+            if(hold) reset_all();
+            else     clk.anchor(dm[0].k, (double)now_ms());
             hold_prev=hold;
         }
         if(hold){
@@ -130,7 +260,7 @@ void worker(FFTViewer& v, int ch_idx){
         }
         { uint64_t cur=v.live_cf_hz.load(std::memory_order_acquire);
           if(cur!=prev_cf){
-              off_hz=(((ch.s+ch.e)/2.0f)-(float)(cur/1e6f))*1e6f;
+              off_hz=(float)((ddc_mhz - cur/1e6) * 1e6);
               osc.set_freq((double)off_hz,(double)msr); prev_cf=cur;
           }
         }
@@ -141,12 +271,15 @@ void worker(FFTViewer& v, int ch_idx){
             size_t keep=(size_t)(msr*0.02);
             rp=(wp-keep)&IQ_RING_MASK; my_rp.store(rp,std::memory_order_release);
             for(int k=0;k<4;k++){ lpi[k].s=lpq[k].s=0; }
-            dec_i=dec_q=0; dec_cnt=0; prev_i=prev_q=0; acc.reset(); acc_gate=false;
+            dec_i=dec_q=0; dec_cnt=0;
+            for(int i=0;i<nd;i++){ dm[i].prev_i=dm[i].prev_q=0; dm[i].acc.reset(); dm[i].acc_gate=false; }
             lag=(wp-rp)&IQ_RING_MASK;
+            clk.anchor(dm[0].k, (double)now_ms() - lag*1000.0/msr);
         }
         if(lag==0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("mod", "ais_batch", avail);
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
             float si=v.ring[pos*2]*inv_scale, sq=v.ring[pos*2+1]*inv_scale;
@@ -157,46 +290,24 @@ void worker(FFTViewer& v, int ch_idx){
             if(++dec_cnt < decim) continue;
             float oi=(float)(dec_i/dec_cnt), oq=(float)(dec_q/dec_cnt);
             dec_i=dec_q=0; dec_cnt=0;
-
-            // FM 판별: arg(z * conj(prev)) — 순시주파수 (GMSK mark/space). 부호모호성은 NRZI 가 흡수.
-            float d = atan2f(oq*prev_i - oi*prev_q, oi*prev_i + oq*prev_q + 1e-20f);
-            prev_i=oi; prev_q=oq;
-            // RF 지문 누산 (페이로드 게이트 열림 + skip 경과 후만; on_record 서 finalize)
-            if(acc_gate){
-                if(acc_skip>0) acc_skip--;
-                else {
-                    double mag2=(double)oi*oi + (double)oq*oq;
-                    acc.sum_d += d; acc.sumsq_d += (double)d*d;
-                    acc.sum_dw += d*mag2; acc.sum_mag2 += mag2; acc.n_d++;
-                    if(cap && acc.series.size()<512) acc.series.push_back(d);   // 옵션 raw 시리즈
-                }
-            }
-
-            // GMSK 정합 가우시안 FIR
-            fir[fir_pos]=d;
-            float out=0; int idx=fir_pos;
-            for(int k=0;k<36;k++){ out+=GMSK_FIR[k]*fir[idx]; if(--idx<0) idx=35; }
-            fir_pos=(fir_pos+1)%36;
-
-            // DPLL: 영교차마다 위상 보정, wrap 마다 1심볼 샘플 → slice → NRZI → 디코더
-            int curr=(out>0);
-            if((curr^prev_zc)==1){ int corr = (pll<0x8000)? +(int)(PLLINC/16) : -(int)(PLLINC/16);
-                                   pll += corr; if(acc_gate) acc.sum_pll += (double)corr; }  // clk_ppm 페이로드 한정
-            prev_zc=curr;
-            pll+=PLLINC;
-            if(pll>0xFFFF){
-                uint8_t bit=(out>0)?1:0;
-                uint8_t b=(uint8_t)!(bit^lastbit);          // NRZI
-                dec.feed_bit(b);
-                lastbit=bit; pll&=0xFFFF; diag_bits++; if(acc_gate) acc.n_bits++;
+            if(!joint){ dm[0].feed(oi,oq); continue; }
+            for(int i=0;i<2;i++){
+                float ri,rq,hi,hq; sub_osc[i].mix(oi,oq,ri,rq);
+                if(hb[i].push(ri,rq,hi,hq)) dm[i].feed(hi,hq);
             }
         }
         my_rp.store((rp+avail)&IQ_RING_MASK,std::memory_order_release);
 
         int64_t t=now_ms();
-        if(t-last_diag>=10000){                              // 10초마다 진단 (콘솔만)
-            bewe_log_push(0,"AIS[%d] diag: bits/10s=%ld frames=%ld\n", ch_idx, diag_bits, frames);
-            last_diag=t; diag_bits=0;
+        if(t-last_diag>=10000){                              // 10초마다 진단 (콘솔만) + 슬롯 시계 재앵커
+            if(joint)
+                bewe_log_push(0,"AIS[%d] diag: bits/10s A=%ld B=%ld frames A=%ld B=%ld\n",
+                              ch_idx, dm[0].diag_bits, dm[1].diag_bits, dm[0].frames, dm[1].frames);
+            else
+                bewe_log_push(0,"AIS[%d] diag: bits/10s=%ld frames=%ld\n", ch_idx, dm[0].diag_bits, dm[0].frames);
+            last_diag=t; dm[0].diag_bits=dm[1].diag_bits=0;
+            size_t lag_now=(v.ring_wp.load(std::memory_order_acquire)-my_rp.load())&IQ_RING_MASK;
+            clk.anchor(dm[0].k, (double)t - lag_now*1000.0/msr);
         }
     }
     if(!worker_stop_req(ch_idx)) worker_natural_exit(v, ch_idx);
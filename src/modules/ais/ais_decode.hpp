@@ -1,6 +1,7 @@
 #pragma once
 // ── AIS HDLC/NRZI 프레임 디코더 (ITU-R M.1371) ─────────────────────────────
-// 입력 = NRZI 디코드된 비트열(0/1) 한 비트씩. GMSK 복조/비트동기는 워커(ais_decode.cpp).
+// 입력 = NRZI 디코드된 비트열(0/1) 한 비트씩. DDC/FM 판별은 워커(ais_decode.cpp),
+// 판별기 → 비트 동기(GMSK 정합 FIR + DPLL + NRZI)는 AisBitSync (워커/벤치 공용).
 // 프레임 구조: 프리앰블(0101..) → 플래그 0x7E → 데이터 → FCS(CRC-16) → 플래그 0x7E.
 //   - 비트스터핑: 연속 1 다섯 개 뒤 삽입된 0 제거.
 //   - HDLC 옥텟은 LSB-first 전송 → buffer(수신순) → rbuffer(옥텟 MSB-first 재배열).
@@ -11,6 +12,47 @@
 #include <functional>
 #include "ais_meta.hpp"
 
+// ── GMSK 비트 동기: FM 판별 출력 → 정합 가우시안 FIR → DPLL → NRZI ──────────
+// 정합 가우시안 LPF (9600 bps @ ~48 kHz, 5 sps). GNU AIS receiver.c 계수.
+// DPLL: pllinc 1비트 = sr/9600 샘플, 영교차마다 ±pllinc/16 위상 보정.
+struct AisBitSync {
+    static constexpr float FIR[36] = {
+       2.5959e-55f,2.9479e-49f,1.4741e-43f,3.2462e-38f,3.1480e-33f,
+       1.3443e-28f,2.5280e-24f,2.0934e-20f,7.6339e-17f,1.2259e-13f,
+       8.6690e-11f,2.6996e-08f,3.7020e-06f,2.2355e-04f,5.9448e-03f,
+       6.9616e-02f,3.5899e-01f,8.1522e-01f,8.1522e-01f,3.5899e-01f,
+       6.9616e-02f,5.9448e-03f,2.2355e-04f,3.7020e-06f,2.6996e-08f,
+       8.6690e-11f,1.2259e-13f,7.6339e-17f,2.0934e-20f,2.5280e-24f,
+       1.3443e-28f,3.1480e-33f,3.2462e-38f,1.4741e-43f,2.9479e-49f,
+       2.5959e-55f };
+
+    float    fir[36]={}; int fir_pos=0;
+    uint32_t PLLINC=0, pll=0; int prev_zc=0; uint8_t lastbit=0;
+    int      corr=0;              // 직전 step 의 DPLL 보정량 (0 = 영교차 없음)
+
+    void init(uint32_t sr){ PLLINC=(uint32_t)(65536.0*9600.0/(double)sr + 0.5); reset(); }
+    void reset(){ for(float& f : fir) f=0.f; fir_pos=0; pll=0; prev_zc=0; lastbit=0; corr=0; }
+
+    // 판별기 샘플 1개 → 비트 경계면 NRZI 복호 비트(0/1), 아니면 -1
+    inline int step(float d){
+        fir[fir_pos]=d;
+        float out=0; int idx=fir_pos;
+        for(int j=0;j<36;j++){ out+=FIR[j]*fir[idx]; if(--idx<0) idx=35; }
+        fir_pos=(fir_pos+1)%36;
+
+        int curr=(out>0);
+        corr=0;
+        if((curr^prev_zc)==1){ corr = (pll<0x8000)? +(int)(PLLINC/16) : -(int)(PLLINC/16); pll += corr; }
+        prev_zc=curr;
+        pll+=PLLINC;
+        if(pll<=0xFFFF) return -1;
+        uint8_t bit=(out>0)?1:0;
+        uint8_t b=(uint8_t)!(bit^lastbit);              // NRZI
+        lastbit=bit; pll&=0xFFFF;
+        return b;
+    }
+};
+
 class AisDecoder {
 public:
     std::function<void(const AisRecord&)> on_record;
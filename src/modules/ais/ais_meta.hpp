@@ -1,6 +1,7 @@
 #pragma once
 // ── AIS 메시지 레코드 + wire 포맷 + 보조 디코드 헬퍼 ────────────────────────
 // ITU-R M.1371 (Universal Shipborne AIS, TDMA VHF). 위치/정적 메시지 필드 추출.
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <cmath>
@@ -44,6 +45,9 @@ struct AisRecord {
     float    cfo_z = 0.f;         // 그 MMSI 서명 대비 편차 (진단)
     uint32_t match_mmsi = 0;      // 지문 최근접 MMSI (0=미상/저신뢰)
     float    match_conf = 0.f;    // Match 신뢰도 0..1
+    // ── 채널/슬롯 (워커 샘플 시계 기준 추정) ──
+    char     ais_ch = 0;          // 'A'=161.975 'B'=162.025 (0 = 미상)
+    int16_t  slot = -1;           // SOTDMA 슬롯 0..2249 (-1 = 미상)
 };
 
 // wire 포맷 (framework BEWE_MK_DATA payload; station 은 MpData 봉투가 운반)
@@ -57,12 +61,26 @@ struct __attribute__((packed)) AisWireMsg {
     uint32_t rx_cnt;
     uint32_t imo; char dest[21]; float draught;
     uint8_t  eta_mon, eta_day, eta_hour, eta_min;
-    // ── RF 지문 (끝에 추가; 구버전 짧은 payload 는 on_data n<sizeof 가드가 안전 거부) ──
+    // ── RF 지문 (끝에 추가) ──
     uint16_t fp_ver; uint8_t has_rf;
     float    cfo_hz, fdev_std_hz, rssi_db, clk_ppm, dur_ms;
     uint8_t  spoof_flag; float cfo_z; uint32_t match_mmsi; float match_conf;
+    // ── 채널/슬롯 (끝에 추가) ──
+    char     ais_ch; int16_t slot;
 };
 
+// ais_ch/slot 추가 이전 HOST 의 payload 길이 — 이보다 짧으면 거부.
+constexpr size_t AIS_WIRE_MIN = offsetof(AisWireMsg, ais_ch);
+
+// 수신 payload → AisWireMsg. 구버전(짧은) payload 는 뒤 필드를 기본값으로 (slot = -1).
+inline bool ais_wire_read(const uint8_t* d, size_t n, AisWireMsg& w){
+    if(n < AIS_WIRE_MIN) return false;
+    memset(&w, 0, sizeof(w));
+    w.slot = -1;
+    memcpy(&w, d, n < sizeof(w) ? n : sizeof(w));
+    return true;
+}
+
 inline void ais_msg_to_wire(const AisRecord& m, AisWireMsg& w){
     memset(&w, 0, sizeof(w));
     w.t_ms=m.t_ms; w.freq=m.freq; w.ch=m.ch;
@@ -76,6 +94,7 @@ inline void ais_msg_to_wire(const AisRecord& m, AisWireMsg& w){
     w.fp_ver=m.fp_ver; w.has_rf=m.has_rf?1:0;
     w.cfo_hz=m.cfo_hz; w.fdev_std_hz=m.fdev_std_hz; w.rssi_db=m.rssi_db; w.clk_ppm=m.clk_ppm; w.dur_ms=m.dur_ms;
     w.spoof_flag=m.spoof_flag; w.cfo_z=m.cfo_z; w.match_mmsi=m.match_mmsi; w.match_conf=m.match_conf;
+    w.ais_ch=m.ais_ch; w.slot=m.slot;
 }
 inline void ais_wire_to_msg(const AisWireMsg& w, AisRecord& m){
     m = AisRecord{};
@@ -91,6 +110,7 @@ inline void ais_wire_to_msg(const AisWireMsg& w, AisRecord& m){
     m.fp_ver=w.fp_ver; m.has_rf=w.has_rf!=0;
     m.cfo_hz=w.cfo_hz; m.fdev_std_hz=w.fdev_std_hz; m.rssi_db=w.rssi_db; m.clk_ppm=w.clk_ppm; m.dur_ms=w.dur_ms;
     m.spoof_flag=w.spoof_flag; m.cfo_z=w.cfo_z; m.match_mmsi=w.match_mmsi; m.match_conf=w.match_conf;
+    m.ais_ch=w.ais_ch; m.slot=w.slot;
 }
 
 // ── AIS 6-bit ASCII → 8-bit ASCII (ITU-R M.1371 Table 47) ──────────────────
@@ -128,6 +128,8 @@ void store_append(const AisRecord& m){
                   "\"sf\":%d,\"cz\":%.2f,\"mm\":%u,\"mc\":%.2f",
             m.fp_ver,m.cfo_hz,m.fdev_std_hz,m.rssi_db,m.clk_ppm,m.dur_ms,
             m.spoof_flag,m.cfo_z,m.match_mmsi,m.match_conf);
+    if(m.ais_ch)    fprintf(f,",\"ac\":\"%c\"",m.ais_ch);
+    if(m.slot>=0)   fprintf(f,",\"sl\":%d",m.slot);
     fprintf(f,"}\n");
     fclose(f);
 }
@@ -171,6 +173,8 @@ void store_parse_jsonl(const char* data, size_t n, std::vector<AisRecord>& out){
             m.spoof_flag=(uint8_t)jll(l,"\"sf\":"); m.cfo_z=(float)jf(l,"\"cz\":");
             m.match_mmsi=(uint32_t)jll(l,"\"mm\":"); m.match_conf=(float)jf(l,"\"mc\":");
         }
+        { const char* p=strstr(l,"\"ac\":\""); if(p) m.ais_ch=p[6]; }
+        if(strstr(l,"\"sl\":")) m.slot=(int16_t)jll(l,"\"sl\":");
         out.push_back(m);
     }
 }
@@ -229,7 +233,8 @@ void host_fpcap(uint32_t mmsi, const float* series, int n){
 
 // ── HOST: 워커 → 지문판정 + 스탬프 + 아카이브 + framework emit ──────────────
 void host_emit(FFTViewer& v, AisRecord m){
-    if(m.ch>=0 && m.ch<MAX_CHANNELS && v.channels[m.ch].filter_active)
+    // 결합(A+B) 워커는 서브채널 주파수를 직접 채움 → 그대로 둠
+    if(m.freq==0.f && m.ch>=0 && m.ch<MAX_CHANNELS && v.channels[m.ch].filter_active)
         m.freq = (v.channels[m.ch].s + v.channels[m.ch].e)/2.0f;
     m.t_ms = (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
                  std::chrono::system_clock::now().time_since_epoch()).count();
@@ -247,12 +252,14 @@ void host_emit(FFTViewer& v, AisRecord m){
     if(g_fpdb_dirty_ms && m.t_ms-last_flush>60000){ last_flush=m.t_ms; fpdb_flush(); }
     AisWireMsg w; ais_msg_to_wire(m, w);
     bewe_mod_emit(v, "ais", &w, sizeof(w));
+    bewe_mod_tm_pin(v, "ais", m.ch);
 }
 
 static void on_data(FFTViewer& v, const char* station, const uint8_t* d, size_t n){
     (void)v;
-    if(n < sizeof(AisWireMsg)) return;
-    AisRecord m; ais_wire_to_msg(*reinterpret_cast<const AisWireMsg*>(d), m);
+    AisWireMsg w;
+    if(!ais_wire_read(d, n, w)) return;
+    AisRecord m; ais_wire_to_msg(w, m);
     bewe_mod_stat_bump("ais", station, m.ch, m.t_ms);
     station_disp(station, m.station, sizeof(m.station));
     append_log(m);
@@ -290,8 +297,8 @@ static void on_vessel_hist(FFTViewer& v, const uint8_t* d, size_t n){
         uint32_t rl; memcpy(&rl, d+off, 4); off += 4;
         if(off + rl > n) break;
         const uint8_t* rec = d + off; off += rl;
-        if(rl < sizeof(MpData) + sizeof(AisWireMsg)){ continue; }
-        AisWireMsg w; memcpy(&w, rec + sizeof(MpData), sizeof(AisWireMsg));
+        AisWireMsg w;
+        if(rl < sizeof(MpData) || !ais_wire_read(rec + sizeof(MpData), rl - sizeof(MpData), w)) continue;
         AisRecord m; ais_wire_to_msg(w, m);
         char stn[25] = {}; memcpy(stn, rec, 24);       // MpData.station (raw station_id)
         station_disp(stn, m.station, sizeof(m.station));
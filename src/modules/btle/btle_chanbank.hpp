@@ -0,0 +1,157 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// BLE 광대역 채널라이저: overlap-save FFT 필터뱅크 (header-only, FFTW).
+//
+//   forward : 광대역 입력 N = D·NO 점 FFT 1회 / 블록 (스텝 L = N − D·VO) — 전 채널 공유
+//   extract : 채널 중심 bin kc 주변 NO bin × H → NO 점 IFFT → 앞 VO 버림
+//             → 채널당 블록마다 OUT = NO−VO 샘플 @ msr/D (≈4 MHz)
+//   H       : P = D·VO+1 탭 Blackman 윈도 sinc 의 NO bin DFT (1/N 포함). 탭 ≤ overlap+1
+//             이라 원형 앨리어싱 없음 → 시간영역 FIR + D 데시메이트와 같은 출력.
+//
+// 채널당 비용 = NO 점 IFFT + NO 곱 / 블록 (입력 샘플당 ≈ 1/D) → 채널을 늘려도 채널마다
+// 전대역 DDC 를 돌리는 것보다 훨씬 싸다. kc 반올림 잔여(≤ msr/2N)는 FM 판별 DC 로
+// 남고 BtleDecoder 의 dc(동기 40비트 평균)가 흡수.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <fftw3.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <volk/volk.h>
+
+class BtleChanBank {
+public:
+    static constexpr int NO  = 512;         // 채널 IFFT 크기
+    static constexpr int VO  = 128;         // 채널측 overlap (버리는 출력 수)
+    static constexpr int OUT = NO - VO;     // 블록당 채널 출력
+
+    static std::mutex& plan_mtx(){ static std::mutex m; return m; }   // fftw planner 는 thread-unsafe
+
+    BtleChanBank() = default;
+    BtleChanBank(const BtleChanBank&) = delete;
+    BtleChanBank& operator=(const BtleChanBank&) = delete;
+    ~BtleChanBank(){ release(); }
+
+    // cut_hz: 채널 LPF 단측 차단 주파수.
+    void init(double msr, int decim, double cut_hz){
+        release();
+        D_ = decim < 1 ? 1 : decim;
+        N_ = D_ * NO; V_ = D_ * VO; L_ = N_ - V_; msr_ = msr;
+        {
+            std::lock_guard<std::mutex> lk(plan_mtx());
+            in_   = fftwf_alloc_complex((size_t)N_);
+            out_  = fftwf_alloc_complex((size_t)N_);
+            plan_ = fftwf_plan_dft_1d(N_, in_, out_, FFTW_FORWARD, FFTW_ESTIMATE);
+        }
+        reset();
+        design(cut_hz);
+    }
+    void reset(){ if(in_) memset(in_, 0, sizeof(fftwf_complex) * (size_t)N_); }
+
+    int    size()     const { return N_; }
+    int    block_in() const { return L_; }          // 블록당 새 입력 샘플
+    double bin_hz()   const { return msr_ / N_; }
+    const lv_32fc_t* H() const { return H_.data(); } // NO bin, IFFT 순서 (0..NO/2-1, -NO/2..-1)
+
+    // 새 입력 L 개 → spec[N]. in_ 앞 V 는 직전 블록 꼬리 (out-of-place c2c 는 입력 보존).
+    void forward(const lv_32fc_t* in, lv_32fc_t* spec){
+        lv_32fc_t* line = (lv_32fc_t*)in_;
+        memcpy(line + V_, in, sizeof(lv_32fc_t) * (size_t)L_);
+        fftwf_execute(plan_);
+        memcpy((void*)spec, out_, sizeof(lv_32fc_t) * (size_t)N_);
+        memmove(line, line + L_, sizeof(lv_32fc_t) * (size_t)V_);
+    }
+
+private:
+    void design(double cut_hz){
+        int P = V_ + 1;
+        std::vector<double> h((size_t)P);
+        double fc = cut_hz / msr_, sum = 0, c = 0.5 * (P - 1);
+        for(int n = 0; n < P; n++){
+            double x = n - c;
+            double s = (x == 0) ? 2 * fc : std::sin(2 * M_PI * fc * x) / (M_PI * x);
+            double w = 0.42 - 0.5 * std::cos(2 * M_PI * n / (P - 1)) + 0.08 * std::cos(4 * M_PI * n / (P - 1));
+            h[(size_t)n] = s * w; sum += h[(size_t)n];
+        }
+        H_.assign(NO, lv_32fc_t(0, 0));
+        for(int d = 0; d < NO; d++){
+            int o = d < NO / 2 ? d : d - NO;            // bin 오프셋 (음수 = 위쪽 절반)
+            double re = 0, im = 0, a = -2 * M_PI * o / N_;
+            for(int n = 0; n < P; n++){ re += h[(size_t)n] * std::cos(a * n); im += h[(size_t)n] * std::sin(a * n); }
+            double g = 1.0 / (sum * N_);
+            H_[(size_t)d] = lv_32fc_t((float)(re * g), (float)(im * g));
+        }
+    }
+    void release(){
+        std::lock_guard<std::mutex> lk(plan_mtx());
+        if(plan_) fftwf_destroy_plan(plan_);
+        if(in_)   fftwf_free(in_);
+        if(out_)  fftwf_free(out_);
+        plan_ = nullptr; in_ = out_ = nullptr;
+    }
+
+    int D_ = 1, N_ = NO, V_ = VO, L_ = NO - VO;
+    double msr_ = 1;
+    fftwf_complex *in_ = nullptr, *out_ = nullptr;
+    fftwf_plan plan_ = nullptr;
+    std::vector<lv_32fc_t> H_;
+};
+
+// 채널 하나: 공유 스펙트럼에서 kc 주변 bin 추출 → IFFT → 유효 OUT 샘플.
+// 블록 b 의 IFFT 는 블록 시작 기준 mix 라 e^{-j2π·kc·bL/N} 로 위상 연속 보정 (정수 누산).
+class BtleBankChan {
+public:
+    BtleBankChan() = default;
+    BtleBankChan(const BtleBankChan&) = delete;
+    BtleBankChan& operator=(const BtleBankChan&) = delete;
+    ~BtleBankChan(){ release(); }
+
+    void init(const BtleChanBank& b, int kc){
+        release();
+        bank_ = &b; N_ = b.size();
+        kc_ = ((kc % N_) + N_) % N_;
+        {
+            std::lock_guard<std::mutex> lk(BtleChanBank::plan_mtx());
+            x_    = fftwf_alloc_complex(BtleChanBank::NO);
+            y_    = fftwf_alloc_complex(BtleChanBank::NO);
+            plan_ = fftwf_plan_dft_1d(BtleChanBank::NO, x_, y_, FFTW_BACKWARD, FFTW_ESTIMATE);
+        }
+        reset();
+    }
+    void reset(){ q_ = 0; }
+
+    void extract(const lv_32fc_t* spec, std::vector<lv_32fc_t>& out){
+        constexpr int NO = BtleChanBank::NO, VO = BtleChanBank::VO, OUT = BtleChanBank::OUT;
+        const lv_32fc_t* H = bank_->H();
+        lv_32fc_t* x = (lv_32fc_t*)x_;
+        for(int d = 0; d < NO; d++){
+            int src = kc_ + (d < NO / 2 ? d : d - NO);
+            if(src >= N_) src -= N_; else if(src < 0) src += N_;
+            x[d] = spec[src] * H[d];
+        }
+        fftwf_execute(plan_);
+        double a = -2 * M_PI * (double)q_ / NO;
+        lv_32fc_t ph((float)std::cos(a), (float)std::sin(a));
+        size_t o = out.size();
+        out.resize(o + OUT);
+        const lv_32fc_t* y = (const lv_32fc_t*)y_ + VO;
+        for(int m = 0; m < OUT; m++) out[o + m] = y[m] * ph;
+        q_ = (int)(((int64_t)q_ + (int64_t)kc_ * OUT) % NO);   // L/N = OUT/NO
+    }
+
+private:
+    void release(){
+        std::lock_guard<std::mutex> lk(BtleChanBank::plan_mtx());
+        if(plan_) fftwf_destroy_plan(plan_);
+        if(x_) fftwf_free(x_);
+        if(y_) fftwf_free(y_);
+        plan_ = nullptr; x_ = y_ = nullptr;
+    }
+
+    const BtleChanBank* bank_ = nullptr;
+    int N_ = 1, kc_ = 0, q_ = 0;
+    fftwf_complex *x_ = nullptr, *y_ = nullptr;
+    fftwf_plan plan_ = nullptr;
+};
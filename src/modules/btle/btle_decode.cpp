@@ -1,14 +1,23 @@
 // ── BLE HOST 워커: IQ ring 독립 read-ptr 탭 → 채널 DDC → ~4 MHz 데시메이트 →
 //    FM 판별기(GFSK) → BtleDecoder(AA동기/디화이트닝/CRC/PDU). ais_decode.cpp 미러.
+//    채널필터가 BLE 채널 2개 이상을 덮으면 광대역 모드: 탭 1개 → FFT 필터뱅크로
+//    전 BLE 채널(2 MHz 격자) 분리 → 채널별 FM판별+디코더를 소형 풀에서 병렬 실행.
 //    오디오/스컬치 없음(패킷 디코더). 결과는 host_emit() → 로그+일단위 저장+JOIN 팬아웃.
 #include "fft_viewer.hpp"
 #include "btle_module.hpp"
 #include "btle_decode.hpp"
 #include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
+#include "btle_chanbank.hpp"
+#include "../common/worker_pool.hpp"
 #include <cmath>
+#include <cstdlib>
 #include <algorithm>
 #include <chrono>
-#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 namespace btle_mod {
 
@@ -26,8 +35,232 @@ static int adv_chan_of(float cmhz){
     return 37;
 }
 
+// ── 광대역 모드 ─────────────────────────────────────────────────────────
+// 워커가 블록 묶음(≤WIDE_MAX_BLOCKS)의 광대역 FFT 를 한 번 하고, 채널별 작업(bin 추출 →
+// IFFT → FM 판별 → BtleDecoder)을 풀에 나눠 준 뒤 전부 끝날 때까지 기다린다(배치 barrier).
+// 채널 디코더는 한 배치에 한 스레드만 만지므로 잠금 없음. 데이터 채널(BEWE_BTLE_DATA=1)은
+// 광고 채널에서 본 CONNECT_IND 의 AA/CRCInit 최근 MAX_LINKS 개만 추적.
+namespace {
+
+constexpr int WIDE_MAX_BLOCKS = 64;      // 배치당 블록 (61.44 MSPS 에서 ~6 ms)
+
+struct WideChan {
+    int   idx = 37;                      // BLE 채널 인덱스
+    float mhz = 2402.f;
+    BtleBankChan bank;
+    BtleDecoder  dec;
+    float prev_i = 0, prev_q = 0;        // FM 판별기 상태
+    std::vector<lv_32fc_t> y;
+    std::vector<float> fm, amp;
+};
+struct WideCtx;
+struct WideJob { WideCtx* ctx; WideChan* c; };
+struct WideCtx {                         // 채널 워커 스택 소유
+    const lv_32fc_t* spec = nullptr;
+    int nb = 0, N = 0;
+    std::mutex mtx;
+    std::condition_variable cv;
+    int inflight = 0;
+    std::vector<WideJob> jobs;           // 배치 제출 버퍼 (재사용)
+};
+
+void run_chan(const WideCtx& x, WideChan& c){
+    c.y.clear(); c.fm.clear(); c.amp.clear();
+    for(int b=0;b<x.nb;b++) c.bank.extract(x.spec + (size_t)b*x.N, c.y);
+    for(const lv_32fc_t& z : c.y){
+        float oi=z.real(), oq=z.imag();
+        c.fm.push_back(atan2f(oq*c.prev_i - oi*c.prev_q, oi*c.prev_i + oq*c.prev_q + 1e-20f));
+        c.amp.push_back(oi*oi + oq*oq);
+        c.prev_i=oi; c.prev_q=oq;
+    }
+    if(!c.fm.empty()) c.dec.process(c.fm.data(), c.amp.data(), c.fm.size());
+}
+
+void run_job(const WideJob& j){
+    run_chan(*j.ctx, *j.c);
+    { std::lock_guard<std::mutex> lk(j.ctx->mtx); --j.ctx->inflight; }
+    j.ctx->cv.notify_one();
+}
+
+modpool::WorkerPool<WideJob> g_pool{run_job};
+
+// 채널 0 은 호출 스레드가 직접, 나머지는 풀 → 전부 끝날 때까지 대기.
+void run_batch(WideCtx& x, std::vector<std::unique_ptr<WideChan>>& cs){
+    if(cs.empty()) return;
+    if(cs.size() > 1){
+        { std::lock_guard<std::mutex> lk(x.mtx); x.inflight = (int)cs.size() - 1; }
+        x.jobs.clear();
+        for(size_t i=1;i<cs.size();i++) x.jobs.push_back(WideJob{&x, cs[i].get()});
+        g_pool.submit(x.jobs.data(), x.jobs.size());
+    }
+    run_chan(x, *cs[0]);
+    std::unique_lock<std::mutex> lk(x.mtx);
+    x.cv.wait(lk, [&x]{ return x.inflight == 0; });
+}
+
+// 필터 [lo,hi] MHz 안 BLE 채널 수 (광대역 모드 판정)
+int ble_chans_in(float lo, float hi){
+    int n=0;
+    for(int i=0;i<40;i++){ float f=btle_chan_mhz(i); if(f>=lo-0.01f && f<=hi+0.01f) n++; }
+    return n;
+}
+
+} // namespace
+
+static void worker_wide(FFTViewer& v, int ch_idx){
+    Channel& ch = v.channels[ch_idx];
+    uint32_t msr = v.header.sample_rate;
+    const float inv_scale=1.0f/v.hw.iq_scale;
+    const char* de = getenv("BEWE_BTLE_DATA");
+    bool with_data = de && de[0] && de[0]!='0';
+
+    uint32_t decim  = std::max(1u, (uint32_t)llround((double)msr / BTLE_TARGET_SR));
+    double   fs_out = (double)msr / decim;
+    BtleChanBank bank;
+    bank.init((double)msr, (int)decim, std::min(1.1e6, fs_out*0.3));   // 1M PHY 점유 ~±0.75 MHz
+    const int N = bank.size(), L = bank.block_in();
+
+    // CONNECT_IND → 데이터 채널 추적 목록 (풀 스레드에서 추가, 배치 사이에 반영)
+    std::mutex link_mtx;
+    std::vector<std::pair<uint32_t,uint32_t>> links;
+    uint32_t link_ver=0, link_applied=0;
+
+    std::vector<std::unique_ptr<WideChan>> chans;
+    uint64_t prev_cf = 0;
+    float    prev_s = 0, prev_e = 0;
+    auto build = [&](uint64_t cf){
+        chans.clear();
+        float lo=std::min(ch.s,ch.e), hi=std::max(ch.s,ch.e);
+        double cfm=cf/1e6, half=msr/2e6 - 1.2;              // SDR 가장자리 1.2 MHz 제외
+        static const int order[3]={37,38,39};
+        for(int k=0;k<40;k++){
+            int idx = k<3 ? order[k] : k-3;                  // 광고 먼저 (run_batch 의 채널 0)
+            if(idx<37 && !with_data) continue;
+            float f=btle_chan_mhz(idx);
+            if(f<lo-0.01f || f>hi+0.01f || std::fabs(f-cfm)>half) continue;
+            auto c = std::make_unique<WideChan>();
+            c->idx=idx; c->mhz=f;
+            c->bank.init(bank, (int)llround((f-cfm)*1e6/bank.bin_hz()));
+            c->dec.reset(fs_out, ch_idx, idx);
+            c->dec.on_record = [&v,ch_idx,f,&link_mtx,&links,&link_ver](const BtleRecord& r){
+                BtleRecord m=r; m.ch=ch_idx; m.freq=f;
+                if(m.is_connect && m.access_addr){
+                    std::lock_guard<std::mutex> lk(link_mtx);
+                    bool dup=false;
+                    for(auto& p : links) if(p.first==m.access_addr){ dup=true; break; }
+                    if(!dup){
+                        links.emplace_back(m.access_addr, m.crc_init);
+                        if((int)links.size()>BtleDecoder::MAX_LINKS) links.erase(links.begin());
+                        link_ver++;
+                    }
+                }
+                host_emit(v, m);
+            };
+            c->fm.reserve((size_t)WIDE_MAX_BLOCKS*BtleChanBank::OUT);
+            c->amp.reserve((size_t)WIDE_MAX_BLOCKS*BtleChanBank::OUT);
+            chans.push_back(std::move(c));
+        }
+        link_applied=~link_ver;                             // 새 데이터 디코더에 목록 재적용
+        bank.reset();
+        prev_cf=cf; prev_s=ch.s; prev_e=ch.e;
+    };
+    auto apply_links = [&]{
+        uint32_t aa[BtleDecoder::MAX_LINKS], ci[BtleDecoder::MAX_LINKS]; int n=0;
+        {
+            std::lock_guard<std::mutex> lk(link_mtx);
+            if(link_applied==link_ver) return;
+            for(auto& p : links){ aa[n]=p.first; ci[n]=p.second; n++; }
+            link_applied=link_ver;
+        }
+        for(auto& c : chans) if(c->idx<37) c->dec.set_links(aa, ci, n);
+    };
+    auto reset_all = [&]{
+        bank.reset();
+        for(auto& c : chans){ c->bank.reset(); c->prev_i=c->prev_q=0; c->dec.reset(fs_out, ch_idx, c->idx); }
+        link_applied=~link_ver;
+    };
+    build(v.live_cf_hz.load(std::memory_order_acquire));
+
+    int pool_n = g_pool.acquire();
+    int n_adv=0; for(auto& c : chans) if(c->idx>=37) n_adv++;
+    bewe_log_push(0,"BTLE[%d] wideband start: %.1f-%.1f MHz  %d ch (adv %d, data %d)  decim=%u fs_out=%.3f MHz  N=%d pool=%d\n",
+        ch_idx, std::min(ch.s,ch.e), std::max(ch.s,ch.e), (int)chans.size(), n_adv,
+        (int)chans.size()-n_adv, decim, fs_out/1e6, N, pool_n);
+
+    WideCtx ctx; ctx.N=N;
+    std::vector<lv_32fc_t> stage((size_t)WIDE_MAX_BLOCKS*L);
+    std::vector<lv_32fc_t> spec((size_t)WIDE_MAX_BLOCKS*N);
+
+    const size_t MAX_LAG=(size_t)(msr*0.08);
+    std::atomic<size_t>& my_rp = worker_rp(ch_idx);
+    my_rp.store(v.ring_wp.load());
+    PipeStats::ReaderScope rs_(my_rp, "btle", ch_idx);
+    int64_t last_diag=now_ms();
+
+    bool hold_prev=false;
+    while(!worker_stop_req(ch_idx) && !v.sdr_stream_error.load() && ch.filter_active){
+        bool hold = ch.dem_paused.load(std::memory_order_relaxed);
+        if(hold!=hold_prev){
+            bewe_mod_host_ch_hold(ch_idx, hold);
+            if(hold) reset_all();
+            hold_prev=hold;
+        }
+        if(hold){
+            my_rp.store(v.ring_wp.load(std::memory_order_acquire), std::memory_order_release);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+        { uint64_t cur=v.live_cf_hz.load(std::memory_order_acquire);
+          if(cur!=prev_cf || ch.s!=prev_s || ch.e!=prev_e) build(cur); }
+        apply_links();
+
+        size_t wp=v.ring_wp.load(std::memory_order_acquire);
+        size_t rp=my_rp.load(std::memory_order_relaxed);
+        size_t lag=(wp-rp)&IQ_RING_MASK;
+        if(lag>MAX_LAG){                                    // 과부하 → 경계 점프 + 상태 리셋
+            size_t keep=(size_t)(msr*0.02);
+            rp=(wp-keep)&IQ_RING_MASK; my_rp.store(rp,std::memory_order_release);
+            reset_all();
+            lag=(wp-rp)&IQ_RING_MASK;
+        }
+        int nb = (int)std::min<size_t>(lag/(size_t)L, WIDE_MAX_BLOCKS);
+        if(nb==0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
+
+        size_t take=(size_t)nb*L;
+        BEWE_TRACE_SCOPE_ARG("mod", "btle_wide_batch", take);
+        for(size_t s=0;s<take;s++){
+            size_t pos=(rp+s)&IQ_RING_MASK;
+            stage[s]=lv_32fc_t(v.ring[pos*2]*inv_scale, v.ring[pos*2+1]*inv_scale);
+        }
+        for(int b=0;b<nb;b++) bank.forward(stage.data()+(size_t)b*L, spec.data()+(size_t)b*N);
+        ctx.spec=spec.data(); ctx.nb=nb;
+        run_batch(ctx, chans);
+        my_rp.store((rp+take)&IQ_RING_MASK,std::memory_order_release);
+
+        int64_t t=now_ms();
+        if(t-last_diag>=3000){                              // ~3초 진단: 광고 채널별 + 데이터 합계
+            char line[160]; int o=0; long d_ok=0, d_fail=0;
+            for(auto& c : chans){
+                if(c->idx>=37){
+                    if(o<(int)sizeof(line)-24)
+                        o+=snprintf(line+o,sizeof(line)-o," %d:%ld/%ld",c->idx,c->dec.dg_ok,c->dec.dg_fail);
+                } else { d_ok+=c->dec.dg_ok; d_fail+=c->dec.dg_fail; }
+                c->dec.diag_reset();
+            }
+            line[o]=0;
+            bewe_log_push(0,"BTLE[%d] diag: crcOK/FAIL%s  data:%ld/%ld links=%d\n",
+                ch_idx, line, d_ok, d_fail, (int)links.size());
+            last_diag=t;
+        }
+    }
+    g_pool.release();
+    if(!worker_stop_req(ch_idx)) worker_natural_exit(v, ch_idx);
+    bewe_log_push(0,"BTLE[%d] stop\n",ch_idx);
+}
+
 void worker(FFTViewer& v, int ch_idx){
     Channel& ch = v.channels[ch_idx];
+    if(ble_chans_in(std::min(ch.s,ch.e), std::max(ch.s,ch.e)) >= 2){ worker_wide(v, ch_idx); return; }
     uint32_t msr = v.header.sample_rate;
     const float inv_scale=1.0f/v.hw.iq_scale;  // ÷ → ×
     uint64_t init_cf = v.live_cf_hz.load(std::memory_order_acquire);
@@ -64,6 +297,7 @@ void worker(FFTViewer& v, int ch_idx){
     const size_t BATCH  =std::max<size_t>(4096, msr/50);
     std::atomic<size_t>& my_rp = worker_rp(ch_idx);
     my_rp.store(v.ring_wp.load());
+    PipeStats::ReaderScope rs_(my_rp, "btlew", ch_idx);
     int64_t last_diag=now_ms();
 
     bool hold_prev=false;
@@ -102,6 +336,7 @@ void worker(FFTViewer& v, int ch_idx){
         if(lag==0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("mod", "btle_batch", avail);
         fm.clear(); amp.clear();
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
@@ -3,10 +3,11 @@
 // 입력 = 채널 baseband 의 FM 판별기 출력열(순시주파수) d[n], 샘플레이트 fs (≈4 MHz).
 //        RF→baseband DDC/데시메이션/FM판별은 워커(btle_decode.cpp). adsb_decode.hpp 미러.
 //
-// 물리계층 (1M PHY, 광고 채널):
+// 물리계층 (1M PHY):
 //   • GFSK 1 Mbit/s. bit 1 = 양(+) 주파수편이, bit 0 = 음(-). FM판별 부호 = 비트.
 //   • 비트 전송순서 LSB-first. 프리앰블 8b(AA LSB=0 → 0xAA) + AccessAddress 32b.
 //     광고 AccessAddress 는 고정 0x8E89BED6 → 40-bit 상관기로 동기.
+//     데이터 채널(0..36)은 CONNECT_IND 로 배운 연결 AA/CRCInit 목록(set_links)으로 동기.
 //   • AA 이후(헤더+페이로드+CRC)는 채널인덱스로 화이트닝(LFSR x^7+x^4+1).
 //   • PDU 헤더 2B(type/ChSel/TxAdd/RxAdd/Length) → 페이로드 Length B → CRC 3B.
 //   • CRC-24 (poly 0x00065B, 광고 init 0x555555). 통과 시 무오류.
@@ -37,19 +38,31 @@ public:
     float sync_thresh=0.80f;   // AA 정규화 상관 임계 (실측: 진짜 패킷 0.9+, 노이즈 컷)
     void  diag_reset(){ dg_samp=dg_sync=dg_lenok=dg_ok=dg_fail=0; dg_maxlev=0; }
 
+    // adv_channel = BLE 채널 인덱스 (37..39 광고 → 광고 AA 고정, 0..36 데이터 → set_links).
     void reset(double sample_rate, int ch_idx, int adv_channel){
         sr  = sample_rate>1.0 ? sample_rate : 4000000.0;
         spb = sr/1e6;                       // samples per bit (1 Mbit/s)
+        for(int k=0;k<MAX_BITS;k++) bit_off[k] = (int)llround((k+0.5)*spb);   // 비트 k 중심 오프셋
         ch  = ch_idx;
         adv_chan = adv_channel;
         buf.clear(); buf_amp.clear(); samp_base=0;
-        build_ref();
+        links_.clear();
+        if(adv_chan>=37) links_.push_back(make_link(ADV_AA, 0x555555));
     }
 
+    // 데이터 채널: 추적할 연결 (AA, CRCInit) 목록 교체. 버퍼는 유지.
+    void set_links(const uint32_t* aa, const uint32_t* crc_init, int n){
+        if(adv_chan>=37) return;
+        links_.clear();
+        for(int i=0;i<n && i<MAX_LINKS;i++) links_.push_back(make_link(aa[i], crc_init[i]));
+    }
+    static constexpr int MAX_LINKS = 4;     // 상관 비용 ∝ 링크 수
+
     // 워커가 FM판별 샘플(d) + 동위치 순시전력(amp=oi²+oq²) 묶음을 투입. AA 동기 스캔 + 해독.
     void process(const float* d, const float* amp, size_t n){
         dg_samp += (long)n;
         for(size_t i=0;i<n;i++){ float a=std::fabs(d[i]); if(a>dg_maxlev) dg_maxlev=a; }
+        if(links_.empty()){ buf.clear(); buf_amp.clear(); samp_base += (double)n; return; }   // 추적 연결 없음
         buf.insert(buf.end(), d, d+n);
         buf_amp.insert(buf_amp.end(), amp, amp+n);   // RSSI용 (buf 와 동일 인덱싱)
         // 최장: 40-bit 동기 + (헤더2+페이로드37+CRC3)=42B → 376 bit
@@ -58,10 +71,10 @@ public:
         size_t limit = buf.size() - need;
         size_t j=0;
         while(j <= limit){
-            int pol; float dc;
-            if(find_sync(j, pol, dc)){
+            int pol, li; float dc;
+            if(find_sync(j, pol, dc, li)){
                 dg_sync++;
-                int adv = decode_at(j, pol, dc);
+                int adv = decode_at(j, pol, dc, links_[(size_t)li]);
                 if(adv>0){ j += (size_t)adv; continue; }
             }
             j++;
@@ -73,49 +86,70 @@ public:
 
 private:
     static constexpr int    SYNC_BITS   = 40;     // 8 프리앰블 + 32 AA
+    static constexpr int    MAX_BITS    = SYNC_BITS + 44*8;   // 동기 + raw[44]
     static constexpr uint32_t ADV_AA    = 0x8E89BED6u;
 
+    struct Link {
+        uint32_t aa=0, crc_init=0;
+        float    sgn[SYNC_BITS];      // 기대 동기 비트 (프리앰블+AA) → ±1 (분기 없는 내적)
+    };
+
     double sr=4000000.0, spb=4.0, samp_base=0;
     int    ch=0, adv_chan=37;
     std::vector<float> buf;
     std::vector<float> buf_amp;   // buf 동위치 순시전력 (RSSI 산출용)
-    uint8_t ref_[SYNC_BITS];   // 기대 동기 비트 (프리앰블+AA)
+    std::vector<Link>  links_;
+    int    bit_off[MAX_BITS] = {};  // reset 에서 1회 — 샘플마다 llround 안 함
 
     // ── 비트 k 중심의 FM판별 소프트값 (oversampled) ──
     inline float samp(size_t j, int k) const {
-        long idx = (long)j + (long)llround((k+0.5)*spb);
+        long idx = (long)j + bit_off[k];
         if(idx<0 || idx>=(long)buf.size()) return 0.f;
         return buf[idx];
     }
 
     // 동기 기대 비트열: 프리앰블(AA LSB 따라 0xAA/0x55) + AA 4바이트(byte0 LSB-first)
-    void build_ref(){
-        uint8_t aa[4]={ (uint8_t)(ADV_AA), (uint8_t)(ADV_AA>>8),
-                        (uint8_t)(ADV_AA>>16), (uint8_t)(ADV_AA>>24) };
+    static Link make_link(uint32_t aa_v, uint32_t crc_init){
+        Link L; L.aa=aa_v; L.crc_init=crc_init&0xFFFFFF;
+        uint8_t aa[4]={ (uint8_t)(aa_v), (uint8_t)(aa_v>>8),
+                        (uint8_t)(aa_v>>16), (uint8_t)(aa_v>>24) };
         uint8_t pre = (aa[0]&1) ? 0x55 : 0xAA;
-        for(int b=0;b<8;b++)  ref_[b]      = (pre>>b)&1;        // 프리앰블 LSB-first
+        for(int b=0;b<8;b++)  L.sgn[b]      = ((pre>>b)&1) ? 1.f : -1.f;        // 프리앰블 LSB-first
         for(int B=0;B<4;B++)
-            for(int b=0;b<8;b++) ref_[8+B*8+b] = (aa[B]>>b)&1;  // AA LSB-first
+            for(int b=0;b<8;b++) L.sgn[8+B*8+b] = ((aa[B]>>b)&1) ? 1.f : -1.f;  // AA LSB-first
+        return L;
     }
 
-    // AA 40-bit 정규화 상관. 성공 시 pol(극성 ±1) / dc(슬라이스 기준) 반환.
-    bool find_sync(size_t j, int& pol, float& dc) const {
+    // AA 40-bit 정규화 상관 (링크별 ref, 소프트값/평균은 공유). 성공 시 pol(극성 ±1) /
+    // dc(슬라이스 기준) / li(링크 인덱스) 반환. 샘플마다 호출되는 hot path —
+    // j ≤ limit (process) 이라 동기 40비트는 항상 buf 안 → 경계검사 없이 직접 읽음.
+    bool find_sync(size_t j, int& pol, float& dc, int& li) const {
         float vals[SYNC_BITS], mean=0;
-        for(int k=0;k<SYNC_BITS;k++){ vals[k]=samp(j,k); mean+=vals[k]; }
+        const float* p = buf.data() + j;
+        for(int k=0;k<SYNC_BITS;k++){ vals[k]=p[bit_off[k]]; mean+=vals[k]; }
         mean/=SYNC_BITS;
-        float corr=0, energy=0;
-        for(int k=0;k<SYNC_BITS;k++){
-            float s=vals[k]-mean;
-            corr   += s*(ref_[k]?1.f:-1.f);
-            energy += std::fabs(s);
-        }
+        float energy=0;
+        for(int k=0;k<SYNC_BITS;k++){ vals[k]-=mean; energy+=std::fabs(vals[k]); }
         if(energy < 1e-5f) return false;
-        float score = corr/energy;          // [-1,+1]
-        if(std::fabs(score) < sync_thresh) return false;
-        pol = (score>0)?1:-1; dc = mean;
+        float best=0; int bi=-1;
+        for(size_t l=0;l<links_.size();l++){
+            const float* sgn=links_[l].sgn;
+            float corr=0;
+            for(int k=0;k<SYNC_BITS;k++) corr += sgn[k]*vals[k];
+            if(std::fabs(corr) > std::fabs(best)){ best=corr; bi=(int)l; }
+        }
+        float score = best/energy;          // [-1,+1]
+        if(bi<0 || std::fabs(score) < sync_thresh) return false;
+        pol = (score>0)?1:-1; dc = mean; li = bi;
         return true;
     }
 
+    static uint32_t reflect24(uint32_t v){
+        uint32_t r=0;
+        for(int b=0;b<24;b++) if(v&(1u<<b)) r|=1u<<(23-b);
+        return r;
+    }
+
     // BLE 화이트닝 LFSR (x^7+x^4+1, Vol6 PartB 3.2). 채널인덱스로 seed.
     struct Whiten {
         uint8_t r[7];
@@ -146,7 +180,8 @@ private:
     }
 
     // 동기 j 에서 PDU 해독. 성공 시 소비 샘플수(>0), 길이 비정상이면 0.
-    int decode_at(size_t j, int pol, float dc){
+    int decode_at(size_t j, int pol, float dc, const Link& L){
+        bool adv = (L.aa==ADV_AA);
         Whiten w; w.init(adv_chan);
         uint8_t raw[44]={0};
         auto get_byte=[&](int bytePos)->uint8_t{
@@ -162,15 +197,16 @@ private:
         raw[0]=get_byte(0); raw[1]=get_byte(1);
         int pdu_type=raw[0]&0x0F;
         int txadd   =(raw[0]>>6)&1;
-        int length  = raw[1]&0x3F;                            // 페이로드 길이
-        if(length<6 || length>37) return 0;                   // AdvA 6B 미만/과대 → 잡음
+        int length  = adv ? (raw[1]&0x3F) : raw[1];          // 페이로드 길이 (데이터 PDU 8bit)
+        if(adv ? (length<6 || length>37) : length>37) return 0;   // AdvA 6B 미만/과대 → 잡음
         dg_lenok++;
         int total = 2 + length + 3;
         for(int b=2;b<total;b++) raw[b]=get_byte(b);
 
         // 광고 CRCInit = 0x555555 (Vol6). reflected(LSB-first) LFSR 라 비트역전값 0xAAAAAA 로 로드.
         // (실캡처 검증: seed/tap/poly 0xDA6000 일치, init 0xAAAAAA 에서만 CRC 통과)
-        uint32_t calc = ble_crc(raw, 2+length, 0xAAAAAA);
+        // 데이터 채널은 CONNECT_IND CRCInit 을 같은 규칙(비트역전)으로 로드.
+        uint32_t calc = ble_crc(raw, 2+length, reflect24(L.crc_init));
         uint32_t rx   = (uint32_t)raw[2+length] | ((uint32_t)raw[3+length]<<8)
                       | ((uint32_t)raw[4+length]<<16);
         bool ok = (calc==rx);
@@ -194,6 +230,22 @@ private:
         m.rssi=rssi; m.cfo_hz=cfo;
         const uint8_t* pl = raw+2;
 
+        if(!adv){                                             // 데이터 채널 PDU
+            if(length==0) return consumed;                    // 빈 PDU (연결 keep-alive) → 미출력
+            int llid = raw[0]&0x03;
+            m.pdu_type = 0x10|llid; m.addr_type=0;
+            m.access_addr = L.aa; m.crc_init = L.crc_init;
+            if(llid==0x3)
+                snprintf(m.info,sizeof(m.info),"LL_CTRL op=0x%02X len=%d", pl[0], length);
+            else if(llid==0x2 && length>=4){                  // L2CAP 시작: len(2) + CID(2)
+                int cid=pl[2]|(pl[3]<<8);
+                const char* cn = cid==0x0004?" ATT":(cid==0x0005?" LE-SIG":(cid==0x0006?" SMP":""));
+                snprintf(m.info,sizeof(m.info),"L2CAP cid=0x%04X%s len=%d", cid, cn, length);
+            } else
+                snprintf(m.info,sizeof(m.info),"LL_DATA len=%d", length);
+            if(on_record) on_record(m);
+            return consumed;
+        }
         if(pdu_type==0x5){                                    // CONNECT_IND
             m.is_connect=true;
             for(int i=0;i<6;i++){ m.init_mac[i]=pl[5-i]; m.mac[i]=pl[11-i]; }
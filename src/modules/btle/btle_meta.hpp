@@ -15,7 +15,7 @@ struct BtleRecord {
     float    rssi    = 0.f;     // 패킷 평균전력 dBFS (상대 신호세기, 0=미측정)
     float    cfo_hz  = 0.f;     // 반송파 주파수오프셋 Hz (송신기 RF 지문; RX LO 공통분 포함)
 
-    int      adv_chan  = 37;    // 광고 채널 (37/38/39)
+    int      adv_chan  = 37;    // 채널 인덱스 (광고 37/38/39, 광대역 데이터 0..36)
     int      pdu_type  = 0;     // 0=ADV_IND..6=ADV_SCAN_IND (Vol6 PartB 2.3)
     int      addr_type = 0;     // 0=public, 1=random (TxAdd)
     uint8_t  mac[6]    = {};    // AdvA (표시순: mac[0]=MSB)
@@ -31,7 +31,7 @@ struct BtleRecord {
     // ── CONNECT_IND (pdu_type==5) 연결 파라미터 ──
     bool     is_connect = false;
     uint8_t  init_mac[6]= {};   // InitA (표시순)
-    uint32_t access_addr= 0;     // 데이터 채널 AccessAddress
+    uint32_t access_addr= 0;     // 데이터 채널 AccessAddress (데이터 PDU 는 수신 AA)
     uint32_t crc_init   = 0;     // 데이터 채널 CRCInit (24-bit)
     int      interval   = 0;     // connInterval (단위 1.25 ms)
     int      timeout    = 0;     // supervisionTimeout (단위 10 ms)
@@ -94,10 +94,23 @@ inline const char* btle_pdu_name(int t){
         case 0x5: return "CONNECT_IND";
         case 0x6: return "ADV_SCAN_IND";
         case 0x7: return "ADV_EXT_IND";
+        case 0x11: return "LL_DATA";        // 데이터 채널 PDU = 0x10|LLID (광대역 모드)
+        case 0x12: return "LL_DATA_START";
+        case 0x13: return "LL_CONTROL";
         default:  return "";
     }
 }
 
+// ── BLE 채널 인덱스 → 중심 MHz (37=2402 / 38=2426 / 39=2480, 데이터 0..36 은 나머지 2 MHz 격자)
+inline float btle_chan_mhz(int idx){
+    if(idx==37) return 2402.f;
+    if(idx==38) return 2426.f;
+    if(idx==39) return 2480.f;
+    if(idx>=0 && idx<=10)  return 2404.f + 2.f*idx;
+    if(idx>=11 && idx<=36) return 2428.f + 2.f*(idx-11);
+    return 2402.f;
+}
+
 // ── 제조사 회사ID → 이름 (Bluetooth SIG Assigned Numbers, 소비자기기 위주 발췌) ──
 // 값은 공식 SIG company_identifiers.yaml 대조 검증. (Qualcomm/Polar 등 일부는 합병/이전
 // 으로 복수 ID 존재 → 그대로 둠.) 미수록 ID 는 호출측에서 raw 0xXXXX 로 표기.
@@ -191,6 +191,7 @@ static uint64_t btle_content_hash(const BtleRecord& m){
 static bool btle_is_dup(const BtleRecord& m){
     if(m.is_connect) return false;                     // 연결요청 항상 보존
     uint64_t mac=0; for(int b=0;b<6;b++) mac=(mac<<8)|m.mac[b];
+    if(m.pdu_type>=0x10) mac = (1ULL<<63) | m.access_addr;   // 데이터 PDU: AdvA 없음 → 연결 AA 키
     uint64_t hsh=btle_content_hash(m);
     std::lock_guard<std::mutex> lk(g_dedup_mtx);
     auto it=g_dedup.find(mac);
@@ -203,14 +204,15 @@ static bool btle_is_dup(const BtleRecord& m){
 
 // ── HOST: 워커 → 스탬프 + 중복억제 + 아카이브 + framework emit ──────────────
 void host_emit(FFTViewer& v, BtleRecord m){
-    if(m.ch>=0 && m.ch<MAX_CHANNELS && v.channels[m.ch].filter_active)
-        m.freq = (v.channels[m.ch].s + v.channels[m.ch].e)/2.0f;
+    if(m.freq==0.f && m.ch>=0 && m.ch<MAX_CHANNELS && v.channels[m.ch].filter_active)
+        m.freq = (v.channels[m.ch].s + v.channels[m.ch].e)/2.0f;   // 광대역 모드는 BLE 채널 MHz 를 채워 옴
     m.t_ms = (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
                  std::chrono::system_clock::now().time_since_epoch()).count();
     if(btle_is_dup(m)) return;                          // 중복 비콘 → 저장·전송 생략
     store_append(m);
     BtleWireMsg w; btle_msg_to_wire(m, w);
     bewe_mod_emit(v, "btle", &w, sizeof(w));
+    bewe_mod_tm_pin(v, "btle", m.ch);
 }
 
 static void on_data(FFTViewer& v, const char* station, const uint8_t* d, size_t n){
@@ -25,8 +25,8 @@ void hms(int64_t ms, char* o){
 void mac_str(const uint8_t* m, char* o){ // o[18]
     snprintf(o,18,"%02X:%02X:%02X:%02X:%02X:%02X",m[0],m[1],m[2],m[3],m[4],m[5]);
 }
-// 광고 채널번호 → 정규 중심주파수 MHz (측정 freq 아님: 37=2402 / 38=2426 / 39=2480)
-float adv_chan_mhz(int c){ return c==38?2426.f:(c==39?2480.f:2402.f); }
+// 채널번호 → 정규 중심주파수 MHz (측정 freq 아님: 37=2402 / 38=2426 / 39=2480, 데이터 0..36)
+float adv_chan_mhz(int c){ return btle_chan_mhz(c); }
 // RSSI(dBFS) → 신호세기 색 (강/중/약)
 ImVec4 rssi_col(float d){
     if(d>-45.f) return ImVec4(0.45f,0.85f,0.45f,1.f);
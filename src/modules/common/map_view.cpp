@@ -1,8 +1,12 @@
 // ── 공용 2D 지도 위젯 구현 (GUI 전용, *_view.cpp → CLI 빌드 제외, 1회 컴파일) ─
 // 순수 ImGui ImDrawList. 등거리원통 투영 + OSM 한국 육지/해안선 +
 // 위경도 격자 + 항적 꼬리 + 침로 마커 + 커서고정 휠줌 + 드래그 팬 + auto-fit.
+// 해안선/육지는 줌별 LOD(Douglas–Peucker) + 카메라 변경 시만 재투영 캐시,
+// 밀집 마커는 화면 격자 클러스터링 → 그리는 양(draw call/정점)은 화면 셀 수로 제한.
+// 투영 + 셀 배정은 여전히 매 프레임 O(표적 수) (점 몇 개 곱셈 — 마커 수만 개에서도 draw 보다 작음).
 #include "modview_map.hpp"
 #include "../../korea_osm_data.hpp"   // OSM 한국 해안선 (KR_OSM_COAST) — 육지/해안선 유일 소스
+#include "../../geo_lod.hpp"
 #include <cmath>
 #include <cstdio>
 #include <algorithm>
@@ -52,34 +56,41 @@ static void fit_to_points(MapView& v, const std::vector<MapPoint>& pts, float W,
     normalize(v,W,H);
 }
 
-// 육지 채움용 엣지 — 해안선(KR_OSM_COAST) 닫힌 링만 모아 lat 오름차순 정렬 (1회 캐시).
+// 해안선 LOD 레벨 (1회 빌드). 허용오차 deg — 화면 0.5px 이하인 가장 거친 레벨 사용.
+// 전체 한국(~7° / 수백 px)이면 0.003°, 항구 단위 확대면 원본.
+static const std::vector<GeoLod::Level>& coast_levels(){
+    static const float EPS[]={0.f, 0.0003f, 0.001f, 0.003f, 0.01f};
+    static std::vector<GeoLod::Level> L = GeoLod::build(KR_OSM_COAST, KR_OSM_COAST_COUNT, EPS, 5);
+    return L;
+}
+static int coast_lod(const MapView& v, float H){
+    return GeoLod::pick(coast_levels(), (v.lat1-v.lat0)/H);
+}
+
+// 육지 채움용 엣지 — 해안선(KR_OSM_COAST) 닫힌 링만 모아 lat 오름차순 정렬 (레벨별 1회 캐시).
 // 화면 scanline even-odd 로 "해안선이 둘러싼 영역"을 그대로 채우는 paint-bucket 용.
 struct FillEdge { float latlo, lathi, lonlo, slope; };  // lonlo=latlo 에서의 lon, slope=dlon/dlat
-static const std::vector<FillEdge>& fill_edges(){
-    static std::vector<FillEdge> E; static bool done=false;
-    if(!done){
-        done=true;
-        std::vector<float> rla, rlo;   // 현재 링 (lat,lon)
-        auto flush=[&](){
-            size_t n=rla.size();
-            if(n>=3 && std::fabs(rla.front()-rla.back())<0.002f
-                    && std::fabs(rlo.front()-rlo.back())<0.002f){   // 닫힌 링만
-                for(size_t i=0;i<n;i++){
-                    float la1=rla[i], lo1=rlo[i];
-                    float la2=rla[(i+1)%n], lo2=rlo[(i+1)%n];
+static const std::vector<FillEdge>& fill_edges(int lod){
+    static std::vector<std::vector<FillEdge>> cache;
+    const std::vector<GeoLod::Level>& L = coast_levels();
+    if(cache.empty()) cache.resize(L.size());
+    std::vector<FillEdge>& E = cache[lod];
+    if(E.empty()){
+        const GeoLod::Level& lv = L[lod];
+        for(const GeoLod::Line& ln : lv.lines){
+            const float* q=&lv.pts[2*ln.start];
+            int n=ln.count;
+            if(n>=3 && std::fabs(q[0]-q[2*n-2])<0.002f
+                    && std::fabs(q[1]-q[2*n-1])<0.002f){   // 닫힌 링만
+                for(int i=0;i<n;i++){
+                    float la1=q[2*i], lo1=q[2*i+1];
+                    float la2=q[2*((i+1)%n)], lo2=q[2*((i+1)%n)+1];
                     if(la1==la2) continue;
                     if(la1>la2){ std::swap(la1,la2); std::swap(lo1,lo2); }
                     E.push_back({la1,la2,lo1,(lo2-lo1)/(la2-la1)});
                 }
             }
-            rla.clear(); rlo.clear();
-        };
-        for(int i=0;i+1<KR_OSM_COAST_COUNT;i+=2){
-            float lat=KR_OSM_COAST[i], lon=KR_OSM_COAST[i+1];
-            if(std::isnan(lat)){ flush(); continue; }
-            rla.push_back(lat); rlo.push_back(lon);
         }
-        flush();
         std::sort(E.begin(),E.end(),[](const FillEdge&a,const FillEdge&b){ return a.latlo<b.latlo; });
     }
     return E;
@@ -161,8 +172,9 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
     }
 
     // ── OSM 한국 육지 채움 (해안선이 둘러싼 영역을 화면 픽셀행 even-odd scanline 으로 채움) ──
-    // paint-bucket: 흰 해안선과 동일 데이터(닫힌 링)를 화면 1px 행마다 채워 줌 무관 픽셀 단위 매끈.
-    // 카메라(bbox)/크기 변경 시만 재계산 → v._fill 막대(p0 상대 px) 캐시, 정지 프레임은 재방출만.
+    // paint-bucket: 흰 해안선과 동일 데이터(닫힌 링)를 화면 1px 행마다 교차 계산해 줌 무관 픽셀 단위 매끈.
+    // 같은 엣지 쌍이 이어지는 행들은 사다리꼴 1개로 합침 (직선 엣지라 정확) → 행×구간 막대 대신 수백 개 quad.
+    // 카메라(bbox)/크기 변경 시만 재계산 → v._fill (p0 상대 px) 캐시, 정지 프레임은 재방출만.
     if(v.show_land && kr_active){
         bool changed = v.lat0!=v._fl_lat0 || v.lat1!=v._fl_lat1
                     || v.lon0!=v._fl_lon0 || v.lon1!=v._fl_lon1
@@ -170,11 +182,17 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
         if(changed){
             v._fl_lat0=v.lat0; v._fl_lat1=v.lat1; v._fl_lon0=v.lon0; v._fl_lon1=v.lon1; v._fl_W=W; v._fl_H=H;
             v._fill.clear();
-            const std::vector<FillEdge>& E = fill_edges();
+            const std::vector<FillEdge>& E = fill_edges(coast_lod(v,H));
             double latspan=v.lat1-v.lat0, lonspan=v.lon1-v.lon0;
             size_t NE=E.size(), ei=0;
+            struct Run { const FillEdge *ea, *eb; int y0, y1; float a0, b0, a1, b1; };  // y0=첫(아래) 행, y1=마지막(위) 행
             static std::vector<const FillEdge*> active; active.clear();
-            static std::vector<float> xs;
+            static std::vector<std::pair<float,const FillEdge*>> xs;
+            static std::vector<Run> open, next; open.clear();
+            auto emit=[&](const Run& r){
+                float f[6]={(float)r.y1, r.a1, r.b1, (float)r.y0+1.0f, r.a0, r.b0};
+                v._fill.insert(v._fill.end(), f, f+6);
+            };
             int Hi=(int)H;
             for(int yy=Hi-1; yy>=0; --yy){                       // 아래(저위도)→위 = lat 오름차순 sweep
                 double latc = v.lat1 - ((yy+0.5)/(double)Hi)*latspan;
@@ -186,35 +204,83 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
                 xs.clear();
                 for(const FillEdge* e : active)
                     if(e->latlo<=latc && latc<e->lathi)
-                        xs.push_back(e->lonlo + (float)(latc-e->latlo)*e->slope);   // 교차 lon
-                if(xs.size()<2) continue;
-                std::sort(xs.begin(), xs.end());
+                        xs.push_back({e->lonlo + (float)(latc-e->latlo)*e->slope, e});   // 교차 lon
+                std::sort(xs.begin(), xs.end(), [](const std::pair<float,const FillEdge*>& a,
+                                                   const std::pair<float,const FillEdge*>& b){ return a.first<b.first; });
+                next.clear();
+                size_t j=0;                                        // open 도 x 순 → 순방향 탐색
                 for(size_t k=0;k+1<xs.size();k+=2){               // even-odd: 쌍 사이 채움
-                    float dx0=(float)((xs[k]  -v.lon0)/lonspan*W);
-                    float dx1=(float)((xs[k+1]-v.lon0)/lonspan*W);
-                    v._fill.push_back(dx0); v._fill.push_back((float)yy); v._fill.push_back(dx1);
+                    float dx0=(float)((xs[k].first  -v.lon0)/lonspan*W);
+                    float dx1=(float)((xs[k+1].first-v.lon0)/lonspan*W);
+                    const FillEdge *ea=xs[k].second, *eb=xs[k+1].second;
+                    size_t m=j;
+                    while(m<open.size() && !(open[m].ea==ea && open[m].eb==eb)) ++m;
+                    if(m<open.size()){
+                        for(size_t q=j;q<m;q++) emit(open[q]);    // 건너뛴 구간은 끝남
+                        Run r=open[m]; r.y1=yy; r.a1=dx0; r.b1=dx1;
+                        next.push_back(r); j=m+1;
+                    } else next.push_back({ea,eb,yy,yy,dx0,dx1,dx0,dx1});
                 }
+                for(size_t q=j;q<open.size();q++) emit(open[q]);
+                open.swap(next);
             }
+            for(const Run& r : open) emit(r);
         }
         ImU32 lc=IM_COL32(34,46,40,255);
-        for(size_t i=0;i+2<v._fill.size();i+=3)
-            dl->AddRectFilled(ImVec2(p0.x+v._fill[i],   p0.y+v._fill[i+1]),
-                              ImVec2(p0.x+v._fill[i+2], p0.y+v._fill[i+1]+1.0f), lc);
+        ImDrawListFlags fl=dl->Flags;
+        dl->Flags &= ~ImDrawListFlags_AntiAliasedFill;     // 인접 사다리꼴 AA 이음새 방지
+        for(size_t i=0;i+5<v._fill.size();i+=6){
+            const float* f=&v._fill[i];
+            dl->AddQuadFilled(ImVec2(p0.x+f[1], p0.y+f[0]), ImVec2(p0.x+f[2], p0.y+f[0]),
+                              ImVec2(p0.x+f[5], p0.y+f[3]), ImVec2(p0.x+f[4], p0.y+f[3]), lc);
+        }
+        dl->Flags=fl;
     }
 
-    // ── OSM 한국 해안선 (KR_OSM_COAST: interleaved lat,lon, NAN 끊김, 화면밖 컬링) ──
+    // ── OSM 한국 해안선 (LOD 레벨, 라인 bbox + 선분 화면밖 컬링, 카메라 변경 시만 재투영) ──
     if(v.show_coast && kr_active){
-        bool have=false; ImVec2 prev;
-        for(int i=0;i+1<KR_OSM_COAST_COUNT;i+=2){
-            float lat=KR_OSM_COAST[i], lon=KR_OSM_COAST[i+1];
-            if(std::isnan(lat)){ have=false; continue; }
-            ImVec2 cur=LL2PX(lat,lon);
-            if(have){
-                bool out=(prev.x<p0.x&&cur.x<p0.x)||(prev.x>p1.x&&cur.x>p1.x)||
-                         (prev.y<p0.y&&cur.y<p0.y)||(prev.y>p1.y&&cur.y>p1.y);
-                if(!out) dl->AddLine(prev,cur, IM_COL32(120,150,175,255), 1.2f);
+        bool changed = v.lat0!=v._cs_lat0 || v.lat1!=v._cs_lat1
+                    || v.lon0!=v._cs_lon0 || v.lon1!=v._cs_lon1
+                    || W!=v._cs_W || H!=v._cs_H;
+        if(changed){
+            v._cs_lat0=v.lat0; v._cs_lat1=v.lat1; v._cs_lon0=v.lon0; v._cs_lon1=v.lon1; v._cs_W=W; v._cs_H=H;
+            v._coast.clear(); v._coast_n.clear();
+            v._lod = coast_lod(v,H);
+            const GeoLod::Level& L = coast_levels()[v._lod];
+            const int CHUNK=4096;                          // 폴리라인 1개당 점 상한 (16bit 인덱스 여유)
+            double sx=W/(v.lon1-v.lon0), sy=H/(v.lat1-v.lat0);
+            for(const GeoLod::Line& ln : L.lines){
+                if(ln.lat1<v.lat0||ln.lat0>v.lat1||ln.lon1<v.lon0||ln.lon0>v.lon1) continue;
+                const float* q=&L.pts[2*ln.start];
+                int run=0; ImVec2 prev;
+                auto end_run=[&](){
+                    if(run>=2) v._coast_n.push_back(run); else v._coast.resize(v._coast.size()-run);
+                    run=0;
+                };
+                for(int i=0;i<ln.count;i++){
+                    ImVec2 cur((float)((q[2*i+1]-v.lon0)*sx), (float)((v.lat1-q[2*i])*sy));
+                    if(i>0){
+                        bool out=(prev.x<0&&cur.x<0)||(prev.x>W&&cur.x>W)||
+                                 (prev.y<0&&cur.y<0)||(prev.y>H&&cur.y>H);
+                        if(out) end_run();
+                        else {
+                            if(run==0){ v._coast.push_back(prev); run=1; }
+                            v._coast.push_back(cur); run++;
+                            if(run>=CHUNK){ end_run(); v._coast.push_back(cur); run=1; }
+                        }
+                    }
+                    prev=cur;
+                }
+                end_run();
             }
-            prev=cur; have=true;
+        }
+        static std::vector<ImVec2> abs_pts;
+        size_t o=0;
+        for(int n : v._coast_n){
+            abs_pts.resize(n);
+            for(int k=0;k<n;k++) abs_pts[k]=ImVec2(p0.x+v._coast[o+k].x, p0.y+v._coast[o+k].y);
+            dl->AddPolyline(abs_pts.data(), n, IM_COL32(120,150,175,255), ImDrawFlags_None, 1.2f);
+            o+=n;
         }
     }
     dl->PopClipRect();   // KR bbox 클립 해제 (격자/마커는 전체 캔버스에)
@@ -241,12 +307,54 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
     }
 
     // ── 항적 + 마커 ── (최근접 마커 추적 → hover/click)
+    // 보이는 마커가 CLUSTER_MIN 초과면 비선택 마커를 CELL px 화면 격자로 묶어 셀당 버블 1개(개수)만 그림.
+    // 그리는 양 = 화면 셀 수 상한. 투영/셀 배정은 매 프레임 전 표적 O(N) (pts 가 프레임마다 바뀌므로 캐시 안 함).
+    // 선택 마커·홀로 있는 마커는 개별 표시, 꼬리/라벨은 선택만.
+    const float CELL=32.f; const int CLUSTER_MIN=300;
     int best=-1; float bestd=1e9f; ImVec2 mp=io.MousePos;
     bool any_sel=false; for(const auto& p : pts) if(p.selected){ any_sel=true; break; }  // 선택 배 있으면 그 배만 꼬리
+    static std::vector<ImVec2> scr; static std::vector<int> cell_of;
+    scr.resize(pts.size()); cell_of.assign(pts.size(), -1);
+    int nvis=0;
+    for(size_t i=0;i<pts.size();i++){
+        scr[i]=LL2PX(pts[i].lat, pts[i].lon);
+        if(!(scr[i].x<p0.x||scr[i].x>p1.x||scr[i].y<p0.y||scr[i].y>p1.y)) nvis++;
+    }
+    bool clus = v.cluster && nvis>CLUSTER_MIN;
+    int gw=(int)(W/CELL)+1, gh=(int)(H/CELL)+1;
+    static std::vector<int> cell_n, cell_first; static std::vector<float> cell_x, cell_y;
+    if(clus){
+        cell_n.assign(gw*gh,0); cell_first.assign(gw*gh,-1); cell_x.assign(gw*gh,0.f); cell_y.assign(gw*gh,0.f);
+        for(size_t i=0;i<pts.size();i++){
+            ImVec2 s=scr[i];
+            if(pts[i].selected || s.x<p0.x||s.x>p1.x||s.y<p0.y||s.y>p1.y) continue;
+            int c=std::min(gh-1,(int)((s.y-p0.y)/CELL))*gw + std::min(gw-1,(int)((s.x-p0.x)/CELL));
+            cell_of[i]=c; cell_n[c]++; cell_x[c]+=s.x; cell_y[c]+=s.y;
+            if(cell_first[c]<0) cell_first[c]=(int)i;
+        }
+    }
+    // ── 클러스터 버블 (셀 무게중심, 반경 ∝ log2 개수, 첫 마커 색; 선택 마커 아래) ──
+    int clus_hit=-1; float clus_d=1e9f;
+    if(clus){
+        char cnt[12];
+        for(int c=0;c<gw*gh;c++){
+            int n=cell_n[c]; if(n<2) continue;
+            ImVec2 cc(cell_x[c]/n, cell_y[c]/n);
+            float rad=std::min(14.f, 5.f+2.5f*std::log2((float)n));
+            ImU32 col=pts[cell_first[c]].color & 0x00FFFFFFu;
+            dl->AddCircleFilled(cc, rad, col|0xB4000000u, 12);
+            dl->AddCircle(cc, rad, IM_COL32(255,255,255,160), 12, 1.0f);
+            snprintf(cnt,sizeof(cnt),"%d",n);
+            ImVec2 ts=ImGui::CalcTextSize(cnt);
+            if(ts.x<rad*2.4f) dl->AddText(ImVec2(cc.x-ts.x*0.5f, cc.y-ts.y*0.5f), IM_COL32(255,255,255,235), cnt);
+            if(hovered){ float dx=cc.x-mp.x, dy=cc.y-mp.y, d=dx*dx+dy*dy;
+                if(d<=(rad+2)*(rad+2) && d<clus_d){ clus_d=d; clus_hit=c; } }
+        }
+    }
     for(size_t i=0;i<pts.size();i++){
         const MapPoint& pt=pts[i];
         // 항적 꼬리 (oldest→newest, alpha ramp) — 선택 배 있으면 비선택 배 꼬리 숨김(그 배만 돋보이게)
-        if(v.show_trails && pt.trail && pt.trail_n>1 && (!any_sel || pt.selected)){
+        if(v.show_trails && pt.trail && pt.trail_n>1 && (clus ? pt.selected : (!any_sel || pt.selected))){
             ImU32 base = pt.color & 0x00FFFFFFu;
             ImVec2 tp = LL2PX(pt.trail[0], pt.trail[1]);
             if(pt.selected) dl->AddCircleFilled(tp, 1.25f, base|0xC0000000u, 8);  // GPS 기록점
@@ -266,8 +374,9 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
                 tp=tc;
             }
         }
-        ImVec2 s=LL2PX(pt.lat, pt.lon);
+        ImVec2 s=scr[i];
         if(s.x<p0.x||s.x>p1.x||s.y<p0.y||s.y>p1.y) continue;   // 화면밖 컬링
+        if(clus && cell_of[i]>=0 && cell_n[cell_of[i]]>1) continue;   // 클러스터 버블로 대체
         if(pt.heading>=0.f){
             float a=pt.heading*(float)M_PI/180.f;
             float ux=std::sin(a), uy=-std::cos(a);             // 전방 (북=위)
@@ -283,7 +392,7 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
             dl->AddCircleFilled(s, rad, pt.color, 10);
             if(pt.selected) dl->AddCircle(s, rad+2, IM_COL32(255,255,255,255), 12, 1.5f);
         }
-        if(v.show_labels && pt.label && (pt.selected || true))
+        if(v.show_labels && pt.label && (pt.selected || !clus))
             dl->AddText(ImVec2(s.x+8,s.y-6), pt.selected ? IM_COL32(255,240,200,255) : IM_COL32(200,220,255,180), pt.label);
         if(hovered){ float dx=s.x-mp.x, dy=s.y-mp.y, d=dx*dx+dy*dy; if(d<bestd){ bestd=d; best=(int)i; } }
     }
@@ -401,6 +510,22 @@ MapResult draw_map(const char* id, MapView& v, const std::vector<MapPoint>& pts,
 
     dl->PopClipRect();
 
+    // ── 클러스터 hover/클릭 → 개수 툴팁, 클릭 시 그 셀로 확대 (개별 마커 hover 우선) ──
+    if(clus_hit>=0 && !(best>=0 && bestd<=169.f)){
+        int n=cell_n[clus_hit];
+        ImGui::SetTooltip("%d targets - click to zoom", n);
+        ImVec2 dr=ImGui::GetMouseDragDelta(ImGuiMouseButton_Left);
+        if(!panned && ImGui::IsMouseReleased(ImGuiMouseButton_Left) && std::fabs(dr.x)+std::fabs(dr.y) < 4.f){
+            double cx=cell_x[clus_hit]/n, cy=cell_y[clus_hit]/n;
+            double clon=v.lon0+(cx-p0.x)/W*(v.lon1-v.lon0);
+            double clat=v.lat1-(cy-p0.y)/H*(v.lat1-v.lat0);
+            double hl=(v.lat1-v.lat0)*0.5*0.3, ho=(v.lon1-v.lon0)*0.5*0.3;
+            v.lat0=clat-hl; v.lat1=clat+hl; v.lon0=clon-ho; v.lon1=clon+ho;
+            normalize(v,W,H);
+            clamp_to_bbox(v,W,H);
+        }
+    }
+
     // ── hover 툴팁 + 클릭(드래그 아님) 선택 ──
     if(hovered && best>=0 && bestd<=169.f){
         const MapPoint& pt=pts[best];
@@ -32,12 +32,19 @@ struct MapView {
     bool   show_coast     = true;    // 해안선
     bool   show_trails    = true;    // 항적 꼬리
     bool   show_labels    = true;    // 마커 이름 라벨
+    bool   cluster        = true;    // 보이는 마커가 많으면 화면 격자 클러스터링 (개수 버블)
     bool   big            = false;   // 크게보기: 지도가 패널 전폭 차지 (호출자가 읽어 표 숨김). 좌상단 버튼으로 토글
 
     // 육지 채움 캐시 (해안선 닫힌 링 even-odd 화면-scanline; 카메라/크기 변경 시만 재계산) — 내부 전용
     double _fl_lat0=1, _fl_lat1=0, _fl_lon0=0, _fl_lon1=0;  // 마지막 계산 시점 카메라
     float  _fl_W=0, _fl_H=0;
-    std::vector<float> _fill;   // (dx0, yy, dx1) 막대, p0 상대 픽셀 (1px 높이)
+    std::vector<float> _fill;   // 사다리꼴 (y_top, x0_top, x1_top, y_bot, x0_bot, x1_bot), p0 상대 px
+    // 해안선 캐시 (줌별 LOD 레벨 + 라인 bbox 컬링 + 화면 투영; 카메라/크기 변경 시만 재계산)
+    double _cs_lat0=1, _cs_lat1=0, _cs_lon0=0, _cs_lon1=0;
+    float  _cs_W=0, _cs_H=0;
+    std::vector<ImVec2> _coast;    // 폴리라인 점 연속 저장, p0 상대 px
+    std::vector<int>    _coast_n;  // 폴리라인별 점 개수
+    int    _lod = 0;               // 마지막 사용 LOD 레벨 (0 = 원본)
 };
 
 // 수신소(기지) 마커 — 실제 복조한 기지 위치+이름 오버레이용.
@@ -0,0 +1,88 @@
+#pragma once
+// ── 해독 모듈 공용 작업 풀 (header-only) ───────────────────────────────────
+// 채널 워커가 무거운 디코드(비콘 스캔 / 광대역 채널 분리 / AMBE 음성)를 넘기는 스레드 풀.
+// 모듈당 전역 1개 (`WorkerPool<Job> g_pool{run_fn};`), 채널 워커 수명에 맞춰
+//   acquire() : 첫 사용자가 스레드 기동 (코어/4, 1..4) → 스레드 수 반환
+//   release() : 마지막 사용자가 종료 요청 + join (남은 job 은 모두 실행 후 종료)
+// 기동마다 세대(Gen)를 새로 만들어 stop 플래그를 세대별로 둔다 — release 가 lock 을 놓고
+// join 하는 동안 다른 워커가 acquire 해도 새 세대가 뜰 뿐, 이전 세대 stop 이 되돌려지지 않음.
+// Job 은 값 복사되는 작은 POD (포인터 몇 개) — job 마다 heap 할당 없음.
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace modpool {
+
+template<class Job>
+class WorkerPool {
+public:
+    using RunFn = void(*)(const Job&);
+    explicit WorkerPool(RunFn fn) : run_(fn) {}
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int acquire(){
+        std::lock_guard<std::mutex> lk(mtx_);
+        if(users_++ == 0){
+            gen_ = std::make_shared<Gen>();
+            int n = std::max(1, std::min(4, (int)std::thread::hardware_concurrency() / 4));
+            for(int i=0;i<n;i++) gen_->th.emplace_back(&WorkerPool::loop, this, gen_);
+        }
+        return (int)gen_->th.size();
+    }
+    void release(){
+        std::shared_ptr<Gen> g;
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if(users_ == 0 || --users_ > 0) return;
+            g.swap(gen_);
+            g->stop = true;
+        }
+        cv_.notify_all();
+        for(auto& t : g->th) t.join();        // lock 밖 — 동시 acquire 는 새 세대로
+    }
+
+    void submit(const Job& j){
+        { std::lock_guard<std::mutex> lk(mtx_); q_.push_back(j); }
+        cv_.notify_one();
+    }
+    // 여러 job 을 lock 1회로 (배치 barrier 용)
+    void submit(const Job* js, size_t n){
+        if(n == 0) return;
+        { std::lock_guard<std::mutex> lk(mtx_); q_.insert(q_.end(), js, js + n); }
+        cv_.notify_all();
+    }
+
+private:
+    struct Gen {
+        std::vector<std::thread> th;
+        bool stop = false;                    // mtx_ 보호
+    };
+
+    void loop(std::shared_ptr<Gen> g){
+        for(;;){
+            Job j;
+            {
+                std::unique_lock<std::mutex> lk(mtx_);
+                cv_.wait(lk, [&]{ return g->stop || !q_.empty(); });
+                // stop: 잔여가 없거나, 새 세대가 이어받았으면 종료
+                if(g->stop && (q_.empty() || gen_)) return;
+                j = q_.front(); q_.pop_front();
+            }
+            run_(j);
+        }
+    }
+
+    RunFn                   run_;
+    std::mutex              mtx_;
+    std::condition_variable cv_;
+    std::deque<Job>         q_;
+    std::shared_ptr<Gen>    gen_;             // 현재 세대 (users_ == 0 이면 null)
+    int                     users_ = 0;
+};
+
+} // namespace modpool
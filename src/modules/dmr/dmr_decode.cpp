@@ -1,18 +1,28 @@
-// ── DMR HOST 워커: IQ ring 독립 read-ptr 탭 → 채널 DDC → FM 판별기 → boxcar
+// ── DMR HOST 워커: IQ ring 독립 read-ptr 탭 → 채널 DDC → FM 판별기 → RRC(α=0.2)
 //    정합필터 → DmrDecoder(심볼동기/sync/Slot Type Golay/BPTC/CSBK·LC). AIS 와 동형.
 //    결과는 host_emit() → 로그+일단위 저장+전 JOIN 브로드캐스트.
+//    음성: 워커는 프레이밍까지만 — TDMA 슬롯별 AMBE 프레임을 공용 vocoder 풀로 넘기고
+//    (mbelib 합성 + 오디오 push + 통화 WAV 는 풀 스레드, WAV 는 AsyncIO::Writer).
 #include "fft_viewer.hpp"
 #include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include "dmr_module.hpp"
 #include "dmr_decode.hpp"
 #include "dmr_ambe.hpp"
 #include "bewe_paths.hpp"
+#include "async_writer.hpp"
+#include "../common/worker_pool.hpp"
 #include <cmath>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <thread>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <volk/volk.h>
 
 namespace dmr_mod {
 
@@ -21,6 +31,195 @@ static int64_t now_ms(){
         std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+namespace {
+
+// ── RRC 정합필터 (ETSI TS 102 361-1 §10.2: 송신 RRC α=0.2 → 수신도 RRC) ──────
+// boxcar 대비 저SNR 에서 심볼 ISI/잡음대역 ↓. ±4 심볼, 출력당 1회 VOLK 내적
+// (48 kHz × ~81 탭 — 채널 DDC 의 입력당 연산에 비하면 무시할 수준).
+struct RrcFir {
+    int T=1, pos=0;
+    std::vector<float> h, hist;            // hist = 2T (이중 기록 → 연속 창)
+    void init(double sps, double alpha=0.2, int span=4){
+        int half=std::max(1,(int)llround(span*sps));
+        T=2*half+1; h.assign(T,0.f); hist.assign(2*T,0.f); pos=0;
+        double sum=0;
+        for(int n=0;n<T;n++){
+            double t=(n-half)/sps, v;
+            if(std::fabs(t)<1e-9) v=1.0-alpha+4.0*alpha/M_PI;
+            else if(std::fabs(std::fabs(t)-1.0/(4.0*alpha))<1e-9)
+                v=alpha/std::sqrt(2.0)*((1+2/M_PI)*std::sin(M_PI/(4*alpha))+(1-2/M_PI)*std::cos(M_PI/(4*alpha)));
+            else v=(std::sin(M_PI*t*(1-alpha))+4*alpha*t*std::cos(M_PI*t*(1+alpha)))
+                  /(M_PI*t*(1-(4*alpha*t)*(4*alpha*t)));
+            h[n]=(float)v; sum+=v;
+        }
+        for(float& x : h) x=(float)(x/sum);  // DC 이득 1 (boxcar 평균과 같은 스케일)
+    }
+    void reset(){ std::fill(hist.begin(),hist.end(),0.f); pos=0; }
+    float p(float x){
+        hist[pos]=hist[pos+T]=x;
+        if(++pos>=T) pos=0;
+        float y; volk_32f_x2_dot_prod_32f(&y, hist.data()+pos, h.data(), (unsigned)T);   // 대칭 탭
+        return y;
+    }
+};
+
+// ── AMBE vocoder 풀 ───────────────────────────────────────────────────────
+// 채널×TDMA 슬롯마다 VoiceStream(예측기 상태 + 통화 WAV). 워커는 프레임을 큐에 넣고
+// 즉시 복귀, 스트림은 한 번에 한 풀 스레드만 drain (scheduled) → 프레임 순서 보장.
+// 채널 오디오 ring 은 단일 생산자라 슬롯 하나만 소유(audio_owner): 먼저 말한 슬롯이
+// 잡고, 통화 종료 또는 AUDIO_STALE_MS 무음이면 다른 슬롯에 넘김.
+constexpr size_t  VQ_MAX          = 64;    // 스트림당 대기 항목 (~3.8 s 음성) 초과 시 버림
+constexpr int64_t AUDIO_STALE_MS  = 500;
+
+struct VoiceItem {
+    uint8_t  fr[3*36];
+    int      nf = 0;
+    bool     new_call = false, close = false;
+    uint64_t rec_id = 0;
+    uint32_t src = 0, dst = 0;
+    int      slot = 0;
+};
+struct VoiceCtx;
+struct VoiceStream {
+    VoiceCtx* ctx = nullptr;
+    int       tslot = 0;
+    std::mutex mtx;                        // q / scheduled
+    std::deque<VoiceItem> q;
+    bool      scheduled = false;
+    // 아래는 drain 중인 풀 스레드 전용
+    dmr::DmrAmbeDecoder ambe;
+    AsyncIO::Writer wav;
+    uint64_t  rec_frames = 0;
+    float     a_prev = 0.f;
+};
+struct VoiceCtx {                          // 채널 워커 스택 소유, inflight==0 까지 유지
+    FFTViewer* v = nullptr;
+    Channel*   ch = nullptr;
+    int        ch_idx = 0, up = 1;
+    std::mutex audio_mtx;
+    int        audio_owner = -1;
+    int64_t    owner_t = 0;
+    std::vector<float> nbuf;
+    VoiceStream s[2];
+    std::atomic<int>  inflight{0};
+    std::atomic<long> dropped{0}, frames{0};
+};
+
+std::atomic<uint64_t>     g_last_rec_id{0};
+
+// 통화 WAV 키 = ms 타임스탬프 (두 슬롯 동시 시작에도 유일하게 +1)
+uint64_t next_rec_id(){
+    uint64_t t=(uint64_t)now_ms(), c=g_last_rec_id.load();
+    for(;;){
+        uint64_t id = t>c ? t : c+1;
+        if(g_last_rec_id.compare_exchange_weak(c, id)) return id;
+    }
+}
+
+void rec_close(VoiceStream& s){
+    if(!s.wav.is_open()) return;
+    uint8_t hdr[44];
+    Channel::wav_hdr_mono(hdr, 8000, s.rec_frames);
+    s.wav.flush();
+    s.wav.write(hdr, sizeof(hdr), 0);
+    s.wav.close();
+    s.rec_frames=0;
+}
+void rec_open(VoiceStream& s, const VoiceItem& it){
+    rec_close(s);
+    std::string dir = BEWEPaths::data_dir()+"/modules/dmr/rec";
+    mkdir((BEWEPaths::data_dir()+"/modules").c_str(),0755);
+    mkdir((BEWEPaths::data_dir()+"/modules/dmr").c_str(),0755);
+    mkdir(dir.c_str(),0755);
+    char fn[192]; snprintf(fn,sizeof(fn),"%s/dmr_%llu_%u_%u_%d.wav", dir.c_str(),
+        (unsigned long long)it.rec_id, it.src, it.dst, it.slot);
+    int fd=::open(fn,O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if(fd<0 || !s.wav.attach(fd,fn,true,1<<16,4)){
+        if(fd>=0) ::close(fd);
+        bewe_log_push(0,"DMR[%d] rec: cannot open %s\n", s.ctx->ch_idx, fn);
+        return;
+    }
+    s.wav.seek(44);                        // 헤더는 통화 종료 시 기록
+    s.rec_frames=0;
+}
+
+void end_call(VoiceStream& s){
+    rec_close(s);
+    s.ambe.reset(); s.a_prev=0.f;
+    VoiceCtx& c=*s.ctx;
+    std::lock_guard<std::mutex> lk(c.audio_mtx);
+    if(c.audio_owner==s.tslot) c.audio_owner=-1;
+}
+
+// 한 샘플 출력: 로컬 ring(L/R/pan 재생) + 네트워크(구독 operator) — dem_worker 와 동형.
+// audio_mtx 보유 상태에서 호출.
+void emit_audio(VoiceCtx& c, float out){
+    c.ch->push_audio(out);
+    if(c.v->net_srv && (c.ch->audio_mask.load() & ~0x1u)){
+        c.nbuf.push_back(out);
+        if(c.nbuf.size()>=256){ uint32_t mask=(c.ch->audio_mask.load()>>1);
+            c.v->net_srv->send_audio(mask,(uint8_t)c.ch_idx,(int8_t)c.ch->pan,c.nbuf.data(),(uint32_t)c.nbuf.size());
+            c.nbuf.clear(); }
+    }
+}
+
+void run_item(VoiceStream& s, const VoiceItem& it){
+    if(it.close){ end_call(s); return; }
+    if(it.new_call){ end_call(s); rec_open(s, it); }          // 새 통화 → 예측기 리셋 + 새 WAV
+    VoiceCtx& c=*s.ctx;
+    const float VOICE_GAIN = 2.2f;
+    for(int f=0; f<it.nf; f++){
+        short pcm[160]; s.ambe.decode(it.fr + f*36, pcm);
+        c.frames.fetch_add(1, std::memory_order_relaxed);
+        if(s.wav.is_open()){ s.wav.append(pcm, sizeof(pcm)); s.rec_frames+=160; }   // 8kHz mono int16
+        std::lock_guard<std::mutex> lk(c.audio_mtx);
+        int64_t t=now_ms();
+        if(c.audio_owner<0 || (c.audio_owner!=s.tslot && t-c.owner_t>AUDIO_STALE_MS)) c.audio_owner=s.tslot;
+        if(c.audio_owner!=s.tslot) continue;                 // 다른 슬롯이 재생 중 → 녹음만
+        c.owner_t=t;
+        for(int i=0;i<160;i++){
+            float x = pcm[i] * (VOICE_GAIN/32768.f);
+            if(x>1.f)x=1.f; else if(x<-1.f)x=-1.f;
+            for(int j=1;j<=c.up;j++){ float al=(float)j/c.up;  // 선형보간 업샘플 8k→out_sr
+                emit_audio(c, s.a_prev + (x-s.a_prev)*al); }
+            s.a_prev = x;
+        }
+    }
+}
+
+void drain(VoiceStream& s){
+    for(;;){
+        VoiceItem it;
+        {
+            std::lock_guard<std::mutex> lk(s.mtx);
+            if(s.q.empty()){ s.scheduled=false; break; }
+            it=s.q.front(); s.q.pop_front();
+        }
+        run_item(s, it);
+    }
+    s.ctx->inflight.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void run_job(VoiceStream* const& s){ drain(*s); }
+
+modpool::WorkerPool<VoiceStream*> g_pool{run_job};
+
+// 워커 → 스트림 큐. close 는 버리지 않음 (통화 WAV 마감 보장).
+void post(VoiceStream& s, const VoiceItem& it){
+    bool sched=false;
+    {
+        std::lock_guard<std::mutex> lk(s.mtx);
+        if(!it.close && s.q.size()>=VQ_MAX){ s.ctx->dropped.fetch_add(1, std::memory_order_relaxed); return; }
+        s.q.push_back(it);
+        if(!s.scheduled){ s.scheduled=true; sched=true; }
+    }
+    if(!sched) return;
+    s.ctx->inflight.fetch_add(1, std::memory_order_acq_rel);
+    g_pool.submit(&s);
+}
+
+} // namespace
+
 void worker(FFTViewer& v, int ch_idx){
     Channel& ch = v.channels[ch_idx];
     uint32_t msr = v.header.sample_rate;
@@ -41,15 +240,19 @@ void worker(FFTViewer& v, int ch_idx){
       for(int k=0;k<4;k++){ lpi[k].set(cn); lpq[k].set(cn); } }
     double dec_i=0, dec_q=0; uint32_t dec_cnt=0;
 
-    // FM 판별기 상태 + boxcar 정합필터 (1심볼 = round(out_sr/4800) 샘플)
+    // FM 판별기 상태 + RRC 정합필터
     float prev_i=0, prev_q=0;
-    int   W = std::max(1, (int)llround((double)out_sr/4800.0));
-    std::vector<float> box(W,0.f); int box_pos=0; double box_sum=0;
+    RrcFir rrc; rrc.init((double)out_sr/4800.0);
 
     DmrDecoder dec; dec.configure((double)out_sr);
     long frames=0;
-    // ── 통화별 음성 녹음 (8kHz mono int16 WAV; rec_id = 파일명 키 = 음성레코드에 부착) ──
-    FILE*    rec_fp=nullptr; uint64_t rec_frames=0, cur_rec_id=0;
+    // ── 음성: 슬롯별 스트림 → 공용 AMBE 풀 (통화별 8kHz mono int16 WAV; rec_id = 파일명 키) ──
+    VoiceCtx vctx; vctx.v=&v; vctx.ch=&ch; vctx.ch_idx=ch_idx;
+    vctx.up = std::max(1, (int)llround((double)out_sr/8000.0));        // 8k→out_sr 정수배
+    for(int k=0;k<2;k++){ vctx.s[k].ctx=&vctx; vctx.s[k].tslot=k; }
+    g_pool.acquire();
+
+    uint64_t rec_ids[2]={0,0}, cur_rec_id=0;
     uint32_t pend_src=0, pend_dst=0; int pend_slot=0;
     dec.on_record = [&](const DmrRecord& r){
         frames++; DmrRecord m=r; m.ch=ch_idx;
@@ -57,68 +260,39 @@ void worker(FFTViewer& v, int ch_idx){
             if(m.src_id) pend_src=m.src_id;
             if(m.dst_id) pend_dst=m.dst_id;
             if(m.slot>0) pend_slot=m.slot;
-            m.rec_id = cur_rec_id;                        // rec_open 전이면 0
+            m.rec_id = cur_rec_id;                        // 첫 음성버스트 전이면 0
         }
         host_emit(v, m);
     };
-
-    // ── 음성: AMBE(mbelib) → PCM → 8k→out_sr 리샘플 → 채널 오디오 ring ──
-    // 음성 디코드 동안만 push → 음성 없으면 무음(스컬치). FM 오디오는 ext_audio 로 억제.
-    dmr::DmrAmbeDecoder ambe;
-    const float VOICE_GAIN = 2.2f;
-    const int up = std::max(1, (int)llround((double)out_sr/8000.0));   // 8k→out_sr 정수배
-    float a_prev = 0.f;
-    std::vector<float> nbuf; nbuf.reserve(256);
-    // 한 샘플 출력: 로컬 ring(L/R/pan 재생) + 네트워크(구독 operator) — dem_worker 와 동형
-    auto emit_audio = [&](float out){
-        ch.push_audio(out);
-        if(v.net_srv && (ch.audio_mask.load() & ~0x1u)){
-            nbuf.push_back(out);
-            if(nbuf.size()>=256){ uint32_t mask=(ch.audio_mask.load()>>1);
-                v.net_srv->send_audio(mask,(uint8_t)ch_idx,(int8_t)ch.pan,nbuf.data(),(uint32_t)nbuf.size());
-                nbuf.clear(); }
+    dec.on_voice = [&](const uint8_t* fr, int nf, bool nc, int tslot){
+        VoiceItem it;
+        it.nf = std::min(nf, 3);
+        memcpy(it.fr, fr, (size_t)it.nf*36);
+        if(nc){                                           // 새 통화 → 새 WAV 키
+            rec_ids[tslot]=next_rec_id();
+            it.new_call=true; it.rec_id=rec_ids[tslot];
+            it.src=pend_src; it.dst=pend_dst; it.slot=pend_slot;
         }
+        cur_rec_id = rec_ids[tslot];
+        post(vctx.s[tslot], it);
     };
-    // 녹음 종료(헤더 frames 갱신 후 닫기) / 시작(통화별 새 WAV)
-    auto rec_close = [&](){
-        if(rec_fp){ fseek(rec_fp,0,SEEK_SET); ch.audio_rec_write_wav_hdr(rec_fp,8000,rec_frames); fclose(rec_fp); rec_fp=nullptr; }
-        rec_frames=0; cur_rec_id=0;
-    };
-    auto rec_open = [&](){
-        rec_close();
-        std::string dir = BEWEPaths::data_dir()+"/modules/dmr/rec";
-        mkdir((BEWEPaths::data_dir()+"/modules").c_str(),0755);
-        mkdir((BEWEPaths::data_dir()+"/modules/dmr").c_str(),0755);
-        mkdir(dir.c_str(),0755);
-        cur_rec_id=(uint64_t)now_ms();
-        char fn[192]; snprintf(fn,sizeof(fn),"%s/dmr_%llu_%u_%u_%d.wav", dir.c_str(),
-            (unsigned long long)cur_rec_id, pend_src, pend_dst, pend_slot);
-        rec_fp=fopen(fn,"wb"); rec_frames=0;
-        if(rec_fp) ch.audio_rec_write_wav_hdr(rec_fp,8000,0);   // 자리표시 헤더
-    };
-    dec.on_voice = [&](const uint8_t* fr, int nf, bool nc){
-        if(nc){ ambe.reset(); rec_open(); }                    // 새 통화 → 새 WAV
-        for(int f=0; f<nf; f++){
-            short pcm[160]; ambe.decode(fr + f*36, pcm);
-            if(rec_fp){ fwrite(pcm,sizeof(short),160,rec_fp); rec_frames+=160; }   // 8kHz mono int16 녹음
-            for(int i=0;i<160;i++){
-                float s = pcm[i] * (VOICE_GAIN/32768.f);
-                if(s>1.f)s=1.f; else if(s<-1.f)s=-1.f;
-                for(int j=1;j<=up;j++){ float al=(float)j/up;     // 선형보간 업샘플
-                    emit_audio(a_prev + (s-a_prev)*al); }
-                a_prev = s;
-            }
-        }
+    // 통화 끝 (스컬치 닫힘 / Holding / 종료): 예약 음성 폐기 + 두 슬롯 WAV 마감
+    auto end_calls = [&](){
+        dec.clear_voice();
+        VoiceItem c; c.close=true;
+        post(vctx.s[0], c); post(vctx.s[1], c);
+        rec_ids[0]=rec_ids[1]=0; cur_rec_id=0;
     };
     ch.ext_audio.store(true, std::memory_order_relaxed);   // DMR 이 채널 오디오 소유
 
-    bewe_log_push(0,"DMR[%d] start: %.4f MHz  BW=%.1f kHz  decim=%u out=%u Hz (%.2f sps)\n",
-        ch_idx,(ch.s+ch.e)/2.0f, bw_hz/1000.f, decim, out_sr, (double)out_sr/4800.0);
+    bewe_log_push(0,"DMR[%d] start: %.4f MHz  BW=%.1f kHz  decim=%u out=%u Hz (%.2f sps)  RRC %d taps\n",
+        ch_idx,(ch.s+ch.e)/2.0f, bw_hz/1000.f, decim, out_sr, (double)out_sr/4800.0, rrc.T);
 
     const size_t MAX_LAG=(size_t)(msr*0.08);
     const size_t BATCH  =std::max<size_t>(4096, msr/50);
     std::atomic<size_t>& my_rp = worker_rp(ch_idx);
     my_rp.store(v.ring_wp.load());
+    PipeStats::ReaderScope rs_(my_rp, "dmr", ch_idx);
     int64_t last_diag=now_ms();
     bool gate_prev=false;   // 스컬치 게이트 이전상태 (AM/FM 과 동일 sq_gate 사용)
     bool hold_prev=false;   // Holding 이전상태 (전환 edge 에서만 runtime freeze/resume)
@@ -130,7 +304,7 @@ void worker(FFTViewer& v, int ch_idx){
         if(hold != hold_prev){ bewe_mod_host_ch_hold(ch_idx, hold); hold_prev=hold; }
         if(hold){
             my_rp.store(v.ring_wp.load(std::memory_order_acquire), std::memory_order_release);
-            if(gate_prev){ dec.clear_voice(); ambe.reset(); a_prev=0.f; rec_close(); gate_prev=false; }
+            if(gate_prev){ end_calls(); gate_prev=false; }
             dec.reset();
             std::this_thread::sleep_for(std::chrono::milliseconds(20));
             continue;
@@ -149,7 +323,7 @@ void worker(FFTViewer& v, int ch_idx){
             rp=(wp-keep)&IQ_RING_MASK; my_rp.store(rp,std::memory_order_release);
             for(int k=0;k<4;k++){ lpi[k].s=lpq[k].s=0; }
             dec_i=dec_q=0; dec_cnt=0; prev_i=prev_q=0;
-            std::fill(box.begin(),box.end(),0.f); box_sum=0; box_pos=0;
+            rrc.reset();
             dec.reset();
             lag=(wp-rp)&IQ_RING_MASK;
         }
@@ -159,10 +333,11 @@ void worker(FFTViewer& v, int ch_idx){
         //    닫힘 = 신호 없음 → 복조기에 노이즈 안 넣음(가짜 voice-sync 방지).
         //    닫힘 edge 에서 예약 음성(B–F) 폐기 + AMBE 리셋 → 잔향/클릭 차단.
         bool gate = ch.sq_gate.load(std::memory_order_relaxed);
-        if(gate_prev && !gate){ dec.clear_voice(); ambe.reset(); a_prev=0.f; rec_close(); }  // 통화 끝 → WAV 닫기
+        if(gate_prev && !gate) end_calls();                 // 통화 끝 → WAV 닫기
         gate_prev = gate;
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("mod", "dmr_batch", avail);
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
             float si=v.ring[pos*2]*inv_scale, sq=v.ring[pos*2+1]*inv_scale;
@@ -174,22 +349,25 @@ void worker(FFTViewer& v, int ch_idx){
             float oi=(float)(dec_i/dec_cnt), oq=(float)(dec_q/dec_cnt);
             dec_i=dec_q=0; dec_cnt=0;
 
-            // FM 판별 (순시주파수) → boxcar 정합필터(이동평균) → 디코더
+            // FM 판별 (순시주파수) → RRC 정합필터 → 디코더
             float dft = atan2f(oq*prev_i - oi*prev_q, oi*prev_i + oq*prev_q + 1e-20f);
             prev_i=oi; prev_q=oq;
-            box_sum += dft - box[box_pos]; box[box_pos]=dft;
-            if(++box_pos>=W) box_pos=0;
-            if(gate) dec.feed((float)(box_sum/W));   // 스컬치 열림 구간만 복조
+            float mf = rrc.p(dft);
+            if(gate) dec.feed(mf);                          // 스컬치 열림 구간만 복조
         }
         my_rp.store((rp+avail)&IQ_RING_MASK,std::memory_order_release);
 
         int64_t t=now_ms();
         if(t-last_diag>=10000){
-            bewe_log_push(0,"DMR[%d] diag: records=%ld\n", ch_idx, frames);
+            bewe_log_push(0,"DMR[%d] diag: records=%ld ambe=%ld dropped=%ld\n", ch_idx, frames,
+                vctx.frames.load(), vctx.dropped.load());
             last_diag=t;
         }
     }
-    rec_close();                                            // 종료 시 녹음 마무리
+    end_calls();                                            // 종료 시 녹음 마무리
+    while(vctx.inflight.load(std::memory_order_acquire) > 0)   // 스트림/ctx 는 이 스택 소유
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    g_pool.release();
     ch.ext_audio.store(false, std::memory_order_relaxed);   // FM 오디오 복귀
     if(!worker_stop_req(ch_idx)) worker_natural_exit(v, ch_idx);
     bewe_log_push(0,"DMR[%d] stop\n",ch_idx);
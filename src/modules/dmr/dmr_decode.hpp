@@ -1,6 +1,6 @@
 #pragma once
 // ── DMR 스트리밍 디코더 (ETSI TS 102 361-1, Tier II 메타/시그널링) ───────────
-// 입력 = 정합필터(boxcar I&D) 적용된 FM 판별기 샘플 1개씩(feed). DDC/판별기/정합
+// 입력 = 정합필터(RRC α=0.2) 적용된 FM 판별기 샘플 1개씩(feed). DDC/판별기/정합
 // 필터는 워커(dmr_decode.cpp). 내부: 심볼 strobe(sync 탐지) → 버스트별 sample-space
 // 정밀추출(위상+국소omega 보정) → Slot Type Golay / BPTC(196,96) → LC/CSBK → on_record.
 // 오프라인 하니스(tools/dmr_offline.cpp)에서 실신호 CRC 검증된 로직을 스트리밍화.
@@ -17,15 +17,16 @@ class DmrDecoder {
 public:
     std::function<void(const DmrRecord&)> on_record;
     // 음성버스트 → AMBE 프레임 dibit 방출 (frames = nframes*36 dibit; new_call=새 통화).
+    // tslot = TDMA 슬롯 0/1 (direct 는 sync 로 절대값, repeater 는 버스트 간격 패리티로 상대값).
     // mbelib 비의존 — 소비자(워커/하니스)가 dmr_ambe.hpp 로 디코드.
-    std::function<void(const uint8_t* frames, int nframes, bool new_call)> on_voice;
+    std::function<void(const uint8_t* frames, int nframes, bool new_call, int tslot)> on_voice;
 
     long dbgDet=0, dbgExtract=0, dbgVoice=0, dbgData=0;   // 진단 카운터
     void configure(double out_sr){ omega_ = omegaNom_ = out_sr/4800.0; reset(); buildPats(); }
     void reset(){
         buf_.clear(); base_=0; strobe_=0; inited_=false;
         symv_.clear(); syms_.clear(); pend_.clear();
-        lastSyncSmp_=-1e18; lastVoiceSmp_=-1e18;
+        lastSyncSmp_=-1e18; lastVoiceSmp_[0]=lastVoiceSmp_[1]=-1e18; tdmaS0_=-1e18; tdmaSlot_=0; clkS0_=-1e18;
         polVote_[0]=polVote_[1]=0; polLock_=-1;
         voicePend_.clear();
         curSrc_=curDst_=0; curSlot_=0; curCC_=curFlco_=curCall_=-1; lastVoiceEmit_=-1e18;
@@ -33,7 +34,7 @@ public:
     }
     // 스컬치 닫힘 시: 예약된 음성 슈퍼프레임(B–F) 폐기 → 잔향 음성 차단.
     //   polLock_/omega_ 는 유지(동일 RF 경로 재키업 시 빠른 재획득).
-    void clear_voice(){ voicePend_.clear(); lastVoiceSmp_=-1e18; curDst_=0; curEnc_=pendingEnc_=false; }   // 콜 종료
+    void clear_voice(){ voicePend_.clear(); lastVoiceSmp_[0]=lastVoiceSmp_[1]=-1e18; curDst_=0; curEnc_=pendingEnc_=false; }   // 콜 종료
 
     void feed(float s){
         buf_.push_back(s);
@@ -76,7 +77,9 @@ public:
     }
 
 private:
-    double omega_=10.0, omegaNom_=10.0, strobe_=0, lastSyncSmp_=-1e18, lastVoiceSmp_=-1e18;
+    double omega_=10.0, omegaNom_=10.0, strobe_=0, lastSyncSmp_=-1e18, lastVoiceSmp_[2]={-1e18,-1e18};
+    double tdmaS0_=-1e18; int tdmaSlot_=0;     // 직전 버스트 위치/슬롯 (TDMA 패리티 체인)
+    double clkS0_=-1e18;                       // 직전 확신 버스트 위치 (omega 트래킹)
     int polVote_[2]={0,0}, polLock_=-1;
     uint64_t base_=0; bool inited_=false;
     // 현재 음성통화 컨텍스트 (직전 Voice LC Hdr 에서 물려받아 음성버스트 활동레코드에 부착)
@@ -89,7 +92,7 @@ private:
     static constexpr double VBURST = 288.0;   // 음성버스트 간격(심볼) = 60ms × 4800
     // 음성 슈퍼프레임 B–F 예약: voice-A 만 트리거(데이터버스트는 안 함 → 과추출 없음).
     // A 의 sync-보정 레벨/극성을 B–F 에 물려줌(B–F 는 EMB 라 sync 없음).
-    struct VPend{ double s0,sdc,slvl,ol; int pol; };
+    struct VPend{ double s0,sdc,slvl,ol; int pol, tslot; };
     std::deque<VPend> voicePend_;
 
     // sync 부호열 (모든 sync = ±3 → 부호상관, AGC-독립)
@@ -110,6 +113,16 @@ private:
         }
         return best;
     }
+    // 버스트 → TDMA 슬롯. 슬롯 간격 30ms = 144 심볼 → 직전 버스트와의 거리 패리티로 이어감.
+    // direct(sync 가 슬롯 명시)면 그 값으로 재정렬. 공백 10s 초과면 체인 끊고 0 부터.
+    int tdma_slot(double S0, double ol, int direct){
+        int sl;
+        if(direct>0) sl=direct-1;
+        else if(S0-tdmaS0_ < 10.0*4800.0*ol) sl=(int)((tdmaSlot_ + llround((S0-tdmaS0_)/(144.0*ol))) & 1);
+        else sl=0;
+        tdmaS0_=S0; tdmaSlot_=sl;
+        return sl;
+    }
     float interpAbs(double p){
         long i=(long)floor(p) - (long)base_; double f=p-floor(p);
         if(i<0 || i+1>=(long)buf_.size()) return 0.f;
@@ -118,14 +131,14 @@ private:
 
     // 버스트 추출: approxS0 = sync 심볼0(=버스트-sym 54) 근사 샘플위치
     void extractBurst(double approxS0){ dbgExtract++;
-        // 2D 타이밍: 위상 dl × 국소 omega ol, burst-sym 0..131 Σ|d| 최대
+        // 타이밍: strobe omega 고정, 위상 dl 만 탐색 (burst-sym 0..131 Σ|d| 최대).
+        // (위상 × 국소 omega 2D 탐색은 랜덤 데이터서 omega 가 ±1% 튀어 버스트 끝이 어긋남)
         double S0=approxS0, ol=omega_, bsc=-1;
-        for(double col=omega_-0.10; col<=omega_+0.10+1e-9; col+=0.01)
-          for(double dl=-omega_*0.6; dl<=omega_*0.6+1e-9; dl+=0.3){
+        for(double dl=-omega_*0.6; dl<=omega_*0.6+1e-9; dl+=0.2){
             double base=approxS0+dl, sc=0;
-            for(int b=0;b<132;b+=2) sc+=fabs(interpAbs(base+(b-54)*col));
-            if(sc>bsc){ bsc=sc; S0=base; ol=col; }
-          }
+            for(int b=0;b<132;b++) sc+=fabs(interpAbs(base+(b-54)*ol));
+            if(sc>bsc){ bsc=sc; S0=base; }
+        }
         // 국소 dc/outer (sync 24심볼 = 전부 ±3)
         double sdc=0; for(int k=0;k<dmr::SYNC_SYMS;k++) sdc+=interpAbs(S0+k*ol); sdc/=dmr::SYNC_SYMS;
         double slvl=0; for(int k=0;k<dmr::SYNC_SYMS;k++) slvl+=fabs(interpAbs(S0+k*ol)-sdc); slvl/=dmr::SYNC_SYMS;
@@ -165,17 +178,26 @@ private:
             got=(got<<1)|((vv-sdc<0)?1u:0u); }
           syncErr=99; for(int p=0;p<dmr::N_SYNC;p++){ int e=__builtin_popcount(got^patHi[p]);
             if(e<syncErr){syncErr=e;stype=dmr::SYNC_PATTERNS[p].type;} } }
-        // 심볼클럭 트래킹: 확신 버스트의 국소 omega 로 strobe omega 보정.
+        // 심볼클럭 트래킹: 버스트는 30ms(=144 심볼) TDMA 격자 위 → 직전 확신 버스트와의
+        // 거리 / (144·n) 이 omega. 0.3% 넘게 벗어나면 다른 송신기 → 무시.
         // (파일 SR 반올림/TX ppm → strobe 드리프트 → sync 놓침 방지)
-        if(syncErr<=2){ omega_ += 0.1*(ol-omega_);
-            if(omega_<omegaNom_-0.3) omega_=omegaNom_-0.3;
-            if(omega_>omegaNom_+0.3) omega_=omegaNom_+0.3; }
+        if(syncErr<=2){
+            double d=S0-clkS0_, n=floor(d/(144.0*omega_)+0.5);
+            double om=(n>=1 && n<=50)?d/(144.0*n):0;
+            if(fabs(om-omega_)<0.003*omegaNom_){
+                omega_ += 0.2*(om-omega_);
+                if(omega_<omegaNom_-0.3) omega_=omegaNom_-0.3;
+                if(omega_>omegaNom_+0.3) omega_=omegaNom_+0.3;
+            }
+            clkS0_=S0;
+        }
         // sign-corr(≥22)가 이미 진짜 sync 검증 → 약한신호로 magnitude syncErr 높아도
         // voice/data 판별은 Slot Type Golay 성공여부로 (robust). syncErr 게이트 폐기.
 
         DmrRecord m{};
         m.slot = dmr::sync_direct_slot(stype);      // direct 만; repeater=0(CACH 미구현)
         bool voiceSync = dmr::sync_is_voice(stype); // 부호기반 타입 → voice/data 분류
+        int  tslot = tdma_slot(S0, ol, m.slot);
 
         // Slot Type: burst-sym 49..53 + 78..82 → Golay(20,8). 성공 = DATA, 실패 = VOICE.
         uint8_t ab[10],bb[10]; bitsAt(49,5,pol,ab); bitsAt(78,5,pol,bb);
@@ -211,14 +233,14 @@ private:
         } else if(voiceSync && on_voice){ dbgVoice++;  // ── VOICE 버스트 (voice-sync) → 3 AMBE ──
             // 음성버스트는 60ms(=288심볼)마다 sync 보유 → omega 트래킹으로 전부 검출.
             // 프레임0=sym0..35, 프레임1=36..53++78..95(SYNC 건너뜀), 프레임2=96..131.
-            bool new_call = (S0 - lastVoiceSmp_) > 4.0*VBURST*ol;
+            bool new_call = (S0 - lastVoiceSmp_[tslot]) > 4.0*VBURST*ol;
             uint8_t fr[3*36];
             for(int k=0;k<36;k++) fr[k]       = (uint8_t)dibitAt(k,pol);
             for(int k=0;k<18;k++) fr[36+k]    = (uint8_t)dibitAt(36+k,pol);
             for(int k=0;k<18;k++) fr[36+18+k] = (uint8_t)dibitAt(78+k,pol);
             for(int k=0;k<36;k++) fr[72+k]    = (uint8_t)dibitAt(96+k,pol);
-            on_voice(fr, 3, new_call);
-            lastVoiceSmp_ = S0;
+            on_voice(fr, 3, new_call, tslot);
+            lastVoiceSmp_[tslot] = S0;
             // ── 음성 활동을 메타에 흘림 (스로틀 ~360ms; src/dst 는 직전 Voice LC Hdr 에서 물려받음).
             //    이게 있어야 세션이 콜 전체 span → Dur/빈도 실측 (헤더만으론 Dur=0). ──
             if(on_record && curDst_ && (new_call || S0 - lastVoiceEmit_ > 6.0*VBURST*ol)){
@@ -229,7 +251,13 @@ private:
                 on_record(vm); lastVoiceEmit_=S0;
             }
             // 슈퍼프레임 B–F 예약 (A 의 레벨/극성 물려줌; B–F 는 EMB 라 sync 없음)
-            for(int n=1;n<=5;n++) voicePend_.push_back({S0+n*VBURST*ol, sdc, slvl, ol, pol});
+            // 두 슬롯 예약이 섞이므로 s0 순 정렬 삽입 (front 만 검사하는 소비 루프 전제).
+            for(int n=1;n<=5;n++){
+                VPend vp{S0+n*VBURST*ol, sdc, slvl, ol, pol, tslot};
+                auto it=std::upper_bound(voicePend_.begin(), voicePend_.end(), vp.s0,
+                                         [](double x, const VPend& e){ return x < e.s0; });
+                voicePend_.insert(it, vp);
+            }
         }
     }
 
@@ -244,7 +272,7 @@ private:
         }
         double sdc=vp.sdc, slvl=vp.slvl, ol=vp.ol; int pol=vp.pol;
         if(slvl<1e-4 || !on_voice) return;
-        lastVoiceSmp_ = S0;        // B–F 도 갱신 → A 의 new_call 오판(360ms 공백) 방지
+        lastVoiceSmp_[vp.tslot] = S0;   // B–F 도 갱신 → A 의 new_call 오판(360ms 공백) 방지
         auto dibitAt=[&](double bsym)->int{
             double v=interpAbs(S0+(bsym-54.0)*ol); v=pol?(2*sdc-v):v;
             int sym=(v>=sdc+2*slvl/3)?3:(v>=sdc)?1:(v>=sdc-2*slvl/3)?-1:-3;
@@ -255,6 +283,6 @@ private:
         for(int k=0;k<18;k++) fr[36+k]    = (uint8_t)dibitAt(36+k);
         for(int k=0;k<18;k++) fr[36+18+k] = (uint8_t)dibitAt(78+k);
         for(int k=0;k<36;k++) fr[72+k]    = (uint8_t)dibitAt(96+k);
-        on_voice(fr, 3, false);
+        on_voice(fr, 3, false, vp.tslot);
     }
 };
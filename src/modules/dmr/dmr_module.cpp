@@ -185,6 +185,7 @@ void host_emit(FFTViewer& v, DmrRecord m){
     store_append(m);
     DmrWireMsg w; dmr_msg_to_wire(m, w);
     bewe_mod_emit(v, "dmr", &w, sizeof(w));
+    bewe_mod_tm_pin(v, "dmr", m.ch);
 }
 
 // ── framework 데이터 수신 (라이브 + 히스토리 공용) ──────────────────────────
@@ -5,8 +5,11 @@
 #include "wifi_module.hpp"
 #include "wifi_decode.hpp"
 #include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include "wifi_ofdm.hpp"
 #include "wifi_dsss.hpp"
+#include "../common/worker_pool.hpp"
 #include <functional>
 #include <complex>
 #include <unordered_map>
@@ -16,7 +19,7 @@
 #include <cmath>
 #include <algorithm>
 #include <chrono>
-#include <thread>
+#include <mutex>
 #include <cstdio>
 #include <ctime>
 #include <sys/stat.h>
@@ -28,6 +31,59 @@ static int64_t now_ms(){
         std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
+// ── 비콘 스캔 offload ────────────────────────────────────────────────────
+// 채널 워커는 DDC 출력을 고정 슬롯 ring(SCAN_SLOTS 개, 각 ~out_sr/8 + overlap)에 채우고
+// 가득 찬 슬롯을 공용 풀에 넘긴 뒤 바로 다음 슬롯으로 진행 → 바쁜 채널의 OFDM/DSSS
+// 디코드가 DDC 루프(ring lag 한도)를 막지 않음. 풀이 밀려 다음 슬롯이 아직 사용 중이면
+// 그 스캔 창은 버린다 (DDC 는 절대 대기하지 않음).
+namespace {
+
+constexpr int    SCAN_SLOTS = 4;
+constexpr size_t SCAN_KEEP  = 4096;      // 슬롯 간 overlap (패킷 경계)
+
+struct ScanSlot {
+    std::vector<std::complex<float>> x;
+    std::atomic<bool> busy{false};
+};
+struct ScanCtx {                         // 채널 워커 스택 소유, inflight==0 까지 유지
+    FFTViewer* v = nullptr;
+    int        ch = 0;
+    double     sr = 0;
+    std::mutex seen_mtx;
+    std::unordered_map<std::string,int64_t> seen;   // BSSID → 마지막 emit (dedup, 10s)
+    std::atomic<int> inflight{0};
+};
+struct ScanJob { ScanCtx* ctx; ScanSlot* slot; };
+
+void run_job(const ScanJob& j){
+    ScanCtx* c = j.ctx;
+    int64_t tn = now_ms();
+    auto emit = [c, tn](const WifiRecord& br){
+        {
+            std::lock_guard<std::mutex> lk(c->seen_mtx);
+            auto it = c->seen.find(br.bssid);
+            if(it != c->seen.end() && tn - it->second < 10000) return;   // 10s dedup per BSSID
+            c->seen[br.bssid] = tn;
+        }
+        WifiRecord m = br; m.ch = c->ch; host_emit(*c->v, m);
+    };
+    const auto& x = j.slot->x;
+    wifi_ofdm::decode_buffer(x.data(), x.size(), c->sr, emit);
+    wifi_dsss::decode_buffer_dsss(x.data(), x.size(), c->sr, emit);
+    j.slot->busy.store(false, std::memory_order_release);
+    c->inflight.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+modpool::WorkerPool<ScanJob> g_pool{run_job};
+
+void pool_submit(ScanCtx* c, ScanSlot* s){
+    s->busy.store(true, std::memory_order_relaxed);
+    c->inflight.fetch_add(1, std::memory_order_acq_rel);
+    g_pool.submit(ScanJob{c, s});
+}
+
+} // namespace
+
 void worker(FFTViewer& v, int ch_idx){
     Channel& ch = v.channels[ch_idx];
     uint32_t msr = v.header.sample_rate;                 // 스테이션(광대역) SR
@@ -72,11 +128,17 @@ void worker(FFTViewer& v, int ch_idx){
     const size_t BATCH   = std::max<size_t>(4096, msr/50);
     std::atomic<size_t>& my_rp = worker_rp(ch_idx);
     my_rp.store(v.ring_wp.load());
+    PipeStats::ReaderScope rs_(my_rp, "wifi", ch_idx);
     int64_t last_emit = now_ms();
     std::vector<float> dbuf; dbuf.reserve(BATCH*2/std::max(1u,decim)+4);
-    // OFDM 비콘 디코드용 누적 버퍼 (채널 baseband, ~0.12s 마다 스캔)
-    std::vector<std::complex<float>> wbuf; size_t wcap=(size_t)(out_sr/8); wbuf.reserve(wcap+4096);
-    std::unordered_map<std::string,int64_t> seen;   // BSSID → 마지막 emit (dedup, 10s)
+    // 비콘 스캔 슬롯 ring (채널 baseband, ~0.12s 창 → 풀에서 OFDM/DSSS 디코드)
+    size_t wcap=(size_t)(out_sr/8);
+    ScanSlot slots[SCAN_SLOTS];
+    for(auto& sl : slots) sl.x.reserve(wcap+SCAN_KEEP);
+    int cur=0; auto* wbuf=&slots[0].x;
+    ScanCtx sctx; sctx.v=&v; sctx.ch=ch_idx; sctx.sr=(double)out_sr;
+    uint64_t scan_drop=0;
+    g_pool.acquire();
 
     bool hold_prev=false;
     while(!worker_stop_req(ch_idx) && !v.sdr_stream_error.load() && ch.filter_active){
@@ -86,7 +148,7 @@ void worker(FFTViewer& v, int ch_idx){
         if(hold!=hold_prev){
             bewe_mod_host_ch_hold(ch_idx, hold);
             if(hold){ for(int k=0;k<3;k++){ lpi[k].s=lpq[k].s=0; } dec_i=dec_q=0; dec_cnt=0;
-                      wbuf.clear(); dec.reset(out_sr); }
+                      wbuf->clear(); dec.reset(out_sr); }
             hold_prev=hold;
         }
         if(hold){
@@ -113,6 +175,7 @@ void worker(FFTViewer& v, int ch_idx){
         if(lag==0){ std::this_thread::sleep_for(std::chrono::microseconds(1000)); continue; }
 
         size_t avail=std::min(lag,BATCH);
+        BEWE_TRACE_SCOPE_ARG("mod", "wifi_batch", avail);
         dbuf.clear();
         for(size_t s=0;s<avail;s++){
             size_t pos=(rp+s)&IQ_RING_MASK;
@@ -125,7 +188,7 @@ void worker(FFTViewer& v, int ch_idx){
             float oi=(float)(dec_i/dec_cnt), oq=(float)(dec_q/dec_cnt);
             dec_i=dec_q=0; dec_cnt=0;
             dec.feed(oi,oq);                              // 진단 측정
-            wbuf.push_back(std::complex<float>(oi,oq));   // OFDM 디코드 누적
+            wbuf->push_back(std::complex<float>(oi,oq));  // 비콘 스캔 슬롯 누적
             if(dump && dump_n<dump_cap){ dbuf.push_back(oi); dbuf.push_back(oq); dump_n++; }
         }
         if(dump && !dbuf.empty()) fwrite(dbuf.data(),sizeof(float),dbuf.size(),dump);
@@ -133,32 +196,41 @@ void worker(FFTViewer& v, int ch_idx){
             bewe_log_push(0,"WiFi[%d] IQ dump done: %s (%llu samples)\n",ch_idx,fn,(unsigned long long)dump_cap); }
         my_rp.store((rp+avail)&IQ_RING_MASK,std::memory_order_release);
 
-        // ── 주기적 비콘 디코드 (OFDM 6Mbps + DSSS 1Mbps) → FCS 유효 비콘만 host_emit ──
-        if(wbuf.size()>=wcap){
-            int64_t tn=now_ms();
-            auto emit=[&](const WifiRecord& br){
-                std::string key=br.bssid;
-                auto it=seen.find(key);
-                if(it!=seen.end() && tn-it->second < 10000) return;  // 10s dedup per BSSID
-                seen[key]=tn;
-                WifiRecord m=br; m.ch=ch_idx; host_emit(v, m);
-            };
-            wifi_ofdm::decode_buffer(wbuf.data(), wbuf.size(), (double)out_sr, emit);
-            wifi_dsss::decode_buffer_dsss(wbuf.data(), wbuf.size(), (double)out_sr, emit);
-            size_t keep=std::min<size_t>(wbuf.size(), 4096);   // 패킷 경계 overlap
-            wbuf.erase(wbuf.begin(), wbuf.end()-keep);
+        // ── 주기적 비콘 디코드 (OFDM 6/9Mbps + DSSS 1Mbps) → 풀 → FCS 유효 비콘만 host_emit ──
+        if(wbuf->size()>=wcap){
+            int nxt=(cur+1)%SCAN_SLOTS;
+            size_t keep=std::min<size_t>(wbuf->size(), SCAN_KEEP);   // 패킷 경계 overlap
+            if(slots[nxt].busy.load(std::memory_order_acquire)){
+                // 풀 밀림 → 이 창 버리고 같은 슬롯 재사용
+                scan_drop++;
+                std::copy(wbuf->end()-keep, wbuf->end(), wbuf->begin());
+                wbuf->resize(keep);
+            } else {
+                auto& nx=slots[nxt].x;
+                nx.assign(wbuf->end()-keep, wbuf->end());
+                pool_submit(&sctx, &slots[cur]);
+                cur=nxt; wbuf=&nx;
+            }
         }
 
         // 1초마다 진단 레코드 (end-to-end 파이프 검증 + 측정)
         int64_t t=now_ms();
         if(t-last_emit>=1000){
             last_emit=t;
+            if(scan_drop){
+                bewe_log_push(0,"WiFi[%d] decode pool behind: %llu scan windows dropped\n",
+                              ch_idx,(unsigned long long)scan_drop);
+                scan_drop=0;
+            }
             WifiRecord r=dec.snapshot();
             r.t_ms=t; r.ch=ch_idx; r.freq=(ch.s+ch.e)/2.0f;
             host_emit(v, r);
         }
     }
     if(dump) fclose(dump);
+    while(sctx.inflight.load(std::memory_order_acquire) > 0)          // 슬롯/ctx 는 이 스택 소유
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    g_pool.release();
     if(!worker_stop_req(ch_idx)) worker_natural_exit(v, ch_idx);
     bewe_log_push(0,"WiFi[%d] stop\n",ch_idx);
 }
@@ -141,6 +141,7 @@ void host_emit(FFTViewer& v, WifiRecord m){
     store_append(m);
     WifiWireMsg w; wifi_msg_to_wire(m, w);
     bewe_mod_emit(v, "wifi", &w, sizeof(w));
+    bewe_mod_tm_pin(v, "wifi", m.ch);
 }
 
 static void on_data(FFTViewer& v, const char* station, const uint8_t* d, size_t n){
@@ -4,13 +4,18 @@
 // 단계: 패킷검출(L-STF autocorr) → CFO → L-LTF 동기/채널추정 → 심볼 FFT/등화
 //       → L-SIG(Viterbi) → DATA demap/deinterleave/Viterbi/descramble → MPDU/FCS → IE.
 // 헤더 전용 — 오프라인 하니스 + (추후)스트리밍 워커 공용. FFTW3f 필요.
+#include <algorithm>
 #include <vector>
 #include <complex>
 #include <cstdint>
 #include <cstring>
 #include <cmath>
 #include <functional>
+#include <mutex>
 #include <fftw3.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #include "wifi_meta.hpp"
 
 namespace wifi_ofdm {
@@ -36,49 +41,117 @@ static const int8_t PILOT_POL[127] = {
  -1,-1,-1,-1,-1,1,-1,1,1,-1,1,-1,1,1,1,-1,-1,1,-1,-1,-1,1,1,1,-1,-1,-1,-1,-1,-1,-1 };
 
 // ── 길쌈부호 Viterbi (K=7, r=1/2, g0=133, g1=171 octal) — soft input ───────
+// 나비(butterfly) ACS: 상태 j, j+32 → 2j(in=0), 2j+1(in=1). 두 생성다항식 모두
+// bit6 이 1 이라 j+32 쪽 출력은 j 쪽의 보수 → 분기 metric 부호만 반전.
+// 32 나비를 AVX2(8) / SSE(4) 폭으로 한 번에, 결정 비트는 movemask 로 스텝당 u32×2.
+// 상태/결정 버퍼는 객체 소유 (용량만 증가) → 디코드마다 할당 없음. 객체는 thread_local.
 struct Viterbi {
-    static constexpr int NS=64; // 2^(K-1)
-    // 출력 비트 룩업: out0/out1 for (state,input)
-    int8_t o0[NS][2], o1[NS][2], ns[NS][2];
+    static constexpr int NS=64, NB=32; // 2^(K-1), 나비 수
+    alignas(32) float ea0[NB], eb0[NB], ea1[NB], eb1[NB];   // in=0/1 분기 부호 (±1, j 쪽)
+    alignas(32) float pm[NS], npm[NS];
+    std::vector<uint32_t> dec;          // 스텝 t: [2t]=짝수 목적상태 2j, [2t+1]=홀수 2j+1 — bit j = 위쪽(j+32) 선택
     Viterbi(){
-        for(int s=0;s<NS;s++) for(int in=0;in<2;in++){
-            int reg=(s<<1)|in;                       // 7-bit reg (msb=new bit)
-            auto par=[&](int g){ int x=reg&g,c=0; while(x){c^=x&1;x>>=1;} return c; };
-            o0[s][in]=par(0133); o1[s][in]=par(0171);
-            ns[s][in]=reg&0x3f;                      // next state (low 6 bits)
+        auto par=[](int x){ int c=0; while(x){c^=x&1;x>>=1;} return c; };
+        for(int j=0;j<NB;j++) for(int in=0;in<2;in++){
+            int reg=(j<<1)|in;                       // 7-bit reg (msb=가장 오래된 비트)
+            // 기대비트 0→+soft, 1→−soft 상관. metric = pm − 상관 (작을수록 좋음)
+            float sa = par(reg&0133)? -1.f : 1.f, sb = par(reg&0171)? -1.f : 1.f;
+            (in? ea1 : ea0)[j]=sa; (in? eb1 : eb0)[j]=sb;
         }
     }
-    // soft bits: +1=강한0, -1=강한1 (LLR 부호). 코드길이 = 2*nbits.
+    // soft bits: +1=강한0, -1=강한1 (LLR 부호, 0=erasure). 코드길이 = 2*nbits.
+    // out 은 호출자 재사용 버퍼 (resize 만).
     void decode(const float* soft, int nbits, std::vector<uint8_t>& out){
         const float INF=1e9f;
-        std::vector<float> pm(NS, INF), npm(NS);
-        std::vector<std::vector<uint8_t>> tb(nbits, std::vector<uint8_t>(NS));
+        if(dec.size() < (size_t)nbits*2) dec.resize((size_t)nbits*2);
+        for(int s=0;s<NS;s++) pm[s]=INF;
         pm[0]=0;
         for(int t=0;t<nbits;t++){
-            float a=soft[2*t], b=soft[2*t+1];
-            for(int s=0;s<NS;s++) npm[s]=INF;
-            for(int s=0;s<NS;s++){
-                if(pm[s]>=INF) continue;
-                for(int in=0;in<2;in++){
-                    // BPSK soft metric: 기대비트 0→+, 1→-. 거리 = (a - sgn)^2 류 대신 상관.
-                    float e0 = (o0[s][in]? -a : a);
-                    float e1 = (o1[s][in]? -b : b);
-                    float m = pm[s] - e0 - e1;        // 상관 클수록 metric 감소(=좋음)
-                    int n=ns[s][in];
-                    if(m<npm[n]){ npm[n]=m; tb[t][n]=(uint8_t)s; }
-                }
+            acs(soft[2*t], soft[2*t+1], dec.data()+2*t);
+            if((t&31)==31){                          // 재정규화 (float 누적 오차 방지)
+                float mn=pm[0]; for(int s=1;s<NS;s++) mn=std::min(mn,pm[s]);
+                for(int s=0;s<NS;s++) pm[s]-=mn;
             }
-            pm.swap(npm);
         }
         // 종단: tail-terminated 코드 → 종단 상태 = 0 강제 (6 tail bit 가 인코더 flush)
-        int s=0;
-        std::vector<uint8_t> bits(nbits);
         // 디코드 비트 = 그 스텝 후 상태의 LSB (reg = (prev<<1)|in → ns&1 = in)
-        for(int t=nbits-1;t>=0;t--){ int ps=tb[t][s]; bits[t]=(uint8_t)(s&1); s=ps; }
-        out.assign(bits.begin(),bits.end());
+        out.resize(nbits);
+        int s=0;
+        for(int t=nbits-1;t>=0;t--){
+            int j=s>>1, up=(dec[2*t+(s&1)]>>j)&1;
+            out[t]=(uint8_t)(s&1);
+            s=j|(up<<5);
+        }
+    }
+private:
+    // 한 스텝 ACS: pm → npm → pm (swap 대신 복사, 256B)
+    inline void acs(float a, float b, uint32_t* d){
+#if defined(__AVX2__)
+        __m256 va=_mm256_set1_ps(a), vb=_mm256_set1_ps(b);
+        uint32_t de=0, dodd=0;
+        for(int j=0;j<NB;j+=8){
+            __m256 lo=_mm256_load_ps(pm+j), hi=_mm256_load_ps(pm+j+NB);
+            __m256 e0=_mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(ea0+j),va),_mm256_mul_ps(_mm256_load_ps(eb0+j),vb));
+            __m256 e1=_mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(ea1+j),va),_mm256_mul_ps(_mm256_load_ps(eb1+j),vb));
+            __m256 c0l=_mm256_sub_ps(lo,e0), c0h=_mm256_add_ps(hi,e0);   // → 2j
+            __m256 c1l=_mm256_sub_ps(lo,e1), c1h=_mm256_add_ps(hi,e1);   // → 2j+1
+            __m256 m0=_mm256_cmp_ps(c0h,c0l,_CMP_LT_OQ), m1=_mm256_cmp_ps(c1h,c1l,_CMP_LT_OQ);
+            __m256 n0=_mm256_min_ps(c0l,c0h), n1=_mm256_min_ps(c1l,c1h);
+            de  |= (uint32_t)_mm256_movemask_ps(m0)<<j;
+            dodd|= (uint32_t)_mm256_movemask_ps(m1)<<j;
+            // (n0[k], n1[k]) → npm[2(j+k)], npm[2(j+k)+1] 인터리브
+            __m256 il=_mm256_unpacklo_ps(n0,n1), ih=_mm256_unpackhi_ps(n0,n1);
+            _mm256_store_ps(npm+2*j,   _mm256_permute2f128_ps(il,ih,0x20));
+            _mm256_store_ps(npm+2*j+8, _mm256_permute2f128_ps(il,ih,0x31));
+        }
+        d[0]=de; d[1]=dodd;
+#elif defined(__SSE2__)
+        __m128 va=_mm_set1_ps(a), vb=_mm_set1_ps(b);
+        uint32_t de=0, dodd=0;
+        for(int j=0;j<NB;j+=4){
+            __m128 lo=_mm_load_ps(pm+j), hi=_mm_load_ps(pm+j+NB);
+            __m128 e0=_mm_add_ps(_mm_mul_ps(_mm_load_ps(ea0+j),va),_mm_mul_ps(_mm_load_ps(eb0+j),vb));
+            __m128 e1=_mm_add_ps(_mm_mul_ps(_mm_load_ps(ea1+j),va),_mm_mul_ps(_mm_load_ps(eb1+j),vb));
+            __m128 c0l=_mm_sub_ps(lo,e0), c0h=_mm_add_ps(hi,e0);
+            __m128 c1l=_mm_sub_ps(lo,e1), c1h=_mm_add_ps(hi,e1);
+            de  |= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(c0h,c0l))<<j;
+            dodd|= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(c1h,c1l))<<j;
+            __m128 n0=_mm_min_ps(c0l,c0h), n1=_mm_min_ps(c1l,c1h);
+            _mm_store_ps(npm+2*j,   _mm_unpacklo_ps(n0,n1));
+            _mm_store_ps(npm+2*j+4, _mm_unpackhi_ps(n0,n1));
+        }
+        d[0]=de; d[1]=dodd;
+#else
+        uint32_t de=0, dodd=0;
+        for(int j=0;j<NB;j++){
+            float e0=ea0[j]*a+eb0[j]*b, e1=ea1[j]*a+eb1[j]*b;
+            float c0l=pm[j]-e0, c0h=pm[j+NB]+e0, c1l=pm[j]-e1, c1h=pm[j+NB]+e1;
+            if(c0h<c0l){ de|=1u<<j;   npm[2*j]=c0h; }   else npm[2*j]=c0l;
+            if(c1h<c1l){ dodd|=1u<<j; npm[2*j+1]=c1h; } else npm[2*j+1]=c1l;
+        }
+        d[0]=de; d[1]=dodd;
+#endif
+        memcpy(pm, npm, sizeof(pm));
     }
 };
 
+// ── 디펑처링: 전송 coded soft → r=1/2 모체 부호 soft (누락 위치 0 = erasure) ──
+// 802.11 17.3.5.6: r=3/4 는 A1 B1 A2 B3 (B2, A3 누락), r=2/3 는 A1 B1 A2 (B2 누락).
+// num/den = 부호율 (1/2, 2/3, 3/4). 반환 = 모체 soft 수 (out 재사용 버퍼).
+inline size_t depuncture(const float* in, size_t n, int num, int den, std::vector<float>& out){
+    static const uint8_t P23[4]={1,1,1,0}, P34[6]={1,1,1,0,0,1};
+    const uint8_t* pat; int plen;
+    if(num==3&&den==4){ pat=P34; plen=6; }
+    else if(num==2&&den==3){ pat=P23; plen=4; }
+    else { out.assign(in,in+n); return n; }
+    int keep=0; for(int k=0;k<plen;k++) keep+=pat[k];
+    size_t nm=(n+keep-1)/keep*plen;
+    out.resize(nm);
+    size_t i=0;
+    for(size_t m=0;m<nm;m++) out[m] = pat[m%plen] ? (i<n ? in[i++] : 0.f) : 0.f;
+    return nm;
+}
+
 // ── 디인터리버 (N_CBPS=48, BPSK) ──────────────────────────────────────────
 static inline void deinterleave48(const float* in, float* out){
     const int N=48;
@@ -109,7 +182,9 @@ static inline uint32_t crc32_802(const uint8_t* d, size_t n){
 // ── 64-pt FFT (FFTW) ──────────────────────────────────────────────────────
 struct FFT64 {
     fftwf_complex *i,*o; fftwf_plan p; cf ltf_t[64];
-    FFT64(){ i=fftwf_alloc_complex(64); o=fftwf_alloc_complex(64);
+    static std::mutex& plan_mtx(){ static std::mutex m; return m; }   // fftw planner 는 thread-unsafe
+    FFT64(){ std::lock_guard<std::mutex> lk(plan_mtx());
+        i=fftwf_alloc_complex(64); o=fftwf_alloc_complex(64);
         p=fftwf_plan_dft_1d(64,i,o,FFTW_FORWARD,FFTW_ESTIMATE);
         // LTF time 기준 (matched-filter 용): IFFT of LONG/LTF_FREQ
         fftwf_complex *fi=fftwf_alloc_complex(64),*fo=fftwf_alloc_complex(64);
@@ -119,38 +194,43 @@ struct FFT64 {
         fftwf_execute(ip); for(int k=0;k<64;k++) ltf_t[k]=cf(fo[k][0],fo[k][1])/64.0f;
         fftwf_destroy_plan(ip); fftwf_free(fi); fftwf_free(fo);
     }
-    ~FFT64(){ fftwf_destroy_plan(p); fftwf_free(i); fftwf_free(o); }
+    ~FFT64(){ std::lock_guard<std::mutex> lk(plan_mtx()); fftwf_destroy_plan(p); fftwf_free(i); fftwf_free(o); }
     void run(const cf* t, cf* f){ for(int k=0;k<64;k++){i[k][0]=t[k].real();i[k][1]=t[k].imag();}
         fftwf_execute(p); for(int k=0;k<64;k++) f[k]=cf(o[k][0],o[k][1]); }
 };
 
-// 분수 리샘플 (windowed-sinc 32탭) → 정확히 out_sr
-inline std::vector<cf> ofdm_resample(const std::vector<cf>& in, double in_sr, double out_sr){
-    if(std::fabs(in_sr-out_sr)<1.0) return in;
+// 분수 리샘플 (windowed-sinc 32탭) → 정확히 out_sr. out = 호출자 재사용 버퍼.
+inline void ofdm_resample(const cf* in, size_t nin, double in_sr, double out_sr, std::vector<cf>& out){
+    out.clear();
+    if(std::fabs(in_sr-out_sr)<1.0){ out.assign(in,in+nin); return; }
     const double PI=3.14159265358979323846; double step=in_sr/out_sr;
-    if((long)(in.size()/step)<=64) return {};
-    size_t nout=(size_t)(in.size()/step)-32; std::vector<cf> out; out.reserve(nout); const int T=16;
+    if((long)(nin/step)<=64) return;
+    size_t nout=(size_t)(nin/step)-32; out.reserve(nout); const int T=16;
     for(size_t m=0;m<nout;m++){ double tin=m*step; long c=(long)std::floor(tin); double fr=tin-c;
         cf acc(0,0); double ws=0;
-        for(int k=-T+1;k<=T;k++){ long id=c+k; if(id<0||id>=(long)in.size())continue;
+        for(int k=-T+1;k<=T;k++){ long id=c+k; if(id<0||id>=(long)nin)continue;
             double xx=PI*(k-fr); double s=(std::fabs(xx)<1e-6)?1.0:std::sin(xx)/xx;
             double aa=(double)(k-fr)/T; double w=0.42+0.5*std::cos(PI*aa)+0.08*std::cos(2*PI*aa);
             double h=s*w; acc+=in[id]*(float)h; ws+=h; }
         out.push_back(ws>1e-9?acc/(float)ws:acc); }
-    return out;
 }
 
 // ── 버퍼 디코드: 20.0 MSPS baseband → FCS 유효 비콘 → on_rec(WifiRecord) ─────
 // in_sr != 20e6 면 내부 리샘플. on_rec 는 SSID/채널/보안/PHY 채운 레코드 전달.
+// 6 Mbps (BPSK r=1/2) + 9 Mbps (BPSK r=3/4, 디펑처링) 비콘. 작업 버퍼는 전부
+// thread_local 재사용 → 스캔당 힙 할당 없음 (용량 증가 시 제외).
 inline void decode_buffer(const cf* xin, size_t nin, double in_sr,
                           const std::function<void(const WifiRecord&)>& on_rec, int max_pkt=2000){
     const double PI=3.14159265358979323846, FS=20.0e6;
-    std::vector<cf> rs; const cf* xp; size_t N;
+    static thread_local std::vector<cf> rs;
+    static thread_local std::vector<float> cs, dp;
+    static thread_local std::vector<uint8_t> sb, db, dsb, mp;
+    const cf* xp; size_t N;
     if(std::fabs(in_sr-FS)<1.0){ xp=xin; N=nin; }
-    else { std::vector<cf> tmp(xin,xin+nin); rs=ofdm_resample(tmp,in_sr,FS); xp=rs.data(); N=rs.size(); }
+    else { ofdm_resample(xin,nin,in_sr,FS,rs); xp=rs.data(); N=rs.size(); }
     if(N<512) return;
     auto& x=xp;
-    static thread_local FFT64 fft;  Viterbi vit;
+    static thread_local FFT64 fft;  static thread_local Viterbi vit;
     double eref=0; for(int k=0;k<64;k++) eref+=std::norm(fft.ltf_t[k]);
     // STF lag-16 검출
     int pkts=0;
@@ -199,24 +279,31 @@ inline void decode_buffer(const cf* xin, size_t nin, double in_sr,
             return true;
         };
         float lc[48]; if(!demap(sig,0,lc)) continue;
-        std::vector<uint8_t> sb; vit.decode(lc,24,sb);
+        vit.decode(lc,24,sb);
         int rate=0; for(int i=0;i<4;i++) rate|=sb[i]<<i;
         int len=0;  for(int i=0;i<12;i++) len|=sb[5+i]<<i;
         // reencode 거리로 L-SIG 검증
         uint8_t re[48]; { int reg=0; auto par=[&](int g){int v=reg&g,c=0;while(v){c^=v&1;v>>=1;}return c;};
             for(int i=0;i<24;i++){ reg=((reg<<1)|sb[i])&0x7f; re[2*i]=par(0133); re[2*i+1]=par(0171);} }
         int dist=0; for(int k=0;k<48;k++){ int hd=(lc[k]<0)?1:0; if(hd!=re[k])dist++; }
-        if(dist>4 || rate!=0xB || len<24 || len>2400) continue;   // 6Mbps OFDM 비콘만
-        int nsym=(16+8*len+6+23)/24;
+        if(dist>4 || (rate!=0xB && rate!=0xF) || len<24 || len>2400) continue;   // 6/9 Mbps BPSK 비콘만
+        const bool r34 = rate==0xF;
+        const int ndbps = r34 ? 36 : 24;
+        int nsym=(16+8*len+6+ndbps-1)/ndbps;
         if(sig+80+(long)nsym*80>=(long)N) continue;
-        std::vector<float> cs; cs.reserve(nsym*48);
-        for(int s=0;s<nsym;s++){ float sub[48]; if(!demap(sig+80*(s+1),s+1,sub)){ cs.clear(); break; } for(int k=0;k<48;k++) cs.push_back(sub[k]); }
-        if((int)cs.size()!=nsym*48) continue;
-        int nbits=16+8*len+6; std::vector<uint8_t> db; vit.decode(cs.data(),nbits,db);
+        cs.resize((size_t)nsym*48);
+        bool okd=true;
+        for(int s=0;s<nsym && okd;s++) okd=demap(sig+80*(s+1),s+1,cs.data()+(size_t)s*48);
+        if(!okd) continue;
+        const float* mother=cs.data();
+        if(r34){ depuncture(cs.data(),cs.size(),3,4,dp); mother=dp.data(); }
+        int nbits=16+8*len+6; vit.decode(mother,nbits,db);
         int scr=0; for(int i=0;i<7;i++) scr|=db[i]<<(6-i);
-        std::vector<uint8_t> dsb(nbits);
-        for(int i=0;i<nbits;i++){ int fb=((scr>>6)^(scr>>3))&1; dsb[i]=db[i]^fb; scr=((scr<<1)|fb)&0x7f; }
-        std::vector<uint8_t> mp(len);
+        dsb.resize(nbits);
+        // SERVICE 앞 7 bit = 0 → db[0..6] 가 곧 스크램블러 출력 → 상태는 bit 7 부터 이어감
+        for(int i=0;i<7;i++) dsb[i]=0;
+        for(int i=7;i<nbits;i++){ int fb=((scr>>6)^(scr>>3))&1; dsb[i]=db[i]^fb; scr=((scr<<1)|fb)&0x7f; }
+        mp.resize(len);
         for(int B=0;B<len;B++){ int v=0; for(int b=0;b<8;b++) v|=dsb[16+B*8+b]<<b; mp[B]=(uint8_t)v; }
         uint32_t fcs=(mp[len-4])|(mp[len-3]<<8)|(mp[len-2]<<16)|((uint32_t)mp[len-1]<<24);
         if(fcs!=crc32_802(mp.data(),len-4)) continue;
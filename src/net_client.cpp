@@ -2,6 +2,8 @@
 #include "bewe_paths.hpp"
 #include "login.hpp"
 #include "sigmf.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <cstdio>
 
 extern void bewe_log_push(int col, const char* fmt, ...);
@@ -173,6 +175,7 @@ void NetClient::recv_loop(){
     uint64_t pkt_count = 0;
     const char* disc_reason = "unknown";
     bewe_log_push(2,"[NetClient] recv_loop started fd=%d\n", fd_);
+    PipeStats::name_thread("net_rx");
     auto stats_start = std::chrono::steady_clock::now();
     auto stats_last  = stats_start;
     uint64_t stats_prev_total = stat_rx_bytes.load();
@@ -223,6 +226,7 @@ void NetClient::recv_loop(){
             break;
         }
         uint32_t len = hdr.len;
+        BEWE_TRACE_SCOPE_ARG("net", "recv", len);   // payload 수신 + dispatch
         if(len > 4*1024*1024){
             bewe_log_push(2,"[NetClient] oversized pkt: type=0x%02x len=%u\n", hdr.type, len);
             disc_reason = "oversized";
@@ -552,6 +556,28 @@ void NetClient::handle_packet(PacketType type,
         break;
     }
 
+    case PacketType::STATS: {
+        if(len < sizeof(PktStats)) break;
+        PktStats st; memcpy(&st, payload, sizeof(st));
+        PktStats prev;
+        bool had = remote_stats_valid.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lk(remote_stats_mtx);
+            prev = remote_stats;
+            remote_stats = st;
+        }
+        remote_stats_valid.store(true, std::memory_order_relaxed);
+        // HOST 손실 이벤트만 로그 (정상 시 조용)
+        if(had && st.rx_overruns > prev.rx_overruns)
+            bewe_log_push(2, "[STATS] HOST RX overrun +%llu (lost %llu samples)\n",
+                          (unsigned long long)(st.rx_overruns - prev.rx_overruns),
+                          (unsigned long long)(st.rx_lost - prev.rx_lost));
+        if(had && st.net_drops > prev.net_drops + 100)
+            bewe_log_push(2, "[STATS] HOST send drops +%llu (q fft=%u audio=%u)\n",
+                          (unsigned long long)(st.net_drops - prev.net_drops), st.q_fft, st.q_audio);
+        break;
+    }
+
     case PacketType::HEARTBEAT: {
         if(len < 4) break; // 최소 기존 4바이트 호환
         auto* hb = reinterpret_cast<const PktHeartbeat*>(payload);
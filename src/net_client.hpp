@@ -156,6 +156,10 @@ public:
     std::atomic<uint64_t> remote_central_disk_free{0};
     std::atomic<uint64_t> remote_central_disk_total{0};
     std::atomic<double>   last_heartbeat_time{0.0};  // glfwGetTime() at last HB
+    // ── HOST 파이프라인 메트릭 요약 (STATS 패킷, 5s) ──
+    std::mutex            remote_stats_mtx;
+    PktStats              remote_stats{};
+    std::atomic<bool>     remote_stats_valid{false};
     std::mutex            remote_antenna_mtx;
     char                  remote_antenna[32] = {};    // HOST의 안테나 (HB 수신 시 갱신)
     char                  remote_sdr_kind[16] = {};   // HOST의 SDR 모델명 (HB 수신 시 갱신)
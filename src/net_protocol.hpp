@@ -90,6 +90,10 @@ enum class PacketType : uint8_t {
     MISSION_FILE_SET_NOTE  = 0x57,  // any → central: archive 파일 note 갱신 (사이드카 Note + list 재발송)
     // ── Module data pipe (src/modules/ 선택형 모듈 공용 전송로) ─────────
     MODULE_PIPE            = 0x58,  // 양방향: PktModulePipe + payload (mod_id 다중화, Central opaque relay)
+    LWF_LIVE_BLOCK         = 0x59,  // host → central: v4 압축 블록 (봉인된 ≤BLOCK_ROWS 행 블록) append to LIVE file
+    MISSION_FILE_PUSH_STATE = 0x5A, // central → host: resumable PUSH 재개 지점 / 청크 진행 ACK
+    STATS                  = 0x5B,  // host → all: 파이프라인 메트릭 요약 (5s, PktStats)
+    CENTRAL_CAPS           = 0x5C,  // central → host: 지원 기능 bitmask (HOST_OPEN 직후 첫 패킷, PktCentralCaps)
 };
 
 // ── Packet header (9 bytes, packed) ──────────────────────────────────────
@@ -424,7 +428,7 @@ struct __attribute__((packed)) LwfFileEntry {
     uint64_t center_freq_hz;
     uint64_t sample_rate_hz;
     uint32_t fft_size;
-    uint32_t num_rows;         // (size_bytes - sizeof(FileHeader)) / fft_size
+    uint32_t num_rows;         // LwfCodec::count_rows (v3 raw / v4 block index)
     char     station_name[32]; // v3: host station name
     float    station_lat;      // v3
     float    station_lon;      // v3
@@ -470,6 +474,10 @@ struct __attribute__((packed)) PktLwfLiveRowHdr {
     uint32_t row_index;
     // raw row bytes (fft_size 길이) follow
 };
+// v4: LIVE_ROW 대신 압축 블록 단위 전송 (LwfCodec::BlockHdr + zlib bytes follow).
+struct __attribute__((packed)) PktLwfLiveBlockHdr {
+    char     filename[64];
+};
 struct __attribute__((packed)) PktLwfLiveStop {
     char     filename[64];
 };
@@ -515,6 +523,24 @@ struct __attribute__((packed)) PktDiskStat {
     char     station[64];  // HOST: 자기 station_name / Central: 빈문자열
 };
 
+// ── STATS (HOST → all clients) ───────────────────────────────────────────
+// 5초 주기. 상세는 HOST localhost /metrics (Prometheus) — 이건 JOIN 용 요약.
+// 누적값은 HOST 시작 이후 합계, rate 는 직전 STATS 대비.
+struct __attribute__((packed)) PktStats {
+    uint64_t rx_overruns;      // SDR RX overrun 누적 (BladeRF META status)
+    uint64_t rx_lost;          // overrun/timestamp 불연속으로 잃은 샘플 누적
+    uint64_t net_drops;        // HOST 송신 큐 드롭 누적 (FFT/오디오/소켓 full)
+    uint64_t dem_skipped;      // 복조 워커 lag 초과로 건너뛴 샘플 누적
+    uint32_t ring_lag_max;     // IQ ring reader 최대 lag (samples)
+    uint32_t ring_capacity;    // IQ ring 크기 (samples)
+    uint32_t q_fft;            // 현재 FFT/제어 송신 큐 합계 (패킷)
+    uint32_t q_audio;          // 현재 오디오 송신 큐 합계 (패킷)
+    uint32_t records_x10;      // 모듈 디코드 레코드 / s ×10 (전 모듈 합)
+    uint16_t proc_cpu_x10;     // 프로세스 CPU % ×10 (코어 1개 = 1000)
+    uint16_t top_cpu_x10;      // 가장 바쁜 스레드 CPU % ×10
+    char     top_thread[16];   // 그 스레드 이름
+};
+
 // ── HEARTBEAT (server → all clients) ─────────────────────────────────────
 // Sent every 3 seconds.
 // host_state: 0=OK, 1=CHASSIS_RESETTING, 2=SPECTRUM_PAUSED
@@ -822,22 +848,61 @@ struct __attribute__((packed)) PktMissionFilePushMeta {
     MissionFileKey key;
     uint64_t       total_bytes;     // 0 = unknown / streaming
     uint8_t        transfer_id;     // HOST가 부여 (room 내 unique)
-    uint8_t        mode;            // 0=replace (truncate), 1=append (offset 따름)
+    uint8_t        mode;            // MFP_MODE_*
     uint8_t        _pad[2];
     char           info_data[1024];  // .info 사이드카 (없으면 빈)
+    // mode==MFP_MODE_RESUME 이면 뒤에 PktMissionFilePushResume
+};
+
+static constexpr uint8_t MFP_MODE_REPLACE = 0;  // truncate
+static constexpr uint8_t MFP_MODE_APPEND  = 1;  // 기존 파일 유지, offset 따름
+// resumable: Central 이 숨김 .part + .part.state 에 검증된 prefix 를 유지하고
+// META 에 PUSH_STATE(RESUME) 로 재개 지점을 답함. 청크는 CRC32C 필수, have 순서대로만 수용
+// (go-back-N), 청크마다 PUSH_STATE(PROGRESS). 끝은 COMMIT 청크 (전체 파일 CRC32C) → rename + ACK.
+static constexpr uint8_t MFP_MODE_RESUME  = 2;
+
+struct __attribute__((packed)) PktMissionFilePushResume {
+    uint64_t file_id;       // HOST 원본 fingerprint (size/mtime) — 다르면 Central 이 partial 폐기
 };
 
 // HOST → Central: 청크 (offset append 지원)
 struct __attribute__((packed)) PktMissionFilePushData {
     uint8_t  transfer_id;
     uint8_t  is_last;       // 1: 마지막 청크 → Central은 파일 close 후 ack
-    uint8_t  _pad[2];
+    uint8_t  flags;         // MFP_DATA_* (구버전 HOST = 0)
+    uint8_t  _pad;
     uint64_t offset;        // 목적 파일 내 쓰기 시작 위치
     uint32_t chunk_bytes;
-    uint8_t  _pad2[4];      // 8-byte align before raw bytes
+    uint32_t crc32c;        // MFP_DATA_CRC: 청크 CRC32C / MFP_DATA_COMMIT: 전체 파일 CRC32C
     // 뒤에 raw bytes [chunk_bytes]
 };
 
+static constexpr uint8_t MFP_DATA_CRC    = 0x01;
+static constexpr uint8_t MFP_DATA_COMMIT = 0x02;  // chunk_bytes=0, offset=total (resume 모드 종료)
+
+// Central → HOST: resumable PUSH 상태
+//   have_bytes: .part 에 CRC 검증 후 연속 기록된 prefix = 다음에 받을 offset
+//   have_crc  : 그 prefix 의 CRC32C (HOST 가 자기 파일과 비교, 다르면 offset 0 부터 재전송)
+static constexpr uint8_t MFP_ST_RESUME   = 0;  // META 응답
+static constexpr uint8_t MFP_ST_PROGRESS = 1;  // 청크 기록 완료
+static constexpr uint8_t MFP_ST_REWIND   = 2;  // CRC 불일치 / offset 어긋남 → have 부터 재전송
+struct __attribute__((packed)) PktMissionFilePushState {
+    MissionFileKey key;
+    uint8_t        transfer_id;
+    uint8_t        reason;      // MFP_ST_*
+    uint8_t        _pad[2];
+    uint32_t       have_crc;
+    uint64_t       have_bytes;
+};
+
+// Central → HOST: 기능 협상. Central 은 HOST_OPEN 직후 다른 어떤 MUX 패킷보다 먼저 보냄 →
+// HOST 는 CAPS 없이 다른 패킷이 먼저 오면 구버전 Central (caps = 0) 로 확정.
+static constexpr uint32_t CENTRAL_CAP_PUSH_RESUME = 1u << 0;  // MFP_MODE_RESUME + PUSH_STATE
+struct __attribute__((packed)) PktCentralCaps {
+    uint32_t caps;          // CENTRAL_CAP_*
+    uint32_t _rsv;
+};
+
 // any → Central: 파일 목록 (station/year/code 필터)
 struct __attribute__((packed)) PktMissionFileListReq {
     char     station[64];   // 빈 = 모든 station
@@ -908,7 +973,8 @@ struct __attribute__((packed)) PktMissionFileRename {
 };
 
 // Central → HOST: PUSH 완료 (or 실패) ACK
-//   status: 0=ok (file fully committed), 1=io error, 2=protocol error, 3=key invalid
+//   status: 0=ok (file fully committed), 1=io error, 2=protocol error, 3=key invalid,
+//           4=hash mismatch (resume 모드: partial 폐기됨 → 처음부터 재전송)
 struct __attribute__((packed)) PktMissionFilePushAck {
     MissionFileKey key;
     uint8_t        transfer_id;
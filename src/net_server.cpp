@@ -60,10 +60,34 @@ bool NetServer::start(int port){
     running_.store(true);
     accept_thr_ = std::thread(&NetServer::accept_loop, this);
     bewe_log_push(0, "[NetServer] listening on port %d\n", listen_port_);
+
+    for(int k = 0; k < 4; k++) ClientConn::drop_counter((ClientConn::DropKind)k);   // 0 부터 노출
+    // /metrics: 클라이언트별 큐 깊이 + 합계 (scrape 시점 계산)
+    metrics_col_ = Metrics::collector_add([this](Metrics::Writer& w){
+        NetStats ns = collect_stats();
+        w.family("bewe_net_clients", "gauge", "Connected clients (incl. Central relay)");
+        { std::lock_guard<std::mutex> lk(clients_mtx_); w.sample("bewe_net_clients", "", (double)clients_.size()); }
+        w.family("bewe_net_rx_bytes_total", "counter", "HOST bytes received from clients");
+        w.sample("bewe_net_rx_bytes_total", "", (double)ns.rx_bytes);
+        w.family("bewe_net_queue_depth", "gauge", "HOST send queue depth summed over clients (packets)");
+        w.sample("bewe_net_queue_depth", "queue=\"fft\"",   (double)ns.q_fft);
+        w.sample("bewe_net_queue_depth", "queue=\"audio\"", (double)ns.q_audio);
+        w.family("bewe_net_client_queue_depth", "gauge", "Per-client send queue depth (packets)");
+        std::lock_guard<std::mutex> lk(clients_mtx_);
+        for(auto& c : clients_){
+            std::string cl = Metrics::label("client", c->is_relay ? std::string("relay") : std::string(c->name));
+            size_t qf, qa;
+            {std::lock_guard<std::mutex> qlk(c->send_mtx);  qf = c->send_queue.size();}
+            {std::lock_guard<std::mutex> qlk(c->audio_mtx); qa = c->audio_queue.size();}
+            w.sample("bewe_net_client_queue_depth", cl + ",queue=\"fft\"",   (double)qf);
+            w.sample("bewe_net_client_queue_depth", cl + ",queue=\"audio\"", (double)qa);
+        }
+    });
     return true;
 }
 
 void NetServer::stop(){
+    if(metrics_col_){ Metrics::collector_del(metrics_col_); metrics_col_ = 0; }
     running_.store(false);
     if(server_fd_ >= 0){ shutdown(server_fd_, SHUT_RDWR); close(server_fd_); server_fd_=-1; }
     if(accept_thr_.joinable()) accept_thr_.join();
@@ -137,6 +161,8 @@ void NetServer::inject_fd(int fd){
 void NetServer::client_loop(std::shared_ptr<ClientConn> c){
     uint64_t pkt_count = 0;
     std::vector<uint8_t> payload;  // 패킷당 재할당 방지 — 루프 밖에서 재사용
+    char tn[16]; snprintf(tn, sizeof(tn), "nrx%d", c->fd);
+    PipeStats::name_thread(tn);
     while(c->alive.load()){
         PktHdr hdr{};
         if(!recv_all(c->fd, &hdr, PKT_HDR_SIZE)){
@@ -152,6 +178,7 @@ void NetServer::client_loop(std::shared_ptr<ClientConn> c){
             break;
         }
         uint32_t len = hdr.len;
+        BEWE_TRACE_SCOPE_ARG("net", "recv", len);   // payload 수신 + handle_packet
         if(len > 1024*1024){
             bewe_log_push(0, "[NetServer] oversized pkt op=%d type=0x%02x len=%u\n",
                    c->op_index, (uint8_t)hdr.type, len);
@@ -494,7 +521,7 @@ void NetServer::send_to(ClientConn& c, PacketType type,
 }
 
 // ── Broadcast FFT ─────────────────────────────────────────────────────────
-void NetServer::broadcast_fft(const float* data, int fft_size,
+void NetServer::broadcast_fft(const uint8_t* q, int fft_size,
                                int64_t wall_time,
                                uint64_t center_hz, uint32_t sr,
                                float pmin, float pmax,
@@ -503,6 +530,7 @@ void NetServer::broadcast_fft(const float* data, int fft_size,
     // v3.24.x: uint8 quantize 로 4배 압축. dB 범위 [pmin..pmax] 를 0..255 mapping.
     // 시각적 손실 거의 없음 (256 단계 = ~0.4 dB resolution). 헤더 fft_size 의 MSB
     // 에 FFT_FLAG_QUANT_U8 set 하여 수신측이 dequantize 알 수 있게.
+    // fft_data 가 같은 매핑의 uint8 로 저장되므로 여기서는 복사만 (FftQuant).
     PktFftFrame hdr{};
     hdr.center_freq_hz = center_hz;
     hdr.sample_rate    = sr;
@@ -523,16 +551,7 @@ void NetServer::broadcast_fft(const float* data, int fft_size,
     ph->type = static_cast<uint8_t>(PacketType::FFT_FRAME);
     ph->len  = total;
     memcpy(pkt.data() + PKT_HDR_SIZE, &hdr, sizeof(PktFftFrame));
-    uint8_t* qdata = pkt.data() + PKT_HDR_SIZE + sizeof(PktFftFrame);
-    float range = pmax - pmin;
-    if(!(range > 0.f)) range = 1.f;  // 안전망
-    float inv = 255.f / range;
-    for(int i = 0; i < fft_size; i++){
-        float v = (data[i] - pmin) * inv;
-        if(v < 0.f) v = 0.f;
-        if(v > 255.f) v = 255.f;
-        qdata[i] = (uint8_t)v;
-    }
+    memcpy(pkt.data() + PKT_HDR_SIZE + sizeof(PktFftFrame), q, (size_t)fft_size);
     if(cb.on_relay_broadcast){
         cb.on_relay_broadcast(pkt.data(), pkt.size(), false);
     }
@@ -752,6 +771,18 @@ void NetServer::broadcast_disk_stat(uint64_t free_bytes, uint64_t total_bytes, c
     }
 }
 
+// ── Broadcast stats ───────────────────────────────────────────────────────
+void NetServer::broadcast_stats(const PktStats& st){
+    auto pkt = make_packet(PacketType::STATS, &st, sizeof(st));
+    if(cb.on_relay_broadcast)
+        cb.on_relay_broadcast(pkt.data(), pkt.size(), false);
+    std::lock_guard<std::mutex> lk(clients_mtx_);
+    for(auto& c : clients_){
+        if(c->is_relay || !c->authed || !c->alive.load()) continue;
+        c->enqueue(pkt, false);
+    }
+}
+
 // ── Broadcast status ──────────────────────────────────────────────────────
 void NetServer::broadcast_status(float cf_mhz, float gain_db,
                                   uint32_t sr, uint8_t hw_type){
@@ -1033,12 +1064,12 @@ void NetServer::broadcast_lwf_live_start(const PktLwfLiveStart& s){
         cb.on_relay_broadcast(pkt.data(), pkt.size(), true);
 }
 
-void NetServer::broadcast_lwf_live_row(const PktLwfLiveRowHdr& hdr,
-                                        const uint8_t* row, uint32_t row_bytes){
-    std::vector<uint8_t> body(sizeof(PktLwfLiveRowHdr) + row_bytes);
+void NetServer::broadcast_lwf_live_block(const PktLwfLiveBlockHdr& hdr,
+                                          const uint8_t* blk, uint32_t blk_bytes){
+    std::vector<uint8_t> body(sizeof(PktLwfLiveBlockHdr) + blk_bytes);
     memcpy(body.data(), &hdr, sizeof(hdr));
-    if(row_bytes && row) memcpy(body.data() + sizeof(hdr), row, row_bytes);
-    auto pkt = make_packet(PacketType::LWF_LIVE_ROW, body.data(), (uint32_t)body.size());
+    if(blk_bytes && blk) memcpy(body.data() + sizeof(hdr), blk, blk_bytes);
+    auto pkt = make_packet(PacketType::LWF_LIVE_BLOCK, body.data(), (uint32_t)body.size());
     if(cb.on_relay_broadcast)
         cb.on_relay_broadcast(pkt.data(), pkt.size(), true);
 }
@@ -1,6 +1,10 @@
 #pragma once
 #include "net_protocol.hpp"
 #include "channel.hpp"
+#include "metrics.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <deque>
@@ -47,9 +51,23 @@ struct ClientConn {
     std::atomic<uint64_t>   stat_tx{0};
     std::atomic<uint64_t>   stat_drops{0};
 
+    // 프로세스 전역 드롭 카운터 (/metrics, STATS) — 클라이언트가 끊겨도 누적 유지
+    enum DropKind { DROP_FFT, DROP_AUDIO, DROP_CTRL, DROP_SOCK };
+    static Metrics::Counter& drop_counter(DropKind k){
+        static Metrics::Counter* c[4] = {
+            &Metrics::counter("bewe_net_drops_total", "HOST send drops (packets)", "kind=\"fft\""),
+            &Metrics::counter("bewe_net_drops_total", "HOST send drops (packets)", "kind=\"audio\""),
+            &Metrics::counter("bewe_net_drops_total", "HOST send drops (packets)", "kind=\"ctrl\""),
+            &Metrics::counter("bewe_net_drops_total", "HOST send drops (packets)", "kind=\"sock\""),
+        };
+        return *c[k];
+    }
+    static void count_drop(DropKind k){ drop_counter(k).inc(); }
+
     // fd로 패킷 전송 (non-blocking: socketpair 버퍼 가득 차면 드롭)
     void send_raw(const std::vector<uint8_t>& pkt){
         if(fd < 0 || !alive.load()) return;
+        BEWE_TRACE_SCOPE_ARG("net", "send", pkt.size());
         std::lock_guard<std::mutex> wlk(fd_write_mtx);
         size_t sent = 0;
         while(sent < pkt.size()){
@@ -57,6 +75,7 @@ struct ClientConn {
             if(r < 0){
                 if(errno == EAGAIN || errno == EWOULDBLOCK){
                     stat_drops.fetch_add(1, std::memory_order_relaxed);
+                    count_drop(DROP_SOCK);
                     return;  // 버퍼 가득 → 이 패킷 드롭 (실시간 스트림)
                 }
                 alive.store(false); return;
@@ -65,10 +84,14 @@ struct ClientConn {
             sent += (size_t)r;
         }
         stat_tx.fetch_add(pkt.size(), std::memory_order_relaxed);
+        static auto& m_tx = Metrics::counter("bewe_net_tx_bytes_total", "HOST bytes sent to clients");
+        m_tx.inc(pkt.size());
     }
 
     // FFT/제어 전용 스레드
     void send_worker(){
+        char tn[16]; snprintf(tn, sizeof(tn), "ntx%d", fd);   // trace / top 에서 접속별 구분
+        PipeStats::name_thread(tn);
         while(true){
             std::vector<uint8_t> pkt;
             {
@@ -84,6 +107,8 @@ struct ClientConn {
 
     // 오디오 전용 스레드
     void audio_worker(){
+        char tn[16]; snprintf(tn, sizeof(tn), "nau%d", fd);
+        PipeStats::name_thread(tn);
         while(true){
             std::vector<uint8_t> pkt;
             {
@@ -115,14 +140,15 @@ struct ClientConn {
             if(audio_queue.size() >= AUDIO_QUEUE_MAX){
                 audio_queue.pop_front();
                 stat_drops.fetch_add(1, std::memory_order_relaxed);
+                count_drop(DROP_AUDIO);
             }
             audio_queue.push_back(std::move(pkt));
             audio_cv.notify_one();
         } else {
             std::lock_guard<std::mutex> lk(send_mtx);
             if(send_queue.size() >= SEND_QUEUE_MAX){
-                if(is_fft){ send_queue.pop_front(); stat_drops.fetch_add(1, std::memory_order_relaxed); }
-                else return;
+                if(is_fft){ send_queue.pop_front(); stat_drops.fetch_add(1, std::memory_order_relaxed); count_drop(DROP_FFT); }
+                else { count_drop(DROP_CTRL); return; }
             }
             send_queue.push_back(std::move(pkt));
             send_cv.notify_one();
@@ -238,8 +264,8 @@ public:
     std::vector<OpEntry> get_operators() const;
 
     // ── Broadcast / Send ─────────────────────────────────────────────────
-    // FFT frame → all clients
-    void broadcast_fft(const float* data, int fft_size,
+    // FFT frame → all clients. q = uint8 행 (dB = pmin + q·(pmax-pmin)/255, FFT_FLAG_QUANT_U8)
+    void broadcast_fft(const uint8_t* q, int fft_size,
                         int64_t wall_time,
                        uint64_t center_hz, uint32_t sr,
                        float pmin, float pmax,
@@ -287,8 +313,8 @@ public:
 
     // LIVE 스트리밍 — host worker가 누적 row를 모든 JOIN에 broadcast
     void broadcast_lwf_live_start(const PktLwfLiveStart& s);
-    void broadcast_lwf_live_row(const PktLwfLiveRowHdr& hdr,
-                                 const uint8_t* row, uint32_t row_bytes);
+    void broadcast_lwf_live_block(const PktLwfLiveBlockHdr& hdr,
+                                   const uint8_t* blk, uint32_t blk_bytes);
     void broadcast_lwf_live_stop(const PktLwfLiveStop& s);
 
     // Digital decode log → clients with audio_mask bit set
@@ -304,6 +330,9 @@ public:
     // DISK_STAT → all clients (HOST 측 recordings/missions 디스크 여유공간)
     void broadcast_disk_stat(uint64_t free_bytes, uint64_t total_bytes, const char* station);
 
+    // STATS → all clients (파이프라인 메트릭 요약, 5s)
+    void broadcast_stats(const PktStats& st);
+
     // /chassis 2 reset: FFT+오디오 방송 일시 중단 / 재개
     void pause_broadcast()  { bcast_pause_.store(true,  std::memory_order_relaxed); }
     void resume_broadcast() { bcast_pause_.store(false, std::memory_order_relaxed); }
@@ -365,6 +394,7 @@ public:
 
 private:
     std::atomic<uint64_t> stat_rx_bytes_{0};  // 총 수신 바이트
+    int metrics_col_ = 0;                     // /metrics collector id (start~stop)
 
     char    host_name_[32] = {};
     uint8_t host_tier_     = 1;
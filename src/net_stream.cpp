@@ -1,17 +1,21 @@
 #include <ctime>
 #include "fft_viewer.hpp"
 #include "net_server.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 
 // ── 브로드캐스트 전용 스레드 ─────────────────────────────────────────────
 // 캡처 스레드에서 TCP send를 절대 호출하지 않도록 분리.
 // net_bcast_seq가 증가하면 깨어나서 최신 FFT 행을 복사 후 전송.
 void FFTViewer::net_bcast_worker(){
+    PipeStats::name_thread("net_bcast");
     int last_seq = -1;
     // 전송 버퍼 (로컬 복사 → send 중 data_mtx 불필요)
-    std::vector<float> local_fft;
+    std::vector<uint8_t> local_fft;
     uint64_t local_cf  = 0;
     uint32_t local_sr  = 0;
     float    local_min = -80.f, local_max = 0.f;
+    FftQuant::Scale local_rs;            // 복사한 행의 저장 스케일
     int      local_sz  = 0;
     int64_t  local_wt  = 0;
     int64_t  local_iq_pos = 0;
@@ -37,25 +41,30 @@ void FFTViewer::net_bcast_worker(){
         if(net_srv->client_count() == 0 && !net_srv->has_relay() && !net_srv->cb.on_relay_broadcast) continue;
         if(net_bcast_pause.load(std::memory_order_relaxed)) continue;
 
+        BEWE_TRACE_SCOPE_ARG("net", "row_emit", fft_size);   // 복사 + 전 client enqueue
         // 최신 FFT 행을 로컬 버퍼로 빠르게 복사 (data_mtx는 최소 시간만 점유)
         {
             std::lock_guard<std::mutex> lk(data_mtx);
             local_sz  = fft_size;
             local_cf  = header.center_frequency;
             local_sr  = header.sample_rate;
-            // 캡처 양자화 범위만 전송 (HOST 화면 스케일 아님 → JOIN 독립 스케일 유지)
+            int fi    = (current_fft_idx) % MAX_FFTS_MEMORY;
+            // 캡처 양자화 범위만 전송 (HOST 화면 스케일 아님 → JOIN 독립 스케일 유지).
+            // 저장 행은 행별 min/max 스케일 → 아래에서 이 범위로 재양자화.
             local_min = header.power_min;
             local_max = header.power_max;
+            local_rs  = fft_row_scale[fi];
             local_wt  = (int64_t)time(nullptr);
-            int fi    = (current_fft_idx) % MAX_FFTS_MEMORY;
             // 이 프레임을 생성한 시점의 HOST IQ 좌표 스냅샷
             local_iq_pos   = row_write_pos[fi];
             local_iq_total = tm_iq_total_samples;
-            const float* rowp = fft_data.data() + fi * fft_size;
             // assign() 대신 resize()+memcpy: fft_size 불변 시 heap 재할당 없음
             if((int)local_fft.size() != fft_size) local_fft.resize(fft_size);
-            memcpy(local_fft.data(), rowp, (size_t)fft_size * sizeof(float));
+            memcpy(local_fft.data(), fft_data.data() + (size_t)fi * fft_size, (size_t)fft_size);
         }
+        // 행 스케일 → wire 범위 (lock 밖, 제자리)
+        FftQuant::requantize(local_fft.data(), local_fft.data(), local_sz, local_rs,
+                             FftQuant::make_scale(local_min, local_max));
 
         // TCP 전송 (블로킹이어도 캡처 스레드와 무관)
         net_srv->broadcast_fft(local_fft.data(), local_sz,
@@ -0,0 +1,143 @@
+#include "pipe_stats.hpp"
+#include "config.hpp"
+#include <mutex>
+#include <deque>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace PipeStats {
+
+namespace {
+std::mutex          g_mtx;
+std::vector<Reader> g_readers;
+struct RecSlot {
+    std::string           id;
+    std::atomic<uint64_t> n{0};
+    explicit RecSlot(const char* s) : id(s){}
+};
+std::deque<RecSlot> g_records;          // deque → 추가해도 기존 슬롯 주소 불변
+
+// /proc/<...>/stat → comm, utime+stime (ticks). comm 은 괄호 안 (공백 포함 가능) → 마지막 ')' 기준.
+bool read_stat(const char* path, std::string& comm, uint64_t& ticks){
+    FILE* f = fopen(path, "r");
+    if(!f) return false;
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf)-1, f);
+    fclose(f);
+    buf[n] = 0;
+    char* l = strchr(buf, '(');
+    char* r = strrchr(buf, ')');
+    if(!l || !r || r < l) return false;
+    comm.assign(l+1, r-l-1);
+    // ')' 뒤: state(3) ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt utime(14) stime(15)
+    char* p = r + 2;
+    unsigned long long ut = 0, st = 0;
+    for(int field = 3; field <= 15 && *p; field++){
+        char* e = p;
+        while(*e && *e != ' ') e++;
+        if(field == 14) ut = strtoull(p, nullptr, 10);
+        if(field == 15) st = strtoull(p, nullptr, 10);
+        p = *e ? e + 1 : e;
+    }
+    ticks = ut + st;
+    return true;
+}
+
+double tick_s(){
+    static const double t = 1.0 / (double)sysconf(_SC_CLK_TCK);
+    return t;
+}
+} // namespace
+
+void reader_add(const std::atomic<size_t>* rp, const char* name){
+    Reader r; r.rp = rp;
+    strncpy(r.name, name ? name : "?", sizeof(r.name)-1);
+    std::lock_guard<std::mutex> lk(g_mtx);
+    g_readers.push_back(r);
+}
+
+void reader_del(const std::atomic<size_t>* rp){
+    std::lock_guard<std::mutex> lk(g_mtx);
+    for(size_t i = 0; i < g_readers.size(); i++)
+        if(g_readers[i].rp == rp){ g_readers.erase(g_readers.begin()+i); return; }
+}
+
+std::vector<Reader> readers(){
+    std::lock_guard<std::mutex> lk(g_mtx);
+    return g_readers;
+}
+
+size_t max_lag(size_t wp){
+    std::lock_guard<std::mutex> lk(g_mtx);
+    size_t m = 0;
+    for(auto& r : g_readers){
+        size_t lag = (wp - r.rp->load(std::memory_order_acquire)) & IQ_RING_MASK;
+        if(lag > m) m = lag;
+    }
+    return m;
+}
+
+std::vector<std::pair<std::string, size_t>> lags(size_t wp){
+    std::lock_guard<std::mutex> lk(g_mtx);
+    std::vector<std::pair<std::string, size_t>> out;
+    out.reserve(g_readers.size());
+    for(auto& r : g_readers)
+        out.emplace_back(r.name, (wp - r.rp->load(std::memory_order_acquire)) & IQ_RING_MASK);
+    return out;
+}
+
+void name_thread(const char* name){
+    char n[16]; strncpy(n, name, 15); n[15] = 0;
+    pthread_setname_np(pthread_self(), n);
+}
+
+ReaderScope::ReaderScope(const std::atomic<size_t>& r, const char* tag, int idx) : rp(&r){
+    char n[16]; snprintf(n, sizeof(n), "%s%d", tag, idx);
+    name_thread(n);
+    reader_add(rp, n);
+}
+
+std::atomic<uint64_t>* record_slot(const char* mod_id){
+    std::lock_guard<std::mutex> lk(g_mtx);
+    for(auto& r : g_records) if(r.id == mod_id) return &r.n;
+    g_records.emplace_back(mod_id);
+    return &g_records.back().n;
+}
+
+std::vector<std::pair<std::string, uint64_t>> records(){
+    std::lock_guard<std::mutex> lk(g_mtx);
+    std::vector<std::pair<std::string, uint64_t>> out;
+    out.reserve(g_records.size());
+    for(auto& r : g_records) out.emplace_back(r.id, r.n.load(std::memory_order_relaxed));
+    return out;
+}
+
+std::vector<ThreadCpu> thread_cpu(){
+    std::vector<ThreadCpu> out;
+    DIR* d = opendir("/proc/self/task");
+    if(!d) return out;
+    struct dirent* e;
+    while((e = readdir(d)) != nullptr){
+        if(e->d_name[0] == '.') continue;
+        char path[64]; snprintf(path, sizeof(path), "/proc/self/task/%s/stat", e->d_name);
+        ThreadCpu t; uint64_t ticks = 0;
+        if(!read_stat(path, t.name, ticks)) continue;
+        t.tid = atoi(e->d_name);
+        t.cpu_s = ticks * tick_s();
+        out.push_back(t);
+    }
+    closedir(d);
+    return out;
+}
+
+double process_cpu_s(){
+    std::string comm; uint64_t ticks = 0;
+    if(!read_stat("/proc/self/stat", comm, ticks)) return 0;
+    return ticks * tick_s();
+}
+
+} // namespace PipeStats
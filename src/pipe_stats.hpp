@@ -0,0 +1,49 @@
+#pragma once
+// ── 캡처 파이프라인 계측 (replay 벤치 리포트 / 운용 진단) ─────────────────
+//   ring reader 등록  : 워커가 자기 read-ptr 를 등록 → wp 대비 lag 측정
+//                       (replay 최대속도 모드는 이걸로 backpressure — 손실 없이 최대 처리량)
+//   record 카운터     : bewe_mod_emit 1회 = 디코드 레코드 1건 (모듈 id 별 atomic 슬롯, 1회 등록)
+//   스레드 CPU        : /proc/self/task/*/stat (utime+stime) — 스레드 이름은 ReaderScope/name_thread
+// 등록/해제는 워커 시작·종료 시 1회뿐이라 mutex. hot path 는 relaxed fetch_add 1회.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PipeStats {
+
+struct Reader {
+    const std::atomic<size_t>* rp = nullptr;
+    char name[16] = {};
+};
+
+void reader_add(const std::atomic<size_t>* rp, const char* name);
+void reader_del(const std::atomic<size_t>* rp);
+std::vector<Reader> readers();                 // snapshot
+size_t max_lag(size_t wp);                     // 등록 reader 중 최대 lag (samples), 없으면 0
+std::vector<std::pair<std::string, size_t>> lags(size_t wp);   // reader 이름별 lag (lock 안에서 계산)
+
+// 현재 스레드 이름 (15자 제한, 초과분 잘림)
+void name_thread(const char* name);
+
+// 워커 함수 진입부: rp 등록 + 스레드 이름 "<tag><idx>". 스코프 종료 시 해제.
+struct ReaderScope {
+    const std::atomic<size_t>* rp;
+    ReaderScope(const std::atomic<size_t>& r, const char* tag, int idx);
+    ~ReaderScope(){ reader_del(rp); }
+    ReaderScope(const ReaderScope&) = delete;
+    ReaderScope& operator=(const ReaderScope&) = delete;
+};
+
+// 디코드 레코드 카운터 — 모듈 id 별 슬롯 (주소 고정, 처음 1회만 lock). 호출자가 캐시해서
+//   slot->fetch_add(1, std::memory_order_relaxed);
+std::atomic<uint64_t>* record_slot(const char* mod_id);
+std::vector<std::pair<std::string, uint64_t>> records();
+
+// 프로세스 스레드별 누적 CPU (초)
+struct ThreadCpu { int tid = 0; std::string name; double cpu_s = 0; };
+std::vector<ThreadCpu> thread_cpu();
+double process_cpu_s();
+
+} // namespace PipeStats
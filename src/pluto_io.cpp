@@ -2,6 +2,9 @@
 #include "net_server.hpp"
 #include "bewe_paths.hpp"
 #include "long_waterfall.hpp"
+#include "metrics.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <volk/volk.h>
 #include <iio.h>
 #include <ad9361.h>
@@ -140,6 +143,7 @@ bool FFTViewer::initialize_pluto(float cf_mhz, float sr_msps){
 
 // ── 캡처 루프 ────────────────────────────────────────────────────────────
 void FFTViewer::capture_and_process_pluto(){
+    PipeStats::name_thread("cap_pluto");
     auto* rxd = (struct iio_device*)pluto_rx_dev;
     auto* phy = (struct iio_device*)pluto_phy_dev;
     auto* buf = (struct iio_buffer*)pluto_rx_buf;
@@ -227,14 +231,8 @@ void FFTViewer::capture_and_process_pluto(){
             bool tm_was_on = tm_iq_on.load(std::memory_order_relaxed);
             if(tm_was_on) tm_iq_on.store(false);
             tm_iq_close(); // fd 닫기 + 상태 초기화
-            // 기존 SR 롤링 파일 삭제 (SR 불일치 방지)
-            {
-                std::string tm_dir = BEWEPaths::time_temp_dir();
-                char old_path[256];
-                snprintf(old_path, sizeof(old_path), "%s/iq_rolling_%uMSPS.wav",
-                         tm_dir.c_str(), header.sample_rate/1000000);
-                if(access(old_path, F_OK)==0){ remove(old_path); }
-            }
+            // 기존 SR 롤링 파일 삭제 (SR 불일치 방지, raw/압축 둘 다)
+            tm_iq_remove_rolling(header.sample_rate);
 
             // 버퍼 재생성
             iio_buffer_destroy(buf);
@@ -284,7 +282,7 @@ void FFTViewer::capture_and_process_pluto(){
             rx_pos=0; rx_avail=0;
             texture_needs_recreate=true;
             // SR 변경 > 신호 크기 스케일이 달라질 수 있어 오토스케일 재트리거
-            autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
+            autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
             // TM IQ 재시작 (Pluto는 모든 SR 허용 — 고 SR은 USB2 드롭 감수)
             if(tm_was_on){
                 tm_iq_open();
@@ -317,7 +315,7 @@ void FFTViewer::capture_and_process_pluto(){
             live_cf_hz.store((uint64_t)(pending_cf*1e6), std::memory_order_release);
             LongWaterfall::request_rotate();
             bewe_log_push(0,"Freq > %.2f MHz\n", pending_cf);
-            autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
+            autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
             warmup_cnt=0;
             update_dem_by_freq(pending_cf);
             freq_req=false; freq_prog=false;
@@ -326,7 +324,13 @@ void FFTViewer::capture_and_process_pluto(){
 
         // ── RX ──
         if(rx_avail == 0){
+            static auto& m_rx      = Metrics::counter("bewe_sdr_rx_samples_total", "SDR samples received", "sdr=\"pluto\"");
+            static auto& m_rx_wait = Metrics::histogram("bewe_sdr_rx_wait_seconds", "Time blocked in SDR read call", "sdr=\"pluto\"", 1e-6);
+            BEWE_TRACE_SCOPE_ARG("cap", "rx", cur_buf_samps);
+            auto t_rx0 = std::chrono::steady_clock::now();
             ssize_t nbytes = iio_buffer_refill(buf);
+            m_rx_wait.observe((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now()-t_rx0).count());
             if(nbytes <= 0){
                 fprintf(stderr,"Pluto RX: refill=%zd - disconnected\n", nbytes);
                 sdr_stream_error.store(true);
@@ -351,17 +355,10 @@ void FFTViewer::capture_and_process_pluto(){
             if(!need_ring) for(int i=0;i<MAX_CHANNELS;i++) if(channels[i].dem_run.load()){need_ring=true;break;}
             bool need_tm = tm_iq_on.load(std::memory_order_relaxed) && (warmup_cnt>=WARMUP_FFTS);
             if(need_ring || need_tm){
-                size_t wp=ring_wp.load(std::memory_order_relaxed);
-                size_t nn=(size_t)n, cap=IQ_RING_CAPACITY;
-                if(wp+nn<=cap) memcpy(&ring[wp*2],iq16,nn*2*sizeof(int16_t));
-                else{
-                    size_t p1=cap-wp, p2=nn-p1;
-                    memcpy(&ring[wp*2],iq16,p1*2*sizeof(int16_t));
-                    memcpy(&ring[0],iq16+p1*2,p2*2*sizeof(int16_t));
-                }
-                ring_wp.store((wp+nn)&IQ_RING_MASK, std::memory_order_release);
+                iq_ring_write(iq16,(size_t)n);
                 if(need_tm) tm_iq_write(iq16, n);
             }
+            m_rx.inc((uint64_t)n);
             rx_pos=0; rx_avail=n;
         }
 
@@ -379,17 +376,7 @@ void FFTViewer::capture_and_process_pluto(){
                 fft_in[i][0] = (float)rp[i*2+0] * inv_scale;
                 fft_in[i][1] = (float)rp[i*2+1] * inv_scale;
             }
-            volk_32fc_32f_multiply_32fc((lv_32fc_t*)fft_in, (lv_32fc_t*)fft_in,
-                                        win_buf, fft_input_size);
-            fftwf_execute(fft_plan);
-            {
-                volk_32fc_magnitude_squared_32f(mag_sq_buf, (lv_32fc_t*)fft_out, fft_size);
-                const float scale=NUTTALL_WINDOW_CORRECTION/((float)fft_input_size*(float)fft_input_size);
-                for(int i=0;i<fft_size;i++){
-                    pacc[i] += mag_sq_buf[i]*scale + 1e-10f;
-                }
-            }
-            pacc[0]=(pacc[1]+pacc[fft_size-1])*0.5f; fcnt++;
+            fft_accumulate(pacc.data()); fcnt++;
             if(fcnt>=time_average){
                 if(warmup_cnt < WARMUP_FFTS){
                     warmup_cnt++;
@@ -397,64 +384,7 @@ void FFTViewer::capture_and_process_pluto(){
                     rx_pos+=fft_input_size; rx_avail-=fft_input_size;
                     continue;
                 }
-                int fi=total_ffts%MAX_FFTS_MEMORY;
-                float* rowp=fft_data.data()+fi*fft_size;
-                {std::lock_guard<std::mutex> lk(data_mtx);
-                 // current_spectrum은 UI 스레드 전용 > 캡처 쓰기 금지 (race 유발)
-                 for(int i=0;i<fft_size;i++){
-                     rowp[i]=10.0f*log10f(pacc[i]/fcnt);
-                 }
-                 // 비-캡처 스레드 요청 처리 (set_frequency/init) — 여기서만 autoscale 상태 변경 (레이스 X)
-                 if(autoscale_req.exchange(false)){
-                     autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
-                 }
-                 if(autoscale_active){
-                     if(!autoscale_init){
-                         size_t cap=(size_t)fft_size*100;
-                         if(autoscale_accum.size()!=cap) autoscale_accum.assign(cap,0.0f);
-                         autoscale_wp=0; autoscale_buf_full=false;
-                         autoscale_last=std::chrono::steady_clock::now();
-                         autoscale_init=true;
-                     }
-                     size_t cap=autoscale_accum.size();
-                     for(int i=1;i<fft_size;i++){
-                         autoscale_accum[autoscale_wp]=rowp[i];
-                         if(++autoscale_wp>=cap){ autoscale_wp=0; autoscale_buf_full=true; }
-                     }
-                     float el=std::chrono::duration<float>(std::chrono::steady_clock::now()-autoscale_last).count();
-                     if(el>=1.0f&&(autoscale_buf_full||autoscale_wp>0)){
-                         size_t nn=autoscale_buf_full?cap:autoscale_wp;
-                         std::vector<float> tmp(autoscale_accum.begin(),
-                                                autoscale_accum.begin()+(ptrdiff_t)nn);
-                         size_t idx_lo=(size_t)(nn*0.15f);
-                         std::nth_element(tmp.begin(),tmp.begin()+(ptrdiff_t)idx_lo,tmp.end());
-                         float noise=tmp[idx_lo];
-                         float peak=*std::max_element(tmp.begin(),tmp.end());
-                         display_power_min=noise-5.0f;
-                         display_power_max=peak+20.0f;
-                         if(display_power_max-display_power_min<20.f)
-                             display_power_max=display_power_min+20.f;
-                         header.power_min=display_power_min;
-                         header.power_max=display_power_max;
-                         bewe_log_push(0,"[autoscale] noise=%.1f peak=%.1f → pmin=%.1f pmax=%.1f\n",
-                             noise, peak, display_power_min, display_power_max);
-                         autoscale_active=false; autoscale_init=false;
-                         autoscale_wp=0; autoscale_buf_full=false;
-                         cached_sp_idx=-1;
-                     }
-                 }
-                 total_ffts++; current_fft_idx=total_ffts-1;
-                 header.num_ffts=std::min(total_ffts,MAX_FFTS_MEMORY);
-                 row_write_pos[current_fft_idx%MAX_FFTS_MEMORY]=tm_iq_write_sample;
-                 row_wall_ms[current_fft_idx%MAX_FFTS_MEMORY]=(int64_t)(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-                 if(tm_iq_on.load(std::memory_order_relaxed))
-                     tm_mark_rows(current_fft_idx%MAX_FFTS_MEMORY);
-                 else
-                     iq_row_avail[current_fft_idx%MAX_FFTS_MEMORY]=false;
-                 tm_add_time_tag(current_fft_idx);
-                 net_bcast_seq.fetch_add(1, std::memory_order_release);
-                 net_bcast_cv.notify_one();
-                }
+                fft_commit_row(pacc.data(), fcnt);
                 std::fill(pacc.begin(),pacc.end(),0.0f); fcnt=0;
             }
         }
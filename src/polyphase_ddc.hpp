@@ -0,0 +1,74 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Decimating DDC: float rotator mix-down + decimating FIR (header-only, VOLK).
+//
+//   mix    : volk rotator2 (float 위상 누산, 커널 내부 주기적 정규화) —
+//            per-sample sincos(double) 제거
+//   filter : 출력 시점(D 샘플마다)에만 T-tap 내적 (polyphase 분해와 동일 연산량:
+//            출력당 T MAC, 입력당 T/D). 지연 라인은 선형 버퍼라 내적이
+//            volk_32fc_32f_dot_prod_32fc SIMD 커널 한 번.
+//
+// prime() 은 출력 없이 지연 라인/위상만 진행 — 시간 slice 병렬 처리 시 앞 slice
+// 꼬리(T-1 샘플)로 상태를 맞춰 slice 경계에서도 연속 처리와 같은 출력을 낸다.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <volk/volk.h>
+
+class DecimDDC {
+public:
+    // taps: FIR 계수 (h[0] = 현재 샘플). decim ≥ 1.
+    // phase_inc: rad/sample (mix-down 은 e^{j·phase}), phase0: 첫 입력 샘플의 위상.
+    void init(const std::vector<float>& taps, int decim, double phase_inc, double phase0){
+        T_ = taps.empty() ? 1 : (int)taps.size();
+        D_ = decim < 1 ? 1 : decim;
+        taps_rev_.assign(taps.rbegin(), taps.rend());
+        if(taps_rev_.empty()) taps_rev_.assign(1, 1.0f);
+        line_.assign((size_t)(T_ - 1), lv_32fc_t(0.f, 0.f));
+        inc_   = lv_32fc_t((float)cos(phase_inc), (float)sin(phase_inc));
+        phase_ = lv_32fc_t((float)cos(phase0),    (float)sin(phase0));
+        cnt_   = 0;
+    }
+
+    int taps() const  { return T_; }
+    int decim() const { return D_; }
+
+    // 출력 없이 상태만 진행 (warm-up history).
+    void prime(const lv_32fc_t* in, int n){ push(in, n); keep_tail(n); }
+
+    // n 입력 → D 번째마다 출력 1개를 out 에 append.
+    void feed(const lv_32fc_t* in, int n, std::vector<lv_32fc_t>& out){
+        push(in, n);
+        const lv_32fc_t* base = line_.data();     // 입력 i 의 창 = base[i .. i+T-1]
+        const float*     h    = taps_rev_.data();
+        for(int i = 0; i < n; i++){
+            if(++cnt_ < D_) continue;
+            cnt_ = 0;
+            lv_32fc_t acc;
+            volk_32fc_32f_dot_prod_32fc(&acc, base + i, h, (unsigned)T_);
+            out.push_back(acc);
+        }
+        keep_tail(n);
+    }
+
+private:
+    // line_ = [T-1 history][n mixed new]
+    void push(const lv_32fc_t* in, int n){
+        size_t h = (size_t)(T_ - 1);
+        line_.resize(h + (size_t)n);
+        volk_32fc_s32fc_x2_rotator2_32fc(line_.data() + h, in, &inc_, &phase_, (unsigned)n);
+    }
+    void keep_tail(int n){
+        size_t h = (size_t)(T_ - 1);
+        if(h) memmove(line_.data(), line_.data() + n, h * sizeof(lv_32fc_t));
+        line_.resize(h);
+    }
+
+    int T_ = 1, D_ = 1, cnt_ = 0;
+    std::vector<float>     taps_rev_;
+    std::vector<lv_32fc_t> line_;
+    lv_32fc_t inc_{1.f, 0.f}, phase_{1.f, 0.f};
+};
@@ -0,0 +1,89 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Streaming dB quantile sketch (header-only).
+//
+// 고정 해상도 히스토그램 — 값을 저장하지 않고 bin count 만 누적하므로
+// 샘플 수와 무관하게 메모리 일정 (기본 -200..+60 dB / 0.1 dB = 2600 bin).
+// quantile 오차 ≤ res/2. 스레드별 sketch 를 merge() 로 합쳐 병렬 수집.
+// autoscale (행 전체 bin → 15% 분위 + max), squelch 캘리브레이션 (채널 peak → 20% 분위),
+// SA/EID 범위 추정 공용.
+// ─────────────────────────────────────────────────────────────────────────────
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+class QuantileSketch {
+public:
+    explicit QuantileSketch(float lo_db = -200.f, float hi_db = 60.f, float res_db = 0.1f)
+        : lo_(lo_db), res_(res_db), inv_res_(1.f / res_db),
+          bins_((size_t)std::ceil((hi_db - lo_db) / res_db), 0) {}
+
+    void clear(){ std::fill(bins_.begin(), bins_.end(), 0); n_ = 0; max_ = -INFINITY; }
+
+    void add(float db){
+        bins_[index(db)]++;
+        n_++;
+        if(db > max_) max_ = db;
+    }
+    void add(const float* v, int n){
+        float mx = max_;
+        for(int i = 0; i < n; i++){
+            bins_[index(v[i])]++;
+            if(v[i] > mx) mx = v[i];
+        }
+        n_ += (uint64_t)(n > 0 ? n : 0);
+        max_ = mx;
+    }
+    // 같은 범위/해상도 sketch 만 합칠 수 있음.
+    void merge(const QuantileSketch& o){
+        if(o.bins_.size() != bins_.size()) return;
+        for(size_t i = 0; i < bins_.size(); i++) bins_[i] += o.bins_[i];
+        n_ += o.n_;
+        if(o.max_ > max_) max_ = o.max_;
+    }
+
+    uint64_t count() const { return n_; }
+    float    max()   const { return max_; }      // 실제 최대값 (bin 양자화 없음), 비었으면 -inf
+
+    // q ∈ [0,1] → dB (bin 내부 선형 보간).
+    float quantile(double q) const {
+        if(n_ == 0) return lo_;
+        double target = q * (double)n_;
+        double acc = 0.0;
+        for(size_t i = 0; i < bins_.size(); i++){
+            double c = (double)bins_[i];
+            if(acc + c >= target && c > 0){
+                double f = (target - acc) / c;
+                return lo_ + ((float)i + (float)f) * res_;
+            }
+            acc += c;
+        }
+        return lo_ + (float)bins_.size() * res_;
+    }
+
+    // x 미만 값의 (보간된) 개수 — CDF / equalisation LUT 용.
+    double count_below(float x) const {
+        double pos = (x - lo_) * inv_res_;
+        if(pos <= 0.0) return 0.0;
+        size_t whole = (size_t)pos;
+        double acc = 0.0;
+        size_t lim = whole < bins_.size() ? whole : bins_.size();
+        for(size_t i = 0; i < lim; i++) acc += (double)bins_[i];
+        if(whole < bins_.size()) acc += (double)bins_[whole] * (pos - (double)whole);
+        return acc;
+    }
+
+private:
+    size_t index(float db) const {
+        float p = (db - lo_) * inv_res_;
+        if(!(p > 0.f)) return 0;                        // NaN 포함
+        size_t i = (size_t)p;
+        return i < bins_.size() ? i : bins_.size() - 1;
+    }
+
+    float                 lo_, res_, inv_res_;
+    std::vector<uint64_t> bins_;
+    uint64_t              n_ = 0;
+    float                 max_ = -INFINITY;
+};
@@ -2,6 +2,8 @@
 #include "bewe_paths.hpp"
 #include "login.hpp"
 #include "kst_time.hpp"
+#include "polyphase_ddc.hpp"
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <cmath>
@@ -10,6 +12,8 @@
 #include <ctime>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <thread>
 #include <chrono>
 
@@ -107,15 +111,140 @@ static void make_filename(char* out, size_t sz,
     }
 }
 
+
 // ─────────────────────────────────────────────────────────────────────────────
-// 영역 IQ 추출 및 WAV 저장
+// 영역 IQ 추출 엔진 (다중 영역 · 단일 파일 패스 · 시간 slice 병렬)
+//
+//   1. 영역마다 샘플 범위 / 데시메이션 / Kaiser 탭 / 출력 fd 를 ExtractJob 으로 확정
+//   2. 전체 범위 [U0,U1) 를 스레드 수만큼 시간 slice 로 분할
+//   3. slice 스레드는 롤링 파일을 CHUNK 단위로 한 번만 읽어 그 청크에 걸친 모든
+//      영역의 DecimDDC 에 공급 → 영역 수와 무관하게 파일은 1 pass
+//   4. slice 경계는 영역별 데시메이션 격자(s + k·D)로 스냅하고 직전 T-1 샘플로
+//      warm-up → 출력이 단일 스레드 연속 처리와 같다. 출력 위치가 결정적이라
+//      slice 마다 pwrite 로 제자리 기록 (slice 간 순서 맞출 필요 없음)
+// ─────────────────────────────────────────────────────────────────────────────
+namespace {
+
+constexpr int     EXTRACT_CHUNK        = 65536;       // 샘플
+constexpr int64_t SLICE_MIN_SAMPS      = 1LL << 22;   // slice 1개 최소 길이 (~68 ms @61.44M)
+constexpr int     EXTRACT_MAX_THR      = 8;
+constexpr int     REGION_BATCH_WAIT_MS = 150;         // 동시에 들어온 JOIN 요청을 모으는 시간
+
+struct ExtractJob {
+    int64_t s = 0, e = 0;              // 입력 샘플 범위 (링 절대 좌표)
+    int     decim = 1;
+    double  phase_inc = 0.0;           // rad/sample (mix-down)
+    std::vector<float> taps;
+    int     out_fd = -1;
+    std::atomic<int64_t> written{0};   // 출력 샘플 수
+    std::atomic<bool>    io_err{false};
+};
+using JobList = std::vector<std::unique_ptr<ExtractJob>>;
+
+// x 를 job 의 데시메이션 격자로 올림 스냅 (결과 ∈ [s, e]).
+int64_t snap_up(const ExtractJob& j, int64_t x){
+    if(x <= j.s) return j.s;
+    if(x >= j.e) return j.e;
+    int64_t k = (x - j.s + j.decim - 1) / j.decim;
+    return std::min(j.e, j.s + k * j.decim);
+}
+
+void run_slice(const FFTViewer* v, const JobList& jobs, int64_t a, int64_t b){
+    struct Local { ExtractJob* j; int64_t la, lb, out_idx; DecimDDC ddc; };
+    std::vector<Local>     act;
+    std::vector<int16_t>   raw;
+    std::vector<lv_32fc_t> cf, out;
+    std::vector<int16_t>   o16;
+
+    int64_t r0 = INT64_MAX, r1 = INT64_MIN;
+    for(const auto& jp : jobs){
+        ExtractJob& j = *jp;
+        int64_t la = snap_up(j, a), lb = snap_up(j, b);
+        if(lb <= la) continue;
+        Local L{&j, la, lb, (la - j.s) / j.decim, DecimDDC{}};
+        // slice 중간 시작이면 직전 T-1 샘플로 지연 라인·위상 warm-up
+        int64_t hist = std::min((int64_t)j.taps.size() - 1, la - j.s);
+        double  ph0  = std::fmod(j.phase_inc * (double)(la - hist - j.s), 2.0 * M_PI);
+        L.ddc.init(j.taps, j.decim, j.phase_inc, ph0);
+        if(hist > 0){
+            raw.resize((size_t)hist * 2);
+            cf.resize((size_t)hist);
+            v->tm_iq_read(la - hist, (int)hist, raw.data());
+            volk_16i_s32f_convert_32f((float*)cf.data(), raw.data(), 32768.0f, (unsigned)(hist * 2));
+            L.ddc.prime(cf.data(), (int)hist);
+        }
+        act.push_back(std::move(L));
+        r0 = std::min(r0, la);
+        r1 = std::max(r1, lb);
+    }
+    if(act.empty()) return;
+
+    raw.resize((size_t)EXTRACT_CHUNK * 2);
+    cf.resize((size_t)EXTRACT_CHUNK);
+    for(int64_t pos = r0; pos < r1; pos += EXTRACT_CHUNK){
+        int64_t c1 = std::min(pos + EXTRACT_CHUNK, r1);
+        // 이 청크에서 필요한 구간만 읽음 (영역 사이 빈 구간은 건너뜀)
+        int64_t n0 = c1, n1 = pos;
+        for(const Local& L : act){
+            n0 = std::min(n0, std::max(pos, L.la));
+            n1 = std::max(n1, std::min(c1, L.lb));
+        }
+        if(n1 <= n0) continue;
+        int n = (int)(n1 - n0);
+        v->tm_iq_read(n0, n, raw.data());
+        volk_16i_s32f_convert_32f((float*)cf.data(), raw.data(), 32768.0f, (unsigned)(n * 2));
+
+        for(Local& L : act){
+            int64_t f0 = std::max(n0, L.la), f1 = std::min(n1, L.lb);
+            if(f1 <= f0) continue;
+            out.clear();
+            L.ddc.feed(cf.data() + (f0 - n0), (int)(f1 - f0), out);
+            if(out.empty()) continue;
+            o16.resize(out.size() * 2);
+            volk_32f_s32f_convert_16i(o16.data(), (const float*)out.data(), 32767.0f,
+                                      (unsigned)(out.size() * 2));
+            ssize_t bytes = (ssize_t)(o16.size() * sizeof(int16_t));
+            if(pwrite(L.j->out_fd, o16.data(), (size_t)bytes,
+                      (off_t)L.out_idx * 2 * (off_t)sizeof(int16_t)) != bytes)
+                L.j->io_err.store(true);
+            L.out_idx += (int64_t)out.size();
+            L.j->written.fetch_add((int64_t)out.size());
+        }
+    }
+}
+
+// 모든 job 을 1 pass 로 처리. 범위가 충분히 길면 시간 slice 를 스레드로 분산.
+void extract_pass(const FFTViewer* v, const JobList& jobs){
+    int64_t u0 = INT64_MAX, u1 = INT64_MIN;
+    for(const auto& j : jobs){ u0 = std::min(u0, j->s); u1 = std::max(u1, j->e); }
+    if(u1 <= u0) return;
+    int64_t  span = u1 - u0;
+    unsigned hw   = std::thread::hardware_concurrency();
+    // 캡처/FFT 스레드 몫은 남겨 둠
+    int n_thr = std::max(1, std::min(EXTRACT_MAX_THR, (int)(hw / 2)));
+    int n_sl  = (int)std::min((int64_t)n_thr, std::max((int64_t)1, span / SLICE_MIN_SAMPS));
+    if(n_sl <= 1){ run_slice(v, jobs, u0, u1); return; }
+    std::vector<std::thread> th;
+    th.reserve((size_t)n_sl);
+    for(int k = 0; k < n_sl; k++){
+        int64_t a = u0 + span * k / n_sl;
+        int64_t b = (k == n_sl - 1) ? u1 : u0 + span * (k + 1) / n_sl;
+        th.emplace_back([=, &jobs](){ run_slice(v, jobs, a, b); });
+    }
+    for(auto& t : th) t.join();
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// 영역 IQ 추출 및 저장
 //
 // 알고리즘:
-//   1. fft 행 인덱스 → 롤링 파일 샘플 오프셋 변환
-//   2. 롤링 파일에서 원시 IQ (61.44 MSPS int16) 읽기
-//   3. 주파수 mix-down: e^(-j2π*offset*n/sr) 곱셈
-//   4. 박스필터 + 데시메이션 → 출력 샘플레이트 ≈ bw_hz
-//   5. WAV 저장
+//   1. fft 행 인덱스 / 시각 / HOST 샘플 좌표 → 롤링 파일 샘플 범위
+//   2. 롤링 파일에서 원시 IQ (61.44 MSPS int16) 읽기 — 배치 전체 1 pass
+//   3. 주파수 mix-down: float rotator (VOLK)
+//   4. Kaiser FIR 데시메이션 (출력 시점만 내적) → 출력 샘플레이트 ≈ bw_hz
+//   5. raw IQ(.sigmf-data) 저장
 // ─────────────────────────────────────────────────────────────────────────────
 void FFTViewer::region_save(){
     if(!region.active){ return; }
@@ -142,117 +271,85 @@ void FFTViewer::region_save(){
 }
 
 std::string FFTViewer::do_region_save_work(){
+    return do_region_save_batch({region})[0];
+}
+
+// JOIN 요청: 큐에 넣고 future 로 경로를 받는다. REGION_BATCH_WAIT_MS 안에 모인
+// 요청은 한 배치(롤링 파일 1 pass)로 처리된다.
+std::future<std::string> FFTViewer::region_save_enqueue(const RegionSel& r){
+    std::promise<std::string> p;
+    std::future<std::string> f = p.get_future();
+    bool spawn;
+    {
+        std::lock_guard<std::mutex> lk(region_q_mtx);
+        region_q.emplace_back(r, std::move(p));
+        spawn = !region_q_worker;
+        region_q_worker = true;
+    }
+    if(spawn) std::thread([this](){ region_q_drain(); }).detach();
+    return f;
+}
+
+void FFTViewer::region_q_drain(){
+    for(;;){
+        std::this_thread::sleep_for(std::chrono::milliseconds(REGION_BATCH_WAIT_MS));
+        for(int w=0;w<200&&rec_busy_flag.load();w++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::vector<std::pair<RegionSel, std::promise<std::string>>> batch;
+        {
+            std::lock_guard<std::mutex> lk(region_q_mtx);
+            if(region_q.empty()){ region_q_worker = false; return; }
+            batch.swap(region_q);
+        }
+        rec_busy_flag.store(true);
+        rec_state = REC_BUSY;
+        rec_anim_timer = 0.0f;
+        std::vector<RegionSel> regs;
+        regs.reserve(batch.size());
+        for(auto& b : batch) regs.push_back(b.first);
+        std::vector<std::string> paths = do_region_save_batch(regs);
+        rec_state = REC_SUCCESS;
+        rec_success_timer = 3.0f;
+        rec_busy_flag.store(false);
+        for(size_t i = 0; i < batch.size(); i++) batch[i].second.set_value(paths[i]);
+    }
+}
+
+std::vector<std::string> FFTViewer::do_region_save_batch(const std::vector<RegionSel>& regs, bool archive){
+    std::vector<std::string> paths(regs.size());
     uint32_t sr=header.sample_rate;          // 61440000
     int64_t  max_total=tm_iq_total_samples;
 
     if(!tm_iq_file_ready || tm_iq_fd < 0 || max_total <= 0){
         bewe_log_push(0,"[region_save] FAIL: IQ ring not ready (ready=%d fd=%d total=%lld)\n",
                       (int)tm_iq_file_ready, tm_iq_fd, (long long)max_total);
-        return "";
+        return paths;
     }
-
-    // ── 주파수 계산 ───────────────────────────────────────────────────────
-    float cf_abs_mhz=(region.freq_lo+region.freq_hi)*0.5f;
-    float bw_mhz    = region.freq_hi - region.freq_lo;
-    float bw_khz    = bw_mhz * 1000.0f;
-    float tune_mhz  = (float)(header.center_frequency/1e6);
-    float offset_hz = (cf_abs_mhz - tune_mhz) * 1e6f; // mix-down 오프셋
-
-    // 데시메이션 비율: sr / bw_hz (정수)
-    uint32_t bw_hz = (uint32_t)(bw_mhz * 1e6f);
-    if(bw_hz < 1000) bw_hz = 1000;
-    int decim = std::max(1, (int)((float)sr / (float)bw_hz));
-    uint32_t out_sr = sr / decim;
-
-    // Kaiser FIR LPF (데시메이션 비율에 따라 탭 수·beta 결정)
-    // 컷오프: 0.45/decim (Nyquist의 90% → alias 억압 충분)
-    // 탭 수: 최소 31, 데시메이션이 클수록 더 많은 탭 필요
-    std::vector<float> fir_taps;
-    std::vector<float> fir_state; // 지연 라인
-    if(decim > 1){
-        int ntaps = std::max(31, decim * 8 + 1);
-        if(ntaps % 2 == 0) ntaps++;              // 홀수 탭 유지
-        ntaps = std::min(ntaps, 1023);           // 상한 제한
-        double cutoff_norm = 0.45 / decim;
-        double beta = 8.0;                       // ~58dB stopband
-        fir_taps  = make_kaiser_lpf(ntaps, cutoff_norm, beta);
-        fir_state.assign((ntaps - 1) * 2, 0.0f); // 지연 라인 초기화 (I,Q 쌍)
-    }
-
-    // ── fft 행 인덱스 → 롤링 파일 샘플 위치 직접 참조 ──────────────────
     // row_write_pos[fi % MAX_FFTS_MEMORY] = 그 행이 끝나는 IQ 샘플 위치
     // time_t 기반 변환(초단위 오차)을 제거하고 row_write_pos 직접 사용
     if(tm_iq_write_sample <= 0){
         bewe_log_push(0,"[region_save] FAIL: tm_iq not started (write_sample=0)\n");
-        return "";
+        return paths;
     }
 
-    // fft_top = 영역 위쪽(더 최근), fft_bot = 아래쪽(더 오래됨)
-    // row_write_pos[top] = top 행 끝 IQ 샘플 위치 → samp_end 기준
-    // row_write_pos[bot] = bot 행 끝 IQ 샘플 위치 → samp_start 기준
     int64_t snap_write = tm_iq_write_sample;
     time_t  snap_now   = time(nullptr);
-    int64_t max_cap    = max_total;
+    // 롤링 버퍼에 남아 있는 범위 (raw: 고정 60 s, 압축: 블록 index 의 가장 오래된 블록)
+    int64_t valid_start = tm_iq_valid_start(snap_write);
+    float   tune_mhz   = (float)(header.center_frequency/1e6);
 
     auto row_to_samp = [&](int fft_idx) -> int64_t {
         int slot = fft_idx % MAX_FFTS_MEMORY;
         int64_t pos = row_write_pos[slot];
-        // row_write_pos가 0이면 아직 기록 안 됨 → snap_write 기반 fallback
+        // row_write_pos가 0이면 아직 기록 안 됨 → 시각 기반 fallback
         if(pos <= 0) return -1;
         return pos;
     };
-
-    int64_t samp_start = -1, samp_end = -1;
-
-    if(region.samp_start > 0 && region.samp_end > 0){
-        // HOST IQ 좌표 직접 지정 (JOIN이 row_write_pos 기반으로 계산) → 지연 0
-        samp_start = region.samp_start;
-        samp_end   = region.samp_end;
-    } else if(region.time_start_ms > 0 && region.time_end_ms > 0){
-        // 절대 wall_time_ms → 샘플 위치 (JOIN 요청 시 가장 정확, ms 정밀도)
+    auto ts2samp_ms = [&](int64_t ts_ms) -> int64_t {
         int64_t snap_now_ms = (int64_t)snap_now * 1000LL;
-        samp_start = snap_write - (snap_now_ms - region.time_start_ms) * (int64_t)sr / 1000LL;
-        samp_end   = snap_write - (snap_now_ms - region.time_end_ms)   * (int64_t)sr / 1000LL;
-    } else {
-        // row_write_pos 기반 (HOST 자체 요청)
-        samp_end   = row_to_samp(region.fft_top);
-        samp_start = row_to_samp(region.fft_bot);
-        if(samp_end < 0 || samp_start < 0){
-            // row_wall_ms 사용 (ms 정밀도 fallback)
-            auto ts2samp_ms = [&](int64_t ts_ms) -> int64_t {
-                int64_t snap_now_ms = (int64_t)snap_now * 1000LL;
-                return snap_write - (snap_now_ms - ts_ms) * (int64_t)sr / 1000LL;
-            };
-            if(samp_start < 0) samp_start = (region.time_start_ms > 0) ? ts2samp_ms(region.time_start_ms) : -1;
-            if(samp_end   < 0) samp_end   = (region.time_end_ms > 0) ? ts2samp_ms(region.time_end_ms) : -1;
-        }
-    }
-
-    if(samp_start > samp_end) std::swap(samp_start, samp_end);
-
-    // 롤링 파일 유효 범위 클램프
-    int64_t valid_start = (snap_write >= max_cap) ? snap_write - max_cap : 0;
-    samp_start = std::max(samp_start, valid_start);
-    samp_end   = std::min(samp_end,   snap_write);
-
-    bewe_log_push(0,"[region_save] samp_start=%lld samp_end=%lld snap_write=%lld valid_start=%lld max_total=%lld sr=%u decim=%d\n",
-                   (long long)samp_start,(long long)samp_end,
-                   (long long)snap_write,(long long)valid_start,
-                   (long long)max_total, sr, decim);
-    bewe_log_push(0,"[region_save] n_in=%lld n_out=%lld sec=%.1f fft_top=%d fft_bot=%d\n",
-                   (long long)(samp_end-samp_start), (long long)((samp_end-samp_start)/decim),
-                   (double)(samp_end-samp_start)/(double)sr,
-                   region.fft_top, region.fft_bot);
-    if(samp_end <= samp_start){
-        bewe_log_push(0,"[region_save] FAIL: no valid IQ data in range\n");
-        return "";
-    }
-
-    int64_t n_in = samp_end - samp_start;
-    int64_t n_out = n_in / decim;
-    if(n_out < 1){ return ""; }
+        return snap_write - (snap_now_ms - ts_ms) * (int64_t)sr / 1000LL;
+    };
 
-    // ── 출력 파일 열기 ─────────────────────────────────────────────────────
     // 미션 활성이면 missions/<station>/<year>/<code>/iq/ 디렉토리 체인 mkdir.
     std::string st_for_mission = mission_station_name[0] ? mission_station_name : "_unknown_";
     if(mission_year > 0 && mission_code[0]){
@@ -265,170 +362,202 @@ std::string FFTViewer::do_region_save_work(){
         mkdir(BEWEPaths::record_dir().c_str(), 0755);
         mkdir(BEWEPaths::record_iq_dir().c_str(), 0755);
     }
-    char outpath[512];
-    make_filename(outpath, sizeof(outpath),
-                  cf_abs_mhz, bw_khz,
-                  region.time_start_ms / 1000, region.time_end_ms / 1000,
-                  mission_year, mission_code, mission_station_name,
-                  station_name.c_str());
-    FILE* wf = fopen(outpath, "wb");
-    if(!wf){
-        bewe_log_push(0,"[region_save] FAIL: fopen failed: %s\n", outpath);
-        return "";
+
+    struct Out { size_t idx; float cf_abs_mhz, bw_khz; uint32_t out_sr; int64_t n_out; std::string path; };
+    JobList          jobs;
+    std::vector<Out> outs;
+
+    for(size_t ri = 0; ri < regs.size(); ri++){
+        const RegionSel& rg = regs[ri];
+
+        // ── 주파수 계산 ───────────────────────────────────────────────────
+        float cf_abs_mhz=(rg.freq_lo+rg.freq_hi)*0.5f;
+        float bw_mhz    = rg.freq_hi - rg.freq_lo;
+        float bw_khz    = bw_mhz * 1000.0f;
+        float offset_hz = (cf_abs_mhz - tune_mhz) * 1e6f; // mix-down 오프셋
+
+        // 데시메이션 비율: sr / bw_hz (정수)
+        uint32_t bw_hz = (uint32_t)(bw_mhz * 1e6f);
+        if(bw_hz < 1000) bw_hz = 1000;
+        int decim = std::max(1, (int)((float)sr / (float)bw_hz));
+        uint32_t out_sr = sr / decim;
+
+        // ── 샘플 범위 ─────────────────────────────────────────────────────
+        // fft_top = 영역 위쪽(더 최근) → samp_end, fft_bot = 아래쪽(더 오래됨) → samp_start
+        int64_t samp_start = -1, samp_end = -1;
+        if(rg.samp_start > 0 && rg.samp_end > 0){
+            // HOST IQ 좌표 직접 지정 (JOIN이 row_write_pos 기반으로 계산) → 지연 0
+            samp_start = rg.samp_start;
+            samp_end   = rg.samp_end;
+        } else if(rg.time_start_ms > 0 && rg.time_end_ms > 0){
+            // 절대 wall_time_ms → 샘플 위치 (JOIN 요청 시 가장 정확, ms 정밀도)
+            samp_start = ts2samp_ms(rg.time_start_ms);
+            samp_end   = ts2samp_ms(rg.time_end_ms);
+        } else {
+            // row_write_pos 기반 (HOST 자체 요청)
+            samp_end   = row_to_samp(rg.fft_top);
+            samp_start = row_to_samp(rg.fft_bot);
+            if(samp_start < 0) samp_start = (rg.time_start_ms > 0) ? ts2samp_ms(rg.time_start_ms) : -1;
+            if(samp_end   < 0) samp_end   = (rg.time_end_ms > 0) ? ts2samp_ms(rg.time_end_ms) : -1;
+        }
+        if(samp_start > samp_end) std::swap(samp_start, samp_end);
+
+        // 롤링 파일 유효 범위 클램프
+        samp_start = std::max(samp_start, valid_start);
+        samp_end   = std::min(samp_end,   snap_write);
+
+        bewe_log_push(0,"[region_save] samp_start=%lld samp_end=%lld snap_write=%lld valid_start=%lld max_total=%lld sr=%u decim=%d\n",
+                       (long long)samp_start,(long long)samp_end,
+                       (long long)snap_write,(long long)valid_start,
+                       (long long)max_total, sr, decim);
+        bewe_log_push(0,"[region_save] n_in=%lld n_out=%lld sec=%.1f fft_top=%d fft_bot=%d\n",
+                       (long long)(samp_end-samp_start), (long long)((samp_end-samp_start)/decim),
+                       (double)(samp_end-samp_start)/(double)sr,
+                       rg.fft_top, rg.fft_bot);
+        if(samp_end <= samp_start){
+            bewe_log_push(0,"[region_save] FAIL: no valid IQ data in range\n");
+            continue;
+        }
+        int64_t n_out = (samp_end - samp_start) / decim;
+        if(n_out < 1) continue;
+
+        // ── 출력 파일 ─────────────────────────────────────────────────────
+        char outpath[512];
+        make_filename(outpath, sizeof(outpath),
+                      cf_abs_mhz, bw_khz,
+                      rg.time_start_ms / 1000, rg.time_end_ms / 1000,
+                      mission_year, mission_code, mission_station_name,
+                      station_name.c_str());
+        // 같은 배치에서 cf/시각이 같은 영역 → 파일명 충돌 방지
+        std::string path = outpath;
+        for(int dup = 2; ; dup++){
+            bool clash = false;
+            for(const Out& o : outs) if(o.path == path){ clash = true; break; }
+            if(!clash) break;
+            std::string p0 = outpath;
+            size_t dot = p0.rfind(".sigmf-data");
+            path = p0.substr(0, dot) + "_" + std::to_string(dup) + p0.substr(dot);
+        }
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0){
+            bewe_log_push(0,"[region_save] FAIL: open failed: %s\n", path.c_str());
+            continue;
+        }
+        // raw IQ(.sigmf-data): 헤더 없음. 출력 크기를 미리 잡아 slice 들이 제자리 pwrite.
+        if(ftruncate(fd, (off_t)n_out * 2 * (off_t)sizeof(int16_t)) != 0)
+            bewe_log_push(0,"[region_save] ftruncate failed: %s\n", path.c_str());
+
+        auto j = std::make_unique<ExtractJob>();
+        j->s = samp_start;
+        j->e = samp_end;
+        j->decim = decim;
+        j->phase_inc = -2.0 * M_PI * (double)offset_hz / (double)sr;
+        // Kaiser FIR LPF (데시메이션 비율에 따라 탭 수·beta 결정)
+        // 컷오프: 0.45/decim (Nyquist의 90% → alias 억압 충분)
+        // 탭 수: 최소 31, 데시메이션이 클수록 더 많은 탭 필요
+        if(decim > 1){
+            int ntaps = std::max(31, decim * 8 + 1);
+            if(ntaps % 2 == 0) ntaps++;              // 홀수 탭 유지
+            ntaps = std::min(ntaps, 1023);           // 상한 제한
+            double cutoff_norm = 0.45 / decim;
+            double beta = 8.0;                       // ~58dB stopband
+            j->taps = make_kaiser_lpf(ntaps, cutoff_norm, beta);
+        } else {
+            j->taps.assign(1, 1.0f);                 // 데시메이션 없음 → mix-down 만
+        }
+        j->out_fd = fd;
+        jobs.push_back(std::move(j));
+        outs.push_back({ri, cf_abs_mhz, bw_khz, out_sr, n_out, path});
     }
-    // raw IQ(.sigmf-data): 헤더 없이 데이터부터 기록. 메타는 아래 write_default_info_file.
-
-    // ── 청크 단위 읽기 + mix-down + decimate + 저장 ───────────────────────
-    const int CHUNK = 65536; // 샘플 단위
-    std::vector<int16_t> in_buf(CHUNK * 2);
-    std::vector<int16_t> out_buf;
-    out_buf.reserve(CHUNK / decim * 2 + 4);
-
-    double phase = 0.0;
-    double phase_inc = -2.0 * M_PI * (double)offset_hz / (double)sr;
-
-    int64_t actual_out = 0;
-    int64_t pos = samp_start;
-
-    // FIR 지연 라인 인덱스 및 입력 카운터 (데시메이션용)
-    int fir_ntaps   = fir_taps.empty() ? 0 : (int)fir_taps.size();
-    int fir_dly_pos = 0;  // 순환 버퍼 인덱스
-    int decim_cnt   = 0;  // 데시메이션 카운터
-
-    while(pos < samp_end){
-        int64_t file_pos = pos % max_total;
-        int     to_read  = (int)std::min((int64_t)CHUNK, samp_end - pos);
-        // 파일 끝 넘어가면 두 번 읽기
-        int64_t avail = max_total - file_pos;
-        int     r1 = (int)std::min((int64_t)to_read, avail);
-        int     r2 = to_read - r1;
-
-        static constexpr off_t WAV_HDR_SIZE = 44;
-        off_t off1 = WAV_HDR_SIZE + file_pos*2*(off_t)sizeof(int16_t);
-        pread(tm_iq_fd, in_buf.data(),        (size_t)r1*2*sizeof(int16_t), off1);
-        if(r2 > 0)
-            pread(tm_iq_fd, in_buf.data()+r1*2, (size_t)r2*2*sizeof(int16_t), WAV_HDR_SIZE);
-
-        out_buf.clear();
-        for(int i=0; i<to_read; i++){
-            float si = in_buf[i*2  ] / 32768.0f;
-            float sq = in_buf[i*2+1] / 32768.0f;
-
-            // Mix-down (sincos: sin/cos 동시 계산 — 결과는 개별 호출과 동일)
-            double sp_d, cp_d;
-            sincos(phase, &sp_d, &cp_d);
-            float cp = (float)cp_d;
-            float sp = (float)sp_d;
-            float mi = si*cp - sq*sp;
-            float mq = si*sp + sq*cp;
-            phase += phase_inc;
-            if(phase >  M_PI) phase -= 2.0*M_PI;
-            if(phase < -M_PI) phase += 2.0*M_PI;
-
-            if(decim <= 1){
-                // 데시메이션 없음 → 그대로 출력
-                int16_t wi = (int16_t)(std::max(-1.0f,std::min(1.0f,mi))*32767.0f);
-                int16_t wq = (int16_t)(std::max(-1.0f,std::min(1.0f,mq))*32767.0f);
-                out_buf.push_back(wi);
-                out_buf.push_back(wq);
-                actual_out++;
-            } else {
-                // Kaiser FIR LPF → 데시메이션
-                // 지연 라인에 새 복소수 샘플 삽입 (I와 Q 각각 별도 처리, 같은 지연 라인 공유 불가)
-                // → 지연 라인을 복소수(I,Q 쌍)로 관리
-                // fir_state: [I0,Q0, I1,Q1, ...] 크기 = (ntaps-1)*2
-                int dly_idx = fir_dly_pos * 2;
-                fir_state[dly_idx    ] = mi;
-                fir_state[dly_idx + 1] = mq;
-                fir_dly_pos = (fir_dly_pos + 1) % (fir_ntaps - 1);
-
-                decim_cnt++;
-                if(decim_cnt >= decim){
-                    decim_cnt = 0;
-                    // FIR 합성: 현재 샘플 포함 ntaps개
-                    float oi = mi * fir_taps[0];
-                    float oq = mq * fir_taps[0];
-                    int dly_sz = fir_ntaps - 1;
-                    int j = fir_dly_pos - 1;  // 방금 삽입한 샘플 위치 (감소-and-wrap, modulo 제거)
-                    if(j < 0) j += dly_sz;
-                    for(int t = 1; t < fir_ntaps; t++){
-                        if(--j < 0) j += dly_sz;
-                        int idx = j * 2;
-                        oi += fir_state[idx    ] * fir_taps[t];
-                        oq += fir_state[idx + 1] * fir_taps[t];
-                    }
-                    int16_t wi = (int16_t)(std::max(-1.0f,std::min(1.0f,oi))*32767.0f);
-                    int16_t wq = (int16_t)(std::max(-1.0f,std::min(1.0f,oq))*32767.0f);
-                    out_buf.push_back(wi);
-                    out_buf.push_back(wq);
-                    actual_out++;
+    if(jobs.empty()) return paths;
+
+    // ── 롤링 파일 1 pass: mix-down + decimate + 저장 ─────────────────────
+    auto t0 = std::chrono::steady_clock::now();
+    extract_pass(this, jobs);
+    double el = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    bewe_log_push(0,"[region_save] %zu region(s) extracted in one pass (%.2f s)\n", jobs.size(), el);
+
+    for(size_t k = 0; k < jobs.size(); k++){
+        ExtractJob& j = *jobs[k];
+        const Out&  o = outs[k];
+        const RegionSel& rg = regs[o.idx];
+        const char* outpath = o.path.c_str();
+        close(j.out_fd);
+        if(j.io_err.load()){
+            bewe_log_push(0,"[region_save] FAIL: write error: %s\n", outpath);
+            unlink(outpath);
+            continue;
+        }
+        int64_t actual_out = j.written.load();
+        bewe_log_push(0,"Region IQ saved: %s  (%.1f sec  %.0f kHz SR)\n",
+               outpath, (double)actual_out/o.out_sr, (double)o.out_sr/1000.0);
+
+        // trigger pin 보존: 전송/SA 흐름 없이 파일 + .info 만
+        if(archive){
+            double duration_sec = (o.out_sr > 0) ? (double)o.n_out / (double)o.out_sr : 0.0;
+            write_default_info_file(outpath, recorder_name(),
+                                    o.cf_abs_mhz, (double)o.bw_khz, duration_sec,
+                                    "", login_get_id(), station_name.c_str(),
+                                    rg.time_start_ms / 1000LL,
+                                    utc_offset_hours(), o.out_sr);
+            paths[o.idx] = o.path;
+            continue;
+        }
+        // file_xfers에 추가
+        {
+            std::lock_guard<std::mutex> lk(file_xfer_mtx);
+            bool updated=false;
+            for(auto& xf : file_xfers){
+                if(!xf.finished){
+                    xf.filename  = (strrchr(outpath,'/')?strrchr(outpath,'/')+1:outpath);
+                    xf.local_path= outpath;
+                    xf.finished  = true;
+                    xf.is_sa     = true;
+                    updated=true; break;
                 }
             }
-        }
-        if(!out_buf.empty())
-            fwrite(out_buf.data(), sizeof(int16_t), out_buf.size(), wf);
-
-        pos += to_read;
-    }
-
-    fclose(wf);
-
-    bewe_log_push(0,"Region IQ saved: %s  (%.1f sec  %.0f kHz SR)\n",
-           outpath, (double)actual_out/out_sr, (double)out_sr/1000.0);
-
-    // file_xfers에 추가
-    {
-        std::lock_guard<std::mutex> lk(file_xfer_mtx);
-        bool updated=false;
-        for(auto& xf : file_xfers){
-            if(!xf.finished){
-                xf.filename  = (strrchr(outpath,'/')?strrchr(outpath,'/')+1:outpath);
-                xf.local_path= outpath;
-                xf.finished  = true;
-                xf.is_sa     = true;
-                updated=true; break;
+            if(!updated){
+                FileXfer xf{};
+                xf.filename   = (strrchr(outpath,'/')?strrchr(outpath,'/')+1:outpath);
+                xf.local_path = outpath;
+                xf.finished   = true;
+                xf.is_sa      = true;
+                file_xfers.push_back(xf);
             }
         }
-        if(!updated){
-            FileXfer xf{};
-            xf.filename   = (strrchr(outpath,'/')?strrchr(outpath,'/')+1:outpath);
-            xf.local_path = outpath;
-            xf.finished   = true;
-            xf.is_sa      = true;
-            file_xfers.push_back(xf);
+        // rec_entries에 완료 항목 추가 (SA 모드 아닌 경우만)
+        if(!sa_mode){
+            std::lock_guard<std::mutex> lk(rec_entries_mtx);
+            const char* bn = strrchr(outpath,'/');
+            RecEntry e{};
+            e.path     = outpath;
+            e.filename = bn ? bn+1 : outpath;
+            e.finished = true;
+            e.is_audio = false;
+            e.is_region= false;
+            e.t_start  = std::chrono::steady_clock::now();
+            rec_entries.push_back(e);
         }
-    }
-    // rec_entries에 완료 항목 추가 (SA 모드 아닌 경우만)
-    if(!sa_mode){
-        std::lock_guard<std::mutex> lk(rec_entries_mtx);
-        const char* bn = strrchr(outpath,'/');
-        RecEntry e{};
-        e.path     = outpath;
-        e.filename = bn ? bn+1 : outpath;
-        e.finished = true;
-        e.is_audio = false;
-        e.is_region= false;
-        e.t_start  = std::chrono::steady_clock::now();
-        rec_entries.push_back(e);
-    }
 
-    // .info 자동 생성 (SA 모드 아닐 때만 — SA는 분석 임시 파일)
-    if(!sa_mode){
-        double duration_sec = (out_sr > 0) ? (double)n_out / (double)out_sr : 0.0;
-        write_default_info_file(outpath, recorder_name(),
-                                cf_abs_mhz, (double)bw_khz, duration_sec,
-                                "", login_get_id(), station_name.c_str(),
-                                region.time_start_ms / 1000LL,
-                                utc_offset_hours(), out_sr);
-    }
+        // .info 자동 생성 (SA 모드 아닐 때만 — SA는 분석 임시 파일)
+        if(!sa_mode){
+            double duration_sec = (o.out_sr > 0) ? (double)o.n_out / (double)o.out_sr : 0.0;
+            write_default_info_file(outpath, recorder_name(),
+                                    o.cf_abs_mhz, (double)o.bw_khz, duration_sec,
+                                    "", login_get_id(), station_name.c_str(),
+                                    rg.time_start_ms / 1000LL,
+                                    utc_offset_hours(), o.out_sr);
+        }
 
-    // SA 모드: 저장 완료 후 SA 워터폴 계산 시작
-    if(sa_mode){
-        sa_mode = false;
-        sa_temp_path = outpath;
-        sa_start(outpath);
-    } else {
-        region.active = false;
+        // SA 모드: 저장 완료 후 SA 워터폴 계산 시작
+        if(sa_mode){
+            sa_mode = false;
+            sa_temp_path = o.path;
+            sa_start(o.path);
+        } else {
+            region.active = false;
+        }
+        paths[o.idx] = o.path;
     }
-    return outpath;
-}
\ No newline at end of file
+    return paths;
+}
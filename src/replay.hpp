@@ -0,0 +1,42 @@
+#pragma once
+// ── Capture replay: SDR 없이 캡처 파이프라인 벤치 ────────────────────────────
+// .sigmf-data (ci16, SigMF::open_source) 또는 합성 신호를 실장비 백엔드와 같은 경로
+// (iq_ring_write → fft_accumulate → fft_commit_row, capture_common.cpp) 로 공급하고
+// demod / 디코드 모듈 워커를 그대로 돌린 뒤 JSON 리포트를 남기고 종료.
+//
+//   BEWE --replay <file.sigmf-data | synth[:MSPS]>
+//        [--replay-rate 1|4|max]          1=실시간, N=N배속, max=최대 (reader lag 기준 backpressure)
+//        [--replay-secs S]                소스 기준 재생 길이 (0=파일 끝, synth 기본 10)
+//        [--replay-loop]                  파일 끝에서 처음으로
+//        [--replay-fft N]                 FFT 입력 크기 (기본 DEFAULT_FFT_SIZE)
+//        [--replay-cf MHz]                synth 중심 주파수 (기본 100)
+//        [--replay-ch LO:HI:am|fm|none[:mod,mod..]] ...   채널 (MHz) + 디코드 모듈
+//        [--replay-report out.json]       기본 stdout
+//
+// 리포트: 스레드별 CPU, ring reader 별 lag, FFT rows/s, 모듈별 records/s (pipe_stats.hpp).
+// 로그인/Central 없음. 모듈 저장(JSONL 등)이 실데이터를 오염시키지 않게 HOME 을 임시 디렉터리로 돌림.
+#include <string>
+#include <vector>
+
+struct ReplayChan {
+    float       lo_mhz = 0, hi_mhz = 0;
+    int         mode = 0;          // Channel::DemodMode (0=NONE 1=AM 2=FM)
+    std::string mods;              // "acars,adsb"
+};
+
+struct ReplayArgs {
+    std::string src;               // "" = replay 모드 아님
+    double      rate = 1.0;        // 0 = 최대 속도
+    double      secs = 0;
+    bool        loop = false;
+    int         fft_input = 0;     // 0 = 기본
+    float       cf_mhz = 100.0f;
+    std::string report;            // "" = stdout
+    std::vector<ReplayChan> chans;
+};
+
+extern ReplayArgs g_replay;
+
+// main.cpp: argv 하나 처리 (소비한 추가 인자 수 반환, replay 인자 아니면 -1)
+int  replay_parse_arg(int argc, char** argv, int i);
+int  run_replay_bench();
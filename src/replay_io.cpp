@@ -0,0 +1,396 @@
+// ── Replay 캡처 백엔드 + 오프라인 벤치 드라이버 (replay.hpp 참고) ───────────
+// 캡처 루프는 실장비 백엔드와 같은 공통 hot path (capture_common.cpp) 를 사용:
+//   chunk(min 8192) → iq_ring_write → fft_input_size 단위 fft_accumulate → fft_commit_row
+// 차이점: ring 은 항상 공급 (벤치 대상), TM IQ 롤링 없음, SR/FFT 크기 런타임 변경 없음.
+#include "replay.hpp"
+#include "fft_viewer.hpp"
+#include "module_api.hpp"
+#include "pipe_stats.hpp"
+#include "sigmf.hpp"
+#include "trace.hpp"
+#include <volk/volk.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ReplayArgs g_replay;
+extern std::atomic<bool> g_signal_shutdown;
+
+namespace {
+
+// 소스: 파일 (ci16 IQ) 또는 합성 루프 버퍼
+SigMF::Source        g_src;
+long                 g_left = 0;              // data chunk 남은 바이트 (WAV 뒤 chunk 는 읽지 않음)
+std::vector<int16_t> g_synth;                 // IQ 인터리브, 주기 SYNTH_N 샘플
+size_t               g_synth_pos = 0;
+constexpr size_t     SYNTH_N = (size_t)1 << 21;
+
+std::atomic<bool>     g_done{false};          // 소스 끝 / secs 도달
+std::atomic<uint64_t> g_samples{0};           // 공급 샘플 수
+std::atomic<uint64_t> g_stalls{0};            // max 모드 backpressure 1초 초과 (reader 정체)
+
+// 합성: 잡음 + CW + NBFM(1 kHz, ±5 kHz) + AM(1 kHz, 50%). 주파수는 전부 sr/SYNTH_N 의 정수배
+// → 루프 경계에서 위상 연속 (FFT/복조기에 이음새 안 보임).
+void synth_build(uint32_t sr, float cf_mhz){
+    const double fs = (double)sr, N = (double)SYNTH_N;
+    auto q = [&](double hz){ return std::round(hz * N / fs) * fs / N; };
+    const double f_cw = q(fs *  0.083), f_fm = q(fs * -0.1875), f_am = q(fs * 0.25);
+    const double f_tone = q(1000.0), dev = 5000.0;
+    const double a_cw = 0.1, a_fm = 0.05, a_am = 0.05, a_n = 0.003;    // 풀스케일 대비
+    g_synth.resize(SYNTH_N * 2);
+    uint64_t s = 0x9E3779B97F4A7C15ull;
+    auto urand = [&s](){ s ^= s << 13; s ^= s >> 7; s ^= s << 17; return ((s >> 11) + 0.5) * (1.0 / 9007199254740992.0); };
+    for(size_t n = 0; n < SYNTH_N; n++){
+        double t = n / fs;
+        double u1 = urand(), u2 = urand();
+        double r = a_n * std::sqrt(-2.0 * std::log(u1));
+        double i = r * std::cos(2*M_PI*u2), qv = r * std::sin(2*M_PI*u2);
+        i  += a_cw * std::cos(2*M_PI*f_cw*t);  qv += a_cw * std::sin(2*M_PI*f_cw*t);
+        double ph = 2*M_PI*f_fm*t + (dev / f_tone) * std::sin(2*M_PI*f_tone*t);
+        i  += a_fm * std::cos(ph);             qv += a_fm * std::sin(ph);
+        double env = a_am * (1.0 + 0.5 * std::sin(2*M_PI*f_tone*t));
+        i  += env * std::cos(2*M_PI*f_am*t);   qv += env * std::sin(2*M_PI*f_am*t);
+        g_synth[n*2]   = (int16_t)std::lround(std::clamp(i,  -1.0, 1.0) * 2047.0);
+        g_synth[n*2+1] = (int16_t)std::lround(std::clamp(qv, -1.0, 1.0) * 2047.0);
+    }
+    g_synth_pos = 0;
+    fprintf(stderr, "[REPLAY] synth %.3f MSPS  CW %.4f  NBFM %.4f  AM %.4f MHz\n",
+            fs/1e6, cf_mhz + f_cw/1e6, cf_mhz + f_fm/1e6, cf_mhz + f_am/1e6);
+}
+
+// n 샘플 채움. 반환 < n 이면 소스 끝.
+size_t source_read(int16_t* dst, size_t n){
+    if(!g_synth.empty()){
+        for(size_t k = 0; k < n; ){
+            size_t m = std::min(n - k, SYNTH_N - g_synth_pos);
+            memcpy(dst + k*2, &g_synth[g_synth_pos*2], m * 2 * sizeof(int16_t));
+            k += m; g_synth_pos = (g_synth_pos + m) % SYNTH_N;
+        }
+        return n;
+    }
+    size_t got = 0; bool rewound = false;
+    while(got < n){
+        if(g_left < 4){
+            if(!g_replay.loop || rewound) break;          // 빈 소스에서 무한 루프 방지
+            fseek(g_src.f, g_src.data_offset, SEEK_SET);
+            g_left = g_src.data_size; rewound = true;
+            continue;
+        }
+        size_t want = std::min(n - got, (size_t)(g_left / 4));
+        size_t r = fread(dst + got*2, 2*sizeof(int16_t), want, g_src.f);
+        got += r; g_left -= (long)r * 4;
+        if(r < want) g_left = 0;                          // 잘린 파일
+        if(r > 0) rewound = false;
+    }
+    return got;
+}
+
+double parse_rate(const char* s){
+    if(strcmp(s, "max") == 0 || strcmp(s, "0") == 0) return 0.0;
+    double r = atof(s);
+    return r > 0 ? r : 1.0;
+}
+
+// "LO:HI:fm[:acars,adsb]"
+bool parse_chan(const char* s, ReplayChan& c){
+    char mode[8] = {}, mods[128] = {};
+    int n = sscanf(s, "%f:%f:%7[^:]:%127s", &c.lo_mhz, &c.hi_mhz, mode, mods);
+    if(n < 3) return false;
+    c.mode = !strcmp(mode, "am") ? (int)Channel::DM_AM : !strcmp(mode, "fm") ? (int)Channel::DM_FM : 0;
+    c.mods = n >= 4 ? mods : "";
+    return true;
+}
+
+void json_str(FILE* f, const std::string& s){
+    fputc('"', f);
+    for(char c : s) if(c != '"' && c != '\\' && (unsigned char)c >= 0x20) fputc(c, f);
+    fputc('"', f);
+}
+
+} // namespace
+
+int replay_parse_arg(int argc, char** argv, int i){
+    const char* a = argv[i];
+    bool has = i + 1 < argc;
+    if(!strcmp(a, "--replay") && has)        { g_replay.src = argv[i+1]; return 1; }
+    if(!strcmp(a, "--replay-rate") && has)   { g_replay.rate = parse_rate(argv[i+1]); return 1; }
+    if(!strcmp(a, "--replay-secs") && has)   { g_replay.secs = atof(argv[i+1]); return 1; }
+    if(!strcmp(a, "--replay-fft") && has)    { g_replay.fft_input = atoi(argv[i+1]); return 1; }
+    if(!strcmp(a, "--replay-cf") && has)     { g_replay.cf_mhz = (float)atof(argv[i+1]); return 1; }
+    if(!strcmp(a, "--replay-report") && has) { g_replay.report = argv[i+1]; return 1; }
+    if(!strcmp(a, "--replay-loop"))          { g_replay.loop = true; return 0; }
+    if(!strcmp(a, "--replay-ch") && has){
+        ReplayChan c;
+        if(parse_chan(argv[i+1], c)) g_replay.chans.push_back(c);
+        else fprintf(stderr, "[REPLAY] bad --replay-ch '%s' (LO:HI:am|fm|none[:mods])\n", argv[i+1]);
+        return 1;
+    }
+    return -1;
+}
+
+// ── Replay 초기화 ───────────────────────────────────────────────────────────
+bool FFTViewer::initialize_replay(float cf_mhz){
+    uint32_t sr = 0;
+    const std::string& src = g_replay.src;
+    if(src.compare(0, 5, "synth") == 0){
+        double msps = src.size() > 6 && src[5] == ':' ? atof(src.c_str() + 6) : 2.4;
+        sr = (uint32_t)(std::max(0.1, msps) * 1e6);
+        synth_build(sr, cf_mhz);
+        if(g_replay.secs <= 0) g_replay.secs = 10.0;
+    } else {
+        if(!SigMF::open_source(src, g_src)){
+            fprintf(stderr, "[REPLAY] cannot open '%s' (.sigmf-data + .sigmf-meta or IQ .wav)\n", src.c_str());
+            return false;
+        }
+        if(g_src.nch != 2){
+            fprintf(stderr, "[REPLAY] '%s' is not IQ (mono audio)\n", src.c_str());
+            fclose(g_src.f); g_src.f = nullptr;
+            return false;
+        }
+        fseek(g_src.f, g_src.data_offset, SEEK_SET);
+        g_left = g_src.data_size;
+        sr = g_src.sample_rate;
+        if(g_src.center_freq_hz) cf_mhz = (float)(g_src.center_freq_hz / 1e6);
+        fprintf(stderr, "[REPLAY] %s  %.3f MSPS  CF %.4f MHz  %.1f s\n", src.c_str(), sr/1e6, cf_mhz,
+                (double)g_src.data_size / 4.0 / sr);
+    }
+
+    hw = make_replay_config(sr);
+    gain_db = 0;
+
+    // FFT 헤더 / 버퍼 (initialize_rtlsdr 와 동일 구성)
+    std::memcpy(header.magic,"FFTD",4);
+    fft_input_size = fft_size / FFT_PAD_FACTOR;
+    header.version=1; header.fft_size=fft_size; header.sample_rate=sr;
+    header.center_frequency=(uint64_t)(cf_mhz*1e6);
+    live_cf_hz.store((uint64_t)(cf_mhz*1e6), std::memory_order_release);
+    time_average=hw.compute_time_average(fft_input_size);
+    header.time_average=time_average; header.power_min=-100; header.power_max=0; header.num_ffts=0;
+    fft_data.resize(MAX_FFTS_MEMORY*fft_size);
+    current_spectrum.resize(fft_size,-100.0f);
+    window_title="BEWE (" BEWE_VERSION ") replay"; display_power_min=-100; display_power_max=0;
+    fft_in =fftwf_alloc_complex(fft_size);
+    fft_out=fftwf_alloc_complex(fft_size);
+    memset(fft_in, 0, fft_size*sizeof(fftwf_complex));
+    fft_plan=fftwf_plan_dft_1d(fft_size,fft_in,fft_out,FFTW_FORWARD,FFTW_ESTIMATE);
+    memset(fft_in, 0, fft_size*sizeof(fftwf_complex));
+    if(win_buf) volk_free(win_buf);
+    win_buf=(float*)volk_malloc(fft_input_size*sizeof(float), volk_get_alignment());
+    fill_nuttall_window(win_buf, fft_input_size);
+    if(mag_sq_buf) volk_free(mag_sq_buf);
+    mag_sq_buf=(float*)volk_malloc(fft_size*sizeof(float), volk_get_alignment());
+    ring.resize(IQ_RING_CAPACITY*2,0);
+    autoscale_req.store(true, std::memory_order_relaxed);
+    g_done.store(false); g_samples.store(0); g_stalls.store(0);
+    return true;
+}
+
+// ── Replay 캡처 루프 ────────────────────────────────────────────────────────
+void FFTViewer::capture_and_process_replay(){
+    PipeStats::name_thread("replay");
+    static constexpr int RX_MIN = 8192;
+    static constexpr int WARMUP_FFTS = 30;
+    const int rx_chunk = std::max(fft_input_size, RX_MIN);
+    std::vector<int16_t> iq((size_t)rx_chunk * 2);
+    std::vector<float> pacc(fft_size, 0.0f); int fcnt = 0;
+    int warmup_cnt = 0;
+
+    const double sr = (double)hw.sample_rate;
+    const double rate = g_replay.rate;
+    const uint64_t limit = g_replay.secs > 0 ? (uint64_t)(g_replay.secs * sr) : UINT64_MAX;
+    // max 모드: 가장 느린 reader 의 lag 를 워커 MAX_LAG(80 ms) 절반 이하로 → 워커가 건너뛰지 않음
+    const size_t lag_cap = std::max((size_t)(sr * 0.04), (size_t)rx_chunk * 2);
+    const float inv_scale = 1.0f / hw.iq_scale;
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t fed = 0;
+
+    while(is_running && fed < limit){
+        // ── 페이싱 ──────────────────────────────────────────────────────────
+        if(rate > 0){
+            auto due = t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(fed / (sr * rate)));
+            std::this_thread::sleep_until(due);
+        } else {
+            auto w0 = std::chrono::steady_clock::now();
+            while(is_running && PipeStats::max_lag(ring_wp.load(std::memory_order_relaxed)) + rx_chunk > lag_cap){
+                if(std::chrono::steady_clock::now() - w0 > std::chrono::seconds(1)){ g_stalls.fetch_add(1); break; }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+
+        BEWE_TRACE_SCOPE_V(tr_rx, "cap", "rx");
+        size_t n = source_read(iq.data(), (size_t)std::min<uint64_t>(rx_chunk, limit - fed));
+        tr_rx.arg = (uint32_t)n;
+        if(n == 0) break;
+        iq_ring_write(iq.data(), n);
+        fed += n;
+        g_samples.store(fed, std::memory_order_relaxed);
+
+        if(!render_visible.load(std::memory_order_relaxed)) continue;
+        for(size_t pos = 0; pos + fft_input_size <= n; pos += fft_input_size){
+            const int16_t* rp = iq.data() + pos*2;
+            for(int i=0;i<fft_input_size;i++){
+                fft_in[i][0] = (float)rp[i*2+0] * inv_scale;
+                fft_in[i][1] = (float)rp[i*2+1] * inv_scale;
+            }
+            fft_accumulate(pacc.data()); fcnt++;
+            if(fcnt>=time_average){
+                if(warmup_cnt < WARMUP_FFTS) warmup_cnt++;
+                else fft_commit_row(pacc.data(), fcnt);
+                std::fill(pacc.begin(),pacc.end(),0.0f); fcnt=0;
+            }
+        }
+        if(n < (size_t)rx_chunk && fed < limit) break;   // 소스 끝
+    }
+    g_done.store(true);
+    bewe_log_push(0,"[REPLAY] capture done: %llu samples\n", (unsigned long long)fed);
+}
+
+// rm -rf (mission.cpp rm_rf_dir 와 같은 패턴, 심볼릭 링크는 따라가지 않음)
+static void rm_rf_dir(const std::string& path){
+    DIR* d = opendir(path.c_str());
+    if(!d){ unlink(path.c_str()); return; }
+    struct dirent* ent;
+    while((ent = readdir(d)) != nullptr){
+        const char* n = ent->d_name;
+        if(n[0]=='.' && (n[1]==0 || (n[1]=='.' && n[2]==0))) continue;
+        std::string full = path + "/" + n;
+        struct stat st;
+        if(lstat(full.c_str(), &st) != 0) continue;
+        if(S_ISDIR(st.st_mode)) rm_rf_dir(full);
+        else                    unlink(full.c_str());
+    }
+    closedir(d);
+    rmdir(path.c_str());
+}
+
+// ── 오프라인 벤치 드라이버 ───────────────────────────────────────────────────
+int run_replay_bench(){
+    // 모듈 저장(JSONL 등) → 임시 HOME (실데이터 오염 방지). 종료 시 삭제 (BEWE_REPLAY_KEEP_HOME=1 이면 유지)
+    char home[64]; snprintf(home, sizeof(home), "/tmp/bewe_replay_%d", (int)getpid());
+    mkdir(home, 0755);
+    setenv("HOME", home, 1);
+    BEWEPaths::ensure_dirs();
+    fprintf(stderr, "[REPLAY] HOME=%s\n", home);
+    struct HomeGuard {
+        std::string dir;
+        ~HomeGuard(){
+            const char* k = getenv("BEWE_REPLAY_KEEP_HOME");
+            if(k && *k == '1'){ fprintf(stderr, "[REPLAY] kept %s\n", dir.c_str()); return; }
+            rm_rf_dir(dir);
+        }
+    } home_guard{home};   // v_ptr 보다 먼저 선언 → viewer 소멸(모듈 파일 close) 뒤에 삭제
+
+    auto v_ptr = std::make_unique<FFTViewer>();
+    FFTViewer& v = *v_ptr;
+    if(g_replay.fft_input > 0){
+        v.fft_input_size = g_replay.fft_input;
+        v.fft_size = g_replay.fft_input * FFT_PAD_FACTOR;
+    }
+    if(!v.initialize_replay(g_replay.cf_mhz)) return 1;
+    v.metrics_install();   // 벤치 중에도 /metrics 로 실시간 관찰 가능
+    const double sr = (double)v.hw.sample_rate;
+
+    for(int i = 0; i < (int)g_replay.chans.size() && i < MAX_CHANNELS; i++){
+        const ReplayChan& c = g_replay.chans[i];
+        Channel& ch = v.channels[i];
+        ch.reset_slot();
+        ch.s = c.lo_mhz; ch.e = c.hi_mhz;
+        ch.filter_active = true;
+        ch.mode = (Channel::DemodMode)c.mode;
+        if(ch.mode != Channel::DM_NONE) v.start_dem(i, ch.mode);
+        if(!c.mods.empty()){
+            char tmp[128]; strncpy(tmp, c.mods.c_str(), sizeof(tmp)-1); tmp[sizeof(tmp)-1] = 0;
+            for(char* tok = strtok(tmp, ","); tok; tok = strtok(nullptr, ","))
+                bewe_mod_set_target(v, tok, bewe_mod_my_station(), i, true);
+        }
+    }
+    v.update_dem_by_freq(v.header.center_frequency / 1e6f);
+
+    // 스레드 CPU 기준점 (기동 전 스레드는 이후 증가분만)
+    struct TAcc { std::string name; double c0 = 0, c1 = 0; };
+    std::map<int, TAcc> threads;
+    for(auto& t : PipeStats::thread_cpu()){ auto& a = threads[t.tid]; a.name = t.name; a.c0 = a.c1 = t.cpu_s; }
+    struct LAcc { double sum = 0; size_t max = 0; uint64_t n = 0; };
+    std::map<std::string, LAcc> lags;
+    const double cpu0 = PipeStats::process_cpu_s();
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::thread cap(&FFTViewer::capture_and_process_replay, &v);
+    while(!g_done.load() && !g_signal_shutdown.load()){
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        size_t wp = v.ring_wp.load(std::memory_order_acquire);
+        for(auto& r : PipeStats::readers()){
+            size_t lag = (wp - r.rp->load(std::memory_order_acquire)) & IQ_RING_MASK;
+            auto& a = lags[r.name];
+            a.sum += lag; a.n++; a.max = std::max(a.max, lag);
+        }
+        for(auto& t : PipeStats::thread_cpu()){ auto& a = threads[t.tid]; a.name = t.name; a.c1 = t.cpu_s; }
+    }
+    // 남은 워커 처리분 반영 후 마지막 샘플 (정지 전)
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    for(auto& t : PipeStats::thread_cpu()){ auto& a = threads[t.tid]; a.name = t.name; a.c1 = t.cpu_s; }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double cpu = PipeStats::process_cpu_s() - cpu0;
+
+    v.is_running = false;
+    if(cap.joinable()) cap.join();
+    int rows; { std::lock_guard<std::mutex> lk(v.data_mtx); rows = v.total_ffts; }
+    v.stop_all_dem();
+    if(g_src.f){ fclose(g_src.f); g_src.f = nullptr; }
+
+    // ── JSON 리포트 ─────────────────────────────────────────────────────────
+    FILE* f = g_replay.report.empty() ? stdout : fopen(g_replay.report.c_str(), "w");
+    if(!f){ fprintf(stderr, "[REPLAY] cannot write %s\n", g_replay.report.c_str()); return 1; }
+    const uint64_t samples = g_samples.load();
+    const double wl = wall > 0 ? wall : 1e-9;
+    fprintf(f, "{\n  \"source\": "); json_str(f, g_replay.src);
+    if(g_replay.rate > 0) fprintf(f, ",\n  \"rate\": %g,\n", g_replay.rate);
+    else                  fprintf(f, ",\n  \"rate\": \"max\",\n");
+    fprintf(f, "  \"sample_rate\": %u,\n  \"fft_input\": %d,\n  \"fft_size\": %d,\n  \"time_average\": %d,\n",
+            v.hw.sample_rate, v.fft_input_size, v.fft_size, v.time_average);
+    fprintf(f, "  \"wall_s\": %.3f,\n  \"samples\": %llu,\n  \"realtime_x\": %.3f,\n  \"msps\": %.3f,\n",
+            wall, (unsigned long long)samples, samples / sr / wl, samples / wl / 1e6);
+    fprintf(f, "  \"backpressure_stalls\": %llu,\n", (unsigned long long)g_stalls.load());
+    fprintf(f, "  \"fft_rows\": %d,\n  \"fft_rows_per_s\": %.2f,\n", rows, rows / wl);
+    fprintf(f, "  \"process_cpu_s\": %.3f,\n  \"process_cpu_pct\": %.1f,\n", cpu, 100.0 * cpu / wl);
+    fprintf(f, "  \"threads\": [");
+    bool first = true;
+    for(auto& [tid, a] : threads){
+        double d = a.c1 - a.c0;
+        if(d <= 0) continue;
+        fprintf(f, "%s\n    {\"tid\": %d, \"name\": ", first ? "" : ",", tid); json_str(f, a.name);
+        fprintf(f, ", \"cpu_s\": %.3f, \"cpu_pct\": %.1f}", d, 100.0 * d / wl);
+        first = false;
+    }
+    fprintf(f, "\n  ],\n  \"ring_readers\": [");
+    first = true;
+    for(auto& [name, a] : lags){
+        double mean = a.n ? a.sum / a.n : 0;
+        fprintf(f, "%s\n    {\"name\": ", first ? "" : ","); json_str(f, name);
+        fprintf(f, ", \"lag_mean_ms\": %.2f, \"lag_max_ms\": %.2f, \"lag_max_samples\": %zu, \"lag_limit_ms\": 80}",
+                1e3 * mean / sr, 1e3 * a.max / sr, a.max);
+        first = false;
+    }
+    fprintf(f, "\n  ],\n  \"records\": [");
+    first = true;
+    for(auto& [id, n] : PipeStats::records()){
+        fprintf(f, "%s\n    {\"module\": ", first ? "" : ","); json_str(f, id);
+        fprintf(f, ", \"count\": %llu, \"per_s\": %.2f}", (unsigned long long)n, n / wl);
+        first = false;
+    }
+    fprintf(f, "\n  ]\n}\n");
+    if(f != stdout) fclose(f);
+    fprintf(stderr, "[REPLAY] %.2f s wall, %.2fx realtime, %d rows, report %s\n",
+            wall, samples / sr / wl, rows, g_replay.report.empty() ? "stdout" : g_replay.report.c_str());
+    return 0;
+}
@@ -1,6 +1,9 @@
 #include "fft_viewer.hpp"
 #include "net_server.hpp"
 #include "long_waterfall.hpp"
+#include "metrics.hpp"
+#include "pipe_stats.hpp"
+#include "trace.hpp"
 #include <volk/volk.h>
 #include <cstring>
 #include <cstdio>
@@ -181,6 +184,7 @@ void FFTViewer::set_frequency(float cf_mhz){
 // RTL-SDR은 uint8 IQ, center=127.5
 // 동기 read 방식 사용 (async보다 지연 제어 쉬움)
 void FFTViewer::capture_and_process_rtl(){
+    PipeStats::name_thread("cap_rtl");
     static constexpr int RX_MIN = 8192; // 최소 RX 청크 (USB 오버헤드 최소화)
     int rx_chunk = std::max(fft_input_size, RX_MIN);
     size_t    n_bytes = (size_t)rx_chunk * 2;
@@ -249,14 +253,8 @@ void FFTViewer::capture_and_process_rtl(){
             bool tm_was_on = tm_iq_on.load(std::memory_order_relaxed);
             if(tm_was_on) tm_iq_on.store(false);
             tm_iq_close(); // fd 닫기 + 상태 초기화
-            // 기존 SR 롤링 파일 삭제 (SR 불일치 방지)
-            {
-                std::string tm_dir = BEWEPaths::time_temp_dir();
-                char old_path[256];
-                snprintf(old_path, sizeof(old_path), "%s/iq_rolling_%uMSPS.wav",
-                         tm_dir.c_str(), header.sample_rate/1000000);
-                if(access(old_path, F_OK)==0){ remove(old_path); }
-            }
+            // 기존 SR 롤링 파일 삭제 (SR 불일치 방지, raw/압축 둘 다)
+            tm_iq_remove_rolling(header.sample_rate);
 
             rtlsdr_set_sample_rate(dev_rtl, new_sr);
             rtlsdr_set_tuner_bandwidth(dev_rtl, 0); // 0 = SR 기준 자동 BW
@@ -286,7 +284,7 @@ void FFTViewer::capture_and_process_rtl(){
             pacc.assign(fft_size,0.0f); fcnt=0; warmup_cnt=0;
             texture_needs_recreate=true;
             // SR 변경 > 신호 크기 스케일이 달라질 수 있어 오토스케일 재트리거
-            autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
+            autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
             // TM IQ가 켜져 있었으면 새 SR로 롤링 파일 재시작
             if(tm_was_on){
                 tm_iq_open();
@@ -315,7 +313,7 @@ void FFTViewer::capture_and_process_rtl(){
             live_cf_hz.store((uint64_t)(pending_cf*1e6), std::memory_order_release);
             LongWaterfall::request_rotate();
             bewe_log_push(0,"Freq > %.2f MHz\n", pending_cf);
-            autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
+            autoscale_hist.clear(); autoscale_init=false; autoscale_active=true;
             warmup_cnt=0;
             update_dem_by_freq(pending_cf);
             freq_req=false; freq_prog=false;
@@ -324,8 +322,16 @@ void FFTViewer::capture_and_process_rtl(){
 
         // ── RX: 고정 청크(min 8192)로 읽기 > USB 오버헤드 최소화 ──────────
         if(rx_avail == 0){
+            // RTL read_sync 는 드롭을 알려주지 않음 → 샘플 수/대기 시간만 계측
+            static auto& m_rx      = Metrics::counter("bewe_sdr_rx_samples_total", "SDR samples received", "sdr=\"rtlsdr\"");
+            static auto& m_rx_wait = Metrics::histogram("bewe_sdr_rx_wait_seconds", "Time blocked in SDR read call", "sdr=\"rtlsdr\"", 1e-6);
+            BEWE_TRACE_SCOPE_ARG("cap", "rx", rx_chunk);
             int n_read = 0;
+            auto t_rx0 = std::chrono::steady_clock::now();
             int r = rtlsdr_read_sync(dev_rtl, raw, (int)n_bytes, &n_read);
+            m_rx_wait.observe((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now()-t_rx0).count());
+            if(n_read > 0) m_rx.inc((uint64_t)n_read/2);
             if(r < 0 || n_read < (int)n_bytes){
                 fprintf(stderr,"RTL-SDR RX: r=%d n_read=%d - SDR disconnected\n", r, n_read);
                 sdr_stream_error.store(true);
@@ -343,16 +349,8 @@ void FFTViewer::capture_and_process_rtl(){
             if(!need_ring) for(int i=0;i<MAX_CHANNELS;i++) if(channels[i].dem_run.load()){need_ring=true;break;}
             bool need_tm = tm_iq_on.load(std::memory_order_relaxed) && (warmup_cnt>=WARMUP_FFTS);
             if(need_ring || need_tm){
-                size_t wp=ring_wp.load(std::memory_order_relaxed);
-                size_t n=(size_t)rx_chunk, cap=IQ_RING_CAPACITY;
-                if(wp+n<=cap) memcpy(&ring[wp*2],iq16,n*2*sizeof(int16_t));
-                else{
-                    size_t p1=cap-wp, p2=n-p1;
-                    memcpy(&ring[wp*2],iq16,p1*2*sizeof(int16_t));
-                    memcpy(&ring[0],iq16+p1*2,p2*2*sizeof(int16_t));
-                }
-                ring_wp.store((wp+n)&IQ_RING_MASK, std::memory_order_release);
-                if(need_tm) tm_iq_write(iq16,(int)n);
+                iq_ring_write(iq16,(size_t)rx_chunk);
+                if(need_tm) tm_iq_write(iq16,rx_chunk);
             }
             rx_pos=0; rx_avail=rx_chunk;
         }
@@ -371,19 +369,7 @@ void FFTViewer::capture_and_process_rtl(){
                 fft_in[i][0] = ((float)rp[i*2  ] - iq_offset) / iq_scale;
                 fft_in[i][1] = ((float)rp[i*2+1] - iq_offset) / iq_scale;
             }
-            // Nuttall window via VOLK SIMD
-            volk_32fc_32f_multiply_32fc((lv_32fc_t*)fft_in, (lv_32fc_t*)fft_in,
-                                        win_buf, fft_input_size);
-            // pad region은 init/resize 시 한 번만 0 초기화
-            fftwf_execute(fft_plan);
-            {
-                volk_32fc_magnitude_squared_32f(mag_sq_buf, (lv_32fc_t*)fft_out, fft_size);
-                const float scale=NUTTALL_WINDOW_CORRECTION/((float)fft_input_size*(float)fft_input_size);
-                for(int i=0;i<fft_size;i++){
-                    pacc[i] += mag_sq_buf[i]*scale + 1e-10f;
-                }
-            }
-            pacc[0]=(pacc[1]+pacc[fft_size-1])*0.5f; fcnt++;
+            fft_accumulate(pacc.data()); fcnt++;
             if(fcnt>=time_average){
                 if(warmup_cnt < WARMUP_FFTS){
                     warmup_cnt++;
@@ -391,64 +377,7 @@ void FFTViewer::capture_and_process_rtl(){
                     rx_pos+=fft_input_size; rx_avail-=fft_input_size;
                     continue;
                 }
-                int fi=total_ffts%MAX_FFTS_MEMORY;
-                float* rowp=fft_data.data()+fi*fft_size;
-                {std::lock_guard<std::mutex> lk(data_mtx);
-                 // current_spectrum은 UI 스레드 전용 > 캡처 쓰기 금지 (race 유발)
-                 for(int i=0;i<fft_size;i++){
-                     rowp[i]=10.0f*log10f(pacc[i]/fcnt);
-                 }
-                 // 비-캡처 스레드 요청 처리 (set_frequency/init) — 여기서만 autoscale 상태 변경 (레이스 X)
-                 if(autoscale_req.exchange(false)){
-                     autoscale_accum.clear(); autoscale_init=false; autoscale_active=true;
-                 }
-                 if(autoscale_active){
-                     if(!autoscale_init){
-                         size_t cap=(size_t)fft_size*100;
-                         if(autoscale_accum.size()!=cap) autoscale_accum.assign(cap,0.0f);
-                         autoscale_wp=0; autoscale_buf_full=false;
-                         autoscale_last=std::chrono::steady_clock::now();
-                         autoscale_init=true;
-                     }
-                     size_t cap=autoscale_accum.size();
-                     for(int i=1;i<fft_size;i++){
-                         autoscale_accum[autoscale_wp]=rowp[i];
-                         if(++autoscale_wp>=cap){ autoscale_wp=0; autoscale_buf_full=true; }
-                     }
-                     float el=std::chrono::duration<float>(std::chrono::steady_clock::now()-autoscale_last).count();
-                     if(el>=1.0f&&(autoscale_buf_full||autoscale_wp>0)){
-                         size_t n=autoscale_buf_full?cap:autoscale_wp;
-                         std::vector<float> tmp(autoscale_accum.begin(),
-                                                autoscale_accum.begin()+(ptrdiff_t)n);
-                         size_t idx_lo=(size_t)(n*0.15f);
-                         std::nth_element(tmp.begin(),tmp.begin()+(ptrdiff_t)idx_lo,tmp.end());
-                         float noise=tmp[idx_lo];
-                         float peak=*std::max_element(tmp.begin(),tmp.end());
-                         display_power_min=noise-5.0f;
-                         display_power_max=peak+20.0f;
-                         if(display_power_max-display_power_min<20.f)
-                             display_power_max=display_power_min+20.f;
-                         header.power_min=display_power_min;
-                         header.power_max=display_power_max;
-                         bewe_log_push(0,"[autoscale] noise=%.1f peak=%.1f → pmin=%.1f pmax=%.1f\n",
-                             noise, peak, display_power_min, display_power_max);
-                         autoscale_active=false; autoscale_init=false;
-                         autoscale_wp=0; autoscale_buf_full=false;
-                         cached_sp_idx=-1;
-                     }
-                 }
-                 total_ffts++; current_fft_idx=total_ffts-1;
-                 header.num_ffts=std::min(total_ffts,MAX_FFTS_MEMORY);
-                 row_write_pos[current_fft_idx%MAX_FFTS_MEMORY]=tm_iq_write_sample;
-                 row_wall_ms[current_fft_idx%MAX_FFTS_MEMORY]=(int64_t)(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-                 if(tm_iq_on.load(std::memory_order_relaxed))
-                     tm_mark_rows(current_fft_idx%MAX_FFTS_MEMORY);
-                 else
-                     iq_row_avail[current_fft_idx%MAX_FFTS_MEMORY]=false;
-                 tm_add_time_tag(current_fft_idx);
-                 net_bcast_seq.fetch_add(1, std::memory_order_release);
-                 net_bcast_cv.notify_one();
-                }
+                fft_commit_row(pacc.data(), fcnt);
                 std::fill(pacc.begin(),pacc.end(),0.0f); fcnt=0;
             }
         } // end !spectrum_pause
@@ -2,6 +2,7 @@
 #include "audio.hpp"
 #include "bewe_paths.hpp"
 #include "sigmf.hpp"
+#include "quantile_sketch.hpp"
 #include <fftw3.h>
 #include <cstdio>
 #include <cmath>
@@ -9,6 +10,9 @@
 #include <algorithm>
 #include <vector>
 #include <thread>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // ── Jet colormap (sa 전용) ─────────────────────────────────────────────────
 // Jet colormap (default)
@@ -45,10 +49,124 @@ static void sa_apply_window(float* buf, int n, const float* win){
     }
 }
 
+// ── Streaming spectrogram engine ──────────────────────────────────────────
+// 전체 IQ / 전체 dB 를 RAM 에 올리지 않는다:
+//   pass 1: 출력 행 일부(SA_SKETCH_ROWS)만 계산해 QuantileSketch 로 1~99% 범위 + CDF 추정
+//   pass 2: 출력 행을 SA_TILE_ROWS 단위 tile 로 worker pool 에 분배, 완료 tile 부터
+//           메인 스레드가 glTexSubImage2D 로 올린다 (첫 tile 이 바로 보임).
+// 샘플 접근은 fill 콜백 (파일 = mmap/pread int16, EID = RAM float) — 스레드 안전해야 함.
+namespace {
+
+constexpr int     SA_TILE_ROWS   = 64;     // 출력 텍스처 행 단위
+constexpr int     SA_SKETCH_ROWS = 384;    // pass 1 샘플 출력 행 수
+constexpr int     SA_MAX_TEX     = 16384;  // GL 호출은 메인 스레드 전용 — 기본 상한값 사용
+constexpr int     SA_LUT_BINS    = 256;
+
+// fill(s0, n, iq): 샘플 s0 부터 n 개 복소 샘플을 iq[2n] 에 (scale 적용 전) 기록.
+using SaFill = std::function<void(int64_t s0, int n, float* iq)>;
+
+struct SaGeom {
+    int     fft_n    = 0;
+    int64_t hop      = 0;
+    int64_t rows     = 0;   // FFT 행 수
+    int64_t out_rows = 0;   // 텍스처 행 수
+    int     merge    = 1;   // 텍스처 1행 = FFT merge 행 평균
+};
+
+bool sa_plan_geom(int fft_req, int64_t n_samples, SaGeom& g){
+    int n = fft_req;
+    // FFT size 자동 축소: n_samples에 맞는 가장 큰 2의 거듭제곱
+    while(n > 32 && n_samples < (int64_t)n) n >>= 1;
+    if(n_samples < (int64_t)n) return false;
+    g.fft_n = n;
+    g.hop   = n;
+    g.rows  = n_samples / g.hop;
+    // rows 부족 시 50% 오버랩으로 보완
+    if(g.rows < 8 && n > 1){
+        g.hop  = std::max((int64_t)1, g.hop / 2);
+        g.rows = (n_samples - n) / g.hop + 1;
+    }
+    if(g.rows < 1) return false;
+    // rows가 최대 텍스처 높이 초과 시 행 병합 (시간축 다운샘플)
+    g.merge = (int)((g.rows + SA_MAX_TEX - 1) / SA_MAX_TEX);
+    if(g.merge < 1) g.merge = 1;
+    g.out_rows = std::max((int64_t)1, g.rows / g.merge);
+    return true;
+}
+
+// worker 당 FFTW 버퍼/플랜 (new-array execute 대신 전용 플랜 — 스레드 간 공유 없음).
+struct SaWorker {
+    std::vector<float> in;
+    fftwf_complex*     out  = nullptr;
+    fftwf_plan         plan = nullptr;
+    std::vector<float> acc;    // 출력 1행 dB 합
+    std::vector<float> row;    // 출력 1행 평균 dB
+    void init(int n){
+        in.assign((size_t)n * 2, 0.f);
+        out  = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
+        plan = fftwf_plan_dft_1d(n, (fftwf_complex*)in.data(), out, FFTW_FORWARD, FFTW_ESTIMATE);
+        acc.resize(n); row.resize(n);
+    }
+    ~SaWorker(){
+        if(plan) fftwf_destroy_plan(plan);
+        if(out)  fftwf_free(out);
+    }
+};
+
+// 출력 행 r 의 평균 dB (FFT shift + DC 억제 포함) → w.row
+void sa_out_row(SaWorker& w, const SaGeom& g, const SaFill& fill, float scale,
+                const float* win, int64_t r){
+    const int n = g.fft_n, half = n / 2;
+    std::fill(w.acc.begin(), w.acc.end(), 0.f);
+    int cnt = 0;
+    for(int m = 0; m < g.merge; m++){
+        int64_t fr = r * g.merge + m;
+        if(fr >= g.rows) break;
+        fill(fr * g.hop, n, w.in.data());
+        for(int i = 0; i < n * 2; i++) w.in[i] *= scale;
+        sa_apply_window(w.in.data(), n, win);
+        fftwf_execute(w.plan);
+        // FFT shift: 음수 주파수 → 양수
+        for(int i = 0; i < n; i++){
+            int bin = (i + half) % n;
+            float re = w.out[bin][0], im = w.out[bin][1];
+            w.row[i] = 10.0f * log10f(re*re + im*im + 1e-12f);
+        }
+        // DC bin 억제
+        w.row[half] = w.row[half - 1];
+        for(int i = 0; i < n; i++) w.acc[i] += w.row[i];
+        cnt++;
+    }
+    float inv = cnt > 0 ? 1.0f / cnt : 0.f;
+    for(int i = 0; i < n; i++) w.row[i] = w.acc[i] * inv;
+}
+
+// items 를 n_thr 개 스레드가 atomic counter 로 나눠 처리. fn(worker_idx, item).
+template<class Fn>
+void sa_run_pool(int n_thr, int64_t n_items, const std::atomic<bool>& cancel, Fn fn){
+    std::atomic<int64_t> next{0};
+    auto body = [&](int wi){
+        for(;;){
+            if(cancel.load(std::memory_order_relaxed)) return;
+            int64_t it = next.fetch_add(1);
+            if(it >= n_items) return;
+            fn(wi, it);
+        }
+    };
+    std::vector<std::thread> thr;
+    for(int t = 1; t < n_thr; t++) thr.emplace_back(body, t);
+    body(0);
+    for(auto& t : thr) t.join();
+}
+
+} // namespace
+
 void FFTViewer::sa_cleanup(){
     sa_playing.store(false);
     if(sa_play_thread.joinable()) sa_play_thread.join();
+    sa_cancel.store(true);
     if(sa_thread.joinable()) sa_thread.join();
+    sa_cancel.store(false);
 
     sa_temp_path.clear();
 #ifndef BEWE_HEADLESS
@@ -59,35 +177,145 @@ void FFTViewer::sa_cleanup(){
     {
         std::lock_guard<std::mutex> lk(sa_pixel_mtx);
         sa_pixel_buf.clear();
+        sa_tile_queue.clear();
+        sa_tex_realloc = false;
     }
 }
 
+// 메인 스레드: 새 크기면 텍스처 재할당, 이후 완료된 tile 만 sub-upload.
 void FFTViewer::sa_upload_texture(){
 #ifdef BEWE_HEADLESS
     return;
 #else
     std::lock_guard<std::mutex> lk(sa_pixel_mtx);
+    sa_pixel_ready.store(false);
     if(sa_pixel_buf.empty()) return;
-    if(sa_texture) glDeleteTextures(1,&sa_texture);
-    glGenTextures(1,&sa_texture);
-    glBindTexture(GL_TEXTURE_2D,sa_texture);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA,
-                 sa_tex_w,sa_tex_h,0,
-                 GL_RGBA,GL_UNSIGNED_BYTE,sa_pixel_buf.data());
+    if(sa_tex_realloc || !sa_texture){
+        if(sa_texture) glDeleteTextures(1,&sa_texture);
+        glGenTextures(1,&sa_texture);
+        glBindTexture(GL_TEXTURE_2D,sa_texture);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+        // 버퍼는 0(투명)으로 초기화돼 있음 — 아직 안 끝난 tile 은 배경색으로 보임
+        glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA,
+                     sa_tex_w,sa_tex_h,0,
+                     GL_RGBA,GL_UNSIGNED_BYTE,sa_pixel_buf.data());
+        sa_tex_realloc = false;
+    } else {
+        glBindTexture(GL_TEXTURE_2D,sa_texture);
+        for(int t : sa_tile_queue){
+            int y0 = t * SA_TILE_ROWS;
+            int h  = std::min(SA_TILE_ROWS, sa_tex_h - y0);
+            if(h <= 0) continue;
+            glTexSubImage2D(GL_TEXTURE_2D,0,0,y0,sa_tex_w,h,
+                            GL_RGBA,GL_UNSIGNED_BYTE,
+                            sa_pixel_buf.data() + (size_t)y0 * sa_tex_w);
+        }
+    }
+    sa_tile_queue.clear();
     glBindTexture(GL_TEXTURE_2D,0);
-    sa_pixel_ready.store(false);
 #endif
 }
 
+// sa_thread 본체 — 두 pass 스트리밍 렌더. 성공 시 FFT 행 수, 실패/취소 시 -1.
+int64_t FFTViewer::sa_render(int fft_req, int win_type, int64_t n_samples,
+                             const std::function<void(int64_t,int,float*)>& fill,
+                             float sample_scale){
+    SaGeom g;
+    if(!sa_plan_geom(fft_req, n_samples, g)) return -1;
+    const int n = g.fft_n;
+    const float scale = sample_scale / n;
+
+    std::vector<float> win;
+    sa_build_window(win, n, win_type);
+
+    int n_thr = (int)std::thread::hardware_concurrency();
+    n_thr = std::max(1, std::min(n_thr, 8));
+    n_thr = (int)std::min<int64_t>(n_thr, std::max<int64_t>(1, g.out_rows / SA_TILE_ROWS));
+    std::vector<SaWorker> workers(n_thr);
+    for(auto& w : workers) w.init(n);   // 플랜 생성은 이 스레드에서 순차
+
+    // ── pass 1: quantile sketch (균등 간격 출력 행 샘플) ──────────────────
+    int64_t n_sk = std::min<int64_t>(g.out_rows, SA_SKETCH_ROWS);
+    std::vector<QuantileSketch> sk(n_thr);
+    sa_run_pool(n_thr, n_sk, sa_cancel, [&](int wi, int64_t k){
+        int64_t r = (n_sk > 1) ? k * (g.out_rows - 1) / (n_sk - 1) : 0;
+        sa_out_row(workers[wi], g, fill, scale, win.data(), r);
+        sk[wi].add(workers[wi].row.data(), n);
+    });
+    if(sa_cancel.load()) return -1;
+    for(int t = 1; t < n_thr; t++) sk[0].merge(sk[t]);
+    const QuantileSketch& s = sk[0];
+
+    // 1) dB 범위 파악 (1st~99th percentile)
+    float db_lo = s.quantile(0.01);
+    float db_hi = s.quantile(0.99);
+    if(db_hi - db_lo < 1.0f) db_hi = db_lo + 1.0f;
+    // 2) 256-bin 누적분포 → 히스토그램 이퀄라이제이션 LUT (범위 밖 값은 양끝 bin)
+    const float db_rng_inv = 1.0f / (db_hi - db_lo);
+    const float bin_w = (db_hi - db_lo) / (SA_LUT_BINS - 1);
+    std::vector<double> cdf(SA_LUT_BINS);
+    for(int i=0;i<SA_LUT_BINS-1;i++) cdf[i] = s.count_below(db_lo + (i+1) * bin_w);
+    cdf[SA_LUT_BINS-1] = (double)s.count();
+    double cdf_min = cdf[0];
+    double cdf_rng = cdf[SA_LUT_BINS-1] - cdf_min;
+    if(cdf_rng < 1.0) cdf_rng = 1.0;
+    // jet 색상 LUT 사전계산 (픽셀마다 sa_jet 재계산 방지)
+    std::vector<uint32_t> color_lut(SA_LUT_BINS);
+    for(int i=0;i<SA_LUT_BINS;i++) color_lut[i] = sa_jet((float)((cdf[i]-cdf_min)/cdf_rng));
+
+    // ── pass 2: tile 렌더 ─────────────────────────────────────────────────
+    int64_t n_tiles = (g.out_rows + SA_TILE_ROWS - 1) / SA_TILE_ROWS;
+    uint32_t* px;
+    {
+        std::lock_guard<std::mutex> lk(sa_pixel_mtx);
+        sa_pixel_buf.assign((size_t)g.out_rows * n, 0u);
+        sa_tile_queue.clear();
+        sa_tex_w       = n;
+        sa_tex_h       = (int)g.out_rows;
+        sa_tex_realloc = true;
+        px = sa_pixel_buf.data();
+    }
+    // SA 좌표 메타데이터 (뷰 계산에 사용) — 첫 tile 표시 전에 확정
+    sa_total_rows   = g.rows;
+    sa_actual_fft_n = n;
+    sa_tiles_total.store(n_tiles);
+    sa_tiles_done.store(0);
+
+    sa_run_pool(n_thr, n_tiles, sa_cancel, [&](int wi, int64_t t){
+        SaWorker& w = workers[wi];
+        int64_t r0 = t * SA_TILE_ROWS;
+        int64_t r1 = std::min(g.out_rows, r0 + SA_TILE_ROWS);
+        for(int64_t r = r0; r < r1; r++){
+            sa_out_row(w, g, fill, scale, win.data(), r);
+            uint32_t* dst = px + (size_t)r * n;
+            for(int i=0;i<n;i++){
+                int b = (int)((w.row[i] - db_lo) * db_rng_inv * (SA_LUT_BINS-1));
+                b = b<0?0:b>=SA_LUT_BINS?SA_LUT_BINS-1:b;
+                dst[i] = color_lut[b];
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lk(sa_pixel_mtx);
+            sa_tile_queue.push_back((int)t);
+        }
+        sa_tiles_done.fetch_add(1);
+        sa_pixel_ready.store(true);
+    });
+    if(sa_cancel.load()) return -1;
+    return g.rows;
+}
+
 void FFTViewer::sa_start(const std::string& wav_path){
     // 이전 스레드 정리
+    sa_cancel.store(true);
     if(sa_thread.joinable()) sa_thread.join();
+    sa_cancel.store(false);
     sa_computing.store(true);
     sa_pixel_ready.store(false);
+    sa_tiles_done.store(0);
     sa_temp_path = wav_path;  // 경로 보존 (FFT 재계산 시 사용)
 
     int fft_n = sa_fft_size;
@@ -97,7 +325,7 @@ void FFTViewer::sa_start(const std::string& wav_path){
         // ── IQ 소스 열기 (SigMF .sigmf-data 또는 legacy .wav + bewe 청크) ──
         SigMF::Source src;
         if(!SigMF::open_source(wav_path, src)){ sa_computing.store(false); return; }
-        FILE* f = src.f;   // open_source가 데이터 시작 위치로 seek 완료
+        FILE* f = src.f;
 
         // SA 메타데이터 저장
         sa_center_freq_hz = src.center_freq_hz;
@@ -108,151 +336,58 @@ void FFTViewer::sa_start(const std::string& wav_path){
         if(data_bytes_actual <= 0){ fclose(f); sa_computing.store(false); return; }
         int64_t n_samples = data_bytes_actual / (int64_t)(2*sizeof(int16_t));
 
-        // FFT size 자동 축소: n_samples에 맞는 가장 큰 2의 거듭제곱
-        int actual_fft_n = fft_n;
-        while(actual_fft_n > 32 && n_samples < (int64_t)actual_fft_n)
-            actual_fft_n >>= 1;
-        if(n_samples < (int64_t)actual_fft_n){ fclose(f); sa_computing.store(false); return; }
-
-        // 전체 IQ 로드
-        std::vector<int16_t> raw(n_samples*2);
-        fread(raw.data(), sizeof(int16_t), (size_t)(n_samples*2), f);
-        fclose(f);
-
-        // ── FFTW 플랜 ─────────────────────────────────────────────────────
-        std::vector<float> in_f(actual_fft_n*2);
-        fftwf_complex* out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*actual_fft_n);
-        fftwf_plan plan = fftwf_plan_dft_1d(actual_fft_n,
-                              (fftwf_complex*)in_f.data(), out,
-                              FFTW_FORWARD, FFTW_ESTIMATE);
-
-        int64_t hop  = actual_fft_n;
-        int64_t rows = n_samples / hop;
-        // rows 부족 시 50% 오버랩으로 보완
-        if(rows < 8 && actual_fft_n > 1){
-            hop  = std::max((int64_t)1, hop / 2);
-            rows = (n_samples - actual_fft_n) / hop + 1;
-        }
-        if(rows < 1){ fftwf_destroy_plan(plan); fftwf_free(out); sa_computing.store(false); return; }
-
-        // ── power 누산 → normalize 범위 파악 ─────────────────────────────
-        // 첫 패스: min/max dB 파악
-        std::vector<float> all_db(rows * actual_fft_n);
-        const float scale = 1.0f / (32768.0f * actual_fft_n);
-
-        std::vector<float> win;
-        sa_build_window(win, actual_fft_n, win_type);
-
-        for(int64_t r=0; r<rows; r++){
-            for(int i=0;i<actual_fft_n;i++){
-                in_f[i*2  ] = raw[(r*hop+i)*2  ] * scale;
-                in_f[i*2+1] = raw[(r*hop+i)*2+1] * scale;
+        // 파일 전체 mmap (out-of-core) — 실패 시 pread 로 행 단위 읽기
+        int fd = fileno(f);
+        struct stat st{};
+        const uint8_t* map = nullptr;
+        size_t map_size = 0;
+        if(fstat(fd, &st) == 0 && st.st_size > 0){
+            void* m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if(m != MAP_FAILED){
+                map = (const uint8_t*)m;
+                map_size = (size_t)st.st_size;
+                posix_madvise(m, map_size, POSIX_MADV_SEQUENTIAL);
             }
-            sa_apply_window(in_f.data(), actual_fft_n, win.data());
-            fftwf_execute(plan);
-
-            int half = actual_fft_n/2;
-            // FFT shift: 음수 주파수 → 양수
-            for(int i=0;i<actual_fft_n;i++){
-                int bin = (i + half) % actual_fft_n;
-                float re=out[bin][0], im=out[bin][1];
-                float ms = re*re+im*im+1e-12f;
-                all_db[r*actual_fft_n+i] = 10.0f*log10f(ms);
-            }
-            // DC bin 억제
-            all_db[r*actual_fft_n + half] = all_db[r*actual_fft_n + half - 1];
         }
-
-        fftwf_destroy_plan(plan); fftwf_free(out);
-
-        // ── 히스토그램 이퀄라이제이션으로 대비 극대화 ───────────────────
-        // 1) dB 범위 파악 (1st~99th percentile) — nth_element 2단계 (전체 sort 회피)
-        std::vector<float> sorted_db(all_db);
-        size_t lo_idx = (size_t)(sorted_db.size()*0.01f);
-        size_t hi_idx = (size_t)(sorted_db.size()*0.99f);
-        std::nth_element(sorted_db.begin(), sorted_db.begin()+lo_idx, sorted_db.end());
-        float db_lo = sorted_db[lo_idx];
-        std::nth_element(sorted_db.begin()+lo_idx, sorted_db.begin()+hi_idx, sorted_db.end());
-        float db_hi = sorted_db[hi_idx];
-        if(db_hi - db_lo < 1.0f) db_hi = db_lo + 1.0f;
-
-        // 2) 256-bin 히스토그램 누적분포함수(CDF) 계산
-        const int BINS = 256;
-        std::vector<int> hist(BINS, 0);
-        float db_rng_inv = 1.0f / (db_hi - db_lo);
-        for(float v : all_db){
-            int b = (int)((v - db_lo) * db_rng_inv * (BINS-1));
-            b = b<0?0:b>=BINS?BINS-1:b;
-            hist[b]++;
-        }
-        // CDF 정규화 → 룩업테이블
-        std::vector<float> cdf(BINS);
-        cdf[0] = hist[0];
-        for(int i=1;i<BINS;i++) cdf[i] = cdf[i-1] + hist[i];
-        float cdf_min = *std::min_element(cdf.begin(), cdf.end());
-        float cdf_rng = cdf[BINS-1] - cdf_min;
-        if(cdf_rng < 1.0f) cdf_rng = 1.0f;
-        std::vector<float> lut(BINS);
-        for(int i=0;i<BINS;i++) lut[i] = (cdf[i]-cdf_min)/cdf_rng;
-        // jet 색상 LUT 사전계산 (픽셀마다 sa_jet 재계산 방지)
-        std::vector<uint32_t> color_lut(BINS);
-        for(int i=0;i<BINS;i++) color_lut[i] = sa_jet(lut[i]);
-
-        // ── 픽셀 버퍼 생성 (히스토그램 이퀄라이제이션 LUT 적용) ──────────
-        // GL 호출은 메인 스레드에서만 가능 — 기본 상한값 사용
-        int max_tex = 16384;
-
-        // rows가 최대 텍스처 높이 초과 시 행 병합 (시간축 다운샘플)
-        int64_t out_rows = rows;
-        int merge = 1;
-        while(out_rows > (int64_t)max_tex){
-            merge++;
-            out_rows = rows / merge;
-        }
-        if(out_rows < 1) out_rows = 1;
-
-        std::vector<uint32_t> pixels(out_rows * actual_fft_n);
-        for(int64_t r=0; r<out_rows; r++){
-            for(int i=0;i<actual_fft_n;i++){
-                // merge행 평균 dB → LUT
-                float db_avg = 0.0f;
-                int cnt = 0;
-                for(int m=0; m<merge; m++){
-                    int64_t src_r = r*merge + m;
-                    if(src_r >= rows) break;
-                    db_avg += all_db[src_r*actual_fft_n+i];
-                    cnt++;
-                }
-                if(cnt > 0) db_avg /= cnt;
-                int b = (int)((db_avg - db_lo) * db_rng_inv * (BINS-1));
-                b = b<0?0:b>=BINS?BINS-1:b;
-                pixels[r*actual_fft_n+i] = color_lut[b];
+        const int64_t data_off = src.data_offset;
+        if(map && (uint64_t)data_off + (uint64_t)n_samples * 4 > map_size)
+            n_samples = ((int64_t)map_size - data_off) / 4;
+
+        auto fill = [&](int64_t s0, int cnt, float* iq){
+            const int16_t* p;
+            if(map){
+                p = (const int16_t*)(map + data_off + s0 * 4);
+            } else {
+                // worker 별 버퍼 — cnt (= FFT 크기) 상한 없음
+                static thread_local std::vector<int16_t> tmp;
+                if(tmp.size() < (size_t)cnt * 2) tmp.resize((size_t)cnt * 2);
+                ssize_t got = pread(fd, tmp.data(), (size_t)cnt * 4, (off_t)(data_off + s0 * 4));
+                if(got < (ssize_t)cnt * 4)
+                    memset((uint8_t*)tmp.data() + (got > 0 ? got : 0), 0, (size_t)cnt * 4 - (got > 0 ? got : 0));
+                p = tmp.data();
             }
-        }
+            for(int i=0;i<cnt*2;i++) iq[i] = (float)p[i];
+        };
+        int64_t rows = sa_render(fft_n, win_type, n_samples, fill, 1.0f / 32768.0f);
 
-        // 메인 스레드로 전달
-        {
-            std::lock_guard<std::mutex> lk(sa_pixel_mtx);
-            sa_pixel_buf   = std::move(pixels);
-            sa_tex_w       = actual_fft_n;
-            sa_tex_h       = (int)out_rows;
-        }
-        // SA 좌표 메타데이터 저장 (뷰 계산에 사용)
-        sa_total_rows   = rows;    // 실제 FFT 행 수 (시간축)
-        sa_actual_fft_n = actual_fft_n;
+        if(map) munmap((void*)map, map_size);
+        fclose(f);
+        if(rows < 0){ sa_computing.store(false); return; }
         // 뷰 리셋은 호출부에서 관리 (FFT 변경 시 줌 유지)
         sa_sel_active = false;
-        bewe_log_push(0,"[SA] FFT done: %d bins, %lld rows\n", actual_fft_n, (long long)rows);
-        sa_pixel_ready.store(true);
+        bewe_log_push(0,"[SA] FFT done: %d bins, %lld rows\n", sa_actual_fft_n, (long long)rows);
         sa_computing.store(false);
     });
 }
 
 // ── 메모리 IQ에서 스펙트로그램 재계산 (Remove Samples 후) ──────────────────────
 void FFTViewer::sa_recompute_from_iq(bool reset_view){
+    sa_cancel.store(true);
     if(sa_thread.joinable()) sa_thread.join();
+    sa_cancel.store(false);
     sa_computing.store(true);
     sa_pixel_ready.store(false);
+    sa_tiles_done.store(0);
 
     int fft_n = sa_fft_size;
     int win_type = sa_window_type;
@@ -260,124 +395,25 @@ void FFTViewer::sa_recompute_from_iq(bool reset_view){
     double captured_t1 = eid_view_t1;
 
     sa_thread = std::thread([this, fft_n, win_type, reset_view, captured_t0, captured_t1](){
-        // IQ 데이터 복사
-        std::vector<float> chi_copy, chq_copy;
+        // IQ piece table 스냅샷 (버퍼 공유 — 샘플 복사 없음)
+        EidStore::Samples iq_snap;
         uint32_t sr;
         {
             std::lock_guard<std::mutex> lk(eid_data_mtx);
-            chi_copy = eid_ch_i;
-            chq_copy = eid_ch_q;
+            iq_snap = eid_iq;
             sr = eid_sample_rate;
         }
-        int64_t n_samples = (int64_t)chi_copy.size();
+        int64_t n_samples = iq_snap.size();
         if(n_samples < 1){ sa_computing.store(false); return; }
 
-        int actual_fft_n = fft_n;
-        while(actual_fft_n > 32 && n_samples < (int64_t)actual_fft_n)
-            actual_fft_n >>= 1;
-        if(n_samples < (int64_t)actual_fft_n){ sa_computing.store(false); return; }
-
-        // FFTW
-        std::vector<float> in_f(actual_fft_n*2);
-        fftwf_complex* out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*actual_fft_n);
-        fftwf_plan plan = fftwf_plan_dft_1d(actual_fft_n,
-                              (fftwf_complex*)in_f.data(), out,
-                              FFTW_FORWARD, FFTW_ESTIMATE);
-
-        int64_t hop = actual_fft_n;
-        int64_t rows = n_samples / hop;
-        if(rows < 8 && actual_fft_n > 1){
-            hop = std::max((int64_t)1, hop / 2);
-            rows = (n_samples - actual_fft_n) / hop + 1;
-        }
-        if(rows < 1){ fftwf_destroy_plan(plan); fftwf_free(out); sa_computing.store(false); return; }
-
-        // float IQ → FFT (scale = 1/fft_n, IQ 이미 [-1,1] 정규화됨)
-        const float scale = 1.0f / actual_fft_n;
-        std::vector<float> all_db(rows * actual_fft_n);
-        std::vector<float> win;
-        sa_build_window(win, actual_fft_n, win_type);
-        for(int64_t r=0; r<rows; r++){
-            for(int i=0;i<actual_fft_n;i++){
-                int64_t si = r*hop+i;
-                in_f[i*2  ] = chi_copy[si] * scale;
-                in_f[i*2+1] = chq_copy[si] * scale;
-            }
-            sa_apply_window(in_f.data(), actual_fft_n, win.data());
-            fftwf_execute(plan);
-            int half = actual_fft_n/2;
-            for(int i=0;i<actual_fft_n;i++){
-                int bin = (i + half) % actual_fft_n;
-                float re=out[bin][0], im=out[bin][1];
-                float ms = re*re+im*im+1e-12f;
-                all_db[r*actual_fft_n+i] = 10.0f*log10f(ms);
-            }
-            all_db[r*actual_fft_n + half] = all_db[r*actual_fft_n + half - 1];
-        }
-        fftwf_destroy_plan(plan); fftwf_free(out);
-
-        // 히스토그램 이퀄라이제이션 — nth_element 2단계 (전체 sort 회피)
-        std::vector<float> sorted_db(all_db);
-        size_t lo_idx = (size_t)(sorted_db.size()*0.01f);
-        size_t hi_idx = (size_t)(sorted_db.size()*0.99f);
-        std::nth_element(sorted_db.begin(), sorted_db.begin()+lo_idx, sorted_db.end());
-        float db_lo = sorted_db[lo_idx];
-        std::nth_element(sorted_db.begin()+lo_idx, sorted_db.begin()+hi_idx, sorted_db.end());
-        float db_hi = sorted_db[hi_idx];
-        if(db_hi - db_lo < 1.0f) db_hi = db_lo + 1.0f;
-
-        const int BINS = 256;
-        std::vector<int> hist(BINS, 0);
-        float db_rng_inv = 1.0f / (db_hi - db_lo);
-        for(float v : all_db){
-            int b = (int)((v - db_lo) * db_rng_inv * (BINS-1));
-            b = b<0?0:b>=BINS?BINS-1:b;
-            hist[b]++;
-        }
-        std::vector<float> cdf(BINS);
-        cdf[0] = hist[0];
-        for(int i=1;i<BINS;i++) cdf[i] = cdf[i-1] + hist[i];
-        float cdf_min = *std::min_element(cdf.begin(), cdf.end());
-        float cdf_rng = cdf[BINS-1] - cdf_min;
-        if(cdf_rng < 1.0f) cdf_rng = 1.0f;
-        std::vector<float> lut(BINS);
-        for(int i=0;i<BINS;i++) lut[i] = (cdf[i]-cdf_min)/cdf_rng;
-        // jet 색상 LUT 사전계산 (픽셀마다 sa_jet 재계산 방지)
-        std::vector<uint32_t> color_lut(BINS);
-        for(int i=0;i<BINS;i++) color_lut[i] = sa_jet(lut[i]);
-
-        // 픽셀 버퍼 생성
-        int max_tex = 16384;
-        int64_t out_rows = rows;
-        int merge = 1;
-        while(out_rows > (int64_t)max_tex){ merge++; out_rows = rows / merge; }
-        if(out_rows < 1) out_rows = 1;
-
-        std::vector<uint32_t> pixels(out_rows * actual_fft_n);
-        for(int64_t r=0; r<out_rows; r++){
-            for(int i=0;i<actual_fft_n;i++){
-                float db_avg = 0.0f; int cnt = 0;
-                for(int m=0; m<merge; m++){
-                    int64_t src_r = r*merge + m;
-                    if(src_r >= rows) break;
-                    db_avg += all_db[src_r*actual_fft_n+i]; cnt++;
-                }
-                if(cnt > 0) db_avg /= cnt;
-                int b = (int)((db_avg - db_lo) * db_rng_inv * (BINS-1));
-                b = b<0?0:b>=BINS?BINS-1:b;
-                pixels[r*actual_fft_n+i] = color_lut[b];
-            }
-        }
-
-        {
-            std::lock_guard<std::mutex> lk(sa_pixel_mtx);
-            sa_pixel_buf = std::move(pixels);
-            sa_tex_w = actual_fft_n;
-            sa_tex_h = (int)out_rows;
-        }
+        // float IQ (이미 [-1,1] 정규화됨). read_iq 는 const — worker 동시 호출 가능
+        auto fill = [&](int64_t s0, int cnt, float* iq){
+            iq_snap.read_iq(s0, cnt, iq);
+        };
         sa_sample_rate = sr;
-        sa_total_rows = rows;
-        sa_actual_fft_n = actual_fft_n;
+        int64_t rows = sa_render(fft_n, win_type, n_samples, fill, 1.0f);
+        if(rows < 0){ sa_computing.store(false); return; }
+
         if(reset_view){
             sa_view_y0=0.f; sa_view_y1=1.f;
             sa_view_x0=0.f; sa_view_x1=1.f;
@@ -393,8 +429,7 @@ void FFTViewer::sa_recompute_from_iq(bool reset_view){
             // x축(주파수)은 보존 — BPF/remove 후에도 주파수 줌 유지
         }
         sa_sel_active = false;
-        bewe_log_push(0,"[SA] recomputed: %d bins, %lld rows\n", actual_fft_n, (long long)rows);
-        sa_pixel_ready.store(true);
+        bewe_log_push(0,"[SA] recomputed: %d bins, %lld rows\n", sa_actual_fft_n, (long long)rows);
         sa_computing.store(false);
     });
 }
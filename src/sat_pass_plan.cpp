@@ -0,0 +1,296 @@
+#include "sat_pass_plan.hpp"
+#include "sat_prop.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <map>
+#include <thread>
+
+extern void bewe_log_push(int col, const char* fmt, ...);
+
+namespace SatPlan {
+
+namespace {
+    const double C_KMS      = 299792.458;
+    const double DOP_STEP_S = 5.0;      // Doppler grid; LEO rate ≤ ~100 Hz/s at UHF
+    const double END_PAD_S  = 2.0;      // sched_tick runs at 1 Hz → stop lands ≤ 1 s late
+
+    struct Cand {
+        const Downlink* dl;
+        time_t start, end;
+        float  max_el;
+        Band   band;
+        std::shared_ptr<const DopplerTrack> dop;
+    };
+
+    bool overlaps(const Cand& a, const Cand& b, float pre) {
+        double a0 = (double)a.start - pre, a1 = (double)a.end + END_PAD_S;
+        double b0 = (double)b.start - pre, b1 = (double)b.end + END_PAD_S;
+        return a0 < b1 && b0 < a1;
+    }
+
+    std::shared_ptr<const DopplerTrack> doppler(const TleElem& e, double f_hz,
+                                                double lat, double lon, double alt,
+                                                double t0, double t1) {
+        int n = (int)std::ceil((t1 - t0) / DOP_STEP_S) + 2;
+        std::vector<double> r((size_t)n);
+        SatProp::range_track(e, lat, lon, alt, t0, DOP_STEP_S, n, r.data());
+        auto d = std::make_shared<DopplerTrack>();
+        d->t0   = t0 + 0.5 * DOP_STEP_S;   // forward difference → interval midpoint
+        d->step = DOP_STEP_S;
+        d->hz.resize((size_t)(n - 1));
+        for (int k = 0; k + 1 < n; k++) {
+            if (r[k] <= 0 || r[k + 1] <= 0) { d->hz[k] = k ? d->hz[k - 1] : 0.f; continue; }
+            double rdot = (r[k + 1] - r[k]) / DOP_STEP_S;   // km/s, + = receding
+            d->hz[k] = (float)(-f_hz * rdot / C_KMS);
+        }
+        return d;
+    }
+}
+
+bool load_downlinks(const std::string& path, std::vector<Downlink>& out) {
+    out.clear();
+    FILE* fp = fopen(path.c_str(), "r");
+    if (!fp) return false;
+    char line[512];
+    int ln = 0;
+    while (fgets(line, sizeof line, fp)) {
+        ln++;
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == 0) continue;
+        Downlink d;
+        char mode[16] = {};
+        int used = 0;
+        if (sscanf(p, "%d %lf %f %15s%n", &d.catalog_num, &d.freq_mhz, &d.bw_khz, mode, &used) < 4
+            || d.catalog_num <= 0 || d.freq_mhz <= 0 || d.bw_khz <= 0) {
+            bewe_log_push(0, "[SATPLAN] %s:%d skipped (catalog freq_mhz bw_khz mode ...)\n",
+                          path.c_str(), ln);
+            continue;
+        }
+        strncpy(d.mode, mode, sizeof(d.mode) - 1);
+        p += used;
+        // optional numeric prio / min_el, rest = name
+        for (int k = 0; k < 2; k++) {
+            char* end = nullptr;
+            double v = strtod(p, &end);
+            if (end == p || (*end && *end != ' ' && *end != '\t' && *end != '\n' && *end != '\r')) break;
+            if (k == 0) d.prio = (int)v; else d.min_el = (float)v;
+            p = end;
+        }
+        while (*p == ' ' || *p == '\t') p++;
+        d.name = p;
+        while (!d.name.empty() && (d.name.back() == '\n' || d.name.back() == '\r' || d.name.back() == ' '))
+            d.name.pop_back();
+        out.push_back(std::move(d));
+    }
+    fclose(fp);
+    return true;
+}
+
+namespace {
+    void span_of(const std::vector<Band>& bands, double& lo, double& hi, double& g) {
+        lo = bands[0].lo_hz; hi = bands[0].hi_hz; g = 0;
+        for (const Band& b : bands) {
+            lo = std::min(lo, b.lo_hz);
+            hi = std::max(hi, b.hi_hz);
+            g  = std::max(g, 0.5 * (b.hi_hz - b.lo_hz));
+        }
+    }
+}
+
+bool covers(const std::vector<Band>& bands, double sr_hz, double cf_hz) {
+    if (bands.empty() || sr_hz <= 0) return false;
+    double lo, hi, g;
+    span_of(bands, lo, hi, g);
+    const double half = 0.45 * sr_hz, eps = 1.0;
+    if (cf_hz - half > lo + eps || cf_hz + half < hi - eps) return false;
+    for (const Band& b : bands)
+        if (cf_hz > b.lo_hz - g + eps && cf_hz < b.hi_hz + g - eps) return false;
+    return true;
+}
+
+bool pick_center(const std::vector<Band>& bands, double sr_hz,
+                 double fmin_hz, double fmax_hz, double& cf_hz) {
+    if (bands.empty() || sr_hz <= 0) return false;
+    double lo, hi, g;
+    span_of(bands, lo, hi, g);
+    const double half = 0.45 * sr_hz, mid = 0.5 * (lo + hi);
+    // Candidates: midpoint, just outside each band (upper side first), then the
+    // extreme tunings that still cover the span.
+    std::vector<double> c{ mid };
+    for (const Band& b : bands) { c.push_back(b.hi_hz + g); c.push_back(b.lo_hz - g); }
+    std::stable_sort(c.begin() + 1, c.end(),
+                     [&](double a, double b) { return std::fabs(a - mid) < std::fabs(b - mid); });
+    c.push_back(lo + half);
+    c.push_back(hi - half);
+    for (double v : c) {
+        if (fmax_hz > fmin_hz && (v < fmin_hz || v > fmax_hz)) continue;
+        if (covers(bands, sr_hz, v)) { cf_hz = v; return true; }
+    }
+    return false;
+}
+
+Result plan(const std::vector<Downlink>& dl, const std::vector<TleElem>& tles,
+            double lat_deg, double lon_deg, double alt_km,
+            time_t t0, double hours, const Limits& lim,
+            const std::function<bool()>& cancel) {
+    Result res;
+    std::map<int, const TleElem*> by_cat;
+    for (const TleElem& e : tles) by_cat[e.catalog_num] = &e;
+
+    // One pass search per distinct min_el (usually one or two groups).
+    std::map<float, std::vector<const Downlink*>> groups;
+    for (const Downlink& d : dl) {
+        if (!by_cat.count(d.catalog_num)) { res.missing_tle++; continue; }
+        groups[d.min_el].push_back(&d);
+    }
+    std::vector<Cand> cand;
+    for (auto& g : groups) {
+        std::vector<TleElem> sats;
+        std::map<int, size_t> idx;
+        for (const Downlink* d : g.second)
+            if (idx.emplace(d->catalog_num, sats.size()).second) sats.push_back(*by_cat[d->catalog_num]);
+        std::vector<std::vector<SatProp::Pass>> passes;
+        if (!SatProp::find_passes(sats, lat_deg, lon_deg, alt_km, t0, hours, g.first, passes, cancel))
+            return res;
+
+        for (const Downlink* d : g.second) {
+            const TleElem& e = sats[idx[d->catalog_num]];
+            const double f_hz = d->freq_mhz * 1e6, half_bw = d->bw_khz * 500.0;
+            for (const SatProp::Pass& p : passes[idx[d->catalog_num]]) {
+                time_t a = std::max(p.aos, t0), b = p.los;
+                if ((float)(b - a) < lim.min_dur_sec) continue;
+                res.passes++;
+                if (lim.fmax_hz > lim.fmin_hz && (f_hz - half_bw < lim.fmin_hz || f_hz + half_bw > lim.fmax_hz)) {
+                    res.dropped_limits++;
+                    continue;
+                }
+                Cand c{ d, a, b, p.max_el, {}, {} };
+                c.dop = doppler(e, f_hz, lat_deg, lon_deg, alt_km, (double)a - lim.pre_arm_sec, (double)b);
+                double ex = c.dop->max_abs();
+                c.band = { f_hz - half_bw - ex, f_hz + half_bw + ex };
+                double cf;
+                if (!pick_center({ c.band }, lim.sr_hz, lim.fmin_hz, lim.fmax_hz, cf)) {
+                    res.dropped_limits++;
+                    continue;
+                }
+                cand.push_back(std::move(c));
+            }
+        }
+    }
+
+    std::sort(cand.begin(), cand.end(), [](const Cand& a, const Cand& b) {
+        if (a.dl->prio != b.dl->prio) return a.dl->prio > b.dl->prio;
+        if (a.max_el != b.max_el)     return a.max_el > b.max_el;
+        return a.start < b.start;
+    });
+    std::vector<const Cand*> kept;
+    std::vector<Band> bands;
+    for (const Cand& c : cand) {
+        bands.assign(1, c.band);
+        int used = 1;
+        for (const Cand* k : kept)
+            if (overlaps(*k, c, lim.pre_arm_sec)) { bands.push_back(k->band); used++; }
+        double cf;
+        if (used > lim.max_slots || !pick_center(bands, lim.sr_hz, lim.fmin_hz, lim.fmax_hz, cf)) {
+            res.dropped_conflict++;
+            continue;
+        }
+        kept.push_back(&c);
+    }
+    std::sort(kept.begin(), kept.end(), [](const Cand* a, const Cand* b) { return a->start < b->start; });
+
+    res.items.reserve(kept.size());
+    for (const Cand* c : kept) {
+        Item it;
+        // Group CF: the scheduler tunes here when it has to, so every overlapping item
+        // still fits without retuning under a running recording.
+        bands.assign(1, c->band);
+        for (const Cand* k : kept)
+            if (k != c && overlaps(*k, *c, lim.pre_arm_sec)) bands.push_back(k->band);
+        if (!pick_center(bands, lim.sr_hz, lim.fmin_hz, lim.fmax_hz, it.cf_hz) &&
+            !pick_center({ c->band }, lim.sr_hz, lim.fmin_hz, lim.fmax_hz, it.cf_hz))
+            it.cf_hz = 0;
+        it.start       = c->start;
+        it.dur         = (float)(c->end - c->start);
+        it.freq_mhz    = c->dl->freq_mhz;
+        it.bw_khz      = c->dl->bw_khz;
+        it.catalog_num = c->dl->catalog_num;
+        it.prio        = c->dl->prio;
+        it.max_el      = c->max_el;
+        memcpy(it.mode, c->dl->mode, sizeof(it.mode));
+        it.name        = c->dl->name.empty() ? by_cat[c->dl->catalog_num]->name : c->dl->name;
+        it.dop         = c->dop;
+        res.items.push_back(std::move(it));
+    }
+    return res;
+}
+
+// ── Queue ────────────────────────────────────────────────────────────────
+namespace {
+    struct Later {
+        bool operator()(const Item& a, const Item& b) const { return a.start > b.start; }
+    };
+}
+
+void Queue::replace(std::vector<Item>&& items) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    time_t now = time(nullptr);
+    taken_.erase(std::remove_if(taken_.begin(), taken_.end(),
+                                [&](const Taken& t) { return t.end < now; }), taken_.end());
+    heap_.clear();
+    for (Item& it : items) {
+        bool dup = false;
+        for (const Taken& t : taken_)
+            if (t.catalog_num == it.catalog_num && t.freq_mhz == it.freq_mhz && it.start < t.end) { dup = true; break; }
+        if (!dup) heap_.push_back(std::move(it));
+    }
+    std::make_heap(heap_.begin(), heap_.end(), Later());
+}
+
+bool Queue::pop_due(time_t until, Item& out) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (heap_.empty() || heap_.front().start > until) return false;
+    std::pop_heap(heap_.begin(), heap_.end(), Later());
+    out = std::move(heap_.back());
+    heap_.pop_back();
+    taken_.push_back({ out.catalog_num, out.freq_mhz, out.start + (time_t)out.dur });
+    return true;
+}
+
+size_t Queue::size() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return heap_.size();
+}
+
+std::thread replan_async(std::shared_ptr<Queue> q, Params p) {
+    q->busy.store(true);
+    return std::thread([q, p]() {
+        std::vector<Downlink> dl;
+        load_downlinks(p.downlinks_path, dl);
+        std::vector<TleElem> tles, part;
+        if (DIR* d = opendir(p.tle_dir.c_str())) {
+            while (dirent* ent = readdir(d)) {
+                size_t n = strlen(ent->d_name);
+                if (n < 5 || strcmp(ent->d_name + n - 4, ".txt") != 0) continue;
+                if (tle_load(p.tle_dir + "/" + ent->d_name, part))
+                    tles.insert(tles.end(), part.begin(), part.end());
+            }
+            closedir(d);
+        }
+        Result r = plan(dl, tles, p.lat_deg, p.lon_deg, p.alt_km, time(nullptr), p.hours, p.lim,
+                        [&q]() { return q->cancel.load(std::memory_order_relaxed); });
+        if (q->cancel.load()) { q->busy.store(false); return; }
+        bewe_log_push(0, "[SATPLAN] %zu downlinks, %d passes / %.0f h -> %zu scheduled "
+                         "(conflict %d, SDR limits %d, no TLE %d)\n",
+                      dl.size(), r.passes, p.hours, r.items.size(),
+                      r.dropped_conflict, r.dropped_limits, r.missing_tle);
+        q->replace(std::move(r.items));
+        q->busy.store(false);
+    });
+}
+
+} // namespace SatPlan
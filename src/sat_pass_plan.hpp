@@ -0,0 +1,125 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Satellite-pass driven recording planner.
+//
+//   Downlink : one line of ~/BE_WE/sat_downlinks.txt
+//                catalog freq_mhz bw_khz mode [prio] [min_el] name...
+//              ('#' comment). prio: higher wins a conflict (default 0),
+//              min_el: deg (default 10).
+//   plan()   : TLEs (assets/tle/*.txt) → SatProp::find_passes per downlink → one
+//              candidate per pass with a Doppler track (range-rate, 5 s grid).
+//              Candidates are taken greedily by (prio, max elevation); a candidate
+//              is kept only if, together with every kept item overlapping it, it fits
+//              one SDR tuning (pick_center) and the channel slot budget.
+//   Queue    : plan output as a min-heap on start time. The scheduler pops items
+//              as they come into its lead window and turns them into SchedEntry rows;
+//              a replan replaces the heap but never re-emits what was already popped.
+//
+// Frequencies in Hz inside the planner, times in unix seconds.
+// ─────────────────────────────────────────────────────────────────────────────
+#include "doppler_track.hpp"
+#include "sat_tle.hpp"
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SatPlan {
+
+struct Downlink {
+    int         catalog_num = 0;
+    double      freq_mhz    = 0;
+    float       bw_khz      = 0;
+    char        mode[8]     = {};
+    int         prio        = 0;
+    float       min_el      = 10.f;
+    std::string name;
+};
+
+// false = file missing / unreadable. Bad lines are skipped with a log line.
+bool load_downlinks(const std::string& path, std::vector<Downlink>& out);
+
+// Occupied band of one channel (incl. Doppler excursion).
+struct Band { double lo_hz, hi_hz; };
+
+// cf_hz (SDR centre) keeps every band inside ±0.45·sr and DC at least half the widest
+// channel away from each band.
+bool covers(const std::vector<Band>& bands, double sr_hz, double cf_hz);
+
+// SDR centre frequency that covers every band inside ±0.45·sr without putting DC
+// inside (or within half the widest channel of) any band, and lies in [fmin, fmax].
+// Prefers the span midpoint; a single band gets the old "target + bw" DC offset.
+bool pick_center(const std::vector<Band>& bands, double sr_hz,
+                 double fmin_hz, double fmax_hz, double& cf_hz);
+
+struct Limits {
+    double sr_hz       = 0;
+    double fmin_hz     = 0, fmax_hz = 0;   // 0/0 = no limit
+    int    max_slots   = 1;                // channel slots the planner may use at once
+    float  pre_arm_sec = 5.f;              // SchedEntry pre-arm window (kept free)
+    float  min_dur_sec = 60.f;             // shorter passes are not worth a file
+};
+
+struct Item {
+    time_t      start = 0;                 // AOS (≥ plan t0)
+    float       dur   = 0;                 // LOS − AOS
+    double      freq_mhz = 0;
+    float       bw_khz   = 0;
+    int         catalog_num = 0;
+    int         prio  = 0;
+    float       max_el = 0;
+    char        mode[8] = {};
+    std::string name;
+    std::shared_ptr<const DopplerTrack> dop;
+    double      cf_hz = 0;                 // SDR centre covering this item and every kept item
+                                           // overlapping it (0 = none found; scheduler picks)
+};
+
+struct Result {
+    std::vector<Item> items;                // start-time order
+    int passes = 0, dropped_limits = 0, dropped_conflict = 0, missing_tle = 0;
+};
+
+Result plan(const std::vector<Downlink>& dl, const std::vector<TleElem>& tles,
+            double lat_deg, double lon_deg, double alt_km,
+            time_t t0, double hours, const Limits& lim,
+            const std::function<bool()>& cancel = {});
+
+class Queue {
+public:
+    // Items overlapping an already popped item of the same downlink are dropped
+    // (a replan may move AOS by a second — must not record the pass twice).
+    void   replace(std::vector<Item>&& items);
+    // Earliest item with start ≤ until → out. false = none due.
+    bool   pop_due(time_t until, Item& out);
+    size_t size() const;
+
+    std::atomic<bool> busy{false};         // replan in flight
+    std::atomic<bool> cancel{false};       // owner shutting down → abandon replan
+    time_t next_plan  = 0;                 // scheduler-owned (sched_mtx)
+    time_t file_mtime = 0;
+    double st_lat = 0, st_lon = 0;
+
+private:
+    mutable std::mutex mtx_;
+    struct Taken { int catalog_num; double freq_mhz; time_t end; };
+    std::vector<Item>  heap_;
+    std::vector<Taken> taken_;
+};
+
+struct Params {
+    std::string downlinks_path, tle_dir;
+    double lat_deg = 0, lon_deg = 0, alt_km = 0;
+    double hours = 24.0;
+    Limits lim;
+};
+
+// Worker thread: load files, plan from now, q->replace(). Sets/clears q->busy.
+// The caller owns (joins) the returned thread; set q->cancel first to cut a long plan short.
+std::thread replan_async(std::shared_ptr<Queue> q, Params p);
+
+} // namespace SatPlan
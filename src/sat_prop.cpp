@@ -0,0 +1,615 @@
+#include "sat_prop.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+extern void bewe_log_push(int col, const char* fmt, ...);
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace SatProp {
+
+namespace {
+    const double TWOPI = 2.0 * M_PI;
+    const double WGS84_A = 6378.137, WGS84_F = 1.0 / 298.257223563;
+    const double WGS84_E2 = 2 * WGS84_F - WGS84_F * WGS84_F;
+    const int    DEEP_CHUNK = 16;     // deep-space objects per work item
+
+    // fmod(x, 2π) without the libm call (keeps the lane loop vectorisable).
+    inline double wrap2pi(double x) { return x - TWOPI * std::trunc(x / TWOPI); }
+    // std::min/max take references, which keeps `omp simd` loops scalar.
+    inline double clampd(double x, double lo, double hi) { return std::fmin(std::fmax(x, lo), hi); }
+
+    inline double jd_of(double t_utc) { return 2440587.5 + t_utc / 86400.0; }
+    inline double epoch_of(const elsetrec& r) { return r.jdsatepoch + r.jdsatepochF; }
+
+    int auto_threads(size_t items) {
+        int n = (int)std::thread::hardware_concurrency();
+        n = std::max(1, std::min(n, 8));
+        return (int)std::min<size_t>((size_t)n, std::max<size_t>(1, items / 8));
+    }
+
+    // sa_run_pool 과 같은 방식: 호출마다 스레드, 작업은 atomic 인덱스로 분배.
+    template<class Fn>
+    void run_pool(int n_thr, size_t n_items, Fn fn) {
+        std::atomic<size_t> next{0};
+        auto body = [&]() {
+            for (;;) {
+                size_t it = next.fetch_add(1);
+                if (it >= n_items) return;
+                fn(it);
+            }
+        };
+        std::vector<std::thread> thr;
+        for (int t = 1; t < n_thr; t++) thr.emplace_back(body);
+        body();
+        for (auto& t : thr) t.join();
+    }
+
+    bool deep_ecef(elsetrec& rec, double jd, double cg, double sg,
+                   double& x, double& y, double& z) {
+        double r[3], v[3];
+        double tsince = (jd - epoch_of(rec)) * 1440.0;
+        if (!SGP4Funcs::sgp4(rec, tsince, r, v)) { x = y = z = 0.0; return false; }
+        x =  r[0] * cg + r[1] * sg;
+        y = -r[0] * sg + r[1] * cg;
+        z =  r[2];
+        return true;
+    }
+}
+
+// ── Batch ────────────────────────────────────────────────────────────────
+void Batch::clear() {
+    n_ = 0;
+    near_idx_.clear(); deep_idx_.clear(); deep_rec_.clear();
+    for (auto* v : { &epoch_, &mo_, &mdot_, &argpo_, &argpdot_, &nodeo_, &nodedot_, &nodecf_,
+                     &cc1_, &cc4_, &cc5_, &bstar_, &d2_, &d3_, &d4_, &t2cof_, &t3cof_, &t4cof_,
+                     &t5cof_, &omgcof_, &eta_, &xmcof_, &delmo_, &sinmao_, &no_, &ecco_, &inclo_,
+                     &aycof_, &xlcof_, &con41_, &x1mth2_, &x7thm1_, &sinio_, &cosio_, &a0_ })
+        v->clear();
+}
+
+void Batch::build(const std::vector<TleElem>& sats) {
+    std::vector<const TleElem*> p(sats.size());
+    for (size_t i = 0; i < sats.size(); i++) p[i] = &sats[i];
+    build(p);
+}
+
+void Batch::build(const std::vector<const TleElem*>& sats) {
+    clear();
+    n_ = sats.size();
+    for (size_t i = 0; i < n_; i++) {
+        const elsetrec& r = sats[i]->satrec;
+        if (r.method == 'd') {
+            deep_idx_.push_back((uint32_t)i);
+            deep_rec_.push_back(r);
+            continue;
+        }
+        near_idx_.push_back((uint32_t)i);
+        j2_ = r.j2; re_km_ = r.radiusearthkm;
+        // isimp: the secular drag terms it skips are zeroed here so the lane
+        // loop needs no branch (d2..t5cof are already 0 from sgp4init).
+        bool simp = r.isimp == 1;
+        epoch_.push_back(epoch_of(r));
+        mo_.push_back(r.mo);         mdot_.push_back(r.mdot);
+        argpo_.push_back(r.argpo);   argpdot_.push_back(r.argpdot);
+        nodeo_.push_back(r.nodeo);   nodedot_.push_back(r.nodedot);
+        nodecf_.push_back(r.nodecf); cc1_.push_back(r.cc1);
+        cc4_.push_back(r.cc4);       cc5_.push_back(simp ? 0.0 : r.cc5);
+        bstar_.push_back(r.bstar);
+        d2_.push_back(simp ? 0.0 : r.d2);  d3_.push_back(simp ? 0.0 : r.d3);
+        d4_.push_back(simp ? 0.0 : r.d4);
+        t2cof_.push_back(r.t2cof);
+        t3cof_.push_back(simp ? 0.0 : r.t3cof); t4cof_.push_back(simp ? 0.0 : r.t4cof);
+        t5cof_.push_back(simp ? 0.0 : r.t5cof);
+        omgcof_.push_back(simp ? 0.0 : r.omgcof);
+        eta_.push_back(r.eta);
+        xmcof_.push_back(simp ? 0.0 : r.xmcof);
+        delmo_.push_back(r.delmo);   sinmao_.push_back(r.sinmao);
+        no_.push_back(r.no_unkozai); ecco_.push_back(r.ecco);
+        inclo_.push_back(r.inclo);
+        aycof_.push_back(r.aycof);   xlcof_.push_back(r.xlcof);
+        con41_.push_back(r.con41);   x1mth2_.push_back(r.x1mth2);
+        x7thm1_.push_back(r.x7thm1);
+        sinio_.push_back(std::sin(r.inclo)); cosio_.push_back(std::cos(r.inclo));
+        a0_.push_back(std::pow(r.xke / r.no_unkozai, 2.0 / 3.0));
+    }
+}
+
+// SGP4Funcs::sgp4 near-earth branch (position only) over m ≤ TILE lanes.
+// Error codes 1/4/6 become ok = 0; code 2 (nm ≤ 0) cannot occur after sgp4init.
+void Batch::near_tile(size_t k0, int m, double jd, double cg, double sg,
+                      double* ox, double* oy, double* oz, uint8_t* ook) const {
+    const double j2 = j2_, re = re_km_;
+    const double *EP = &epoch_[k0], *MO = &mo_[k0], *MDOT = &mdot_[k0], *ARGPO = &argpo_[k0],
+                 *ARGPDOT = &argpdot_[k0], *NODEO = &nodeo_[k0], *NODEDOT = &nodedot_[k0],
+                 *NODECF = &nodecf_[k0], *CC1 = &cc1_[k0], *CC4 = &cc4_[k0], *CC5 = &cc5_[k0],
+                 *BSTAR = &bstar_[k0], *D2 = &d2_[k0], *D3 = &d3_[k0], *D4 = &d4_[k0],
+                 *T2C = &t2cof_[k0], *T3C = &t3cof_[k0], *T4C = &t4cof_[k0], *T5C = &t5cof_[k0],
+                 *OMGCOF = &omgcof_[k0], *ETA = &eta_[k0], *XMCOF = &xmcof_[k0],
+                 *DELMO = &delmo_[k0], *SINMAO = &sinmao_[k0], *NO = &no_[k0],
+                 *ECCO = &ecco_[k0], *INCLO = &inclo_[k0], *AYCOF = &aycof_[k0],
+                 *XLCOF = &xlcof_[k0], *CON41 = &con41_[k0], *X1MTH2 = &x1mth2_[k0],
+                 *X7THM1 = &x7thm1_[k0], *SINIO = &sinio_[k0], *COSIO = &cosio_[k0],
+                 *A0 = &a0_[k0];
+
+    alignas(64) double am[TILE], nodep[TILE], axnl[TILE], aynl[TILE],
+                       u[TILE], eo1[TILE], sn[TILE], cs[TILE],
+                       em_raw[TILE], pl_raw[TILE], mrt_raw[TILE];
+
+    // ── secular gravity + drag, mean elements ────────────────────────────
+    #pragma omp simd
+    for (int j = 0; j < m; j++) {
+        double t  = (jd - EP[j]) * 1440.0;
+        double t2 = t * t, t3 = t2 * t, t4 = t3 * t;
+        double xmdf   = MO[j] + MDOT[j] * t;
+        double argpdf = ARGPO[j] + ARGPDOT[j] * t;
+        double nodem  = NODEO[j] + NODEDOT[j] * t + NODECF[j] * t2;
+        double dmt    = 1.0 + ETA[j] * std::cos(xmdf);
+        double temp   = OMGCOF[j] * t + XMCOF[j] * (dmt * dmt * dmt - DELMO[j]);
+        double mm     = xmdf + temp;
+        double argpm  = argpdf - temp;
+        double tempa  = 1.0 - CC1[j] * t - D2[j] * t2 - D3[j] * t3 - D4[j] * t4;
+        double tempe  = BSTAR[j] * CC4[j] * t + BSTAR[j] * CC5[j] * (std::sin(mm) - SINMAO[j]);
+        double templ  = T2C[j] * t2 + T3C[j] * t3 + t4 * (T4C[j] + t * T5C[j]);
+
+        double a  = A0[j] * tempa * tempa;
+        double em = ECCO[j] - tempe;
+        em_raw[j] = em;
+        em = clampd(em, 1.0e-6, 0.999);
+        mm += NO[j] * templ;
+        double xlm = mm + argpm + nodem;
+        nodem = wrap2pi(nodem);
+        argpm = wrap2pi(argpm);
+        xlm   = wrap2pi(xlm);
+        mm    = wrap2pi(xlm - argpm - nodem);
+
+        double ci = std::cos(argpm), si = std::sin(argpm);
+        double tp = 1.0 / (a * (1.0 - em * em));
+        double ax = em * ci;
+        double ay = em * si + tp * AYCOF[j];
+        double xl = mm + argpm + nodem + tp * XLCOF[j] * ax;
+        am[j] = a; nodep[j] = nodem;
+        axnl[j] = ax; aynl[j] = ay;
+        u[j] = eo1[j] = wrap2pi(xl - nodem);
+    }
+
+    // ── Kepler: same clamped Newton step as sgp4(); the tile stops when every
+    //    lane has converged (≤ 10 passes) so lanes stay in lock-step ─────────
+    for (int ktr = 0; ktr < 10; ktr++) {
+        double worst = 0.0;
+        #pragma omp simd reduction(max:worst)
+        for (int j = 0; j < m; j++) {
+            double s = std::sin(eo1[j]), c = std::cos(eo1[j]);
+            double tem5 = (u[j] - aynl[j] * c + axnl[j] * s - eo1[j])
+                        / (1.0 - c * axnl[j] - s * aynl[j]);
+            tem5 = clampd(tem5, -0.95, 0.95);
+            eo1[j] += tem5;
+            sn[j] = s; cs[j] = c;
+            double at = std::fabs(tem5);
+            worst = at > worst ? at : worst;
+        }
+        if (worst < 1.0e-12) break;
+    }
+
+    // ── short-period periodics, orientation, TEME → ECEF ─────────────────
+    #pragma omp simd
+    for (int j = 0; j < m; j++) {
+        double a = am[j], ax = axnl[j], ay = aynl[j];
+        double ecose = ax * cs[j] + ay * sn[j];
+        double esine = ax * sn[j] - ay * cs[j];
+        double el2   = ax * ax + ay * ay;
+        double pl    = a * (1.0 - el2);
+        pl_raw[j] = pl;
+        pl = pl < 1.0e-9 ? 1.0e-9 : pl;
+        double rl    = a * (1.0 - ecose);
+        double betal = std::sqrt(clampd(1.0 - el2, 0.0, 1.0));
+        double temp  = esine / (1.0 + betal);
+        double sinu  = a / rl * (sn[j] - ay - ax * temp);
+        double cosu  = a / rl * (cs[j] - ax + ay * temp);
+        double su    = std::atan2(sinu, cosu);
+        double sin2u = (cosu + cosu) * sinu;
+        double cos2u = 1.0 - 2.0 * sinu * sinu;
+        double temp1 = 0.5 * j2 / pl;
+        double temp2 = temp1 / pl;
+        double cosip = COSIO[j], sinip = SINIO[j];
+
+        double mrt   = rl * (1.0 - 1.5 * temp2 * betal * CON41[j])
+                     + 0.5 * temp1 * X1MTH2[j] * cos2u;
+        su -= 0.25 * temp2 * X7THM1[j] * sin2u;
+        double xnode = nodep[j] + 1.5 * temp2 * cosip * sin2u;
+        double xinc  = INCLO[j] + 1.5 * temp2 * cosip * sinip * cos2u;
+        mrt_raw[j] = mrt;
+
+        double sinsu = std::sin(su),    cossu = std::cos(su);
+        double snod  = std::sin(xnode), cnod  = std::cos(xnode);
+        double sini  = std::sin(xinc),  cosi  = std::cos(xinc);
+        double ux = (-snod * cosi) * sinsu + cnod * cossu;
+        double uy = ( cnod * cosi) * sinsu + snod * cossu;
+        double uz = sini * sinsu;
+        double rx = mrt * ux * re, ry = mrt * uy * re, rz = mrt * uz * re;
+        ox[j] =  rx * cg + ry * sg;
+        oy[j] = -rx * sg + ry * cg;
+        oz[j] =  rz;
+    }
+
+    // ── sgp4 error codes 1 / 4 / 6 (kept out of the math loops: a compare
+    //    there becomes a branch and the loop stays scalar) ─────────────────
+    for (int j = 0; j < m; j++) {
+        bool bad = em_raw[j] >= 1.0 || em_raw[j] < -0.001 || pl_raw[j] < 0.0 || mrt_raw[j] < 1.0;
+        if (bad) ox[j] = oy[j] = oz[j] = 0.0;
+        ook[j] = bad ? 0 : 1;
+    }
+}
+
+template<class Fn>
+void Batch::run(double t_utc, int threads, Fn out) const {
+    if (n_ == 0) return;
+    double jd  = jd_of(t_utc);
+    double gst = SGP4Funcs::gstime_SGP4(jd);
+    double cg = std::cos(gst), sg = std::sin(gst);
+
+    size_t n_near = near_idx_.size(), n_deep = deep_idx_.size();
+    size_t near_items = (n_near + TILE - 1) / TILE;
+    size_t deep_items = (n_deep + DEEP_CHUNK - 1) / DEEP_CHUNK;
+    size_t items = near_items + deep_items;
+    int thr = threads > 0 ? threads : auto_threads(items);
+
+    run_pool(thr, items, [&](size_t it) {
+        alignas(64) double x[TILE], y[TILE], z[TILE];
+        uint8_t ok[TILE];
+        const uint32_t* idx;
+        int m;
+        if (it < near_items) {
+            size_t k0 = it * TILE;
+            m = (int)std::min<size_t>(TILE, n_near - k0);
+            near_tile(k0, m, jd, cg, sg, x, y, z, ok);
+            idx = &near_idx_[k0];
+        } else {
+            size_t k0 = (it - near_items) * DEEP_CHUNK;
+            m = (int)std::min<size_t>(DEEP_CHUNK, n_deep - k0);
+            for (int j = 0; j < m; j++) {
+                elsetrec rec = deep_rec_[k0 + j];   // sgp4 mutates the deep-space state
+                ok[j] = deep_ecef(rec, jd, cg, sg, x[j], y[j], z[j]) ? 1 : 0;
+            }
+            idx = &deep_idx_[k0];
+        }
+        out(idx, m, x, y, z, ok);
+    });
+}
+
+void Batch::ecef(double t_utc, double* x, double* y, double* z, uint8_t* ok, int threads) const {
+    run(t_utc, threads, [&](const uint32_t* idx, int m, const double* tx, const double* ty,
+                            const double* tz, const uint8_t* tok) {
+        for (int j = 0; j < m; j++) {
+            uint32_t i = idx[j];
+            x[i] = tx[j]; y[i] = ty[j]; z[i] = tz[j]; ok[i] = tok[j];
+        }
+    });
+}
+
+void Batch::geodetic(double t_utc, double* lat, double* lon, double* alt,
+                     uint8_t* ok, int threads) const {
+    run(t_utc, threads, [&](const uint32_t* idx, int m, const double* tx, const double* ty,
+                            const double* tz, const uint8_t* tok) {
+        alignas(64) double la[TILE], lo[TILE], al[TILE];
+        ecef_to_geodetic(tx, ty, tz, (size_t)m, la, lo, al);
+        for (int j = 0; j < m; j++) {
+            uint32_t i = idx[j];
+            bool g = tok[j] != 0;
+            lat[i] = g ? la[j] : 0.0; lon[i] = g ? lo[j] : 0.0; alt[i] = g ? al[j] : 0.0;
+            ok[i] = tok[j];
+        }
+    });
+}
+
+// ── scalar helpers ───────────────────────────────────────────────────────
+bool ecef_one(const TleElem& e, double t_utc, double& x, double& y, double& z) {
+    double jd  = jd_of(t_utc);
+    double gst = SGP4Funcs::gstime_SGP4(jd);
+    elsetrec rec = e.satrec;
+    return deep_ecef(rec, jd, std::cos(gst), std::sin(gst), x, y, z);
+}
+
+void ecef_to_geodetic(const double* x, const double* y, const double* z, size_t n,
+                      double* lat_deg, double* lon_deg, double* alt_km) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        double p   = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+        double lat = std::atan2(z[i], p);
+        for (int k = 0; k < 5; k++) {
+            double s = std::sin(lat);
+            double N = WGS84_A / std::sqrt(1.0 - WGS84_E2 * s * s);
+            lat = std::atan2(z[i] + WGS84_E2 * N * s, p);
+        }
+        double s = std::sin(lat);
+        double N = WGS84_A / std::sqrt(1.0 - WGS84_E2 * s * s);
+        alt_km[i]  = p / std::cos(lat) - N;
+        lat_deg[i] = lat * 180.0 / M_PI;
+        lon_deg[i] = std::atan2(y[i], x[i]) * 180.0 / M_PI;
+    }
+}
+
+void track(const TleElem& e, double t0, double dt, int n,
+           double* lat_deg, double* lon_deg, double* alt_km) {
+    if (n <= 0) return;
+    std::vector<double> x((size_t)n), y((size_t)n), z((size_t)n);
+    std::vector<uint8_t> ok((size_t)n);
+    elsetrec rec = e.satrec;   // one copy for the whole track
+    for (int k = 0; k < n; k++) {
+        double jd  = jd_of(t0 + dt * k);
+        double gst = SGP4Funcs::gstime_SGP4(jd);
+        ok[k] = deep_ecef(rec, jd, std::cos(gst), std::sin(gst), x[k], y[k], z[k]) ? 1 : 0;
+    }
+    ecef_to_geodetic(x.data(), y.data(), z.data(), (size_t)n, lat_deg, lon_deg, alt_km);
+    for (int k = 0; k < n; k++)
+        if (!ok[k]) lat_deg[k] = lon_deg[k] = alt_km[k] = 0.0;
+}
+
+// ── pass prediction ──────────────────────────────────────────────────────
+namespace {
+    const int    PASS_STEP_S = 30;      // coarse grid; LEO passes are minutes long
+    const int    MAX_JOB     = 4096;    // objects per background batch
+
+    struct Topo {
+        double sx, sy, sz;              // station ECEF
+        double ux, uy, uz, ex, ey, nx, ny, nz;
+
+        Topo(double lat_deg, double lon_deg, double alt_km) {
+            double la = lat_deg * M_PI / 180.0, lo = lon_deg * M_PI / 180.0;
+            double sla = std::sin(la), cla = std::cos(la), slo = std::sin(lo), clo = std::cos(lo);
+            double N = WGS84_A / std::sqrt(1.0 - WGS84_E2 * sla * sla);
+            sx = (N + alt_km) * cla * clo;
+            sy = (N + alt_km) * cla * slo;
+            sz = (N * (1.0 - WGS84_E2) + alt_km) * sla;
+            ux = cla * clo;  uy = cla * slo;  uz = sla;
+            ex = -slo;       ey = clo;
+            nx = -sla * clo; ny = -sla * slo; nz = cla;
+        }
+        void look(double x, double y, double z, double& el, double& az) const {
+            double rx = x - sx, ry = y - sy, rz = z - sz;
+            double r  = std::sqrt(rx * rx + ry * ry + rz * rz);
+            double up = rx * ux + ry * uy + rz * uz;
+            el = std::asin(std::max(-1.0, std::min(1.0, up / r))) * 180.0 / M_PI;
+            az = std::atan2(rx * ex + ry * ey, rx * nx + ry * ny + rz * nz) * 180.0 / M_PI;
+            if (az < 0) az += 360.0;
+        }
+    };
+
+    double elev_at(const TleElem& e, const Topo& st, double t, double* az = nullptr) {
+        double x, y, z, el, a;
+        if (!ecef_one(e, t, x, y, z)) return -90.0;
+        st.look(x, y, z, el, a);
+        if (az) *az = a;
+        return el;
+    }
+
+    // el(lo) < thr ≤ el(hi) (or reverse): crossing time to ~0.1 s.
+    double bisect(const TleElem& e, const Topo& st, double lo, double hi, double thr) {
+        bool rising = elev_at(e, st, lo) < thr;
+        for (int k = 0; k < 9; k++) {
+            double mid = 0.5 * (lo + hi);
+            bool above = elev_at(e, st, mid) >= thr;
+            if (above == rising) hi = mid; else lo = mid;
+        }
+        return 0.5 * (lo + hi);
+    }
+
+    // Golden-section max elevation in [a, b].
+    double peak(const TleElem& e, const Topo& st, double a, double b, double& el_max) {
+        const double g = 0.5 * (std::sqrt(5.0) - 1.0);
+        double c = b - g * (b - a), d = a + g * (b - a);
+        double fc = elev_at(e, st, c), fd = elev_at(e, st, d);
+        while (b - a > 0.5) {
+            if (fc > fd) { b = d; d = c; fd = fc; c = b - g * (b - a); fc = elev_at(e, st, c); }
+            else         { a = c; c = d; fc = fd; d = a + g * (b - a); fd = elev_at(e, st, d); }
+        }
+        double t = 0.5 * (a + b);
+        el_max = elev_at(e, st, t);
+        return t;
+    }
+}
+
+void PassService::set_station(double lat_deg, double lon_deg, double alt_km) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (has_station_ && std::fabs(lat_ - lat_deg) < 1e-4 && std::fabs(lon_ - lon_deg) < 1e-4
+        && std::fabs(alt_ - alt_km) < 0.01) return;
+    lat_ = lat_deg; lon_ = lon_deg; alt_ = alt_km;
+    has_station_ = true;
+    gen_++;
+    cache_.clear();
+    pending_.clear();
+}
+
+void PassService::set_window(double hours, double min_el_deg) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    hours_  = std::max(1.0, hours);
+    min_el_ = min_el_deg;
+    gen_++;
+    cache_.clear();
+    pending_.clear();
+}
+
+bool PassService::fresh(const Entry& en, const TleElem& e, time_t now) const {
+    if (en.busy) return true;
+    if (en.t1 == 0 || en.epoch != epoch_of(e.satrec)) return false;
+    return now <= en.t1 - (time_t)(hours_ * 1800.0);   // ≥ half the window left
+}
+
+void PassService::request(const TleElem& e) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (!has_station_ || quit_) return;
+    Entry& en = cache_[e.catalog_num];
+    if (fresh(en, e, time(nullptr))) return;
+    en.busy = true;
+    pending_.push_back(e);
+    if (!thr_.joinable()) thr_ = std::thread(&PassService::loop, this);
+    cv_.notify_one();
+}
+
+bool PassService::passes(int catalog_num, time_t now, std::vector<Pass>& out) const {
+    out.clear();
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = cache_.find(catalog_num);
+    if (it == cache_.end() || it->second.t1 == 0) return false;
+    for (const Pass& p : it->second.passes)
+        if (p.los > now) out.push_back(p);
+    return !out.empty();
+}
+
+bool PassService::next(int catalog_num, time_t now, Pass& out) const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = cache_.find(catalog_num);
+    if (it == cache_.end()) return false;
+    for (const Pass& p : it->second.passes)
+        if (p.los > now) { out = p; return true; }
+    return false;
+}
+
+size_t PassService::busy() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    size_t n = 0;
+    for (const auto& kv : cache_) n += kv.second.busy ? 1 : 0;
+    return n;
+}
+
+void PassService::stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        quit_ = true;
+        pending_.clear();
+    }
+    cv_.notify_all();
+    if (thr_.joinable()) thr_.join();
+}
+
+void PassService::loop() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    for (;;) {
+        cv_.wait(lk, [&] { return quit_ || !pending_.empty(); });
+        if (quit_) return;
+        std::vector<TleElem> job;
+        while (!pending_.empty() && (int)job.size() < MAX_JOB) {
+            job.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+        }
+        uint64_t gen = gen_;
+        lk.unlock();
+        compute(job, time(nullptr), gen);
+        lk.lock();
+    }
+}
+
+bool find_passes(const std::vector<TleElem>& sats, double lat_deg, double lon_deg, double alt_km,
+                 time_t t0, double hours, double min_el, std::vector<std::vector<Pass>>& out,
+                 const std::function<bool()>& cancel) {
+    const Topo st(lat_deg, lon_deg, alt_km);
+    const size_t n = sats.size();
+    const int steps = (int)(hours * 3600.0 / PASS_STEP_S) + 1;
+    const time_t t1 = t0 + (time_t)(steps - 1) * PASS_STEP_S;
+
+    Batch b;
+    b.build(sats);
+    std::vector<double> x(n), y(n), z(n), smax(n, -90.0);
+    std::vector<uint8_t> ok(n), up(n, 0);
+    std::vector<double> tsmax(n, 0.0);
+    std::vector<Pass> cur(n);
+    out.assign(n, {});
+
+    // Grid samples come from the batch; crossings / peaks are refined on the
+    // scalar path (a handful of evaluations per pass).
+    auto close_pass = [&](size_t i, double t_los) {
+        Pass& p = cur[i];
+        double a = std::max((double)p.aos, tsmax[i] - PASS_STEP_S);
+        double c = std::min(t_los, tsmax[i] + PASS_STEP_S);
+        double el_max = smax[i];
+        double tm = c > a ? peak(sats[i], st, a, c, el_max) : tsmax[i];
+        if (el_max < smax[i]) { el_max = smax[i]; tm = tsmax[i]; }
+        double az = 0.0;
+        elev_at(sats[i], st, t_los, &az);
+        p.los = (time_t)std::llround(t_los);
+        p.tmax = (time_t)std::llround(tm);
+        p.max_el = (float)el_max;
+        p.los_az = (float)az;
+        out[i].push_back(p);
+    };
+
+    for (int s = 0; s < steps; s++) {
+        if (s % 64 == 0 && cancel && cancel()) return false;
+        double t = (double)t0 + (double)s * PASS_STEP_S;
+        b.ecef(t, x.data(), y.data(), z.data(), ok.data());
+        for (size_t i = 0; i < n; i++) {
+            double el = -90.0, az = 0.0;
+            if (ok[i]) st.look(x[i], y[i], z[i], el, az);
+            if (!up[i] && el >= min_el) {
+                Pass p;
+                if (s == 0) p.aos = t0;
+                else        p.aos = (time_t)std::llround(bisect(sats[i], st, t - PASS_STEP_S, t, min_el));
+                double aaz = 0.0;
+                elev_at(sats[i], st, (double)p.aos, &aaz);
+                p.aos_az = (float)aaz;
+                cur[i] = p;
+                up[i] = 1; smax[i] = el; tsmax[i] = t;
+            } else if (up[i] && el < min_el) {
+                close_pass(i, bisect(sats[i], st, t - PASS_STEP_S, t, min_el));
+                up[i] = 0;
+            } else if (up[i] && el > smax[i]) {
+                smax[i] = el; tsmax[i] = t;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+        if (up[i]) close_pass(i, (double)t1);   // still up at window end → los = t1
+    return true;
+}
+
+void range_track(const TleElem& e, double lat_deg, double lon_deg, double alt_km,
+                 double t0, double dt, int n, double* range_km) {
+    const Topo st(lat_deg, lon_deg, alt_km);
+    elsetrec rec = e.satrec;
+    for (int k = 0; k < n; k++) {
+        double jd  = jd_of(t0 + dt * k);
+        double gst = SGP4Funcs::gstime_SGP4(jd);
+        double x, y, z;
+        if (!deep_ecef(rec, jd, std::cos(gst), std::sin(gst), x, y, z)) { range_km[k] = 0.0; continue; }
+        double rx = x - st.sx, ry = y - st.sy, rz = z - st.sz;
+        range_km[k] = std::sqrt(rx * rx + ry * ry + rz * rz);
+    }
+}
+
+void PassService::compute(std::vector<TleElem>& job, time_t t0, uint64_t gen) {
+    double lat, lon, alt, hours, min_el;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        lat = lat_; lon = lon_; alt = alt_; hours = hours_; min_el = min_el_;
+    }
+    const size_t n = job.size();
+    const time_t t1 = t0 + (time_t)((int)(hours * 3600.0 / PASS_STEP_S) * PASS_STEP_S);
+    std::vector<std::vector<Pass>> res;
+    auto cancel = [&] {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return quit_ || gen != gen_;
+    };
+    if (!find_passes(job, lat, lon, alt, t0, hours, min_el, res, cancel)) return;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (gen != gen_) return;
+    size_t deep = 0;
+    for (size_t i = 0; i < n; i++) {
+        Entry& en = cache_[job[i].catalog_num];
+        en.busy   = false;
+        en.epoch  = epoch_of(job[i].satrec);
+        en.t0     = t0;
+        en.t1     = t1;
+        en.passes = std::move(res[i]);
+        deep += job[i].satrec.method == 'd' ? 1 : 0;
+    }
+    bewe_log_push(0, "[sat_prop] passes: %zu sats x %.0f h (%zu deep-space)\n",
+                  n, hours, deep);
+}
+
+} // namespace SatProp
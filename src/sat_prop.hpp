@@ -0,0 +1,139 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Batch SGP4 propagation + background pass prediction.
+//
+//   SatProp::Batch : structure-of-arrays copy of the near-earth SGP4 constants of a
+//                    TleElem catalogue. One call evaluates every object at one instant:
+//                    GMST once per call, no per-object elsetrec copy, and a branch-free
+//                    TILE-lane inner loop (isimp folded into zeroed coefficients, fixed
+//                    Kepler iterations) that the compiler can vectorise. Tiles are
+//                    spread over worker threads. Deep-space objects (period ≥ 225 min,
+//                    method 'd') keep the reference SGP4Funcs::sgp4 path.
+//   SatProp::PassService : background thread. For a station and the requested
+//                    satellites it finds AOS / max elevation / LOS over the next N hours
+//                    (coarse grid over a Batch, then bisection on the scalar path) and
+//                    caches the result per catalog number until the window runs short,
+//                    the TLE epoch changes or the station moves.
+//
+// Times are unix seconds (double → sub-second OK). ECEF is SGP4 TEME rotated by GMST,
+// identical to tle_propagate(); geodetic is WGS84.
+// ─────────────────────────────────────────────────────────────────────────────
+#include "sat_tle.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SatProp {
+
+constexpr int TILE = 64;   // inner-loop lanes per tile (one tile = one scatter)
+
+class Batch {
+public:
+    void build(const std::vector<TleElem>& sats);
+    void build(const std::vector<const TleElem*>& sats);   // subset without copying
+    void clear();
+
+    size_t size()       const { return n_; }
+    size_t deep_count() const { return deep_idx_.size(); }
+
+    // All objects at t_utc. Outputs indexed like the build() vector.
+    // ok[i] = 0 → SGP4 error for that object (outputs 0). threads ≤ 0 → auto.
+    void ecef(double t_utc, double* x, double* y, double* z, uint8_t* ok, int threads = 0) const;
+    void geodetic(double t_utc, double* lat_deg, double* lon_deg, double* alt_km,
+                  uint8_t* ok, int threads = 0) const;
+
+private:
+    void near_tile(size_t k0, int m, double jd, double cg, double sg,
+                   double* x, double* y, double* z, uint8_t* ok) const;
+    template<class Fn> void run(double t_utc, int threads, Fn out) const;
+
+    size_t n_ = 0;
+    std::vector<uint32_t> near_idx_, deep_idx_;   // → build() index
+    std::vector<elsetrec> deep_rec_;
+    // near-earth SoA (near_idx_ order)
+    std::vector<double> epoch_, mo_, mdot_, argpo_, argpdot_, nodeo_, nodedot_, nodecf_,
+                        cc1_, cc4_, cc5_, bstar_, d2_, d3_, d4_, t2cof_, t3cof_, t4cof_,
+                        t5cof_, omgcof_, eta_, xmcof_, delmo_, sinmao_, no_, ecco_, inclo_,
+                        aycof_, xlcof_, con41_, x1mth2_, x7thm1_, sinio_, cosio_,
+                        a0_;                      // (xke / no)^(2/3)
+    double j2_ = 0, re_km_ = 6378.135;
+};
+
+// Scalar reference path (same frame as Batch). false on SGP4 error.
+bool ecef_one(const TleElem& e, double t_utc, double& x, double& y, double& z);
+
+// WGS84 ECEF (km) → geodetic, n points.
+void ecef_to_geodetic(const double* x, const double* y, const double* z, size_t n,
+                      double* lat_deg, double* lon_deg, double* alt_km);
+
+// One object at t0 + k·dt, k = 0..n-1 (orbit polyline). Failed points → 0.
+void track(const TleElem& e, double t0, double dt, int n,
+           double* lat_deg, double* lon_deg, double* alt_km);
+
+struct Pass {
+    time_t aos = 0, tmax = 0, los = 0;   // aos = window start if already up
+    float  max_el = 0.f;                 // deg
+    float  aos_az = 0.f, los_az = 0.f;   // deg, true north
+};
+
+// Synchronous pass search for a station over [t0, t0 + hours] (the PassService core).
+// out[i] ↔ sats[i]. cancel is polled every few grid steps; true → abort, returns false.
+bool find_passes(const std::vector<TleElem>& sats, double lat_deg, double lon_deg, double alt_km,
+                 time_t t0, double hours, double min_el, std::vector<std::vector<Pass>>& out,
+                 const std::function<bool()>& cancel = {});
+
+// Slant range station → object (km) at t0 + k·dt, k = 0..n-1 (Doppler). Failed points → 0.
+void range_track(const TleElem& e, double lat_deg, double lon_deg, double alt_km,
+                 double t0, double dt, int n, double* range_km);
+
+class PassService {
+public:
+    PassService() = default;
+    PassService(const PassService&) = delete;
+    PassService& operator=(const PassService&) = delete;
+    ~PassService(){ stop(); }
+
+    // Station change drops the cache (results in flight are discarded).
+    void set_station(double lat_deg, double lon_deg, double alt_km);
+    void set_window(double hours, double min_el_deg);
+
+    // Enqueue e unless a fresh entry exists or it is already pending. Cheap; call per frame.
+    void request(const TleElem& e);
+    // First pass with los > now. false = nothing cached (yet) or no pass in the window.
+    bool next(int catalog_num, time_t now, Pass& out) const;
+    // All cached passes (los > now).
+    bool passes(int catalog_num, time_t now, std::vector<Pass>& out) const;
+    // Objects queued or being computed (0 = cache settled).
+    size_t busy() const;
+
+    void stop();
+
+private:
+    struct Entry {
+        double epoch = 0;          // TLE epoch (jd) the entry was built from
+        time_t t0 = 0, t1 = 0;     // searched window
+        bool   busy = false;       // queued / computing
+        std::vector<Pass> passes;
+    };
+    bool fresh(const Entry& en, const TleElem& e, time_t now) const;
+    void loop();
+    void compute(std::vector<TleElem>& job, time_t t0, uint64_t gen);
+
+    mutable std::mutex      mtx_;
+    std::condition_variable cv_;
+    std::thread             thr_;
+    bool                    quit_ = false;
+    bool                    has_station_ = false;
+    double                  lat_ = 0, lon_ = 0, alt_ = 0;
+    double                  hours_ = 24.0, min_el_ = 5.0;
+    uint64_t                gen_ = 0;
+    std::map<int, Entry>    cache_;
+    std::deque<TleElem>     pending_;
+};
+
+} // namespace SatProp
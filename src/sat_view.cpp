@@ -1,6 +1,8 @@
 #include "sat_view.hpp"
 #include "sat_tle.hpp"
+#include "sat_prop.hpp"
 #include "globe.hpp"
+#include "kst_time.hpp"
 #include "bewe_paths.hpp"
 #include "imgui.h"
 #include <vector>
@@ -37,6 +39,33 @@ namespace {
     std::vector<PosCache> g_pos_cache;
     std::vector<unsigned char> g_is_soi; // per-sat SOI flag (parallel to g_sats; avoids per-frame set lookup)
 
+    // Batch propagator over the visible subset; rebuilt when the mode or the
+    // satellite list changes. One call per UTC second refreshes every marker.
+    SatProp::Batch        g_batch;
+    std::vector<uint32_t> g_batch_idx;    // batch slot → g_sats index
+    int                   g_batch_mode = -1;
+    unsigned              g_sats_gen = 0, g_batch_gen = ~0u;
+    time_t                g_batch_at = 0;
+    std::vector<double>   g_b_lat, g_b_lon, g_b_alt;
+    std::vector<uint8_t>  g_b_ok;
+    unsigned              g_pos_ver = 0;  // bumped whenever batch positions change
+
+    // Screen positions of the batch slots (hover / labels / click), recomputed only
+    // when the positions tick or the camera moves — not per frame.
+    std::vector<float>    g_scr_x, g_scr_y;
+    std::vector<uint8_t>  g_scr_ok;
+    unsigned              g_scr_pos = ~0u;
+    uint32_t              g_scr_view = 0;
+
+    // Instanced marker buffer on the globe; re-uploaded on position tick / selection change.
+    std::vector<GlobeRenderer::Marker> g_mk;
+    unsigned              g_mk_pos = ~0u;
+    int                   g_mk_sel = -2;
+
+    // Next-pass prediction for the station (background thread, cached).
+    SatProp::PassService  g_pass;
+    bool                  g_have_station = false;
+
     void rebuild_soi_flags() {
         g_is_soi.assign(g_sats.size(), 0);
         for (size_t i = 0; i < g_sats.size(); i++)
@@ -88,12 +117,72 @@ namespace {
         return g_is_soi[i] != 0;  // SAT_SOI
     }
 
-    void update_position(size_t i, time_t now_utc) {
-        PosCache& c = g_pos_cache[i];
-        if (c.valid_at == now_utc) return;
-        tle_propagate(g_sats[i], now_utc, c.lat, c.lon, c.alt);
-        latlonalt_to_world(c.lat, c.lon, c.alt, c.wx, c.wy, c.wz);
-        c.valid_at = now_utc;
+    // Call after every change to g_sats.
+    void positions_reset() {
+        g_pos_cache.assign(g_sats.size(), PosCache{});
+        g_sats_gen++;
+        g_batch_at = 0;
+    }
+
+    void batch_sync() {
+        if (g_batch_mode == g_mode && g_batch_gen == g_sats_gen) return;
+        std::vector<const TleElem*> sub;
+        g_batch_idx.clear();
+        for (size_t i = 0; i < g_sats.size(); i++) {
+            if (!sat_visible(i)) continue;
+            sub.push_back(&g_sats[i]);
+            g_batch_idx.push_back((uint32_t)i);
+        }
+        g_batch.build(sub);
+        g_batch_mode = g_mode;
+        g_batch_gen  = g_sats_gen;
+        g_batch_at   = 0;
+        g_pos_ver++;
+        size_t n = sub.size();
+        g_b_lat.resize(n); g_b_lon.resize(n); g_b_alt.resize(n); g_b_ok.resize(n);
+    }
+
+    void update_all_positions(time_t now_utc) {
+        batch_sync();
+        if (g_batch_at == now_utc) return;
+        g_batch_at = now_utc;
+        g_batch.geodetic((double)now_utc, g_b_lat.data(), g_b_lon.data(), g_b_alt.data(),
+                         g_b_ok.data());
+        for (size_t k = 0; k < g_batch_idx.size(); k++) {
+            PosCache& c = g_pos_cache[g_batch_idx[k]];
+            c.lat = g_b_lat[k]; c.lon = g_b_lon[k]; c.alt = g_b_alt[k];
+            latlonalt_to_world(c.lat, c.lon, c.alt, c.wx, c.wy, c.wz);
+            c.valid_at = now_utc;
+        }
+        g_pos_ver++;
+    }
+
+    void screen_sync(const GlobeRenderer& globe) {
+        uint32_t vv = globe.view_version();
+        if (g_scr_pos == g_pos_ver && g_scr_view == vv) return;
+        g_scr_pos = g_pos_ver; g_scr_view = vv;
+        size_t n = g_batch_idx.size();
+        g_scr_x.resize(n); g_scr_y.resize(n); g_scr_ok.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            const PosCache& pc = g_pos_cache[g_batch_idx[k]];
+            g_scr_ok[k] = globe.project_world(pc.wx, pc.wy, pc.wz, g_scr_x[k], g_scr_y[k]) ? 1 : 0;
+        }
+    }
+
+    void markers_sync(GlobeRenderer& globe) {
+        if (g_mk_pos == g_pos_ver && g_mk_sel == g_selected) return;
+        g_mk_pos = g_pos_ver; g_mk_sel = g_selected;
+        g_mk.clear();
+        GlobeRenderer::Marker sel{};
+        bool have_sel = false;
+        for (uint32_t i : g_batch_idx) {
+            const PosCache& pc = g_pos_cache[i];
+            GlobeRenderer::Marker m{ pc.wx, pc.wy, pc.wz, with_alpha(sat_color(i, pc.alt), 255), 4.5f };
+            if ((int)i == g_selected) { m.size = 9.f; sel = m; have_sel = true; continue; }
+            g_mk.push_back(m);
+        }
+        if (have_sel) g_mk.push_back(sel);   // drawn last = on top
+        globe.set_markers(g_mk.data(), (int)g_mk.size());
     }
 
     void orbit_cache_clear() { g_orbit = OrbitPath{}; }
@@ -111,13 +200,12 @@ namespace {
         int N = ORBIT_K + 1;
         g_orbit.wpts.resize(N);
         double dur = (double)(g_orbit.t_end - g_orbit.t_start);
+        std::vector<double> lat(N), lon(N), alt(N);
+        SatProp::track(e, (double)g_orbit.t_start, dur / (N - 1), N,
+                       lat.data(), lon.data(), alt.data());
         for (int i = 0; i < N; i++) {
-            double frac = (double)i / (N - 1);
-            time_t t = g_orbit.t_start + (time_t)(frac * dur);
-            double lat, lon, alt;
-            tle_propagate(e, t, lat, lon, alt);
             float wx, wy, wz;
-            latlonalt_to_world(lat, lon, alt, wx, wy, wz);
+            latlonalt_to_world(lat[i], lon[i], alt[i], wx, wy, wz);
             g_orbit.wpts[i] = {wx, wy, wz};
         }
     }
@@ -279,7 +367,7 @@ void sat_view_init() {
         }
     }
 
-    g_pos_cache.assign(g_sats.size(), PosCache{});
+    positions_reset();
     rebuild_soi_flags();
     fprintf(stderr, "[sat_view] init: %d sot + %d SOI-only; %zu in SOI set; %zu total\n",
             sot_kept, soi_kept, g_soi_ids.size(), g_sats.size());
@@ -308,7 +396,7 @@ namespace {
                 g_sats.push_back(std::move(e)); etc_kept++;
             }
         }
-        g_pos_cache.assign(g_sats.size(), PosCache{});
+        positions_reset();
         rebuild_soi_flags();
         fprintf(stderr, "[sat_view] ALL: +%d starlink +%d etc; %zu total\n",
                 sl_kept, etc_kept, g_sats.size());
@@ -339,13 +427,18 @@ namespace {
                 g_sats.push_back(std::move(e)); kept++;
             }
         }
-        g_pos_cache.assign(g_sats.size(), PosCache{});
+        positions_reset();
         rebuild_soi_flags();
         fprintf(stderr, "[sat_view] LEO: +%d sats (-%d starlink filtered); %zu total\n",
                 kept, skipped_sl, g_sats.size());
     }
 }
 
+void sat_view_set_station(double lat_deg, double lon_deg, double alt_km) {
+    g_pass.set_station(lat_deg, lon_deg, alt_km);
+    g_have_station = true;
+}
+
 void sat_view_update_tle() {
     sat_tle_fetch(true);
     sat_tle_refresh_soi(true);
@@ -439,32 +532,23 @@ void sat_view_draw(GlobeRenderer& globe, ImGuiIO& io, time_t now_utc) {
     }
 
     // ── Satellite markers (1-second propagate cache) ─────────────────────
-    for (size_t i = 0; i < g_sats.size(); i++) {
-        if (!sat_visible(i)) continue;
-        update_position(i, now_utc);
-        const PosCache& pc = g_pos_cache[i];
-        float sx, sy;
-        if (!globe.project_world(pc.wx, pc.wy, pc.wz, sx, sy)) continue;
-
+    // Markers are one instanced draw on the globe (uploaded on change); only the
+    // labels go through ImGui, from the cached screen positions.
+    update_all_positions(now_utc);
+    markers_sync(globe);
+    globe.draw_markers();
+    screen_sync(globe);
+    for (size_t k = 0; k < g_batch_idx.size(); k++) {
+        if (!g_scr_ok[k]) continue;
+        size_t i  = g_batch_idx[k];
+        float  sx = g_scr_x[k], sy = g_scr_y[k];
         bool   selected = ((int)i == g_selected);
-        ImU32  c        = sat_color(i, pc.alt);
-        const int LAYERS = 8;
-        float scale = selected ? 2.0f : 1.0f;
-        float r_out = 4.5f * scale;
-        float r_in  = 0.75f * scale;
-        for (int k = LAYERS - 1; k >= 0; k--) {
-            float t = (float)k / (float)(LAYERS - 1);
-            float r = r_in + (r_out - r_in) * t;
-            unsigned a = (unsigned)(240.f * (1.f - t) * (1.f - t) + 15.f);
-            fdl->AddCircleFilled(ImVec2(sx, sy), r, with_alpha(c, a), 16);
-        }
-        fdl->AddCircleFilled(ImVec2(sx, sy), 0.75f * scale,
-                             IM_COL32(255, 255, 255, 230), selected ? 16 : 8);
 
         // Show label on hover, while selected, or always under SOI mode
         // (SOI list is small enough that labels never crowd the screen).
         float dx = sx - io.MousePos.x, dy = sy - io.MousePos.y;
         if (g_mode == SAT_SOI || selected || dx*dx + dy*dy < 196.f) {
+            const PosCache& pc = g_pos_cache[i];
             const TleElem& e = g_sats[i];
             fdl->AddText(ImVec2(sx + 12, sy - 8),
                          IM_COL32(255, 240, 200, 255), e.name.c_str());
@@ -472,6 +556,18 @@ void sat_view_draw(GlobeRenderer& globe, ImGuiIO& io, time_t now_utc) {
             snprintf(buf, sizeof buf, "%.0f km", pc.alt);
             fdl->AddText(ImVec2(sx + 12, sy + 4),
                          IM_COL32(220, 200, 160, 220), buf);
+            if (g_have_station) {
+                g_pass.request(e);
+                SatProp::Pass p;
+                if (selected && g_pass.next(e.catalog_num, now_utc, p)) {
+                    bool up = p.aos <= now_utc;
+                    struct tm kt; KST::to_tm(up ? p.los : p.aos, kt);
+                    snprintf(buf, sizeof buf, "%s %02d:%02d:%02d  max %.0f°",
+                             up ? "LOS" : "AOS", kt.tm_hour, kt.tm_min, kt.tm_sec, p.max_el);
+                    fdl->AddText(ImVec2(sx + 12, sy + 16),
+                                 up ? IM_COL32(140, 255, 140, 230) : IM_COL32(200, 220, 255, 220), buf);
+                }
+            }
         }
     }
 }
@@ -479,17 +575,15 @@ void sat_view_draw(GlobeRenderer& globe, ImGuiIO& io, time_t now_utc) {
 bool sat_view_handle_click(GlobeRenderer& globe, float mx, float my) {
     if (g_sats.empty()) return false;
     time_t now = time(nullptr);
+    update_all_positions(now);
+    screen_sync(globe);
     int best_idx = -1;
     float best_d2 = 25.f * 25.f;
-    for (size_t i = 0; i < g_sats.size(); i++) {
-        if (!sat_visible(i)) continue;
-        update_position(i, now);
-        const PosCache& pc = g_pos_cache[i];
-        float sx, sy;
-        if (!globe.project_world(pc.wx, pc.wy, pc.wz, sx, sy)) continue;
-        float dx = sx - mx, dy = sy - my;
+    for (size_t k = 0; k < g_batch_idx.size(); k++) {
+        if (!g_scr_ok[k]) continue;
+        float dx = g_scr_x[k] - mx, dy = g_scr_y[k] - my;
         float d2 = dx*dx + dy*dy;
-        if (d2 < best_d2) { best_d2 = d2; best_idx = (int)i; }
+        if (d2 < best_d2) { best_d2 = d2; best_idx = (int)g_batch_idx[k]; }
     }
     if (best_idx < 0) return false;
     if (g_selected == best_idx) {
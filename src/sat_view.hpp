@@ -22,6 +22,10 @@ void sat_view_draw(GlobeRenderer& globe, ImGuiIO& io, time_t now_utc);
 // force=true 로 staleness throttle 무시 + sat list 재로드. ALL 모드면 starlink/etc 도 강제 reload.
 void sat_view_update_tle();
 
+// Ground station for pass prediction (AOS/LOS line under the selected satellite).
+// Cheap when unchanged; a move drops the cached passes.
+void sat_view_set_station(double lat_deg, double lon_deg, double alt_km = 0.0);
+
 // Returns true if a satellite marker was hit (and selection updated).
 // Caller should skip station/pick logic when true.
 bool sat_view_handle_click(GlobeRenderer& globe, float mx, float my);
@@ -4,10 +4,12 @@
 #include "login.hpp"
 #include "kst_time.hpp"
 #include "sigmf.hpp"
+#include "sat_pass_plan.hpp"
 #include <ctime>
 #include <chrono>
 #include <thread>
 #include <cstdio>
+#include <sys/stat.h>
 
 // ── sched 리스트를 SCHED_SYNC 패킷으로 변환 ──────────────────────────────
 // 호출자는 sched_mtx를 잡은 상태여야 함
@@ -59,49 +61,220 @@ bool FFTViewer::sched_has_overlap(time_t start, float dur) const {
     return false;
 }
 
+int FFTViewer::sched_find(uint32_t uid) const {
+    for(int i = 0; i < (int)sched_entries.size(); i++)
+        if(sched_entries[i].uid == uid) return i;
+    return -1;
+}
+
+// 새 엔트리(uid 0)에 uid 부여, 리스트가 바뀌었으면 WAITING start_time 힙 재구성.
+// 추가/삭제/시각·상태 수정은 UI·CMD·Central 여러 곳에서 일어나므로 tick 에서
+// (uid, start_time, status) FNV-1a 서명으로 감지한다 (≤ MAX_SCHED_ENTRIES).
+void FFTViewer::sched_index_locked(){
+    uint64_t sig = 1469598103934665603ull;
+    auto mix = [&sig](uint64_t v){
+        for(int b = 0; b < 8; b++){ sig ^= (v >> (b * 8)) & 0xff; sig *= 1099511628211ull; }
+    };
+    for(auto& e : sched_entries){
+        if(e.uid == 0) e.uid = sched_uid_next++;
+        mix(e.uid); mix((uint64_t)e.start_time); mix((uint64_t)e.status);
+    }
+    if(sig == sched_heap_sig) return;
+    sched_heap.clear();
+    for(const auto& e : sched_entries)
+        if(e.status == SchedEntry::WAITING) sched_heap.push_back({e.start_time, e.uid});
+    std::make_heap(sched_heap.begin(), sched_heap.end(), std::greater<>());
+    sched_heap_sig = sig;
+}
+
+static SatPlan::Band sched_band(const FFTViewer::SchedEntry& e){
+    double half = e.bw_khz * 500.0 + (e.dop ? e.dop->max_abs() : 0.f);
+    return { e.freq_mhz * 1e6 - half, e.freq_mhz * 1e6 + half };
+}
+
+// e 를 지금 arm 할 수 있는가 → SDR CF (Hz). 활성 엔트리가 없으면 e 에 맞춰 새로 튠
+// (SatPlan 그룹 CF 우선 — 뒤따르는 겹치는 패스도 재튠 없이 들어감),
+// 있으면 현재 CF 유지가 우선. 재튠이 필요한데 RECORDING 중인 엔트리가 있으면 false
+// (녹음 중 CF 가 바뀌면 그 파일이 깨짐 — 끝날 때까지 대기), ARMED 뿐이면 전체가 들어가는 CF 로 재튠.
+bool FFTViewer::sched_fits_locked(const SchedEntry& e, double& cf_hz) const {
+    bool free_slot = false;
+    for(int i = 0; i < MAX_CHANNELS && !free_slot; i++) free_slot = !channels[i].filter_active;
+    if(!free_slot) return false;
+    double sr = (double)header.sample_rate;
+    std::vector<SatPlan::Band> bands{ sched_band(e) };
+    if(sched_active.empty()){
+        if(e.plan_cf_hz > 0 && SatPlan::covers(bands, sr, e.plan_cf_hz)){ cf_hz = e.plan_cf_hz; return true; }
+        if(SatPlan::pick_center(bands, sr, hw.freq_min_hz, hw.freq_max_hz, cf_hz)) return true;
+        // SDR 헤드룸보다 넓음 — 기존 동작대로 최대 오프셋으로 튠 (DC 침범 경고는 arm 에서)
+        double max_off = sr * 0.45 - e.bw_khz * 500.0;
+        cf_hz = e.freq_mhz * 1e6 + (max_off > 0 ? max_off : 0.0);
+        return true;
+    }
+    if((int)sched_active.size() >= SCHED_PLAN_MAX_SLOTS) return false;
+    bool recording = false;
+    for(const auto& a : sched_active){
+        int i = sched_find(a.first);
+        if(i < 0) continue;
+        bands.push_back(sched_band(sched_entries[i]));
+        recording |= sched_entries[i].status == SchedEntry::RECORDING;
+    }
+    double cur = (double)header.center_frequency;
+    if(SatPlan::covers(bands, sr, cur)){ cf_hz = cur; return true; }
+    if(recording) return false;
+    if(e.plan_cf_hz > 0 && SatPlan::covers(bands, sr, e.plan_cf_hz)){ cf_hz = e.plan_cf_hz; return true; }
+    return SatPlan::pick_center(bands, sr, hw.freq_min_hz, hw.freq_max_hz, cf_hz);
+}
+
+// 활성 목록에서 제거. 마지막 하나가 빠지면 arm 이전 CF 로 복귀.
+void FFTViewer::sched_release_locked(uint32_t uid){
+    for(size_t k = 0; k < sched_active.size(); k++)
+        if(sched_active[k].first == uid){ sched_active.erase(sched_active.begin() + k); break; }
+    if(sched_active.empty()){
+        set_frequency(sched_saved_cf);
+        bewe_log_push(0, "[SCHED] Freq restored > %.3f MHz\n", sched_saved_cf);
+    }
+}
+
+// 위성 패스 계획: downlink 파일/지상국이 있으면 주기적으로 백그라운드 재계획,
+// lead window 에 들어온 항목을 SchedEntry 로 꺼낸다 (SCHED_SYNC 32개 한도 안에서 굴림).
+void FFTViewer::sched_plan_poll_locked(time_t now){
+    if(remote_mode) return;
+    std::string path = BEWEPaths::data_dir() + "/sat_downlinks.txt";
+    struct stat fst;
+    bool have = stat(path.c_str(), &fst) == 0;
+    if(!have && !sched_plan) return;
+    if(!sched_plan) sched_plan = std::make_shared<SatPlan::Queue>();
+    SatPlan::Queue& q = *sched_plan;
+
+    if(have && station_location_set && header.sample_rate > 0 && !q.busy.load()){
+        bool moved = fabs(q.st_lat - station_lat) > 1e-3 || fabs(q.st_lon - station_lon) > 1e-3;
+        if(now >= q.next_plan || fst.st_mtime != q.file_mtime || moved){
+            SatPlan::Params p;
+            p.downlinks_path  = path;
+            p.tle_dir         = BEWEPaths::assets_dir() + "/tle";
+            p.lat_deg         = station_lat;
+            p.lon_deg         = station_lon;
+            p.hours           = 24.0;
+            p.lim.sr_hz       = (double)header.sample_rate;
+            p.lim.fmin_hz     = hw.freq_min_hz;
+            p.lim.fmax_hz     = hw.freq_max_hz;
+            p.lim.max_slots   = std::min(SCHED_PLAN_MAX_SLOTS, (int)MAX_CHANNELS);
+            p.lim.pre_arm_sec = SCHED_PRE_ARM_SEC;
+            q.next_plan  = now + SCHED_PLAN_REFRESH_SEC;
+            q.file_mtime = fst.st_mtime;
+            q.st_lat = station_lat; q.st_lon = station_lon;
+            if(sched_plan_thr.joinable()) sched_plan_thr.join();   // 이전 워커 (busy 해제 후라 즉시)
+            sched_plan_thr = SatPlan::replan_async(sched_plan, p);
+        }
+    }
+
+    bool changed = false;
+    if((int)sched_entries.size() >= MAX_SCHED_ENTRIES){
+        // 끝난 자동 항목부터 정리 (수동 항목은 운용자가 지움)
+        for(size_t i = 0; i < sched_entries.size();){
+            const auto& e = sched_entries[i];
+            bool old = (e.status == SchedEntry::DONE || e.status == SchedEntry::FAILED)
+                    && strcmp(e.operator_name, "SATPLAN") == 0;
+            if(old){ sched_entries.erase(sched_entries.begin() + i); changed = true; }
+            else i++;
+        }
+    }
+    SatPlan::Item it;
+    while((int)sched_entries.size() < MAX_SCHED_ENTRIES
+          && q.pop_due(now + SCHED_PLAN_LEAD_SEC, it)){
+        if(it.start + (time_t)it.dur <= now) continue;
+        SchedEntry e;
+        e.start_time   = it.start;
+        e.duration_sec = it.dur;
+        e.freq_mhz     = (float)it.freq_mhz;
+        e.bw_khz       = it.bw_khz;
+        e.status       = SchedEntry::WAITING;
+        e.op_index     = 0;
+        e.dop          = it.dop;
+        e.plan_cf_hz   = it.cf_hz;
+        strncpy(e.operator_name, "SATPLAN", sizeof(e.operator_name)-1);
+        snprintf(e.target, sizeof(e.target), "%s %s", it.name.c_str(), it.mode);
+        {
+            std::lock_guard<std::mutex> mlk(mission_mtx);
+            if(mission_state == Mission::State::ACTIVE && mission_code[0]){
+                e.mission_year = mission_year;
+                memcpy(e.mission_code, mission_code, sizeof(e.mission_code));
+            }
+        }
+        sched_entries.push_back(e);
+        changed = true;
+        bewe_log_push(0, "[SATPLAN] %s: %.3f MHz %.0f kHz %s, %.0fs max %.0f deg, Doppler ±%.1f kHz\n",
+                      it.name.c_str(), it.freq_mhz, it.bw_khz, it.mode, it.dur, it.max_el,
+                      it.dop ? it.dop->max_abs() / 1000.f : 0.f);
+    }
+    if(changed) broadcast_sched_list_locked();
+}
+
 void FFTViewer::sched_tick(){
     std::lock_guard<std::mutex> lk(sched_mtx);
     time_t now = time(nullptr);
+    sched_plan_poll_locked(now);
+    sched_index_locked();
 
-    // Active slot (ARMED or RECORDING)
-    if(sched_active_idx >= 0 && sched_active_idx < (int)sched_entries.size()){
-        auto& e = sched_entries[sched_active_idx];
+    // Active slots (ARMED or RECORDING) — uid 로 추적
+    for(size_t k = 0; k < sched_active.size();){
+        uint32_t uid = sched_active[k].first;
+        int i = sched_find(uid);
+        if(i < 0){
+            // 리스트에서 사라짐 (Central 복원 등) — 채널 정리
+            int slot = sched_active[k].second;
+            if(slot >= 0 && slot < MAX_CHANNELS){ stop_iq_rec(slot); channels[slot].reset_slot(); }
+            sched_release_locked(uid);
+            if(net_srv) net_srv->broadcast_channel_sync(channels, MAX_CHANNELS);
+            continue;
+        }
+        size_t before = sched_active.size();
+        auto& e = sched_entries[i];
         if(e.status == SchedEntry::ARMED){
             if(now >= e.start_time)
-                sched_begin_rec(sched_active_idx);
+                sched_begin_rec(i);
         } else if(e.status == SchedEntry::RECORDING){
             float elapsed = std::chrono::duration<float>(
                 std::chrono::steady_clock::now() - e.rec_started).count();
             if(elapsed >= e.duration_sec)
-                sched_stop_entry(sched_active_idx);
+                sched_stop_entry(i);
         }
+        if(sched_active.size() == before) k++;
     }
 
-    // No active slot: find next WAITING entry eligible for pre-arm
-    if(sched_active_idx < 0){
-        for(int i = 0; i < (int)sched_entries.size(); i++){
-            auto& e = sched_entries[i];
-            if(e.status != SchedEntry::WAITING) continue;
-            // Entirely missed?
-            if(now > e.start_time + (time_t)e.duration_sec){
-                e.status = SchedEntry::FAILED;
-                broadcast_sched_list_locked();
-                bewe_log_push(0, "[SCHED] Entry %d missed (time passed)\n", i);
-                continue;
-            }
-            // Pre-arm window reached?
-            if(now >= e.start_time - (time_t)SCHED_PRE_ARM_SEC){
-                sched_arm_entry(i);
-                break;
-            }
+    // 다음 WAITING (start_time 순 힙). 지금 튜닝/슬롯에 안 들어가면 활성 녹음이 끝날 때까지 대기.
+    while(!sched_heap.empty()){
+        uint32_t uid = sched_heap.front().second;
+        int i = sched_find(uid);
+        if(i < 0 || sched_entries[i].status != SchedEntry::WAITING){
+            std::pop_heap(sched_heap.begin(), sched_heap.end(), std::greater<>());
+            sched_heap.pop_back();
+            continue;
+        }
+        auto& e = sched_entries[i];
+        // Entirely missed?
+        if(now > e.start_time + (time_t)e.duration_sec){
+            std::pop_heap(sched_heap.begin(), sched_heap.end(), std::greater<>());
+            sched_heap.pop_back();
+            e.status = SchedEntry::FAILED;
+            broadcast_sched_list_locked();
+            bewe_log_push(0, "[SCHED] Entry %d missed (time passed)\n", i);
+            continue;
         }
+        // Pre-arm window reached?
+        if(now < e.start_time - (time_t)SCHED_PRE_ARM_SEC) break;
+        double cf_hz;
+        if(!sched_fits_locked(e, cf_hz)) break;
+        std::pop_heap(sched_heap.begin(), sched_heap.end(), std::greater<>());
+        sched_heap.pop_back();
+        sched_arm_entry(i, cf_hz);
     }
 }
 
 // Pre-arm: start_time - SCHED_PRE_ARM_SEC 시점에 호출됨.
-// SDR 튠(DC 오프셋 적용), 채널 할당, demod 시작만 수행. IQ 기록은 아직.
+// SDR 튠(DC 오프셋 적용 — cf_hz 는 sched_fits_locked 가 고름), 채널 할당만 수행. IQ 기록은 아직.
 // 이 구간 동안 PLL lock / IIR 과도응답 / squelch 보정이 안정화됨.
-void FFTViewer::sched_arm_entry(int idx){
+void FFTViewer::sched_arm_entry(int idx, double cf_hz){
     auto& e = sched_entries[idx];
 
     if(remote_mode){ e.status=SchedEntry::FAILED; broadcast_sched_list_locked(); bewe_log_push(0,"[SCHED] Failed: JOIN mode\n"); return; }
@@ -110,26 +283,18 @@ void FFTViewer::sched_arm_entry(int idx){
                || (hw.type == HWType::PLUTO && pluto_ctx != nullptr);
     if(!sdr_ok){ e.status=SchedEntry::FAILED; broadcast_sched_list_locked(); bewe_log_push(0,"[SCHED] Failed: no SDR\n"); return; }
 
-    sched_saved_cf = (float)(header.center_frequency / 1e6);
-
-    // DC 오프셋: SDR CF를 target + offset 로 이동 → DC 스파이크가 채널 베이스밴드에서 -offset 위치로
-    // 밀려 채널 LPF 바깥이 되어 제거됨.
-    float bw_mhz     = e.bw_khz / 1000.0f;
-    float sdr_sr_mhz = (float)(header.sample_rate) / 1e6f;
-    float min_off    = bw_mhz;                                    // 채널 필터 바깥으로 밀어냄
-    float max_off    = sdr_sr_mhz * 0.45f - bw_mhz * 0.5f;        // SDR 유효 대역 헤드룸
-    float offset;
-    if(max_off <= 0.f){
-        offset = 0.f;
-        bewe_log_push(0,"[SCHED] Warn: BW exceeds SDR headroom; DC may intrude\n");
-    } else {
-        offset = (max_off < min_off) ? max_off : min_off;
-    }
-    float sdr_cf = e.freq_mhz + offset;
+    bool first = sched_active.empty();
+    if(first) sched_saved_cf = (float)(header.center_frequency / 1e6);
 
-    set_frequency(sdr_cf);
-    bewe_log_push(0, "[SCHED] ARM: SDR CF %.3f MHz (target %.3f + DC offset %.3f)\n",
-                  sdr_cf, e.freq_mhz, offset);
+    // DC 오프셋: SDR CF를 target 에서 비켜 둠 → DC 스파이크가 채널 LPF 바깥이 되어 제거됨.
+    float sdr_cf = (float)(cf_hz / 1e6);
+    if(fabs(cf_hz - (double)header.center_frequency) > 1.0){
+        set_frequency(sdr_cf);
+        bewe_log_push(0, "[SCHED] ARM: SDR CF %.3f MHz (target %.3f, offset %.3f, %zu active)\n",
+                      sdr_cf, e.freq_mhz, sdr_cf - e.freq_mhz, sched_active.size());
+    }
+    if(fabs(sdr_cf - e.freq_mhz) * 1e3f < e.bw_khz * 0.5f)
+        bewe_log_push(0,"[SCHED] Warn: BW exceeds SDR headroom; DC may intrude\n");
 
     int slot = -1;
     for(int i = 0; i < MAX_CHANNELS; i++){
@@ -137,13 +302,13 @@ void FFTViewer::sched_arm_entry(int idx){
     }
     if(slot < 0){
         e.status = SchedEntry::FAILED;
-        set_frequency(sched_saved_cf);
+        if(first) set_frequency(sched_saved_cf);
         broadcast_sched_list_locked();
         bewe_log_push(0, "[SCHED] Failed: no free channel slot\n");
         return;
     }
 
-    // 채널 [s, e]는 target 기준 — IQ-only worker가 SDR CF에서 target으로 mixer
+    // 채널 [s, e]는 target 기준 — IQ-only worker가 SDR CF에서 target(+도플러)으로 mixer
     float half_bw = e.bw_khz / 2000.0f;
     channels[slot].reset_slot();
     channels[slot].s = e.freq_mhz - half_bw;
@@ -152,6 +317,7 @@ void FFTViewer::sched_arm_entry(int idx){
     const char* owner_src = (e.operator_name[0]) ? e.operator_name : "SCHED";
     strncpy(channels[slot].owner, owner_src, 31);
     channels[slot].audio_mask.store(0x0);  // 스케줄 녹음은 audio 재생 안 함
+    channels[slot].iq_dop = e.dop;
     e.temp_ch_idx = slot;
 
     // demod 안 시작 — start_iq_rec이 IQ-only worker로 직접 IQ ring 소비.
@@ -159,7 +325,7 @@ void FFTViewer::sched_arm_entry(int idx){
     channels[slot].iq_rec_force_all.store(true);
 
     e.status = SchedEntry::ARMED;
-    sched_active_idx = idx;
+    sched_active.push_back({e.uid, slot});
 
     if(net_srv) net_srv->broadcast_channel_sync(channels, MAX_CHANNELS);
     broadcast_sched_list_locked();
@@ -180,7 +346,7 @@ void FFTViewer::sched_begin_rec(int idx){
     int slot = e.temp_ch_idx;
     if(slot < 0 || slot >= MAX_CHANNELS){
         e.status = SchedEntry::FAILED;
-        sched_active_idx = -1;
+        sched_release_locked(e.uid);
         broadcast_sched_list_locked();
         return;
     }
@@ -193,9 +359,8 @@ void FFTViewer::sched_begin_rec(int idx){
         bewe_log_push(0, "[SCHED] REC start failed: CH%d\n", slot);
         stop_dem(slot);
         channels[slot].reset_slot();
-        set_frequency(sched_saved_cf);
         e.status = SchedEntry::FAILED;
-        sched_active_idx = -1;
+        sched_release_locked(e.uid);
         if(net_srv) net_srv->broadcast_channel_sync(channels, MAX_CHANNELS);
         broadcast_sched_list_locked();
         return;
@@ -206,6 +371,15 @@ void FFTViewer::sched_begin_rec(int idx){
     broadcast_sched_list_locked();
     bewe_log_push(0, "[SCHED] REC start: CH%d %.3f MHz dur=%.0fs\n",
                   slot, e.freq_mhz, e.duration_sec);
+    // TM pin: pre-arm 구간 포함 롤링 버퍼에서도 SigMF 로 보존 (BEWE_TM_PIN=sched)
+    {
+        int64_t now = tm_iq_write_sample;
+        int64_t pre = (int64_t)(TmTier::PIN_PRE_SEC * header.sample_rate);
+        float half = e.bw_khz / 2000.0f;
+        tm_pin_range(TmTier::TRIG_SCHED, e.freq_mhz - half, e.freq_mhz + half,
+                     std::max((int64_t)1, now - pre),
+                     now + (int64_t)(e.duration_sec * header.sample_rate), "sched");
+    }
 }
 
 void FFTViewer::sched_stop_entry(int idx){
@@ -230,12 +404,8 @@ void FFTViewer::sched_stop_entry(int idx){
     if(slot >= 0 && slot < MAX_CHANNELS)
         channels[slot].reset_slot();
 
-    // Restore frequency
-    set_frequency(sched_saved_cf);
-    bewe_log_push(0, "[SCHED] Freq restored > %.3f MHz\n", sched_saved_cf);
-
     e.status = SchedEntry::DONE;
-    sched_active_idx = -1;
+    sched_release_locked(e.uid);   // 마지막 활성 엔트리면 CF 복원
 
     if(net_srv) net_srv->broadcast_channel_sync(channels, MAX_CHANNELS);
     broadcast_sched_list_locked();
@@ -11,6 +11,7 @@
 #include <string>
 
 extern char** environ;
+extern int g_metrics_port;   // host_metrics.cpp — HOST child 의 /metrics 포트 그대로 전달
 
 static std::string self_exe_path(){
     char buf[4096];
@@ -36,6 +37,7 @@ pid_t spawn_session_child(const std::string& mode,
     std::string a_sname = "--station-name=" + station_name;
     std::string a_slat  = "--station-lat="  + std::string(lat_buf);
     std::string a_slon  = "--station-lon="  + std::string(lon_buf);
+    std::string a_mport = std::to_string(g_metrics_port);
 
     std::vector<char*> argv;
     argv.push_back(const_cast<char*>(exe.c_str()));
@@ -45,6 +47,8 @@ pid_t spawn_session_child(const std::string& mode,
     argv.push_back(const_cast<char*>(a_sname.c_str()));
     argv.push_back(const_cast<char*>(a_slat.c_str()));
     argv.push_back(const_cast<char*>(a_slon.c_str()));
+    argv.push_back(const_cast<char*>("--metrics-port"));
+    argv.push_back(const_cast<char*>(a_mport.c_str()));
     argv.push_back(nullptr);
 
     // Forward login token via env vars (login.cpp reads BEWE_AUTO_*).
@@ -0,0 +1,115 @@
+#include "fft_viewer.hpp"
+
+// ── 채널 스컬치: FFT 스펙트럼에서 직접 채널 파워 계산 ─────────────────────
+// GUI (UI 프레임, ~60Hz) / CLI (20ms) 공용. filter_active 인 모든 채널에 대해
+// 동작 (복조 없어도 회색 상태에서 작동). dB 값은 FFT 스펙트럼과 동일한 스케일.
+void FFTViewer::update_channel_squelch(){
+    // JOIN 모드: 스컬치 계산은 HOST 전담. CH_SYNC로 받은 sq_threshold/sq_sig/sq_gate만 표시.
+    if(remote_mode) return;
+    if(total_ffts < 1 || fft_size < 1) return;
+    // 호출 간격 기반 실 delta 시간 (시간 카운터용)
+    auto sq_now = std::chrono::steady_clock::now();
+    float real_dt = std::chrono::duration<float>(sq_now - sq_last_tick).count();
+    if(real_dt > 0.5f) real_dt = 0.02f; // 첫 호출/정지 이후 복귀 보정
+    sq_last_tick = sq_now;
+
+    std::lock_guard<std::mutex> lk(data_mtx);
+    float cf_mhz = (float)(header.center_frequency / 1e6);
+    float nyq_mhz = header.sample_rate / 2e6f;
+    if(nyq_mhz < 0.001f) return;
+    int hf = fft_size / 2;
+
+    int fi = (total_ffts > 0 ? total_ffts - 1 : 0) % MAX_FFTS_MEMORY;
+    FftQuant::Row rowp = fft_row(fi);
+    // 같은 FFT 행이면 채널별 peak 재스캔 생략 (행 갱신은 ~1.5-37Hz, 호출은 ~50-60Hz)
+    bool same_row = (total_ffts == sq_last_total_ffts);
+    sq_last_total_ffts = total_ffts;
+
+    auto freq_to_bin = [&](float rel_mhz) -> int {
+        int bin = (rel_mhz >= 0)
+            ? (int)((rel_mhz / nyq_mhz) * hf)
+            : fft_size + (int)((rel_mhz / nyq_mhz) * hf);
+        return std::max(0, std::min(fft_size - 1, bin));
+    };
+    // 행 안에서는 q 순서 = dB 순서 → byte max 후 1회 변환
+    auto peak_of = [&](int b0, int b1, uint8_t mx) -> uint8_t {
+        for(int b = b0; b <= b1; b++) if(rowp.q[b] > mx) mx = rowp.q[b];
+        return mx;
+    };
+
+    for(int c = 0; c < MAX_CHANNELS; c++){
+        Channel& ch = channels[c];
+        if(!ch.filter_active) continue;
+
+        // 채널 주파수 범위 > FFT 빈
+        float s_mhz = std::min(ch.s, ch.e) - cf_mhz;
+        float e_mhz = std::max(ch.s, ch.e) - cf_mhz;
+        int bin_s = freq_to_bin(s_mhz);
+        int bin_e = freq_to_bin(e_mhz);
+
+        // 채널 대역 내 피크 파워
+        // 행·대역 둘 다 그대로면 캐시 재사용 (계산결과 동일 → 게이트/시간 동작 불변)
+        float peak_db;
+        if(same_row && ch.sq_calibrated.load(std::memory_order_relaxed)
+           && ch.sq_scan_s == ch.s && ch.sq_scan_e == ch.e){
+            peak_db = ch.sq_cached_peak;
+        } else {
+            uint8_t mx = (bin_s <= bin_e)
+                ? peak_of(bin_s, bin_e, 0)
+                : peak_of(0, bin_e, peak_of(bin_s, fft_size - 1, 0));   // DC 경계를 넘는 경우
+            peak_db = rowp.s.lo + (float)mx * rowp.s.step;
+            ch.sq_cached_peak = peak_db;
+            ch.sq_scan_s = ch.s; ch.sq_scan_e = ch.e;
+        }
+
+        // IIR 스무딩
+        float prev = ch.sq_sig.load(std::memory_order_relaxed);
+        float sig = 0.3f * peak_db + 0.7f * prev;
+        ch.sq_sig.store(sig, std::memory_order_relaxed);
+
+        // 캘리브레이션: 처음 SQ_CALIB_FRAMES 프레임(~1초) 수집 후 20th percentile + 10dB
+        if(!ch.sq_calibrated.load(std::memory_order_relaxed)){
+            ch.sq_calib.add(peak_db);
+            if(ch.sq_calib.count() >= (uint64_t)Channel::SQ_CALIB_FRAMES){
+                float noise_floor = ch.sq_calib.quantile(0.20f);
+                ch.sq_threshold.store(noise_floor + 10.0f, std::memory_order_relaxed);
+                ch.sq_calibrated.store(true, std::memory_order_relaxed);
+                ch.sq_calib.clear();
+            }
+        }
+
+        // 게이트 로직 (히스테리시스 + 홀드)
+        float thr = ch.sq_threshold.load(std::memory_order_relaxed);
+        bool gate = ch.sq_gate.load(std::memory_order_relaxed);
+        const bool gate0 = gate;
+        const float HYS = 3.0f;
+        const int HOLD_FRAMES = 18;  // ~0.3초 @ 60fps
+
+        if(ch.sq_calibrated.load(std::memory_order_relaxed)){
+            if(!gate && sig >= thr){
+                gate = true;
+                ch.sq_gate_hold = HOLD_FRAMES;
+            }
+            if(gate){
+                if(sig >= thr - HYS)
+                    ch.sq_gate_hold = HOLD_FRAMES;
+                else if(--ch.sq_gate_hold <= 0)
+                    gate = false;
+            }
+        }
+        ch.sq_gate.store(gate, std::memory_order_relaxed);
+        if(gate != gate0) tm_pin_channel(TmTier::TRIG_SQUELCH, c, gate, "squelch");
+
+        // 스컬치 누적 시간 — 실벽시계 delta (Holding(dem_paused) 중에는 정지,
+        // JOIN 은 CH_SYNC 의 HOST 값을 그대로 사용)
+        if(ch.filter_active && !ch.dem_paused.load()){
+            if(!sdr_stream_error.load()){
+                ch.sq_total_time += real_dt;
+                if(gate) ch.sq_active_time += real_dt;
+            }
+        } else if(!ch.filter_active){
+            ch.sq_active_time = 0;
+            ch.sq_total_time = 0;
+        }
+    }
+}
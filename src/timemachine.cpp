@@ -1,33 +1,44 @@
 #include "fft_viewer.hpp"
 #include "bewe_paths.hpp"
 #include "long_waterfall.hpp"
+#include "tm_tiers.hpp"
 #include <sys/stat.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <algorithm>
 
 static char s_iq_path[256]={};
-static constexpr off_t WAV_HDR_SIZE = 44; // WAV 헤더 크기
+static constexpr size_t TM_AW_SLOT_BYTES = 4u<<20;  // = TmTier::SPILL_SAMPLES × 4 B
+static constexpr int    TM_AW_SLOTS      = 8;       // in-flight 상한 32 MB
+static constexpr off_t WAV_HDR_SIZE = 4096; // WAV 헤더 (JUNK 패딩) — data 가 4K 정렬 → O_DIRECT
 
-// WAV 헤더 작성 (stereo int16: L=I, R=Q)
+static void rolling_path(char* out, size_t sz, uint32_t sr, bool compressed){
+    snprintf(out, sz, "%s/iq_rolling_%uMSPS.%s", BEWEPaths::time_temp_dir().c_str(),
+             sr/1000000, compressed ? "bwtm" : "wav");
+}
+
+// WAV 헤더 작성 (stereo int16: L=I, R=Q). fmt 뒤 JUNK chunk 로 data 를 WAV_HDR_SIZE 에 맞춤.
 static void write_rolling_wav_header(int fd, uint32_t sample_rate, uint32_t n_frames){
     uint32_t data_bytes  = n_frames * 4;
-    uint32_t chunk_size  = 36 + data_bytes;
+    uint32_t chunk_size  = (uint32_t)WAV_HDR_SIZE - 8 + data_bytes;
     uint16_t audio_fmt   = 1, channels = 2;
     uint32_t byte_rate   = sample_rate * 4;
     uint16_t block_align = 4, bits = 16;
-    uint8_t hdr[44]={};
+    uint8_t hdr[WAV_HDR_SIZE]={};
     memcpy(hdr+0,"RIFF",4); memcpy(hdr+4,&chunk_size,4);
     memcpy(hdr+8,"WAVE",4); memcpy(hdr+12,"fmt ",4);
     uint32_t sc1=16; memcpy(hdr+16,&sc1,4);
     memcpy(hdr+20,&audio_fmt,2); memcpy(hdr+22,&channels,2);
     memcpy(hdr+24,&sample_rate,4); memcpy(hdr+28,&byte_rate,4);
     memcpy(hdr+32,&block_align,2); memcpy(hdr+34,&bits,2);
-    memcpy(hdr+36,"data",4); memcpy(hdr+40,&data_bytes,4);
-    pwrite(fd, hdr, 44, 0);
+    uint32_t junk = (uint32_t)WAV_HDR_SIZE - 8 - 36 - 8;
+    memcpy(hdr+36,"JUNK",4); memcpy(hdr+40,&junk,4);
+    memcpy(hdr+WAV_HDR_SIZE-8,"data",4); memcpy(hdr+WAV_HDR_SIZE-4,&data_bytes,4);
+    pwrite(fd, hdr, sizeof(hdr), 0);
 }
 
 void FFTViewer::tm_iq_open(){
@@ -39,59 +50,283 @@ void FFTViewer::tm_iq_open(){
     uint32_t sr=header.sample_rate;
     if(sr==0){ fprintf(stderr,"TM: sample_rate 0\n"); return; }
     tm_iq_total_samples=(int64_t)sr*(int64_t)TM_IQ_SECS;
-    snprintf(s_iq_path,sizeof(s_iq_path),"%s/iq_rolling_%uMSPS.wav",TM_IQ_DIR,sr/1000000);
+    tm_iq_codec=TmCodec::parse_mode(getenv("BEWE_TM_COMPRESS"));
+    bool comp=(tm_iq_codec!=TmCodec::MODE_RAW);
+    rolling_path(s_iq_path,sizeof(s_iq_path),sr,comp);
     // 기존 파일 항상 삭제 후 새로 생성
     if(access(s_iq_path,F_OK)==0){ remove(s_iq_path); bewe_log_push(0,"TM: removed old %s\n",s_iq_path); }
     tm_iq_fd=open(s_iq_path, O_RDWR|O_CREAT|O_TRUNC, 0644);
     if(tm_iq_fd<0){ fprintf(stderr,"TM: open failed: %s\n",strerror(errno)); return; }
-    // WAV 헤더 placeholder (n_frames=0, Stop 시 갱신)
-    write_rolling_wav_header(tm_iq_fd, sr, 0);
-    tm_iq_write_sample=0; tm_iq_chunk_write=0; tm_iq_chunk_sample_start=0;
+    if(comp){
+        // raw 60 s 와 같은 바이트 용량 → look-back 은 압축비만큼 길어짐
+        uint64_t cap=(uint64_t)tm_iq_total_samples*2*sizeof(int16_t);
+        TmCodec::FileHdr fh{};
+        memcpy(fh.magic,"BWTR",4);
+        fh.version=0x0001; fh.mode=(uint8_t)tm_iq_codec;
+        fh.sample_rate=sr; fh.block_samples=TM_IQ_BATCH; fh.cap_bytes=cap;
+        pwrite(tm_iq_fd, &fh, sizeof(fh), 0);
+        tm_iq_ring.open(tm_iq_fd, TmCodec::DATA_OFF, cap, tm_iq_codec);
+    } else {
+        // WAV 헤더 placeholder (n_frames=0, Stop 시 갱신)
+        write_rolling_wav_header(tm_iq_fd, sr, 0);
+        // 데이터는 비동기 writer (정렬된 batch/spill → O_DIRECT)
+        if(tm_aw.attach(tm_iq_fd, s_iq_path, false, TM_AW_SLOT_BYTES, TM_AW_SLOTS))
+            bewe_log_push(0,"TM IQ writer: %s%s\n", AsyncIO::Engine::get().uring()?"io_uring":"thread pool",
+                          tm_aw.direct()?" + O_DIRECT":"");
+    }
+    tm_iq_write_sample=0; tm_iq_spilled=0; tm_iq_chunk_write=0; tm_iq_chunk_sample_start=0;
+    // RAM hot ring (최근 N 초) — 실패하면 SSD 직접 기록
+    {
+        const char* hs=getenv("BEWE_TM_HOT_SECS");
+        float hot_sec=hs ? (float)atof(hs) : TmTier::HOT_SECS_DEFAULT;
+        if(hot_sec>0.f && tm_hot.alloc((int64_t)(hot_sec*sr)))
+            bewe_log_push(0,"TM hot ring: %.1f sec in RAM (%s)\n",
+                          (double)tm_hot.capacity()/sr, tm_hot.hugepage()?"hugepage":"thp");
+    }
+    tm_pin_sources=TmTier::parse_sources(getenv("BEWE_TM_PIN"));
     memset(tm_iq_chunk_time,0,sizeof(tm_iq_chunk_time));
     tm_iq_batch_buf.assign(TM_IQ_BATCH*2, 0);
     tm_iq_batch_cnt=0;
     tm_iq_file_ready=true;
-    bewe_log_push(0,"TM IQ rolling: ready (wav)  max %.1f GB\n",
+    bewe_log_push(0,"TM IQ rolling: ready (%s)  max %.1f GB\n",
+           comp ? TmCodec::mode_name(tm_iq_codec) : "wav",
            (double)(tm_iq_total_samples*2*sizeof(int16_t))/1e9);
     LongWaterfall::request_rotate();   // start a fresh long-waterfall file
 }
 
 void FFTViewer::tm_iq_close(){
     if(tm_iq_fd>=0 && tm_iq_batch_cnt>0) tm_iq_flush_batch();
-    if(tm_iq_fd>=0){
+    if(tm_iq_fd>=0) tm_iq_spill(true);     // hot ring 잔량 → SSD
+    // pin 워커: 남은 pin 을 현재까지로 닫아 저장한 뒤 종료 (fd 닫기 전)
+    if(tm_pin_thr.joinable()){
+        tm_pin_stop.store(true);
+        tm_pin_cv.notify_all();
+        tm_pin_thr.join();
+    }
+    if(tm_iq_fd>=0 && tm_iq_codec!=TmCodec::MODE_RAW){
+        int64_t oldest=tm_iq_ring.oldest_sample();
+        double  secs=(oldest>=0)?(double)(tm_iq_write_sample-oldest)/header.sample_rate:0.0;
+        bewe_log_push(0,"TM IQ rolling: closed (%s)  %.2f sec  ratio %.2f\n",
+                      TmCodec::mode_name(tm_iq_codec), secs, tm_iq_ring.ratio());
+        tm_iq_ring.close();
+        close(tm_iq_fd); tm_iq_fd=-1;
+    } else if(tm_iq_fd>=0){
+        tm_aw.close();                 // in-flight 쓰기 완료 후 헤더 갱신
+        char aio[128];
+        AsyncIO::format(aio, sizeof(aio), tm_aw.stats());
+        bewe_log_push(0,"TM IQ writer: %s\n", aio);
         // Stop: WAV 헤더를 실제 샘플 수로 갱신
-        uint32_t actual = (uint32_t)std::min(tm_iq_write_sample, tm_iq_total_samples);
+        uint32_t actual = (uint32_t)std::min(tm_iq_write_sample, tm_iq_total_samples.load());
         write_rolling_wav_header(tm_iq_fd, header.sample_rate, actual);
         close(tm_iq_fd); tm_iq_fd=-1;
         bewe_log_push(0,"TM IQ rolling: closed  %.2f sec\n",(double)actual/header.sample_rate);
     }
-    tm_iq_file_ready=false; tm_iq_write_sample=0; tm_iq_batch_cnt=0;
+    tm_hot.release();
+    tm_iq_file_ready=false; tm_iq_write_sample=0; tm_iq_spilled=0; tm_iq_batch_cnt=0;
     memset(tm_iq_chunk_time,0,sizeof(tm_iq_chunk_time));
     LongWaterfall::request_rotate();   // close current long-waterfall file
 }
 
-// 배치 버퍼 → 파일 플러시 (내부용)
+// 배치 버퍼 → hot ring (있으면) → SSD (내부용)
 void FFTViewer::tm_iq_flush_batch(){
     if(tm_iq_fd<0||tm_iq_batch_cnt<=0) return;
     int n=tm_iq_batch_cnt;
+    const int16_t* buf=tm_iq_batch_buf.data();
+    if(tm_hot.capacity()>0){
+        tm_hot.write(buf, n, tm_iq_write_sample);
+        tm_iq_write_sample+=n;
+        tm_iq_spill(false);
+    } else {
+        tm_ssd_write(buf, n, tm_iq_write_sample);
+        tm_iq_write_sample+=n;
+        tm_iq_spilled=tm_iq_write_sample;
+    }
+    int64_t cur_sec=tm_iq_write_sample/(int64_t)header.sample_rate;
+    int ci=(int)(cur_sec%(int64_t)TM_IQ_SECS);
+    if(ci!=tm_iq_chunk_write){ tm_iq_chunk_write=ci; tm_iq_chunk_time[ci]=time(nullptr); }
+    tm_iq_batch_cnt=0;
+}
+
+// SSD 롤링 파일에 [pos, pos+n) 기록 (raw: 링 wrap, 압축: 블록 1개)
+void FFTViewer::tm_ssd_write(const int16_t* buf, int n, int64_t pos){
+    if(tm_iq_codec!=TmCodec::MODE_RAW){
+        tm_iq_ring.append(buf, (uint32_t)n, pos);
+        tm_iq_total_samples.store(tm_iq_ring.capacity_samples(), std::memory_order_relaxed);
+        return;
+    }
     int written=0;
-    int16_t* buf=tm_iq_batch_buf.data();
+    int64_t max_total=tm_iq_total_samples;
     while(written<n){
-        int64_t max_total=tm_iq_total_samples;
-        int64_t pos=(tm_iq_write_sample<max_total)
-                    ? tm_iq_write_sample
-                    : tm_iq_write_sample % max_total;
-        int64_t avail=max_total-pos;
-        int chunk=(int)std::min((int64_t)(n-written),(int64_t)avail);
-        off_t offset = WAV_HDR_SIZE + pos*2*(off_t)sizeof(int16_t);
-        ssize_t bytes=(ssize_t)chunk*2*(ssize_t)sizeof(int16_t);
-        pwrite(tm_iq_fd, buf+written*2, (size_t)bytes, offset);
-        written+=chunk; tm_iq_write_sample+=chunk;
-        int64_t cur_sec=tm_iq_write_sample/(int64_t)header.sample_rate;
-        int ci=(int)(cur_sec%(int64_t)TM_IQ_SECS);
-        if(ci!=tm_iq_chunk_write){ tm_iq_chunk_write=ci; tm_iq_chunk_time[ci]=time(nullptr); }
+        int64_t fpos=(pos+written)%max_total;
+        int chunk=(int)std::min((int64_t)(n-written), max_total-fpos);
+        off_t offset = WAV_HDR_SIZE + fpos*2*(off_t)sizeof(int16_t);
+        size_t bytes=(size_t)chunk*2*sizeof(int16_t);
+        tm_aw.write(buf+(size_t)written*2, bytes, offset);
+        written+=chunk;
     }
-    tm_iq_batch_cnt=0;
+}
+
+// hot ring → SSD. all=false: SPILL_SAMPLES 단위로 모일 때만 (큰 pwrite 로 묶음).
+void FFTViewer::tm_iq_spill(bool all){
+    if(tm_hot.capacity()<=0) return;
+    for(;;){
+        int64_t pend=tm_iq_write_sample-tm_iq_spilled;
+        if(pend<=0 || (!all && pend<TmTier::SPILL_SAMPLES)) break;
+        int64_t todo=all ? pend : TmTier::SPILL_SAMPLES;
+        while(todo>0){
+            int64_t n;
+            const int16_t* p=tm_hot.span(tm_iq_spilled, n);
+            n=std::min(n, todo);
+            // 압축 링은 블록 = TM_IQ_BATCH (index 세분도 유지)
+            if(tm_iq_codec!=TmCodec::MODE_RAW) n=std::min(n,(int64_t)TM_IQ_BATCH);
+            if(n<=0) return;
+            tm_ssd_write(p, (int)n, tm_iq_spilled);
+            tm_iq_spilled+=n; todo-=n;
+        }
+    }
+}
+
+bool FFTViewer::tm_ssd_read(int64_t pos, int n, int16_t* dst) const {
+    if(tm_iq_codec!=TmCodec::MODE_RAW) return tm_iq_ring.read(pos, n, dst);
+    int64_t max_total=tm_iq_total_samples;
+    if(max_total<=0) return false;
+    // 파일 끝 넘어가면 두 번 읽기
+    int64_t fpos=pos%max_total;
+    int     r1=(int)std::min((int64_t)n, max_total-fpos);
+    int     r2=n-r1;
+    ssize_t b1=(ssize_t)r1*2*(ssize_t)sizeof(int16_t);
+    ssize_t b2=(ssize_t)r2*2*(ssize_t)sizeof(int16_t);
+    // 이미 spill 된 구간이 아직 in-flight 일 수 있음 — 읽을 구간과 겹치는 쓰기만 대기
+    tm_aw.sync(WAV_HDR_SIZE+(off_t)fpos*2*(off_t)sizeof(int16_t), (size_t)b1);
+    if(r2>0) tm_aw.sync(WAV_HDR_SIZE, (size_t)b2);
+    bool ok=pread(tm_iq_fd, dst, (size_t)b1, WAV_HDR_SIZE+(off_t)fpos*2*(off_t)sizeof(int16_t))==b1;
+    if(r2>0) ok=pread(tm_iq_fd, dst+(size_t)r1*2, (size_t)b2, WAV_HDR_SIZE)==b2 && ok;
+    return ok;
+}
+
+bool FFTViewer::tm_iq_read(int64_t pos, int n, int16_t* dst) const {
+    if(tm_iq_fd<0||n<=0) return false;
+    // hot ring 에 있는 부분은 RAM 에서, 그 이전은 SSD 에서
+    int64_t split=pos+n;
+    if(tm_hot.capacity()>0) split=std::max(pos, std::min(pos+n, tm_hot.lo()));
+    bool ok=true;
+    if(split<pos+n){
+        int nh=(int)(pos+n-split);
+        int16_t* d=dst+(size_t)(split-pos)*2;
+        // 읽는 도중 덮어쓰였으면 이미 spill 된 구간 → SSD
+        if(!tm_hot.read(split, nh, d)) ok=tm_ssd_read(split, nh, d);
+    }
+    if(split>pos) ok=tm_ssd_read(pos, (int)(split-pos), dst) && ok;
+    return ok;
+}
+
+int64_t FFTViewer::tm_iq_valid_start(int64_t snap_write) const {
+    int64_t v;
+    if(tm_iq_codec!=TmCodec::MODE_RAW){
+        int64_t oldest=tm_iq_ring.oldest_sample();
+        v=oldest>=0 ? oldest : snap_write;
+    } else {
+        // raw 링은 SSD 에 내려간 끝(spilled) 기준 60 s
+        int64_t sp=std::min(snap_write, tm_iq_spilled);
+        int64_t tot=tm_iq_total_samples.load(std::memory_order_relaxed);
+        v=(sp>=tot) ? sp-tot : 0;
+    }
+    if(tm_hot.capacity()>0) v=std::min(v, std::max(tm_hot.lo(), (int64_t)0));
+    return v;
+}
+
+void FFTViewer::tm_iq_remove_rolling(uint32_t sr){
+    char p[256];
+    for(bool comp : {false, true}){
+        rolling_path(p, sizeof(p), sr, comp);
+        if(access(p, F_OK)==0) remove(p);
+    }
+}
+
+// ── Trigger pin ──────────────────────────────────────────────────────────
+// squelch: open=true 에서 pin 시작(s1 열림), open=false 에서 +POST 로 닫음.
+// module : 디코드 1건마다 [now-PRE, now+POST], 같은 채널 pin 과 겹치면 연장.
+void FFTViewer::tm_pin_channel(uint32_t trig, int ch, bool open, const char* label){
+    if(!(tm_pin_sources&trig) || !tm_iq_file_ready) return;
+    if(ch<0 || ch>=MAX_CHANNELS || !channels[ch].filter_active) return;
+    uint32_t sr=header.sample_rate;
+    int64_t now=tm_iq_write_sample;
+    int64_t pre=(int64_t)(TmTier::PIN_PRE_SEC*sr), post=(int64_t)(TmTier::PIN_POST_SEC*sr);
+    {
+        std::lock_guard<std::mutex> lk(tm_pin_mtx);
+        for(TmTier::Pin& p : tm_pins){
+            if(p.ch!=ch || p.trig!=trig) continue;
+            if(p.s1<0){ if(!open) p.s1=now+post; return; }
+            if(open && now-pre<=p.s1){
+                p.s1=(trig==TmTier::TRIG_SQUELCH) ? -1 : std::max(p.s1, now+post);
+                return;
+            }
+        }
+    }
+    if(!open) return;
+    float lo=std::min(channels[ch].s, channels[ch].e), hi=std::max(channels[ch].s, channels[ch].e);
+    tm_pin_range(trig, lo, hi, std::max((int64_t)1, now-pre),
+                 (trig==TmTier::TRIG_SQUELCH) ? -1 : now+post, label, ch);
+}
+
+// [s0, s1) 구간 pin 등록 (s1 < 0 = 열림). 워커는 첫 pin 에서 시작.
+void FFTViewer::tm_pin_range(uint32_t trig, float freq_lo, float freq_hi,
+                             int64_t s0, int64_t s1, const char* label, int ch){
+    if(!(tm_pin_sources&trig) || !tm_iq_file_ready) return;
+    TmTier::Pin p;
+    p.trig=trig; p.ch=ch; p.freq_lo=freq_lo; p.freq_hi=freq_hi; p.s0=s0; p.s1=s1;
+    if(label) strncpy(p.label, label, sizeof(p.label)-1);
+    {
+        std::lock_guard<std::mutex> lk(tm_pin_mtx);
+        tm_pins.push_back(p);
+        if(!tm_pin_thr.joinable()){
+            tm_pin_stop.store(false);
+            tm_pin_thr=std::thread([this](){ tm_pin_worker(); });
+        }
+    }
+    tm_pin_cv.notify_all();
+    bewe_log_push(0,"[TM] pin %s %s %.3f-%.3f MHz\n", TmTier::trig_name(trig), p.label,
+                  (double)freq_lo, (double)freq_hi);
+}
+
+// 끝(s1)까지 기록된 pin 을 모아 한 배치(롤링 버퍼 1 pass)로 SigMF 저장.
+void FFTViewer::tm_pin_worker(){
+    std::unique_lock<std::mutex> lk(tm_pin_mtx);
+    for(;;){
+        bool stopping=tm_pin_stop.load();
+        if(!stopping) tm_pin_cv.wait_for(lk, std::chrono::milliseconds(250));
+        stopping=tm_pin_stop.load();
+        uint32_t sr=header.sample_rate;
+        if(sr==0){ if(stopping) break; continue; }
+        int64_t now=tm_iq_write_sample;
+        int64_t max_len=(int64_t)(TmTier::PIN_MAX_SEC*sr);
+        int64_t now_ms=(int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+        std::vector<RegionSel> regs;
+        for(auto it=tm_pins.begin(); it!=tm_pins.end();){
+            TmTier::Pin& p=*it;
+            // 너무 오래 열린 pin / 종료 중 → 현재까지로 닫음
+            if(p.s1<0 && (stopping || now-p.s0>=max_len)) p.s1=now;
+            if(stopping && p.s1>now) p.s1=now;
+            if(p.s1<0 || p.s1>now){ ++it; continue; }
+            if(p.s1>p.s0){
+                RegionSel r{};
+                r.freq_lo=p.freq_lo; r.freq_hi=p.freq_hi;
+                r.samp_start=p.s0; r.samp_end=p.s1;
+                r.time_start_ms=now_ms-(now-p.s0)*1000LL/sr;
+                r.time_end_ms  =now_ms-(now-p.s1)*1000LL/sr;
+                regs.push_back(r);
+            }
+            it=tm_pins.erase(it);
+        }
+        if(!regs.empty()){
+            lk.unlock();
+            do_region_save_batch(regs, true);
+            lk.lock();
+        }
+        if(stopping) break;
+    }
+    tm_pins.clear();
 }
 
 void FFTViewer::tm_iq_write(const int16_t* buf, int n_pairs){
@@ -233,8 +468,9 @@ bool FFTViewer::tm_rec_start(){
     if(fi<0||!channels[fi].filter_active){ return false; }
     int64_t samp_offset=(int64_t)((double)header.sample_rate*tm_offset);
     int64_t read_pos=tm_iq_write_sample-samp_offset;
-    if(read_pos<0) read_pos=tm_iq_total_samples+read_pos;
-    read_pos=read_pos%tm_iq_total_samples;
+    int64_t tot=tm_iq_total_samples.load(std::memory_order_relaxed);
+    if(read_pos<0) read_pos=tot+read_pos;
+    read_pos=read_pos%tot;
     tm_rec_read_pos=read_pos; tm_rec_active=true;
     start_rec(); return true;
 }
\ No newline at end of file
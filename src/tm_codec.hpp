@@ -0,0 +1,347 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Time-machine IQ rolling buffer — block codec + 가변 길이 블록 링 (header-only).
+//
+// 기존 롤링 파일은 int16 IQ 를 60 s 고정 WAV 로 덮어쓴다 (61.44 MSPS ≈ 14.7 GB).
+// 압축 모드에서는 같은 바이트 용량을 가변 길이 블록 링으로 쓰고, 블록 index 로
+// 샘플 좌표 → 파일 위치를 찾는다. 압축비만큼 look-back 이 늘어난다.
+//
+//   Block = BlockHdr(24B) "BWTM" + payload (기록 단위 = TM_IQ_BATCH 샘플)
+//   payload: SUB_VALS(64) 값(=32 IQ pair) 단위 sub-block
+//     [1B: shift<<4 | (width-1)] + 64 × width bit (= 8·width B)
+//     값 = signext(mantissa) << shift
+//   LOSSLESS : shift = 공통 trailing-zero 수 (SC16_Q11 ×16 이면 ≥4), width = 필요 비트
+//              → 조용한 대역(작은 진폭)일수록 width 가 줄어드는 무손실 bit-packing
+//   BFP8/6/4 : width ≤ 8/6/4 로 제한, 넘치는 비트는 shift 로 (반올림) — 블록 부동소수
+//              sub-block 진폭이 한도 안이면 자동으로 무손실
+//   RAW      : 인코딩 결과가 raw 보다 크면 int16 그대로 (노이즈가 꽉 찬 블록)
+//
+// Ring: [data_off, data_off+cap) 바이트 영역에 블록을 순서대로 append, 끝에 못
+//       들어가면 data_off 로 wrap. 새 블록이 덮는 오래된 블록은 index 에서 먼저 제거.
+//       reader 는 pread 후 블록이 아직 index 에 있는지 재확인 (덮어쓰기 race 방지).
+// ─────────────────────────────────────────────────────────────────────────────
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+namespace TmCodec {
+
+enum Mode : uint8_t {
+    MODE_RAW      = 0,
+    MODE_LOSSLESS = 16,     // width 상한 = 16 (무손실)
+    MODE_BFP8     = 8,
+    MODE_BFP6     = 6,
+    MODE_BFP4     = 4,
+};
+constexpr int SUB_VALS = 64;            // sub-block 값 수 (int16, I/Q 교차)
+
+#pragma pack(push, 1)
+// 압축 롤링 파일(.bwtm) 선두 64B. 블록 영역은 DATA_OFF 부터.
+struct FileHdr {
+    char     magic[4];      // "BWTR"
+    uint16_t version;       // 0x0001
+    uint8_t  mode;          // 요청 Mode
+    uint8_t  reserved0;
+    uint32_t sample_rate;
+    uint32_t block_samples;
+    uint64_t cap_bytes;     // 블록 링 바이트 용량
+    uint8_t  reserved[40];
+};
+struct BlockHdr {
+    char     magic[4];      // "BWTM"
+    uint8_t  mode;          // 실제 사용된 Mode (RAW 또는 요청 모드)
+    uint8_t  reserved[3];
+    uint32_t n_samples;     // IQ pair 수
+    int64_t  first_sample;  // tm_iq_write_sample 좌표
+    uint32_t payload_bytes;
+};
+#pragma pack(pop)
+static_assert(sizeof(FileHdr) == 64, "TmCodec::FileHdr must be 64");
+static_assert(sizeof(BlockHdr) == 24, "TmCodec::BlockHdr must be 24");
+constexpr uint64_t DATA_OFF = sizeof(FileHdr);
+
+inline const char* mode_name(uint8_t m){
+    switch(m){
+        case MODE_LOSSLESS: return "lossless";
+        case MODE_BFP8:     return "bfp8";
+        case MODE_BFP6:     return "bfp6";
+        case MODE_BFP4:     return "bfp4";
+        default:            return "raw";
+    }
+}
+// "lossless"/"bfp8"/"bfp6"/"bfp4" → Mode, 그 외 RAW.
+inline Mode parse_mode(const char* s){
+    if(!s) return MODE_RAW;
+    if(!strcmp(s, "lossless")) return MODE_LOSSLESS;
+    if(!strcmp(s, "bfp8"))     return MODE_BFP8;
+    if(!strcmp(s, "bfp6"))     return MODE_BFP6;
+    if(!strcmp(s, "bfp4"))     return MODE_BFP4;
+    return MODE_RAW;
+}
+
+// 최악의 payload 크기 (sub-block 헤더 + 16bit 폭)
+inline size_t max_payload(uint32_t n_samples){
+    size_t subs = ((size_t)n_samples * 2 + SUB_VALS - 1) / SUB_VALS;
+    return subs * (1 + SUB_VALS * 2);
+}
+
+// ── sub-block codec ──────────────────────────────────────────────────────
+// v[SUB_VALS] → out. width 상한 cap (16 = 무손실). 기록한 바이트 수 반환.
+inline size_t encode_sub(const int16_t* v, int cap, uint8_t* out){
+    uint32_t ors = 0, mag = 0;
+    for(int k = 0; k < SUB_VALS; k++){
+        int32_t x = v[k];
+        ors |= (uint32_t)(uint16_t)x;
+        mag |= (uint32_t)(x ^ (x >> 31));          // 음수 → ~x (부호 비트 제외 크기)
+    }
+    int shift = 0;
+    if(ors) while(!((ors >> shift) & 1u)) shift++;  // 공통 trailing zero (무손실)
+    mag >>= shift;
+    int need = 1;
+    while(need < 16 && (mag >> (need - 1))) need++; // 2의 보수 폭
+    int width = std::min(need, cap);
+    int extra = need - width;                       // 손실 비트 (BFP)
+    shift += extra;
+
+    out[0] = (uint8_t)((shift << 4) | (width - 1));
+    uint8_t* p = out + 1;
+    const int32_t lo = -(1 << (width - 1)), hi = (1 << (width - 1)) - 1;
+    const int32_t rnd = extra ? (1 << (shift - 1)) : 0;
+    const uint32_t msk = (1u << width) - 1u;
+    uint64_t acc = 0;
+    int nbit = 0;
+    for(int k = 0; k < SUB_VALS; k++){
+        int32_t m = ((int32_t)v[k] + rnd) >> shift;
+        m = std::max(lo, std::min(hi, m));
+        acc |= (uint64_t)((uint32_t)m & msk) << nbit;
+        nbit += width;
+        while(nbit >= 8){ *p++ = (uint8_t)acc; acc >>= 8; nbit -= 8; }
+    }
+    return (size_t)(p - out);                       // 64·width 는 항상 8 의 배수
+}
+
+// in → v[SUB_VALS]. 소비한 바이트 수 반환 (avail 부족 시 0).
+inline size_t decode_sub(const uint8_t* in, size_t avail, int16_t* v){
+    if(avail < 1) return 0;
+    int width = (in[0] & 0x0F) + 1;
+    int shift = in[0] >> 4;
+    size_t bytes = 1 + (size_t)SUB_VALS * width / 8;
+    if(avail < bytes) return 0;
+    const uint8_t* p = in + 1;
+    const int sh = 32 - width;
+    uint64_t acc = 0;
+    int nbit = 0;
+    for(int k = 0; k < SUB_VALS; k++){
+        while(nbit < width){ acc |= (uint64_t)(*p++) << nbit; nbit += 8; }
+        int32_t m = (int32_t)((uint32_t)acc << sh) >> sh;   // sign-extend
+        acc >>= width; nbit -= width;
+        v[k] = (int16_t)std::max(-32768, std::min(32767, m * (1 << shift)));
+    }
+    return bytes;
+}
+
+// ── block codec ──────────────────────────────────────────────────────────
+// iq(n pair) → out = BlockHdr + payload. 인코딩이 raw 보다 크면 RAW 로 저장.
+inline void encode_block(const int16_t* iq, uint32_t n, int64_t first, Mode mode,
+                         std::vector<uint8_t>& out){
+    size_t raw_bytes = (size_t)n * 2 * sizeof(int16_t);
+    out.resize(sizeof(BlockHdr) + std::max(raw_bytes, max_payload(n)));
+    size_t len = 0;
+    uint8_t used = MODE_RAW;
+    if(mode != MODE_RAW){
+        uint8_t* p = out.data() + sizeof(BlockHdr);
+        size_t vals = (size_t)n * 2, k = 0;
+        for(; k + SUB_VALS <= vals; k += SUB_VALS) len += encode_sub(iq + k, mode, p + len);
+        if(k < vals){                                 // 마지막 partial sub-block: 0 패딩
+            int16_t tail[SUB_VALS] = {};
+            memcpy(tail, iq + k, (vals - k) * sizeof(int16_t));
+            len += encode_sub(tail, mode, p + len);
+        }
+        used = (uint8_t)mode;
+    }
+    if(mode == MODE_RAW || len >= raw_bytes){
+        memcpy(out.data() + sizeof(BlockHdr), iq, raw_bytes);
+        len  = raw_bytes;
+        used = MODE_RAW;
+    }
+    BlockHdr h{};
+    memcpy(h.magic, "BWTM", 4);
+    h.mode          = used;
+    h.n_samples     = n;
+    h.first_sample  = first;
+    h.payload_bytes = (uint32_t)len;
+    memcpy(out.data(), &h, sizeof(h));
+    out.resize(sizeof(BlockHdr) + len);
+}
+
+// blk(전체 블록 바이트) → iq(n pair). 헤더 불일치/손상 시 false.
+inline bool decode_block(const uint8_t* blk, size_t avail, int64_t expect_first,
+                         std::vector<int16_t>& iq){
+    BlockHdr h;
+    if(avail < sizeof(h)) return false;
+    memcpy(&h, blk, sizeof(h));
+    if(memcmp(h.magic, "BWTM", 4) != 0 || h.first_sample != expect_first) return false;
+    if((size_t)h.payload_bytes > avail - sizeof(h)) return false;
+    const uint8_t* p = blk + sizeof(h);
+    size_t vals = (size_t)h.n_samples * 2;
+    iq.resize(vals);
+    if(h.mode == MODE_RAW){
+        if(h.payload_bytes != vals * sizeof(int16_t)) return false;
+        memcpy(iq.data(), p, h.payload_bytes);
+        return true;
+    }
+    size_t pos = 0, k = 0;
+    for(; k + SUB_VALS <= vals; k += SUB_VALS){
+        size_t c = decode_sub(p + pos, h.payload_bytes - pos, iq.data() + k);
+        if(!c) return false;
+        pos += c;
+    }
+    if(k < vals){
+        int16_t tail[SUB_VALS];
+        if(!decode_sub(p + pos, h.payload_bytes - pos, tail)) return false;
+        memcpy(iq.data() + k, tail, (vals - k) * sizeof(int16_t));
+    }
+    return true;
+}
+
+// ── 가변 길이 블록 링 ────────────────────────────────────────────────────
+// append() 는 writer 스레드 하나, read() 는 여러 스레드에서 동시 호출 가능.
+class Ring {
+public:
+    void open(int fd, uint64_t data_off, uint64_t cap_bytes, Mode mode){
+        std::lock_guard<std::mutex> lk(mtx_);
+        fd_ = fd; base_ = data_off; cap_ = cap_bytes; mode_ = mode;
+        w_ = data_off;
+        idx_.clear();
+        gen_.fetch_add(1);
+        raw_bytes_ = 0; stored_bytes_ = 0;
+    }
+    void close(){
+        std::lock_guard<std::mutex> lk(mtx_);
+        fd_ = -1; idx_.clear();
+        gen_.fetch_add(1);
+    }
+    Mode mode() const { return mode_; }
+
+    // 블록 인코딩 + 기록. 성공 시 true.
+    bool append(const int16_t* iq, uint32_t n, int64_t first){
+        if(fd_ < 0 || n == 0) return false;
+        encode_block(iq, n, first, mode_, enc_);
+        uint64_t len = enc_.size();
+        if(len > cap_) return false;
+        uint64_t at;
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if(w_ + len > base_ + cap_){
+                // wrap: 꼬리 영역 블록(가장 오래된 것들)은 모두 폐기
+                uint64_t w_old = w_;
+                while(!idx_.empty() && idx_.front().off >= w_old) idx_.pop_front();
+                w_ = base_;
+            }
+            // 새 블록이 덮는 오래된 블록 제거 (pwrite 전에 — reader 재확인용)
+            while(!idx_.empty() && idx_.front().off >= w_ && idx_.front().off < w_ + len)
+                idx_.pop_front();
+            at  = w_;
+            w_ += len;
+        }
+        bool ok = pwrite(fd_, enc_.data(), (size_t)len, (off_t)at) == (ssize_t)len;
+        std::lock_guard<std::mutex> lk(mtx_);
+        if(ok) idx_.push_back({first, n, at, (uint32_t)len});
+        raw_bytes_    += (uint64_t)n * 2 * sizeof(int16_t);
+        stored_bytes_ += len;
+        return ok;
+    }
+
+    // index 에 남아 있는 가장 오래된 샘플 (비었으면 -1).
+    int64_t oldest_sample() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return idx_.empty() ? -1 : idx_.front().first;
+    }
+    // raw / stored (≥1 이면 압축 이득).
+    double ratio() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return stored_bytes_ ? (double)raw_bytes_ / (double)stored_bytes_ : 1.0;
+    }
+    // 현재 압축비 기준 링이 담는 샘플 수 추정.
+    int64_t capacity_samples() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        double r = stored_bytes_ ? (double)raw_bytes_ / (double)stored_bytes_ : 1.0;
+        return (int64_t)((double)cap_ * r / (2.0 * sizeof(int16_t)));
+    }
+
+    // [pos, pos+n) → dst (int16 IQ). 링에 없는(덮어쓴/미기록) 구간은 0, false 반환.
+    bool read(int64_t pos, int n, int16_t* dst) const {
+        bool all = true;
+        int k = 0;
+        while(k < n){
+            Ent e;
+            uint64_t g;
+            bool found = false;
+            int64_t s0 = pos + k, nxt = pos + n;
+            {
+                std::lock_guard<std::mutex> lk(mtx_);
+                g = gen_.load();
+                auto it = std::upper_bound(idx_.begin(), idx_.end(), s0,
+                    [](int64_t s, const Ent& x){ return s < x.first; });
+                if(it != idx_.end()) nxt = std::min(nxt, it->first);
+                if(it != idx_.begin() && s0 < (it - 1)->first + (it - 1)->n){
+                    e = *(it - 1);
+                    found = true;
+                }
+            }
+            if(!found){
+                // 이 샘플이 속한 블록 없음 → 다음 블록 시작까지 0
+                int z = (int)std::max((int64_t)1, nxt - s0);
+                memset(dst + (size_t)k * 2, 0, (size_t)z * 2 * sizeof(int16_t));
+                k += z; all = false;
+                continue;
+            }
+            const std::vector<int16_t>* pcm = decoded(e, g);
+            int off  = (int)(pos + k - e.first);
+            int take = std::min(n - k, (int)e.n - off);
+            if(pcm) memcpy(dst + (size_t)k * 2, pcm->data() + (size_t)off * 2,
+                           (size_t)take * 2 * sizeof(int16_t));
+            else { memset(dst + (size_t)k * 2, 0, (size_t)take * 2 * sizeof(int16_t)); all = false; }
+            k += take;
+        }
+        return all;
+    }
+
+private:
+    struct Ent { int64_t first; uint32_t n; uint64_t off; uint32_t bytes; };
+
+    // 스레드별 1-블록 디코드 캐시 (64k 청크 읽기가 블록 경계에 걸쳐도 블록당 디코드 1회).
+    const std::vector<int16_t>* decoded(const Ent& e, uint64_t g) const {
+        struct Cache { uint64_t gen = 0; int64_t first = -1; std::vector<uint8_t> raw;
+                       std::vector<int16_t> pcm; };
+        thread_local Cache c;
+        if(c.gen == g && c.first == e.first) return &c.pcm;
+        c.first = -1;
+        c.raw.resize(e.bytes);
+        if(pread(fd_, c.raw.data(), e.bytes, (off_t)e.off) != (ssize_t)e.bytes) return nullptr;
+        {
+            // pread 동안 writer 가 덮었는지 확인
+            std::lock_guard<std::mutex> lk(mtx_);
+            if(gen_.load() != g || idx_.empty() || idx_.front().first > e.first) return nullptr;
+        }
+        if(!decode_block(c.raw.data(), c.raw.size(), e.first, c.pcm)) return nullptr;
+        c.gen = g; c.first = e.first;
+        return &c.pcm;
+    }
+
+    mutable std::mutex    mtx_;
+    std::deque<Ent>       idx_;
+    std::atomic<uint64_t> gen_{0};      // open/close 마다 증가 (스레드 캐시 무효화)
+    int      fd_   = -1;
+    uint64_t base_ = 0, cap_ = 0, w_ = 0;
+    Mode     mode_ = MODE_RAW;
+    uint64_t raw_bytes_ = 0, stored_bytes_ = 0;
+    std::vector<uint8_t> enc_;          // writer 전용 scratch
+};
+
+} // namespace TmCodec
@@ -0,0 +1,148 @@
+#pragma once
+// ─────────────────────────────────────────────────────────────────────────────
+// Time-machine 계층 보존 (header-only).
+//
+//   hot  : 최근 N 초를 RAM ring (hugepage 우선) 에 유지 → "방금 그것" region_save 는
+//          디스크 I/O 없이 메모리에서 추출. SSD 에는 SPILL 단위(16 배치)로 모아서
+//          내려보내 작은 pwrite 반복을 없앤다.
+//   warm : 기존 SSD 롤링 파일 (raw WAV 또는 TmCodec 압축 링).
+//   pin  : squelch / 모듈 디코드 / 예약 녹음 trigger 가 가리키는 구간을 덮어쓰기
+//          전에 SigMF 파일로 영구 보존 (채널 대역만 DDC 추출).
+// ─────────────────────────────────────────────────────────────────────────────
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+namespace TmTier {
+
+constexpr float   HOT_SECS_DEFAULT = 2.0f;       // BEWE_TM_HOT_SECS (0 = 끔)
+constexpr int64_t SPILL_SAMPLES    = 1 << 20;    // SSD 로 내리는 단위 (16 × TM_IQ_BATCH)
+constexpr float   PIN_PRE_SEC      = 2.0f;       // trigger 이전 보존 구간
+constexpr float   PIN_POST_SEC     = 1.0f;       // trigger(또는 squelch 닫힘) 이후
+constexpr float   PIN_MAX_SEC      = 30.0f;      // 열린 pin 강제 종료 길이
+
+enum Trig : uint32_t {
+    TRIG_SQUELCH = 1u << 0,
+    TRIG_MODULE  = 1u << 1,
+    TRIG_SCHED   = 1u << 2,
+};
+
+// "squelch,module,sched" (BEWE_TM_PIN) → Trig 비트.
+inline uint32_t parse_sources(const char* s){
+    uint32_t m = 0;
+    if(!s) return 0;
+    if(strstr(s, "squelch")) m |= TRIG_SQUELCH;
+    if(strstr(s, "module"))  m |= TRIG_MODULE;
+    if(strstr(s, "sched"))   m |= TRIG_SCHED;
+    if(strstr(s, "all"))     m |= TRIG_SQUELCH | TRIG_MODULE | TRIG_SCHED;
+    return m;
+}
+inline const char* trig_name(uint32_t t){
+    switch(t){
+        case TRIG_SQUELCH: return "squelch";
+        case TRIG_MODULE:  return "module";
+        case TRIG_SCHED:   return "sched";
+        default:           return "?";
+    }
+}
+
+struct Pin {
+    uint32_t trig    = 0;
+    int      ch      = -1;
+    float    freq_lo = 0, freq_hi = 0;   // MHz
+    int64_t  s0 = 0, s1 = -1;            // tm_iq_write_sample 좌표, s1 < 0 = 열림
+    char     label[32] = {};
+};
+
+// ── RAM hot ring ─────────────────────────────────────────────────────────
+// write() 는 writer 스레드 하나, read() 는 여러 스레드. reader 는 복사 후
+// lo() 를 다시 확인해 복사 도중 덮어쓰인 구간이면 false (호출자가 SSD 로 fallback).
+class HotRing {
+public:
+    ~HotRing(){ release(); }
+
+    // cap_samples 는 SPILL_SAMPLES 배수로 올림 (spill 경계가 ring wrap 과 맞도록).
+    bool alloc(int64_t cap_samples){
+        release();
+        if(cap_samples <= 0) return false;
+        cap_samples = (cap_samples + SPILL_SAMPLES - 1) / SPILL_SAMPLES * SPILL_SAMPLES;
+        cap_samples = std::max(cap_samples, 2 * SPILL_SAMPLES);
+        size_t bytes = (size_t)cap_samples * 2 * sizeof(int16_t);
+        huge_ = true;
+        void* m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(m == MAP_FAILED){
+            huge_ = false;
+            m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(m == MAP_FAILED) return false;
+            madvise(m, bytes, MADV_HUGEPAGE);       // THP 로라도
+        }
+        buf_ = (int16_t*)m; bytes_ = bytes; cap_ = cap_samples;
+        reset(0);
+        return true;
+    }
+    void release(){
+        if(buf_) munmap(buf_, bytes_);
+        buf_ = nullptr; bytes_ = 0; cap_ = 0;
+        lo_.store(0); end_.store(0);
+    }
+    void reset(int64_t start){ lo_.store(start); end_.store(start); }
+
+    int64_t capacity() const { return cap_; }
+    bool    hugepage() const { return huge_; }
+    int64_t lo()  const { return lo_.load(std::memory_order_acquire); }
+    int64_t end() const { return end_.load(std::memory_order_acquire); }
+
+    // pos == end() 에 n pair append.
+    void write(const int16_t* iq, int n, int64_t pos){
+        if(!buf_ || n <= 0) return;
+        int64_t new_lo = pos + n - cap_;
+        if(new_lo > lo_.load(std::memory_order_relaxed)){
+            lo_.store(new_lo, std::memory_order_relaxed);   // 덮기 전에 공개
+            // seqlock: 아래 memcpy 가 lo_ 보다 먼저 보이지 않도록 (reader 의 acquire fence 와 짝)
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        int k = 0;
+        while(k < n){
+            int64_t at   = (pos + k) % cap_;
+            int     take = (int)std::min((int64_t)(n - k), cap_ - at);
+            memcpy(buf_ + at * 2, iq + (size_t)k * 2, (size_t)take * 2 * sizeof(int16_t));
+            k += take;
+        }
+        end_.store(pos + n, std::memory_order_release);
+    }
+
+    // writer 전용: pos 부터 wrap 전까지 연속 구간 포인터 (n = 길이).
+    const int16_t* span(int64_t pos, int64_t& n) const {
+        int64_t at = pos % cap_;
+        n = std::min(end() - pos, cap_ - at);
+        return buf_ + at * 2;
+    }
+
+    bool read(int64_t pos, int n, int16_t* dst) const {
+        if(!buf_ || n <= 0) return false;
+        if(pos < lo() || pos + n > end()) return false;
+        int k = 0;
+        while(k < n){
+            int64_t at   = (pos + k) % cap_;
+            int     take = (int)std::min((int64_t)(n - k), cap_ - at);
+            memcpy(dst + (size_t)k * 2, buf_ + at * 2, (size_t)take * 2 * sizeof(int16_t));
+            k += take;
+        }
+        // 복사한 바이트를 읽은 뒤에 lo_ 재확인 (writer 의 release fence 와 짝)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return lo_.load(std::memory_order_relaxed) <= pos;
+    }
+
+private:
+    int16_t* buf_   = nullptr;
+    size_t   bytes_ = 0;
+    int64_t  cap_   = 0;
+    bool     huge_  = false;
+    std::atomic<int64_t> lo_{0}, end_{0};   // 유효 범위 [lo, end)
+};
+
+} // namespace TmTier
@@ -0,0 +1,295 @@
+#include "trace.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Trace {
+
+std::atomic<bool> g_on{false};
+
+namespace {
+struct Ev {
+    uint64_t t0, t1;   // t1 == 0 → instant
+    uint32_t arg;
+    uint16_t id;
+    uint16_t pad;
+};
+
+// 스레드 1개 전용 ring. writer = 소유 스레드, reader = dump (멈추지 않고 읽음 —
+// wrap 구간은 margin 만큼 버림). 스레드 종료 시 live=false → 다음 새 스레드가 재사용
+// (Central 접속별 스레드가 계속 생겨도 메모리 상한 = 동시 스레드 수 × ring).
+struct Buf {
+    std::unique_ptr<Ev[]> ev;
+    uint64_t              mask = 0;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> floor{0};   // 재사용 시점 head — 이전 소유자 이벤트 제외
+    int                   tid = 0;
+    char                  name[16] = {};
+    bool                  live = false;
+};
+
+constexpr int      MAX_IDS = 1024;
+constexpr uint64_t MARGIN  = 64;      // dump 중 writer 가 덮어쓸 수 있는 구간
+
+struct State {
+    std::mutex mtx;                   // pool / ids / name (hot path 는 첫 emit 때만)
+    std::vector<std::unique_ptr<Buf>> pool;
+    std::string cat[MAX_IDS], name[MAX_IDS];
+    int         n_ids = 1;            // 0 = 무효
+    uint64_t    cap = 32768;          // 스레드당 이벤트 수 (24 B 씩)
+    std::atomic<uint64_t> t_origin{0};   // 첫 start() — ts 기준
+    std::atomic<uint64_t> t_floor{0};    // clear() — 이전 이벤트 무시
+    uint64_t    cal_tsc = 0;
+    int64_t     cal_ns  = 0;
+};
+State& st(){
+    static State* s = new State;      // 종료 중 emit 대비 해제 안 함
+    return *s;
+}
+
+struct Holder {
+    Buf* b = nullptr;
+    ~Holder(){
+        if(!b) return;
+        std::lock_guard<std::mutex> lk(st().mtx);
+        b->live = false;
+    }
+};
+thread_local Buf*   t_buf = nullptr;
+thread_local Holder t_hold;
+
+int64_t mono_ns(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Buf* acquire(){
+    State& s = st();
+    std::lock_guard<std::mutex> lk(s.mtx);
+    Buf* b = nullptr;
+    for(auto& p : s.pool)
+        if(!p->live && p->mask + 1 == s.cap){ b = p.get(); break; }
+    if(!b){
+        s.pool.emplace_back(new Buf);
+        b = s.pool.back().get();
+        b->ev.reset(new Ev[s.cap]);
+        b->mask = s.cap - 1;
+    }
+    b->floor.store(b->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    b->tid  = (int)syscall(SYS_gettid);
+    b->live = true;
+    pthread_getname_np(pthread_self(), b->name, sizeof(b->name));
+    t_buf = b;
+    t_hold.b = b;
+    return b;
+}
+
+// tsc → ns (첫 start 이후 경과 구간으로 보정, 짧으면 잠깐 대기)
+double ns_per_tick(){
+#if defined(__x86_64__) || defined(__i386__)
+    State& s = st();
+    int64_t dn = mono_ns() - s.cal_ns;
+    if(dn < 20000000){
+        std::this_thread::sleep_for(std::chrono::nanoseconds(20000000 - dn));
+        dn = mono_ns() - s.cal_ns;
+    }
+    uint64_t dt = now() - s.cal_tsc;
+    return dt ? (double)dn / (double)dt : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+void json_str(std::string& o, const char* s){
+    o += '"';
+    for(; *s; s++){
+        unsigned char ch = (unsigned char)*s;
+        if(ch == '"' || ch == '\\'){ o += '\\'; o += (char)ch; }
+        else if(ch < 0x20){ char b[8]; snprintf(b, sizeof(b), "\\u%04x", ch); o += b; }
+        else o += (char)ch;
+    }
+    o += '"';
+}
+
+bool read_comm(const char* path, char* out, size_t n){
+    FILE* f = fopen(path, "r");
+    if(!f) return false;
+    bool ok = fgets(out, (int)n, f) != nullptr;
+    fclose(f);
+    if(ok) out[strcspn(out, "\n")] = 0;
+    return ok;
+}
+} // namespace
+
+uint16_t event_id(const char* cat, const char* name){
+    State& s = st();
+    std::lock_guard<std::mutex> lk(s.mtx);
+    for(int i = 1; i < s.n_ids; i++)
+        if(s.cat[i] == cat && s.name[i] == name) return (uint16_t)i;
+    if(s.n_ids >= MAX_IDS) return 0;
+    s.cat[s.n_ids] = cat; s.name[s.n_ids] = name;
+    return (uint16_t)s.n_ids++;
+}
+
+void emit(uint16_t id, uint64_t t0, uint64_t t1, uint32_t arg){
+    if(!id) return;
+    Buf* b = t_buf;
+    if(!b) b = acquire();
+    uint64_t h = b->head.load(std::memory_order_relaxed);
+    Ev& e = b->ev[h & b->mask];
+    e.t0 = t0; e.t1 = t1; e.arg = arg; e.id = id; e.pad = 0;
+    b->head.store(h + 1, std::memory_order_release);
+}
+
+void start(){
+    State& s = st();
+    {
+        std::lock_guard<std::mutex> lk(s.mtx);
+        if(!s.t_origin.load()){
+            s.cal_ns  = mono_ns();
+            s.cal_tsc = now();
+            s.t_origin.store(s.cal_tsc);
+        }
+    }
+    g_on.store(true);
+    fprintf(stderr, "[TRACE] on (%llu events/thread)\n", (unsigned long long)s.cap);
+}
+
+void stop(){
+    g_on.store(false);
+    fprintf(stderr, "[TRACE] off\n");
+}
+
+void clear(){
+    st().t_floor.store(now());
+}
+
+std::string dump_json(double last_ms){
+    State& s = st();
+    uint64_t origin = s.t_origin.load();
+    std::string o = "{\"traceEvents\":[";
+    if(!origin){ o += "],\"displayTimeUnit\":\"ns\"}\n"; return o; }
+
+    double   npt   = ns_per_tick();
+    uint64_t t_end = now();
+    uint64_t lo_t  = std::max(origin, s.t_floor.load());
+    if(last_ms > 0){
+        uint64_t w = (uint64_t)(last_ms * 1e6 / npt);
+        if(t_end > w) lo_t = std::max(lo_t, t_end - w);
+    }
+    int pid = (int)getpid();
+    bool first = true;
+    auto sep = [&](){ if(!first) o += ",\n"; first = false; };
+    char b[192];
+
+    char pname[64] = "bewe";
+    read_comm("/proc/self/comm", pname, sizeof(pname));
+    sep();
+    snprintf(b, sizeof(b), "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":", pid);
+    o += b; json_str(o, pname); o += "}}";
+
+    std::lock_guard<std::mutex> lk(s.mtx);
+    std::vector<Ev> tmp;
+    for(auto& p : s.pool){
+        Buf& bf = *p;
+        uint64_t cap = bf.mask + 1;
+        uint64_t h   = bf.head.load(std::memory_order_acquire);
+        uint64_t lo  = bf.floor.load(std::memory_order_relaxed);
+        if(h > cap - MARGIN) lo = std::max(lo, h - (cap - MARGIN));
+        if(lo >= h) continue;
+        tmp.resize(h - lo);
+        for(uint64_t i = lo; i < h; i++) tmp[i - lo] = bf.ev[i & bf.mask];
+        // 복사 중 writer 가 앞지른 구간 버림
+        uint64_t h2 = bf.head.load(std::memory_order_acquire);
+        uint64_t skip = (h2 > cap - MARGIN && h2 - (cap - MARGIN) > lo) ? h2 - (cap - MARGIN) - lo : 0;
+
+        char tname[16];
+        memcpy(tname, bf.name, sizeof(tname));
+        if(bf.live){
+            char path[64];
+            snprintf(path, sizeof(path), "/proc/self/task/%d/comm", bf.tid);
+            read_comm(path, tname, sizeof(tname));
+        }
+        if(!tname[0]) snprintf(tname, sizeof(tname), "tid%d", bf.tid);
+        sep();
+        snprintf(b, sizeof(b), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                 pid, bf.tid);
+        o += b; json_str(o, tname); o += "}}";
+
+        for(size_t i = (size_t)std::min<uint64_t>(skip, tmp.size()); i < tmp.size(); i++){
+            const Ev& e = tmp[i];
+            if(e.t0 < lo_t || !e.id || e.id >= s.n_ids) continue;
+            double ts = (double)(e.t0 - origin) * npt * 1e-3;
+            sep();
+            o += "{\"name\":"; json_str(o, s.name[e.id].c_str());
+            o += ",\"cat\":";  json_str(o, s.cat[e.id].c_str());
+            if(e.t1){
+                double dur = e.t1 > e.t0 ? (double)(e.t1 - e.t0) * npt * 1e-3 : 0.0;
+                snprintf(b, sizeof(b), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", ts, dur);
+            } else {
+                snprintf(b, sizeof(b), ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", ts);
+            }
+            o += b;
+            snprintf(b, sizeof(b), ",\"pid\":%d,\"tid\":%d,\"args\":{\"n\":%u}}", pid, bf.tid, e.arg);
+            o += b;
+        }
+    }
+    o += "],\"displayTimeUnit\":\"ns\"}\n";
+    return o;
+}
+
+bool dump_file(const char* path, double last_ms){
+    std::string j = dump_json(last_ms);
+    FILE* f = fopen(path, "w");
+    if(!f){ fprintf(stderr, "[TRACE] open %s failed\n", path); return false; }
+    bool ok = fwrite(j.data(), 1, j.size(), f) == j.size();
+    fclose(f);
+    fprintf(stderr, "[TRACE] wrote %s (%zu bytes)\n", path, j.size());
+    return ok;
+}
+
+void init_from_env(){
+    static bool done = false;
+    if(done) return;
+    done = true;
+    if(const char* e = getenv("BEWE_TRACE_EVENTS")){
+        uint64_t n = strtoull(e, nullptr, 10), c = 1024;
+        while(c < n && c < (1ull << 22)) c <<= 1;
+        std::lock_guard<std::mutex> lk(st().mtx);
+        st().cap = c;
+    }
+    const char* on_env = getenv("BEWE_TRACE");
+    if(on_env && on_env[0] && strcmp(on_env, "0")) start();
+    // BEWE_TRACE_FILE=path → 종료 시 dump
+    if(getenv("BEWE_TRACE_FILE"))
+        atexit([]{ if(st().t_origin.load()) dump_file(getenv("BEWE_TRACE_FILE")); });
+}
+
+void http_install(){
+    init_from_env();
+    Metrics::http_route("/trace", [](const std::string& path, std::string& ctype) -> std::string {
+        if(path == "/trace/start"){ start(); return "trace on\n"; }
+        if(path == "/trace/stop"){  stop();  return "trace off\n"; }
+        if(path == "/trace/clear"){ clear(); return "trace cleared\n"; }
+        if(path == "/trace" || !path.compare(0, 7, "/trace?")){
+            double ms = 0;
+            size_t q = path.find("ms=");
+            if(q != std::string::npos) ms = atof(path.c_str() + q + 3);
+            ctype = "application/json";
+            return dump_json(ms);
+        }
+        return "";
+    });
+}
+
+} // namespace Trace
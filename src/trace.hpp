@@ -0,0 +1,86 @@
+#pragma once
+// ── hot path 이벤트 트레이서 (Chrome trace / Perfetto JSON) ──────────────────
+//   스레드별 lock-free ring (단일 writer) 에 {t0, t1, id, arg} 기록. 시각 = TSC (x86) /
+//   CLOCK_MONOTONIC ns (그 외) — dump 시 시작 시점 기준으로 µs 환산.
+//   이벤트 id 는 호출 지점마다 static 1회 등록 (cat, name 문자열 → uint16).
+//   꺼져 있으면 scope 1개 = relaxed load 1회 + 분기 (ring 도 할당 안 함).
+//
+//   BEWE_TRACE_SCOPE("cap", "rx");                  // 블록 끝까지 span
+//   BEWE_TRACE_SCOPE_ARG("dem", "ring_read", n);   // arg 포함 (Perfetto args.n)
+//   BEWE_TRACE_SCOPE_V(sc, "net", "send"); sc.arg = bytes;   // arg 를 나중에
+//   BEWE_TRACE_INSTANT("cap", "overrun", lost);     // 순간 이벤트
+//   BEWE_TRACE_SPAN("disk", "write", t0, len);      // t0 = Trace::now() (다른 스레드에서 시작한 구간)
+//
+// 토글: 환경변수 BEWE_TRACE=1 (시작 시 on) 또는 /metrics HTTP 서버의
+//   /trace/start  /trace/stop  /trace/clear  /trace[?ms=N] (JSON dump, 최근 N ms)
+// cmake -DBEWE_TRACE=OFF (→ BEWE_NO_TRACE) 로 빌드하면 매크로 전부 제거.
+#include <atomic>
+#include <cstdint>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#else
+  #include <time.h>
+#endif
+
+namespace Trace {
+
+extern std::atomic<bool> g_on;
+inline bool on(){ return g_on.load(std::memory_order_relaxed); }
+
+inline uint64_t now(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+uint16_t event_id(const char* cat, const char* name);   // 같은 (cat,name) → 같은 id
+void     emit(uint16_t id, uint64_t t0, uint64_t t1, uint32_t arg);   // t1 == 0 → instant
+
+struct Scope {
+    uint64_t t0 = 0;
+    uint32_t arg;
+    uint16_t id;
+    explicit Scope(uint16_t i, uint32_t a = 0) : arg(a), id(i){ if(on()) t0 = now(); }
+    ~Scope(){ if(t0) emit(id, t0, now(), arg); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+void start();                           // ring 은 첫 이벤트 때 스레드별 할당
+void stop();
+void clear();
+std::string dump_json(double last_ms = 0);   // 0 = ring 전체
+bool dump_file(const char* path, double last_ms = 0);
+void init_from_env();                   // BEWE_TRACE=1 → start(), BEWE_TRACE_EVENTS=N (스레드당 ring 크기)
+void http_install();                    // Metrics HTTP 서버에 /trace 경로 등록
+
+} // namespace Trace
+
+#define BEWE_TR_CAT2(a, b) a##b
+#define BEWE_TR_CAT(a, b)  BEWE_TR_CAT2(a, b)
+#ifndef BEWE_NO_TRACE
+  #define BEWE_TRACE_SCOPE_V(var, cat, name) \
+      static const uint16_t BEWE_TR_CAT(bewe_tr_id_, __LINE__) = Trace::event_id(cat, name); \
+      Trace::Scope var(BEWE_TR_CAT(bewe_tr_id_, __LINE__))
+  #define BEWE_TRACE_SCOPE_ARG(cat, name, arg) \
+      static const uint16_t BEWE_TR_CAT(bewe_tr_id_, __LINE__) = Trace::event_id(cat, name); \
+      Trace::Scope BEWE_TR_CAT(bewe_tr_sc_, __LINE__)(BEWE_TR_CAT(bewe_tr_id_, __LINE__), (uint32_t)(arg))
+  #define BEWE_TRACE_SCOPE(cat, name) BEWE_TRACE_SCOPE_ARG(cat, name, 0)
+  #define BEWE_TRACE_INSTANT(cat, name, arg) do{ if(Trace::on()){ \
+      static const uint16_t bewe_tr_id_ = Trace::event_id(cat, name); \
+      Trace::emit(bewe_tr_id_, Trace::now(), 0, (uint32_t)(arg)); } }while(0)
+  #define BEWE_TRACE_SPAN(cat, name, t0, arg) do{ if((t0) && Trace::on()){ \
+      static const uint16_t bewe_tr_id_ = Trace::event_id(cat, name); \
+      Trace::emit(bewe_tr_id_, (t0), Trace::now(), (uint32_t)(arg)); } }while(0)
+#else
+  struct BeweTraceNop { uint32_t arg = 0; };
+  #define BEWE_TRACE_SCOPE_V(var, cat, name)   BeweTraceNop var
+  #define BEWE_TRACE_SCOPE_ARG(cat, name, arg) do{}while(0)
+  #define BEWE_TRACE_SCOPE(cat, name)          do{}while(0)
+  #define BEWE_TRACE_INSTANT(cat, name, arg)   do{}while(0)
+  #define BEWE_TRACE_SPAN(cat, name, t0, arg)  do{}while(0)
+#endif
@@ -106,130 +106,7 @@ static std::string fmt_filesize(const std::string& dir, const std::string& fname
     return buf;
 }
 
-// ── 채널 스컬치: FFT 스펙트럼에서 직접 채널 파워 계산 ─────────────────────
-// filter_active인 모든 채널에 대해 동작 (복조 없어도 회색 상태에서 작동)
-// dB값이 FFT 스펙트럼과 동일한 스케일 (-100~0)
-void FFTViewer::update_channel_squelch(){
-    // JOIN 모드: 스컬치 계산은 HOST 전담. CH_SYNC로 받은 sq_threshold/sq_sig/sq_gate만 표시.
-    if(remote_mode) return;
-    if(total_ffts < 1 || fft_size < 1) return;
-    std::lock_guard<std::mutex> lk(data_mtx);
-    float cf_mhz = (float)(header.center_frequency / 1e6);
-    float nyq_mhz = header.sample_rate / 2e6f;
-    if(nyq_mhz < 0.001f) return;
-    int hf = fft_size / 2;
-
-    // 최신 FFT 행 읽기 (float dB 값 직접)
-    int fi = (total_ffts > 0 ? total_ffts - 1 : 0) % MAX_FFTS_MEMORY;
-    const float* rowp = fft_data.data() + fi * fft_size;
-    // 같은 FFT 행이면 채널별 peak 재스캔 생략 (행 갱신은 ~1.5-37Hz, 호출은 ~60Hz)
-    bool same_row = (total_ffts == sq_last_total_ffts);
-    sq_last_total_ffts = total_ffts;
-
-    auto freq_to_bin = [&](float rel_mhz) -> int {
-        int bin = (rel_mhz >= 0)
-            ? (int)((rel_mhz / nyq_mhz) * hf)
-            : fft_size + (int)((rel_mhz / nyq_mhz) * hf);
-        return std::max(0, std::min(fft_size - 1, bin));
-    };
-
-    for(int c = 0; c < MAX_CHANNELS; c++){
-        Channel& ch = channels[c];
-        if(!ch.filter_active) continue;
-
-        // 채널 주파수 범위 > FFT 빈
-        float s_mhz = std::min(ch.s, ch.e) - cf_mhz;
-        float e_mhz = std::max(ch.s, ch.e) - cf_mhz;
-        int bin_s = freq_to_bin(s_mhz);
-        int bin_e = freq_to_bin(e_mhz);
-
-        // 채널 대역 내 피크 파워 (float dB 직접)
-        // 행·대역 둘 다 그대로면 캐시 재사용 (계산결과 동일 → 게이트/시간 동작 불변)
-        float peak_db;
-        if(same_row && ch.sq_calibrated.load(std::memory_order_relaxed)
-           && ch.sq_scan_s == ch.s && ch.sq_scan_e == ch.e){
-            peak_db = ch.sq_cached_peak;
-        } else {
-            peak_db = -120.0f;
-            if(bin_s <= bin_e){
-                for(int b = bin_s; b <= bin_e; b++){
-                    if(rowp[b] > peak_db) peak_db = rowp[b];
-                }
-            } else {
-                // DC 경계를 넘는 경우
-                for(int b = bin_s; b < fft_size; b++){
-                    if(rowp[b] > peak_db) peak_db = rowp[b];
-                }
-                for(int b = 0; b <= bin_e; b++){
-                    if(rowp[b] > peak_db) peak_db = rowp[b];
-                }
-            }
-            ch.sq_cached_peak = peak_db;
-            ch.sq_scan_s = ch.s; ch.sq_scan_e = ch.e;
-        }
-
-        // IIR 스무딩 (UI 프레임 기반, ~60fps)
-        float prev = ch.sq_sig.load(std::memory_order_relaxed);
-        float sig = 0.3f * peak_db + 0.7f * prev;
-        ch.sq_sig.store(sig, std::memory_order_relaxed);
-
-        // 캘리브레이션: 처음 60프레임(~1초) 수집 후 20th percentile + 10dB
-        if(!ch.sq_calibrated.load(std::memory_order_relaxed)){
-            if(ch.sq_calib_cnt < 60){
-                ch.sq_calib_buf[ch.sq_calib_cnt++] = peak_db;
-            }
-            if(ch.sq_calib_cnt >= 60){
-                // 20th percentile + 10dB
-                float tmp[60];
-                memcpy(tmp, ch.sq_calib_buf, sizeof(tmp));
-                std::nth_element(tmp, tmp + 12, tmp + 60);
-                float noise_floor = tmp[12];
-                ch.sq_threshold.store(noise_floor + 10.0f, std::memory_order_relaxed);
-                ch.sq_calibrated.store(true, std::memory_order_relaxed);
-                ch.sq_calib_cnt = 0;
-            }
-        }
-
-        // 게이트 로직 (히스테리시스 + 홀드)
-        float thr = ch.sq_threshold.load(std::memory_order_relaxed);
-        bool gate = ch.sq_gate.load(std::memory_order_relaxed);
-        const float HYS = 3.0f;
-        const int HOLD_FRAMES = 18;  // ~0.3초 @ 60fps
-
-        if(ch.sq_calibrated.load(std::memory_order_relaxed)){
-            if(!gate && sig >= thr){
-                gate = true;
-                ch.sq_gate_hold = HOLD_FRAMES;
-            }
-            if(gate){
-                if(sig >= thr - HYS)
-                    ch.sq_gate_hold = HOLD_FRAMES;
-                else if(--ch.sq_gate_hold <= 0)
-                    gate = false;
-            }
-        }
-        ch.sq_gate.store(gate, std::memory_order_relaxed);
-
-        // 스컬치 누적 시간 추적 (프레임 기반 — SDR 멈추면 시간도 정지)
-        // Holding(dem_paused) 상태에서는 증가 정지 — JOIN도 HOST 값이 멈춘 상태로 받음
-        if(ch.filter_active && !ch.dem_paused.load()){
-            // JOIN: CH_SYNC에서 HOST 값을 직접 사용 (로컬 증가 안 함)
-            if(!remote_mode){
-                float fps = (float)header.sample_rate / (float)std::max(1,fft_input_size) / (float)std::max(1,time_average);
-                if(fps > 0){
-                    float dt = 1.0f / fps;
-                    if(!sdr_stream_error.load()){
-                        ch.sq_total_time += dt;
-                        if(gate) ch.sq_active_time += dt;
-                    }
-                }
-            }
-        } else if(!ch.filter_active){
-            ch.sq_active_time = 0;
-            ch.sq_total_time = 0;
-        }
-    }
-}
+// 채널 스컬치 (update_channel_squelch) → squelch.cpp (CLI 공용)
 
 // ── Channel overlays ──────────────────────────────────────────────────────
 void FFTViewer::handle_new_channel_drag(float gx, float gw){
@@ -633,7 +510,7 @@ void FFTViewer::draw_spectrum_area(ImDrawList* dl, float full_x, float full_y, f
         if(total_ffts > 0 && fft_size > 0 && sp_idx != last_maxhold_sp_idx){
             std::lock_guard<std::mutex> lk_mh(data_mtx);
             int mi = sp_idx % MAX_FFTS_MEMORY;
-            const float* rp = fft_data.data() + mi * fft_size;
+            FftQuant::Row rp = fft_row(mi);
             // 5 dB/s @ ~37.5 rows/s → 약 0.133 dB/frame
             constexpr float DECAY_PER_FRAME = 5.0f / 37.5f;
             // 노치 bin 검사용 스냅샷 + bin→MHz 헬퍼
@@ -672,7 +549,7 @@ void FFTViewer::draw_spectrum_area(ImDrawList* dl, float full_x, float full_y, f
         std::lock_guard<std::mutex> lk(data_mtx);
         float nyq=sr_mhz/2.0f; int hf=header.fft_size/2;
         int mi=sp_idx%MAX_FFTS_MEMORY;
-        const float* rowp=fft_data.data()+mi*fft_size;
+        FftQuant::Row rowp=fft_row(mi);
         // Peak detection: 각 픽셀에 매핑되는 빈 범위의 최대값 사용
         auto freq_to_bin=[&](float fd)->int{
             int b=(fd>=0)?(int)((fd/nyq)*hf+0.5f):fft_size+(int)((fd/nyq)*hf-0.5f);
@@ -730,7 +607,7 @@ void FFTViewer::draw_spectrum_area(ImDrawList* dl, float full_x, float full_y, f
     if(!nlocal.empty()){
         std::lock_guard<std::mutex> lk(data_mtx);
         int mi = sp_idx % MAX_FFTS_MEMORY;
-        const float* rowp = fft_data.data() + mi*fft_size;
+        FftQuant::Row rowp = fft_row(mi);
         bool mh_valid = (max_hold_mode != 0 && (int)max_hold_spectrum.size() == fft_size && fft_size > 0);
         float bin_width_mhz = (sr_mhz_loc > 0 && fft_size > 0) ? (sr_mhz_loc / (float)fft_size) : 1e-6f;
         constexpr float EMA_ALPHA = 0.15f;  // 새 값 반영 비율 (1-α는 이전 값 유지)
@@ -1739,31 +1616,28 @@ void FFTViewer::draw_waterfall_area(ImDrawList* dl, float full_x, float full_y,
     dl->AddRectFilled(ImVec2(full_x,full_y),ImVec2(full_x+total_w,full_y+total_h),IM_COL32(10,10,10,255));
     // /rx stop 시 검은 화면만 표시
     if(rx_stopped.load()) { draw_freq_axis(dl,gx,gw,gy,gh,true); return; }
-    if(!waterfall_texture) create_waterfall_texture();
+    if(!wf_data_tex) create_waterfall_texture();
     // 타임머신 모드 아닐 때만 텍스처 업데이트
     // 워터폴 텍스처 업데이트: TM 모드 중에도 계속 갱신 (복귀 시 검은화면 방지)
     if(total_ffts>0&&last_wf_update_idx!=current_fft_idx){
         update_wf_row(current_fft_idx); last_wf_update_idx=current_fft_idx;
     }
-    if(waterfall_texture){
+    if(wf_data_tex){
         float ds,de; get_disp(ds,de);
         float nyq=header.sample_rate/2.0f/1e6f;
         int dr2=std::min(total_ffts,MAX_FFTS_MEMORY);
-        int tex_w=std::min(fft_size, 16384);
-        if(tex_w<1) tex_w=1;
-        float half_texel=0.5f/tex_w;
-        float us=(ds+nyq)/(2*nyq)+half_texel, ue=(de+nyq)/(2*nyq)+half_texel;
+        float d0=(ds+nyq)/(2*nyq)*fft_size, d1=(de+nyq)/(2*nyq)*fft_size;
         float dh=(dr2>=(int)gh)?gh:(float)dr2;
         // 타임머신: tm_display_fft_idx 기준, 일반: current_fft_idx 기준
         // 매 프레임 tm_update_display() 호출 → 60초 한계 follow 동작 반영
         if(tm_active.load()) tm_update_display();
         int disp_idx=tm_active.load() ? tm_display_fft_idx : current_fft_idx;
-        float half_texel_v=0.5f/MAX_FFTS_MEMORY;
-        float vn=(float)(disp_idx%MAX_FFTS_MEMORY)/MAX_FFTS_MEMORY;
-        float vt=vn+1.0f/MAX_FFTS_MEMORY-half_texel_v;
-        float vb=vt-dh/MAX_FFTS_MEMORY+half_texel_v;
-        ImTextureID tid=(ImTextureID)(intptr_t)waterfall_texture;
-        dl->AddImage(tid,ImVec2(gx,gy),ImVec2(gx+gw,gy+dh),ImVec2(us,vt),ImVec2(ue,vb),IM_COL32(255,255,255,255));
+        // 화면 픽셀 크기로 셰이더 렌더 (컬러맵 / peak / 노치) → 1:1 로 붙임
+        render_waterfall((int)gw,(int)dh,disp_idx,d0,d1);
+        if(waterfall_texture && dh>=1.0f){
+            ImTextureID tid=(ImTextureID)(intptr_t)waterfall_texture;
+            dl->AddImage(tid,ImVec2(gx,gy),ImVec2(gx+(int)gw,gy+(int)dh),ImVec2(0,1),ImVec2(1,0),IM_COL32(255,255,255,255));
+        }
         // IQ 가용 오버레이 제거됨 - 좌측 태그로 대체
     }
     draw_freq_axis(dl,gx,gw,gy,gh,true);
@@ -2797,6 +2671,7 @@ void run_streaming_viewer(){
 
         // ── Satellite markers + selected orbit ────────────────────────────
         if(globe_ok){
+            if(v.station_location_set) sat_view_set_station(v.station_lat, v.station_lon);
             sat_view_draw(globe, io, time(nullptr));
         }
 
@@ -3234,7 +3109,7 @@ void run_streaming_viewer(){
                     // 채널 생성: HOST의 sq_threshold를 이미 CH_SYNC로 받으므로
                     // 캘리브레이션 건너뛰기 (즉시 calibrated)
                     v.channels[i].sq_calibrated.store(true);
-                    v.channels[i].sq_calib_cnt = 0;
+                    v.channels[i].sq_calib.clear();
                     v.channels[i].sq_gate_hold = 0;
                     cli->audio[i].clear();
                     if(!v.ch_created_by_me[i]){
@@ -4101,7 +3976,7 @@ void run_streaming_viewer(){
             srv->cb.on_set_autoscale = [&](){
                 bewe_log_push(0, "[CMD] Autoscale requested\n");
                 v.autoscale_active=true; v.autoscale_init=false;
-                v.autoscale_accum.clear();
+                v.autoscale_hist.clear();
             };
             srv->cb.on_toggle_tm_iq = [&](){
                 bool cur=v.tm_iq_on.load();
@@ -4175,19 +4050,13 @@ void run_streaming_viewer(){
                         for(auto& e:v.rec_entries)
                             if(e.filename==fname){ e.req_state=FFTViewer::RecEntry::REQ_CONFIRMED; break; }
                     }
-                    for(int w=0;w<200&&v.rec_busy_flag.load();w++)
-                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                    v.region.fft_top=ft; v.region.fft_bot=fb;
-                    v.region.freq_lo=fl; v.region.freq_hi=fh;
-                    v.region.time_start_ms=(int64_t)ts*1000LL;
-                    v.region.time_end_ms=(int64_t)te*1000LL;
-                    v.region.samp_start=samp_start;
-                    v.region.samp_end=samp_end;
-                    v.region.active=true;
-                    v.rec_busy_flag.store(true);
-                    v.rec_state = FFTViewer::REC_BUSY;
-                    v.rec_anim_timer = 0.0f;
-                    v.region.active = false;
+                    FFTViewer::RegionSel rq{};
+                    rq.fft_top=ft; rq.fft_bot=fb;
+                    rq.freq_lo=fl; rq.freq_hi=fh;
+                    rq.time_start_ms=(int64_t)ts*1000LL;
+                    rq.time_end_ms=(int64_t)te*1000LL;
+                    rq.samp_start=samp_start;
+                    rq.samp_end=samp_end;
                     // IQ_PROGRESS phase=0 (REC 중) 브로드캐스트 - 파이프와 동일한 req_id 사용
                     if(srv){
                         PktIqProgress prog{};
@@ -4196,16 +4065,12 @@ void run_streaming_viewer(){
                         prog.done=0; prog.total=0; prog.phase=0;
                         srv->broadcast_iq_progress(prog);
                     }
-                    v.do_region_save_work();
-                    v.rec_state = FFTViewer::REC_SUCCESS;
-                    v.rec_success_timer = 3.0f;
-                    v.rec_busy_flag.store(false);
-                    std::string path;
-                    {
+                    // 동시에 들어온 요청과 묶어 롤링 파일 1 pass 로 추출 (rec_state/busy 는 큐 워커가 관리)
+                    std::string path = v.region_save_enqueue(rq).get();
+                    if(!path.empty()){
                         std::lock_guard<std::mutex> lk2(v.rec_entries_mtx);
                         for(auto it=v.rec_entries.rbegin();it!=v.rec_entries.rend();++it)
-                            if(!it->is_audio&&it->req_state==FFTViewer::RecEntry::REQ_NONE&&it->finished){
-                                path=it->path;
+                            if(!it->is_audio&&it->req_state==FFTViewer::RecEntry::REQ_NONE&&it->path==path){
                                 v.rec_entries.erase(std::next(it).base());
                                 break;
                             }
@@ -4409,7 +4274,8 @@ void run_streaming_viewer(){
                         if((time_t)start_time != it->start_time) continue;
                         if(fabsf(freq_mhz - it->freq_mhz) > 0.0001f) continue;
                         if(it->op_index != op_idx && op_idx != 0) return;
-                        if(it->status == FFTViewer::SchedEntry::RECORDING) return;
+                        if(it->status == FFTViewer::SchedEntry::RECORDING ||
+                           it->status == FFTViewer::SchedEntry::ARMED) return;
                         v.sched_entries.erase(it);
                         removed = true;
                         break;
@@ -4441,6 +4307,7 @@ void run_streaming_viewer(){
             } else {
                 host_port = srv->listen_port(); // 실제 할당된 포트 기록
                 v.net_srv = srv;
+                v.metrics_install();   // /metrics (localhost) — HOST 모드에서만
                 srv->set_host_info(login_get_id(), (uint8_t)login_get_tier());
                 // HOST station 정보를 static에 저장 (/reset 재진입 시 복원)
                 if(v.station_location_set){
@@ -4600,9 +4467,9 @@ void run_streaming_viewer(){
                                 lcb.on_start = [&v](const PktLwfLiveStart& s){
                                     if(v.net_srv) v.net_srv->broadcast_lwf_live_start(s);
                                 };
-                                lcb.on_row = [&v](const PktLwfLiveRowHdr& hdr,
-                                                  const uint8_t* row, uint32_t row_bytes){
-                                    if(v.net_srv) v.net_srv->broadcast_lwf_live_row(hdr, row, row_bytes);
+                                lcb.on_block = [&v](const PktLwfLiveBlockHdr& hdr,
+                                                    const uint8_t* blk, uint32_t blk_bytes){
+                                    if(v.net_srv) v.net_srv->broadcast_lwf_live_block(hdr, blk, blk_bytes);
                                 };
                                 lcb.on_stop = [&v](const PktLwfLiveStop& s){
                                     if(v.net_srv) v.net_srv->broadcast_lwf_live_stop(s);
@@ -5113,6 +4980,17 @@ void run_streaming_viewer(){
             }
         }
 
+        // ── STATS (5s): 파이프라인 메트릭 요약 broadcast (상세는 /metrics) ──
+        if(v.net_srv){
+            static auto stats_last = std::chrono::steady_clock::now();
+            auto now3 = std::chrono::steady_clock::now();
+            if(std::chrono::duration<float>(now3-stats_last).count() >= 5.0f){
+                stats_last = now3;
+                PktStats st; v.stats_fill(st);
+                v.net_srv->broadcast_stats(st);
+            }
+        }
+
         // ── Scheduled recording tick ──────────────────────────────────────
         if(!v.remote_mode) v.sched_tick();
 
@@ -5512,7 +5390,7 @@ void run_streaming_viewer(){
             if(cur_cf > 0.f && fabsf(cur_cf - last_cf_mhz) > 0.001f){
                 v.autoscale_active  = true;
                 v.autoscale_init    = false;
-                v.autoscale_accum.clear();
+                v.autoscale_hist.clear();
                 v.join_manual_scale = false;
             }
             last_cf_mhz = cur_cf;
@@ -5522,7 +5400,7 @@ void run_streaming_viewer(){
             if(cur_sr_join > 0 && cur_sr_join != last_sr_join && last_sr_join != 0){
                 v.autoscale_active  = true;
                 v.autoscale_init    = false;
-                v.autoscale_accum.clear();
+                v.autoscale_hist.clear();
                 v.join_manual_scale = false;
             }
             last_sr_join = cur_sr_join;
@@ -5559,8 +5437,9 @@ void run_streaming_viewer(){
                 {
                     std::lock_guard<std::mutex> dlk(v.data_mtx);
                     int fi = v.total_ffts % MAX_FFTS_MEMORY;
-                    float* dst = v.fft_data.data() + (size_t)fi * fsz;
-                    memcpy(dst, frm.data.data(), fsz * sizeof(float));
+                    // HOST 와 같은 저장 방식 (행 자신의 min/max 로 재양자화)
+                    v.fft_store_row(fi, frm.data.data());
+                    const float* dst = frm.data.data();
                     v.total_ffts++;
                     v.current_fft_idx = v.total_ffts - 1;
                     // JOIN: row_wall_ms 설정 (ms 정밀도, HOST wall_time 기준)
@@ -5580,29 +5459,23 @@ void run_streaming_viewer(){
                     // 오토스케일 누적
                     if(v.autoscale_active){
                         if(!v.autoscale_init){
-                            v.autoscale_accum.reserve(fsz*200);
+                            v.autoscale_hist.clear();
                             v.autoscale_last = std::chrono::steady_clock::now();
                             v.autoscale_init = true;
                         }
-                        v.autoscale_accum.insert(v.autoscale_accum.end(), dst+1, dst+fsz);
+                        v.autoscale_hist.add(dst+1, fsz-1);
                         float _el=std::chrono::duration<float>(
                             std::chrono::steady_clock::now()-v.autoscale_last).count();
-                        if(_el>=1.0f && !v.autoscale_accum.empty()){
-                            size_t _n = v.autoscale_accum.size();
-                            size_t _lo = (size_t)(_n * 0.15f);
-                            std::nth_element(v.autoscale_accum.begin(),
-                                v.autoscale_accum.begin()+_lo,
-                                v.autoscale_accum.end());
-                            float _noise = v.autoscale_accum[_lo];
+                        if(_el>=1.0f && v.autoscale_hist.count()>0){
+                            float _noise = v.autoscale_hist.quantile(0.15f);
                             // 피크: 실제 max (99% 분위수는 신호 bin이 너무 적어 노이즈권에 머무름)
-                            float _peak = *std::max_element(v.autoscale_accum.begin(),
-                                v.autoscale_accum.end());
+                            float _peak = v.autoscale_hist.max();
                             v.display_power_min = _noise - 5.f;
                             v.display_power_max = _peak + 20.f;
                             if(v.display_power_max - v.display_power_min < 20.f)
                                 v.display_power_max = v.display_power_min + 20.f;
                             v.join_manual_scale = true; // 수신 frm.pmin 덮어쓰기 차단
-                            v.autoscale_accum.clear();
+                            v.autoscale_hist.clear();
                             v.autoscale_active = false;
                             v.cached_sp_idx = -1;
                             bewe_log_push(0,"[autoscale-JOIN] noise=%.1f peak=%.1f → pmin=%.1f pmax=%.1f\n",
@@ -5620,7 +5493,7 @@ void run_streaming_viewer(){
                             for(int _i=1;_i<fsz;_i++) if(dst[_i] > _mx) _mx = dst[_i];
                             if(_mx > v.display_power_max){
                                 v.autoscale_active = true; v.autoscale_init = false;
-                                v.autoscale_accum.clear();
+                                v.autoscale_hist.clear();
                                 bewe_log_push(0,"[autoscale-JOIN] peak %.1f > pmax %.1f re-autoscale\n",
                                     _mx, v.display_power_max);
                             }
@@ -6003,7 +5876,7 @@ void run_streaming_viewer(){
             } else {
                 v.pending_cf=new_freq; v.freq_req=true;
                 v.autoscale_active=true; v.autoscale_init=false;
-                v.autoscale_accum.clear();
+                v.autoscale_hist.clear();
             }
             fdeact=true;
         }
@@ -9271,7 +9144,9 @@ void run_streaming_viewer(){
             }
 
             // ── 로딩 ────────────────────────────────────────────────────
-            bool loading = v.eid_computing.load() || (eid_mode == 0 && v.sa_computing.load());
+            // SA 는 첫 tile 이 올라오면 바로 표시 (나머지는 진행률만)
+            bool loading = v.eid_computing.load() ||
+                           (eid_mode == 0 && v.sa_computing.load() && v.sa_tiles_done.load() == 0);
             if(loading){
                 v.eid_anim_timer += io.DeltaTime;
                 int dots = ((int)(v.eid_anim_timer / 0.5f) % 3) + 1;
@@ -9402,6 +9277,15 @@ void run_streaming_viewer(){
                     // 테두리
                     fg->AddRect(ImVec2(ea_x0, ea_y0), ImVec2(ea_x1, ea_y1), IM_COL32(60,60,80,255));
 
+                    // tile 렌더 진행률 (계산 중에도 완료 tile 은 이미 표시됨)
+                    if(v.sa_computing.load()){
+                        int64_t tt = std::max<int64_t>(1, v.sa_tiles_total.load());
+                        char pl[32]; snprintf(pl, sizeof(pl), "Computing %d%%",
+                                              (int)(100 * v.sa_tiles_done.load() / tt));
+                        ImVec2 psz = ImGui::CalcTextSize(pl);
+                        fg->AddText(ImVec2(ea_x1 - psz.x - 6, ea_y0 + 4), IM_COL32(255,100,180,255), pl);
+                    }
+
                     // 스크롤 줌 (시간축 = 화면 X)
                     ImVec2 mp = io.MousePos;
                     bool in_sa = (mp.x >= ea_x0 && mp.x < ea_x1 && mp.y >= ea_y0 && mp.y < ea_y1);
@@ -10481,7 +10365,7 @@ void run_streaming_viewer(){
                 // 파형 렌더링
                 fg->PushClipRect(ImVec2(ea_x0, ea_y0), ImVec2(ea_x1, ea_y1), true);
                 {
-                    struct ECh { const std::vector<float>* d; ImU32 c; };
+                    struct ECh { const EidStore::Channel* d; ImU32 c; };
                     ECh chs[2]; int nch = 0;
                     if(imode == 0){ chs[0]={&v.eid_envelope, IM_COL32(80,255,140,255)}; nch=1; }
                     else if(imode == 1){ chs[0]={&v.eid_ch_i, IM_COL32(80,255,140,255)};
@@ -11046,7 +10930,7 @@ void run_streaming_viewer(){
                     uint32_t sr=v.eid_sample_rate>0?v.eid_sample_rate:1;
                     double interval=v.eid_baud_s1-v.eid_baud_s0;
                     if(interval>0){
-                        const std::vector<float>* src_data = nullptr;
+                        const EidStore::Channel* src_data = nullptr;
                         switch(v.eid_baseline_imode){
                             case 0: src_data = v.eid_envelope.empty()   ? nullptr : &v.eid_envelope;  break;
                             case 1: src_data = v.eid_ch_i.empty()       ? nullptr : &v.eid_ch_i;      break;
@@ -11907,6 +11791,11 @@ void run_streaming_viewer(){
     }
     if(v.dev_rtl){ rtlsdr_close(v.dev_rtl); v.dev_rtl=nullptr; }
     if(v.waterfall_texture) glDeleteTextures(1,&v.waterfall_texture);
+    if(v.wf_data_tex) glDeleteTextures(1,&v.wf_data_tex);
+    if(v.wf_scale_tex) glDeleteTextures(1,&v.wf_scale_tex);
+    if(v.wf_fbo) glDeleteFramebuffers(1,&v.wf_fbo);
+    if(v.wf_vao) glDeleteVertexArrays(1,&v.wf_vao);
+    if(v.wf_prog) glDeleteProgram(v.wf_prog);
     v.sa_cleanup();
     v.eid_cleanup();      // eid_thread join 보장
 